@@ -116,6 +116,14 @@ enum AOFX_TAP_TYPE
     AOFX_TAP_TYPE_COUNT = 3,
 };
 
+enum AOFX_KERNEL_TYPE
+{
+    AOFX_KERNEL_TYPE_HDAO = 0,
+    AOFX_KERNEL_TYPE_GTAO = 1,
+
+    AOFX_KERNEL_TYPE_COUNT = 2,
+};
+
 enum AOFX_IMPLEMENTATION_MASK
 {
     AOFX_IMPLEMENTATION_MASK_KERNEL_CS = 1,
@@ -158,8 +166,91 @@ enum AOFX_LAYER_PROCESS
     AOFX_LAYER_PROCESS_COUNT = 4,
 };
 
+enum AOFX_STAGE
+{
+    AOFX_STAGE_PROCESS_INPUT = 0,
+    AOFX_STAGE_AMBIENT_OCCLUSION = 1,
+    AOFX_STAGE_BLUR = 2,
+    AOFX_STAGE_DILATE = 3,
+    AOFX_STAGE_OUTPUT = 4,
+    AOFX_STAGE_UPSAMPLE = 5,                // full resolution copy of a downscaled layer ahead of its blur, see AOFX_MemoryUsage
+
+    AOFX_STAGE_COUNT = 6,
+};
+
+/**
+Application state AOFX_Render preserves.
+* FULL - every slot of every pipeline stage is captured and restored (default)
+* USED - only the stages and leading slots AOFX binds are captured and restored
+* NONE - nothing is captured, the application rebinds its own state after AOFX_Render
+*/
+enum AOFX_STATE_RESTORE
+{
+    AOFX_STATE_RESTORE_FULL = 0,
+    AOFX_STATE_RESTORE_USED = 1,
+    AOFX_STATE_RESTORE_NONE = 2,
+
+    AOFX_STATE_RESTORE_COUNT = 3,
+};
+
+/**
+When AOFX creates its shader permutations.
+* ALL - AOFX_Initialize creates every permutation (default)
+* ON_DEMAND - AOFX_Initialize only creates the permutations of the AOFX_Desc it is given, the others are created
+  by the first AOFX_Render that needs them, or ahead of time by AOFX_PrewarmShaders
+*/
+enum AOFX_SHADER_CREATION
+{
+    AOFX_SHADER_CREATION_ALL = 0,
+    AOFX_SHADER_CREATION_ON_DEMAND = 1,
+
+    AOFX_SHADER_CREATION_COUNT = 2,
+};
+
 struct AOFX_OpaqueDesc;
 
+/**
+Work submitted by a single stage of AOFX_Render (or of the CPU path used by AOFX_RenderBatch).
+* m_Layer is the layer the stage processed, or AOFX_Desc::m_MultiResLayerCount for stages that cover all layers
+  (dilate, output and a blur of the blended layers)
+* m_DispatchSize holds the thread groups of the last compute dispatch, or the pass size for pixel shader and CPU passes
+* m_ConstantBufferUploadsSkipped counts constant buffer updates avoided because their contents did not change
+* m_StateBinds counts pipeline state binds sent to the context, m_StateBindsSkipped the ones dropped because
+  the stage had already bound the same state earlier in AOFX_Render
+*/
+struct AOFX_StageCounters
+{
+    AOFX_STAGE                          m_Stage;
+    uint                                m_Layer;
+    uint                                m_Passes;
+    uint                                m_DispatchSize[3];
+    size_t                              m_TexelsProcessed;
+    size_t                              m_BytesWritten;
+    uint                                m_ConstantBufferUploads;
+    uint                                m_ConstantBufferUploadsSkipped;
+    uint                                m_StateBinds;
+    uint                                m_StateBindsSkipped;
+};
+
+/**
+Instrumentation callbacks are invoked around every stage of AOFX_Render from the thread calling it.
+For the GPU path they are invoked while the stage is being recorded, so they are the place to insert timestamp queries
+or debug markers (the immediate context is passed along). The CPU path passes a NULL context and runs on
+AOFX_RenderBatch worker threads, so callbacks have to be thread safe when used with it.
+AOFX_Render tracks the state it binds across stages, callbacks must not change pipeline state of the context.
+*/
+typedef void (*AOFX_STAGE_BEGIN_CALLBACK)(AOFX_STAGE stage, uint layer, ID3D11DeviceContext * pContext, void * pUserData);
+typedef void (*AOFX_STAGE_END_CALLBACK)(const AOFX_StageCounters & counters, ID3D11DeviceContext * pContext, void * pUserData);
+
+struct AOFX_Instrumentation
+{
+    AOFX_STAGE_BEGIN_CALLBACK           m_pBeginStage;      // optional
+    AOFX_STAGE_END_CALLBACK             m_pEndStage;        // optional
+    void *                              m_pUserData;
+
+    AMD_AOFX_DLL_API                    AOFX_Instrumentation();
+};
+
 struct AOFX_Desc
 {
     /**
@@ -180,6 +271,7 @@ struct AOFX_Desc
     AOFX_SAMPLE_COUNT                   m_SampleCount[m_MultiResLayerCount];
     AOFX_NORMAL_OPTION                  m_NormalOption[m_MultiResLayerCount];
     AOFX_TAP_TYPE                       m_TapType[m_MultiResLayerCount];
+    AOFX_KERNEL_TYPE                    m_KernelType[m_MultiResLayerCount];
     float                               m_MultiResLayerScale[m_MultiResLayerCount];
     float                               m_PowIntensity[m_MultiResLayerCount];
     float                               m_RejectRadius[m_MultiResLayerCount];
@@ -203,10 +295,17 @@ struct AOFX_Desc
     ID3D11RenderTargetView*             m_pOutputRTV;
 
     uint2                               m_InputSize;
+    uint2                               m_MaxInputSize;
 
     uint                                m_OutputChannelsFlag;
     ID3D11BlendState*                   m_pOutputBS;
 
+    const AOFX_Instrumentation*         m_pInstrumentation;
+
+    AOFX_STATE_RESTORE                  m_StateRestore;
+
+    AOFX_SHADER_CREATION                m_ShaderCreation;
+
     AMD_AOFX_DLL_API                    AOFX_Desc();
 
     /**
@@ -223,11 +322,350 @@ private:
     AMD_AOFX_DLL_API                    AOFX_Desc & operator= (const AOFX_Desc &);
 };
 
+/**
+A single depth image processed by AOFX_RenderBatch.
+* m_pDepth points to m_Size.x * m_Size.y hardware depth values (the same values AOFX_Render reads through m_pDepthSRV)
+* m_pOutput receives m_Size.x * m_Size.y AO values in [0, 1] range. It can be left NULL if a store callback consumes the result
+* m_Camera - only m_NearPlane, m_FarPlane, m_Fov and m_Aspect are used
+*/
+struct AOFX_BatchImage
+{
+    const float *                       m_pDepth;
+    float *                             m_pOutput;
+    AOFX_Desc::uint2                    m_Size;
+    AOFX_Desc::Camera                   m_Camera;
+    void *                              m_pUserData;
+
+    AMD_AOFX_DLL_API                    AOFX_BatchImage();
+};
+
+/**
+Batch callbacks are invoked from AOFX_RenderBatch worker threads and have to be thread safe.
+* load is called right before image 'index' is processed and may fill in m_pDepth, m_Size and m_Camera on demand
+* store is called once image 'index' has been processed, with the result of processing it.
+  m_pOutput may point to worker owned scratch memory which is only valid for the duration of the call
+Returning false from a callback marks the image as failed.
+*/
+typedef bool (*AOFX_BATCH_LOAD_CALLBACK)(AOFX_BatchImage & image, uint index, void * pUserData);
+typedef bool (*AOFX_BATCH_STORE_CALLBACK)(const AOFX_BatchImage & image, uint index, AOFX_RETURN_CODE result, void * pUserData);
+
+struct AOFX_BatchDesc
+{
+    AOFX_BatchImage *                   m_pImages;      // can be NULL if m_pLoad provides every image
+    uint                                m_ImageCount;
+    uint                                m_ThreadCount;  // 0 uses all hardware threads
+
+    AOFX_BATCH_LOAD_CALLBACK            m_pLoad;
+    AOFX_BATCH_STORE_CALLBACK           m_pStore;
+    void *                              m_pUserData;
+
+    AMD_AOFX_DLL_API                    AOFX_BatchDesc();
+};
+
+struct AOFX_BatchStats
+{
+    uint                                m_ImagesProcessed;
+    uint                                m_ImagesFailed;
+    uint                                m_ThreadCount;
+    uint                                m_ScratchAllocations; // worker scratch surfaces are only reallocated when image size changes
+    double                              m_Seconds;
+    double                              m_ImagesPerSecond;
+    double                              m_MegaTexelsPerSecond;
+
+    AMD_AOFX_DLL_API                    AOFX_BatchStats();
+};
+
+/**
+Result of AOFX_CompareKernels for one kernel type at one sample count.
+Every kernel type and sample count is scored against the same CPU reference, GTAO with fixed taps marching 16 slices
+with 16 steps per side, so the PSNR of HDAO and GTAO results can be compared with each other.
+*/
+struct AOFX_KernelComparison
+{
+    AOFX_KERNEL_TYPE                    m_KernelType;
+    AOFX_SAMPLE_COUNT                   m_SampleCount;
+    double                              m_Milliseconds;         // CPU time spent in the AO kernel of all active layers
+    double                              m_RMSE;                 // root mean square error of the final AO image against the reference
+    double                              m_PSNR;                 // in dB, capped at 100.0 for identical images
+    double                              m_PSNRPerMillisecond;
+
+    AMD_AOFX_DLL_API                    AOFX_KernelComparison();
+};
+
+/**
+GPU memory held by the internal surfaces of AOFX_OpaqueDesc, in bytes.
+Downscaled layers are kept at their own resolution all the way into the dilate pass,
+so only m_DilateAO and m_BlurAO are allocated at m_InputSize. Until the depth aware dilate
+permutations are precompiled (AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED), downscaled layers are
+upsampled before they are blurred and blended and also hold a full resolution m_UpsampleAO.
+A disabled layer reports 0 for its surfaces.
+*/
+struct AOFX_MemoryUsage
+{
+    size_t                              m_DilateAO;                                     // full resolution, blended layers
+    size_t                              m_BlurAO;                                       // full resolution, bilateral blur intermediate
+    size_t                              m_ResultAO[AOFX_Desc::m_MultiResLayerCount];    // layer resolution AO
+    size_t                              m_InputAO[AOFX_Desc::m_MultiResLayerCount];     // layer resolution (deinterleaved) camera space depth / position
+    size_t                              m_UpsampleAO[AOFX_Desc::m_MultiResLayerCount];  // full resolution copy of a downscaled layer, see above
+    size_t                              m_BlurLayerAO[AOFX_Desc::m_MultiResLayerCount]; // layer resolution blur intermediate of a downscaled layer
+    size_t                              m_Buffers;                                      // constant buffers and sample pattern buffers
+    size_t                              m_Total;
+
+    AMD_AOFX_DLL_API                    AOFX_MemoryUsage();
+};
+
+/**
+Predicted work of one AOFX_Render stage, computed from the same dispatch math as the render passes.
+* m_ThreadGroups counts compute thread groups, pixel shader passes only contribute texels and taps
+* m_Taps counts kernel reads per output texel (LDS or texture), summed over the stage
+* m_LdsLoads counts texels stored into group shared memory tiles, including tile overlap
+* application depth and normal surfaces are assumed to be 32 bits per texel
+*/
+struct AOFX_StageCost
+{
+    AOFX_STAGE                          m_Stage;
+    uint                                m_Layer;                // AOFX_Desc::m_MultiResLayerCount for stages covering all layers
+    uint                                m_Passes;
+    size_t                              m_ThreadGroups;
+    size_t                              m_TexelsProcessed;
+    size_t                              m_Taps;
+    size_t                              m_LdsLoads;
+    size_t                              m_BytesRead;
+    size_t                              m_BytesWritten;
+
+    AMD_AOFX_DLL_API                    AOFX_StageCost();
+};
+
+/**
+Predicted cost of an AOFX_Desc configuration, see AOFX_EstimateCost.
+m_Stages lists the stages in the order AOFX_Render executes them, m_Total sums all of them
+and m_Memory holds the surfaces AOFX_Resize would allocate for the configuration.
+*/
+struct AOFX_CostEstimate
+{
+    static const uint                   m_MaxStageCount = 4 * AOFX_Desc::m_MultiResLayerCount + 3;
+
+    AOFX_StageCost                      m_Stages[m_MaxStageCount];
+    uint                                m_StageCount;
+    AOFX_StageCost                      m_Total;
+    AOFX_MemoryUsage                    m_Memory;
+
+    AMD_AOFX_DLL_API                    AOFX_CostEstimate();
+};
+
+/**
+Shader objects created by AOFX, see AOFX_GetShaderStats.
+* m_ShadersCreated counts all shaders created since AOFX_Initialize, m_ShadersCreatedByRender the ones AOFX_Render
+  had to create on first use (each of them stalls that frame) and m_ShadersPrewarmed the ones AOFX_PrewarmShaders created
+* m_PermutationCount is the number of shaders AOFX_SHADER_CREATION_ALL creates, only counting the permutations
+  enabled by the AMD_AOFX_PERMUTATION_*_MASK settings AOFX was compiled with (see AMD_AOFX_Permutations.h)
+* m_InitializeMilliseconds is the CPU time of the last AOFX_Initialize, m_CreateMilliseconds the CPU time spent
+  creating shaders on any thread
+* m_UnpackMilliseconds is the part of m_CreateMilliseconds spent decompressing bytecode from the shader archive
+  and m_UnpackedBytes the amount of bytecode decompressed, both stay 0 when AMD_AOFX_SHADER_ARCHIVE is disabled
+* m_PrewarmPending is true while a background AOFX_PrewarmShaders is still creating shaders
+*/
+struct AOFX_ShaderStats
+{
+    uint                                m_ShadersCreated;
+    uint                                m_ShadersCreatedByRender;
+    uint                                m_ShadersPrewarmed;
+    uint                                m_PermutationCount;
+    float                               m_InitializeMilliseconds;
+    float                               m_CreateMilliseconds;
+    float                               m_UnpackMilliseconds;
+    size_t                              m_UnpackedBytes;
+    bool                                m_PrewarmPending;
+
+    AMD_AOFX_DLL_API                    AOFX_ShaderStats();
+};
+
+/**
+One rung of the AOFX_Governor quality ladder: the per layer settings the governor is allowed to change.
+Stepping between levels that share m_LayerProcess and m_MultiResLayerScale does not reallocate AOFX surfaces.
+*/
+struct AOFX_QualityLevel
+{
+    AOFX_LAYER_PROCESS                  m_LayerProcess[AOFX_Desc::m_MultiResLayerCount];
+    float                               m_MultiResLayerScale[AOFX_Desc::m_MultiResLayerCount];
+    AOFX_SAMPLE_COUNT                   m_SampleCount[AOFX_Desc::m_MultiResLayerCount];
+    AOFX_BILATERAL_BLUR_RADIUS          m_BilateralBlurRadius[AOFX_Desc::m_MultiResLayerCount];
+
+    AMD_AOFX_DLL_API                    AOFX_QualityLevel();
+};
+
+struct AOFX_GovernorDesc
+{
+    const AOFX_QualityLevel*            m_pLevels;              // ordered from highest to lowest quality, NULL selects the built in ladder
+    uint                                m_LevelCount;
+    uint                                m_StartLevel;
+    float                               m_BudgetMilliseconds;   // target AO time, default 2.0 ms
+    float                               m_Hysteresis;           // quality is raised only below (1 - m_Hysteresis) * budget, default 0.15
+    float                               m_Smoothing;            // weight of a new sample in the averaged time, default 0.2
+    uint                                m_DowngradeFrames;      // frames over budget before lowering quality, default 4
+    uint                                m_UpgradeFrames;        // frames under the hysteresis band before raising quality, default 60
+    uint                                m_ResizeFrameScale;     // frame counts are scaled by this for steps that reallocate surfaces, default 4
+
+    AMD_AOFX_DLL_API                    AOFX_GovernorDesc();
+};
+
+/**
+State of the quality governor, see AOFX_GovernorUpdate.
+m_UpgradeBackoff doubles every time a raised level has to be lowered again before it proved stable, so the governor
+stops probing a level that does not fit the budget; it is reset once a raised level holds for m_UpgradeFrames.
+*/
+struct AOFX_Governor
+{
+    AOFX_GovernorDesc                   m_Desc;
+    uint                                m_Level;
+    float                               m_AverageMilliseconds;
+    uint                                m_OverBudgetFrames;
+    uint                                m_UnderBudgetFrames;
+    uint                                m_FramesAtLevel;
+    uint                                m_UpgradeBackoff;
+    bool                                m_Upgraded;             // the current level was reached by raising quality
+    uint                                m_LevelChanges;
+    uint                                m_Resizes;
+
+    AMD_AOFX_DLL_API                    AOFX_Governor();
+};
+
+/**
+Parameter space searched by AOFX_Autotune.
+Masks hold one bit per enum value (1 << value), blur radii use bit (1 << (radius + 1)) so bit 0 selects AOFX_BILATERAL_BLUR_RADIUS_NONE.
+A zero mask keeps the value of the AOFX_Desc passed to AOFX_Autotune. Every active layer of a candidate uses the same settings.
+* m_LayerMask - layers the search may enable, every non empty subset is tried
+* m_pLayerScales - multipliers of the desc m_MultiResLayerScale, NULL tries 1.0 only
+*/
+struct AOFX_AutotuneDesc
+{
+    const AOFX_BatchImage *             m_pImages;              // corpus, m_pOutput is ignored
+    uint                                m_ImageCount;
+    uint                                m_ThreadCount;          // 0 uses all hardware threads
+
+    uint                                m_LayerMask;
+    uint                                m_LayerProcessMask;
+    uint                                m_SampleCountMask;
+    uint                                m_TapTypeMask;
+    uint                                m_BlurRadiusMask;
+    const float *                       m_pLayerScales;
+    uint                                m_LayerScaleCount;
+
+    bool                                m_MeasuredCost;         // the frontier uses measured CPU time instead of predicted taps, default false
+
+    AMD_AOFX_DLL_API                    AOFX_AutotuneDesc();
+};
+
+/**
+One configuration on the quality / cost frontier found by AOFX_Autotune.
+m_Level can be used directly as a rung of an AOFX_GovernorDesc ladder.
+*/
+struct AOFX_AutotunePreset
+{
+    AOFX_QualityLevel                   m_Level;
+    AOFX_TAP_TYPE                       m_TapType;
+    double                              m_SSIM;                 // mean over the corpus, 1.0 for identical images
+    double                              m_PSNR;                 // mean over the corpus in dB, capped at 100.0 for identical images
+    double                              m_Milliseconds;         // mean CPU time to render one image
+    AOFX_StageCost                      m_PredictedCost;        // AOFX_EstimateCost total at the size of the first image
+
+    AMD_AOFX_DLL_API                    AOFX_AutotunePreset();
+};
+
+struct AOFX_AutotuneResult
+{
+    AOFX_AutotunePreset *               m_pPresets;             // ordered from highest to lowest quality
+    uint                                m_MaxPresetCount;
+    uint                                m_PresetCount;
+    uint                                m_CandidateCount;       // configurations rendered for every image
+    uint                                m_FrontierCount;        // frontier size before it was thinned to m_MaxPresetCount
+    double                              m_Seconds;
+
+    AMD_AOFX_DLL_API                    AOFX_AutotuneResult();
+};
+
+/**
+Commands recorded by the device context returned from AOFX_CreateNullDevice.
+* m_StateBinds counts every context Set call (shaders, views, samplers, constant buffers, fixed function state)
+* m_StateQueries counts every context Get call, e.g. made while saving and restoring application state
+* m_BytesUploaded sums the size of every buffer mapped for writing and every UpdateSubresource call
+*/
+struct AOFX_DeviceCounters
+{
+    uint                                m_Maps;
+    uint                                m_Unmaps;
+    uint                                m_StateBinds;
+    uint                                m_StateQueries;
+    uint                                m_Dispatches;
+    uint                                m_Draws;
+    uint                                m_Copies;
+    uint                                m_Clears;
+    uint                                m_ObjectsCreated;       // device Create calls
+    uint                                m_ObjectsReleased;      // created objects whose last reference was released
+    size_t                              m_BytesUploaded;
+
+    AMD_AOFX_DLL_API                    AOFX_DeviceCounters();
+};
+
+/**
+CPU cost of submitting one configuration, see AOFX_BenchmarkRender.
+*/
+struct AOFX_RenderBenchmark
+{
+    uint                                m_Frames;
+    double                              m_NanosecondsPerRender; // mean over m_Frames
+    double                              m_MinNanoseconds;
+    double                              m_MaxNanoseconds;
+    AOFX_DeviceCounters                 m_Counters;             // summed over m_Frames, only filled in when desc uses the null device
+
+    AMD_AOFX_DLL_API                    AOFX_RenderBenchmark();
+};
+
+/**
+Streams written by AOFX_CaptureOpen and read by AOFX_ReplayOpen, both are opaque to the application.
+*/
+struct AOFX_CaptureStream;
+struct AOFX_ReplayStream;
+
+struct AOFX_CaptureStats
+{
+    uint                                m_FrameCount;
+    uint64                              m_RawBytes;             // depth and normal texels before compression
+    uint64                              m_CompressedBytes;
+    double                              m_ReadbackMilliseconds; // GPU copies and staging maps, summed over all frames
+    double                              m_EncodeMilliseconds;
+
+    AMD_AOFX_DLL_API                    AOFX_CaptureStats();
+};
+
+/**
+A frame decoded by AOFX_ReplayReadFrame.
+* m_pDepth points to m_Size.x * m_Size.y hardware depth values, unorm formats are converted to float the way a shader reads them
+* m_pNormal points to m_Size.x * m_Size.y texels of m_NormalStride bytes in m_NormalFormat, NULL when no normals were captured
+Both pointers are owned by the replay stream and are valid until the next AOFX_ReplayReadFrame or AOFX_ReplayClose call.
+*/
+struct AOFX_ReplayFrame
+{
+    uint                                m_FrameIndex;
+    AOFX_Desc::uint2                    m_Size;
+    uint                                m_DepthFormat;          // DXGI_FORMAT of the captured depth view
+    uint                                m_NormalFormat;         // DXGI_FORMAT_UNKNOWN when no normals were captured
+    uint                                m_NormalStride;
+    const float *                       m_pDepth;
+    const void *                        m_pNormal;
+    AOFX_Desc::Camera                   m_Camera;
+
+    AMD_AOFX_DLL_API                    AOFX_ReplayFrame();
+};
+
 extern "C"
 {
     /**
     Initialize internal data inside AOFX_Desc
     Calling this function requires setting up m_pDevice member
+    Optional parameters are:
+    * m_ShaderCreation - create every shader permutation or only the ones in use. Default value is AOFX_SHADER_CREATION_ALL.
+        With AOFX_SHADER_CREATION_ON_DEMAND the device is referenced until AOFX_Release to create permutations later
     */
     AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_Initialize(const AOFX_Desc & desc);
 
@@ -243,8 +681,17 @@ extern "C"
         options for a layer process include {using original input resources, deinterleaving input by a factor of {2, 4, 8} }
     Optional parameters are:
     * m_pNormalSRV - resource has to be of the same dimensions as m_pDepthSRV
+    * m_MaxInputSize - size AOFX_Resize allocates internal surfaces at, so m_InputSize can change from one render to the next
+        without reallocating them. AOFX renders into the top left m_InputSize texels of its surfaces, m_pDepthSRV and m_pNormalSRV
+        have to be of m_MaxInputSize with the input in their top left m_InputSize texels as well. Default value is (0, 0), surfaces
+        are allocated at m_InputSize. A library built without AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED returns AOFX_RETURN_CODE_INVALID_ARGUMENT
+        for any other value
     * m_OutputChannelsFlag - specify render terget view output mask. Default value is 0xF
     * m_pOutputBS - specify application desire blend state for output (a non NULL value will override m_OutputChannelsFlag)
+    * m_pInstrumentation - stage begin / end callbacks receiving AOFX_StageCounters. Default value is NULL (no instrumentation)
+    * m_StateRestore - how much application pipeline state is saved and restored around AOFX_Render. Default value is AOFX_STATE_RESTORE_FULL.
+        AOFX_STATE_RESTORE_USED leaves hull and domain shader state alone and only restores the leading shader slots AOFX writes,
+        every render target, viewport and scissor rect is still restored.
     * m_Implementation - specify implementation mask to switch between pixel and compute shader code paths.
     Default value is set to execute all stages in compute.
     * For all active layers (layers that specify a value in m_LayerProcess[] that is different from AOFX_LAYER_PROCESS_NONE)
@@ -253,6 +700,12 @@ extern "C"
     ** m_SampleCount - alternate between sample counts of {8, 16, 24, 32}
     ** m_NormalOption - alternate between AO affects that {don't adjust reconstructed position along normal, take normal into account when reconstructing position}
     ** m_TapType - alternate between sampling pattern that is {fixed, random and fetched from constant buffer, random and fetched from shader resource view}
+    ** m_KernelType - alternate between AO kernels {HDAO valley detection, horizon based slice marching (GTAO)}.
+        GTAO marches NumSamples / 4 slices with 4 steps per side, so both kernels read the same number of taps.
+        Random tap types rotate GTAO slices per pixel instead of fetching the sample pattern.
+        GPU rendering of GTAO needs a library built with AMD_AOFX_GTAO_PRECOMPILED, otherwise AOFX_Initialize and AOFX_Render
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT for active GTAO layers (AOFX_GetKernelSupport tells which kernels a library renders).
+        The CPU batch paths support both kernels.
     ** m_MultiResLayerScale - setting this scaler in range from (0.0f, 1.0] will result in input Depth (and Normal) buffer being scalled before being processed
     ** m_PowIntensity - setting this scaler to a value > 0.0f will result in gamma correction for AO
     ** m_RejectRadius
@@ -262,7 +715,9 @@ extern "C"
     ** m_NormalScale - setting this scaler to a value > 0.0 will define how much Normal buffer affects position reconstruction
     ** m_ViewDistanceDiscard - AO is not computed past this distance (value is set in camera space)
     ** m_ViewDistanceFade - AO start fading to 1.0 past this distance (value is set in camera space). Must be < m_ViewDistanceDiscard
-    ** m_DepthUpsampleThreshold - used for bilateral upsampling (currently disabled)
+    ** m_DepthUpsampleThreshold - camera space depth difference above which a downscaled layer is upsampled from the
+        neighbouring layer texel closest in depth rather than the nearest one (0.0f point samples the layer).
+        Also used as the depth rejection threshold of the bilateral blur
     */
     AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_Render(const AOFX_Desc & desc);
 
@@ -274,6 +729,7 @@ extern "C"
     * Active layers process (as defined by m_LayerProcess[])
     * m_MultiResLayerScale
     * m_InputSize
+    * m_MaxInputSize - when set, m_InputSize changes within m_MaxInputSize do not reallocate anything
     * m_NormalOption
     */
     AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_Resize(const AOFX_Desc & desc);
@@ -283,6 +739,166 @@ extern "C"
     */
     AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_Release(const AOFX_Desc & desc);
 
+    /**
+    Query the GPU memory currently held by the internal surfaces of AOFX_OpaqueDesc
+    Sizes reflect the state of the last AOFX_Resize call
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_GetMemoryUsage(const AOFX_Desc & desc, AOFX_MemoryUsage * pUsage);
+
+    /**
+    Create the shader permutations a set of configurations needs before AOFX_Render first uses them.
+    The configuration of desc is always included, each element of pLevels is applied over desc the way
+    AOFX_GovernorUpdate applies it, so passing the governor ladder prewarms every level the governor can select.
+    With background set the shaders are created on a worker thread and the call returns immediately.
+    AOFX_Render creates whatever it needs before the worker got to it, the device must therefore not be
+    created with D3D11_CREATE_DEVICE_SINGLETHREADED. Has nothing to create after AOFX_SHADER_CREATION_ALL.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_PrewarmShaders(const AOFX_Desc & desc, const AOFX_QualityLevel * pLevels, uint levelCount, bool background);
+
+    /**
+    Query how many shader objects AOFX created, when, and how long it took
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_GetShaderStats(const AOFX_Desc & desc, AOFX_ShaderStats * pStats);
+
+    /**
+    Query whether AOFX_Initialize and AOFX_Render accept active layers of a kernel type, which depends on the
+    shader permutations the library was built with. Does not require a device or an initialized AOFX_Desc.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_GetKernelSupport(AOFX_KERNEL_TYPE kernelType, bool * pSupported);
+
+    /**
+    Predict the per stage cost and the memory footprint of a configuration without rendering it.
+    Does not require a device, the following AOFX_Desc members are used:
+    * m_InputSize, m_MaxInputSize (memory only)
+    * m_Implementation
+    * m_LayerProcess, m_MultiResLayerScale, m_NormalOption, m_SampleCount, m_BilateralBlurRadius
+    * m_DepthUpsampleThreshold
+    The model does not include the 2x2 fallback taps of depth aware upsampling at depth discontinuities.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_EstimateCost(const AOFX_Desc & desc, AOFX_CostEstimate * pEstimate);
+
+    /**
+    Reset the governor and apply its start level to desc.
+    If *pResizeRequired is set on return, the application has to call AOFX_Resize before the next AOFX_Render.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_GovernorInitialize(AOFX_Governor * pGovernor, const AOFX_GovernorDesc & governorDesc, AOFX_Desc & desc, bool * pResizeRequired);
+
+    /**
+    Feed the measured AO time of the last frame (e.g. the "AMD_AOFX" TimerEx event) to the governor.
+    The governor steps at most one level per call and writes the new level to desc.
+    If *pResizeRequired is set on return, the application has to call AOFX_Resize before the next AOFX_Render.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_GovernorUpdate(AOFX_Governor * pGovernor, float milliseconds, AOFX_Desc & desc, bool * pResizeRequired);
+
+    /**
+    Execute AOFX on the CPU for a batch of depth images (probe faces, impostor atlases, etc.)
+    This function does not require a device, m_pDevice / m_pDeviceContext and all views are ignored.
+    AO parameters are taken from the desc layers exactly as AOFX_Render would use them, with the following exceptions:
+    * m_NormalOption is treated as AOFX_NORMAL_OPTION_NONE (batch images carry depth only)
+    * m_Implementation is ignored
+    Images are distributed across a pool of worker threads, each worker loads, linearizes, computes AO, blurs and stores
+    one image at a time. Worker scratch surfaces are reused between consecutive images of the same size.
+    pStats is optional and receives throughput numbers (images/sec).
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_RenderBatch(const AOFX_Desc & desc, const AOFX_BatchDesc & batch, AOFX_BatchStats * pStats);
+
+    /**
+    Compare quality per millisecond of every AOFX_KERNEL_TYPE at every AOFX_SAMPLE_COUNT on the CPU.
+    The image is rendered with the CPU path used by AOFX_RenderBatch, all active layers are switched to the measured
+    kernel type and sample count, every other desc option is left as is.
+    pResults must point to an array of AOFX_KERNEL_TYPE_COUNT * AOFX_SAMPLE_COUNT_COUNT elements,
+    it is filled in kernel major order (pResults[kernel * AOFX_SAMPLE_COUNT_COUNT + sampleCount]).
+    Timings are the best of 'iterations' runs (1 is used when 0 is passed).
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_CompareKernels(const AOFX_Desc & desc, const AOFX_BatchImage & image, uint iterations, AOFX_KernelComparison * pResults);
+
+    /**
+    Search the AOFX_AutotuneDesc parameter space for the best quality per cost on a corpus of depth images.
+    Every candidate is rendered with the CPU path used by AOFX_RenderBatch and scored (SSIM and PSNR) against
+    a reference that keeps the desc layers at their own scale with AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE,
+    AOFX_SAMPLE_COUNT_ULTRA and AOFX_TAP_TYPE_FIXED. Layers enabled by m_LayerMask are added to the reference.
+    Candidates that are not beaten in SSIM by a cheaper one form the frontier written to pResult->m_pPresets;
+    a frontier larger than m_MaxPresetCount is thinned evenly, keeping the highest and lowest quality presets.
+    Images have to be at least 8x8, batch images carry depth only so m_NormalOption is treated as NONE.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_Autotune(const AOFX_Desc & desc, const AOFX_AutotuneDesc & autotune, AOFX_AutotuneResult * pResult);
+
+    /**
+    Create a device and immediate context that record commands instead of executing them.
+    Resources, views, shaders and states are created as CPU side objects, buffers can be mapped
+    (textures cannot) and no command touches a GPU, so AOFX_Initialize, AOFX_Resize and AOFX_Render
+    can be run and measured on any machine. The context keeps the bound pipeline state and returns it
+    from its Get calls, so state restore can be checked. Both interfaces have to be released by the caller.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_CreateNullDevice(ID3D11Device ** ppDevice, ID3D11DeviceContext ** ppDeviceContext);
+
+    /**
+    Read or reset the counters of a context created by AOFX_CreateNullDevice.
+    AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT is returned for any other context.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_GetDeviceCounters(ID3D11DeviceContext * pDeviceContext, AOFX_DeviceCounters * pCounters);
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_ResetDeviceCounters(ID3D11DeviceContext * pDeviceContext);
+
+    /**
+    Measure the CPU time of AOFX_Render for every level in pLevels (or for desc as is when pLevels is NULL).
+    Each level is applied to desc (calling AOFX_Resize when it reallocates surfaces), rendered once to warm up
+    and then rendered 'frames' times. pResults must point to an array of levelCount elements (1 when pLevels is NULL).
+    The original desc settings are restored before returning.
+    Works with any device, command counters are only recorded when desc uses the null device.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_BenchmarkRender(AOFX_Desc & desc, const AOFX_QualityLevel * pLevels, uint levelCount, uint frames, AOFX_RenderBenchmark * pResults);
+
+    /**
+    Create a capture file that frames are appended to one at a time.
+    Every frame stores depth, normals (when present), the camera and the AOFX_Desc settings. Depth and normal planes
+    are compressed losslessly with a plane predictor and an adaptive Golomb-Rice coder, AOFX_CaptureClose writes a
+    frame index so AOFX_ReplayReadFrame can seek to any frame. A file that was never closed can still be replayed.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_CaptureOpen(const char * fileName, AOFX_CaptureStream ** ppStream);
+
+    /**
+    Append the current input of desc to a capture.
+    Calling this function requires setting up m_pDevice, m_pDeviceContext, m_pDepthSRV and m_InputSize, m_pNormalSRV is optional.
+    The top left m_InputSize texels are read back through staging textures that are reused while the input resources keep their size.
+    Depth views have to be R32_FLOAT, R32_FLOAT_X8X24_TYPELESS, R24_UNORM_X8_TYPELESS or R16_UNORM, multisampled inputs are not supported.
+    Read back stalls the device context, this function is meant for debugging and regression captures.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_CaptureAppend(AOFX_CaptureStream * pStream, const AOFX_Desc & desc);
+
+    /**
+    Append a CPU depth image to a capture, the settings are taken from desc and the camera from the image.
+    The image is stored as R32_FLOAT depth without normals.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_CaptureAppendImage(AOFX_CaptureStream * pStream, const AOFX_Desc & desc, const AOFX_BatchImage & image);
+
+    /**
+    Write the frame index and close the capture. pStats is optional.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_CaptureClose(AOFX_CaptureStream * pStream, AOFX_CaptureStats * pStats);
+
+    /**
+    Open a capture for replay. Captures without an index (the application exited before AOFX_CaptureClose)
+    are indexed by scanning their frames, a truncated last frame is dropped.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_ReplayOpen(const char * fileName, AOFX_ReplayStream ** ppStream);
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_ReplayGetFrameCount(AOFX_ReplayStream * pStream, uint * pFrameCount);
+
+    /**
+    Decode a single frame. pDesc is optional and receives the captured settings, camera and m_InputSize.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_ReplayReadFrame(AOFX_ReplayStream * pStream, uint frame, AOFX_ReplayFrame * pFrame, AOFX_Desc * pDesc);
+
+    /**
+    Execute the CPU reference path of AOFX_RenderBatch on frames [firstFrame, firstFrame + frameCount) of a capture.
+    Every frame is rendered with the settings and camera captured with it, the original desc settings are restored before returning.
+    Frames are decoded by the batch workers as they load them. From batch only m_ThreadCount, m_pStore and m_pUserData are used,
+    the store callback receives the frame number as its index. Without a store callback the frames are only rendered (for timing).
+    pStats is optional and is summed over all frames.
+    */
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_ReplayRender(AOFX_ReplayStream * pStream, AOFX_Desc & desc, uint firstFrame, uint frameCount, const AOFX_BatchDesc & batch, AOFX_BatchStats * pStats);
+
+    AMD_AOFX_DLL_API AOFX_RETURN_CODE   AOFX_ReplayClose(AOFX_ReplayStream * pStream);
+
     /**
     This debugging code is currently disabled
     */
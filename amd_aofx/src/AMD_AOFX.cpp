@@ -24,6 +24,7 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <chrono>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -33,6 +34,7 @@
 #endif
 
 #include "AMD_AOFX_OPAQUE.h"
+#include "AMD_AOFX_CPU.h"
 
 namespace AMD
 {
@@ -51,12 +53,18 @@ AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_Initialize(const AOFX_Desc & desc)
         return AOFX_RETURN_CODE_INVALID_DEVICE;
     }
 
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
     result = desc.m_pOpaque->cbInitialize(desc);
     if (result != AOFX_RETURN_CODE_SUCCESS)
         return result;
 
     result = desc.m_pOpaque->createShaders(desc);
 
+    float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(desc.m_pOpaque->m_ShaderLock);
+    desc.m_pOpaque->m_ShaderStats.m_InitializeMilliseconds = milliseconds;
+
     return result;
 }
 
@@ -72,6 +80,25 @@ AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_Render(const AOFX_Desc & desc)
         return AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT;
     }
 
+    if (desc.m_StateRestore == AOFX_STATE_RESTORE_NONE)
+    {
+        return desc.m_pOpaque->render(desc);
+    }
+    if (desc.m_StateRestore == AOFX_STATE_RESTORE_USED)
+    {
+        // render targets, viewports and scissor rects are set with fewer slots than the application may use,
+        // which unbinds the remaining ones, so IA/RS/OM are restored in full
+        AMD::C_SaveRestore_IA save_ia(desc.m_pDeviceContext, AOFX_OpaqueDesc::m_UsedVertexBufferSlots);
+        AMD::C_SaveRestore_VS save_vs(desc.m_pDeviceContext, 0, 0, 0);
+        AMD::C_SaveRestore_GS save_gs(desc.m_pDeviceContext, 0, 0, 0);
+        AMD::C_SaveRestore_PS save_ps(desc.m_pDeviceContext, AOFX_OpaqueDesc::m_UsedSamplerSlots, AOFX_OpaqueDesc::m_UsedConstantBufferSlots, AOFX_OpaqueDesc::m_UsedSRVSlots);
+        AMD::C_SaveRestore_RS save_rs(desc.m_pDeviceContext);
+        AMD::C_SaveRestore_OM save_om(desc.m_pDeviceContext);
+        AMD::C_SaveRestore_CS save_cs(desc.m_pDeviceContext, AOFX_OpaqueDesc::m_UsedSamplerSlots, AOFX_OpaqueDesc::m_UsedConstantBufferSlots, AOFX_OpaqueDesc::m_UsedSRVSlots, AOFX_OpaqueDesc::m_UsedUAVSlots);
+
+        return desc.m_pOpaque->render(desc);
+    }
+
     AMD::C_SaveRestore_IA save_ia(desc.m_pDeviceContext);
     AMD::C_SaveRestore_VS save_vs(desc.m_pDeviceContext);
     AMD::C_SaveRestore_HS save_hs(desc.m_pDeviceContext);
@@ -120,6 +147,245 @@ AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_Release(const AOFX_Desc & desc)
     return AOFX_RETURN_CODE_SUCCESS;
 }
 
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_GetMemoryUsage(const AOFX_Desc & desc, AOFX_MemoryUsage * pUsage)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pUsage == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    desc.m_pOpaque->getMemoryUsage(*pUsage);
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_PrewarmShaders(const AOFX_Desc & desc, const AOFX_QualityLevel * pLevels, uint levelCount, bool background)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pLevels == NULL && levelCount != 0)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    return desc.m_pOpaque->prewarmShaders(desc, pLevels, levelCount, background);
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_GetShaderStats(const AOFX_Desc & desc, AOFX_ShaderStats * pStats)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStats == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    desc.m_pOpaque->getShaderStats(*pStats);
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_GetKernelSupport(AOFX_KERNEL_TYPE kernelType, bool * pSupported)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pSupported == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (kernelType < 0 || kernelType >= AOFX_KERNEL_TYPE_COUNT)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    *pSupported = AOFX_OpaqueDesc::kernelSupported(kernelType);
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_EstimateCost(const AOFX_Desc & desc, AOFX_CostEstimate * pEstimate)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pEstimate == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (desc.m_InputSize.x == 0 || desc.m_InputSize.y == 0)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    desc.m_pOpaque->estimateCost(desc, *pEstimate);
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_RenderBatch(const AOFX_Desc & desc, const AOFX_BatchDesc & batch, AOFX_BatchStats * pStats)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (batch.m_pImages == NULL && batch.m_pLoad == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (batch.m_ImageCount == 0)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    AOFX_RETURN_CODE result = AOFX_CpuRenderBatch(desc, batch, pStats);
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_CompareKernels(const AOFX_Desc & desc, const AOFX_BatchImage & image, uint iterations, AOFX_KernelComparison * pResults)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (image.m_pDepth == NULL || pResults == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (image.m_Size.x == 0 || image.m_Size.y == 0)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    AOFX_RETURN_CODE result = AOFX_CpuCompareKernels(desc, image, MAX(iterations, (uint)1), pResults);
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static AOFX_RETURN_CODE benchmarkLevel(AOFX_Desc & desc, const AOFX_QualityLevel * pLevel, uint frames, AOFX_RenderBenchmark & benchmark)
+{
+    AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
+
+    if (pLevel != NULL)
+    {
+        bool resize = AOFX_OpaqueDesc::requiresResize(*pLevel, desc);
+        AOFX_OpaqueDesc::applyQualityLevel(*pLevel, desc);
+
+        if (resize)
+        {
+            result = AOFX_Resize(desc);
+            if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        }
+    }
+
+    // the first render after a change creates constant data and may hit cold caches, keep it out of the numbers
+    result = AOFX_Render(desc);
+    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+
+    bool counted = AOFX_ResetDeviceCounters(desc.m_pDeviceContext) == AOFX_RETURN_CODE_SUCCESS;
+
+    double total = 0.0;
+    benchmark = AOFX_RenderBenchmark();
+    benchmark.m_MinNanoseconds = 1e300;
+
+    for (uint i = 0; i < frames; i++)
+    {
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+        result = AOFX_Render(desc);
+
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+
+        total += ns;
+        benchmark.m_MinNanoseconds = MIN(benchmark.m_MinNanoseconds, ns);
+        benchmark.m_MaxNanoseconds = MAX(benchmark.m_MaxNanoseconds, ns);
+    }
+
+    benchmark.m_Frames = frames;
+    benchmark.m_NanosecondsPerRender = total / frames;
+
+    if (counted)
+        AOFX_GetDeviceCounters(desc.m_pDeviceContext, &benchmark.m_Counters);
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_BenchmarkRender(AOFX_Desc & desc, const AOFX_QualityLevel * pLevels, uint levelCount, uint frames, AOFX_RenderBenchmark * pResults)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pResults == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (frames == 0 || (pLevels != NULL && levelCount == 0))
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+    if (NULL == desc.m_pDeviceContext)
+    {
+        return AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT;
+    }
+
+    AOFX_QualityLevel original;
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        original.m_LayerProcess[i] = desc.m_LayerProcess[i];
+        original.m_MultiResLayerScale[i] = desc.m_MultiResLayerScale[i];
+        original.m_SampleCount[i] = desc.m_SampleCount[i];
+        original.m_BilateralBlurRadius[i] = desc.m_BilateralBlurRadius[i];
+    }
+
+    AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
+
+    if (pLevels == NULL)
+    {
+        result = benchmarkLevel(desc, NULL, frames, pResults[0]);
+    }
+    else
+    {
+        for (uint i = 0; i < levelCount && result == AOFX_RETURN_CODE_SUCCESS; i++)
+            result = benchmarkLevel(desc, &pLevels[i], frames, pResults[i]);
+
+        bool resize = AOFX_OpaqueDesc::requiresResize(original, desc);
+        AOFX_OpaqueDesc::applyQualityLevel(original, desc);
+
+        if (resize)
+        {
+            AOFX_RETURN_CODE restored = AOFX_Resize(desc);
+            if (result == AOFX_RETURN_CODE_SUCCESS) result = restored;
+        }
+    }
+
+    return result;
+}
+
 //-------------------------------------------------------------------------------------------------
 // 
 //-------------------------------------------------------------------------------------------------
@@ -133,6 +399,9 @@ AOFX_Desc::AOFX_Desc()
     , m_pOpaque(NULL)
     , m_OutputChannelsFlag(0xF)
     , m_pOutputBS(NULL)
+    , m_pInstrumentation(NULL)
+    , m_StateRestore(AOFX_STATE_RESTORE_FULL)
+    , m_ShaderCreation(AOFX_SHADER_CREATION_ALL)
 {
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
@@ -156,8 +425,272 @@ AOFX_Desc::AOFX_Desc()
         m_SampleCount[i] = AOFX_SAMPLE_COUNT_LOW;
         m_NormalOption[i] = AOFX_NORMAL_OPTION_NONE;
         m_TapType[i] = AOFX_TAP_TYPE_FIXED;
+        m_KernelType[i] = AOFX_KERNEL_TYPE_HDAO;
     }
 
+    m_MaxInputSize.x = m_MaxInputSize.y = 0;
+
     m_pOpaque = &opaque;
 }
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_BatchImage::AOFX_BatchImage()
+    : m_pDepth(NULL)
+    , m_pOutput(NULL)
+    , m_pUserData(NULL)
+{
+    m_Size.x = m_Size.y = 0;
+    memset(&m_Camera, 0, sizeof(m_Camera));
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_BatchDesc::AOFX_BatchDesc()
+    : m_pImages(NULL)
+    , m_ImageCount(0)
+    , m_ThreadCount(0)
+    , m_pLoad(NULL)
+    , m_pStore(NULL)
+    , m_pUserData(NULL)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_BatchStats::AOFX_BatchStats()
+    : m_ImagesProcessed(0)
+    , m_ImagesFailed(0)
+    , m_ThreadCount(0)
+    , m_ScratchAllocations(0)
+    , m_Seconds(0.0)
+    , m_ImagesPerSecond(0.0)
+    , m_MegaTexelsPerSecond(0.0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_KernelComparison::AOFX_KernelComparison()
+    : m_KernelType(AOFX_KERNEL_TYPE_HDAO)
+    , m_SampleCount(AOFX_SAMPLE_COUNT_LOW)
+    , m_Milliseconds(0.0)
+    , m_RMSE(0.0)
+    , m_PSNR(0.0)
+    , m_PSNRPerMillisecond(0.0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_MemoryUsage::AOFX_MemoryUsage()
+    : m_DilateAO(0)
+    , m_BlurAO(0)
+    , m_Buffers(0)
+    , m_Total(0)
+{
+    for (AMD::uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        m_ResultAO[i] = 0;
+        m_InputAO[i] = 0;
+        m_UpsampleAO[i] = 0;
+        m_BlurLayerAO[i] = 0;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_Instrumentation::AOFX_Instrumentation()
+    : m_pBeginStage(NULL)
+    , m_pEndStage(NULL)
+    , m_pUserData(NULL)
+{
+}
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_StageCost::AOFX_StageCost()
+    : m_Stage(AOFX_STAGE_COUNT)
+    , m_Layer(0)
+    , m_Passes(0)
+    , m_ThreadGroups(0)
+    , m_TexelsProcessed(0)
+    , m_Taps(0)
+    , m_LdsLoads(0)
+    , m_BytesRead(0)
+    , m_BytesWritten(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_CostEstimate::AOFX_CostEstimate()
+    : m_StageCount(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_ShaderStats::AOFX_ShaderStats()
+    : m_ShadersCreated(0)
+    , m_ShadersCreatedByRender(0)
+    , m_ShadersPrewarmed(0)
+    , m_PermutationCount(0)
+    , m_InitializeMilliseconds(0.0f)
+    , m_CreateMilliseconds(0.0f)
+    , m_UnpackMilliseconds(0.0f)
+    , m_UnpackedBytes(0)
+    , m_PrewarmPending(false)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_QualityLevel::AOFX_QualityLevel()
+{
+    for (AMD::uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        m_LayerProcess[i] = AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE;
+        m_MultiResLayerScale[i] = 1.0f / powf(2.0f, (float)i);
+        m_SampleCount[i] = AOFX_SAMPLE_COUNT_LOW;
+        m_BilateralBlurRadius[i] = AOFX_BILATERAL_BLUR_RADIUS_NONE;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_GovernorDesc::AOFX_GovernorDesc()
+    : m_pLevels(NULL)
+    , m_LevelCount(0)
+    , m_StartLevel(0)
+    , m_BudgetMilliseconds(2.0f)
+    , m_Hysteresis(0.15f)
+    , m_Smoothing(0.2f)
+    , m_DowngradeFrames(4)
+    , m_UpgradeFrames(60)
+    , m_ResizeFrameScale(4)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_Governor::AOFX_Governor()
+    : m_Level(0)
+    , m_AverageMilliseconds(0.0f)
+    , m_OverBudgetFrames(0)
+    , m_UnderBudgetFrames(0)
+    , m_FramesAtLevel(0)
+    , m_UpgradeBackoff(1)
+    , m_Upgraded(false)
+    , m_LevelChanges(0)
+    , m_Resizes(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_AutotuneDesc::AOFX_AutotuneDesc()
+    : m_pImages(NULL)
+    , m_ImageCount(0)
+    , m_ThreadCount(0)
+    , m_LayerMask(0)
+    , m_LayerProcessMask(0)
+    , m_SampleCountMask(0)
+    , m_TapTypeMask(0)
+    , m_BlurRadiusMask(0)
+    , m_pLayerScales(NULL)
+    , m_LayerScaleCount(0)
+    , m_MeasuredCost(false)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_AutotunePreset::AOFX_AutotunePreset()
+    : m_TapType(AOFX_TAP_TYPE_FIXED)
+    , m_SSIM(0.0)
+    , m_PSNR(0.0)
+    , m_Milliseconds(0.0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_AutotuneResult::AOFX_AutotuneResult()
+    : m_pPresets(NULL)
+    , m_MaxPresetCount(0)
+    , m_PresetCount(0)
+    , m_CandidateCount(0)
+    , m_FrontierCount(0)
+    , m_Seconds(0.0)
+{
+}
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_DeviceCounters::AOFX_DeviceCounters()
+    : m_Maps(0)
+    , m_Unmaps(0)
+    , m_StateBinds(0)
+    , m_StateQueries(0)
+    , m_Dispatches(0)
+    , m_Draws(0)
+    , m_Copies(0)
+    , m_Clears(0)
+    , m_ObjectsCreated(0)
+    , m_ObjectsReleased(0)
+    , m_BytesUploaded(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RenderBenchmark::AOFX_RenderBenchmark()
+    : m_Frames(0)
+    , m_NanosecondsPerRender(0.0)
+    , m_MinNanoseconds(0.0)
+    , m_MaxNanoseconds(0.0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_CaptureStats::AOFX_CaptureStats()
+    : m_FrameCount(0)
+    , m_RawBytes(0)
+    , m_CompressedBytes(0)
+    , m_ReadbackMilliseconds(0.0)
+    , m_EncodeMilliseconds(0.0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_ReplayFrame::AOFX_ReplayFrame()
+    : m_FrameIndex(0)
+    , m_DepthFormat(0)
+    , m_NormalFormat(0)
+    , m_NormalStride(0)
+    , m_pDepth(NULL)
+    , m_pNormal(NULL)
+{
+    m_Size.x = m_Size.y = 0;
+    memset(&m_Camera, 0, sizeof(m_Camera));
+}
 }
\ No newline at end of file
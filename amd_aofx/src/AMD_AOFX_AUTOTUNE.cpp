@@ -0,0 +1,455 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include <d3d11.h>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <xmmintrin.h>
+
+#include <cmath>
+
+#if AMD_AOFX_COMPILE_DYNAMIC_LIB
+# define AMD_DLL_EXPORTS
+#endif
+
+#include "AMD_AOFX_CPU.h"
+
+namespace AMD
+{
+// SSIM window, constants for AO values in [0, 1] range
+static const uint   s_SSIMWindowSize = 8;
+static const uint   s_SSIMWindowStride = 4;
+static const double s_SSIMC1 = 0.01 * 0.01;
+static const double s_SSIMC2 = 0.03 * 0.03;
+
+struct AutotuneCandidate
+{
+    AOFX_QualityLevel                       m_Level;
+    AOFX_TAP_TYPE                           m_TapType;
+    AOFX_StageCost                          m_PredictedCost;
+};
+
+struct AutotuneScore
+{
+    double                                  m_SSIM;
+    double                                  m_PSNR;
+    double                                  m_Seconds;
+
+    AutotuneScore() : m_SSIM(0.0), m_PSNR(0.0), m_Seconds(0.0) {}
+};
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static inline float horizontalSum(__m128 value)
+{
+    __m128 shuffled = _mm_add_ps(value, _mm_movehl_ps(value, value));
+    shuffled = _mm_add_ss(shuffled, _mm_shuffle_ps(shuffled, shuffled, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(shuffled);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Mean SSIM over s_SSIMWindowSize square windows placed every s_SSIMWindowStride texels,
+// each window row is loaded as two 4 wide vectors
+//-------------------------------------------------------------------------------------------------
+double AOFX_CpuSSIM(const float * pImage, const float * pReference, uint width, uint height)
+{
+    const double count = s_SSIMWindowSize * s_SSIMWindowSize;
+    double ssim = 0.0;
+    uint   windows = 0;
+
+    for (uint y = 0; y + s_SSIMWindowSize <= height; y += s_SSIMWindowStride)
+    {
+        for (uint x = 0; x + s_SSIMWindowSize <= width; x += s_SSIMWindowStride)
+        {
+            __m128 sumA = _mm_setzero_ps(), sumB = _mm_setzero_ps();
+            __m128 sumAA = _mm_setzero_ps(), sumBB = _mm_setzero_ps(), sumAB = _mm_setzero_ps();
+
+            for (uint row = 0; row < s_SSIMWindowSize; row++)
+            {
+                const float * pA = pImage + (size_t)(y + row) * width + x;
+                const float * pB = pReference + (size_t)(y + row) * width + x;
+
+                for (uint column = 0; column < s_SSIMWindowSize; column += 4)
+                {
+                    __m128 a = _mm_loadu_ps(pA + column);
+                    __m128 b = _mm_loadu_ps(pB + column);
+
+                    sumA = _mm_add_ps(sumA, a);
+                    sumB = _mm_add_ps(sumB, b);
+                    sumAA = _mm_add_ps(sumAA, _mm_mul_ps(a, a));
+                    sumBB = _mm_add_ps(sumBB, _mm_mul_ps(b, b));
+                    sumAB = _mm_add_ps(sumAB, _mm_mul_ps(a, b));
+                }
+            }
+
+            double meanA = horizontalSum(sumA) / count;
+            double meanB = horizontalSum(sumB) / count;
+            double varianceA = MAX(horizontalSum(sumAA) / count - meanA * meanA, 0.0);
+            double varianceB = MAX(horizontalSum(sumBB) / count - meanB * meanB, 0.0);
+            double covariance = horizontalSum(sumAB) / count - meanA * meanB;
+
+            ssim += ((2.0 * meanA * meanB + s_SSIMC1) * (2.0 * covariance + s_SSIMC2)) /
+                    ((meanA * meanA + meanB * meanB + s_SSIMC1) * (varianceA + varianceB + s_SSIMC2));
+            windows++;
+        }
+    }
+
+    return windows > 0 ? ssim / windows : 1.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Squared error is summed 4 wide per row and accumulated in double precision between rows
+//-------------------------------------------------------------------------------------------------
+double AOFX_CpuPSNR(const float * pImage, const float * pReference, uint width, uint height)
+{
+    double squaredError = 0.0;
+
+    for (uint y = 0; y < height; y++)
+    {
+        const float * pA = pImage + (size_t)y * width;
+        const float * pB = pReference + (size_t)y * width;
+        __m128 sum = _mm_setzero_ps();
+        uint x = 0;
+
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128 delta = _mm_sub_ps(_mm_loadu_ps(pA + x), _mm_loadu_ps(pB + x));
+            sum = _mm_add_ps(sum, _mm_mul_ps(delta, delta));
+        }
+
+        double rowError = horizontalSum(sum);
+        for (; x < width; x++)
+            rowError += (double)(pA[x] - pB[x]) * (pA[x] - pB[x]);
+
+        squaredError += rowError;
+    }
+
+    double rmse = sqrt(squaredError / ((double)width * height));
+
+    return rmse > 0.0 ? MIN(-20.0 * log10(rmse), 100.0) : 100.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Copies every setting AOFX_CpuDesc::render reads, AOFX_Desc itself is not copyable
+//-------------------------------------------------------------------------------------------------
+static void copySettings(const AOFX_Desc & source, AOFX_Desc & target)
+{
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        target.m_LayerProcess[i] = source.m_LayerProcess[i];
+        target.m_BilateralBlurRadius[i] = source.m_BilateralBlurRadius[i];
+        target.m_SampleCount[i] = source.m_SampleCount[i];
+        target.m_NormalOption[i] = source.m_NormalOption[i];
+        target.m_TapType[i] = source.m_TapType[i];
+        target.m_KernelType[i] = source.m_KernelType[i];
+        target.m_MultiResLayerScale[i] = source.m_MultiResLayerScale[i];
+        target.m_PowIntensity[i] = source.m_PowIntensity[i];
+        target.m_RejectRadius[i] = source.m_RejectRadius[i];
+        target.m_AcceptRadius[i] = source.m_AcceptRadius[i];
+        target.m_RecipFadeOutDist[i] = source.m_RecipFadeOutDist[i];
+        target.m_LinearIntensity[i] = source.m_LinearIntensity[i];
+        target.m_NormalScale[i] = source.m_NormalScale[i];
+        target.m_ViewDistanceDiscard[i] = source.m_ViewDistanceDiscard[i];
+        target.m_ViewDistanceFade[i] = source.m_ViewDistanceFade[i];
+        target.m_DepthUpsampleThreshold[i] = source.m_DepthUpsampleThreshold[i];
+    }
+
+    target.m_Implementation = source.m_Implementation;
+    target.m_InputSize = source.m_InputSize;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static void applyCandidate(const AutotuneCandidate & candidate, AOFX_Desc & desc)
+{
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        desc.m_LayerProcess[i] = candidate.m_Level.m_LayerProcess[i];
+        desc.m_MultiResLayerScale[i] = candidate.m_Level.m_MultiResLayerScale[i];
+        desc.m_SampleCount[i] = candidate.m_Level.m_SampleCount[i];
+        desc.m_BilateralBlurRadius[i] = candidate.m_Level.m_BilateralBlurRadius[i];
+        desc.m_TapType[i] = candidate.m_TapType;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Enumerates the cartesian product of the autotune space, values not covered by a mask are
+// taken from the first active layer of the desc
+//-------------------------------------------------------------------------------------------------
+static void enumerateCandidates(const AOFX_Desc & desc, const AOFX_AutotuneDesc & autotune, uint layerMask, std::vector<AutotuneCandidate> & candidates)
+{
+    uint first = 0;
+    while (first < AOFX_Desc::m_MultiResLayerCount - 1 && desc.m_LayerProcess[first] == AOFX_LAYER_PROCESS_NONE) first++;
+
+    AOFX_LAYER_PROCESS firstProcess = desc.m_LayerProcess[first] != AOFX_LAYER_PROCESS_NONE ? desc.m_LayerProcess[first] : AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE;
+
+    uint processMask = autotune.m_LayerProcessMask != 0 ? autotune.m_LayerProcessMask : (1u << firstProcess);
+    uint sampleMask = autotune.m_SampleCountMask != 0 ? autotune.m_SampleCountMask : (1u << desc.m_SampleCount[first]);
+    uint tapMask = autotune.m_TapTypeMask != 0 ? autotune.m_TapTypeMask : (1u << desc.m_TapType[first]);
+    uint blurMask = autotune.m_BlurRadiusMask != 0 ? autotune.m_BlurRadiusMask : (1u << (desc.m_BilateralBlurRadius[first] + 1));
+
+    static const float defaultScale = 1.0f;
+    const float * pScales = autotune.m_pLayerScales != NULL ? autotune.m_pLayerScales : &defaultScale;
+    uint scaleCount = autotune.m_pLayerScales != NULL ? autotune.m_LayerScaleCount : 1;
+
+    AOFX_Desc estimateDesc;
+    copySettings(desc, estimateDesc);
+    estimateDesc.m_InputSize = autotune.m_pImages[0].m_Size;
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+        estimateDesc.m_NormalOption[i] = AOFX_NORMAL_OPTION_NONE;
+
+    for (uint layers = 1; layers < (1u << AOFX_Desc::m_MultiResLayerCount); layers++)
+    {
+        if ((layers & ~layerMask) != 0) continue;
+
+        for (int process = 0; process < AOFX_LAYER_PROCESS_COUNT; process++)
+        for (int sample = 0; sample < AOFX_SAMPLE_COUNT_COUNT; sample++)
+        for (int tap = 0; tap < AOFX_TAP_TYPE_COUNT; tap++)
+        for (int blur = AOFX_BILATERAL_BLUR_RADIUS_NONE; blur < AOFX_BILATERAL_BLUR_RADIUS_COUNT; blur++)
+        for (uint scale = 0; scale < scaleCount; scale++)
+        {
+            if ((processMask & (1u << process)) == 0 ||
+                (sampleMask & (1u << sample)) == 0 ||
+                (tapMask & (1u << tap)) == 0 ||
+                (blurMask & (1u << (blur + 1))) == 0)
+                continue;
+
+            AutotuneCandidate candidate;
+            candidate.m_TapType = (AOFX_TAP_TYPE)tap;
+
+            for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+            {
+                bool active = (layers & (1u << i)) != 0;
+
+                candidate.m_Level.m_LayerProcess[i] = active ? (AOFX_LAYER_PROCESS)process : AOFX_LAYER_PROCESS_NONE;
+                candidate.m_Level.m_MultiResLayerScale[i] = desc.m_MultiResLayerScale[i] * pScales[scale];
+                candidate.m_Level.m_SampleCount[i] = (AOFX_SAMPLE_COUNT)sample;
+                candidate.m_Level.m_BilateralBlurRadius[i] = (AOFX_BILATERAL_BLUR_RADIUS)blur;
+            }
+
+            AOFX_CostEstimate estimate;
+            applyCandidate(candidate, estimateDesc);
+            desc.m_pOpaque->estimateCost(estimateDesc, estimate);
+            candidate.m_PredictedCost = estimate.m_Total;
+
+            candidates.push_back(candidate);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static double candidateCost(const AOFX_AutotunePreset & preset, bool measured)
+{
+    return measured ? preset.m_Milliseconds : (double)preset.m_PredictedCost.m_Taps;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Every image is rendered once with the reference settings and once per candidate. Images are
+// distributed across worker threads like AOFX_CpuRenderBatch, each worker accumulates its own
+// scores so no synchronization is needed until the workers are joined
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_CpuAutotune(const AOFX_Desc & desc, const AOFX_AutotuneDesc & autotune, AOFX_AutotuneResult & result)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    uint layerMask = autotune.m_LayerMask;
+    if (layerMask == 0)
+    {
+        for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+            layerMask |= desc.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE ? (1u << i) : 0;
+    }
+    if (layerMask == 0) return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+    std::vector<AutotuneCandidate> candidates;
+    enumerateCandidates(desc, autotune, layerMask, candidates);
+    if (candidates.empty()) return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4>  cbSamplePattern(1);
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SBYTE2> t1dSamplePattern(1);
+    AOFX_OpaqueDesc::generateSamplePatterns(cbSamplePattern[0], t1dSamplePattern[0]);
+
+    uint threadCount = autotune.m_ThreadCount != 0 ? autotune.m_ThreadCount : std::thread::hardware_concurrency();
+    threadCount = MIN(MAX(threadCount, (uint)1), autotune.m_ImageCount);
+
+    std::vector< std::vector<AutotuneScore> > scores(threadCount, std::vector<AutotuneScore>(candidates.size()));
+    std::vector<AOFX_RETURN_CODE> codes(threadCount, AOFX_RETURN_CODE_SUCCESS);
+    std::atomic<uint> nextImage(0);
+
+    auto worker = [&](uint workerIndex)
+    {
+        AOFX_CpuDesc cpuDesc(&cbSamplePattern[0]);
+        AOFX_Desc referenceDesc, candidateDesc;
+        std::vector<float> reference, output;
+
+        copySettings(desc, referenceDesc);
+        copySettings(desc, candidateDesc);
+
+        for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+        {
+            bool active = (layerMask & (1u << i)) != 0;
+            referenceDesc.m_LayerProcess[i] = active ? AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE : AOFX_LAYER_PROCESS_NONE;
+            referenceDesc.m_SampleCount[i] = AOFX_SAMPLE_COUNT_ULTRA;
+            referenceDesc.m_TapType[i] = AOFX_TAP_TYPE_FIXED;
+        }
+
+        for (uint index = nextImage++; index < autotune.m_ImageCount; index = nextImage++)
+        {
+            AOFX_BatchImage image = autotune.m_pImages[index];
+            size_t size = (size_t)image.m_Size.x * image.m_Size.y;
+
+            reference.resize(size);
+            output.resize(size);
+
+            image.m_pOutput = &reference[0];
+            AOFX_RETURN_CODE code = cpuDesc.render(referenceDesc, image);
+
+            for (size_t candidate = 0; candidate < candidates.size() && code == AOFX_RETURN_CODE_SUCCESS; candidate++)
+            {
+                applyCandidate(candidates[candidate], candidateDesc);
+                image.m_pOutput = &output[0];
+
+                std::chrono::high_resolution_clock::time_point renderStart = std::chrono::high_resolution_clock::now();
+                code = cpuDesc.render(candidateDesc, image);
+                std::chrono::duration<double> renderElapsed = std::chrono::high_resolution_clock::now() - renderStart;
+
+                AutotuneScore & score = scores[workerIndex][candidate];
+                score.m_Seconds += renderElapsed.count();
+                score.m_SSIM += AOFX_CpuSSIM(&output[0], &reference[0], image.m_Size.x, image.m_Size.y);
+                score.m_PSNR += AOFX_CpuPSNR(&output[0], &reference[0], image.m_Size.x, image.m_Size.y);
+            }
+
+            if (code != AOFX_RETURN_CODE_SUCCESS)
+            {
+                codes[workerIndex] = code;
+                break;
+            }
+        }
+    };
+
+    // the calling thread is one of the workers
+    std::vector<std::thread> threads;
+    for (uint i = 1; i < threadCount; i++)
+        threads.push_back(std::thread(worker, i));
+    worker(0);
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    for (uint i = 0; i < threadCount; i++)
+    {
+        if (codes[i] != AOFX_RETURN_CODE_SUCCESS) return codes[i];
+    }
+
+    std::vector<AOFX_AutotunePreset> presets(candidates.size());
+    for (size_t candidate = 0; candidate < candidates.size(); candidate++)
+    {
+        AOFX_AutotunePreset & preset = presets[candidate];
+        preset.m_Level = candidates[candidate].m_Level;
+        preset.m_TapType = candidates[candidate].m_TapType;
+        preset.m_PredictedCost = candidates[candidate].m_PredictedCost;
+
+        for (uint i = 0; i < threadCount; i++)
+        {
+            preset.m_SSIM += scores[i][candidate].m_SSIM;
+            preset.m_PSNR += scores[i][candidate].m_PSNR;
+            preset.m_Milliseconds += scores[i][candidate].m_Seconds * 1000.0;
+        }
+
+        preset.m_SSIM /= autotune.m_ImageCount;
+        preset.m_PSNR /= autotune.m_ImageCount;
+        preset.m_Milliseconds /= autotune.m_ImageCount;
+    }
+
+    // cheapest first, a candidate joins the frontier if it beats the quality of every cheaper one
+    bool measured = autotune.m_MeasuredCost;
+    std::sort(presets.begin(), presets.end(), [measured](const AOFX_AutotunePreset & a, const AOFX_AutotunePreset & b)
+    {
+        double costA = candidateCost(a, measured), costB = candidateCost(b, measured);
+        return costA != costB ? costA < costB : a.m_SSIM > b.m_SSIM;
+    });
+
+    std::vector<AOFX_AutotunePreset> frontier;
+    for (size_t i = 0; i < presets.size(); i++)
+    {
+        if (frontier.empty() || presets[i].m_SSIM > frontier.back().m_SSIM)
+            frontier.push_back(presets[i]);
+    }
+    std::reverse(frontier.begin(), frontier.end());
+
+    uint frontierCount = (uint)frontier.size();
+    uint presetCount = MIN(frontierCount, result.m_MaxPresetCount);
+
+    for (uint i = 0; i < presetCount; i++)
+    {
+        uint source = presetCount > 1 ? (uint)(((uint64)i * (frontierCount - 1) + (presetCount - 1) / 2) / (presetCount - 1)) : 0;
+        result.m_pPresets[i] = frontier[source];
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    result.m_PresetCount = presetCount;
+    result.m_CandidateCount = (uint)candidates.size();
+    result.m_FrontierCount = frontierCount;
+    result.m_Seconds = elapsed.count();
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_Autotune(const AOFX_Desc & desc, const AOFX_AutotuneDesc & autotune, AOFX_AutotuneResult * pResult)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (autotune.m_pImages == NULL || pResult == NULL || (pResult->m_pPresets == NULL && pResult->m_MaxPresetCount != 0))
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (autotune.m_ImageCount == 0 || (autotune.m_pLayerScales != NULL && autotune.m_LayerScaleCount == 0))
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+    for (uint i = 0; i < autotune.m_ImageCount; i++)
+    {
+        if (autotune.m_pImages[i].m_pDepth == NULL)
+            return AOFX_RETURN_CODE_INVALID_POINTER;
+        if (autotune.m_pImages[i].m_Size.x < s_SSIMWindowSize || autotune.m_pImages[i].m_Size.y < s_SSIMWindowSize)
+            return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+    for (uint i = 0; autotune.m_pLayerScales != NULL && i < autotune.m_LayerScaleCount; i++)
+    {
+        if (autotune.m_pLayerScales[i] <= 0.0f || autotune.m_pLayerScales[i] > 1.0f)
+            return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    AOFX_RETURN_CODE result = AOFX_CpuAutotune(desc, autotune, *pResult);
+
+    return result;
+}
+}
\ No newline at end of file
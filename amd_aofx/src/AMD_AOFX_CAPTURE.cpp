@@ -0,0 +1,1277 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include <d3d11.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+#if AMD_AOFX_COMPILE_DYNAMIC_LIB
+# define AMD_DLL_EXPORTS
+#endif
+
+#include "AMD_AOFX_CPU.h"
+
+#pragma warning( disable : 4996 ) // disable "stdio is deprecated" warnings
+
+//-------------------------------------------------------------------------------------------------
+// Capture file layout, all values are little endian:
+// * file header - s_CaptureMagic, version and the size of CaptureFrameHeader
+// * frames      - CaptureFrameHeader followed by the compressed depth and normal planes
+// * index       - one 64 bit file offset per frame followed by CaptureFooter, written by AOFX_CaptureClose
+//
+// Every plane is coded on its own: texels are predicted from their left, upper and upper left neighbours
+// (the LOCO-I median predictor, a + b - c clamped to the range of a and b, left / up on the first row / column),
+// residuals are taken modulo the texel width, zigzag mapped and written with a Golomb-Rice code whose
+// parameter adapts per context. Contexts are selected by the magnitude of the neighbouring residuals.
+// Depth is coded as 32 bit (float bits, 24 bit unorm) or 16 bit words, normals as one plane per texel byte.
+//-------------------------------------------------------------------------------------------------
+namespace AMD
+{
+static const char   s_CaptureMagic[8] = { 'A', 'O', 'F', 'X', 'C', 'A', 'P', 'T' };
+static const uint   s_CaptureVersion = 1;
+static const uint   s_FrameMagic = 0x52464f41;         // "AOFR"
+static const uint   s_IndexMagic = 0x58494f41;         // "AOIX"
+static const uint   s_MaxCaptureSize = 16384;
+static const uint   s_MaxNormalStride = 16;
+static const uint   s_RiceContextCount = 34;           // one per bit length of the summed neighbour residuals
+static const uint   s_RiceResetCount = 64;             // context statistics are halved after this many values
+static const uint   s_RiceEscapeLength = 24;           // longer unary prefixes are replaced by the raw value
+
+struct CaptureFileHeader
+{
+    char                                    m_Magic[8];
+    uint                                    m_Version;
+    uint                                    m_FrameHeaderSize;
+};
+
+// AOFX_Desc settings stored with every frame
+struct CaptureSettings
+{
+    uint                                    m_LayerProcess[AOFX_Desc::m_MultiResLayerCount];
+    uint                                    m_BilateralBlurRadius[AOFX_Desc::m_MultiResLayerCount];
+    uint                                    m_SampleCount[AOFX_Desc::m_MultiResLayerCount];
+    uint                                    m_NormalOption[AOFX_Desc::m_MultiResLayerCount];
+    uint                                    m_TapType[AOFX_Desc::m_MultiResLayerCount];
+    uint                                    m_KernelType[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_MultiResLayerScale[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_PowIntensity[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_RejectRadius[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_AcceptRadius[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_RecipFadeOutDist[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_LinearIntensity[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_NormalScale[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_ViewDistanceDiscard[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_ViewDistanceFade[AOFX_Desc::m_MultiResLayerCount];
+    float                                   m_DepthUpsampleThreshold[AOFX_Desc::m_MultiResLayerCount];
+    uint                                    m_Implementation;
+    uint                                    m_OutputChannelsFlag;
+};
+
+struct CaptureFrameHeader
+{
+    uint                                    m_Magic;
+    uint                                    m_FrameIndex;
+    uint                                    m_Width;
+    uint                                    m_Height;
+    uint                                    m_DepthFormat;
+    uint                                    m_NormalFormat;
+    uint                                    m_NormalStride;
+    uint                                    m_DepthBytes;       // compressed plane sizes
+    uint                                    m_NormalBytes;
+    CaptureSettings                         m_Settings;
+    AOFX_Desc::Camera                       m_Camera;
+};
+
+struct CaptureFooter
+{
+    uint64                                  m_IndexOffset;
+    uint                                    m_FrameCount;
+    uint                                    m_Magic;
+};
+
+struct RiceContext
+{
+    uint64                                  m_Sum;              // summed zigzag residuals
+    uint                                    m_Count;
+};
+
+struct AOFX_CaptureStream
+{
+    FILE *                                  m_pFile;
+    std::vector<uint64>                     m_Index;
+    std::vector<uint8>                      m_Readback;
+    std::vector<uint32>                     m_Depth32;          // raw texels of the frame being appended
+    std::vector<uint16>                     m_Depth16;
+    std::vector<uint8>                      m_Normal;
+    std::vector<uint8>                      m_DepthPlane;       // compressed planes
+    std::vector<uint8>                      m_NormalPlane;
+    ID3D11Texture2D *                       m_pDepthStaging;
+    ID3D11Texture2D *                       m_pNormalStaging;
+    AOFX_CaptureStats                       m_Stats;
+
+    AOFX_CaptureStream() : m_pFile(NULL), m_pDepthStaging(NULL), m_pNormalStaging(NULL) {}
+};
+
+struct AOFX_ReplayStream
+{
+    FILE *                                  m_pFile;
+    std::mutex                              m_FileLock;         // batch workers read frames concurrently
+    std::vector<uint64>                     m_Index;
+    std::vector<float>                      m_Depth;            // frame returned by AOFX_ReplayReadFrame
+    std::vector<uint8>                      m_Normal;
+
+    AOFX_ReplayStream() : m_pFile(NULL) {}
+};
+
+//-------------------------------------------------------------------------------------------------
+// LSB first bit packing, values are appended 32 bits at a time
+//-------------------------------------------------------------------------------------------------
+class BitWriter
+{
+public:
+    BitWriter(std::vector<uint8> & output) : m_Output(output), m_Bits(0), m_Count(0) {}
+
+    void write(uint64 value, uint count)
+    {
+        m_Bits |= value << m_Count;
+        m_Count += count;
+        if (m_Count >= 32)
+        {
+            const uint8 bytes[4] = { (uint8)m_Bits, (uint8)(m_Bits >> 8), (uint8)(m_Bits >> 16), (uint8)(m_Bits >> 24) };
+            m_Output.insert(m_Output.end(), bytes, bytes + 4);
+            m_Bits >>= 32;
+            m_Count -= 32;
+        }
+    }
+
+    void flush()
+    {
+        for (; m_Count > 0; m_Count -= MIN(m_Count, (uint)8), m_Bits >>= 8)
+            m_Output.push_back((uint8)m_Bits);
+    }
+
+private:
+    std::vector<uint8> &                    m_Output;
+    uint64                                  m_Bits;
+    uint                                    m_Count;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Reads past the end of the data return zero bits, overrun() reports whether any were consumed
+//-------------------------------------------------------------------------------------------------
+class BitReader
+{
+public:
+    BitReader(const uint8 * pData, size_t size) : m_pData(pData), m_Size(size), m_Position(0), m_Bits(0), m_Count(0) {}
+
+    uint read(uint count)
+    {
+        if (m_Count < count)
+            refill();
+        uint value = (uint)(m_Bits & ((1ull << count) - 1));
+        m_Bits >>= count;
+        m_Count -= count;
+        return value;
+    }
+
+    // counts leading one bits up to limit, the terminating zero is consumed when the limit is not reached
+    uint readUnary(uint limit)
+    {
+        if (m_Count <= limit)
+            refill();
+        uint ones = 0;
+        while (ones < limit && (m_Bits & 1) != 0)
+        {
+            m_Bits >>= 1;
+            ones++;
+        }
+        uint consumed = ones < limit ? ones + 1 : ones;
+        m_Bits >>= consumed - ones;
+        m_Count -= consumed;
+        return ones;
+    }
+
+    bool overrun() const
+    {
+        return m_Position * 8 - m_Count > m_Size * 8;
+    }
+
+private:
+    void refill()
+    {
+        for (; m_Count <= 56; m_Count += 8, m_Position++)
+            m_Bits |= (uint64)(m_Position < m_Size ? m_pData[m_Position] : 0) << m_Count;
+    }
+
+    const uint8 *                           m_pData;
+    size_t                                  m_Size;
+    size_t                                  m_Position;
+    uint64                                  m_Bits;
+    uint                                    m_Count;
+};
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static inline uint bitLength(uint64 value)
+{
+    uint length = 0;
+    if (value >> 32) { value >>= 32; length += 32; }
+    if (value >> 16) { value >>= 16; length += 16; }
+    if (value >> 8)  { value >>= 8;  length += 8; }
+    if (value >> 4)  { value >>= 4;  length += 4; }
+    if (value >> 2)  { value >>= 2;  length += 2; }
+    if (value >> 1)  { value >>= 1;  length += 1; }
+    return length + (uint)value;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Median edge detector, a = left, b = up, c = up left
+//-------------------------------------------------------------------------------------------------
+template <typename T>
+static inline T predict(T a, T b, T c)
+{
+    T lo = MIN(a, b), hi = MAX(a, b);
+    if (c >= hi) return lo;
+    if (c <= lo) return hi;
+    return (T)(a + b - c);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Rice parameter of a context, the smallest k with count * 2^k >= sum
+//-------------------------------------------------------------------------------------------------
+static inline uint riceParameter(const RiceContext & context, uint bits)
+{
+    uint64 mean = (context.m_Sum + context.m_Count - 1) / context.m_Count;
+    return MIN(bitLength(mean - (mean != 0)), bits);
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static inline void updateContext(RiceContext & context, uint64 value)
+{
+    context.m_Sum += value;
+    if (++context.m_Count == s_RiceResetCount)
+    {
+        context.m_Sum >>= 1;
+        context.m_Count >>= 1;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static void resetContexts(RiceContext * pContexts)
+{
+    for (uint i = 0; i < s_RiceContextCount; i++)
+    {
+        pContexts[i].m_Sum = 4;
+        pContexts[i].m_Count = 1;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Codes 'lanes' interleaved planes of width x height texels, texel (x, y) of lane l is pData[(y * width + x) * lanes + l]
+//-------------------------------------------------------------------------------------------------
+template <typename T>
+static void encodePlanes(const T * pData, uint width, uint height, uint lanes, std::vector<uint8> & output)
+{
+    const uint   bits = sizeof(T) * 8;
+    const uint64 mask = (uint64)(T)~(T)0;
+    const size_t stride = (size_t)width * lanes;
+
+    BitWriter   writer(output);
+    RiceContext contexts[s_RiceContextCount];
+    std::vector<uint64> residuals(2 * (size_t)width);
+
+    for (uint lane = 0; lane < lanes; lane++)
+    {
+        resetContexts(contexts);
+
+        for (uint y = 0; y < height; y++)
+        {
+            const T * pRow = pData + y * stride + lane;
+            const T * pUp = pRow - stride;
+            uint64 * pResidual = &residuals[(y & 1) * width];
+            const uint64 * pUpResidual = &residuals[((y + 1) & 1) * width];
+
+            for (uint x = 0; x < width; x++)
+            {
+                T prediction;
+                uint64 neighbours;
+                if (y == 0)
+                {
+                    prediction = x > 0 ? pRow[(x - 1) * lanes] : 0;
+                    neighbours = x > 0 ? 2 * pResidual[x - 1] : 0;
+                }
+                else if (x == 0)
+                {
+                    prediction = pUp[0];
+                    neighbours = 2 * pUpResidual[0];
+                }
+                else
+                {
+                    prediction = predict(pRow[(x - 1) * lanes], pUp[x * lanes], pUp[(x - 1) * lanes]);
+                    neighbours = pResidual[x - 1] + pUpResidual[x];
+                }
+
+                T residual = (T)(pRow[x * lanes] - prediction);
+                uint64 value = (((uint64)residual << 1) & mask) ^ ((residual >> (bits - 1)) != 0 ? mask : 0);
+                pResidual[x] = value;
+
+                RiceContext & context = contexts[MIN(bitLength(neighbours), s_RiceContextCount - 1)];
+                uint k = riceParameter(context, bits);
+                uint64 quotient = value >> k;
+                if (quotient < s_RiceEscapeLength)
+                {
+                    writer.write((1ull << quotient) - 1, (uint)quotient + 1);
+                    writer.write(value & ((1ull << k) - 1), k);
+                }
+                else
+                {
+                    writer.write((1ull << s_RiceEscapeLength) - 1, s_RiceEscapeLength);
+                    writer.write(value, bits);
+                }
+                updateContext(context, value);
+            }
+        }
+    }
+
+    writer.flush();
+}
+
+//-------------------------------------------------------------------------------------------------
+// Inverse of encodePlanes, fails if the data ends early
+//-------------------------------------------------------------------------------------------------
+template <typename T>
+static bool decodePlanes(const uint8 * pPlane, size_t size, uint width, uint height, uint lanes, T * pData)
+{
+    const uint   bits = sizeof(T) * 8;
+    const size_t stride = (size_t)width * lanes;
+
+    BitReader   reader(pPlane, size);
+    RiceContext contexts[s_RiceContextCount];
+    std::vector<uint64> residuals(2 * (size_t)width);
+
+    for (uint lane = 0; lane < lanes; lane++)
+    {
+        resetContexts(contexts);
+
+        for (uint y = 0; y < height; y++)
+        {
+            T * pRow = pData + y * stride + lane;
+            const T * pUp = pRow - stride;
+            uint64 * pResidual = &residuals[(y & 1) * width];
+            const uint64 * pUpResidual = &residuals[((y + 1) & 1) * width];
+
+            for (uint x = 0; x < width; x++)
+            {
+                T prediction;
+                uint64 neighbours;
+                if (y == 0)
+                {
+                    prediction = x > 0 ? pRow[(x - 1) * lanes] : 0;
+                    neighbours = x > 0 ? 2 * pResidual[x - 1] : 0;
+                }
+                else if (x == 0)
+                {
+                    prediction = pUp[0];
+                    neighbours = 2 * pUpResidual[0];
+                }
+                else
+                {
+                    prediction = predict(pRow[(x - 1) * lanes], pUp[x * lanes], pUp[(x - 1) * lanes]);
+                    neighbours = pResidual[x - 1] + pUpResidual[x];
+                }
+
+                RiceContext & context = contexts[MIN(bitLength(neighbours), s_RiceContextCount - 1)];
+                uint k = riceParameter(context, bits);
+                uint64 quotient = reader.readUnary(s_RiceEscapeLength);
+                uint64 value = quotient < s_RiceEscapeLength ? (quotient << k) | reader.read(k) : reader.read(bits);
+                pResidual[x] = value;
+                updateContext(context, value);
+
+                T residual = (T)((value >> 1) ^ (0 - (value & 1)));
+                pRow[x * lanes] = (T)(prediction + residual);
+            }
+        }
+
+        if (reader.overrun())
+            return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// The plane codec for the word sizes a capture stores, declared in AMD_AOFX_CPU.h
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuEncodePlanes(const uint8 * pData, uint width, uint height, uint lanes, std::vector<uint8> & output)
+{
+    encodePlanes(pData, width, height, lanes, output);
+}
+
+void AOFX_CpuEncodePlanes(const uint16 * pData, uint width, uint height, uint lanes, std::vector<uint8> & output)
+{
+    encodePlanes(pData, width, height, lanes, output);
+}
+
+void AOFX_CpuEncodePlanes(const uint32 * pData, uint width, uint height, uint lanes, std::vector<uint8> & output)
+{
+    encodePlanes(pData, width, height, lanes, output);
+}
+
+bool AOFX_CpuDecodePlanes(const uint8 * pPlane, size_t size, uint width, uint height, uint lanes, uint8 * pData)
+{
+    return decodePlanes(pPlane, size, width, height, lanes, pData);
+}
+
+bool AOFX_CpuDecodePlanes(const uint8 * pPlane, size_t size, uint width, uint height, uint lanes, uint16 * pData)
+{
+    return decodePlanes(pPlane, size, width, height, lanes, pData);
+}
+
+bool AOFX_CpuDecodePlanes(const uint8 * pPlane, size_t size, uint width, uint height, uint lanes, uint32 * pData)
+{
+    return decodePlanes(pPlane, size, width, height, lanes, pData);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Size of a depth texel in the read back texture, 0 for unsupported view formats
+//-------------------------------------------------------------------------------------------------
+static uint depthTexelSize(uint format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_R32_FLOAT:
+    case DXGI_FORMAT_R24_UNORM_X8_TYPELESS:
+        return 4;
+    case DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+        return 8;
+    case DXGI_FORMAT_R16_UNORM:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Size of a normal texel, 0 for formats a capture does not store
+//-------------------------------------------------------------------------------------------------
+static uint normalTexelSize(uint format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_R8G8_UNORM:
+    case DXGI_FORMAT_R8G8_SNORM:
+    case DXGI_FORMAT_R16_FLOAT:
+        return 2;
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_SNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8X8_UNORM:
+    case DXGI_FORMAT_R10G10B10A2_UNORM:
+    case DXGI_FORMAT_R11G11B10_FLOAT:
+    case DXGI_FORMAT_R16G16_UNORM:
+    case DXGI_FORMAT_R16G16_SNORM:
+    case DXGI_FORMAT_R16G16_FLOAT:
+    case DXGI_FORMAT_R32_FLOAT:
+        return 4;
+    case DXGI_FORMAT_R16G16B16A16_UNORM:
+    case DXGI_FORMAT_R16G16B16A16_SNORM:
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT_R32G32_FLOAT:
+        return 8;
+    case DXGI_FORMAT_R32G32B32_FLOAT:
+        return 12;
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Depth formats with more than 16 bits are stored as 32 bit words
+//-------------------------------------------------------------------------------------------------
+static inline bool isWideDepth(uint format)
+{
+    return format != DXGI_FORMAT_R16_UNORM;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static void storeSettings(const AOFX_Desc & desc, CaptureSettings & settings)
+{
+    memset(&settings, 0, sizeof(settings));
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        settings.m_LayerProcess[i] = desc.m_LayerProcess[i];
+        settings.m_BilateralBlurRadius[i] = desc.m_BilateralBlurRadius[i];
+        settings.m_SampleCount[i] = desc.m_SampleCount[i];
+        settings.m_NormalOption[i] = desc.m_NormalOption[i];
+        settings.m_TapType[i] = desc.m_TapType[i];
+        settings.m_KernelType[i] = desc.m_KernelType[i];
+        settings.m_MultiResLayerScale[i] = desc.m_MultiResLayerScale[i];
+        settings.m_PowIntensity[i] = desc.m_PowIntensity[i];
+        settings.m_RejectRadius[i] = desc.m_RejectRadius[i];
+        settings.m_AcceptRadius[i] = desc.m_AcceptRadius[i];
+        settings.m_RecipFadeOutDist[i] = desc.m_RecipFadeOutDist[i];
+        settings.m_LinearIntensity[i] = desc.m_LinearIntensity[i];
+        settings.m_NormalScale[i] = desc.m_NormalScale[i];
+        settings.m_ViewDistanceDiscard[i] = desc.m_ViewDistanceDiscard[i];
+        settings.m_ViewDistanceFade[i] = desc.m_ViewDistanceFade[i];
+        settings.m_DepthUpsampleThreshold[i] = desc.m_DepthUpsampleThreshold[i];
+    }
+    settings.m_Implementation = desc.m_Implementation;
+    settings.m_OutputChannelsFlag = desc.m_OutputChannelsFlag;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static void applySettings(const CaptureSettings & settings, AOFX_Desc & desc)
+{
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        desc.m_LayerProcess[i] = (AOFX_LAYER_PROCESS)settings.m_LayerProcess[i];
+        desc.m_BilateralBlurRadius[i] = (AOFX_BILATERAL_BLUR_RADIUS)settings.m_BilateralBlurRadius[i];
+        desc.m_SampleCount[i] = (AOFX_SAMPLE_COUNT)settings.m_SampleCount[i];
+        desc.m_NormalOption[i] = (AOFX_NORMAL_OPTION)settings.m_NormalOption[i];
+        desc.m_TapType[i] = (AOFX_TAP_TYPE)settings.m_TapType[i];
+        desc.m_KernelType[i] = (AOFX_KERNEL_TYPE)settings.m_KernelType[i];
+        desc.m_MultiResLayerScale[i] = settings.m_MultiResLayerScale[i];
+        desc.m_PowIntensity[i] = settings.m_PowIntensity[i];
+        desc.m_RejectRadius[i] = settings.m_RejectRadius[i];
+        desc.m_AcceptRadius[i] = settings.m_AcceptRadius[i];
+        desc.m_RecipFadeOutDist[i] = settings.m_RecipFadeOutDist[i];
+        desc.m_LinearIntensity[i] = settings.m_LinearIntensity[i];
+        desc.m_NormalScale[i] = settings.m_NormalScale[i];
+        desc.m_ViewDistanceDiscard[i] = settings.m_ViewDistanceDiscard[i];
+        desc.m_ViewDistanceFade[i] = settings.m_ViewDistanceFade[i];
+        desc.m_DepthUpsampleThreshold[i] = settings.m_DepthUpsampleThreshold[i];
+    }
+    desc.m_Implementation = settings.m_Implementation;
+    desc.m_OutputChannelsFlag = settings.m_OutputChannelsFlag;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static inline void initializeHeader(CaptureFrameHeader & header, const AOFX_Desc & desc, const AOFX_Desc::Camera & camera, uint width, uint height)
+{
+    memset(&header, 0, sizeof(header));
+    header.m_Magic = s_FrameMagic;
+    header.m_Width = width;
+    header.m_Height = height;
+    header.m_DepthFormat = DXGI_FORMAT_R32_FLOAT;
+    header.m_NormalFormat = DXGI_FORMAT_UNKNOWN;
+    storeSettings(desc, header.m_Settings);
+    memcpy(&header.m_Camera, &camera, sizeof(header.m_Camera));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Reuses the staging copy of a texture while the texture keeps its size and format
+//-------------------------------------------------------------------------------------------------
+static AOFX_RETURN_CODE updateStaging(ID3D11Device * pDevice, ID3D11Texture2D * pTexture, ID3D11Texture2D ** ppStaging)
+{
+    D3D11_TEXTURE2D_DESC desc;
+    pTexture->GetDesc(&desc);
+    if (desc.SampleDesc.Count > 1)
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Usage = D3D11_USAGE_STAGING;
+    desc.BindFlags = 0;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    desc.MiscFlags = 0;
+
+    if (*ppStaging != NULL)
+    {
+        D3D11_TEXTURE2D_DESC stagingDesc;
+        (*ppStaging)->GetDesc(&stagingDesc);
+        if (memcmp(&desc, &stagingDesc, sizeof(desc)) == 0)
+            return AOFX_RETURN_CODE_SUCCESS;
+        AMD_SAFE_RELEASE(*ppStaging);
+    }
+
+    return pDevice->CreateTexture2D(&desc, NULL, ppStaging) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Copies the top left width x height texels of the first subresource behind a view,
+// depth-stencil resources can only be copied whole so the staging texture matches the resource
+//-------------------------------------------------------------------------------------------------
+static AOFX_RETURN_CODE readBack(const AOFX_Desc & desc, ID3D11ShaderResourceView * pSRV, ID3D11Texture2D ** ppStaging,
+                                 uint width, uint height, uint texelSize, uint8 * pOutput)
+{
+    ID3D11Resource * pResource = NULL;
+    ID3D11Texture2D * pTexture = NULL;
+    pSRV->GetResource(&pResource);
+    HRESULT hr = pResource->QueryInterface(__uuidof(ID3D11Texture2D), (void **)&pTexture);
+    AMD_SAFE_RELEASE(pResource);
+    if (hr != S_OK)
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+    D3D11_TEXTURE2D_DESC textureDesc;
+    pTexture->GetDesc(&textureDesc);
+
+    AOFX_RETURN_CODE result = textureDesc.Width >= width && textureDesc.Height >= height ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    if (result == AOFX_RETURN_CODE_SUCCESS)
+        result = updateStaging(desc.m_pDevice, pTexture, ppStaging);
+    if (result == AOFX_RETURN_CODE_SUCCESS)
+        desc.m_pDeviceContext->CopySubresourceRegion(*ppStaging, 0, 0, 0, 0, pTexture, 0, NULL);
+    AMD_SAFE_RELEASE(pTexture);
+    if (result != AOFX_RETURN_CODE_SUCCESS)
+        return result;
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (desc.m_pDeviceContext->Map(*ppStaging, 0, D3D11_MAP_READ, 0, &mapped) != S_OK)
+        return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+
+    for (uint y = 0; y < height; y++)
+        memcpy(pOutput + (size_t)y * width * texelSize, (const uint8 *)mapped.pData + (size_t)y * mapped.RowPitch, (size_t)width * texelSize);
+
+    desc.m_pDeviceContext->Unmap(*ppStaging, 0);
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Compresses the planes of the frame held by the stream and appends the frame
+//-------------------------------------------------------------------------------------------------
+static AOFX_RETURN_CODE writeFrame(AOFX_CaptureStream & stream, CaptureFrameHeader & header)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    const size_t texels = (size_t)header.m_Width * header.m_Height;
+
+    stream.m_DepthPlane.clear();
+    stream.m_NormalPlane.clear();
+    if (isWideDepth(header.m_DepthFormat))
+        encodePlanes(&stream.m_Depth32[0], header.m_Width, header.m_Height, 1, stream.m_DepthPlane);
+    else
+        encodePlanes(&stream.m_Depth16[0], header.m_Width, header.m_Height, 1, stream.m_DepthPlane);
+    if (header.m_NormalStride != 0)
+        encodePlanes(&stream.m_Normal[0], header.m_Width, header.m_Height, header.m_NormalStride, stream.m_NormalPlane);
+
+    header.m_FrameIndex = (uint)stream.m_Index.size();
+    header.m_DepthBytes = (uint)stream.m_DepthPlane.size();
+    header.m_NormalBytes = (uint)stream.m_NormalPlane.size();
+
+    uint64 offset = _ftelli64(stream.m_pFile);
+    bool written = fwrite(&header, sizeof(header), 1, stream.m_pFile) == 1;
+    written = written && fwrite(&stream.m_DepthPlane[0], 1, stream.m_DepthPlane.size(), stream.m_pFile) == stream.m_DepthPlane.size();
+    written = written && (stream.m_NormalPlane.empty() || fwrite(&stream.m_NormalPlane[0], 1, stream.m_NormalPlane.size(), stream.m_pFile) == stream.m_NormalPlane.size());
+    if (!written)
+    {
+        AMD_OUTPUT_DEBUG_STRING("AMD_AO Capture Error : Can't write frame\n");
+        return AOFX_RETURN_CODE_FAIL;
+    }
+
+    stream.m_Index.push_back(offset);
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    stream.m_Stats.m_FrameCount++;
+    stream.m_Stats.m_RawBytes += texels * ((isWideDepth(header.m_DepthFormat) ? sizeof(uint32) : sizeof(uint16)) + header.m_NormalStride);
+    stream.m_Stats.m_CompressedBytes += sizeof(header) + header.m_DepthBytes + header.m_NormalBytes;
+    stream.m_Stats.m_EncodeMilliseconds += elapsed.count();
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static bool validHeader(const CaptureFrameHeader & header)
+{
+    return header.m_Magic == s_FrameMagic &&
+           header.m_Width > 0 && header.m_Width <= s_MaxCaptureSize &&
+           header.m_Height > 0 && header.m_Height <= s_MaxCaptureSize &&
+           depthTexelSize(header.m_DepthFormat) != 0 &&
+           header.m_NormalStride <= s_MaxNormalStride &&
+           header.m_DepthBytes <= (uint64)header.m_Width * header.m_Height * 8 + 8 &&       // escaped 32 bit words take 7 bytes
+           header.m_NormalBytes <= (uint64)header.m_Width * header.m_Height * header.m_NormalStride * 4 + 8;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Reads the header and compressed planes of a frame, safe to call from several threads
+//-------------------------------------------------------------------------------------------------
+static bool readFrame(AOFX_ReplayStream & stream, uint frame, CaptureFrameHeader & header, std::vector<uint8> & planes)
+{
+    std::lock_guard<std::mutex> lock(stream.m_FileLock);
+
+    if (_fseeki64(stream.m_pFile, stream.m_Index[frame], SEEK_SET) != 0 ||
+        fread(&header, sizeof(header), 1, stream.m_pFile) != 1 ||
+        !validHeader(header))
+        return false;
+
+    planes.resize((size_t)header.m_DepthBytes + header.m_NormalBytes);
+    return planes.empty() || fread(&planes[0], 1, planes.size(), stream.m_pFile) == planes.size();
+}
+
+//-------------------------------------------------------------------------------------------------
+// Decodes depth to float and normals to raw texels
+//-------------------------------------------------------------------------------------------------
+static bool decodeFrame(const CaptureFrameHeader & header, const std::vector<uint8> & planes, float * pDepth, uint8 * pNormal)
+{
+    const uint   width = header.m_Width, height = header.m_Height;
+    const size_t texels = (size_t)width * height;
+    const uint8 * pPlanes = planes.empty() ? NULL : &planes[0];
+
+    if (isWideDepth(header.m_DepthFormat))
+    {
+        // 32 bit words are decoded in place of the float output
+        uint32 * pWords = (uint32 *)pDepth;
+        if (!decodePlanes(pPlanes, header.m_DepthBytes, width, height, 1, pWords))
+            return false;
+        if (header.m_DepthFormat == DXGI_FORMAT_R24_UNORM_X8_TYPELESS)
+        {
+            for (size_t i = 0; i < texels; i++)
+                pDepth[i] = (pWords[i] & 0xffffff) / 16777215.0f;
+        }
+    }
+    else
+    {
+        std::vector<uint16> words(texels);
+        if (!decodePlanes(pPlanes, header.m_DepthBytes, width, height, 1, &words[0]))
+            return false;
+        for (size_t i = 0; i < texels; i++)
+            pDepth[i] = words[i] / 65535.0f;
+    }
+
+    if (header.m_NormalStride != 0 && pNormal != NULL)
+        return decodePlanes(pPlanes + header.m_DepthBytes, header.m_NormalBytes, width, height, header.m_NormalStride, pNormal);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Rebuilds the index of a capture that was not closed, stops at the first incomplete frame
+//-------------------------------------------------------------------------------------------------
+static void scanFrames(AOFX_ReplayStream & stream, uint64 fileSize)
+{
+    uint64 offset = sizeof(CaptureFileHeader);
+    CaptureFrameHeader header;
+
+    stream.m_Index.clear();
+    while (offset + sizeof(header) <= fileSize &&
+           _fseeki64(stream.m_pFile, offset, SEEK_SET) == 0 &&
+           fread(&header, sizeof(header), 1, stream.m_pFile) == 1 &&
+           validHeader(header))
+    {
+        uint64 next = offset + sizeof(header) + header.m_DepthBytes + header.m_NormalBytes;
+        if (next > fileSize)
+            break;
+        stream.m_Index.push_back(offset);
+        offset = next;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static bool readIndex(AOFX_ReplayStream & stream)
+{
+    CaptureFileHeader fileHeader;
+    if (fread(&fileHeader, sizeof(fileHeader), 1, stream.m_pFile) != 1 ||
+        memcmp(fileHeader.m_Magic, s_CaptureMagic, sizeof(s_CaptureMagic)) != 0 ||
+        fileHeader.m_Version != s_CaptureVersion ||
+        fileHeader.m_FrameHeaderSize != sizeof(CaptureFrameHeader))
+        return false;
+
+    _fseeki64(stream.m_pFile, 0, SEEK_END);
+    uint64 fileSize = _ftelli64(stream.m_pFile);
+
+    CaptureFooter footer;
+    bool indexed = fileSize >= sizeof(fileHeader) + sizeof(footer) &&
+                   _fseeki64(stream.m_pFile, fileSize - sizeof(footer), SEEK_SET) == 0 &&
+                   fread(&footer, sizeof(footer), 1, stream.m_pFile) == 1 &&
+                   footer.m_Magic == s_IndexMagic &&
+                   footer.m_IndexOffset >= sizeof(fileHeader) &&
+                   footer.m_IndexOffset + (uint64)footer.m_FrameCount * sizeof(uint64) + sizeof(footer) == fileSize;
+    if (indexed)
+    {
+        stream.m_Index.resize(footer.m_FrameCount);
+        indexed = footer.m_FrameCount == 0 ||
+                  (_fseeki64(stream.m_pFile, footer.m_IndexOffset, SEEK_SET) == 0 &&
+                   fread(&stream.m_Index[0], sizeof(uint64), footer.m_FrameCount, stream.m_pFile) == footer.m_FrameCount);
+        for (uint i = 0; indexed && i < footer.m_FrameCount; i++)
+            indexed = stream.m_Index[i] >= sizeof(fileHeader) && stream.m_Index[i] + sizeof(CaptureFrameHeader) <= footer.m_IndexOffset;
+    }
+    if (!indexed)
+    {
+        AMD_OUTPUT_DEBUG_STRING("AMD_AO Replay : Capture has no index, scanning frames\n");
+        scanFrames(stream, fileSize);
+    }
+
+    return true;
+}
+
+// Batch callbacks of AOFX_ReplayRender
+struct ReplayBatch
+{
+    AOFX_ReplayStream *                     m_pStream;
+    uint                                    m_FirstFrame;
+    AOFX_BATCH_STORE_CALLBACK               m_pStore;
+    void *                                  m_pUserData;
+    std::vector< std::vector<float> >       m_Depth;            // decoded between load and store of an image
+};
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static bool replayLoad(AOFX_BatchImage & image, uint index, void * pUserData)
+{
+    ReplayBatch & batch = *(ReplayBatch *)pUserData;
+
+    CaptureFrameHeader header;
+    std::vector<uint8> planes;
+    if (!readFrame(*batch.m_pStream, batch.m_FirstFrame + index, header, planes))
+        return false;
+
+    // normals are not used by the CPU path
+    std::vector<float> & depth = batch.m_Depth[index];
+    depth.resize((size_t)header.m_Width * header.m_Height);
+    if (!decodeFrame(header, planes, &depth[0], NULL))
+        return false;
+
+    image.m_pDepth = &depth[0];
+    image.m_Size.x = header.m_Width;
+    image.m_Size.y = header.m_Height;
+    memcpy(&image.m_Camera, &header.m_Camera, sizeof(image.m_Camera));
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+static bool replayStore(const AOFX_BatchImage & image, uint index, AOFX_RETURN_CODE result, void * pUserData)
+{
+    ReplayBatch & batch = *(ReplayBatch *)pUserData;
+
+    bool stored = true;
+    if (batch.m_pStore != NULL)
+        stored = batch.m_pStore(image, batch.m_FirstFrame + index, result, batch.m_pUserData);
+
+    std::vector<float>().swap(batch.m_Depth[index]);
+
+    return stored;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_CaptureOpen(const char * fileName, AOFX_CaptureStream ** ppStream)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (fileName == NULL || ppStream == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    *ppStream = NULL;
+
+    FILE * file = fopen(fileName, "wb");
+    if (file == NULL)
+    {
+        AMD_OUTPUT_DEBUG_STRING("AMD_AO Capture Error : Can't create capture file\n");
+        return AOFX_RETURN_CODE_FAIL;
+    }
+
+    CaptureFileHeader fileHeader;
+    memcpy(fileHeader.m_Magic, s_CaptureMagic, sizeof(s_CaptureMagic));
+    fileHeader.m_Version = s_CaptureVersion;
+    fileHeader.m_FrameHeaderSize = sizeof(CaptureFrameHeader);
+    if (fwrite(&fileHeader, sizeof(fileHeader), 1, file) != 1)
+    {
+        fclose(file);
+        return AOFX_RETURN_CODE_FAIL;
+    }
+
+    AOFX_CaptureStream * pStream = new AOFX_CaptureStream();
+    pStream->m_pFile = file;
+    pStream->m_Stats.m_CompressedBytes = sizeof(fileHeader);
+    *ppStream = pStream;
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_CaptureAppend(AOFX_CaptureStream * pStream, const AOFX_Desc & desc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStream == NULL || desc.m_pDepthSRV == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (desc.m_pDevice == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_DEVICE;
+    }
+    if (desc.m_pDeviceContext == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT;
+    }
+    if (desc.m_InputSize.x == 0 || desc.m_InputSize.y == 0 ||
+        desc.m_InputSize.x > s_MaxCaptureSize || desc.m_InputSize.y > s_MaxCaptureSize)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    const uint   width = desc.m_InputSize.x, height = desc.m_InputSize.y;
+    const size_t texels = (size_t)width * height;
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC depthDesc, normalDesc;
+    desc.m_pDepthSRV->GetDesc(&depthDesc);
+    uint depthSize = depthTexelSize(depthDesc.Format);
+    uint normalSize = 0;
+    if (desc.m_pNormalSRV != NULL)
+    {
+        desc.m_pNormalSRV->GetDesc(&normalDesc);
+        normalSize = normalTexelSize(normalDesc.Format);
+        if (normalSize == 0 || normalDesc.ViewDimension != D3D11_SRV_DIMENSION_TEXTURE2D)
+            return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+    if (depthSize == 0 || depthDesc.ViewDimension != D3D11_SRV_DIMENSION_TEXTURE2D)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    CaptureFrameHeader header;
+    initializeHeader(header, desc, desc.m_Camera, width, height);
+    header.m_DepthFormat = depthDesc.Format;
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    // depth is read back at its texel size and reduced to the stored word size
+    std::vector<uint8> & depth = pStream->m_Readback;
+    depth.resize(texels * depthSize);
+    AOFX_RETURN_CODE result = readBack(desc, desc.m_pDepthSRV, &pStream->m_pDepthStaging, width, height, depthSize, &depth[0]);
+    if (result == AOFX_RETURN_CODE_SUCCESS && normalSize != 0)
+    {
+        header.m_NormalFormat = normalDesc.Format;
+        header.m_NormalStride = normalSize;
+        pStream->m_Normal.resize(texels * normalSize);
+        result = readBack(desc, desc.m_pNormalSRV, &pStream->m_pNormalStaging, width, height, normalSize, &pStream->m_Normal[0]);
+    }
+    if (result != AOFX_RETURN_CODE_SUCCESS)
+    {
+        return result;
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    pStream->m_Stats.m_ReadbackMilliseconds += elapsed.count();
+
+    if (isWideDepth(header.m_DepthFormat))
+    {
+        const uint mask = header.m_DepthFormat == DXGI_FORMAT_R24_UNORM_X8_TYPELESS ? 0xffffff : 0xffffffff;
+        pStream->m_Depth32.resize(texels);
+        for (size_t i = 0; i < texels; i++)
+            pStream->m_Depth32[i] = *(const uint32 *)&depth[i * depthSize] & mask;
+    }
+    else
+    {
+        pStream->m_Depth16.resize(texels);
+        memcpy(&pStream->m_Depth16[0], &depth[0], texels * sizeof(uint16));
+    }
+
+    return writeFrame(*pStream, header);
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_CaptureAppendImage(AOFX_CaptureStream * pStream, const AOFX_Desc & desc, const AOFX_BatchImage & image)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStream == NULL || image.m_pDepth == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (image.m_Size.x == 0 || image.m_Size.y == 0 ||
+        image.m_Size.x > s_MaxCaptureSize || image.m_Size.y > s_MaxCaptureSize)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    CaptureFrameHeader header;
+    initializeHeader(header, desc, image.m_Camera, image.m_Size.x, image.m_Size.y);
+
+    pStream->m_Depth32.resize((size_t)image.m_Size.x * image.m_Size.y);
+    memcpy(&pStream->m_Depth32[0], image.m_pDepth, pStream->m_Depth32.size() * sizeof(float));
+
+    return writeFrame(*pStream, header);
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_CaptureClose(AOFX_CaptureStream * pStream, AOFX_CaptureStats * pStats)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStream == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    CaptureFooter footer;
+    footer.m_IndexOffset = _ftelli64(pStream->m_pFile);
+    footer.m_FrameCount = (uint)pStream->m_Index.size();
+    footer.m_Magic = s_IndexMagic;
+
+    bool written = pStream->m_Index.empty() || fwrite(&pStream->m_Index[0], sizeof(uint64), pStream->m_Index.size(), pStream->m_pFile) == pStream->m_Index.size();
+    written = written && fwrite(&footer, sizeof(footer), 1, pStream->m_pFile) == 1;
+    written = fclose(pStream->m_pFile) == 0 && written;
+
+    pStream->m_Stats.m_CompressedBytes += pStream->m_Index.size() * sizeof(uint64) + sizeof(footer);
+    if (pStats != NULL)
+        *pStats = pStream->m_Stats;
+
+    AMD_SAFE_RELEASE(pStream->m_pDepthStaging);
+    AMD_SAFE_RELEASE(pStream->m_pNormalStaging);
+    delete pStream;
+
+    if (!written)
+    {
+        AMD_OUTPUT_DEBUG_STRING("AMD_AO Capture Error : Can't write frame index\n");
+        return AOFX_RETURN_CODE_FAIL;
+    }
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_ReplayOpen(const char * fileName, AOFX_ReplayStream ** ppStream)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (fileName == NULL || ppStream == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    *ppStream = NULL;
+
+    FILE * file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        AMD_OUTPUT_DEBUG_STRING("AMD_AO Replay Error : Can't open capture file\n");
+        return AOFX_RETURN_CODE_FAIL;
+    }
+
+    AOFX_ReplayStream * pStream = new AOFX_ReplayStream();
+    pStream->m_pFile = file;
+    if (!readIndex(*pStream))
+    {
+        AMD_OUTPUT_DEBUG_STRING("AMD_AO Replay Error : Not a capture file\n");
+        fclose(file);
+        delete pStream;
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    *ppStream = pStream;
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_ReplayGetFrameCount(AOFX_ReplayStream * pStream, uint * pFrameCount)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStream == NULL || pFrameCount == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    *pFrameCount = (uint)pStream->m_Index.size();
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_ReplayReadFrame(AOFX_ReplayStream * pStream, uint frame, AOFX_ReplayFrame * pFrame, AOFX_Desc * pDesc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStream == NULL || pFrame == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (frame >= pStream->m_Index.size())
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    CaptureFrameHeader header;
+    std::vector<uint8> planes;
+    if (!readFrame(*pStream, frame, header, planes))
+    {
+        return AOFX_RETURN_CODE_FAIL;
+    }
+
+    const size_t texels = (size_t)header.m_Width * header.m_Height;
+    pStream->m_Depth.resize(texels);
+    pStream->m_Normal.resize(texels * header.m_NormalStride);
+    if (!decodeFrame(header, planes, &pStream->m_Depth[0], pStream->m_Normal.empty() ? NULL : &pStream->m_Normal[0]))
+    {
+        AMD_OUTPUT_DEBUG_STRING("AMD_AO Replay Error : Corrupt frame\n");
+        return AOFX_RETURN_CODE_FAIL;
+    }
+
+    pFrame->m_FrameIndex = header.m_FrameIndex;
+    pFrame->m_Size.x = header.m_Width;
+    pFrame->m_Size.y = header.m_Height;
+    pFrame->m_DepthFormat = header.m_DepthFormat;
+    pFrame->m_NormalFormat = header.m_NormalFormat;
+    pFrame->m_NormalStride = header.m_NormalStride;
+    pFrame->m_pDepth = &pStream->m_Depth[0];
+    pFrame->m_pNormal = pStream->m_Normal.empty() ? NULL : &pStream->m_Normal[0];
+    memcpy(&pFrame->m_Camera, &header.m_Camera, sizeof(pFrame->m_Camera));
+
+    if (pDesc != NULL)
+    {
+        applySettings(header.m_Settings, *pDesc);
+        memcpy(&pDesc->m_Camera, &header.m_Camera, sizeof(pDesc->m_Camera));
+        pDesc->m_InputSize.x = header.m_Width;
+        pDesc->m_InputSize.y = header.m_Height;
+    }
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Consecutive frames captured with the same settings are rendered as one batch
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_ReplayRender(AOFX_ReplayStream * pStream, AOFX_Desc & desc, uint firstFrame, uint frameCount, const AOFX_BatchDesc & batch, AOFX_BatchStats * pStats)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStream == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (frameCount == 0 || firstFrame >= pStream->m_Index.size() || frameCount > pStream->m_Index.size() - firstFrame)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    std::vector<CaptureSettings> settings(frameCount);
+    for (uint i = 0; i < frameCount; i++)
+    {
+        CaptureFrameHeader header;
+        std::lock_guard<std::mutex> lock(pStream->m_FileLock);
+        if (_fseeki64(pStream->m_pFile, pStream->m_Index[firstFrame + i], SEEK_SET) != 0 ||
+            fread(&header, sizeof(header), 1, pStream->m_pFile) != 1 ||
+            !validHeader(header))
+            return AOFX_RETURN_CODE_FAIL;
+        settings[i] = header.m_Settings;
+    }
+
+    CaptureSettings original;
+    storeSettings(desc, original);
+
+    AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
+    AOFX_BatchStats  total;
+    double           megaTexels = 0.0;
+
+    for (uint first = 0, last = 0; first < frameCount; first = last)
+    {
+        for (last = first + 1; last < frameCount && memcmp(&settings[last], &settings[first], sizeof(CaptureSettings)) == 0; last++);
+
+        ReplayBatch replay;
+        replay.m_pStream = pStream;
+        replay.m_FirstFrame = firstFrame + first;
+        replay.m_pStore = batch.m_pStore;
+        replay.m_pUserData = batch.m_pUserData;
+        replay.m_Depth.resize(last - first);
+
+        AOFX_BatchDesc runBatch;
+        runBatch.m_ImageCount = last - first;
+        runBatch.m_ThreadCount = batch.m_ThreadCount;
+        runBatch.m_pLoad = replayLoad;
+        runBatch.m_pStore = replayStore;
+        runBatch.m_pUserData = &replay;
+
+        applySettings(settings[first], desc);
+
+        AOFX_BatchStats stats;
+        if (AOFX_CpuRenderBatch(desc, runBatch, &stats) != AOFX_RETURN_CODE_SUCCESS)
+            result = AOFX_RETURN_CODE_FAIL;
+
+        total.m_ImagesProcessed += stats.m_ImagesProcessed;
+        total.m_ImagesFailed += stats.m_ImagesFailed;
+        total.m_ThreadCount = MAX(total.m_ThreadCount, stats.m_ThreadCount);
+        total.m_ScratchAllocations += stats.m_ScratchAllocations;
+        total.m_Seconds += stats.m_Seconds;
+        megaTexels += stats.m_MegaTexelsPerSecond * stats.m_Seconds;
+    }
+
+    applySettings(original, desc);
+
+    if (pStats != NULL)
+    {
+        total.m_ImagesPerSecond = total.m_Seconds > 0.0 ? total.m_ImagesProcessed / total.m_Seconds : 0.0;
+        total.m_MegaTexelsPerSecond = total.m_Seconds > 0.0 ? megaTexels / total.m_Seconds : 0.0;
+        *pStats = total;
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_ReplayClose(AOFX_ReplayStream * pStream)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pStream == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    fclose(pStream->m_pFile);
+    delete pStream;
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+}
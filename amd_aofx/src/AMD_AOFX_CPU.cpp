@@ -0,0 +1,894 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <d3d11.h>
+#include <assert.h>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#if AMD_AOFX_COMPILE_DYNAMIC_LIB
+# define AMD_DLL_EXPORTS
+#endif
+
+#include "AMD_AOFX_CPU.h"
+
+#pragma warning( disable : 4100 ) // disable unreference formal parameter warnings for /W4 builds
+
+namespace AMD
+{
+// Fixed sample patterns, these have to match g_SamplePattern in AMD_AOFX_Common.hlsl
+// MEDIUM, HIGH and ULTRA patterns are prefixes of the same table
+static const int s_SamplePatternLow[8][2] =
+{
+    {0, -9}, {2, -6}, {0, -3}, {8, -3},
+    {6, 0}, {4, 3}, {2, 6}, {9, 6},
+};
+
+static const int s_SamplePattern[32][2] =
+{
+    {0, -9}, {4, -9}, {2, -6}, {6, -6},
+    {0, -3}, {4, -3}, {8, -3}, {2, 0},
+    {6, 0}, {9, 0}, {4, 3}, {8, 3},
+    {2, 6}, {6, 6}, {9, 6}, {4, 9},
+    {10, 0}, {-12, 12}, {9, -14}, {-8, -6},
+    {11, -7}, {-9, 1}, {-2, -13}, {-7, -3},
+    {4, 7}, {3, -13}, {12, 3}, {-12, 8},
+    {-10, 13}, {12, 1}, {9, 13}, {0, -5},
+};
+
+static const uint s_SampleCount[AOFX_SAMPLE_COUNT_COUNT] = { 8, 16, 24, 32 };
+static const sint s_BlurRadius[AOFX_BILATERAL_BLUR_RADIUS_COUNT] = { 2, 4, 8, 16 };
+
+static const uint s_RandomTapsCount = 64; // AO_RANDOM_TAPS_COUNT
+
+// GTAO parameters, these have to match GTAO_STEP_COUNT and GTAO_RADIUS_TEXELS in AMD_AOFX_Common.hlsl
+static const uint  s_GTAOStepCount = 4;
+static const float s_GTAORadius = 12.0f;
+
+// AOFX_CompareKernels reference, both kernels are scored against fixed tap GTAO at this slice and step count
+static const uint  s_ReferenceSliceCount = 16;
+static const uint  s_ReferenceStepCount = 16;
+
+static inline float saturate(float value)
+{
+    return MIN(MAX(value, 0.0f), 1.0f);
+}
+
+static inline uint clampCoord(sint coord, uint size)
+{
+    return (uint)MIN(MAX(coord, 0), (sint)size - 1);
+}
+
+// texel of a 'toSize' surface that a point sampler returns at the center of texel 'coord' of a 'fromSize' surface
+static inline uint scaleCoord(uint coord, uint fromSize, uint toSize)
+{
+    return MIN((uint)((coord + 0.5f) * toSize / fromSize), toSize - 1);
+}
+
+static inline float frac(float value)
+{
+    return value - floorf(value);
+}
+
+static inline AOFX_CpuDesc::float3 make3(float x, float y, float z)
+{
+    AOFX_CpuDesc::float3 result = { { { x, y, z } } };
+    return result;
+}
+
+static inline AOFX_CpuDesc::float3 sub3(const AOFX_CpuDesc::float3 & a, const AOFX_CpuDesc::float3 & b)
+{
+    return make3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static inline float dot3(const AOFX_CpuDesc::float3 & a, const AOFX_CpuDesc::float3 & b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static inline AOFX_CpuDesc::float3 cross3(const AOFX_CpuDesc::float3 & a, const AOFX_CpuDesc::float3 & b)
+{
+    return make3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+static inline AOFX_CpuDesc::float3 normalize3(const AOFX_CpuDesc::float3 & a)
+{
+    float length = sqrtf(dot3(a, a));
+    return length > 0.0f ? make3(a.x / length, a.y / length, a.z / length) : a;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_CpuDesc::AO_KernelData::AO_KernelData(const AOFX_Desc & desc, uint target, AOFX_KERNEL_TYPE kernelType, AOFX_SAMPLE_COUNT sampleCount)
+    : m_KernelType(kernelType)
+    , m_TapType(desc.m_TapType[target])
+    , m_SampleCount(s_SampleCount[sampleCount])
+    , m_SliceCount(s_SampleCount[sampleCount] / s_GTAOStepCount)
+    , m_StepCount(s_GTAOStepCount)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_CpuDesc::AOFX_CpuDesc(const AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4 * pSamplePatterns)
+    : m_Allocations(0)
+    , m_KernelSeconds(0.0)
+    , m_pSamplePatterns(pSamplePatterns)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    m_Resolution.x = m_Resolution.y = 0;
+    for (int i = 0; i < m_MultiResLayerCount; i++)
+    {
+        m_ScaledResolution[i].x = 0;
+        m_ScaledResolution[i].y = 0;
+    }
+
+    memset(&m_StageCounters, 0, sizeof(m_StageCounters));
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_CpuDesc::resize(const AOFX_Desc & desc, uint width, uint height)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (width == 0 || height == 0)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    bool resolutionChanged = (m_Resolution.x != width || m_Resolution.y != height);
+
+    if (resolutionChanged)
+    {
+        size_t size = (size_t)width * height;
+
+        m_LinearDepth.resize(size);
+        m_DilateAO.resize(size);
+        m_BlurAO.resize(size);
+
+        m_Resolution.x = width;
+        m_Resolution.y = height;
+        m_Allocations++;
+    }
+
+    for (int i = 0; i < m_MultiResLayerCount; ++i)
+    {
+        if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+
+        uint scaledWidth = MAX((uint)(width * desc.m_MultiResLayerScale[i]), (uint)1);
+        uint scaledHeight = MAX((uint)(height * desc.m_MultiResLayerScale[i]), (uint)1);
+
+        if (m_ScaledResolution[i].x != scaledWidth || m_ScaledResolution[i].y != scaledHeight)
+        {
+            size_t scaledSize = (size_t)scaledWidth * scaledHeight;
+
+            m_InputAO[i].resize(scaledSize);
+            m_InputDistance[i].resize(scaledSize);
+            m_ResultAO[i].resize(scaledSize);
+
+            m_ScaledResolution[i].x = scaledWidth;
+            m_ScaledResolution[i].y = scaledHeight;
+            m_Allocations++;
+        }
+    }
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Scales camera space depth of layer 'target' and reconstructs camera space XYZ,
+// same as csProcessInput followed by loadCameraSpacePositionT2D
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::processInput(uint target, const AOFX_Desc & desc, const AO_CameraData & camera)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    uint width = m_Resolution.x, height = m_Resolution.y;
+    uint scaledWidth = m_ScaledResolution[target].x, scaledHeight = m_ScaledResolution[target].y;
+
+    float3 * pPosition = &m_InputAO[target][0];
+    float * pDistance = &m_InputDistance[target][0];
+
+    for (uint y = 0; y < scaledHeight; y++)
+    {
+        uint  srcY = scaleCoord(y, scaledHeight, height);
+        float cameraY = -((y + 0.5f) * 2.0f / scaledHeight - 1.0f) * camera.m_CameraTanHalfFovVertical;
+
+        for (uint x = 0; x < scaledWidth; x++)
+        {
+            uint  srcX = scaleCoord(x, scaledWidth, width);
+            float cameraX = ((x + 0.5f) * 2.0f / scaledWidth - 1.0f) * camera.m_CameraTanHalfFovHorizontal;
+            float cameraZ = m_LinearDepth[srcY * width + srcX];
+
+            float3 & position = pPosition[y * scaledWidth + x];
+            position.x = cameraX * cameraZ;
+            position.y = cameraY * cameraZ;
+            position.z = cameraZ;
+
+            pDistance[y * scaledWidth + x] = sqrtf(position.x * position.x + position.y * position.y + position.z * position.z);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// HDAO valley detection, see kernelHDAO in AMD_AOFX_Kernel.hlsl
+// A deinterleaved layer samples its own sub-lattice, so taps are spread by the deinterleave factor
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::ambientOcclusionHDAO(uint target, const AOFX_Desc & desc, const AO_KernelData & kernel)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    uint width = m_ScaledResolution[target].x, height = m_ScaledResolution[target].y;
+    sint deinterleaveSize = AOFX_OpaqueDesc::m_DeinterleaveSize[desc.m_LayerProcess[target]];
+    uint sampleCount = kernel.m_SampleCount;
+    bool fixedTaps = kernel.m_TapType == AOFX_TAP_TYPE_FIXED;
+    const int (*fixedPattern)[2] = sampleCount == s_SampleCount[AOFX_SAMPLE_COUNT_LOW] ? s_SamplePatternLow : s_SamplePattern;
+
+    float rejectRadius = desc.m_RejectRadius[target];
+    float acceptRadius = desc.m_AcceptRadius[target];
+    float recipFadeOutDist = desc.m_RecipFadeOutDist[target];
+    float linearIntensity = desc.m_LinearIntensity[target];
+    float viewDistanceDiscard = desc.m_ViewDistanceDiscard[target];
+    float viewDistanceFade = desc.m_ViewDistanceFade[target];
+    float fadeIntervalLength = viewDistanceDiscard - viewDistanceFade;
+
+    const float3 * pPosition = &m_InputAO[target][0];
+    const float * pDistance = &m_InputDistance[target][0];
+    float * pOutput = &m_ResultAO[target][0];
+
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            const float3 & center = pPosition[y * width + x];
+            float centerDistance = pDistance[y * width + x];
+
+            if (center.z > viewDistanceDiscard)
+            {
+                pOutput[y * width + x] = 1.0f;
+                continue;
+            }
+
+            uint randomIndex = deinterleaveSize > 1 ?
+                (x % deinterleaveSize) + (y % deinterleaveSize) * deinterleaveSize :
+                (x * y) % s_RandomTapsCount;
+
+            float occlusion = 0.0f;
+
+            for (uint valley = 0; valley < sampleCount; valley++)
+            {
+                sint patternX, patternY;
+                if (fixedTaps)
+                {
+                    patternX = fixedPattern[valley][0];
+                    patternY = fixedPattern[valley][1];
+                }
+                else
+                {
+                    patternX = m_pSamplePatterns->SP[randomIndex][valley].x;
+                    patternY = m_pSamplePatterns->SP[randomIndex][valley].y;
+                }
+                patternX *= deinterleaveSize;
+                patternY *= deinterleaveSize;
+
+                uint index0 = clampCoord(y + patternY, height) * width + clampCoord(x + patternX, width);
+                uint index1 = clampCoord(y - patternY, height) * width + clampCoord(x - patternX, width);
+
+                // Detect valleys
+                float distanceDelta0 = centerDistance - pDistance[index0];
+                float distanceDelta1 = centerDistance - pDistance[index1];
+                float compare0 = distanceDelta0 > acceptRadius ? saturate((rejectRadius - distanceDelta0) * recipFadeOutDist) : 0.0f;
+                float compare1 = distanceDelta1 > acceptRadius ? saturate((rejectRadius - distanceDelta1) * recipFadeOutDist) : 0.0f;
+
+                if (compare0 * compare1 == 0.0f) continue;
+
+                // Compute dot product, to scale occlusion
+                const float3 & position0 = pPosition[index0];
+                const float3 & position1 = pPosition[index1];
+                float3 direction0 = { { { center.x - position0.x, center.y - position0.y, center.z - position0.z } } };
+                float3 direction1 = { { { center.x - position1.x, center.y - position1.y, center.z - position1.z } } };
+                float length0 = sqrtf(direction0.x * direction0.x + direction0.y * direction0.y + direction0.z * direction0.z);
+                float length1 = sqrtf(direction1.x * direction1.x + direction1.y * direction1.y + direction1.z * direction1.z);
+                float directionDot = (direction0.x * direction1.x + direction0.y * direction1.y + direction0.z * direction1.z) / (length0 * length1);
+                directionDot = saturate(directionDot + 0.9f) * 1.2f;
+
+                // Accumulate weighted occlusion
+                occlusion += compare0 * compare1 * directionDot * directionDot * directionDot;
+            }
+
+            // Finally calculate the AO occlusion value
+            occlusion /= sampleCount;
+            occlusion *= linearIntensity;
+            occlusion = 1.0f - saturate(occlusion);
+
+            float weight = saturate((center.z - viewDistanceFade) / fadeIntervalLength);
+            pOutput[y * width + x] = occlusion + (1.0f - occlusion) * weight;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Horizon based slice marching, see kernelGTAO in AMD_AOFX_Kernel.hlsl
+// A deinterleaved layer samples its own sub-lattice, so taps are spread by the deinterleave factor
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::ambientOcclusionGTAO(uint target, const AOFX_Desc & desc, const AO_KernelData & kernel)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    uint width = m_ScaledResolution[target].x, height = m_ScaledResolution[target].y;
+    sint deinterleaveSize = AOFX_OpaqueDesc::m_DeinterleaveSize[desc.m_LayerProcess[target]];
+    bool fixedTaps = kernel.m_TapType == AOFX_TAP_TYPE_FIXED;
+
+    float rejectRadius = desc.m_RejectRadius[target];
+    float acceptRadius = desc.m_AcceptRadius[target];
+    float recipFadeOutDist = desc.m_RecipFadeOutDist[target];
+    float linearIntensity = desc.m_LinearIntensity[target];
+    float viewDistanceDiscard = desc.m_ViewDistanceDiscard[target];
+    float viewDistanceFade = desc.m_ViewDistanceFade[target];
+    float fadeIntervalLength = viewDistanceDiscard - viewDistanceFade;
+
+    const float3 * pPosition = &m_InputAO[target][0];
+    float * pOutput = &m_ResultAO[target][0];
+
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            const float3 & center = pPosition[y * width + x];
+
+            if (center.z > viewDistanceDiscard)
+            {
+                pOutput[y * width + x] = 1.0f;
+                continue;
+            }
+
+            uint randomIndex = deinterleaveSize > 1 ?
+                (x % deinterleaveSize) + (y % deinterleaveSize) * deinterleaveSize :
+                (x * y) % s_RandomTapsCount;
+
+            float sliceJitter = fixedTaps ? 0.5f : frac(randomIndex * 0.618034f);
+            float stepJitter = fixedTaps ? 0.5f : frac(randomIndex * 0.754878f + 0.5f);
+
+            float3 viewDir = normalize3(make3(-center.x, -center.y, -center.z));
+
+            // Reconstruct the normal from the neighbours with the smaller depth discontinuity
+            const float3 & right = pPosition[y * width + clampCoord(x + deinterleaveSize, width)];
+            const float3 & left = pPosition[y * width + clampCoord(x - deinterleaveSize, width)];
+            const float3 & down = pPosition[clampCoord(y + deinterleaveSize, height) * width + x];
+            const float3 & up = pPosition[clampCoord(y - deinterleaveSize, height) * width + x];
+
+            // A clamped neighbour at the image border is the center itself and can't be used
+            float3 dxRight = sub3(right, center), dxLeft = sub3(center, left);
+            float3 dyDown = sub3(down, center), dyUp = sub3(center, up);
+            float3 dx = (dot3(dxLeft, dxLeft) == 0.0f || (fabsf(dxRight.z) < fabsf(dxLeft.z) && dot3(dxRight, dxRight) > 0.0f)) ? dxRight : dxLeft;
+            float3 dy = (dot3(dyUp, dyUp) == 0.0f || (fabsf(dyDown.z) < fabsf(dyUp.z) && dot3(dyDown, dyDown) > 0.0f)) ? dyDown : dyUp;
+            float3 normal = normalize3(cross3(dy, dx));
+            if (dot3(normal, viewDir) < 0.0f)
+                normal = make3(-normal.x, -normal.y, -normal.z);
+
+            float visibility = 0.0f;
+
+            for (uint slice = 0; slice < kernel.m_SliceCount; slice++)
+            {
+                float phi = (slice + sliceJitter) * ((float)M_PI / kernel.m_SliceCount);
+                float directionX = cosf(phi);
+                float directionY = sinf(phi);
+
+                // [0]: horizon cosine along +direction, [1]: along -direction
+                float horizonCos[2] = { -1.0f, -1.0f };
+
+                for (uint step = 0; step < kernel.m_StepCount; step++)
+                {
+                    float stepDistance = s_GTAORadius * (step + 0.5f + stepJitter * 0.5f) / kernel.m_StepCount;
+                    sint  offsetX = (sint)floorf(directionX * stepDistance + 0.5f) * deinterleaveSize;
+                    sint  offsetY = (sint)floorf(directionY * stepDistance + 0.5f) * deinterleaveSize;
+
+                    for (int side = 0; side < 2; side++)
+                    {
+                        sint sign = side == 0 ? 1 : -1;
+                        const float3 & position = pPosition[clampCoord(y + sign * offsetY, height) * width + clampCoord(x + sign * offsetX, width)];
+
+                        float3 delta = sub3(position, center);
+                        float  deltaLength = sqrtf(dot3(delta, delta));
+                        float  falloff = deltaLength > acceptRadius ? saturate((rejectRadius - deltaLength) * recipFadeOutDist) : 0.0f;
+                        float  sampleCos = -1.0f + (dot3(delta, viewDir) / MAX(deltaLength, 1e-6f) + 1.0f) * falloff;
+
+                        horizonCos[side] = MAX(horizonCos[side], sampleCos);
+                    }
+                }
+
+                // Project the normal onto the slice plane
+                float3 sliceDir = make3(directionX, -directionY, 0.0f);
+                float  sliceDot = dot3(sliceDir, viewDir);
+                float3 orthoDir = make3(sliceDir.x - sliceDot * viewDir.x, sliceDir.y - sliceDot * viewDir.y, sliceDir.z - sliceDot * viewDir.z);
+                float3 axis = normalize3(cross3(orthoDir, viewDir));
+                float  axisDot = dot3(normal, axis);
+                float3 projectedNormal = make3(normal.x - axis.x * axisDot, normal.y - axis.y * axisDot, normal.z - axis.z * axisDot);
+                float  projectedLength = sqrtf(dot3(projectedNormal, projectedNormal));
+                float  cosN = saturate(dot3(projectedNormal, viewDir) / MAX(projectedLength, 1e-6f));
+                float  n = (dot3(orthoDir, projectedNormal) < 0.0f ? -1.0f : 1.0f) * acosf(cosN);
+
+                // Clamp horizons to the hemisphere around the normal
+                float h0 = n + MAX(-acosf(horizonCos[1]) - n, -(float)M_PI_2);
+                float h1 = n + MIN(acosf(horizonCos[0]) - n, (float)M_PI_2);
+
+                // Cosine weighted arc integral
+                float arc0 = (cosN + 2.0f * h0 * sinf(n) - cosf(2.0f * h0 - n)) * 0.25f;
+                float arc1 = (cosN + 2.0f * h1 * sinf(n) - cosf(2.0f * h1 - n)) * 0.25f;
+
+                visibility += projectedLength * (arc0 + arc1);
+            }
+
+            // Finally calculate the AO occlusion value
+            float occlusion = 1.0f - visibility / kernel.m_SliceCount;
+            occlusion *= linearIntensity;
+            occlusion = 1.0f - saturate(occlusion);
+
+            float weight = saturate((center.z - viewDistanceFade) / fadeIntervalLength);
+            pOutput[y * width + x] = occlusion + (1.0f - occlusion) * weight;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// One direction of the separable depth aware gaussian, same weights as CS_AMD_BLUR (BilateralFilter.hlsl)
+// Like the shader, taps are placed in output texels and fetched through normalized coordinates,
+// so input and output may have different resolutions
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::blurPass(const float * pInput, uint2 inputSize, float * pOutput, uint2 outputSize, bool vertical, AOFX_BILATERAL_BLUR_RADIUS radius, float depthThreshold)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    uint width = m_Resolution.x, height = m_Resolution.y;
+    sint kernelRadius = s_BlurRadius[radius];
+    float deviation = kernelRadius * 0.5f;
+    float weights[2 * 16 + 1];
+
+    for (sint i = -kernelRadius; i <= kernelRadius; i++)
+        weights[i + kernelRadius] = expf(-(float)(i * i) / (2.0f * deviation * deviation));
+
+    const float * pDepth = &m_LinearDepth[0];
+    sint stepX = vertical ? 0 : 1;
+    sint stepY = vertical ? 1 : 0;
+
+    for (uint y = 0; y < outputSize.y; y++)
+    {
+        for (uint x = 0; x < outputSize.x; x++)
+        {
+            float centerDepth = pDepth[scaleCoord(y, outputSize.y, height) * width + scaleCoord(x, outputSize.x, width)];
+            float filtered = pInput[scaleCoord(y, outputSize.y, inputSize.y) * inputSize.x + scaleCoord(x, outputSize.x, inputSize.x)] * weights[kernelRadius];
+            float weightSum = weights[kernelRadius];
+
+            for (sint i = -kernelRadius; i <= kernelRadius; i++)
+            {
+                if (i == 0) continue;
+
+                uint tapX = clampCoord(x + i * stepX, outputSize.x);
+                uint tapY = clampCoord(y + i * stepY, outputSize.y);
+                float tapDepth = pDepth[scaleCoord(tapY, outputSize.y, height) * width + scaleCoord(tapX, outputSize.x, width)];
+                if (fabsf(tapDepth - centerDepth) >= depthThreshold) continue;
+
+                filtered += pInput[scaleCoord(tapY, outputSize.y, inputSize.y) * inputSize.x + scaleCoord(tapX, outputSize.x, inputSize.x)] * weights[i + kernelRadius];
+                weightSum += weights[i + kernelRadius];
+            }
+
+            pOutput[y * outputSize.x + x] = filtered / weightSum;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Both passes run at the resolution of 'ao' so taps are spaced the same in both directions, same as csBlurAO.
+// The horizontal pass goes into the first aoSize texels of the full resolution m_BlurAO
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::blurAO(std::vector<float> & ao, uint2 aoSize, AOFX_BILATERAL_BLUR_RADIUS radius, float depthThreshold)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    blurPass(&ao[0], aoSize, &m_BlurAO[0], aoSize, false, radius, depthThreshold);
+    blurPass(&m_BlurAO[0], aoSize, &ao[0], aoSize, true, radius, depthThreshold);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Blend AO layers together using dilate (min) filter, same as psDilate
+// Downscaled layers are read at their own resolution. When the nearest layer texel lies further than
+// m_DepthUpsampleThreshold from the pixel depth, the closest in depth of the 4 surrounding texels is used instead
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::dilateMultiResAO(const AOFX_Desc & desc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    uint width = m_Resolution.x, height = m_Resolution.y;
+    size_t size = (size_t)width * height;
+
+    for (size_t i = 0; i < size; i++)
+        m_DilateAO[i] = 1.0f;
+
+    for (int layer = 0; layer < m_MultiResLayerCount; layer++)
+    {
+        if (desc.m_LayerProcess[layer] == AOFX_LAYER_PROCESS_NONE) continue;
+
+        uint scaledWidth = m_ScaledResolution[layer].x, scaledHeight = m_ScaledResolution[layer].y;
+        bool downscaled = scaledWidth != width || scaledHeight != height;
+        float threshold = downscaled ? desc.m_DepthUpsampleThreshold[layer] : 0.0f;
+
+        const float * pInput = &m_ResultAO[layer][0];
+        const float3 * pPosition = &m_InputAO[layer][0];
+        float powIntensity = desc.m_PowIntensity[layer];
+
+        for (uint y = 0; y < height; y++)
+        {
+            uint nearestY = scaleCoord(y, height, scaledHeight);
+            sint baseY = (sint)floorf((y + 0.5f) * scaledHeight / height - 0.5f);
+
+            for (uint x = 0; x < width; x++)
+            {
+                uint nearestX = scaleCoord(x, width, scaledWidth);
+                uint index = nearestY * scaledWidth + nearestX;
+
+                if (threshold > 0.0f)
+                {
+                    float centerDepth = m_LinearDepth[y * width + x];
+                    float nearestDelta = fabsf(pPosition[index].z - centerDepth);
+
+                    if (nearestDelta > threshold)
+                    {
+                        sint baseX = (sint)floorf((x + 0.5f) * scaledWidth / width - 0.5f);
+
+                        for (sint tap = 0; tap < 4; tap++)
+                        {
+                            uint tapIndex = clampCoord(baseY + (tap >> 1), scaledHeight) * scaledWidth + clampCoord(baseX + (tap & 1), scaledWidth);
+                            float tapDelta = fabsf(pPosition[tapIndex].z - centerDepth);
+
+                            if (tapDelta < nearestDelta)
+                            {
+                                nearestDelta = tapDelta;
+                                index = tapIndex;
+                            }
+                        }
+                    }
+                }
+
+                float & dilate = m_DilateAO[y * width + x];
+                dilate = MIN(dilate, powf(pInput[index], powIntensity));
+            }
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Same stages and counters as AOFX_OpaqueDesc, the CPU path has no constant buffers to upload
+// and reports a NULL device context
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::beginStage(const AOFX_Desc & desc, AOFX_STAGE stage, uint layer)
+{
+    memset(&m_StageCounters, 0, sizeof(m_StageCounters));
+    m_StageCounters.m_Stage = stage;
+    m_StageCounters.m_Layer = layer;
+
+    if (desc.m_pInstrumentation != NULL && desc.m_pInstrumentation->m_pBeginStage != NULL)
+        desc.m_pInstrumentation->m_pBeginStage(stage, layer, NULL, desc.m_pInstrumentation->m_pUserData);
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::endStage(const AOFX_Desc & desc)
+{
+    if (desc.m_pInstrumentation != NULL && desc.m_pInstrumentation->m_pEndStage != NULL)
+        desc.m_pInstrumentation->m_pEndStage(m_StageCounters, NULL, desc.m_pInstrumentation->m_pUserData);
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_CpuDesc::countPass(uint width, uint height, size_t bytesPerTexel)
+{
+    size_t texels = (size_t)width * height;
+
+    m_StageCounters.m_Passes++;
+    m_StageCounters.m_DispatchSize[0] = width;
+    m_StageCounters.m_DispatchSize[1] = height;
+    m_StageCounters.m_DispatchSize[2] = 1;
+    m_StageCounters.m_TexelsProcessed += texels;
+    m_StageCounters.m_BytesWritten += texels * bytesPerTexel;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_CpuDesc::render(const AOFX_Desc & desc, AOFX_BatchImage & image, const AO_KernelData * pKernelData)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (image.m_pDepth == NULL)
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+
+    AOFX_RETURN_CODE result = resize(desc, image.m_Size.x, image.m_Size.y);
+    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+
+    AO_CameraData camera(image.m_Camera);
+    size_t size = (size_t)m_Resolution.x * m_Resolution.y;
+
+    m_KernelSeconds = 0.0;
+
+    // Linearize depth, shared by all layers
+    beginStage(desc, AOFX_STAGE_PROCESS_INPUT, m_MultiResLayerCount);
+    for (size_t i = 0; i < size; i++)
+        m_LinearDepth[i] = -camera.m_CameraQTimesZNear / (image.m_pDepth[i] - camera.m_CameraQ);
+    countPass(m_Resolution.x, m_Resolution.y, sizeof(float));
+    endStage(desc);
+
+    for (int i = 0; i < m_MultiResLayerCount; ++i)
+    {
+        if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+
+        beginStage(desc, AOFX_STAGE_PROCESS_INPUT, i);
+        processInput(i, desc, camera);
+        countPass(m_ScaledResolution[i].x, m_ScaledResolution[i].y, sizeof(float3) + sizeof(float));
+        endStage(desc);
+    }
+
+    // in the stage order of AOFX_Render, all inputs are processed before the first AO kernel
+    for (int i = 0; i < m_MultiResLayerCount; ++i)
+    {
+        if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+
+        AO_KernelData kernel = pKernelData != NULL ? pKernelData[i] : AO_KernelData(desc, i, desc.m_KernelType[i], desc.m_SampleCount[i]);
+        beginStage(desc, AOFX_STAGE_AMBIENT_OCCLUSION, i);
+        std::chrono::high_resolution_clock::time_point kernelStart = std::chrono::high_resolution_clock::now();
+
+        if (kernel.m_KernelType == AOFX_KERNEL_TYPE_GTAO)
+            ambientOcclusionGTAO(i, desc, kernel);
+        else
+            ambientOcclusionHDAO(i, desc, kernel);
+
+        std::chrono::duration<double> kernelElapsed = std::chrono::high_resolution_clock::now() - kernelStart;
+        m_KernelSeconds += kernelElapsed.count();
+        countPass(m_ScaledResolution[i].x, m_ScaledResolution[i].y, sizeof(float));
+        endStage(desc);
+    }
+
+    // Need to check if all layers have the same blur radius (and that the blur radius != NONE)
+    bool separateBlur = false;
+    bool active[m_MultiResLayerCount];
+    int  blurRadius[m_MultiResLayerCount];
+    int  blurRadiusResult = AOFX_BILATERAL_BLUR_RADIUS_NONE;
+    int  firstActive = -1;
+
+    for (int i = 0; i < m_MultiResLayerCount; ++i)
+    {
+        active[i] = desc.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE;
+        blurRadius[i] = active[i] ? desc.m_BilateralBlurRadius[i] : AOFX_BILATERAL_BLUR_RADIUS_NONE;
+        blurRadiusResult = MAX(blurRadiusResult, blurRadius[i]);
+        if (active[i] && firstActive < 0) firstActive = i;
+    }
+    for (int i = 0; i < m_MultiResLayerCount; ++i)
+    {
+        separateBlur = separateBlur || (active[i] && active[(i + 1) % m_MultiResLayerCount] && blurRadius[i] != blurRadius[(i + 1) % m_MultiResLayerCount]);
+    }
+
+    // if each layer has a different blur radius, AO layers need to be blurred before blended
+    if (separateBlur == true)
+    {
+        for (int i = 0; i < m_MultiResLayerCount; ++i)
+        {
+            if (active[i] && blurRadius[i] != AOFX_BILATERAL_BLUR_RADIUS_NONE)
+            {
+                beginStage(desc, AOFX_STAGE_BLUR, i);
+                blurAO(m_ResultAO[i], m_ScaledResolution[i], (AOFX_BILATERAL_BLUR_RADIUS)blurRadius[i], desc.m_DepthUpsampleThreshold[i]);
+                countPass(m_ScaledResolution[i].x, m_ScaledResolution[i].y, sizeof(float));
+                countPass(m_ScaledResolution[i].x, m_ScaledResolution[i].y, sizeof(float));
+                endStage(desc);
+            }
+        }
+    }
+
+    beginStage(desc, AOFX_STAGE_DILATE, m_MultiResLayerCount);
+    dilateMultiResAO(desc);
+    countPass(m_Resolution.x, m_Resolution.y, sizeof(float));
+    endStage(desc);
+
+    if (separateBlur == false &&
+        blurRadiusResult != AOFX_BILATERAL_BLUR_RADIUS_NONE)
+    {
+        beginStage(desc, AOFX_STAGE_BLUR, m_MultiResLayerCount);
+        blurAO(m_DilateAO, m_Resolution, (AOFX_BILATERAL_BLUR_RADIUS)blurRadiusResult, desc.m_DepthUpsampleThreshold[firstActive]);
+        countPass(m_Resolution.x, m_Resolution.y, sizeof(float));
+        countPass(m_Resolution.x, m_Resolution.y, sizeof(float));
+        endStage(desc);
+    }
+
+    beginStage(desc, AOFX_STAGE_OUTPUT, m_MultiResLayerCount);
+    if (image.m_pOutput != NULL)
+    {
+        memcpy(image.m_pOutput, &m_DilateAO[0], size * sizeof(float));
+        countPass(m_Resolution.x, m_Resolution.y, sizeof(float));
+    }
+    else
+        image.m_pOutput = &m_DilateAO[0];
+    endStage(desc);
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_CpuRenderBatch(const AOFX_Desc & desc, const AOFX_BatchDesc & batch, AOFX_BatchStats * pStats)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    // the table is generated once per batch and shared by all workers
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4>  cbSamplePattern(1);
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SBYTE2> t1dSamplePattern(1);
+    AOFX_OpaqueDesc::generateSamplePatterns(cbSamplePattern[0], t1dSamplePattern[0]);
+
+    uint threadCount = batch.m_ThreadCount != 0 ? batch.m_ThreadCount : std::thread::hardware_concurrency();
+    threadCount = MIN(MAX(threadCount, (uint)1), batch.m_ImageCount);
+
+    std::atomic<uint>   nextImage(0);
+    std::atomic<uint>   imagesProcessed(0);
+    std::atomic<uint>   imagesFailed(0);
+    std::atomic<uint>   scratchAllocations(0);
+    std::atomic<uint64> texelsProcessed(0);
+
+    auto worker = [&]()
+    {
+        AOFX_CpuDesc cpuDesc(&cbSamplePattern[0]);
+
+        for (uint index = nextImage++; index < batch.m_ImageCount; index = nextImage++)
+        {
+            AOFX_BatchImage image;
+            if (batch.m_pImages != NULL)
+                image = batch.m_pImages[index];
+
+            AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
+            if (batch.m_pLoad != NULL && !batch.m_pLoad(image, index, batch.m_pUserData))
+                result = AOFX_RETURN_CODE_FAIL;
+            if (result == AOFX_RETURN_CODE_SUCCESS && image.m_pOutput == NULL && batch.m_pStore == NULL)
+                result = AOFX_RETURN_CODE_INVALID_POINTER;
+            if (result == AOFX_RETURN_CODE_SUCCESS)
+                result = cpuDesc.render(desc, image);
+
+            bool stored = true;
+            if (batch.m_pStore != NULL)
+                stored = batch.m_pStore(image, index, result, batch.m_pUserData);
+
+            if (result == AOFX_RETURN_CODE_SUCCESS && stored)
+            {
+                imagesProcessed++;
+                texelsProcessed += (uint64)image.m_Size.x * image.m_Size.y;
+            }
+            else
+            {
+                imagesFailed++;
+            }
+        }
+
+        scratchAllocations += cpuDesc.m_Allocations;
+    };
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    // the calling thread is one of the workers
+    std::vector<std::thread> threads;
+    for (uint i = 1; i < threadCount; i++)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    if (pStats != NULL)
+    {
+        pStats->m_ImagesProcessed = imagesProcessed;
+        pStats->m_ImagesFailed = imagesFailed;
+        pStats->m_ThreadCount = threadCount;
+        pStats->m_ScratchAllocations = scratchAllocations;
+        pStats->m_Seconds = elapsed.count();
+        pStats->m_ImagesPerSecond = elapsed.count() > 0.0 ? imagesProcessed / elapsed.count() : 0.0;
+        pStats->m_MegaTexelsPerSecond = elapsed.count() > 0.0 ? texelsProcessed / elapsed.count() * 1e-6 : 0.0;
+    }
+
+    return imagesFailed == 0 ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_FAIL;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Renders the image with every kernel type at every sample count and scores each result against
+// one reference, a densely marched GTAO image standing in for the ground truth occlusion
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_CpuCompareKernels(const AOFX_Desc & desc, const AOFX_BatchImage & image, uint iterations, AOFX_KernelComparison * pResults)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4>  cbSamplePattern(1);
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SBYTE2> t1dSamplePattern(1);
+    AOFX_OpaqueDesc::generateSamplePatterns(cbSamplePattern[0], t1dSamplePattern[0]);
+
+    AOFX_CpuDesc cpuDesc(&cbSamplePattern[0]);
+    AOFX_CpuDesc::AO_KernelData kernelData[AOFX_Desc::m_MultiResLayerCount];
+
+    size_t size = (size_t)image.m_Size.x * image.m_Size.y;
+    std::vector<float> reference(size);
+    std::vector<float> result(size);
+
+    AOFX_BatchImage target = image;
+
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        kernelData[i] = AOFX_CpuDesc::AO_KernelData(desc, i, AOFX_KERNEL_TYPE_GTAO, AOFX_SAMPLE_COUNT_ULTRA);
+        kernelData[i].m_TapType = AOFX_TAP_TYPE_FIXED;
+        kernelData[i].m_SliceCount = s_ReferenceSliceCount;
+        kernelData[i].m_StepCount = s_ReferenceStepCount;
+    }
+
+    target.m_pOutput = &reference[0];
+    AOFX_RETURN_CODE code = cpuDesc.render(desc, target, kernelData);
+    if (code != AOFX_RETURN_CODE_SUCCESS) return code;
+
+    target.m_pOutput = &result[0];
+
+    for (int kernel = 0; kernel < AOFX_KERNEL_TYPE_COUNT; kernel++)
+    {
+        for (int sample = 0; sample < AOFX_SAMPLE_COUNT_COUNT; sample++)
+        {
+            for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+                kernelData[i] = AOFX_CpuDesc::AO_KernelData(desc, i, (AOFX_KERNEL_TYPE)kernel, (AOFX_SAMPLE_COUNT)sample);
+
+            double seconds = 0.0;
+            for (uint iteration = 0; iteration < iterations; iteration++)
+            {
+                code = cpuDesc.render(desc, target, kernelData);
+                if (code != AOFX_RETURN_CODE_SUCCESS) return code;
+
+                seconds = iteration == 0 ? cpuDesc.m_KernelSeconds : MIN(seconds, cpuDesc.m_KernelSeconds);
+            }
+
+            double squaredError = 0.0;
+            for (size_t i = 0; i < size; i++)
+                squaredError += (double)(result[i] - reference[i]) * (result[i] - reference[i]);
+
+            AOFX_KernelComparison & comparison = pResults[kernel * AOFX_SAMPLE_COUNT_COUNT + sample];
+            comparison.m_KernelType = (AOFX_KERNEL_TYPE)kernel;
+            comparison.m_SampleCount = (AOFX_SAMPLE_COUNT)sample;
+            comparison.m_Milliseconds = seconds * 1000.0;
+            comparison.m_RMSE = sqrt(squaredError / size);
+            comparison.m_PSNR = comparison.m_RMSE > 0.0 ? MIN(-20.0 * log10(comparison.m_RMSE), 100.0) : 100.0;
+            comparison.m_PSNRPerMillisecond = comparison.m_Milliseconds > 0.0 ? comparison.m_PSNR / comparison.m_Milliseconds : 0.0;
+        }
+    }
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+} // namespace AMD
@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef __AMD_AOFX_CPU_H__
+#define __AMD_AOFX_CPU_H__
+
+#include "AMD_AOFX_OPAQUE.h"
+
+#include <vector>
+
+namespace AMD
+{
+// CPU version of the AOFX_OpaqueDesc render path, used by AOFX_RenderBatch
+// Each worker thread owns one AOFX_CpuDesc, its surfaces are only reallocated when image size changes
+struct AOFX_CpuDesc
+{
+public:
+
+#pragma warning(push)
+#pragma warning(disable : 4201)        // suppress nameless struct/union level 4 warnings
+    AMD_DECLARE_BASIC_VECTOR_TYPE;
+#pragma warning(pop)
+
+    static const sint m_MultiResLayerCount = AOFX_Desc::m_MultiResLayerCount;
+
+    // Camera parameters shared by all passes, same values as AO_Data / AO_InputData
+    struct AO_CameraData
+    {
+        float                                 m_CameraQ;                    // far / (far - near)
+        float                                 m_CameraQTimesZNear;          // Q * near
+        float                                 m_CameraTanHalfFovHorizontal; // Tan Horiz and Vert FOV
+        float                                 m_CameraTanHalfFovVertical;
+
+        AO_CameraData(const AOFX_Desc::Camera & camera)
+        {
+            float zDistance = (camera.m_FarPlane - camera.m_NearPlane);
+            this->m_CameraQ = camera.m_FarPlane / zDistance;
+            this->m_CameraQTimesZNear = this->m_CameraQ * camera.m_NearPlane;
+            this->m_CameraTanHalfFovHorizontal = tanf(camera.m_Fov * 0.5f * camera.m_Aspect);
+            this->m_CameraTanHalfFovVertical = tanf(camera.m_Fov * 0.5f);
+        }
+    };
+
+    // Kernel options of a single layer, taken from the desc unless AOFX_CompareKernels overrides them
+    struct AO_KernelData
+    {
+        AOFX_KERNEL_TYPE                      m_KernelType;
+        AOFX_TAP_TYPE                         m_TapType;
+        uint                                  m_SampleCount;                // HDAO valley count
+        uint                                  m_SliceCount;                 // GTAO slices, m_SampleCount / m_StepCount
+        uint                                  m_StepCount;                  // GTAO steps per slice side
+
+        AO_KernelData() {}
+        AO_KernelData(const AOFX_Desc & desc, uint target, AOFX_KERNEL_TYPE kernelType, AOFX_SAMPLE_COUNT sampleCount);
+    };
+
+    uint2                                   m_Resolution;
+    uint2                                   m_ScaledResolution[m_MultiResLayerCount];
+    uint                                    m_Allocations;
+    double                                  m_KernelSeconds;                        // time spent in the AO kernel by the last render
+    AOFX_StageCounters                      m_StageCounters;                        // reported through AOFX_Desc::m_pInstrumentation
+
+    const AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4 * m_pSamplePatterns;
+
+    std::vector<float>                      m_LinearDepth;                          // full resolution camera space Z
+    std::vector<float3>                     m_InputAO[m_MultiResLayerCount];        // scaled camera space XYZ
+    std::vector<float>                      m_InputDistance[m_MultiResLayerCount];  // scaled length(XYZ)
+    std::vector<float>                      m_ResultAO[m_MultiResLayerCount];       // scaled AO
+    std::vector<float>                      m_DilateAO;
+    std::vector<float>                      m_BlurAO;                               // horizontal blur pass result, sized for full resolution layers
+
+    AOFX_CpuDesc(const AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4 * pSamplePatterns);
+
+    AOFX_RETURN_CODE                        resize(const AOFX_Desc & desc, uint width, uint height);
+
+    AOFX_RETURN_CODE                        render(const AOFX_Desc & desc, AOFX_BatchImage & image, const AO_KernelData * pKernelData = NULL);
+
+    void                                    processInput(uint target, const AOFX_Desc & desc, const AO_CameraData & camera);
+    void                                    ambientOcclusionHDAO(uint target, const AOFX_Desc & desc, const AO_KernelData & kernel);
+    void                                    ambientOcclusionGTAO(uint target, const AOFX_Desc & desc, const AO_KernelData & kernel);
+    void                                    blurPass(const float * pInput, uint2 inputSize, float * pOutput, uint2 outputSize, bool vertical, AOFX_BILATERAL_BLUR_RADIUS radius, float depthThreshold);
+    void                                    blurAO(std::vector<float> & ao, uint2 aoSize, AOFX_BILATERAL_BLUR_RADIUS radius, float depthThreshold);
+    void                                    dilateMultiResAO(const AOFX_Desc & desc);
+
+    void                                    beginStage(const AOFX_Desc & desc, AOFX_STAGE stage, uint layer);
+    void                                    endStage(const AOFX_Desc & desc);
+    void                                    countPass(uint width, uint height, size_t bytesPerTexel);
+};
+
+AOFX_RETURN_CODE                            AOFX_CpuRenderBatch(const AOFX_Desc & desc, const AOFX_BatchDesc & batch, AOFX_BatchStats * pStats);
+AOFX_RETURN_CODE                            AOFX_CpuCompareKernels(const AOFX_Desc & desc, const AOFX_BatchImage & image, uint iterations, AOFX_KernelComparison * pResults);
+AOFX_RETURN_CODE                            AOFX_CpuAutotune(const AOFX_Desc & desc, const AOFX_AutotuneDesc & autotune, AOFX_AutotuneResult & result);
+
+// AOFX_Autotune image metrics, SSE
+double                                      AOFX_CpuSSIM(const float * pImage, const float * pReference, uint width, uint height);
+double                                      AOFX_CpuPSNR(const float * pImage, const float * pReference, uint width, uint height);
+
+// AOFX_CaptureAppend plane codec, lossless, texel (x, y) of lane l is pData[(y * width + x) * lanes + l]
+// Decoding fails if the plane ends early, corrupt planes decode to wrong texels but never write past pData
+void                                        AOFX_CpuEncodePlanes(const uint8 * pData, uint width, uint height, uint lanes, std::vector<uint8> & output);
+void                                        AOFX_CpuEncodePlanes(const uint16 * pData, uint width, uint height, uint lanes, std::vector<uint8> & output);
+void                                        AOFX_CpuEncodePlanes(const uint32 * pData, uint width, uint height, uint lanes, std::vector<uint8> & output);
+bool                                        AOFX_CpuDecodePlanes(const uint8 * pPlane, size_t size, uint width, uint height, uint lanes, uint8 * pData);
+bool                                        AOFX_CpuDecodePlanes(const uint8 * pPlane, size_t size, uint width, uint height, uint lanes, uint16 * pData);
+bool                                        AOFX_CpuDecodePlanes(const uint8 * pPlane, size_t size, uint width, uint height, uint lanes, uint32 * pData);
+
+} // namespace AMD
+
+#endif // __AMD_AOFX_CPU_H__
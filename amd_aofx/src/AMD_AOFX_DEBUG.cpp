@@ -68,6 +68,7 @@ AMD_AOFX_DLL_API AOFX_RETURN_CODE AOFX_DebugSerialize(AOFX_Desc& desc, const cha
             serialize_uint(file, "desc.m_SampleCount", (uint *)&desc.m_SampleCount[i]);
             serialize_uint(file, "desc.m_NormalOption", (uint *)&desc.m_NormalOption[i]);
             serialize_uint(file, "desc.m_TapType", (uint *)&desc.m_TapType[i]);
+            serialize_uint(file, "desc.m_KernelType", (uint *)&desc.m_KernelType[i]);
             serialize_float(file, "desc.m_MultiResLayerScale", (float *)&desc.m_MultiResLayerScale[i]);
             serialize_float(file, "desc.m_PowIntensity", (float *)&desc.m_PowIntensity[i]);
             serialize_float(file, "desc.m_RejectRadius", (float *)&desc.m_RejectRadius[i]);
@@ -181,6 +182,7 @@ AMD_AOFX_DLL_API AOFX_RETURN_CODE AOFX_DebugDeserialize(AOFX_Desc& desc,
             deserialize_uint(file, readStr, (uint *)&desc.m_SampleCount[i]);
             deserialize_uint(file, readStr, (uint *)&desc.m_NormalOption[i]);
             deserialize_uint(file, readStr, (uint *)&desc.m_TapType[i]);
+            deserialize_uint(file, readStr, (uint *)&desc.m_KernelType[i]);
             deserialize_float(file, readStr, (float *)&desc.m_MultiResLayerScale[i]);
             deserialize_float(file, readStr, (float *)&desc.m_PowIntensity[i]);
             deserialize_float(file, readStr, (float *)&desc.m_RejectRadius[i]);
@@ -0,0 +1,202 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <d3d11.h>
+
+#if AMD_AOFX_COMPILE_DYNAMIC_LIB
+# define AMD_DLL_EXPORTS
+#endif
+
+#include "AMD_AOFX_OPAQUE.h"
+
+namespace AMD
+{
+static const uint g_DefaultLevelCount = 6;
+static const uint g_MaxUpgradeBackoff = 64;
+
+//-------------------------------------------------------------------------------------------------
+// Built in ladder: a single full resolution layer loses samples and blur radius first,
+// only the last two levels halve its resolution (and reallocate its surfaces)
+//-------------------------------------------------------------------------------------------------
+static AOFX_QualityLevel defaultLevel(uint level)
+{
+    static const AOFX_SAMPLE_COUNT          sampleCount[g_DefaultLevelCount] = { AOFX_SAMPLE_COUNT_ULTRA, AOFX_SAMPLE_COUNT_HIGH, AOFX_SAMPLE_COUNT_MEDIUM, AOFX_SAMPLE_COUNT_LOW, AOFX_SAMPLE_COUNT_MEDIUM, AOFX_SAMPLE_COUNT_LOW };
+    static const AOFX_BILATERAL_BLUR_RADIUS blurRadius[g_DefaultLevelCount] = { AOFX_BILATERAL_BLUR_RADIUS_8, AOFX_BILATERAL_BLUR_RADIUS_8, AOFX_BILATERAL_BLUR_RADIUS_4, AOFX_BILATERAL_BLUR_RADIUS_4, AOFX_BILATERAL_BLUR_RADIUS_4, AOFX_BILATERAL_BLUR_RADIUS_2 };
+    static const float                      layerScale[g_DefaultLevelCount] = { 1.0f, 1.0f, 1.0f, 1.0f, 0.5f, 0.5f };
+
+    AOFX_QualityLevel result;
+
+    for (uint i = 1; i < AOFX_Desc::m_MultiResLayerCount; i++)
+        result.m_LayerProcess[i] = AOFX_LAYER_PROCESS_NONE;
+
+    result.m_LayerProcess[0] = AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE;
+    result.m_MultiResLayerScale[0] = layerScale[level];
+    result.m_SampleCount[0] = sampleCount[level];
+    result.m_BilateralBlurRadius[0] = blurRadius[level];
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static uint levelCount(const AOFX_GovernorDesc & governorDesc)
+{
+    return governorDesc.m_pLevels != NULL ? governorDesc.m_LevelCount : g_DefaultLevelCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static AOFX_QualityLevel getLevel(const AOFX_GovernorDesc & governorDesc, uint level)
+{
+    return governorDesc.m_pLevels != NULL ? governorDesc.m_pLevels[level] : defaultLevel(level);
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static void changeLevel(AOFX_Governor & governor, uint level, bool upgraded, AOFX_Desc & desc, bool & resizeRequired)
+{
+    AOFX_QualityLevel next = getLevel(governor.m_Desc, level);
+
+    resizeRequired = AOFX_OpaqueDesc::requiresResize(next, desc);
+    AOFX_OpaqueDesc::applyQualityLevel(next, desc);
+
+    governor.m_Level = level;
+    governor.m_Upgraded = upgraded;
+    governor.m_OverBudgetFrames = 0;
+    governor.m_UnderBudgetFrames = 0;
+    governor.m_FramesAtLevel = 0;
+    governor.m_LevelChanges++;
+    governor.m_Resizes += resizeRequired ? 1 : 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_GovernorInitialize(AOFX_Governor * pGovernor, const AOFX_GovernorDesc & governorDesc, AOFX_Desc & desc, bool * pResizeRequired)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pGovernor == NULL || pResizeRequired == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if ((governorDesc.m_pLevels != NULL && governorDesc.m_LevelCount == 0) ||
+        governorDesc.m_BudgetMilliseconds <= 0.0f ||
+        governorDesc.m_Hysteresis < 0.0f || governorDesc.m_Hysteresis >= 1.0f ||
+        governorDesc.m_Smoothing <= 0.0f || governorDesc.m_Smoothing > 1.0f)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    *pGovernor = AOFX_Governor();
+    pGovernor->m_Desc = governorDesc;
+
+    changeLevel(*pGovernor, MIN(governorDesc.m_StartLevel, levelCount(governorDesc) - 1), false, desc, *pResizeRequired);
+    pGovernor->m_LevelChanges = 0;
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Quality is lowered after m_DowngradeFrames over budget and raised after m_UpgradeFrames below
+// the hysteresis band. Steps that reallocate surfaces wait m_ResizeFrameScale times longer,
+// so transient spikes are absorbed by the cheap steps of the ladder
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_GovernorUpdate(AOFX_Governor * pGovernor, float milliseconds, AOFX_Desc & desc, bool * pResizeRequired)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pGovernor == NULL || pResizeRequired == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+    if (milliseconds < 0.0f)
+    {
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    }
+
+    AOFX_Governor & governor = *pGovernor;
+    const AOFX_GovernorDesc & governorDesc = governor.m_Desc;
+    uint count = levelCount(governorDesc);
+
+    *pResizeRequired = false;
+
+    // the average restarts with every level, samples of the previous level do not describe the current one
+    governor.m_FramesAtLevel++;
+    if (governor.m_FramesAtLevel == 1)
+        governor.m_AverageMilliseconds = milliseconds;
+    else
+        governor.m_AverageMilliseconds += governorDesc.m_Smoothing * (milliseconds - governor.m_AverageMilliseconds);
+
+    if (governor.m_AverageMilliseconds > governorDesc.m_BudgetMilliseconds)
+    {
+        governor.m_OverBudgetFrames++;
+        governor.m_UnderBudgetFrames = 0;
+    }
+    else if (governor.m_AverageMilliseconds < governorDesc.m_BudgetMilliseconds * (1.0f - governorDesc.m_Hysteresis))
+    {
+        governor.m_UnderBudgetFrames++;
+        governor.m_OverBudgetFrames = 0;
+    }
+    else
+    {
+        governor.m_OverBudgetFrames = 0;
+        governor.m_UnderBudgetFrames = 0;
+    }
+
+    // a raised level that held long enough fits the budget, stop backing off
+    if (governor.m_Upgraded && governor.m_FramesAtLevel >= governorDesc.m_UpgradeFrames)
+    {
+        governor.m_Upgraded = false;
+        governor.m_UpgradeBackoff = 1;
+    }
+
+    if (governor.m_OverBudgetFrames > 0 && governor.m_Level + 1 < count)
+    {
+        bool resize = AOFX_OpaqueDesc::requiresResize(getLevel(governorDesc, governor.m_Level + 1), desc);
+        uint frames = governorDesc.m_DowngradeFrames * (resize ? governorDesc.m_ResizeFrameScale : 1);
+
+        if (governor.m_OverBudgetFrames >= MAX(frames, (uint)1))
+        {
+            if (governor.m_Upgraded)
+                governor.m_UpgradeBackoff = MIN(governor.m_UpgradeBackoff * 2, g_MaxUpgradeBackoff);
+
+            changeLevel(governor, governor.m_Level + 1, false, desc, *pResizeRequired);
+        }
+    }
+    else if (governor.m_UnderBudgetFrames > 0 && governor.m_Level > 0)
+    {
+        bool resize = AOFX_OpaqueDesc::requiresResize(getLevel(governorDesc, governor.m_Level - 1), desc);
+        uint frames = governorDesc.m_UpgradeFrames * governor.m_UpgradeBackoff * (resize ? governorDesc.m_ResizeFrameScale : 1);
+
+        if (governor.m_UnderBudgetFrames >= MAX(frames, (uint)1))
+        {
+            changeLevel(governor, governor.m_Level - 1, true, desc, *pResizeRequired);
+        }
+    }
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+}
\ No newline at end of file
@@ -0,0 +1,890 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include <d3d11_1.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#if AMD_AOFX_COMPILE_DYNAMIC_LIB
+# define AMD_DLL_EXPORTS
+#endif
+
+#include "AMD_AOFX_OPAQUE.h"
+
+#pragma warning( disable : 4100 ) // disable unreference formal parameter warnings for /W4 builds
+
+namespace AMD
+{
+// Returned by QueryInterface of the null context only, used to recognize it in AOFX_GetDeviceCounters
+// {7C2B4F5E-3A1D-4E8B-9F06-5D1C2A7B8E43}
+static const GUID s_NullDeviceContextGuid = { 0x7c2b4f5e, 0x3a1d, 0x4e8b, { 0x9f, 0x06, 0x5d, 0x1c, 0x2a, 0x7b, 0x8e, 0x43 } };
+
+static void countReleased(ID3D11Device * pDevice, IUnknown * pObject);
+
+//-------------------------------------------------------------------------------------------------
+// IUnknown and ID3D11DeviceChild shared by every null object
+//-------------------------------------------------------------------------------------------------
+template <class Interface>
+class NullDeviceChild : public Interface
+{
+public:
+    NullDeviceChild(ID3D11Device * pDevice) : m_RefCount(1), m_pDevice(pDevice) {}
+    virtual ~NullDeviceChild() {}
+
+    virtual bool STDMETHODCALLTYPE isInterface(REFIID riid)
+    {
+        return riid == __uuidof(Interface) || riid == __uuidof(ID3D11DeviceChild) || riid == __uuidof(IUnknown);
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void ** ppvObject)
+    {
+        if (ppvObject == NULL) return E_POINTER;
+
+        if (isInterface(riid))
+        {
+            *ppvObject = static_cast<Interface *>(this);
+            AddRef();
+            return S_OK;
+        }
+
+        *ppvObject = NULL;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() { return ++m_RefCount; }
+
+    ULONG STDMETHODCALLTYPE Release()
+    {
+        ULONG refCount = --m_RefCount;
+        if (refCount == 0)
+        {
+            countReleased(m_pDevice, this);
+            delete this;
+        }
+        return refCount;
+    }
+
+    void STDMETHODCALLTYPE GetDevice(ID3D11Device ** ppDevice)
+    {
+        *ppDevice = m_pDevice;
+        m_pDevice->AddRef();
+    }
+
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT * pDataSize, void * pData)
+    {
+        if (pDataSize != NULL) *pDataSize = 0;
+        return DXGI_ERROR_NOT_FOUND;
+    }
+
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT DataSize, const void * pData) { return S_OK; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown * pData) { return S_OK; }
+
+protected:
+    std::atomic<ULONG>                      m_RefCount;
+    ID3D11Device *                          m_pDevice;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Buffers keep a CPU copy of their contents so they can be mapped, textures only keep their desc
+//-------------------------------------------------------------------------------------------------
+template <class Interface, class Desc, D3D11_RESOURCE_DIMENSION Dimension>
+class NullResource : public NullDeviceChild<Interface>
+{
+public:
+    NullResource(ID3D11Device * pDevice, const Desc & desc) : NullDeviceChild<Interface>(pDevice), m_Desc(desc), m_EvictionPriority(0) {}
+
+    bool STDMETHODCALLTYPE isInterface(REFIID riid) { return riid == __uuidof(ID3D11Resource) || NullDeviceChild<Interface>::isInterface(riid); }
+
+    void STDMETHODCALLTYPE GetType(D3D11_RESOURCE_DIMENSION * pResourceDimension) { *pResourceDimension = Dimension; }
+    void STDMETHODCALLTYPE SetEvictionPriority(UINT EvictionPriority) { m_EvictionPriority = EvictionPriority; }
+    UINT STDMETHODCALLTYPE GetEvictionPriority() { return m_EvictionPriority; }
+    void STDMETHODCALLTYPE GetDesc(Desc * pDesc) { *pDesc = m_Desc; }
+
+    Desc                                    m_Desc;
+    UINT                                    m_EvictionPriority;
+    std::vector<BYTE>                       m_Data;
+};
+
+typedef NullResource<ID3D11Buffer, D3D11_BUFFER_DESC, D3D11_RESOURCE_DIMENSION_BUFFER>          NullBuffer;
+typedef NullResource<ID3D11Texture2D, D3D11_TEXTURE2D_DESC, D3D11_RESOURCE_DIMENSION_TEXTURE2D> NullTexture2D;
+
+//-------------------------------------------------------------------------------------------------
+// Views hold a reference to their resource, a NULL view desc is stored zeroed
+//-------------------------------------------------------------------------------------------------
+template <class Interface, class Desc>
+class NullView : public NullDeviceChild<Interface>
+{
+public:
+    NullView(ID3D11Device * pDevice, ID3D11Resource * pResource, const Desc * pDesc) : NullDeviceChild<Interface>(pDevice), m_pResource(pResource)
+    {
+        m_pResource->AddRef();
+        if (pDesc != NULL) m_Desc = *pDesc;
+        else memset(&m_Desc, 0, sizeof(m_Desc));
+    }
+    ~NullView() { m_pResource->Release(); }
+
+    bool STDMETHODCALLTYPE isInterface(REFIID riid) { return riid == __uuidof(ID3D11View) || NullDeviceChild<Interface>::isInterface(riid); }
+
+    void STDMETHODCALLTYPE GetResource(ID3D11Resource ** ppResource)
+    {
+        *ppResource = m_pResource;
+        m_pResource->AddRef();
+    }
+    void STDMETHODCALLTYPE GetDesc(Desc * pDesc) { *pDesc = m_Desc; }
+
+    ID3D11Resource *                        m_pResource;
+    Desc                                    m_Desc;
+};
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+template <class Interface, class Desc>
+class NullState : public NullDeviceChild<Interface>
+{
+public:
+    NullState(ID3D11Device * pDevice, const Desc & desc) : NullDeviceChild<Interface>(pDevice), m_Desc(desc) {}
+
+    void STDMETHODCALLTYPE GetDesc(Desc * pDesc) { *pDesc = m_Desc; }
+
+    Desc                                    m_Desc;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Objects bound to consecutive slots, the context holds a reference to each of them like the runtime
+// does, Get calls hand out an additional reference
+//-------------------------------------------------------------------------------------------------
+template <class Object, UINT Count>
+class NullSlots
+{
+public:
+    NullSlots() { memset(m_pObjects, 0, sizeof(m_pObjects)); }
+    ~NullSlots() { set(0, Count, NULL); }
+
+    // a NULL array unbinds the slots
+    void set(UINT start, UINT count, Object * const * ppObjects)
+    {
+        for (UINT i = 0; i < count && start + i < Count; i++)
+        {
+            Object * pObject = ppObjects != NULL ? ppObjects[i] : NULL;
+            if (pObject != NULL) pObject->AddRef();
+            if (m_pObjects[start + i] != NULL) m_pObjects[start + i]->Release();
+            m_pObjects[start + i] = pObject;
+        }
+    }
+
+    void get(UINT start, UINT count, Object ** ppObjects) const
+    {
+        for (UINT i = 0; ppObjects != NULL && i < count; i++)
+        {
+            ppObjects[i] = start + i < Count ? m_pObjects[start + i] : NULL;
+            if (ppObjects[i] != NULL) ppObjects[i]->AddRef();
+        }
+    }
+
+    Object *                                m_pObjects[Count];
+};
+
+//-------------------------------------------------------------------------------------------------
+// Bindings of a programmable stage, constant buffers keep their D3D11.1 range
+//-------------------------------------------------------------------------------------------------
+template <class Shader>
+struct NullStageState
+{
+    NullStageState() { resetRanges(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT); }
+
+    // the whole buffer is bound when no range is given
+    void resetRanges(UINT start, UINT count)
+    {
+        for (UINT i = start; i < start + count && i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++)
+        {
+            m_FirstConstant[i] = 0;
+            m_NumConstants[i] = D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT;
+        }
+    }
+
+    NullSlots<ID3D11Buffer, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT>          m_ConstantBuffers;
+    UINT                                                                                m_FirstConstant[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+    UINT                                                                                m_NumConstants[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+    NullSlots<ID3D11ShaderResourceView, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT>   m_ShaderResources;
+    NullSlots<ID3D11SamplerState, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT>                m_Samplers;
+    NullSlots<Shader, 1>                                                                m_Shader;
+};
+
+// Set calls of a programmable stage record the bindings and count binds, Get calls return the recorded bindings
+#define AMD_NULL_CONTEXT_STAGE(Stage, Shader) \
+    void STDMETHODCALLTYPE Stage##SetConstantBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers) \
+    { \
+        m_Counters.m_StateBinds++; \
+        m_##Stage.m_ConstantBuffers.set(StartSlot, NumBuffers, ppConstantBuffers); \
+        m_##Stage.resetRanges(StartSlot, NumBuffers); \
+    } \
+    void STDMETHODCALLTYPE Stage##SetConstantBuffers1(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers, const UINT * pFirstConstant, const UINT * pNumConstants) \
+    { \
+        m_Counters.m_StateBinds++; \
+        m_##Stage.m_ConstantBuffers.set(StartSlot, NumBuffers, ppConstantBuffers); \
+        m_##Stage.resetRanges(StartSlot, NumBuffers); \
+        for (UINT i = 0; pFirstConstant != NULL && pNumConstants != NULL && i < NumBuffers && StartSlot + i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++) \
+        { \
+            m_##Stage.m_FirstConstant[StartSlot + i] = pFirstConstant[i]; \
+            m_##Stage.m_NumConstants[StartSlot + i] = pNumConstants[i]; \
+        } \
+    } \
+    void STDMETHODCALLTYPE Stage##SetShaderResources(UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView * const * ppShaderResourceViews) { m_Counters.m_StateBinds++; m_##Stage.m_ShaderResources.set(StartSlot, NumViews, ppShaderResourceViews); } \
+    void STDMETHODCALLTYPE Stage##SetSamplers(UINT StartSlot, UINT NumSamplers, ID3D11SamplerState * const * ppSamplers) { m_Counters.m_StateBinds++; m_##Stage.m_Samplers.set(StartSlot, NumSamplers, ppSamplers); } \
+    void STDMETHODCALLTYPE Stage##SetShader(Shader * pShader, ID3D11ClassInstance * const * ppClassInstances, UINT NumClassInstances) { m_Counters.m_StateBinds++; m_##Stage.m_Shader.set(0, 1, &pShader); } \
+    void STDMETHODCALLTYPE Stage##GetConstantBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer ** ppConstantBuffers) { m_Counters.m_StateQueries++; m_##Stage.m_ConstantBuffers.get(StartSlot, NumBuffers, ppConstantBuffers); } \
+    void STDMETHODCALLTYPE Stage##GetConstantBuffers1(UINT StartSlot, UINT NumBuffers, ID3D11Buffer ** ppConstantBuffers, UINT * pFirstConstant, UINT * pNumConstants) \
+    { \
+        m_Counters.m_StateQueries++; \
+        m_##Stage.m_ConstantBuffers.get(StartSlot, NumBuffers, ppConstantBuffers); \
+        for (UINT i = 0; i < NumBuffers; i++) \
+        { \
+            bool valid = StartSlot + i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; \
+            if (pFirstConstant != NULL) pFirstConstant[i] = valid ? m_##Stage.m_FirstConstant[StartSlot + i] : 0; \
+            if (pNumConstants != NULL) pNumConstants[i] = valid ? m_##Stage.m_NumConstants[StartSlot + i] : 0; \
+        } \
+    } \
+    void STDMETHODCALLTYPE Stage##GetShaderResources(UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView ** ppShaderResourceViews) { m_Counters.m_StateQueries++; m_##Stage.m_ShaderResources.get(StartSlot, NumViews, ppShaderResourceViews); } \
+    void STDMETHODCALLTYPE Stage##GetSamplers(UINT StartSlot, UINT NumSamplers, ID3D11SamplerState ** ppSamplers) { m_Counters.m_StateQueries++; m_##Stage.m_Samplers.get(StartSlot, NumSamplers, ppSamplers); } \
+    void STDMETHODCALLTYPE Stage##GetShader(Shader ** ppShader, ID3D11ClassInstance ** ppClassInstances, UINT * pNumClassInstances) \
+    { \
+        m_Counters.m_StateQueries++; \
+        m_##Stage.m_Shader.get(0, 1, ppShader); \
+        if (pNumClassInstances != NULL) *pNumClassInstances = 0; \
+    }
+
+//-------------------------------------------------------------------------------------------------
+// Immediate context that executes nothing and counts what it was asked to do, it records the bound
+// state so state save/restore can be checked, and implements the D3D11.1 interface so constant
+// buffer offsetting can be measured as well
+//-------------------------------------------------------------------------------------------------
+class NullDeviceContext : public NullDeviceChild<ID3D11DeviceContext1>
+{
+public:
+    NullDeviceContext(ID3D11Device * pDevice)
+        : NullDeviceChild<ID3D11DeviceContext1>(pDevice)
+        , m_ConstantBufferOffsetting(true)
+        , m_IndexBufferFormat(DXGI_FORMAT_UNKNOWN)
+        , m_IndexBufferOffset(0)
+        , m_Topology(D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED)
+        , m_ViewportCount(0)
+        , m_ScissorRectCount(0)
+        , m_SampleMask(0xFFFFFFFF)
+        , m_StencilRef(0)
+    {
+        memset(m_VertexBufferStrides, 0, sizeof(m_VertexBufferStrides));
+        memset(m_VertexBufferOffsets, 0, sizeof(m_VertexBufferOffsets));
+        for (int i = 0; i < 4; i++) m_BlendFactor[i] = 1.0f;
+    }
+
+    bool STDMETHODCALLTYPE isInterface(REFIID riid)
+    {
+        return riid == s_NullDeviceContextGuid || riid == __uuidof(ID3D11DeviceContext) || NullDeviceChild<ID3D11DeviceContext1>::isInterface(riid);
+    }
+
+    template <class Object>
+    static void clearSlots(Object ** ppObjects, UINT count)
+    {
+        for (UINT i = 0; ppObjects != NULL && i < count; i++)
+            ppObjects[i] = NULL;
+    }
+
+    AMD_NULL_CONTEXT_STAGE(VS, ID3D11VertexShader)
+    AMD_NULL_CONTEXT_STAGE(HS, ID3D11HullShader)
+    AMD_NULL_CONTEXT_STAGE(DS, ID3D11DomainShader)
+    AMD_NULL_CONTEXT_STAGE(GS, ID3D11GeometryShader)
+    AMD_NULL_CONTEXT_STAGE(PS, ID3D11PixelShader)
+    AMD_NULL_CONTEXT_STAGE(CS, ID3D11ComputeShader)
+
+    void STDMETHODCALLTYPE CSSetUnorderedAccessViews(UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView * const * ppUnorderedAccessViews, const UINT * pUAVInitialCounts) { m_Counters.m_StateBinds++; m_CSUnorderedAccessViews.set(StartSlot, NumUAVs, ppUnorderedAccessViews); }
+    void STDMETHODCALLTYPE CSGetUnorderedAccessViews(UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView ** ppUnorderedAccessViews) { m_Counters.m_StateQueries++; m_CSUnorderedAccessViews.get(StartSlot, NumUAVs, ppUnorderedAccessViews); }
+
+    void STDMETHODCALLTYPE IASetInputLayout(ID3D11InputLayout * pInputLayout) { m_Counters.m_StateBinds++; m_InputLayout.set(0, 1, &pInputLayout); }
+    void STDMETHODCALLTYPE IASetVertexBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppVertexBuffers, const UINT * pStrides, const UINT * pOffsets)
+    {
+        m_Counters.m_StateBinds++;
+        m_VertexBuffers.set(StartSlot, NumBuffers, ppVertexBuffers);
+        for (UINT i = 0; i < NumBuffers && StartSlot + i < D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT; i++)
+        {
+            m_VertexBufferStrides[StartSlot + i] = pStrides != NULL ? pStrides[i] : 0;
+            m_VertexBufferOffsets[StartSlot + i] = pOffsets != NULL ? pOffsets[i] : 0;
+        }
+    }
+    void STDMETHODCALLTYPE IASetIndexBuffer(ID3D11Buffer * pIndexBuffer, DXGI_FORMAT Format, UINT Offset)
+    {
+        m_Counters.m_StateBinds++;
+        m_IndexBuffer.set(0, 1, &pIndexBuffer);
+        m_IndexBufferFormat = Format;
+        m_IndexBufferOffset = Offset;
+    }
+    void STDMETHODCALLTYPE IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) { m_Counters.m_StateBinds++; m_Topology = Topology; }
+    void STDMETHODCALLTYPE IAGetInputLayout(ID3D11InputLayout ** ppInputLayout) { m_Counters.m_StateQueries++; m_InputLayout.get(0, 1, ppInputLayout); }
+    void STDMETHODCALLTYPE IAGetVertexBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer ** ppVertexBuffers, UINT * pStrides, UINT * pOffsets)
+    {
+        m_Counters.m_StateQueries++;
+        m_VertexBuffers.get(StartSlot, NumBuffers, ppVertexBuffers);
+        for (UINT i = 0; i < NumBuffers; i++)
+        {
+            bool valid = StartSlot + i < D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
+            if (pStrides != NULL) pStrides[i] = valid ? m_VertexBufferStrides[StartSlot + i] : 0;
+            if (pOffsets != NULL) pOffsets[i] = valid ? m_VertexBufferOffsets[StartSlot + i] : 0;
+        }
+    }
+    void STDMETHODCALLTYPE IAGetIndexBuffer(ID3D11Buffer ** pIndexBuffer, DXGI_FORMAT * Format, UINT * Offset)
+    {
+        m_Counters.m_StateQueries++;
+        m_IndexBuffer.get(0, 1, pIndexBuffer);
+        if (Format != NULL) *Format = m_IndexBufferFormat;
+        if (Offset != NULL) *Offset = m_IndexBufferOffset;
+    }
+    void STDMETHODCALLTYPE IAGetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY * pTopology) { m_Counters.m_StateQueries++; *pTopology = m_Topology; }
+
+    void STDMETHODCALLTYPE RSSetState(ID3D11RasterizerState * pRasterizerState) { m_Counters.m_StateBinds++; m_RasterizerState.set(0, 1, &pRasterizerState); }
+    void STDMETHODCALLTYPE RSSetViewports(UINT NumViewports, const D3D11_VIEWPORT * pViewports)
+    {
+        m_Counters.m_StateBinds++;
+        m_ViewportCount = MIN(NumViewports, (UINT)D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE);
+        if (m_ViewportCount > 0) memcpy(m_Viewports, pViewports, m_ViewportCount * sizeof(D3D11_VIEWPORT));
+    }
+    void STDMETHODCALLTYPE RSSetScissorRects(UINT NumRects, const D3D11_RECT * pRects)
+    {
+        m_Counters.m_StateBinds++;
+        m_ScissorRectCount = MIN(NumRects, (UINT)D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE);
+        if (m_ScissorRectCount > 0) memcpy(m_ScissorRects, pRects, m_ScissorRectCount * sizeof(D3D11_RECT));
+    }
+    void STDMETHODCALLTYPE RSGetState(ID3D11RasterizerState ** ppRasterizerState) { m_Counters.m_StateQueries++; m_RasterizerState.get(0, 1, ppRasterizerState); }
+    // like the runtime, a NULL array returns the bound count and a larger count is trimmed to it
+    void STDMETHODCALLTYPE RSGetViewports(UINT * pNumViewports, D3D11_VIEWPORT * pViewports)
+    {
+        m_Counters.m_StateQueries++;
+        if (pViewports != NULL) memcpy(pViewports, m_Viewports, MIN(*pNumViewports, m_ViewportCount) * sizeof(D3D11_VIEWPORT));
+        *pNumViewports = pViewports != NULL ? MIN(*pNumViewports, m_ViewportCount) : m_ViewportCount;
+    }
+    void STDMETHODCALLTYPE RSGetScissorRects(UINT * pNumRects, D3D11_RECT * pRects)
+    {
+        m_Counters.m_StateQueries++;
+        if (pRects != NULL) memcpy(pRects, m_ScissorRects, MIN(*pNumRects, m_ScissorRectCount) * sizeof(D3D11_RECT));
+        *pNumRects = pRects != NULL ? MIN(*pNumRects, m_ScissorRectCount) : m_ScissorRectCount;
+    }
+
+    // binding fewer render targets than the pipeline has unbinds the remaining ones
+    void STDMETHODCALLTYPE OMSetRenderTargets(UINT NumViews, ID3D11RenderTargetView * const * ppRenderTargetViews, ID3D11DepthStencilView * pDepthStencilView)
+    {
+        m_Counters.m_StateBinds++;
+        m_RenderTargets.set(0, NumViews, ppRenderTargetViews);
+        m_RenderTargets.set(NumViews, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT - MIN(NumViews, (UINT)D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT), NULL);
+        m_DepthStencilView.set(0, 1, &pDepthStencilView);
+    }
+    void STDMETHODCALLTYPE OMSetRenderTargetsAndUnorderedAccessViews(UINT NumRTVs, ID3D11RenderTargetView * const * ppRenderTargetViews, ID3D11DepthStencilView * pDepthStencilView,
+                                                                     UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView * const * ppUnorderedAccessViews, const UINT * pUAVInitialCounts)
+    {
+        OMSetRenderTargets(NumRTVs, ppRenderTargetViews, pDepthStencilView);
+    }
+    void STDMETHODCALLTYPE OMSetBlendState(ID3D11BlendState * pBlendState, const FLOAT BlendFactor[4], UINT SampleMask)
+    {
+        m_Counters.m_StateBinds++;
+        m_BlendState.set(0, 1, &pBlendState);
+        for (int i = 0; i < 4; i++) m_BlendFactor[i] = BlendFactor != NULL ? BlendFactor[i] : 1.0f;
+        m_SampleMask = SampleMask;
+    }
+    void STDMETHODCALLTYPE OMSetDepthStencilState(ID3D11DepthStencilState * pDepthStencilState, UINT StencilRef)
+    {
+        m_Counters.m_StateBinds++;
+        m_DepthStencilState.set(0, 1, &pDepthStencilState);
+        m_StencilRef = StencilRef;
+    }
+    void STDMETHODCALLTYPE OMGetRenderTargets(UINT NumViews, ID3D11RenderTargetView ** ppRenderTargetViews, ID3D11DepthStencilView ** ppDepthStencilView)
+    {
+        m_Counters.m_StateQueries++;
+        m_RenderTargets.get(0, NumViews, ppRenderTargetViews);
+        m_DepthStencilView.get(0, 1, ppDepthStencilView);
+    }
+    void STDMETHODCALLTYPE OMGetRenderTargetsAndUnorderedAccessViews(UINT NumRTVs, ID3D11RenderTargetView ** ppRenderTargetViews, ID3D11DepthStencilView ** ppDepthStencilView,
+                                                                     UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView ** ppUnorderedAccessViews)
+    {
+        OMGetRenderTargets(NumRTVs, ppRenderTargetViews, ppDepthStencilView);
+        clearSlots(ppUnorderedAccessViews, NumUAVs);
+    }
+    void STDMETHODCALLTYPE OMGetBlendState(ID3D11BlendState ** ppBlendState, FLOAT BlendFactor[4], UINT * pSampleMask)
+    {
+        m_Counters.m_StateQueries++;
+        m_BlendState.get(0, 1, ppBlendState);
+        for (int i = 0; BlendFactor != NULL && i < 4; i++) BlendFactor[i] = m_BlendFactor[i];
+        if (pSampleMask != NULL) *pSampleMask = m_SampleMask;
+    }
+    void STDMETHODCALLTYPE OMGetDepthStencilState(ID3D11DepthStencilState ** ppDepthStencilState, UINT * pStencilRef)
+    {
+        m_Counters.m_StateQueries++;
+        m_DepthStencilState.get(0, 1, ppDepthStencilState);
+        if (pStencilRef != NULL) *pStencilRef = m_StencilRef;
+    }
+
+    void STDMETHODCALLTYPE SOSetTargets(UINT NumBuffers, ID3D11Buffer * const * ppSOTargets, const UINT * pOffsets) { m_Counters.m_StateBinds++; }
+    void STDMETHODCALLTYPE SOGetTargets(UINT NumBuffers, ID3D11Buffer ** ppSOTargets) { m_Counters.m_StateQueries++; clearSlots(ppSOTargets, NumBuffers); }
+    void STDMETHODCALLTYPE SetPredication(ID3D11Predicate * pPredicate, BOOL PredicateValue) { m_Counters.m_StateBinds++; }
+    void STDMETHODCALLTYPE GetPredication(ID3D11Predicate ** ppPredicate, BOOL * pPredicateValue)
+    {
+        m_Counters.m_StateQueries++;
+        clearSlots(ppPredicate, 1);
+        if (pPredicateValue != NULL) *pPredicateValue = FALSE;
+    }
+
+    void STDMETHODCALLTYPE Draw(UINT VertexCount, UINT StartVertexLocation) { m_Counters.m_Draws++; }
+    void STDMETHODCALLTYPE DrawIndexed(UINT IndexCount, UINT StartIndexLocation, INT BaseVertexLocation) { m_Counters.m_Draws++; }
+    void STDMETHODCALLTYPE DrawInstanced(UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation) { m_Counters.m_Draws++; }
+    void STDMETHODCALLTYPE DrawIndexedInstanced(UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation) { m_Counters.m_Draws++; }
+    void STDMETHODCALLTYPE DrawAuto() { m_Counters.m_Draws++; }
+    void STDMETHODCALLTYPE DrawInstancedIndirect(ID3D11Buffer * pBufferForArgs, UINT AlignedByteOffsetForArgs) { m_Counters.m_Draws++; }
+    void STDMETHODCALLTYPE DrawIndexedInstancedIndirect(ID3D11Buffer * pBufferForArgs, UINT AlignedByteOffsetForArgs) { m_Counters.m_Draws++; }
+    void STDMETHODCALLTYPE Dispatch(UINT ThreadGroupCountX, UINT ThreadGroupCountY, UINT ThreadGroupCountZ) { m_Counters.m_Dispatches++; }
+    void STDMETHODCALLTYPE DispatchIndirect(ID3D11Buffer * pBufferForArgs, UINT AlignedByteOffsetForArgs) { m_Counters.m_Dispatches++; }
+
+    HRESULT STDMETHODCALLTYPE Map(ID3D11Resource * pResource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE * pMappedResource)
+    {
+        m_Counters.m_Maps++;
+
+        D3D11_RESOURCE_DIMENSION dimension;
+        pResource->GetType(&dimension);
+        if (pMappedResource == NULL)
+            return E_INVALIDARG;
+
+        // textures have no CPU copy
+        if (dimension != D3D11_RESOURCE_DIMENSION_BUFFER)
+            return E_NOTIMPL;
+
+        NullBuffer * pBuffer = static_cast<NullBuffer *>(static_cast<ID3D11Buffer *>(pResource));
+        pMappedResource->pData = &pBuffer->m_Data[0];
+        pMappedResource->RowPitch = pBuffer->m_Desc.ByteWidth;
+        pMappedResource->DepthPitch = pBuffer->m_Desc.ByteWidth;
+
+        if (MapType != D3D11_MAP_READ)
+            m_Counters.m_BytesUploaded += pBuffer->m_Desc.ByteWidth;
+
+        return S_OK;
+    }
+    void STDMETHODCALLTYPE Unmap(ID3D11Resource * pResource, UINT Subresource) { m_Counters.m_Unmaps++; }
+
+    void STDMETHODCALLTYPE UpdateSubresource(ID3D11Resource * pDstResource, UINT DstSubresource, const D3D11_BOX * pDstBox, const void * pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch)
+    {
+        m_Counters.m_Copies++;
+
+        D3D11_RESOURCE_DIMENSION dimension;
+        pDstResource->GetType(&dimension);
+
+        if (dimension == D3D11_RESOURCE_DIMENSION_BUFFER)
+        {
+            NullBuffer * pBuffer = static_cast<NullBuffer *>(static_cast<ID3D11Buffer *>(pDstResource));
+            m_Counters.m_BytesUploaded += pDstBox != NULL ? pDstBox->right - pDstBox->left : pBuffer->m_Desc.ByteWidth;
+        }
+        else if (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D)
+        {
+            NullTexture2D * pTexture = static_cast<NullTexture2D *>(static_cast<ID3D11Texture2D *>(pDstResource));
+            UINT mip = DstSubresource % MAX(pTexture->m_Desc.MipLevels, (UINT)1);
+            UINT rows = pDstBox != NULL ? pDstBox->bottom - pDstBox->top : MAX(pTexture->m_Desc.Height >> mip, (UINT)1);
+            m_Counters.m_BytesUploaded += (size_t)rows * SrcRowPitch;
+        }
+    }
+    void STDMETHODCALLTYPE CopySubresourceRegion(ID3D11Resource * pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource * pSrcResource, UINT SrcSubresource, const D3D11_BOX * pSrcBox) { m_Counters.m_Copies++; }
+    void STDMETHODCALLTYPE CopyResource(ID3D11Resource * pDstResource, ID3D11Resource * pSrcResource) { m_Counters.m_Copies++; }
+    void STDMETHODCALLTYPE CopyStructureCount(ID3D11Buffer * pDstBuffer, UINT DstAlignedByteOffset, ID3D11UnorderedAccessView * pSrcView) { m_Counters.m_Copies++; }
+    void STDMETHODCALLTYPE ResolveSubresource(ID3D11Resource * pDstResource, UINT DstSubresource, ID3D11Resource * pSrcResource, UINT SrcSubresource, DXGI_FORMAT Format) { m_Counters.m_Copies++; }
+    void STDMETHODCALLTYPE GenerateMips(ID3D11ShaderResourceView * pShaderResourceView) { m_Counters.m_Copies++; }
+
+    void STDMETHODCALLTYPE ClearRenderTargetView(ID3D11RenderTargetView * pRenderTargetView, const FLOAT ColorRGBA[4]) { m_Counters.m_Clears++; }
+    void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView * pUnorderedAccessView, const UINT Values[4]) { m_Counters.m_Clears++; }
+    void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView * pUnorderedAccessView, const FLOAT Values[4]) { m_Counters.m_Clears++; }
+    void STDMETHODCALLTYPE ClearDepthStencilView(ID3D11DepthStencilView * pDepthStencilView, UINT ClearFlags, FLOAT Depth, UINT8 Stencil) { m_Counters.m_Clears++; }
+    void STDMETHODCALLTYPE ClearState() { m_Counters.m_Clears++; }
+    void STDMETHODCALLTYPE ClearView(ID3D11View * pView, const FLOAT Color[4], const D3D11_RECT * pRect, UINT NumRects) { m_Counters.m_Clears++; }
+
+    void STDMETHODCALLTYPE CopySubresourceRegion1(ID3D11Resource * pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource * pSrcResource, UINT SrcSubresource, const D3D11_BOX * pSrcBox, UINT CopyFlags) { m_Counters.m_Copies++; }
+    void STDMETHODCALLTYPE UpdateSubresource1(ID3D11Resource * pDstResource, UINT DstSubresource, const D3D11_BOX * pDstBox, const void * pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch, UINT CopyFlags)
+    {
+        UpdateSubresource(pDstResource, DstSubresource, pDstBox, pSrcData, SrcRowPitch, SrcDepthPitch);
+    }
+    void STDMETHODCALLTYPE DiscardResource(ID3D11Resource * pResource) {}
+    void STDMETHODCALLTYPE DiscardView(ID3D11View * pResourceView) {}
+    void STDMETHODCALLTYPE DiscardView1(ID3D11View * pResourceView, const D3D11_RECT * pRects, UINT NumRects) {}
+    void STDMETHODCALLTYPE SwapDeviceContextState(ID3DDeviceContextState * pState, ID3DDeviceContextState ** ppPreviousState)
+    {
+        if (ppPreviousState != NULL) *ppPreviousState = NULL;
+    }
+
+    void STDMETHODCALLTYPE Begin(ID3D11Asynchronous * pAsync) {}
+    void STDMETHODCALLTYPE End(ID3D11Asynchronous * pAsync) {}
+    HRESULT STDMETHODCALLTYPE GetData(ID3D11Asynchronous * pAsync, void * pData, UINT DataSize, UINT GetDataFlags) { return E_INVALIDARG; }
+    void STDMETHODCALLTYPE SetResourceMinLOD(ID3D11Resource * pResource, FLOAT MinLOD) {}
+    FLOAT STDMETHODCALLTYPE GetResourceMinLOD(ID3D11Resource * pResource) { return 0.0f; }
+    void STDMETHODCALLTYPE ExecuteCommandList(ID3D11CommandList * pCommandList, BOOL RestoreContextState) {}
+    void STDMETHODCALLTYPE Flush() {}
+    D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE GetType() { return D3D11_DEVICE_CONTEXT_IMMEDIATE; }
+    UINT STDMETHODCALLTYPE GetContextFlags() { return 0; }
+    HRESULT STDMETHODCALLTYPE FinishCommandList(BOOL RestoreDeferredContextState, ID3D11CommandList ** ppCommandList) { return DXGI_ERROR_INVALID_CALL; }
+
+    AOFX_DeviceCounters                     m_Counters;
+    bool                                    m_ConstantBufferOffsetting;
+
+    NullStageState<ID3D11VertexShader>      m_VS;
+    NullStageState<ID3D11HullShader>        m_HS;
+    NullStageState<ID3D11DomainShader>      m_DS;
+    NullStageState<ID3D11GeometryShader>    m_GS;
+    NullStageState<ID3D11PixelShader>       m_PS;
+    NullStageState<ID3D11ComputeShader>     m_CS;
+    NullSlots<ID3D11UnorderedAccessView, D3D11_PS_CS_UAV_REGISTER_COUNT>        m_CSUnorderedAccessViews;
+
+    NullSlots<ID3D11InputLayout, 1>                                             m_InputLayout;
+    NullSlots<ID3D11Buffer, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT>          m_VertexBuffers;
+    UINT                                    m_VertexBufferStrides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    UINT                                    m_VertexBufferOffsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+    NullSlots<ID3D11Buffer, 1>              m_IndexBuffer;
+    DXGI_FORMAT                             m_IndexBufferFormat;
+    UINT                                    m_IndexBufferOffset;
+    D3D11_PRIMITIVE_TOPOLOGY                m_Topology;
+
+    NullSlots<ID3D11RasterizerState, 1>     m_RasterizerState;
+    D3D11_VIEWPORT                          m_Viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    UINT                                    m_ViewportCount;
+    D3D11_RECT                              m_ScissorRects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    UINT                                    m_ScissorRectCount;
+
+    NullSlots<ID3D11RenderTargetView, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT>   m_RenderTargets;
+    NullSlots<ID3D11DepthStencilView, 1>    m_DepthStencilView;
+    NullSlots<ID3D11BlendState, 1>          m_BlendState;
+    FLOAT                                   m_BlendFactor[4];
+    UINT                                    m_SampleMask;
+    NullSlots<ID3D11DepthStencilState, 1>   m_DepthStencilState;
+    UINT                                    m_StencilRef;
+};
+
+#undef AMD_NULL_CONTEXT_STAGE
+
+//-------------------------------------------------------------------------------------------------
+// Device creating CPU side objects only, it owns its immediate context
+//-------------------------------------------------------------------------------------------------
+class NullDevice : public ID3D11Device
+{
+public:
+    NullDevice() : m_RefCount(1) { m_pContext = new NullDeviceContext(this); }
+    virtual ~NullDevice() { m_pContext->Release(); }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void ** ppvObject)
+    {
+        if (ppvObject == NULL) return E_POINTER;
+
+        if (riid == __uuidof(ID3D11Device) || riid == __uuidof(IUnknown))
+        {
+            *ppvObject = static_cast<ID3D11Device *>(this);
+            AddRef();
+            return S_OK;
+        }
+
+        *ppvObject = NULL;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() { return ++m_RefCount; }
+
+    ULONG STDMETHODCALLTYPE Release()
+    {
+        ULONG refCount = --m_RefCount;
+        if (refCount == 0) delete this;
+        return refCount;
+    }
+
+    // a NULL output pointer only validates the call, like the runtime does
+    template <class Object, class Interface>
+    HRESULT create(Object * pObject, Interface ** ppInterface)
+    {
+        if (ppInterface == NULL)
+        {
+            delete pObject;
+            return S_FALSE;
+        }
+
+        // devices are free threaded, AOFX_PrewarmShaders creates shaders on a worker thread
+        std::lock_guard<std::mutex> lock(m_CreateLock);
+        m_pContext->m_Counters.m_ObjectsCreated++;
+        *ppInterface = pObject;
+
+        return S_OK;
+    }
+
+    template <class Interface>
+    HRESULT createShader(const void * pShaderBytecode, SIZE_T BytecodeLength, Interface ** ppShader)
+    {
+        if (pShaderBytecode == NULL || BytecodeLength == 0) return E_INVALIDARG;
+
+        return create(new NullDeviceChild<Interface>(this), ppShader);
+    }
+
+    template <class Interface>
+    HRESULT notImplemented(Interface ** ppInterface)
+    {
+        if (ppInterface != NULL) *ppInterface = NULL;
+        return E_NOTIMPL;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateBuffer(const D3D11_BUFFER_DESC * pDesc, const D3D11_SUBRESOURCE_DATA * pInitialData, ID3D11Buffer ** ppBuffer)
+    {
+        if (pDesc == NULL || pDesc->ByteWidth == 0) return E_INVALIDARG;
+
+        NullBuffer * pBuffer = new NullBuffer(this, *pDesc);
+        pBuffer->m_Data.resize(pDesc->ByteWidth);
+        if (pInitialData != NULL && pInitialData->pSysMem != NULL)
+            memcpy(&pBuffer->m_Data[0], pInitialData->pSysMem, pDesc->ByteWidth);
+
+        return create(pBuffer, ppBuffer);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateTexture2D(const D3D11_TEXTURE2D_DESC * pDesc, const D3D11_SUBRESOURCE_DATA * pInitialData, ID3D11Texture2D ** ppTexture2D)
+    {
+        if (pDesc == NULL || pDesc->Width == 0 || pDesc->Height == 0) return E_INVALIDARG;
+
+        return create(new NullTexture2D(this, *pDesc), ppTexture2D);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateShaderResourceView(ID3D11Resource * pResource, const D3D11_SHADER_RESOURCE_VIEW_DESC * pDesc, ID3D11ShaderResourceView ** ppSRView)
+    {
+        if (pResource == NULL) return E_INVALIDARG;
+        return create(new NullView<ID3D11ShaderResourceView, D3D11_SHADER_RESOURCE_VIEW_DESC>(this, pResource, pDesc), ppSRView);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateUnorderedAccessView(ID3D11Resource * pResource, const D3D11_UNORDERED_ACCESS_VIEW_DESC * pDesc, ID3D11UnorderedAccessView ** ppUAView)
+    {
+        if (pResource == NULL) return E_INVALIDARG;
+        return create(new NullView<ID3D11UnorderedAccessView, D3D11_UNORDERED_ACCESS_VIEW_DESC>(this, pResource, pDesc), ppUAView);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateRenderTargetView(ID3D11Resource * pResource, const D3D11_RENDER_TARGET_VIEW_DESC * pDesc, ID3D11RenderTargetView ** ppRTView)
+    {
+        if (pResource == NULL) return E_INVALIDARG;
+        return create(new NullView<ID3D11RenderTargetView, D3D11_RENDER_TARGET_VIEW_DESC>(this, pResource, pDesc), ppRTView);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateDepthStencilView(ID3D11Resource * pResource, const D3D11_DEPTH_STENCIL_VIEW_DESC * pDesc, ID3D11DepthStencilView ** ppDepthStencilView)
+    {
+        if (pResource == NULL) return E_INVALIDARG;
+        return create(new NullView<ID3D11DepthStencilView, D3D11_DEPTH_STENCIL_VIEW_DESC>(this, pResource, pDesc), ppDepthStencilView);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC * pInputElementDescs, UINT NumElements, const void * pShaderBytecodeWithInputSignature, SIZE_T BytecodeLength, ID3D11InputLayout ** ppInputLayout)
+    {
+        return createShader(pShaderBytecodeWithInputSignature, BytecodeLength, ppInputLayout);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateVertexShader(const void * pShaderBytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage * pClassLinkage, ID3D11VertexShader ** ppVertexShader) { return createShader(pShaderBytecode, BytecodeLength, ppVertexShader); }
+    HRESULT STDMETHODCALLTYPE CreateGeometryShader(const void * pShaderBytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage * pClassLinkage, ID3D11GeometryShader ** ppGeometryShader) { return createShader(pShaderBytecode, BytecodeLength, ppGeometryShader); }
+    HRESULT STDMETHODCALLTYPE CreatePixelShader(const void * pShaderBytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage * pClassLinkage, ID3D11PixelShader ** ppPixelShader) { return createShader(pShaderBytecode, BytecodeLength, ppPixelShader); }
+    HRESULT STDMETHODCALLTYPE CreateHullShader(const void * pShaderBytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage * pClassLinkage, ID3D11HullShader ** ppHullShader) { return createShader(pShaderBytecode, BytecodeLength, ppHullShader); }
+    HRESULT STDMETHODCALLTYPE CreateDomainShader(const void * pShaderBytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage * pClassLinkage, ID3D11DomainShader ** ppDomainShader) { return createShader(pShaderBytecode, BytecodeLength, ppDomainShader); }
+    HRESULT STDMETHODCALLTYPE CreateComputeShader(const void * pShaderBytecode, SIZE_T BytecodeLength, ID3D11ClassLinkage * pClassLinkage, ID3D11ComputeShader ** ppComputeShader) { return createShader(pShaderBytecode, BytecodeLength, ppComputeShader); }
+
+    HRESULT STDMETHODCALLTYPE CreateBlendState(const D3D11_BLEND_DESC * pBlendStateDesc, ID3D11BlendState ** ppBlendState)
+    {
+        if (pBlendStateDesc == NULL) return E_INVALIDARG;
+        return create(new NullState<ID3D11BlendState, D3D11_BLEND_DESC>(this, *pBlendStateDesc), ppBlendState);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC * pDepthStencilDesc, ID3D11DepthStencilState ** ppDepthStencilState)
+    {
+        if (pDepthStencilDesc == NULL) return E_INVALIDARG;
+        return create(new NullState<ID3D11DepthStencilState, D3D11_DEPTH_STENCIL_DESC>(this, *pDepthStencilDesc), ppDepthStencilState);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateRasterizerState(const D3D11_RASTERIZER_DESC * pRasterizerDesc, ID3D11RasterizerState ** ppRasterizerState)
+    {
+        if (pRasterizerDesc == NULL) return E_INVALIDARG;
+        return create(new NullState<ID3D11RasterizerState, D3D11_RASTERIZER_DESC>(this, *pRasterizerDesc), ppRasterizerState);
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateSamplerState(const D3D11_SAMPLER_DESC * pSamplerDesc, ID3D11SamplerState ** ppSamplerState)
+    {
+        if (pSamplerDesc == NULL) return E_INVALIDARG;
+        return create(new NullState<ID3D11SamplerState, D3D11_SAMPLER_DESC>(this, *pSamplerDesc), ppSamplerState);
+    }
+
+    // not used by AOFX
+    HRESULT STDMETHODCALLTYPE CreateTexture1D(const D3D11_TEXTURE1D_DESC * pDesc, const D3D11_SUBRESOURCE_DATA * pInitialData, ID3D11Texture1D ** ppTexture1D) { return notImplemented(ppTexture1D); }
+    HRESULT STDMETHODCALLTYPE CreateTexture3D(const D3D11_TEXTURE3D_DESC * pDesc, const D3D11_SUBRESOURCE_DATA * pInitialData, ID3D11Texture3D ** ppTexture3D) { return notImplemented(ppTexture3D); }
+    HRESULT STDMETHODCALLTYPE CreateGeometryShaderWithStreamOutput(const void * pShaderBytecode, SIZE_T BytecodeLength, const D3D11_SO_DECLARATION_ENTRY * pSODeclaration, UINT NumEntries,
+                                                                   const UINT * pBufferStrides, UINT NumStrides, UINT RasterizedStream, ID3D11ClassLinkage * pClassLinkage, ID3D11GeometryShader ** ppGeometryShader) { return notImplemented(ppGeometryShader); }
+    HRESULT STDMETHODCALLTYPE CreateClassLinkage(ID3D11ClassLinkage ** ppLinkage) { return notImplemented(ppLinkage); }
+    HRESULT STDMETHODCALLTYPE CreateQuery(const D3D11_QUERY_DESC * pQueryDesc, ID3D11Query ** ppQuery) { return notImplemented(ppQuery); }
+    HRESULT STDMETHODCALLTYPE CreatePredicate(const D3D11_QUERY_DESC * pPredicateDesc, ID3D11Predicate ** ppPredicate) { return notImplemented(ppPredicate); }
+    HRESULT STDMETHODCALLTYPE CreateCounter(const D3D11_COUNTER_DESC * pCounterDesc, ID3D11Counter ** ppCounter) { return notImplemented(ppCounter); }
+    HRESULT STDMETHODCALLTYPE CreateDeferredContext(UINT ContextFlags, ID3D11DeviceContext ** ppDeferredContext) { return notImplemented(ppDeferredContext); }
+    HRESULT STDMETHODCALLTYPE OpenSharedResource(HANDLE hResource, REFIID ReturnedInterface, void ** ppResource) { return notImplemented(ppResource); }
+
+    HRESULT STDMETHODCALLTYPE CheckFormatSupport(DXGI_FORMAT Format, UINT * pFormatSupport) { *pFormatSupport = 0xFFFFFFFF; return S_OK; }
+    HRESULT STDMETHODCALLTYPE CheckMultisampleQualityLevels(DXGI_FORMAT Format, UINT SampleCount, UINT * pNumQualityLevels) { *pNumQualityLevels = SampleCount == 1 ? 1 : 0; return S_OK; }
+    void STDMETHODCALLTYPE CheckCounterInfo(D3D11_COUNTER_INFO * pCounterInfo) { memset(pCounterInfo, 0, sizeof(*pCounterInfo)); }
+    HRESULT STDMETHODCALLTYPE CheckCounter(const D3D11_COUNTER_DESC * pDesc, D3D11_COUNTER_TYPE * pType, UINT * pActiveCounters, LPSTR szName, UINT * pNameLength,
+                                           LPSTR szUnits, UINT * pUnitsLength, LPSTR szDescription, UINT * pDescriptionLength) { return E_NOTIMPL; }
+    HRESULT STDMETHODCALLTYPE CheckFeatureSupport(D3D11_FEATURE Feature, void * pFeatureSupportData, UINT FeatureSupportDataSize)
+    {
+        // every optional feature is reported as unsupported, except for the constant buffer offsetting of the context,
+        // without it the options query fails like it does on runtimes before D3D11.1
+        memset(pFeatureSupportData, 0, FeatureSupportDataSize);
+        if (Feature == D3D11_FEATURE_D3D11_OPTIONS && FeatureSupportDataSize >= sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS))
+        {
+            if (!m_pContext->m_ConstantBufferOffsetting) return E_INVALIDARG;
+            ((D3D11_FEATURE_DATA_D3D11_OPTIONS *)pFeatureSupportData)->ConstantBufferOffsetting = TRUE;
+        }
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT * pDataSize, void * pData)
+    {
+        if (pDataSize != NULL) *pDataSize = 0;
+        return DXGI_ERROR_NOT_FOUND;
+    }
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT DataSize, const void * pData) { return S_OK; }
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown * pData) { return S_OK; }
+
+    D3D_FEATURE_LEVEL STDMETHODCALLTYPE GetFeatureLevel() { return D3D_FEATURE_LEVEL_11_0; }
+    UINT STDMETHODCALLTYPE GetCreationFlags() { return 0; }
+    HRESULT STDMETHODCALLTYPE GetDeviceRemovedReason() { return S_OK; }
+    HRESULT STDMETHODCALLTYPE SetExceptionMode(UINT RaiseFlags) { return S_OK; }
+    UINT STDMETHODCALLTYPE GetExceptionMode() { return 0; }
+
+    void STDMETHODCALLTYPE GetImmediateContext(ID3D11DeviceContext ** ppImmediateContext)
+    {
+        *ppImmediateContext = m_pContext;
+        m_pContext->AddRef();
+    }
+
+    std::atomic<ULONG>                      m_RefCount;
+    std::mutex                              m_CreateLock;
+    NullDeviceContext *                     m_pContext;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Objects are released on any thread, e.g. a duplicate shader of AOFX_PrewarmShaders,
+// the immediate context is not a created object
+//-------------------------------------------------------------------------------------------------
+static void countReleased(ID3D11Device * pDevice, IUnknown * pObject)
+{
+    NullDevice * pNullDevice = static_cast<NullDevice *>(pDevice);
+    if (pObject == static_cast<ID3D11DeviceContext1 *>(pNullDevice->m_pContext)) return;
+
+    std::lock_guard<std::mutex> lock(pNullDevice->m_CreateLock);
+    pNullDevice->m_pContext->m_Counters.m_ObjectsReleased++;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static NullDeviceContext * getNullDeviceContext(ID3D11DeviceContext * pDeviceContext)
+{
+    void * pNullDeviceContext = NULL;
+
+    if (pDeviceContext == NULL || FAILED(pDeviceContext->QueryInterface(s_NullDeviceContextGuid, &pNullDeviceContext)))
+        return NULL;
+
+    // the context stays alive through the caller's reference
+    NullDeviceContext * pResult = static_cast<NullDeviceContext *>(static_cast<ID3D11DeviceContext1 *>(pNullDeviceContext));
+    pResult->Release();
+
+    return pResult;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_CreateNullDevice(ID3D11Device ** ppDevice, ID3D11DeviceContext ** ppDeviceContext)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (ppDevice == NULL || ppDeviceContext == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    NullDevice * pDevice = new NullDevice();
+
+    *ppDevice = pDevice;
+    pDevice->GetImmediateContext(ppDeviceContext);
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_GetDeviceCounters(ID3D11DeviceContext * pDeviceContext, AOFX_DeviceCounters * pCounters)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (pCounters == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_POINTER;
+    }
+
+    NullDeviceContext * pNullDeviceContext = getNullDeviceContext(pDeviceContext);
+    if (pNullDeviceContext == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT;
+    }
+
+    *pCounters = pNullDeviceContext->m_Counters;
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AMD_AOFX_DLL_API AOFX_ResetDeviceCounters(ID3D11DeviceContext * pDeviceContext)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    NullDeviceContext * pNullDeviceContext = getNullDeviceContext(pDeviceContext);
+    if (pNullDeviceContext == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT;
+    }
+
+    pNullDeviceContext->m_Counters = AOFX_DeviceCounters();
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Lets the tests run the constant buffer path of devices without D3D11.1 offsetting,
+// takes effect at the next AOFX_Initialize
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_SetNullDeviceConstantBufferOffsetting(ID3D11DeviceContext * pDeviceContext, bool supported)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    NullDeviceContext * pNullDeviceContext = getNullDeviceContext(pDeviceContext);
+    if (pNullDeviceContext == NULL)
+    {
+        return AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT;
+    }
+
+    pNullDeviceContext->m_ConstantBufferOffsetting = supported;
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+}
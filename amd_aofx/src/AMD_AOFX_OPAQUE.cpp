@@ -24,6 +24,8 @@
 #include <assert.h>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <chrono>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -47,20 +49,169 @@ namespace AMD
 {
 const sint AOFX_OpaqueDesc::m_DeinterleaveSize[AOFX_LAYER_PROCESS_COUNT] = { 1, 2, 4, 8 };
 
+//-------------------------------------------------------------------------------------------------
+// Bytes per texel of the formats AOFX allocates its surfaces with
+//-------------------------------------------------------------------------------------------------
+static size_t formatSize(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_R8_UNORM:           return 1;
+    case DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT_R16_UNORM:          return 2;
+    case DXGI_FORMAT_R32_FLOAT:          return 4;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT: return 8;
+    case DXGI_FORMAT_R32G32B32A32_FLOAT: return 16;
+    default:                             return 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static size_t surfaceSize(const AMD::Texture2D & surface, DXGI_FORMAT format)
+{
+    return (size_t)surface._width * surface._height * surface._array * MAX(surface._sample, 1u) * formatSize(format);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Layers with different blur radiuses are blurred one by one before they are blended,
+// otherwise the blended result is blurred once with blurRadiusResult
+//-------------------------------------------------------------------------------------------------
+static bool separateBlur(const AOFX_Desc & desc, int & blurRadiusResult)
+{
+    bool separate = false;
+    bool active[AOFX_Desc::m_MultiResLayerCount];
+    int  blurRadius[AOFX_Desc::m_MultiResLayerCount];
+    const int layerCount = AOFX_Desc::m_MultiResLayerCount;
+
+    blurRadiusResult = AOFX_BILATERAL_BLUR_RADIUS_NONE;
+    for (int i = 0; i < layerCount; ++i)
+    {
+        active[i] = desc.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE;
+        blurRadius[i] = active[i] ? desc.m_BilateralBlurRadius[i] : AOFX_BILATERAL_BLUR_RADIUS_NONE;
+        blurRadiusResult = MAX(blurRadiusResult, blurRadius[i]);
+    }
+    for (int i = 0; i < layerCount; ++i)
+    {
+        separate = separate || (active[i] && active[(i + 1) % layerCount] && blurRadius[i] != blurRadius[(i + 1) % layerCount]);
+    }
+
+    return separate;
+}
+
+//-------------------------------------------------------------------------------------------------
+// With AOFX_Desc::m_MaxInputSize surfaces are allocated once at that size and every pass renders
+// into their top left m_InputSize part, otherwise they are allocated at m_InputSize
+//-------------------------------------------------------------------------------------------------
+static bool viewportScaled(const AOFX_Desc & desc)
+{
+    return desc.m_MaxInputSize.x != 0 || desc.m_MaxInputSize.y != 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Without the viewport permutations the shaders address whole surfaces, so m_MaxInputSize cannot be rendered
+//-------------------------------------------------------------------------------------------------
+static bool viewportAvailable(const AOFX_Desc & desc)
+{
+    return AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED || !viewportScaled(desc);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Without the GTAO permutations an active layer requesting AOFX_KERNEL_TYPE_GTAO cannot be rendered
+//-------------------------------------------------------------------------------------------------
+static bool kernelAvailable(const AOFX_LAYER_PROCESS * pLayerProcess, const AOFX_KERNEL_TYPE * pKernelType)
+{
+    for (int i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        if (pLayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+        if (!AOFX_OpaqueDesc::kernelSupported(pKernelType[i])) return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Resolution of layer 'target' for the current m_InputSize, the layer surfaces may be larger
+//-------------------------------------------------------------------------------------------------
+static AOFX_OpaqueDesc::uint2 scaledSize(const AOFX_Desc & desc, uint target)
+{
+    AOFX_OpaqueDesc::uint2 size;
+    size.x = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[target]), (uint)1);
+    size.y = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[target]), (uint)1);
+    return size;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Without the depth aware dilate permutations a downscaled layer is upsampled to full resolution
+// by psUpsampleAO before it is blurred and dilated, instead of being point sampled by the dilate pass
+//-------------------------------------------------------------------------------------------------
+static bool upsampledLayer(const AOFX_Desc & desc, uint target)
+{
+    return !AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED &&
+           desc.m_LayerProcess[target] != AOFX_LAYER_PROCESS_NONE && desc.m_MultiResLayerScale[target] < 1.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Layer 'target' is blurred and dilated below full resolution, its blur needs an intermediate of its own size
+//-------------------------------------------------------------------------------------------------
+static bool downscaledLayer(const AOFX_Desc & desc, uint target)
+{
+    return desc.m_LayerProcess[target] != AOFX_LAYER_PROCESS_NONE && desc.m_MultiResLayerScale[target] < 1.0f &&
+           !upsampledLayer(desc, target);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Resolution layer 'target' is blurred and dilated at
+//-------------------------------------------------------------------------------------------------
+static AOFX_OpaqueDesc::uint2 layerSize(const AOFX_Desc & desc, uint target)
+{
+    if (!upsampledLayer(desc, target))
+        return scaledSize(desc, target);
+
+    AOFX_OpaqueDesc::uint2 size;
+    size.x = desc.m_InputSize.x;
+    size.y = desc.m_InputSize.y;
+    return size;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Texture coordinate scale (xy) and center of the last texel in the viewport (zw) of a surface
+// the viewport covers activeSize texels of. Passes address every surface in viewport relative
+// coordinates, so resolution changes within m_MaxInputSize only change these constants
+//-------------------------------------------------------------------------------------------------
+static AOFX_OpaqueDesc::float4 surfaceUV(const AOFX_Desc & desc, AOFX_OpaqueDesc::uint2 activeSize, AOFX_OpaqueDesc::uint2 surfaceSize)
+{
+    if (!viewportScaled(desc))
+        surfaceSize = activeSize;
+
+    AOFX_OpaqueDesc::float4 uv;
+    uv.x = (float)activeSize.x / surfaceSize.x;
+    uv.y = (float)activeSize.y / surfaceSize.y;
+    uv.z = (activeSize.x - 0.5f) / surfaceSize.x;
+    uv.w = (activeSize.y - 0.5f) / surfaceSize.y;
+    return uv;
+}
+
 //-------------------------------------------------------------------------------------------------
 // 
 //-------------------------------------------------------------------------------------------------
 AOFX_OpaqueDesc::AOFX_OpaqueDesc(const AOFX_Desc & desc)
     : m_tbSamplePatterns(NULL)
     , m_tbSamplePatternsSRV(NULL)
+    , m_psUpsample(NULL)
     , m_psOutput(NULL)
-    , m_psUpscale(NULL)
     , m_vsFullscreen(NULL)
     , m_cbSamplePatterns(NULL)
     , m_cbBilateralDilate(NULL)
-    , m_cbDilateData(NULL)
+    , m_cbConstantRing(NULL)
     , m_ssPointClamp(NULL)
     , m_ssLinearClamp(NULL)
+    , m_pDevice(NULL)
+    , m_ShaderCreation(AOFX_SHADER_CREATION_ALL)
+    , m_ShaderConfigReadyValid(false)
+    , m_ShaderThreadRunning(false)
+    , m_ShaderThreadCancel(false)
     , m_FormatDepth(DXGI_FORMAT_R16_FLOAT)          // DXGI_FORMAT_R32_FLOAT or DXGI_FORMAT_R16_UNORM
     , m_FormatAO(DXGI_FORMAT_R8_UNORM)           // DXGI_FORMAT_R16_FLOAT or DXGI_FORMAT_R8_UNORM
     , m_FormatDepthNormal(DXGI_FORMAT_R16G16B16A16_FLOAT) // DXGI_FORMAT_R16G16B16A16_FLOAT
@@ -77,28 +228,22 @@ AOFX_OpaqueDesc::AOFX_OpaqueDesc(const AOFX_Desc & desc)
         m_LayerProcess[i] = AOFX_LAYER_PROCESS_NONE;
     }
 
-    for (int i = 0; i < 2; i++)
-        for (int j = 0; j < 2; j++)
-            for (int k = 0; k < 2; k++)
-                m_psDilate[i][j][k] = NULL;
+    for (int u = 0; u < 2; u++)
+        for (int i = 0; i < AOFX_DILATE_PERMUTATION_COUNT; i++)
+            m_psDilate[u][i] = NULL;
+
+    for (int i = 0; i < AOFX_PROCESS_INPUT_PERMUTATION_COUNT; i++)
+    {
+        m_csProcessInput[i] = NULL;
+        m_psProcessInput[i] = NULL;
+    }
 
-    for (int layer = 0; layer < AOFX_LAYER_PROCESS_COUNT; layer++)
+    for (int kernel = 0; kernel < AOFX_KERNEL_TYPE_COUNT; kernel++)
     {
-        for (int normal = 0; normal < AOFX_NORMAL_OPTION_COUNT; normal++)
+        for (int i = 0; i < AOFX_AO_PERMUTATION_COUNT; i++)
         {
-            for (int msaa = 0; msaa < AOFX_MSAA_LEVEL_COUNT; msaa++)
-            {
-                m_csProcessInput[layer][normal][msaa] = NULL;
-                m_psProcessInput[layer][normal][msaa] = NULL;
-            }
-            for (int tap = 0; tap < AOFX_TAP_TYPE_COUNT; tap++)
-            {
-                for (int sample = 0; sample < AOFX_SAMPLE_COUNT_COUNT; sample++)
-                {
-                    m_psAmbientOcclusion[layer][normal][tap][sample] = NULL;
-                    m_csAmbientOcclusion[layer][normal][tap][sample] = NULL;
-                }
-            }
+            m_psAmbientOcclusion[kernel][i] = NULL;
+            m_csAmbientOcclusion[kernel][i] = NULL;
         }
     }
 
@@ -111,12 +256,14 @@ AOFX_OpaqueDesc::AOFX_OpaqueDesc(const AOFX_Desc & desc)
         m_csBilateralBlurV[radius] = NULL;
     }
 
-    for (int i = 0; i < m_MultiResLayerCount; i++)
-    {
-        m_cbAOData[i] = NULL;
-        m_cbAOInputData[i] = NULL;
-        m_cbBilateralBlurData[i] = NULL;
-    }
+    for (int i = 0; i < CONSTANT_BLOCK_COUNT; i++)
+        m_cbConstantBlocks[i] = NULL;
+
+    memset(m_Constants, 0, sizeof(m_Constants));
+    m_ConstantBlockCount = 0;
+    m_ConstantsUsed = m_ConstantsChanged = m_ConstantsValid = 0;
+
+    memset(&m_StageCounters, 0, sizeof(m_StageCounters));
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -129,20 +276,23 @@ AOFX_OpaqueDesc::~AOFX_OpaqueDesc()
     release();
 }
 
+//-------------------------------------------------------------------------------------------------
+// Same sequence as the MSVC CRT srand()/rand() the patterns were designed with, but the state is
+// local: the global generator belongs to the application and is not thread safe on every CRT
+//-------------------------------------------------------------------------------------------------
+static inline int samplePatternRand(uint & state)
+{
+    state = state * 214013u + 2531011u;
+    return (int)((state >> 16) & 0x7FFF);
+}
+
 //-------------------------------------------------------------------------------------------------
 // 
 //-------------------------------------------------------------------------------------------------
-AOFX_RETURN_CODE     AOFX_OpaqueDesc::cbInitialize(const AOFX_Desc & desc)
+void AOFX_OpaqueDesc::generateSamplePatterns(CB_SAMPLEPATTERN_ROT_SINT4 & cbSamplePattern, CB_SAMPLEPATTERN_ROT_SBYTE2 & t1dSamplePattern)
 {
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
-    AOFX_RETURN_CODE              result = AOFX_RETURN_CODE_SUCCESS;
-    CD3D11_DEFAULT                d3d11Default;
-    CD3D11_BUFFER_DESC            b1dDesc;
-    D3D11_SUBRESOURCE_DATA        subresourceData;
-    CB_SAMPLEPATTERN_ROT_SINT4    cbSamplePattern;
-    CB_SAMPLEPATTERN_ROT_SBYTE2   t1dSamplePattern;
-
     sint4  sample_i32[32];
     sbyte2 sample_i8[32];
 
@@ -151,7 +301,7 @@ AOFX_RETURN_CODE     AOFX_OpaqueDesc::cbInitialize(const AOFX_Desc & desc)
     for (int j = 0; j < CB_SAMPLEPATTERN_ROT_SINT4::numRotations; j++)
     {
         float seed = noise(*(uint*)&fnoise);
-        srand(*(unsigned int *)&seed);
+        uint state = *(uint *)&seed;
         fnoise = seed;
 
         memset(sample_i32, -1, sizeof(sample_i32));
@@ -174,8 +324,8 @@ AOFX_RETURN_CODE     AOFX_OpaqueDesc::cbInitialize(const AOFX_Desc & desc)
             int base_x = i % 4;
             int base_y = i / 4 - 4;
 
-            float x = ((float)(rand() & 0xFFFF)) / 0xFFFF * 4.0f;
-            float y = (((float)(rand() & 0xFFFF)) / 0xFFFF) * 4.0f;
+            float x = ((float)(samplePatternRand(state) & 0xFFFF)) / 0xFFFF * 4.0f;
+            float y = (((float)(samplePatternRand(state) & 0xFFFF)) / 0xFFFF) * 4.0f;
 
             sample_i32[address_map[i]].x = (int)(base_x * 4 + x);
             sample_i32[address_map[i]].y = (int)(base_y * 4 + y);
@@ -187,6 +337,54 @@ AOFX_RETURN_CODE     AOFX_OpaqueDesc::cbInitialize(const AOFX_Desc & desc)
         memcpy(cbSamplePattern.SP[j], sample_i32, sizeof(sample_i32));
         memcpy(t1dSamplePattern.SP[j], sample_i8, sizeof(sample_i8));
     }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Same conditions resize() uses to reallocate layer surfaces
+//-------------------------------------------------------------------------------------------------
+bool AOFX_OpaqueDesc::requiresResize(const AOFX_QualityLevel & level, const AOFX_Desc & desc)
+{
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        if (level.m_LayerProcess[i] != desc.m_LayerProcess[i])
+            return true;
+        if (level.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE &&
+            level.m_MultiResLayerScale[i] != desc.m_MultiResLayerScale[i])
+            return true;
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::applyQualityLevel(const AOFX_QualityLevel & level, AOFX_Desc & desc)
+{
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        desc.m_LayerProcess[i] = level.m_LayerProcess[i];
+        desc.m_MultiResLayerScale[i] = level.m_MultiResLayerScale[i];
+        desc.m_SampleCount[i] = level.m_SampleCount[i];
+        desc.m_BilateralBlurRadius[i] = level.m_BilateralBlurRadius[i];
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE     AOFX_OpaqueDesc::cbInitialize(const AOFX_Desc & desc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    AOFX_RETURN_CODE              result = AOFX_RETURN_CODE_SUCCESS;
+    CD3D11_DEFAULT                d3d11Default;
+    CD3D11_BUFFER_DESC            b1dDesc;
+    D3D11_SUBRESOURCE_DATA        subresourceData;
+    CB_SAMPLEPATTERN_ROT_SINT4    cbSamplePattern;
+    CB_SAMPLEPATTERN_ROT_SBYTE2   t1dSamplePattern;
+
+    generateSamplePatterns(cbSamplePattern, t1dSamplePattern);
 
     memset(&subresourceData, 0, sizeof(subresourceData));
 
@@ -221,18 +419,6 @@ AOFX_RETURN_CODE     AOFX_OpaqueDesc::cbInitialize(const AOFX_Desc & desc)
     result = (desc.m_pDevice->CreateShaderResourceView(m_tbSamplePatterns, &srvDesc, &m_tbSamplePatternsSRV) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
     if (result != AOFX_RETURN_CODE_SUCCESS) return result;
 
-    // AO
-    b1dDesc.Usage = D3D11_USAGE_DYNAMIC;
-    b1dDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    b1dDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-    b1dDesc.MiscFlags = 0;
-    b1dDesc.ByteWidth = sizeof(AO_Data);
-    for (int i = 0; i < m_MultiResLayerCount; i++)
-    {
-        result = (desc.m_pDevice->CreateBuffer(&b1dDesc, NULL, &m_cbAOData[i]) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
-        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
-    }
-
     // Bilateral Dilate
     b1dDesc.Usage = D3D11_USAGE_DYNAMIC;
     b1dDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
@@ -242,28 +428,32 @@ AOFX_RETURN_CODE     AOFX_OpaqueDesc::cbInitialize(const AOFX_Desc & desc)
     result = (desc.m_pDevice->CreateBuffer(&b1dDesc, NULL, &m_cbBilateralDilate) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
     if (result != AOFX_RETURN_CODE_SUCCESS) return result;
 
-    // Dilate
-    b1dDesc.Usage = D3D11_USAGE_DYNAMIC;
-    b1dDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    b1dDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-    b1dDesc.MiscFlags = 0;
-    b1dDesc.ByteWidth = sizeof(S_DILATE_DATA);
-    result = (desc.m_pDevice->CreateBuffer(&b1dDesc, NULL, &m_cbDilateData) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
-    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+    // Per pass constants, runtimes before D3D11.1 fail the options query and get one buffer per block
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+    memset(&options, 0, sizeof(options));
+    if (desc.m_pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)) != S_OK)
+        options.ConstantBufferOffsetting = FALSE;
 
-    // Deinterleave & Scale pre-processing parameters
     b1dDesc.Usage = D3D11_USAGE_DYNAMIC;
     b1dDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
     b1dDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
     b1dDesc.MiscFlags = 0;
-    b1dDesc.ByteWidth = sizeof(AO_InputData);
-    for (int i = 0; i < m_MultiResLayerCount; i++)
+    if (options.ConstantBufferOffsetting)
     {
-        result = (desc.m_pDevice->CreateBuffer(&b1dDesc, NULL, &m_cbAOInputData[i]) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
-        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
-        result = (desc.m_pDevice->CreateBuffer(&b1dDesc, NULL, &m_cbBilateralBlurData[i]) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
+        b1dDesc.ByteWidth = CONSTANT_BLOCK_COUNT * m_ConstantBlockSize;
+        result = (desc.m_pDevice->CreateBuffer(&b1dDesc, NULL, &m_cbConstantRing) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
         if (result != AOFX_RETURN_CODE_SUCCESS) return result;
     }
+    else
+    {
+        b1dDesc.ByteWidth = m_ConstantBlockSize;
+        for (int i = 0; i < CONSTANT_BLOCK_COUNT; i++)
+        {
+            result = (desc.m_pDevice->CreateBuffer(&b1dDesc, NULL, &m_cbConstantBlocks[i]) == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED);
+            if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        }
+    }
+    m_ConstantsValid = 0;
 
     // Point Clamp
     CD3D11_SAMPLER_DESC samplerDesc(d3d11Default);
@@ -308,10 +498,12 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::resize(const AOFX_Desc & desc)
 
     AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
 
-    uint width = (uint)desc.m_InputSize.x;
-    uint height = (uint)desc.m_InputSize.y;
+    // with m_MaxInputSize nothing is reallocated for m_InputSize changes that fit
+    uint width = viewportScaled(desc) ? desc.m_MaxInputSize.x : desc.m_InputSize.x;
+    uint height = viewportScaled(desc) ? desc.m_MaxInputSize.y : desc.m_InputSize.y;
 
-    if (width == 0 || height == 0)
+    if (width == 0 || height == 0 || !viewportAvailable(desc) ||
+        desc.m_InputSize.x > width || desc.m_InputSize.y > height)
     {
         return AOFX_RETURN_CODE_INVALID_ARGUMENT;
     }
@@ -327,6 +519,13 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::resize(const AOFX_Desc & desc)
             AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED;
         if (result != AOFX_RETURN_CODE_SUCCESS) return result;
 
+        m_BlurAO.Release();
+
+        result = m_BlurAO.CreateSurface(desc.m_pDevice, width, height, 1, 1, 1,
+                                        m_FormatAO, m_FormatAO, m_FormatAO, DXGI_FORMAT_UNKNOWN, m_FormatAO, DXGI_FORMAT_UNKNOWN, D3D11_USAGE_DEFAULT, false, 0, NULL, NULL, 0) == S_OK ?
+            AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+
         m_Resolution.x = width;
         m_Resolution.y = height;
     }
@@ -335,26 +534,13 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::resize(const AOFX_Desc & desc)
     {
         if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) // if the layer is currently disabled
         {
-            m_AO[i].Release();
             m_ResultAO[i].Release();
             m_InputAO[i].Release();
-
-            memset(&m_aoData[i], 0, sizeof(m_aoData[i]));
-            memset(&m_aoInputData[i], 0, sizeof(m_aoInputData[i]));
-            memset(&m_aoBilateralBlurData[i], 0, sizeof(m_aoBilateralBlurData[i]));
+            m_UpsampleAO[i].Release();
+            m_BlurLayerAO[i].Release();
         }
         else
         {
-            if (m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE || // if the layer was just enabled
-                resolutionChanged)
-            {
-                m_AO[i].Release();
-                result = m_AO[i].CreateSurface(desc.m_pDevice, width, height, 1, 1, 1,
-                                               m_FormatAO, m_FormatAO, m_FormatAO, DXGI_FORMAT_UNKNOWN, m_FormatAO, DXGI_FORMAT_UNKNOWN, D3D11_USAGE_DEFAULT, false, 0, NULL, NULL, 0) == S_OK ?
-                    AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-                if (result != AOFX_RETURN_CODE_SUCCESS) return result;
-            }
-
             DXGI_FORMAT format;
             switch (desc.m_NormalOption[i])
             {
@@ -366,8 +552,8 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::resize(const AOFX_Desc & desc)
             bool modeChanged = (desc.m_LayerProcess[i] != m_LayerProcess[i]);
             bool normalChanged = (desc.m_NormalOption[i] != m_NormalOption[i]);
 
-            uint scaledWidth = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[i]), (uint)1);
-            uint scaledHeight = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[i]), (uint)1);
+            uint scaledWidth = MAX((uint)(width * desc.m_MultiResLayerScale[i]), (uint)1);
+            uint scaledHeight = MAX((uint)(height * desc.m_MultiResLayerScale[i]), (uint)1);
             bool scaleChanged = (m_ScaledResolution[i].x != scaledWidth && m_ScaledResolution[i].y != scaledHeight);
 
             bool resizeResources = modeChanged || resolutionChanged || normalChanged || scaleChanged;
@@ -396,9 +582,33 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::resize(const AOFX_Desc & desc)
                     AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED;
                 if (result != AOFX_RETURN_CODE_SUCCESS) return result;
 
+                m_BlurLayerAO[i].Release();
+                if (downscaledLayer(desc, i))
+                {
+                    result = m_BlurLayerAO[i].CreateSurface(desc.m_pDevice,
+                                                            scaledWidth, scaledHeight, 1, 1, 1,
+                                                            m_FormatAO, m_FormatAO, m_FormatAO,
+                                                            DXGI_FORMAT_UNKNOWN, m_FormatAO, DXGI_FORMAT_UNKNOWN, D3D11_USAGE_DEFAULT, false, 0, NULL, NULL, 0) == S_OK ?
+                        AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+                    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+                }
+
                 m_ScaledResolution[i].x = scaledWidth;
                 m_ScaledResolution[i].y = scaledHeight;
             }
+
+            if (!upsampledLayer(desc, i))
+            {
+                m_UpsampleAO[i].Release();
+            }
+            else if (resolutionChanged || m_UpsampleAO[i]._width == 0)
+            {
+                m_UpsampleAO[i].Release();
+                result = m_UpsampleAO[i].CreateSurface(desc.m_pDevice, width, height, 1, 1, 1,
+                                                       m_FormatAO, m_FormatAO, m_FormatAO, DXGI_FORMAT_UNKNOWN, m_FormatAO, DXGI_FORMAT_UNKNOWN, D3D11_USAGE_DEFAULT, false, 0, NULL, NULL, 0) == S_OK ?
+                    AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+                if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+            }
         }
 
         m_LayerProcess[i] = desc.m_LayerProcess[i];
@@ -425,166 +635,578 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::resize(const AOFX_Desc & desc)
 //-------------------------------------------------------------------------------------------------
 // 
 //-------------------------------------------------------------------------------------------------
-AOFX_RETURN_CODE AOFX_OpaqueDesc::createShaders(const AOFX_Desc & desc)
+static HRESULT createShaderObject(ID3D11Device * pDevice, const void * pBytecode, size_t size, ID3D11PixelShader ** ppShader)
 {
-    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
-
-    releaseShaders();
-
-    AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
-    HRESULT hr = S_OK;
+    return pDevice->CreatePixelShader(pBytecode, size, NULL, ppShader);
+}
 
-    hr = desc.m_pDevice->CreatePixelShader(PS_OUTPUT_Data, sizeof(PS_OUTPUT_Data), NULL, &m_psOutput);
-    if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-    hr = desc.m_pDevice->CreatePixelShader(PS_UPSAMPLE_Data, sizeof(PS_UPSAMPLE_Data), NULL, &m_psUpscale);
-    if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+static HRESULT createShaderObject(ID3D11Device * pDevice, const void * pBytecode, size_t size, ID3D11ComputeShader ** ppShader)
+{
+    return pDevice->CreateComputeShader(pBytecode, size, NULL, ppShader);
+}
 
-    for (int radius = 0; radius < AOFX_BILATERAL_BLUR_RADIUS_COUNT; radius++)
-    {
-        hr = desc.m_pDevice->CreateComputeShader(CS_AMD_BLUR_Data[radius * 2 + 0], CS_AMD_BLUR_Size[radius * 2 + 0], NULL, &m_csBilateralBlurH[radius]);
-        if (result != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-        hr = desc.m_pDevice->CreateComputeShader(CS_AMD_BLUR_Data[radius * 2 + 1], CS_AMD_BLUR_Size[radius * 2 + 1], NULL, &m_csBilateralBlurV[radius]);
-        if (result != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-        hr = desc.m_pDevice->CreateComputeShader(CS_BILATERAL_BLUR_Data[radius], CS_BILATERAL_BLUR_Size[radius], NULL, &m_csBilateralBlurUpsampling[radius]);
-        if (result != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+static HRESULT createShaderObject(ID3D11Device * pDevice, const void * pBytecode, size_t size, ID3D11VertexShader ** ppShader)
+{
+    return pDevice->CreateVertexShader(pBytecode, size, NULL, ppShader);
+}
 
-        hr = desc.m_pDevice->CreateComputeShader(CS_BILATERAL_BLUR_SEPARABLE_Data[radius * 2 + 0], CS_BILATERAL_BLUR_SEPARABLE_Size[radius * 2 + 0], NULL, &m_csBilateralBlurHorizontal[radius]);
-        if (result != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-        hr = desc.m_pDevice->CreateComputeShader(CS_BILATERAL_BLUR_SEPARABLE_Data[radius * 2 + 1], CS_BILATERAL_BLUR_SEPARABLE_Size[radius * 2 + 1], NULL, &m_csBilateralBlurVertical[radius]);
-        if (result != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-    }
+//-------------------------------------------------------------------------------------------------
+// Decodes one LZ4 block of the shader archive, every length is checked against both buffers
+// so a damaged archive fails shader creation instead of reading or writing out of bounds
+//-------------------------------------------------------------------------------------------------
+static bool unpackShader(const AOFX_OpaqueDesc::S_SHADER_BYTECODE & packed, std::vector<BYTE> & bytecode)
+{
+    const BYTE * pSrc = (const BYTE *)packed.m_pData;
+    const BYTE * pSrcEnd = pSrc + packed.m_PackedSize;
 
-    hr = desc.m_pDevice->CreateVertexShader(VS_FULLSCREEN_Data, sizeof(VS_FULLSCREEN_Data), NULL, &m_vsFullscreen);
-    if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+    bytecode.resize(packed.m_Size);
+    BYTE * pDst = bytecode.data();
+    BYTE * pDstEnd = pDst + packed.m_Size;
 
-    int counter = 0;
-    for (int layer = 0; layer < AOFX_LAYER_PROCESS_COUNT; layer++)
+    while (pSrc < pSrcEnd)
     {
-        for (int normal = 0; normal < AOFX_NORMAL_OPTION_COUNT; normal++)
-        {
-            for (int tap = 0; tap < AOFX_TAP_TYPE_COUNT; tap++)
-            {
-                for (int sample = 0; sample < AOFX_SAMPLE_COUNT_COUNT; sample++)
-                {
-                    hr = desc.m_pDevice->CreatePixelShader(PS_AMD_AO_Data[counter], PS_AMD_AO_Size[counter], NULL, &m_psAmbientOcclusion[layer][normal][tap][sample]);
-                    if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-                    hr = desc.m_pDevice->CreateComputeShader(CS_AMD_AO_Data[counter], CS_AMD_AO_Size[counter], NULL, &m_csAmbientOcclusion[layer][normal][tap][sample]);
-                    if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-                    counter++;
-                }
-            }
-        }
-    }
+        uint token = *pSrc++;
 
-    counter = 0;
-    for (int i = 0; i < 2; i++)
-    {
-        for (int j = 0; j < 2; j++)
+        size_t literals = token >> 4;
+        if (literals == 15)
         {
-            for (int k = 0; k < 2; k++)
+            BYTE extra;
+            do
             {
-                if (!(i == 0 && j == 0 && k == 0))
-                {
-                    hr = desc.m_pDevice->CreatePixelShader(PS_AO_DILATE_Data[counter], PS_AO_DILATE_Size[counter], NULL, &m_psDilate[k][j][i]);
-                    if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-                }
-                counter++;
-            }
+                if (pSrc == pSrcEnd) return false;
+                extra = *pSrc++;
+                literals += extra;
+            } while (extra == 255);
         }
-    }
-
-    counter = 0;
-    for (int layer = 0; layer < AOFX_LAYER_PROCESS_COUNT; layer++)
-    {
-        for (int normal = 0; normal < AOFX_NORMAL_OPTION_COUNT; normal++)
+        if (literals > (size_t)(pSrcEnd - pSrc) || literals > (size_t)(pDstEnd - pDst))
+            return false;
+        memcpy(pDst, pSrc, literals);
+        pSrc += literals;
+        pDst += literals;
+
+        // the last sequence of a block has no match
+        if (pSrc == pSrcEnd)
+            break;
+
+        if (pSrcEnd - pSrc < 2) return false;
+        size_t offset = pSrc[0] | (pSrc[1] << 8);
+        pSrc += 2;
+
+        size_t match = (token & 15) + 4;
+        if ((token & 15) == 15)
         {
-            for (int msaa = 0; msaa < AOFX_MSAA_LEVEL_COUNT; msaa++)
+            BYTE extra;
+            do
             {
-                hr = desc.m_pDevice->CreateComputeShader(CS_AO_DEINTERLEAVE_Data[counter], CS_AO_DEINTERLEAVE_Size[counter], NULL, &m_csProcessInput[layer][normal][msaa]);
-                if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-                hr = desc.m_pDevice->CreatePixelShader(PS_AO_DEINTERLEAVE_Data[counter], PS_AO_DEINTERLEAVE_Size[counter], NULL, &m_psProcessInput[layer][normal][msaa]);
-                if (hr != S_OK) return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
-                counter++;
-            }
+                if (pSrc == pSrcEnd) return false;
+                extra = *pSrc++;
+                match += extra;
+            } while (extra == 255);
         }
+        if (offset == 0 || offset > (size_t)(pDst - bytecode.data()) || match > (size_t)(pDstEnd - pDst))
+            return false;
+
+        // matches may overlap their own output, so copy forward one byte at a time
+        const BYTE * pMatch = pDst - offset;
+        for (size_t i = 0; i < match; i++)
+            pDst[i] = pMatch[i];
+        pDst += match;
     }
 
-    return AOFX_RETURN_CODE_SUCCESS;
+    return pDst == pDstEnd;
 }
 
 //-------------------------------------------------------------------------------------------------
-// 
+// Creation runs outside of the lock so render() is not held up by the prewarm thread,
+// when both threads create the same shader the second one is dropped
 //-------------------------------------------------------------------------------------------------
-void AOFX_OpaqueDesc::releaseShaders()
+template <class T>
+AOFX_RETURN_CODE AOFX_OpaqueDesc::createShader(T ** ppShader, const S_SHADER_BYTECODE & bytecode, uint & created)
 {
-    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+    {
+        std::lock_guard<std::mutex> lock(m_ShaderLock);
+        if (*ppShader != NULL) return AOFX_RETURN_CODE_SUCCESS;
+    }
 
-    AMD_SAFE_RELEASE(m_psOutput);
-    AMD_SAFE_RELEASE(m_psUpscale);
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    // pruned by the AMD_AOFX_PERMUTATION_*_MASK settings
+    if (bytecode.m_pData == NULL)
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
 
-    for (int i = 0; i < 2; i++)
-        for (int j = 0; j < 2; j++)
-            for (int k = 0; k < 2; k++)
-                AMD_SAFE_RELEASE(m_psDilate[i][j][k]);
+    const void * pBytecode = bytecode.m_pData;
+    size_t size = bytecode.m_Size;
+    float unpackMilliseconds = 0.0f;
 
-    for (int radius = 0; radius < AOFX_BILATERAL_BLUR_RADIUS_COUNT; radius++)
+    std::vector<BYTE> unpacked;
+    if (bytecode.m_PackedSize != 0)
     {
-        AMD_SAFE_RELEASE(m_csBilateralBlurUpsampling[radius]);
-        AMD_SAFE_RELEASE(m_csBilateralBlurH[radius]);
-        AMD_SAFE_RELEASE(m_csBilateralBlurV[radius]);
-        AMD_SAFE_RELEASE(m_csBilateralBlurHorizontal[radius]);
-        AMD_SAFE_RELEASE(m_csBilateralBlurVertical[radius]);
+        if (!unpackShader(bytecode, unpacked))
+            return AOFX_RETURN_CODE_FAIL;
+
+        pBytecode = unpacked.data();
+        unpackMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
     }
 
-    AMD_SAFE_RELEASE(m_vsFullscreen);
+    T * pShader = NULL;
+    if (createShaderObject(m_pDevice, pBytecode, size, &pShader) != S_OK)
+        return AOFX_RETURN_CODE_D3D11_CALL_FAILED;
+
+    float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 
-    for (int layer = 0; layer < AOFX_LAYER_PROCESS_COUNT; layer++)
+    std::lock_guard<std::mutex> lock(m_ShaderLock);
+    m_ShaderStats.m_CreateMilliseconds += milliseconds;
+    m_ShaderStats.m_UnpackMilliseconds += unpackMilliseconds;
+    if (bytecode.m_PackedSize != 0) m_ShaderStats.m_UnpackedBytes += size;
+    if (*ppShader != NULL)
     {
-        for (int normal = 0; normal < AOFX_NORMAL_OPTION_COUNT; normal++)
-        {
-            for (int msaa = 0; msaa < AOFX_MSAA_LEVEL_COUNT; msaa++)
-            {
-                AMD_SAFE_RELEASE(m_csProcessInput[layer][normal][msaa]);
-                AMD_SAFE_RELEASE(m_psProcessInput[layer][normal][msaa]);
-            }
-            for (int tap = 0; tap < AOFX_TAP_TYPE_COUNT; tap++)
-            {
-                for (int sample = 0; sample < AOFX_SAMPLE_COUNT_COUNT; sample++)
-                {
-                    AMD_SAFE_RELEASE(m_psAmbientOcclusion[layer][normal][tap][sample]);
-                    AMD_SAFE_RELEASE(m_csAmbientOcclusion[layer][normal][tap][sample]);
-                }
-            }
-        }
+        pShader->Release();
+        return AOFX_RETURN_CODE_SUCCESS;
     }
+
+    *ppShader = pShader;
+    m_ShaderStats.m_ShadersCreated++;
+    created++;
+
+    return AOFX_RETURN_CODE_SUCCESS;
 }
 
 //-------------------------------------------------------------------------------------------------
-// 
+// The enums of AMD_AOFX.h and the tables of AMD_AOFX_Precompiled.h have to match AMD_AOFX_Permutations.h
 //-------------------------------------------------------------------------------------------------
-void AOFX_OpaqueDesc::releaseTextures()
+static_assert(AOFX_PERMUTATION_LAYER_PROCESS_COUNT == AOFX_LAYER_PROCESS_COUNT, "AOFX_LAYER_PROCESS does not match AOFX_PERMUTATION_LAYER_PROCESS_COUNT");
+static_assert(AOFX_PERMUTATION_NORMAL_OPTION_COUNT == AOFX_NORMAL_OPTION_COUNT, "AOFX_NORMAL_OPTION does not match AOFX_PERMUTATION_NORMAL_OPTION_COUNT");
+static_assert(AOFX_PERMUTATION_TAP_TYPE_COUNT == AOFX_TAP_TYPE_COUNT, "AOFX_TAP_TYPE does not match AOFX_PERMUTATION_TAP_TYPE_COUNT");
+static_assert(AOFX_PERMUTATION_SAMPLE_COUNT_COUNT == AOFX_SAMPLE_COUNT_COUNT, "AOFX_SAMPLE_COUNT does not match AOFX_PERMUTATION_SAMPLE_COUNT_COUNT");
+static_assert(AOFX_PERMUTATION_MSAA_LEVEL_COUNT == AOFX_MSAA_LEVEL_COUNT, "AOFX_MSAA_LEVEL does not match AOFX_PERMUTATION_MSAA_LEVEL_COUNT");
+static_assert(AOFX_PERMUTATION_BLUR_RADIUS_COUNT == AOFX_BILATERAL_BLUR_RADIUS_COUNT, "AOFX_BILATERAL_BLUR_RADIUS does not match AOFX_PERMUTATION_BLUR_RADIUS_COUNT");
+
+static_assert(AOFX_SHADER_TABLE_SIZE(CS_AMD_AO) == AOFX_AO_PERMUTATION_COUNT, "CS_AMD_AO does not match AOFX_AO_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(PS_AMD_AO) == AOFX_AO_PERMUTATION_COUNT, "PS_AMD_AO does not match AOFX_AO_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(CS_AO_DEINTERLEAVE) == AOFX_PROCESS_INPUT_PERMUTATION_COUNT, "CS_AO_DEINTERLEAVE does not match AOFX_PROCESS_INPUT_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(PS_AO_DEINTERLEAVE) == AOFX_PROCESS_INPUT_PERMUTATION_COUNT, "PS_AO_DEINTERLEAVE does not match AOFX_PROCESS_INPUT_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(PS_AO_DILATE) == AOFX_DILATE_PERMUTATION_COUNT, "PS_AO_DILATE does not match AOFX_DILATE_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(CS_AMD_BLUR) >= AOFX_BLUR_PERMUTATION_COUNT, "CS_AMD_BLUR does not match AOFX_BLUR_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(CS_BILATERAL_BLUR_SEPARABLE) == AOFX_BLUR_PERMUTATION_COUNT, "CS_BILATERAL_BLUR_SEPARABLE does not match AOFX_BLUR_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(CS_BILATERAL_BLUR) == AOFX_PERMUTATION_BLUR_RADIUS_COUNT, "CS_BILATERAL_BLUR does not match AOFX_PERMUTATION_BLUR_RADIUS_COUNT");
+#if AMD_AOFX_GTAO_PRECOMPILED
+static_assert(AOFX_SHADER_TABLE_SIZE(CS_AMD_GTAO) == AOFX_AO_PERMUTATION_COUNT, "CS_AMD_GTAO does not match AOFX_AO_PERMUTATION");
+static_assert(AOFX_SHADER_TABLE_SIZE(PS_AMD_GTAO) == AOFX_AO_PERMUTATION_COUNT, "PS_AMD_GTAO does not match AOFX_AO_PERMUTATION");
+#endif // AMD_AOFX_GTAO_PRECOMPILED
+#if AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+static_assert(AOFX_SHADER_TABLE_SIZE(PS_AO_DILATE_UPSAMPLE) == AOFX_DILATE_PERMUTATION_COUNT, "PS_AO_DILATE_UPSAMPLE does not match AOFX_DILATE_PERMUTATION");
+#endif // AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+
+//-------------------------------------------------------------------------------------------------
+// Every shader AOFX_SHADER_CREATION_ALL creates, permutations outside the AMD_AOFX_PERMUTATION_*_MASK settings are not counted
+//-------------------------------------------------------------------------------------------------
+uint AOFX_OpaqueDesc::permutationCount()
 {
-    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+    uint kernels = AMD_AOFX_GTAO_PRECOMPILED ? 2 : 1;
+    uint dilate = AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED ? 2 : 1;
+    uint count = AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED ? 2 : 3;     // fullscreen vertex shader, output and upsample shaders
+
+    for (int i = 0; i < AOFX_BLUR_PERMUTATION_COUNT; i++)
+        count += AOFX_BLUR_PERMUTATION_ENABLED(i) ? 2 : 0;
+    for (int i = 0; i < AOFX_PERMUTATION_BLUR_RADIUS_COUNT; i++)
+        count += AOFX_BILATERAL_BLUR_PERMUTATION_ENABLED(i) ? 1 : 0;
+    for (int i = 0; i < AOFX_AO_PERMUTATION_COUNT; i++)
+        count += AOFX_AO_PERMUTATION_ENABLED(i) ? 2 * kernels : 0;
+    for (int i = 0; i < AOFX_DILATE_PERMUTATION_COUNT; i++)
+        count += AOFX_DILATE_PERMUTATION_ENABLED(i) ? dilate : 0;
+    for (int i = 0; i < AOFX_PROCESS_INPUT_PERMUTATION_COUNT; i++)
+        count += AOFX_PROCESS_INPUT_PERMUTATION_ENABLED(i) ? 2 : 0;
+
+    return count;
+}
 
-    m_Resolution.x = m_Resolution.y = 0;
+//-------------------------------------------------------------------------------------------------
+// Kernel types the precompiled shaders of this build can render
+//-------------------------------------------------------------------------------------------------
+bool AOFX_OpaqueDesc::kernelSupported(AOFX_KERNEL_TYPE kernelType)
+{
+    return kernelType == AOFX_KERNEL_TYPE_HDAO || (kernelType == AOFX_KERNEL_TYPE_GTAO && AMD_AOFX_GTAO_PRECOMPILED);
+}
 
-    m_DilateAO.Release();
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_OpaqueDesc::S_SHADER_CONFIG AOFX_OpaqueDesc::shaderConfig(const AOFX_Desc & desc, const AOFX_QualityLevel * pLevel)
+{
+    S_SHADER_CONFIG config;
+    memset(&config, 0, sizeof(config));
 
-    for (int i = 0; i < AOFX_OpaqueDesc::m_MultiResLayerCount; ++i)
+    config.m_Implementation = desc.m_Implementation;
+    for (int i = 0; i < m_MultiResLayerCount; i++)
     {
-        memset(&m_aoData[i], 0, sizeof(m_aoData[i]));
-        memset(&m_aoInputData[i], 0, sizeof(m_aoInputData[i]));
-        memset(&m_aoBilateralBlurData[i], 0, sizeof(m_aoBilateralBlurData[i]));
+        config.m_LayerProcess[i] = pLevel != NULL ? pLevel->m_LayerProcess[i] : desc.m_LayerProcess[i];
+        config.m_SampleCount[i] = pLevel != NULL ? pLevel->m_SampleCount[i] : desc.m_SampleCount[i];
+        config.m_BilateralBlurRadius[i] = pLevel != NULL ? pLevel->m_BilateralBlurRadius[i] : desc.m_BilateralBlurRadius[i];
+        config.m_NormalOption[i] = desc.m_NormalOption[i];
+        config.m_TapType[i] = desc.m_TapType[i];
+        config.m_KernelType[i] = desc.m_KernelType[i];
+
+        // the dilate pass only picks the depth aware permutation for downscaled layers,
+        // requiring it for every active layer is a superset that does not depend on the input size
+        if (config.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE && desc.m_DepthUpsampleThreshold[i] > 0.0f)
+            config.m_DepthUpsample = 1;
+    }
 
-        m_ScaledResolution[i].x = 0;
-        m_ScaledResolution[i].y = 0;
+    return config;
+}
 
-        m_NormalOption[i] = AOFX_NORMAL_OPTION_COUNT;
-        m_LayerProcess[i] = AOFX_LAYER_PROCESS_NONE;
+//-------------------------------------------------------------------------------------------------
+// Creates the shaders render() uses for a configuration that are not created yet
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_OpaqueDesc::createShaders(const S_SHADER_CONFIG & config, uint & created)
+{
+    AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
+
+    if (!kernelAvailable(config.m_LayerProcess, config.m_KernelType))
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+    int active[m_MultiResLayerCount] = { 0 };
+
+    for (int i = 0; i < m_MultiResLayerCount && result == AOFX_RETURN_CODE_SUCCESS; i++)
+    {
+        if (config.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+        active[i] = 1;
+
+        int radius = config.m_BilateralBlurRadius[i];
+        uint input = AOFX_PROCESS_INPUT_PERMUTATION(config.m_LayerProcess[i], config.m_NormalOption[i], AOFX_MSAA_LEVEL_1);
+        uint ao = AOFX_AO_PERMUTATION(config.m_LayerProcess[i], config.m_NormalOption[i], config.m_TapType[i], config.m_SampleCount[i]);
+
+        // compiled out by the AMD_AOFX_PERMUTATION_*_MASK settings
+        if (!AOFX_PROCESS_INPUT_PERMUTATION_ENABLED(input) || !AOFX_AO_PERMUTATION_ENABLED(ao) ||
+            (radius != AOFX_BILATERAL_BLUR_RADIUS_NONE && !AOFX_BILATERAL_BLUR_PERMUTATION_ENABLED(radius)))
+            return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+        if (config.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_PS)
+            result = createShader(&m_psProcessInput[input], AOFX_SHADER_PERMUTATION(PS_AO_DEINTERLEAVE, input), created);
+        if (result == AOFX_RETURN_CODE_SUCCESS && (config.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_CS))
+            result = createShader(&m_csProcessInput[input], AOFX_SHADER_PERMUTATION(CS_AO_DEINTERLEAVE, input), created);
+
+#if AMD_AOFX_GTAO_PRECOMPILED
+        if (config.m_KernelType[i] == AOFX_KERNEL_TYPE_GTAO)
+        {
+            if (result == AOFX_RETURN_CODE_SUCCESS && (config.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_PS))
+                result = createShader(&m_psAmbientOcclusion[AOFX_KERNEL_TYPE_GTAO][ao], AOFX_SHADER_PERMUTATION(PS_AMD_GTAO, ao), created);
+            if (result == AOFX_RETURN_CODE_SUCCESS && (config.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_CS))
+                result = createShader(&m_csAmbientOcclusion[AOFX_KERNEL_TYPE_GTAO][ao], AOFX_SHADER_PERMUTATION(CS_AMD_GTAO, ao), created);
+        }
+        else
+#endif // AMD_AOFX_GTAO_PRECOMPILED
+        {
+            if (result == AOFX_RETURN_CODE_SUCCESS && (config.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_PS))
+                result = createShader(&m_psAmbientOcclusion[AOFX_KERNEL_TYPE_HDAO][ao], AOFX_SHADER_PERMUTATION(PS_AMD_AO, ao), created);
+            if (result == AOFX_RETURN_CODE_SUCCESS && (config.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_CS))
+                result = createShader(&m_csAmbientOcclusion[AOFX_KERNEL_TYPE_HDAO][ao], AOFX_SHADER_PERMUTATION(CS_AMD_AO, ao), created);
+        }
+
+        if (radius == AOFX_BILATERAL_BLUR_RADIUS_NONE || result != AOFX_RETURN_CODE_SUCCESS) continue;
+
+#if USE_NEW_BLUR_PROTOTYPE
+        result = createShader(&m_csBilateralBlurUpsampling[radius], AOFX_SHADER_PERMUTATION(CS_BILATERAL_BLUR, radius), created);
+        if (result == AOFX_RETURN_CODE_SUCCESS)
+            result = createShader(&m_csBilateralBlurHorizontal[radius], AOFX_SHADER_PERMUTATION(CS_BILATERAL_BLUR_SEPARABLE, AOFX_BLUR_PERMUTATION(radius, 0)), created);
+        if (result == AOFX_RETURN_CODE_SUCCESS)
+            result = createShader(&m_csBilateralBlurVertical[radius], AOFX_SHADER_PERMUTATION(CS_BILATERAL_BLUR_SEPARABLE, AOFX_BLUR_PERMUTATION(radius, 1)), created);
+#else
+        result = createShader(&m_csBilateralBlurH[radius], AOFX_SHADER_PERMUTATION(CS_AMD_BLUR, AOFX_BLUR_PERMUTATION(radius, 0)), created);
+        if (result == AOFX_RETURN_CODE_SUCCESS)
+            result = createShader(&m_csBilateralBlurV[radius], AOFX_SHADER_PERMUTATION(CS_AMD_BLUR, AOFX_BLUR_PERMUTATION(radius, 1)), created);
+#endif
+    }
+    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+
+    if (active[0] == 0 && active[1] == 0 && active[2] == 0) return AOFX_RETURN_CODE_SUCCESS;
+
+    uint dilate = AOFX_DILATE_PERMUTATION(active[0], active[1], active[2]);
+    result = createShader(&m_psDilate[0][dilate], AOFX_SHADER_PERMUTATION(PS_AO_DILATE, dilate), created);
+#if AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+    if (result == AOFX_RETURN_CODE_SUCCESS && config.m_DepthUpsample)
+        result = createShader(&m_psDilate[1][dilate], AOFX_SHADER_PERMUTATION(PS_AO_DILATE_UPSAMPLE, dilate), created);
+#endif // AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_OpaqueDesc::createAllShaders(uint & created)
+{
+    AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
+
+    for (int radius = 0; radius < AOFX_BILATERAL_BLUR_RADIUS_COUNT; radius++)
+    {
+        if (!AOFX_BILATERAL_BLUR_PERMUTATION_ENABLED(radius)) continue;
+
+        result = createShader(&m_csBilateralBlurH[radius], AOFX_SHADER_PERMUTATION(CS_AMD_BLUR, AOFX_BLUR_PERMUTATION(radius, 0)), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        result = createShader(&m_csBilateralBlurV[radius], AOFX_SHADER_PERMUTATION(CS_AMD_BLUR, AOFX_BLUR_PERMUTATION(radius, 1)), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        result = createShader(&m_csBilateralBlurUpsampling[radius], AOFX_SHADER_PERMUTATION(CS_BILATERAL_BLUR, radius), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+
+        result = createShader(&m_csBilateralBlurHorizontal[radius], AOFX_SHADER_PERMUTATION(CS_BILATERAL_BLUR_SEPARABLE, AOFX_BLUR_PERMUTATION(radius, 0)), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        result = createShader(&m_csBilateralBlurVertical[radius], AOFX_SHADER_PERMUTATION(CS_BILATERAL_BLUR_SEPARABLE, AOFX_BLUR_PERMUTATION(radius, 1)), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+    }
+
+    for (int ao = 0; ao < AOFX_AO_PERMUTATION_COUNT; ao++)
+    {
+        if (!AOFX_AO_PERMUTATION_ENABLED(ao)) continue;
+
+        result = createShader(&m_psAmbientOcclusion[AOFX_KERNEL_TYPE_HDAO][ao], AOFX_SHADER_PERMUTATION(PS_AMD_AO, ao), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        result = createShader(&m_csAmbientOcclusion[AOFX_KERNEL_TYPE_HDAO][ao], AOFX_SHADER_PERMUTATION(CS_AMD_AO, ao), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+#if AMD_AOFX_GTAO_PRECOMPILED
+        result = createShader(&m_psAmbientOcclusion[AOFX_KERNEL_TYPE_GTAO][ao], AOFX_SHADER_PERMUTATION(PS_AMD_GTAO, ao), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        result = createShader(&m_csAmbientOcclusion[AOFX_KERNEL_TYPE_GTAO][ao], AOFX_SHADER_PERMUTATION(CS_AMD_GTAO, ao), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+#endif // AMD_AOFX_GTAO_PRECOMPILED
+    }
+
+    for (int dilate = 0; dilate < AOFX_DILATE_PERMUTATION_COUNT; dilate++)
+    {
+        if (!AOFX_DILATE_PERMUTATION_ENABLED(dilate)) continue;
+
+        result = createShader(&m_psDilate[0][dilate], AOFX_SHADER_PERMUTATION(PS_AO_DILATE, dilate), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+#if AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+        result = createShader(&m_psDilate[1][dilate], AOFX_SHADER_PERMUTATION(PS_AO_DILATE_UPSAMPLE, dilate), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+#endif // AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+    }
+
+    for (int input = 0; input < AOFX_PROCESS_INPUT_PERMUTATION_COUNT; input++)
+    {
+        if (!AOFX_PROCESS_INPUT_PERMUTATION_ENABLED(input)) continue;
+
+        result = createShader(&m_csProcessInput[input], AOFX_SHADER_PERMUTATION(CS_AO_DEINTERLEAVE, input), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+        result = createShader(&m_psProcessInput[input], AOFX_SHADER_PERMUTATION(PS_AO_DEINTERLEAVE, input), created);
+        if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+    }
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// The fullscreen vertex shader, the output shader and the upsample shader are shared by every configuration
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_OpaqueDesc::createShaders(const AOFX_Desc & desc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (!kernelAvailable(desc.m_LayerProcess, desc.m_KernelType) || !viewportAvailable(desc))
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+    releaseShaders();
+
+    desc.m_pDevice->AddRef();
+    m_pDevice = desc.m_pDevice;
+    m_ShaderCreation = desc.m_ShaderCreation;
+    m_ShaderStats = AOFX_ShaderStats();
+    m_ShaderStats.m_PermutationCount = permutationCount();
+
+    uint created = 0;
+
+    AOFX_RETURN_CODE result = createShader(&m_vsFullscreen, AOFX_SHADER_BYTECODE(VS_FULLSCREEN), created);
+    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+    result = createShader(&m_psOutput, AOFX_SHADER_BYTECODE(PS_OUTPUT), created);
+    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+#if !AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+    result = createShader(&m_psUpsample, AOFX_SHADER_BYTECODE(PS_UPSAMPLE), created);
+    if (result != AOFX_RETURN_CODE_SUCCESS) return result;
+#endif // !AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+
+    if (m_ShaderCreation == AOFX_SHADER_CREATION_ON_DEMAND)
+        return createShaders(shaderConfig(desc, NULL), created);
+
+    return createAllShaders(created);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Called by render() before any state is bound. A configuration that already rendered once
+// only costs a compare, the shaders it needs can not have been released since
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_OpaqueDesc::requireShaders(const AOFX_Desc & desc)
+{
+    if (m_ShaderCreation != AOFX_SHADER_CREATION_ON_DEMAND) return AOFX_RETURN_CODE_SUCCESS;
+
+    S_SHADER_CONFIG config = shaderConfig(desc, NULL);
+    if (m_ShaderConfigReadyValid && memcmp(&config, &m_ShaderConfigReady, sizeof(config)) == 0)
+        return AOFX_RETURN_CODE_SUCCESS;
+
+    if (m_pDevice == NULL) return AOFX_RETURN_CODE_INVALID_DEVICE;
+
+    uint created = 0;
+    AOFX_RETURN_CODE result = createShaders(config, created);
+
+    {
+        std::lock_guard<std::mutex> lock(m_ShaderLock);
+        m_ShaderStats.m_ShadersCreatedByRender += created;
+    }
+
+    if (result == AOFX_RETURN_CODE_SUCCESS)
+    {
+        m_ShaderConfigReady = config;
+        m_ShaderConfigReadyValid = true;
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE AOFX_OpaqueDesc::prewarmShaders(const AOFX_Desc & desc, const AOFX_QualityLevel * pLevels, uint levelCount, bool background)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (m_pDevice == NULL) return AOFX_RETURN_CODE_INVALID_DEVICE;
+
+    // a previous prewarm finishes first, its shaders are not wasted
+    if (m_ShaderThread.joinable())
+        m_ShaderThread.join();
+
+    std::vector<S_SHADER_CONFIG> configs;
+    configs.push_back(shaderConfig(desc, NULL));
+    for (uint i = 0; i < levelCount; i++)
+        configs.push_back(shaderConfig(desc, &pLevels[i]));
+
+    if (!background)
+    {
+        uint created = 0;
+        AOFX_RETURN_CODE result = AOFX_RETURN_CODE_SUCCESS;
+        for (size_t i = 0; i < configs.size() && result == AOFX_RETURN_CODE_SUCCESS; i++)
+            result = createShaders(configs[i], created);
+
+        std::lock_guard<std::mutex> lock(m_ShaderLock);
+        m_ShaderStats.m_ShadersPrewarmed += created;
+
+        return result;
+    }
+
+    m_ShaderThreadCancel = false;
+    m_ShaderThreadRunning = true;
+    m_ShaderThread = std::thread([this, configs]()
+    {
+        // failures are not reported from here, render() retries the shaders it needs and returns the error
+        for (size_t i = 0; i < configs.size() && !m_ShaderThreadCancel; i++)
+        {
+            uint created = 0;
+            createShaders(configs[i], created);
+
+            std::lock_guard<std::mutex> lock(m_ShaderLock);
+            m_ShaderStats.m_ShadersPrewarmed += created;
+        }
+
+        m_ShaderThreadRunning = false;
+    });
+
+    return AOFX_RETURN_CODE_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::getShaderStats(AOFX_ShaderStats & stats)
+{
+    std::lock_guard<std::mutex> lock(m_ShaderLock);
+
+    stats = m_ShaderStats;
+    stats.m_PrewarmPending = m_ShaderThreadRunning;
+}
+
+//-------------------------------------------------------------------------------------------------
+// The prewarm thread stops after the configuration it is working on
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::stopShaderThread()
+{
+    if (!m_ShaderThread.joinable()) return;
+
+    m_ShaderThreadCancel = true;
+    m_ShaderThread.join();
+    m_ShaderThreadRunning = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::releaseShaders()
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    stopShaderThread();
+
+    m_ShaderConfigReadyValid = false;
+
+    AMD_SAFE_RELEASE(m_psOutput);
+    AMD_SAFE_RELEASE(m_psUpsample);
+
+    for (int u = 0; u < 2; u++)
+        for (int i = 0; i < AOFX_DILATE_PERMUTATION_COUNT; i++)
+            AMD_SAFE_RELEASE(m_psDilate[u][i]);
+
+    for (int radius = 0; radius < AOFX_BILATERAL_BLUR_RADIUS_COUNT; radius++)
+    {
+        AMD_SAFE_RELEASE(m_csBilateralBlurUpsampling[radius]);
+        AMD_SAFE_RELEASE(m_csBilateralBlurH[radius]);
+        AMD_SAFE_RELEASE(m_csBilateralBlurV[radius]);
+        AMD_SAFE_RELEASE(m_csBilateralBlurHorizontal[radius]);
+        AMD_SAFE_RELEASE(m_csBilateralBlurVertical[radius]);
+    }
+
+    AMD_SAFE_RELEASE(m_vsFullscreen);
+
+    for (int i = 0; i < AOFX_PROCESS_INPUT_PERMUTATION_COUNT; i++)
+    {
+        AMD_SAFE_RELEASE(m_csProcessInput[i]);
+        AMD_SAFE_RELEASE(m_psProcessInput[i]);
+    }
+
+    for (int kernel = 0; kernel < AOFX_KERNEL_TYPE_COUNT; kernel++)
+    {
+        for (int i = 0; i < AOFX_AO_PERMUTATION_COUNT; i++)
+        {
+            AMD_SAFE_RELEASE(m_psAmbientOcclusion[kernel][i]);
+            AMD_SAFE_RELEASE(m_csAmbientOcclusion[kernel][i]);
+        }
+    }
+
+    AMD_SAFE_RELEASE(m_pDevice);
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::releaseTextures()
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    m_Resolution.x = m_Resolution.y = 0;
+
+    m_DilateAO.Release();
+    m_BlurAO.Release();
+
+    for (int i = 0; i < AOFX_OpaqueDesc::m_MultiResLayerCount; ++i)
+    {
+        m_ScaledResolution[i].x = 0;
+        m_ScaledResolution[i].y = 0;
+
+        m_NormalOption[i] = AOFX_NORMAL_OPTION_COUNT;
+        m_LayerProcess[i] = AOFX_LAYER_PROCESS_NONE;
 
-        m_AO[i].Release();
         m_ResultAO[i].Release();
         m_InputAO[i].Release();
+        m_UpsampleAO[i].Release();
+        m_BlurLayerAO[i].Release();
     }
 }
 
@@ -609,77 +1231,375 @@ void AOFX_OpaqueDesc::release()
     AMD_SAFE_RELEASE(m_tbSamplePatternsSRV);
     AMD_SAFE_RELEASE(m_cbSamplePatterns);
 
-    for (int i = 0; i < m_MultiResLayerCount; i++)
+    for (int i = 0; i < CONSTANT_BLOCK_COUNT; i++)
     {
-        AMD_SAFE_RELEASE(m_cbAOData[i]);
-        AMD_SAFE_RELEASE(m_cbAOInputData[i]);
-        AMD_SAFE_RELEASE(m_cbBilateralBlurData[i]);
+        AMD_SAFE_RELEASE(m_cbConstantBlocks[i]);
     }
 
     AMD_SAFE_RELEASE(m_cbBilateralDilate);
-    AMD_SAFE_RELEASE(m_cbDilateData);
+    AMD_SAFE_RELEASE(m_cbConstantRing);
+    m_ConstantsValid = 0;
     AMD_SAFE_RELEASE(m_ssPointClamp);
     AMD_SAFE_RELEASE(m_ssLinearClamp);
 }
 
+//-------------------------------------------------------------------------------------------------
+// The pixel shader path reads the full resolution input, the compute path the scaled one
+//-------------------------------------------------------------------------------------------------
+AOFX_OpaqueDesc::AO_InputData AOFX_OpaqueDesc::processInputData(uint target, const AOFX_Desc & desc, bool pixelShader) const
+{
+    AO_InputData aoInputData(desc, target);
+
+    int deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[target]];
+    uint scaledWidth = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[target]), (uint)1);
+    uint scaledHeight = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[target]), (uint)1);
+    uint deinterleavedScaledWidth = (uint)ceilf((float)scaledWidth / deinterleaveSize);
+    uint deinterleavedScaledHeight = (uint)ceilf((float)scaledHeight / deinterleaveSize);
+
+    aoInputData.m_OutputSize.x = deinterleavedScaledWidth;
+    aoInputData.m_OutputSize.y = deinterleavedScaledHeight;
+    aoInputData.m_OutputSizeRcp.x = 1.0f / aoInputData.m_OutputSize.x;
+    aoInputData.m_OutputSizeRcp.y = 1.0f / aoInputData.m_OutputSize.y;
+    aoInputData.m_InputSize.x = pixelShader ? desc.m_InputSize.x : scaledWidth;
+    aoInputData.m_InputSize.y = pixelShader ? desc.m_InputSize.y : scaledHeight;
+
+    // the application depth and normals are sampled, they have the size of the full resolution surfaces
+    float4 inputUV = viewportUV(m_MultiResLayerCount, desc);
+    aoInputData.m_InputSizeRcp.x = inputUV.x / aoInputData.m_InputSize.x;
+    aoInputData.m_InputSizeRcp.y = inputUV.y / aoInputData.m_InputSize.y;
+    aoInputData.setViewportUV(inputUV);
+
+    return aoInputData;
+}
+
 //-------------------------------------------------------------------------------------------------
 // 
 //-------------------------------------------------------------------------------------------------
-AOFX_RETURN_CODE  AOFX_OpaqueDesc::csProcessInput(uint target, const AOFX_Desc & desc)
+AOFX_OpaqueDesc::AO_Data AOFX_OpaqueDesc::ambientOcclusionData(uint target, const AOFX_Desc & desc) const
 {
-    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+    AO_Data aoData(desc, target);
 
-    ID3D11RenderTargetView*  pNullRTV[8] = { 0 };
-    desc.m_pDeviceContext->OMSetRenderTargets(AMD_ARRAY_SIZE(pNullRTV), pNullRTV, NULL);
+    int deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[target]];
+    uint scaledWidth = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[target]), (uint)1);
+    uint scaledHeight = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[target]), (uint)1);
+    uint deinterleavedScaledWidth = (uint)ceilf((float)scaledWidth / deinterleaveSize);
+    uint deinterleavedScaledHeight = (uint)ceilf((float)scaledHeight / deinterleaveSize);
 
+    aoData.m_InputSize.x = scaledWidth;
+    aoData.m_InputSize.y = scaledHeight;
+    aoData.m_InputSizeRcp.x = 2.0f / aoData.m_InputSize.x; // we are actually passing 2.0 * 1 / m_InputSize
+    aoData.m_InputSizeRcp.y = 2.0f / aoData.m_InputSize.y; // because the shader always does 2.0 * 1 / InputSize
+    aoData.m_OutputSize.x = deinterleavedScaledWidth;
+    aoData.m_OutputSize.y = deinterleavedScaledHeight;
+
+    // the (deinterleaved) input surface of the layer is sampled
+    uint2 inputSize;
+    inputSize.x = (uint)ceilf((float)m_ScaledResolution[target].x / deinterleaveSize);
+    inputSize.y = (uint)ceilf((float)m_ScaledResolution[target].y / deinterleaveSize);
+    float4 inputUV = surfaceUV(desc, aoData.m_OutputSize, inputSize);
+
+    aoData.m_OutputSizeRcp.x = inputUV.x / aoData.m_OutputSize.x;  // this value needs to be adjusted because it
+    aoData.m_OutputSizeRcp.y = inputUV.y / aoData.m_OutputSize.y;  // participates in clip-space - to - world space transformation
+    aoData.m_InputUVMax.x = inputUV.z;
+    aoData.m_InputUVMax.y = inputUV.w;
+
+    return aoData;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Bilateral blur passes sample AO and depth through normalized coordinates,
+// so a pass may read a surface of a different resolution than the one it writes.
+// inputUV is the viewportUV() of the AO surface the pass reads
+//-------------------------------------------------------------------------------------------------
+AOFX_OpaqueDesc::AO_InputData AOFX_OpaqueDesc::blurData(uint target, const AOFX_Desc & desc, uint2 outputSize, const float4 & inputUV) const
+{
     AO_InputData aoInputData(desc, target);
 
-    int deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[target]];
+    aoInputData.m_OutputSize.x = outputSize.x;
+    aoInputData.m_OutputSize.y = outputSize.y;
+    aoInputData.m_OutputSizeRcp.x = inputUV.x / aoInputData.m_OutputSize.x;
+    aoInputData.m_OutputSizeRcp.y = inputUV.y / aoInputData.m_OutputSize.y;
+    aoInputData.m_InputSize.x = desc.m_InputSize.x;
+    aoInputData.m_InputSize.y = desc.m_InputSize.y;
+    aoInputData.m_InputSizeRcp.x = 1.0f / aoInputData.m_InputSize.x;
+    aoInputData.m_InputSizeRcp.y = 1.0f / aoInputData.m_InputSize.y;
+    aoInputData.setViewportUV(inputUV);
+
+    return aoInputData;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Surfaces of layer 'target', or the full resolution surfaces and application inputs for m_MultiResLayerCount
+//-------------------------------------------------------------------------------------------------
+AOFX_OpaqueDesc::float4 AOFX_OpaqueDesc::viewportUV(uint target, const AOFX_Desc & desc) const
+{
+    if (target == m_MultiResLayerCount)
+    {
+        uint2 fullSize;
+        fullSize.x = desc.m_InputSize.x;
+        fullSize.y = desc.m_InputSize.y;
+        return surfaceUV(desc, fullSize, m_Resolution);
+    }
+
+    return surfaceUV(desc, scaledSize(desc, target), m_ScaledResolution[target]);
+}
+
+//-------------------------------------------------------------------------------------------------
+// viewportUV() of the surface the blur and dilate passes read for layer 'target'
+//-------------------------------------------------------------------------------------------------
+AOFX_OpaqueDesc::float4 AOFX_OpaqueDesc::layerUV(uint target, const AOFX_Desc & desc) const
+{
+    return viewportUV(upsampledLayer(desc, target) ? (uint)m_MultiResLayerCount : target, desc);
+}
+
+//-------------------------------------------------------------------------------------------------
+// The surface the blur and dilate passes read for layer 'target'
+//-------------------------------------------------------------------------------------------------
+AMD::Texture2D & AOFX_OpaqueDesc::layerAO(uint target, const AOFX_Desc & desc)
+{
+    return upsampledLayer(desc, target) ? m_UpsampleAO[target] : m_ResultAO[target];
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_OpaqueDesc::S_DILATE_DATA AOFX_OpaqueDesc::dilateData(const AOFX_Desc & desc) const
+{
+    S_DILATE_DATA dilate_data;
+    memset(&dilate_data, 0, sizeof(dilate_data));
+    for (int i = 0; i != m_MultiResLayerCount; ++i)
+    {
+        dilate_data.m_PowIntensity.v[i] = desc.m_PowIntensity[i];
+        if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+
+        uint2 size = layerSize(desc, i);
+        uint2 surface = upsampledLayer(desc, i) ? m_Resolution : m_ScaledResolution[i];
+        bool downscaled = size.x != desc.m_InputSize.x || size.y != desc.m_InputSize.y;
+        dilate_data.m_LayerSize[i].x = (float)surface.x;
+        dilate_data.m_LayerSize[i].y = (float)surface.y;
+        dilate_data.m_LayerSize[i].z = 1.0f / surface.x;
+        dilate_data.m_LayerSize[i].w = 1.0f / surface.y;
+        dilate_data.m_DepthUpsampleThreshold.v[i] = downscaled ? MAX(desc.m_DepthUpsampleThreshold[i], 0.0f) : 0.0f;
+        dilate_data.m_LayerUV[i] = layerUV(i, desc);
+    }
+    dilate_data.m_DepthUV = viewportUV(m_MultiResLayerCount, desc);
+    dilate_data.m_CameraQ = desc.m_Camera.m_FarPlane / (desc.m_Camera.m_FarPlane - desc.m_Camera.m_NearPlane);
+    dilate_data.m_CameraQTimesZNear = dilate_data.m_CameraQ * desc.m_Camera.m_NearPlane;
+
+    return dilate_data;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Blocks are packed linearly in the order they are written, a block only counts as changed
+// when its contents or its place in the ring differ from the last upload
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::writeConstants(uint block, const void * pData, size_t size)
+{
+    assert(block < CONSTANT_BLOCK_COUNT && size <= m_ConstantBlockSize);
+
+    uint bit = 1u << block;
+
+    memset(&m_Constants[block], 0, sizeof(m_Constants[block]));
+    memcpy(&m_Constants[block], pData, size);
+    m_ConstantOffset[block] = m_ConstantBlockCount++;
+    m_ConstantsUsed |= bit;
+
+    if ((m_ConstantsValid & bit) == 0 ||
+        (m_cbConstantRing != NULL && m_ConstantOffset[block] != m_ConstantOffsetUploaded[block]) ||
+        memcmp(&m_Constants[block], &m_ConstantsUploaded[block], sizeof(m_Constants[block])) != 0)
+    {
+        m_ConstantsChanged |= bit;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Builds the constants of every pass render() is about to issue, following the same flow
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::prepareConstants(const AOFX_Desc & desc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    m_ConstantBlockCount = 0;
+    m_ConstantsUsed = m_ConstantsChanged = 0;
+
+    uint2 fullSize;
+    fullSize.x = desc.m_InputSize.x;
+    fullSize.y = desc.m_InputSize.y;
+
+    for (int i = 0; i < m_MultiResLayerCount; ++i)
+    {
+        if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+
+        if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_PS)
+        {
+            AO_InputData aoInputData = processInputData(i, desc, true);
+            writeConstants(CONSTANT_BLOCK_PROCESS_INPUT_PS + i, &aoInputData, sizeof(aoInputData));
+        }
+        if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_CS)
+        {
+            AO_InputData aoInputData = processInputData(i, desc, false);
+            writeConstants(CONSTANT_BLOCK_PROCESS_INPUT_CS + i, &aoInputData, sizeof(aoInputData));
+        }
+
+        AO_Data aoData = ambientOcclusionData(i, desc);
+        writeConstants(CONSTANT_BLOCK_AMBIENT_OCCLUSION + i, &aoData, sizeof(aoData));
+
+#if USE_NEW_BLUR_PROTOTYPE
+        AO_InputData aoBlurData = blurData(i, desc, fullSize, viewportUV(i, desc));
+        writeConstants(CONSTANT_BLOCK_BLUR + i, &aoBlurData, sizeof(aoBlurData));
+#endif
+    }
+
+#if !USE_NEW_BLUR_PROTOTYPE
+    int  blurRadiusResult = AOFX_BILATERAL_BLUR_RADIUS_NONE;
+    bool blurLayers = separateBlur(desc, blurRadiusResult);
+
+    if (blurLayers == true)
+    {
+        for (int i = 0; i < m_MultiResLayerCount; ++i)
+        {
+            if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE ||
+                desc.m_BilateralBlurRadius[i] == AOFX_BILATERAL_BLUR_RADIUS_NONE) continue;
+
+            // both passes write at the layer resolution, so they share the block
+            AO_InputData aoBlurData = blurData(i, desc, layerSize(desc, i), layerUV(i, desc));
+            writeConstants(CONSTANT_BLOCK_BLUR + i, &aoBlurData, sizeof(aoBlurData));
+        }
+    }
+
+    S_DILATE_DATA dilate_data = dilateData(desc);
+    writeConstants(CONSTANT_BLOCK_DILATE, &dilate_data, sizeof(dilate_data));
+
+    if (blurLayers == false &&
+        blurRadiusResult != AOFX_BILATERAL_BLUR_RADIUS_NONE)
+    {
+        uint selectTarget;
+        for (selectTarget = 0; selectTarget < m_MultiResLayerCount - 1; selectTarget++)
+            if (desc.m_LayerProcess[selectTarget] != AOFX_LAYER_PROCESS_NONE) break;
+
+        AO_InputData aoBlendedBlur = blurData(selectTarget, desc, fullSize, viewportUV(m_MultiResLayerCount, desc));
+        writeConstants(CONSTANT_BLOCK_BLUR + m_MultiResLayerCount, &aoBlendedBlur, sizeof(aoBlendedBlur));
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// With constant buffer offsetting every block of the frame is written by a single discard map
+// of the ring, otherwise only the blocks that changed are mapped, one buffer each
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::uploadConstants(const AOFX_Desc & desc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    if (m_ConstantsChanged == 0) return;
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+    if (m_cbConstantRing != NULL)
+    {
+        // a discard map loses the previous contents, unchanged blocks are written again
+        if (desc.m_pDeviceContext->Map(m_cbConstantRing, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource) != S_OK)
+        {
+            m_ConstantsValid = 0;
+            return;
+        }
+
+        for (uint i = 0; i < CONSTANT_BLOCK_COUNT; i++)
+        {
+            if ((m_ConstantsUsed & (1u << i)) == 0) continue;
+
+            memcpy((unsigned char *)mappedResource.pData + m_ConstantOffset[i] * m_ConstantBlockSize, &m_Constants[i], m_ConstantBlockSize);
+            memcpy(&m_ConstantsUploaded[i], &m_Constants[i], sizeof(m_Constants[i]));
+            m_ConstantOffsetUploaded[i] = m_ConstantOffset[i];
+        }
+        desc.m_pDeviceContext->Unmap(m_cbConstantRing, 0);
+
+        m_ConstantsValid = m_ConstantsUsed;
+        return;
+    }
+
+    for (uint i = 0; i < CONSTANT_BLOCK_COUNT; i++)
+    {
+        if ((m_ConstantsChanged & (1u << i)) == 0) continue;
+
+        if (desc.m_pDeviceContext->Map(m_cbConstantBlocks[i], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource) != S_OK)
+        {
+            m_ConstantsValid &= ~(1u << i);
+            continue;
+        }
+        memcpy(mappedResource.pData, &m_Constants[i], m_ConstantBlockSize);
+        desc.m_pDeviceContext->Unmap(m_cbConstantBlocks[i], 0);
+
+        memcpy(&m_ConstantsUploaded[i], &m_Constants[i], sizeof(m_Constants[i]));
+        m_ConstantsValid |= 1u << i;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Binds a block prepared for this frame to constant buffer slot 0
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::setConstants(uint block, bool computeShader)
+{
+    assert((m_ConstantsUsed & (1u << block)) != 0);
+
+    countUpload((m_ConstantsChanged & (1u << block)) != 0);
+
+    if (m_cbConstantRing != NULL)
+    {
+        UINT firstConstant = m_ConstantOffset[block] * (m_ConstantBlockSize / sizeof(float4));
+        UINT numConstants = m_ConstantBlockSize / sizeof(float4);
+
+        if (computeShader)
+            m_StateCache.CSSetConstantBuffers1(0, 1, &m_cbConstantRing, &firstConstant, &numConstants);
+        else
+            m_StateCache.PSSetConstantBuffers1(0, 1, &m_cbConstantRing, &firstConstant, &numConstants);
+    }
+    else
+    {
+        if (computeShader)
+            m_StateCache.CSSetConstantBuffers(0, 1, &m_cbConstantBlocks[block]);
+        else
+            m_StateCache.PSSetConstantBuffers(0, 1, &m_cbConstantBlocks[block]);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+AOFX_RETURN_CODE  AOFX_OpaqueDesc::csProcessInput(uint target, const AOFX_Desc & desc)
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    ID3D11RenderTargetView*  pNullRTV[8] = { 0 };
+    m_StateCache.OMSetRenderTargets(AMD_ARRAY_SIZE(pNullRTV), pNullRTV, NULL);
+
     uint scaledWidth = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[target]), (uint)1);
     uint scaledHeight = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[target]), (uint)1);
-    uint deinterleavedScaledWidth = (uint)ceilf((float)scaledWidth / deinterleaveSize);
-    uint deinterleavedScaledHeight = (uint)ceilf((float)scaledHeight / deinterleaveSize);
-
-    aoInputData.m_OutputSize.x = deinterleavedScaledWidth;
-    aoInputData.m_OutputSize.y = deinterleavedScaledHeight;
-    aoInputData.m_OutputSizeRcp.x = 1.0f / aoInputData.m_OutputSize.x;
-    aoInputData.m_OutputSizeRcp.y = 1.0f / aoInputData.m_OutputSize.y;
-    aoInputData.m_InputSize.x = scaledWidth;
-    aoInputData.m_InputSize.y = scaledHeight;
-    aoInputData.m_InputSizeRcp.x = 1.0f / aoInputData.m_InputSize.x;
-    aoInputData.m_InputSizeRcp.y = 1.0f / aoInputData.m_InputSize.y;
-
-    assert(sizeof(m_aoInputData[target]) == sizeof(aoInputData));
-    if (0 != memcmp(&m_aoInputData[target], &aoInputData, sizeof(m_aoInputData[target])))
-    {
-        D3D11_MAPPED_SUBRESOURCE   mappedResource;
-        desc.m_pDeviceContext->Map(m_cbAOInputData[target], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        memcpy(mappedResource.pData, &aoInputData, sizeof(aoInputData));
-        desc.m_pDeviceContext->Unmap(m_cbAOInputData[target], 0);
-        memcpy(&m_aoInputData[target], &aoInputData, sizeof(aoInputData));
-    }
 
-    ID3D11Buffer*              pCB[] = { m_cbAOInputData[target] };
     ID3D11UnorderedAccessView* pUAV[] = { m_InputAO[target]._uav };
     ID3D11ShaderResourceView*  pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV };
     ID3D11SamplerState*        pSS[] = { m_ssPointClamp, m_ssLinearClamp };
 
-    desc.m_pDeviceContext->CSSetConstantBuffers(0, AMD_ARRAY_SIZE(pCB), pCB);
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
-    desc.m_pDeviceContext->CSSetSamplers(0, AMD_ARRAY_SIZE(pSS), pSS);
+    setConstants(CONSTANT_BLOCK_PROCESS_INPUT_CS + target, true);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
+    m_StateCache.CSSetSamplers(0, AMD_ARRAY_SIZE(pSS), pSS);
 
-    uint uX = (int)ceilf((float)aoInputData.m_InputSize.x / m_DeinterleaveGroupDim);
-    uint uY = (int)ceilf((float)aoInputData.m_InputSize.y / m_DeinterleaveGroupDim);
+    uint uX = (int)ceilf((float)scaledWidth / m_DeinterleaveGroupDim);
+    uint uY = (int)ceilf((float)scaledHeight / m_DeinterleaveGroupDim);
 
-    desc.m_pDeviceContext->CSSetShader(m_csProcessInput[desc.m_LayerProcess[target]][desc.m_NormalOption[target]][AOFX_MSAA_LEVEL_1], NULL, 0);
+    m_StateCache.CSSetShader(m_csProcessInput[AOFX_PROCESS_INPUT_PERMUTATION(desc.m_LayerProcess[target], desc.m_NormalOption[target], AOFX_MSAA_LEVEL_1)]);
 
     desc.m_pDeviceContext->Dispatch(uX, uY, 1);
 
+    DXGI_FORMAT inputFormat = m_NormalOption[target] == AOFX_NORMAL_OPTION_READ_FROM_SRV ? m_FormatDepthNormal : m_FormatDepth;
+    size_t texels = (size_t)scaledWidth * scaledHeight;
+    countPass(uX, uY, 1, texels, texels * formatSize(inputFormat));
+
     ID3D11ShaderResourceView*  pNullSRV[AMD_ARRAY_SIZE(pSRV)] = { 0 };
     ID3D11UnorderedAccessView* pNullUAV[AMD_ARRAY_SIZE(pUAV)] = { 0 };
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV);
 
     return AOFX_RETURN_CODE_SUCCESS;
 }
@@ -688,45 +1608,25 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::psProcessInput(uint target, const AOFX_Desc &
 {
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
-    AO_InputData aoInputData(desc, target);
-
     int deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[target]];
     uint scaledWidth = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[target]), (uint)1);
     uint scaledHeight = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[target]), (uint)1);
     uint deinterleavedScaledWidth = (uint)ceilf((float)scaledWidth / deinterleaveSize);
     uint deinterleavedScaledHeight = (uint)ceilf((float)scaledHeight / deinterleaveSize);
 
-    aoInputData.m_OutputSize.x = deinterleavedScaledWidth;
-    aoInputData.m_OutputSize.y = deinterleavedScaledHeight;
-    aoInputData.m_OutputSizeRcp.x = 1.0f / aoInputData.m_OutputSize.x;
-    aoInputData.m_OutputSizeRcp.y = 1.0f / aoInputData.m_OutputSize.y;
-    aoInputData.m_InputSize.x = desc.m_InputSize.x;
-    aoInputData.m_InputSize.y = desc.m_InputSize.y;
-    aoInputData.m_InputSizeRcp.x = 1.0f / desc.m_InputSize.x;
-    aoInputData.m_InputSizeRcp.y = 1.0f / desc.m_InputSize.y;
-
-    assert(sizeof(m_aoInputData[target]) == sizeof(aoInputData));
-    if (0 != memcmp(&m_aoInputData[target], &aoInputData, sizeof(m_aoInputData[target])))
-    {
-        D3D11_MAPPED_SUBRESOURCE mappedResource;
-        desc.m_pDeviceContext->Map(m_cbAOInputData[target], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        memcpy(mappedResource.pData, &aoInputData, sizeof(aoInputData));
-        desc.m_pDeviceContext->Unmap(m_cbAOInputData[target], 0);
-        memcpy(&m_aoInputData[target], &aoInputData, sizeof(aoInputData));
-    }
-
     CD3D11_VIEWPORT vpDeinterleaved(0.0f, 0.0f, (float)deinterleavedScaledWidth * deinterleaveSize, (float)deinterleavedScaledHeight * deinterleaveSize, 0.0f, 1.0f);
 
-    ID3D11Buffer*             pCB[] = { m_cbAOInputData[target] };
     ID3D11ShaderResourceView* pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV };
     ID3D11SamplerState*       pSS[] = { m_ssPointClamp, m_ssLinearClamp };
 
-    HRESULT hr = AMD::RenderFullscreenPass(desc.m_pDeviceContext,
+    setConstants(CONSTANT_BLOCK_PROCESS_INPUT_PS + target, false);
+
+    HRESULT hr = AMD::RenderFullscreenPass(m_StateCache,
                                            vpDeinterleaved,
                                            m_vsFullscreen,
-                                           m_psProcessInput[desc.m_LayerProcess[target]][desc.m_NormalOption[target]][AOFX_MSAA_LEVEL_1],
+                                           m_psProcessInput[AOFX_PROCESS_INPUT_PERMUTATION(desc.m_LayerProcess[target], desc.m_NormalOption[target], AOFX_MSAA_LEVEL_1)],
+                                           NULL, 0,
                                            NULL, 0,
-                                           pCB, AMD_ARRAY_SIZE(pCB),
                                            pSS, AMD_ARRAY_SIZE(pSS),
                                            pSRV, AMD_ARRAY_SIZE(pSRV),
                                            NULL, 0,
@@ -734,6 +1634,10 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::psProcessInput(uint target, const AOFX_Desc &
                                            NULL, NULL, 0, m_bsOutputChannel[0xf],
                                            m_rsNoCulling);
 
+    DXGI_FORMAT inputFormat = m_NormalOption[target] == AOFX_NORMAL_OPTION_READ_FROM_SRV ? m_FormatDepthNormal : m_FormatDepth;
+    size_t texels = (size_t)scaledWidth * scaledHeight;
+    countPass((uint)vpDeinterleaved.Width, (uint)vpDeinterleaved.Height, 1, texels, texels * formatSize(inputFormat));
+
     return hr == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_FAIL;
 }
 
@@ -745,15 +1649,9 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::csAmbientOcclusion(uint target, const AOFX_De
 {
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
-    AO_Data                    aoData(desc, target);
-
-    ID3D11Buffer*              pCB[] = { m_cbAOData[target], m_cbSamplePatterns };
     ID3D11SamplerState*        pSS[] = { m_ssPointClamp, m_ssLinearClamp };
     ID3D11ShaderResourceView*  pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV, m_tbSamplePatternsSRV, m_InputAO[target]._srv };
-    ID3D11UnorderedAccessView* pUAV[] = { m_AO[target]._uav };
-
-    if (desc.m_MultiResLayerScale[target] < 1.0f)
-        pUAV[0] = m_ResultAO[target]._uav;
+    ID3D11UnorderedAccessView* pUAV[] = { m_ResultAO[target]._uav };
 
     int deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[target]];
     uint scaledWidth = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[target]), (uint)1);
@@ -761,41 +1659,29 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::csAmbientOcclusion(uint target, const AOFX_De
     uint deinterleavedScaledWidth = (uint)ceilf((float)scaledWidth / deinterleaveSize);
     uint deinterleavedScaledHeight = (uint)ceilf((float)scaledHeight / deinterleaveSize);
 
-    aoData.m_InputSize.x = scaledWidth;
-    aoData.m_InputSize.y = scaledHeight;
-    aoData.m_InputSizeRcp.x = 2.0f / aoData.m_InputSize.x; // we are actually passing 2.0 * 1 / m_InputSize 
-    aoData.m_InputSizeRcp.y = 2.0f / aoData.m_InputSize.y; // because the shader always does 2.0 * 1 / InputSize
-    aoData.m_OutputSize.x = deinterleavedScaledWidth;
-    aoData.m_OutputSize.y = deinterleavedScaledHeight;
-    aoData.m_OutputSizeRcp.x = (float) 1.0f / aoData.m_OutputSize.x;  // this value needs to be adjusted because it
-    aoData.m_OutputSizeRcp.y = (float) 1.0f / aoData.m_OutputSize.y;  // participates in clip-space - to - world space transformation
-
-    assert(sizeof(m_aoData[target]) == sizeof(aoData));
-    if (0 != memcmp(&m_aoData[target], &aoData, sizeof(m_aoData[target])))
-    {
-        D3D11_MAPPED_SUBRESOURCE   mappedResource;
-        desc.m_pDeviceContext->Map(m_cbAOData[target], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        memcpy(mappedResource.pData, &aoData, sizeof(aoData));
-        desc.m_pDeviceContext->Unmap(m_cbAOData[target], 0);
-        memcpy(&m_aoData[target], &aoData, sizeof(m_aoData[target]));
-    }
+    m_StateCache.CSSetSamplers(0, AMD_ARRAY_SIZE(pSS), pSS);
+    setConstants(CONSTANT_BLOCK_AMBIENT_OCCLUSION + target, true);
+    m_StateCache.CSSetConstantBuffers(1, 1, &m_cbSamplePatterns);
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
 
-    desc.m_pDeviceContext->CSSetSamplers(0, AMD_ARRAY_SIZE(pSS), pSS);
-    desc.m_pDeviceContext->CSSetConstantBuffers(0, AMD_ARRAY_SIZE(pCB), pCB);
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
+    uint uGridX = (uint)ceilf((float)deinterleavedScaledWidth / m_DeinterleaveGroupDim);
+    uint uGridY = (uint)ceilf((float)deinterleavedScaledHeight / m_DeinterleaveGroupDim);
 
-    uint uGridX = (uint)ceilf((float)aoData.m_OutputSize.x / m_DeinterleaveGroupDim);
-    uint uGridY = (uint)ceilf((float)aoData.m_OutputSize.y / m_DeinterleaveGroupDim);
+    uint permutation = AOFX_AO_PERMUTATION(desc.m_LayerProcess[target], desc.m_NormalOption[target], desc.m_TapType[target], desc.m_SampleCount[target]);
+    ID3D11ComputeShader* pAmbientOcclusionCS = m_csAmbientOcclusion[desc.m_KernelType[target]][permutation];
 
-    desc.m_pDeviceContext->CSSetShader(m_csAmbientOcclusion[desc.m_LayerProcess[target]][desc.m_NormalOption[target]][desc.m_TapType[target]][desc.m_SampleCount[target]], NULL, 0);
+    m_StateCache.CSSetShader(pAmbientOcclusionCS);
 
     desc.m_pDeviceContext->Dispatch(uGridX * deinterleaveSize, uGridY * deinterleaveSize, 1);
 
+    size_t texels = (size_t)scaledWidth * scaledHeight;
+    countPass(uGridX * deinterleaveSize, uGridY * deinterleaveSize, 1, texels, texels * formatSize(m_FormatAO));
+
     ID3D11ShaderResourceView*  pNullSRV[8] = { 0 };
     ID3D11UnorderedAccessView* pNullUAV[8] = { 0 };
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV);
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
 
     return AOFX_RETURN_CODE_SUCCESS;
 }
@@ -807,8 +1693,6 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::psAmbientOcclusion(uint target, const AOFX_De
 {
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
-    AO_Data                   aoData(desc, target);
-
     int deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[target]];
     uint scaledWidth = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[target]), (uint)1);
     uint scaledHeight = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[target]), (uint)1);
@@ -821,37 +1705,19 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::psAmbientOcclusion(uint target, const AOFX_De
     D3D11_RECT*                pNullSR = NULL;
     ID3D11SamplerState*        pSS[] = { m_ssPointClamp, m_ssLinearClamp };
     ID3D11ShaderResourceView*  pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV, m_tbSamplePatternsSRV, m_InputAO[target]._srv };
-    ID3D11Buffer*              pCB[] = { m_cbAOData[target], m_cbSamplePatterns };
-    ID3D11UnorderedAccessView* pUAV[] = { m_AO[target]._uav };
-
-    if (desc.m_MultiResLayerScale[target] < 1.0f)
-        pUAV[0] = m_ResultAO[target]._uav;
-
-    aoData.m_OutputSize.x = deinterleavedScaledWidth;
-    aoData.m_OutputSize.y = deinterleavedScaledHeight;
-    aoData.m_OutputSizeRcp.x = 1.0f / aoData.m_OutputSize.x;
-    aoData.m_OutputSizeRcp.y = 1.0f / aoData.m_OutputSize.y;
+    ID3D11UnorderedAccessView* pUAV[] = { m_ResultAO[target]._uav };
 
-    aoData.m_InputSize.x = scaledWidth;
-    aoData.m_InputSize.y = scaledHeight;
-    aoData.m_InputSizeRcp.x = 2.0f / aoData.m_InputSize.x; // we are actually passing 2.0 * 1 / m_InputSize 
-    aoData.m_InputSizeRcp.y = 2.0f / aoData.m_InputSize.y; // because the shader always does 2.0 * 1 / InputSize
+    setConstants(CONSTANT_BLOCK_AMBIENT_OCCLUSION + target, false);
+    m_StateCache.PSSetConstantBuffers(1, 1, &m_cbSamplePatterns);
 
-    assert(sizeof(m_aoData[target]) == sizeof(aoData));
-    if ( 0 != memcmp(&m_aoData[target], &aoData, sizeof(m_aoData[target])))
-    {
-        D3D11_MAPPED_SUBRESOURCE mappedResource;
-        desc.m_pDeviceContext->Map(m_cbAOData[target], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        memcpy(mappedResource.pData, &aoData, sizeof(aoData));
-        desc.m_pDeviceContext->Unmap(m_cbAOData[target], 0);
-        memcpy(&m_aoData[target], &aoData, sizeof(m_aoData[target]));
-    }
+    uint permutation = AOFX_AO_PERMUTATION(desc.m_LayerProcess[target], desc.m_NormalOption[target], desc.m_TapType[target], desc.m_SampleCount[target]);
+    ID3D11PixelShader* pAmbientOcclusionPS = m_psAmbientOcclusion[desc.m_KernelType[target]][permutation];
 
-    HRESULT hr = AMD::RenderFullscreenPass(desc.m_pDeviceContext, VP,
+    HRESULT hr = AMD::RenderFullscreenPass(m_StateCache, VP,
                                            m_vsFullscreen,
-                                           m_psAmbientOcclusion[desc.m_LayerProcess[target]][desc.m_NormalOption[target]][desc.m_TapType[target]][desc.m_SampleCount[target]],
+                                           pAmbientOcclusionPS,
                                            pNullSR, 0,
-                                           pCB, AMD_ARRAY_SIZE(pCB),
+                                           NULL, 0,
                                            pSS, AMD_ARRAY_SIZE(pSS),
                                            pSRV, AMD_ARRAY_SIZE(pSRV),
                                            NULL, 0,
@@ -859,10 +1725,12 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::psAmbientOcclusion(uint target, const AOFX_De
                                            NULL, NULL, 0,
                                            m_bsOutputChannel[15], m_rsNoCulling);
 
+    size_t texels = (size_t)scaledWidth * scaledHeight;
+    countPass((uint)VP.Width, (uint)VP.Height, 1, texels, texels * formatSize(m_FormatAO));
+
     return hr == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_FAIL;
 }
 
-
   //-------------------------------------------------------------------------------------------------
   // 
   //-------------------------------------------------------------------------------------------------
@@ -873,96 +1741,87 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::csBlurAO(uint target, const AOFX_Desc & desc)
     // this part may be confusing to the observer
     // if all AO layers had the same blur radius, then csBlurAO will have a custom behaviour
     // - it expects input in Dilate.srv
-    // - it will use AO[0] layer parameters such as Blur Radius (which is ok, all radiuses are equal) and aoInputData
-    // - and it will use AO[0] resource as intermidiate buffer
-    // otherwise it will just blur the 'target' layer
-    // TODO : actually layer '0' may be disabled so using this layer is not safe
-    uint selectTarget = target != m_MultiResLayerCount ? target : 0;
-
-    AO_InputData aoInputData(desc, selectTarget);
-
-    aoInputData.m_OutputSize.x = desc.m_InputSize.x;
-    aoInputData.m_OutputSize.y = desc.m_InputSize.y;
-    aoInputData.m_OutputSizeRcp.x = 1.0f / aoInputData.m_OutputSize.x;
-    aoInputData.m_OutputSizeRcp.y = 1.0f / aoInputData.m_OutputSize.y;
-    aoInputData.m_InputSize.x = desc.m_InputSize.x;
-    aoInputData.m_InputSize.y = desc.m_InputSize.y;
-    aoInputData.m_InputSizeRcp.x = 1.0f / aoInputData.m_InputSize.x;
-    aoInputData.m_InputSizeRcp.y = 1.0f / aoInputData.m_InputSize.y;
-
-    assert(sizeof(m_aoBilateralBlurData[selectTarget]) == sizeof(aoInputData));
-    if (0 != memcmp(&m_aoBilateralBlurData[selectTarget], &aoInputData, sizeof(m_aoBilateralBlurData[selectTarget])))
+    // - it will use the first active layer parameters such as Blur Radius (which is ok, all radiuses are equal)
+    // - and it will write the result back to Dilate
+    // otherwise it will just blur the 'target' layer, both passes at the resolution of layerAO():
+    // - the horizontal pass reads layerAO() and writes BlurAO, or BlurLayerAO for a downscaled layer
+    // - the vertical pass reads that intermediate and writes the layer back into layerAO(), where the dilate pass picks it up
+    uint selectTarget = target;
+    if (target == m_MultiResLayerCount)
     {
-        D3D11_MAPPED_SUBRESOURCE mappedResource;
-        desc.m_pDeviceContext->Map(m_cbBilateralBlurData[selectTarget], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        memcpy(mappedResource.pData, &aoInputData, sizeof(aoInputData));
-        desc.m_pDeviceContext->Unmap(m_cbBilateralBlurData[selectTarget], 0);
-        memcpy(&m_aoBilateralBlurData[selectTarget], &aoInputData, sizeof(aoInputData));
+        for (selectTarget = 0; selectTarget < m_MultiResLayerCount - 1; selectTarget++)
+            if (desc.m_LayerProcess[selectTarget] != AOFX_LAYER_PROCESS_NONE) break;
     }
 
+    uint2 fullSize;
+    fullSize.x = desc.m_InputSize.x;
+    fullSize.y = desc.m_InputSize.y;
+    uint2 outputSize = layerSize(desc, selectTarget);
+
     ID3D11ShaderResourceView*  pNullSRV[8] = { 0 };
     ID3D11UnorderedAccessView* pNullUAV[8] = { 0 };
-    ID3D11ShaderResourceView*  pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV, m_AO[selectTarget]._srv };
-    ID3D11Buffer*              pCB[] = { m_cbBilateralBlurData[selectTarget] };
-    ID3D11UnorderedAccessView* pUAV[] = { m_DilateAO._uav };
-
-    if (desc.m_MultiResLayerScale[selectTarget] < 1.0)
-        pSRV[2] = m_ResultAO[selectTarget]._srv;
+    AMD::Texture2D & layer = layerAO(selectTarget, desc);
+    AMD::Texture2D & intermediate = downscaledLayer(desc, selectTarget) ? m_BlurLayerAO[selectTarget] : m_BlurAO;
+    ID3D11ShaderResourceView*  pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV, layer._srv };
+    ID3D11UnorderedAccessView* pUAV[] = { intermediate._uav };
 
     // override defult behaviour if target == m_MultiResLayerCount
     // this indicates that all layers have already been dilated
     if (target == m_MultiResLayerCount)
     {
         pSRV[2] = m_DilateAO._srv;
-        pUAV[0] = m_AO[selectTarget]._uav;
+        pUAV[0] = m_BlurAO._uav;
+        outputSize = fullSize;
     }
 
     UINT uX, uY, uZ = 1;
 
-    // Horizontal blur
-    desc.m_pDeviceContext->CSSetConstantBuffers(0, AMD_ARRAY_SIZE(pCB), pCB);
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
+    // Horizontal blur, the constants of the blended blur live in the block after the layers
+    setConstants(CONSTANT_BLOCK_BLUR + target, true);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
 
-#if USE_NEW_BLUR_PROTOTYPE 
-    desc.m_pDeviceContext->CSSetShader(m_csBilateralBlurHorizontal[desc.m_BilateralBlurRadius[selectTarget]], NULL, 0);
-    uX = (int)ceilf((float)desc.m_InputSize.x / m_BilateralGroupDim);
-    uY = (int)ceilf((float)desc.m_InputSize.y / m_BilateralGroupDim);
+#if USE_NEW_BLUR_PROTOTYPE
+    m_StateCache.CSSetShader(m_csBilateralBlurHorizontal[desc.m_BilateralBlurRadius[selectTarget]]);
+    uX = (int)ceilf((float)outputSize.x / m_BilateralGroupDim);
+    uY = (int)ceilf((float)outputSize.y / m_BilateralGroupDim);
 #else
-    desc.m_pDeviceContext->CSSetShader(m_csBilateralBlurH[desc.m_BilateralBlurRadius[selectTarget]], NULL, 0);
-    uX = (int)ceilf((float)desc.m_InputSize.x / m_BlurGroupSize);
-    uY = (int)ceilf((float)desc.m_InputSize.y / m_BlurGroupLines);
+    m_StateCache.CSSetShader(m_csBilateralBlurH[desc.m_BilateralBlurRadius[selectTarget]]);
+    uX = (int)ceilf((float)outputSize.x / m_BlurGroupSize);
+    uY = (int)ceilf((float)outputSize.y / m_BlurGroupLines);
 #endif
 
     desc.m_pDeviceContext->Dispatch(uX, uY, uZ);
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
+    countPass(uX, uY, uZ, (size_t)outputSize.x * outputSize.y, (size_t)outputSize.x * outputSize.y * formatSize(m_FormatAO));
 
     // Vertical pass
-    pUAV[0] = m_AO[selectTarget]._uav;
-    pSRV[2] = m_DilateAO._srv;
+    pUAV[0] = layer._uav;
+    pSRV[2] = intermediate._srv;
 
     // Again, override defult behaviour if target == m_MultiResLayerCount
     if (target == m_MultiResLayerCount)
     {
-        pSRV[2] = m_AO[selectTarget]._srv;
         pUAV[0] = m_DilateAO._uav;
+        pSRV[2] = m_BlurAO._srv;
     }
 
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
-#if USE_NEW_BLUR_PROTOTYPE 
-    desc.m_pDeviceContext->CSSetShader(m_csBilateralBlurVertical[desc.m_BilateralBlurRadius[selectTarget]], NULL, 0);
-    uX = (int)ceilf((float)desc.m_InputSize.x / m_BilateralGroupDim);
-    uY = (int)ceilf((float)desc.m_InputSize.y / m_BilateralGroupDim);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
+#if USE_NEW_BLUR_PROTOTYPE
+    m_StateCache.CSSetShader(m_csBilateralBlurVertical[desc.m_BilateralBlurRadius[selectTarget]]);
+    uX = (int)ceilf((float)outputSize.x / m_BilateralGroupDim);
+    uY = (int)ceilf((float)outputSize.y / m_BilateralGroupDim);
 #else
-    desc.m_pDeviceContext->CSSetShader(m_csBilateralBlurV[desc.m_BilateralBlurRadius[selectTarget]], NULL, 0);
-    uX = (int)ceilf((float)desc.m_InputSize.x / m_BlurGroupLines);
-    uY = (int)ceilf((float)desc.m_InputSize.y / m_BlurGroupSize);
+    m_StateCache.CSSetShader(m_csBilateralBlurV[desc.m_BilateralBlurRadius[selectTarget]]);
+    uX = (int)ceilf((float)outputSize.x / m_BlurGroupLines);
+    uY = (int)ceilf((float)outputSize.y / m_BlurGroupSize);
 #endif
 
     desc.m_pDeviceContext->Dispatch(uX, uY, uZ);
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pNullUAV), pNullUAV, NULL);
+    countPass(uX, uY, uZ, (size_t)outputSize.x * outputSize.y, (size_t)outputSize.x * outputSize.y * formatSize(m_FormatAO));
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV);
 
     return AOFX_RETURN_CODE_SUCCESS;
 }
@@ -974,66 +1833,48 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::csBlur(uint target, const AOFX_Desc & desc)
 {
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
-    AO_InputData aoInputData(desc, target);
-
-    aoInputData.m_OutputSize.x = desc.m_InputSize.x;
-    aoInputData.m_OutputSize.y = desc.m_InputSize.y;
-    aoInputData.m_OutputSizeRcp.x = 1.0f / aoInputData.m_OutputSize.x;
-    aoInputData.m_OutputSizeRcp.y = 1.0f / aoInputData.m_OutputSize.y;
-    aoInputData.m_InputSize.x = desc.m_InputSize.x;
-    aoInputData.m_InputSize.y = desc.m_InputSize.y;
-    aoInputData.m_InputSizeRcp.x = 1.0f / aoInputData.m_InputSize.x;
-    aoInputData.m_InputSizeRcp.y = 1.0f / aoInputData.m_InputSize.y;
-
-    assert(sizeof(m_aoBilateralBlurData[target]) == sizeof(aoInputData));
-    if (0 != memcmp(&m_aoBilateralBlurData[target], &aoInputData, sizeof(m_aoBilateralBlurData[target])))
-    {
-        D3D11_MAPPED_SUBRESOURCE mappedResource;
-        desc.m_pDeviceContext->Map(m_cbBilateralBlurData[target], 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-        memcpy(mappedResource.pData, &aoInputData, sizeof(aoInputData));
-        desc.m_pDeviceContext->Unmap(m_cbBilateralBlurData[target], 0);
-        memcpy(&m_aoBilateralBlurData[target], &aoInputData, sizeof(aoInputData));
-    }
+    uint2 outputSize;
+    outputSize.x = desc.m_InputSize.x;
+    outputSize.y = desc.m_InputSize.y;
 
     ID3D11SamplerState*        pSS[] = { m_ssPointClamp, m_ssLinearClamp };
-    ID3D11ShaderResourceView*  pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV, m_AO[target]._srv };
-    ID3D11Buffer*              pCB[] = { m_cbBilateralBlurData[target], m_cbSamplePatterns };
+    ID3D11ShaderResourceView*  pSRV[] = { desc.m_pDepthSRV, desc.m_pNormalSRV, m_ResultAO[target]._srv };
     ID3D11UnorderedAccessView* pUAV[] = { m_DilateAO._uav };
 
-    if (desc.m_MultiResLayerScale[target] < 1.0)
-        pSRV[2] = m_ResultAO[target]._srv;
+    m_StateCache.CSSetSamplers(0, AMD_ARRAY_SIZE(pSS), pSS);
+    setConstants(CONSTANT_BLOCK_BLUR + target, true);
+    m_StateCache.CSSetConstantBuffers(1, 1, &m_cbSamplePatterns);
+    m_StateCache.CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
+    m_StateCache.CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
 
-    desc.m_pDeviceContext->CSSetSamplers(0, AMD_ARRAY_SIZE(pSS), pSS);
-    desc.m_pDeviceContext->CSSetConstantBuffers(0, AMD_ARRAY_SIZE(pCB), pCB);
-    desc.m_pDeviceContext->CSSetShaderResources(0, AMD_ARRAY_SIZE(pSRV), pSRV);
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, AMD_ARRAY_SIZE(pUAV), pUAV, NULL);
-
-    desc.m_pDeviceContext->CSSetShader(m_csBilateralBlurUpsampling[desc.m_BilateralBlurRadius[target]], NULL, 0);
+    m_StateCache.CSSetShader(m_csBilateralBlurUpsampling[desc.m_BilateralBlurRadius[target]]);
     UINT uX = (int)ceilf((float)desc.m_InputSize.x / m_BilateralGroupDim);
     UINT uY = (int)ceilf((float)desc.m_InputSize.y / m_BilateralGroupDim);
     UINT uZ = 1;
 
     desc.m_pDeviceContext->Dispatch(uX, uY, uZ);
+    countPass(uX, uY, uZ, (size_t)outputSize.x * outputSize.y, (size_t)outputSize.x * outputSize.y * formatSize(m_FormatAO));
 
     ID3D11ShaderResourceView*  pNullSRV[8] = { 0 };
     ID3D11UnorderedAccessView* pNullUAV[8] = { 0 };
-    desc.m_pDeviceContext->CSSetUnorderedAccessViews(0, 1, pNullUAV, NULL);
-    desc.m_pDeviceContext->CSSetShaderResources(0, 3, pNullSRV);
+    m_StateCache.CSSetUnorderedAccessViews(0, 1, pNullUAV, NULL);
+    m_StateCache.CSSetShaderResources(0, 3, pNullSRV);
 
     return AOFX_RETURN_CODE_SUCCESS;
 }
 
 //-------------------------------------------------------------------------------------------------
 // 
-//-------------------------------------------------------------------------------------------------  
+//-------------------------------------------------------------------------------------------------
 AOFX_RETURN_CODE  AOFX_OpaqueDesc::psDilateMultiResAO(const AOFX_Desc & desc)
 {
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
     CD3D11_VIEWPORT vpFullscreen(0.0f, 0.0f, (float)desc.m_InputSize.x, (float)desc.m_InputSize.y, 0.0f, 1.0f);
 
+    // layers are read at the resolution of layerAO(), downscaled layers left there are upsampled by the dilate shader itself
     ID3D11RenderTargetView*   pRTV[] = { m_DilateAO._rtv };
-    ID3D11ShaderResourceView* pSRV[] = { m_AO[0]._srv, m_AO[1]._srv, m_AO[2]._srv,
+    ID3D11ShaderResourceView* pSRV[] = { layerAO(0, desc)._srv, layerAO(1, desc)._srv, layerAO(2, desc)._srv,
       m_InputAO[0]._srv, m_InputAO[1]._srv, m_InputAO[2]._srv, desc.m_pDepthSRV };
     ID3D11SamplerState*       pSS[] = { m_ssPointClamp, m_ssLinearClamp };
 
@@ -1043,19 +1884,22 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::psDilateMultiResAO(const AOFX_Desc & desc)
       desc.m_LayerProcess[2] != AOFX_LAYER_PROCESS_NONE
     };
 
-    S_DILATE_DATA dilate_data;
+    const S_DILATE_DATA & dilate_data = *(const S_DILATE_DATA *)&m_Constants[CONSTANT_BLOCK_DILATE];
+    int upsample = 0;
     for (int i = 0; i != m_MultiResLayerCount; ++i)
-    {
-        dilate_data.m_PowIntensity.v[i] = desc.m_PowIntensity[i];
-    }
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    desc.m_pDeviceContext->Map(m_cbDilateData, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
-    memcpy(mappedResource.pData, &dilate_data, sizeof(S_DILATE_DATA));
-    desc.m_pDeviceContext->Unmap(m_cbDilateData, 0);
-    
-    HRESULT hr = AMD::RenderFullscreenPass(desc.m_pDeviceContext,
-                                           vpFullscreen, m_vsFullscreen, m_psDilate[active[0]][active[1]][active[2]],
-                                           NULL, 0, &m_cbDilateData, 1,
+        upsample |= dilate_data.m_DepthUpsampleThreshold.v[i] > 0.0f;
+
+    // without the depth aware permutations downscaled layers were upsampled by psUpsampleAO
+    uint permutation = AOFX_DILATE_PERMUTATION(active[0], active[1], active[2]);
+    ID3D11PixelShader* pDilatePS = m_psDilate[upsample][permutation];
+    if (pDilatePS == NULL)
+        pDilatePS = m_psDilate[0][permutation];
+
+    setConstants(CONSTANT_BLOCK_DILATE, false);
+
+    HRESULT hr = AMD::RenderFullscreenPass(m_StateCache,
+                                           vpFullscreen, m_vsFullscreen, pDilatePS,
+                                           NULL, 0, NULL, 0,
                                            pSS, AMD_ARRAY_SIZE(pSS),
                                            pSRV, AMD_ARRAY_SIZE(pSRV),
                                            pRTV, AMD_ARRAY_SIZE(pRTV),
@@ -1063,39 +1907,40 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::psDilateMultiResAO(const AOFX_Desc & desc)
                                            NULL, NULL, 0, m_bsOutputChannel[0xf],
                                            m_rsNoCulling);
 
+    size_t texels = (size_t)desc.m_InputSize.x * desc.m_InputSize.y;
+    countPass(desc.m_InputSize.x, desc.m_InputSize.y, 1, texels, texels * formatSize(m_FormatAO));
+
     return (hr == S_OK) ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_FAIL;
 }
 
 //-------------------------------------------------------------------------------------------------
-// 
+// Point samples layer 'target' into its full resolution m_UpsampleAO surface
 //-------------------------------------------------------------------------------------------------
 AOFX_RETURN_CODE  AOFX_OpaqueDesc::psUpsampleAO(uint target, const AOFX_Desc & desc)
 {
-
     AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
 
     CD3D11_VIEWPORT vpFullscreen(0.0f, 0.0f, (float)desc.m_InputSize.x, (float)desc.m_InputSize.y, 0.0f, 1.0f);
 
-    ID3D11Buffer*             pCB[] = { m_cbAOInputData[target] };
-    ID3D11RenderTargetView*   pRTV[] = { m_AO[target]._rtv };
+    ID3D11RenderTargetView*   pRTV[] = { m_UpsampleAO[target]._rtv };
     ID3D11ShaderResourceView* pSRV[] = { desc.m_pDepthSRV, m_InputAO[target]._srv, m_ResultAO[target]._srv };
     ID3D11SamplerState*       pSS[] = { m_ssPointClamp, m_ssLinearClamp };
 
-    HRESULT hr = AMD::RenderFullscreenPass(desc.m_pDeviceContext,
-                              vpFullscreen, m_vsFullscreen, m_psUpscale,
-                              NULL, 0,
-                              pCB, AMD_ARRAY_SIZE(pCB),
-                              pSS, AMD_ARRAY_SIZE(pSS),
-                              pSRV, AMD_ARRAY_SIZE(pSRV),
-                              pRTV, AMD_ARRAY_SIZE(pRTV),
-                              NULL, 0, 0,
-                              NULL, NULL, 0, m_bsOutputChannel[0xf],
-                              m_rsNoCulling);
-    
-    return (hr == S_OK) ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_FAIL;
-}
+    HRESULT hr = AMD::RenderFullscreenPass(m_StateCache,
+                                           vpFullscreen, m_vsFullscreen, m_psUpsample,
+                                           NULL, 0, NULL, 0,
+                                           pSS, AMD_ARRAY_SIZE(pSS),
+                                           pSRV, AMD_ARRAY_SIZE(pSRV),
+                                           pRTV, AMD_ARRAY_SIZE(pRTV),
+                                           NULL, 0, 0,
+                                           NULL, NULL, 0, m_bsOutputChannel[0xf],
+                                           m_rsNoCulling);
 
+    size_t texels = (size_t)desc.m_InputSize.x * desc.m_InputSize.y;
+    countPass(desc.m_InputSize.x, desc.m_InputSize.y, 1, texels, texels * formatSize(m_FormatAO));
 
+    return (hr == S_OK) ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_FAIL;
+}
 
 //-------------------------------------------------------------------------------------------------
 // 
@@ -1117,76 +1962,103 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::render(const AOFX_Desc & desc)
     if (desc.m_InputSize.x == 0 || 
         desc.m_InputSize.y == 0)
         return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    if (!kernelAvailable(desc.m_LayerProcess, desc.m_KernelType) || !viewportAvailable(desc))
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+    // the viewport has to fit the surfaces allocated by the last AOFX_Resize
+    if (viewportScaled(desc) &&
+        (desc.m_InputSize.x > m_Resolution.x || desc.m_InputSize.y > m_Resolution.y))
+        return AOFX_RETURN_CODE_INVALID_ARGUMENT;
+
+    // permutations missing in AOFX_SHADER_CREATION_ON_DEMAND mode are created before any state is bound
+    AOFX_RETURN_CODE result = requireShaders(desc);
+    if (result != AOFX_RETURN_CODE_SUCCESS)
+        return result;
+
+    // constants bound by offset need the D3D11.1 interface, the cache keeps no reference to it
+    ID3D11DeviceContext1 * pDeviceContext1 = NULL;
+    if (m_cbConstantRing != NULL)
+    {
+        if (desc.m_pDeviceContext->QueryInterface(__uuidof(ID3D11DeviceContext1), (void**)&pDeviceContext1) != S_OK)
+            return AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT;
+        pDeviceContext1->Release();
+    }
+
+    m_StateCache.Reset(desc.m_pDeviceContext, pDeviceContext1);
+
+    prepareConstants(desc);
+    uploadConstants(desc);
 
     // Down sample depth and normals
     for (int i = 0; i < m_MultiResLayerCount; ++i)
     {
         if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+        beginStage(desc, AOFX_STAGE_PROCESS_INPUT, i);
         if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_PS)
             psProcessInput(i, desc);
         if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_CS)
             csProcessInput(i, desc);
+        endStage(desc);
     }
 
     for (int i = 0; i < m_MultiResLayerCount; ++i)
     {
         if (desc.m_LayerProcess[i] == AOFX_LAYER_PROCESS_NONE) continue;
+        beginStage(desc, AOFX_STAGE_AMBIENT_OCCLUSION, i);
         if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_CS)
             csAmbientOcclusion(i, desc);
         if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_PS)
             psAmbientOcclusion(i, desc);
+        endStage(desc);
 
 #if USE_NEW_BLUR_PROTOTYPE
+        beginStage(desc, AOFX_STAGE_BLUR, i);
         csBlur(i, desc);
+        endStage(desc);
 #endif
     }
 
 #if !USE_NEW_BLUR_PROTOTYPE
     // Need to check if all layers have the same blur radius (and that the blur radius != NONE
-    bool separateBlur = false;
-    bool active[m_MultiResLayerCount];
-    int  blurRadius[m_MultiResLayerCount];
     int  blurRadiusResult = AOFX_BILATERAL_BLUR_RADIUS_NONE;
+    bool blurLayers = separateBlur(desc, blurRadiusResult);
 
+    // without the depth aware dilate permutations downscaled layers are upsampled before they are blurred and blended
     for (int i = 0; i < m_MultiResLayerCount; ++i)
     {
-        active[i] = desc.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE;
-        blurRadius[i] = active[i] ? desc.m_BilateralBlurRadius[i] : AOFX_BILATERAL_BLUR_RADIUS_NONE;
-        blurRadiusResult = MAX(blurRadiusResult, blurRadius[i]);
-    }
-    for (int i = 0; i < m_MultiResLayerCount; ++i)
-    {
-        separateBlur = separateBlur || (active[i] && active[(i + 1) % m_MultiResLayerCount] && blurRadius[i] != blurRadius[(i + 1) % m_MultiResLayerCount]);
-    }
-
-    // Upsample all downscaled AO layers
-    for (int i = 0; i < m_MultiResLayerCount; ++i)
-    {
-        if (desc.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE &&
-            desc.m_MultiResLayerScale[i] < 1.0f)
-            psUpsampleAO(i, desc); // this should be a fancier upsampling kernel compared to current bilinear
+        if (!upsampledLayer(desc, i)) continue;
+        beginStage(desc, AOFX_STAGE_UPSAMPLE, i);
+        psUpsampleAO(i, desc);
+        endStage(desc);
     }
 
     // if each layer has a different blur radius, AO layers need to be blurred before blended 
-    if (separateBlur == true)
+    if (blurLayers == true)
     {
         for (int i = 0; i < m_MultiResLayerCount; ++i)
         {
             if (desc.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE &&
                 desc.m_BilateralBlurRadius[i] != AOFX_BILATERAL_BLUR_RADIUS_NONE)
+            {
+                beginStage(desc, AOFX_STAGE_BLUR, i);
                 csBlurAO(i, desc);
+                endStage(desc);
+            }
         }
     }
 
-    // blend AO layers together using dilate (min) filter
+    // blend AO layers together using dilate (min) filter, this also upsamples downscaled layers
+    beginStage(desc, AOFX_STAGE_DILATE, m_MultiResLayerCount);
     psDilateMultiResAO(desc);
+    endStage(desc);
 
     // if all layers had the same blur radius, previous blur passes were skipped 
     // and the dilated image can be blurred just once
-    if (separateBlur == false &&
+    if (blurLayers == false &&
         blurRadiusResult != AOFX_BILATERAL_BLUR_RADIUS_NONE)
     {
+        beginStage(desc, AOFX_STAGE_BLUR, m_MultiResLayerCount);
         csBlurAO(m_MultiResLayerCount, desc);
+        endStage(desc);
     }
 #endif
 
@@ -1194,7 +2066,9 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::render(const AOFX_Desc & desc)
     CD3D11_VIEWPORT vpFullscreen(0.0f, 0.0f, (float)desc.m_InputSize.x, (float)desc.m_InputSize.y);
     ID3D11SamplerState* pSS[] = { m_ssPointClamp, m_ssLinearClamp };
 
-    HRESULT hr = AMD::RenderFullscreenPass(desc.m_pDeviceContext,
+    beginStage(desc, AOFX_STAGE_OUTPUT, m_MultiResLayerCount);
+
+    HRESULT hr = AMD::RenderFullscreenPass(m_StateCache,
                                            vpFullscreen, m_vsFullscreen, m_psOutput,
                                            NULL, 0, NULL, 0,
                                            pSS, AMD_ARRAY_SIZE(pSS),
@@ -1204,7 +2078,355 @@ AOFX_RETURN_CODE  AOFX_OpaqueDesc::render(const AOFX_Desc & desc)
                                            NULL, NULL, 0, pOutputBS,
                                            m_rsNoCulling);
 
+    // the application render target format is not known here, only the texel count is reported for the output pass
+    countPass(desc.m_InputSize.x, desc.m_InputSize.y, 1, (size_t)desc.m_InputSize.x * desc.m_InputSize.y, 0);
+    endStage(desc);
+
     return hr == S_OK ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_FAIL;
 }
 
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::getMemoryUsage(AOFX_MemoryUsage & usage) const
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    usage.m_DilateAO = surfaceSize(m_DilateAO, m_FormatAO);
+    usage.m_BlurAO = surfaceSize(m_BlurAO, m_FormatAO);
+    usage.m_Total = usage.m_DilateAO + usage.m_BlurAO;
+
+    for (int i = 0; i < m_MultiResLayerCount; i++)
+    {
+        DXGI_FORMAT inputFormat = m_NormalOption[i] == AOFX_NORMAL_OPTION_READ_FROM_SRV ? m_FormatDepthNormal : m_FormatDepth;
+
+        usage.m_ResultAO[i] = surfaceSize(m_ResultAO[i], m_FormatAO);
+        usage.m_InputAO[i] = surfaceSize(m_InputAO[i], inputFormat);
+        usage.m_UpsampleAO[i] = surfaceSize(m_UpsampleAO[i], m_FormatAO);
+        usage.m_BlurLayerAO[i] = surfaceSize(m_BlurLayerAO[i], m_FormatAO);
+        usage.m_Total += usage.m_ResultAO[i] + usage.m_InputAO[i] + usage.m_UpsampleAO[i] + usage.m_BlurLayerAO[i];
+    }
+
+    usage.m_Buffers = 0;
+    if (m_cbSamplePatterns != NULL)
+    {
+        usage.m_Buffers += sizeof(CB_SAMPLEPATTERN_ROT_SINT4) + sizeof(CB_SAMPLEPATTERN_ROT_SBYTE2);
+        usage.m_Buffers += CONSTANT_BLOCK_COUNT * m_ConstantBlockSize;
+        usage.m_Buffers += sizeof(CB_BILATERAL_DILATE);
+    }
+    usage.m_Total += usage.m_Buffers;
+}
+
+//-------------------------------------------------------------------------------------------------
+// One separable bilateral blur pass (csBilateralBlurH / csBilateralBlurV): each group filters
+// m_BlurGroupLines runs of m_BlurGroupSize texels and loads the runs plus the kernel apron into LDS.
+// The approximate filter steps 2 texels per bilinear tap, so a texel reads 1 + radius taps
+//-------------------------------------------------------------------------------------------------
+static void estimateBlurPass(AOFX_StageCost & cost, AOFX_OpaqueDesc::uint2 outputSize, bool vertical, int radius, size_t aoSize)
+{
+    const size_t runSize = AOFX_OpaqueDesc::m_BlurGroupSize;
+    const size_t runLines = AOFX_OpaqueDesc::m_BlurGroupLines;
+    const size_t kernelRadius = (size_t)2 << radius;
+    const size_t depthSize = 4;
+
+    size_t uX = (size_t)ceilf((float)outputSize.x / (vertical ? runLines : runSize));
+    size_t uY = (size_t)ceilf((float)outputSize.y / (vertical ? runSize : runLines));
+    size_t texels = (size_t)outputSize.x * outputSize.y;
+    size_t ldsLoads = uX * uY * runLines * (runSize + 2 * kernelRadius);
+
+    cost.m_Passes++;
+    cost.m_ThreadGroups += uX * uY;
+    cost.m_TexelsProcessed += texels;
+    cost.m_Taps += texels * (1 + kernelRadius);
+    cost.m_LdsLoads += ldsLoads;
+    cost.m_BytesRead += ldsLoads * (aoSize + depthSize);
+    cost.m_BytesWritten += texels * aoSize;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+static AOFX_StageCost & addStage(AOFX_CostEstimate & estimate, AOFX_STAGE stage, uint layer)
+{
+    AOFX_StageCost & cost = estimate.m_Stages[estimate.m_StageCount++];
+    cost.m_Stage = stage;
+    cost.m_Layer = layer;
+    return cost;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Mirrors the surface sizes of resize() and the dispatch sizes of render() and its passes
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::estimateCost(const AOFX_Desc & desc, AOFX_CostEstimate & estimate) const
+{
+    AMD_OUTPUT_DEBUG_STRING("CALL: " AMD_FUNCTION_NAME "\n");
+
+    static const size_t valleyCount[AOFX_SAMPLE_COUNT_COUNT] = { 8, 16, 24, 32 };
+    const size_t aoTile = (2 * m_AOGroupDim) * (2 * m_AOGroupDim);
+    const size_t depthSize = 4;
+
+    estimate = AOFX_CostEstimate();
+
+    uint2 fullSize;
+    fullSize.x = desc.m_InputSize.x;
+    fullSize.y = desc.m_InputSize.y;
+    size_t fullTexels = (size_t)fullSize.x * fullSize.y;
+    size_t aoSize = formatSize(m_FormatAO);
+
+    // memory follows the allocated surfaces, the stages only process the viewport
+    uint2 allocSize;
+    allocSize.x = viewportScaled(desc) ? desc.m_MaxInputSize.x : desc.m_InputSize.x;
+    allocSize.y = viewportScaled(desc) ? desc.m_MaxInputSize.y : desc.m_InputSize.y;
+    size_t allocTexels = (size_t)allocSize.x * allocSize.y;
+
+    uint2 scaledSize[m_MultiResLayerCount];
+    size_t inputSize[m_MultiResLayerCount];
+    bool active[m_MultiResLayerCount];
+    uint activeCount = 0;
+
+    AOFX_MemoryUsage & memory = estimate.m_Memory;
+    memory.m_DilateAO = allocTexels * aoSize;
+    memory.m_BlurAO = allocTexels * aoSize;
+
+    for (int i = 0; i < m_MultiResLayerCount; i++)
+    {
+        active[i] = desc.m_LayerProcess[i] != AOFX_LAYER_PROCESS_NONE;
+        if (!active[i]) continue;
+        activeCount++;
+
+        DXGI_FORMAT inputFormat = desc.m_NormalOption[i] == AOFX_NORMAL_OPTION_READ_FROM_SRV ? m_FormatDepthNormal : m_FormatDepth;
+        uint deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[i]];
+        scaledSize[i].x = MAX((uint)(desc.m_InputSize.x * desc.m_MultiResLayerScale[i]), (uint)1);
+        scaledSize[i].y = MAX((uint)(desc.m_InputSize.y * desc.m_MultiResLayerScale[i]), (uint)1);
+        inputSize[i] = formatSize(inputFormat);
+
+        uint allocWidth = MAX((uint)(allocSize.x * desc.m_MultiResLayerScale[i]), (uint)1);
+        uint allocHeight = MAX((uint)(allocSize.y * desc.m_MultiResLayerScale[i]), (uint)1);
+        uint deinterleavedWidth = (uint)ceilf((float)allocWidth / deinterleaveSize);
+        uint deinterleavedHeight = (uint)ceilf((float)allocHeight / deinterleaveSize);
+
+        memory.m_ResultAO[i] = (size_t)allocWidth * allocHeight * aoSize;
+        memory.m_InputAO[i] = (size_t)deinterleavedWidth * deinterleavedHeight * deinterleaveSize * deinterleaveSize * inputSize[i];
+        memory.m_UpsampleAO[i] = upsampledLayer(desc, i) ? allocTexels * aoSize : 0;
+        memory.m_BlurLayerAO[i] = downscaledLayer(desc, i) ? memory.m_ResultAO[i] : 0;
+        memory.m_Total += memory.m_ResultAO[i] + memory.m_InputAO[i] + memory.m_UpsampleAO[i] + memory.m_BlurLayerAO[i];
+    }
+
+    memory.m_Buffers = sizeof(CB_SAMPLEPATTERN_ROT_SINT4) + sizeof(CB_SAMPLEPATTERN_ROT_SBYTE2);
+    memory.m_Buffers += CONSTANT_BLOCK_COUNT * m_ConstantBlockSize;
+    memory.m_Buffers += sizeof(CB_BILATERAL_DILATE);
+    memory.m_Total += memory.m_DilateAO + memory.m_BlurAO + memory.m_Buffers;
+
+    if (activeCount == 0) return;
+
+    // Down sample depth and normals: one input sample per scaled texel, stored once into LDS by the compute path
+    for (int i = 0; i < m_MultiResLayerCount; i++)
+    {
+        if (!active[i]) continue;
+
+        AOFX_StageCost & cost = addStage(estimate, AOFX_STAGE_PROCESS_INPUT, i);
+        size_t deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[i]];
+        size_t inputTaps = desc.m_NormalOption[i] == AOFX_NORMAL_OPTION_READ_FROM_SRV ? 2 : 1;
+        size_t texels = (size_t)scaledSize[i].x * scaledSize[i].y;
+
+        if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_PS)
+        {
+            size_t pixels = (size_t)ceilf((float)scaledSize[i].x / deinterleaveSize) * deinterleaveSize *
+                            (size_t)ceilf((float)scaledSize[i].y / deinterleaveSize) * deinterleaveSize;
+
+            cost.m_Passes++;
+            cost.m_TexelsProcessed += pixels;
+            cost.m_Taps += pixels * inputTaps;
+            cost.m_BytesRead += pixels * inputTaps * depthSize;
+            cost.m_BytesWritten += texels * inputSize[i];
+        }
+        if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_UTILITY_CS)
+        {
+            size_t uX = (size_t)ceilf((float)scaledSize[i].x / m_DeinterleaveGroupDim);
+            size_t uY = (size_t)ceilf((float)scaledSize[i].y / m_DeinterleaveGroupDim);
+            size_t threads = uX * uY * m_DeinterleaveGroupDim * m_DeinterleaveGroupDim;
+
+            cost.m_Passes++;
+            cost.m_ThreadGroups += uX * uY;
+            cost.m_TexelsProcessed += texels;
+            cost.m_Taps += threads * inputTaps;
+            cost.m_LdsLoads += threads;
+            cost.m_BytesRead += threads * inputTaps * depthSize;
+            cost.m_BytesWritten += texels * inputSize[i];
+        }
+    }
+
+    // AO kernels: HDAO reads both sides of every valley, GTAO reads the same number of taps
+    // the compute path caches a tile of (2 * m_AOGroupDim)^2 positions per group, the pixel path reads every tap from the input surface
+    for (int i = 0; i < m_MultiResLayerCount; i++)
+    {
+        if (!active[i]) continue;
+
+        AOFX_StageCost & cost = addStage(estimate, AOFX_STAGE_AMBIENT_OCCLUSION, i);
+        size_t deinterleaveSize = m_DeinterleaveSize[desc.m_LayerProcess[i]];
+        size_t deinterleavedWidth = (size_t)ceilf((float)scaledSize[i].x / deinterleaveSize);
+        size_t deinterleavedHeight = (size_t)ceilf((float)scaledSize[i].y / deinterleaveSize);
+        size_t texels = (size_t)scaledSize[i].x * scaledSize[i].y;
+        size_t taps = texels * (1 + 2 * valleyCount[desc.m_SampleCount[i]]);
+
+        if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_CS)
+        {
+            size_t uX = (size_t)ceilf((float)deinterleavedWidth / m_DeinterleaveGroupDim) * deinterleaveSize;
+            size_t uY = (size_t)ceilf((float)deinterleavedHeight / m_DeinterleaveGroupDim) * deinterleaveSize;
+
+            cost.m_Passes++;
+            cost.m_ThreadGroups += uX * uY;
+            cost.m_TexelsProcessed += texels;
+            cost.m_Taps += taps;
+            cost.m_LdsLoads += uX * uY * aoTile;
+            cost.m_BytesRead += uX * uY * aoTile * inputSize[i];
+            cost.m_BytesWritten += texels * aoSize;
+        }
+        if (desc.m_Implementation & AOFX_IMPLEMENTATION_MASK_KERNEL_PS)
+        {
+            cost.m_Passes++;
+            cost.m_TexelsProcessed += texels;
+            cost.m_Taps += taps;
+            cost.m_BytesRead += taps * inputSize[i];
+            cost.m_BytesWritten += texels * aoSize;
+        }
+    }
+
+    int  blurRadiusResult = AOFX_BILATERAL_BLUR_RADIUS_NONE;
+    bool blurLayers = separateBlur(desc, blurRadiusResult);
+
+    // Upsample: one point sampled tap per full resolution texel of a layer the dilate pass can not upsample
+    for (int i = 0; i < m_MultiResLayerCount; i++)
+    {
+        if (!upsampledLayer(desc, i)) continue;
+
+        AOFX_StageCost & cost = addStage(estimate, AOFX_STAGE_UPSAMPLE, i);
+        cost.m_Passes++;
+        cost.m_TexelsProcessed += fullTexels;
+        cost.m_Taps += fullTexels;
+        cost.m_BytesRead += fullTexels * aoSize;
+        cost.m_BytesWritten += fullTexels * aoSize;
+    }
+
+    if (blurLayers == true)
+    {
+        for (int i = 0; i < m_MultiResLayerCount; i++)
+        {
+            if (!active[i] || desc.m_BilateralBlurRadius[i] == AOFX_BILATERAL_BLUR_RADIUS_NONE) continue;
+
+            AOFX_StageCost & cost = addStage(estimate, AOFX_STAGE_BLUR, i);
+            estimateBlurPass(cost, layerSize(desc, i), false, desc.m_BilateralBlurRadius[i], aoSize);
+            estimateBlurPass(cost, layerSize(desc, i), true, desc.m_BilateralBlurRadius[i], aoSize);
+        }
+    }
+
+    // Dilate: one AO tap per active layer, depth aware upsampling adds the layer position and the pixel depth
+    {
+        AOFX_StageCost & cost = addStage(estimate, AOFX_STAGE_DILATE, m_MultiResLayerCount);
+        size_t upsampleLayers = 0;
+        size_t positionBytes = 0;
+
+#if AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+        for (int i = 0; i < m_MultiResLayerCount; i++)
+        {
+            bool downscaled = scaledSize[i].x != fullSize.x || scaledSize[i].y != fullSize.y;
+            if (active[i] && downscaled && desc.m_DepthUpsampleThreshold[i] > 0.0f)
+            {
+                upsampleLayers++;
+                positionBytes += inputSize[i];
+            }
+        }
+#endif
+
+        size_t taps = activeCount + upsampleLayers + (upsampleLayers > 0 ? 1 : 0);
+
+        cost.m_Passes++;
+        cost.m_TexelsProcessed += fullTexels;
+        cost.m_Taps += fullTexels * taps;
+        cost.m_BytesRead += fullTexels * (activeCount * aoSize + positionBytes + (upsampleLayers > 0 ? depthSize : 0));
+        cost.m_BytesWritten += fullTexels * aoSize;
+    }
+
+    if (blurLayers == false &&
+        blurRadiusResult != AOFX_BILATERAL_BLUR_RADIUS_NONE)
+    {
+        AOFX_StageCost & cost = addStage(estimate, AOFX_STAGE_BLUR, m_MultiResLayerCount);
+        estimateBlurPass(cost, fullSize, false, blurRadiusResult, aoSize);
+        estimateBlurPass(cost, fullSize, true, blurRadiusResult, aoSize);
+    }
+
+    // Output: the application render target format is not known, its writes are not counted
+    {
+        AOFX_StageCost & cost = addStage(estimate, AOFX_STAGE_OUTPUT, m_MultiResLayerCount);
+        cost.m_Passes++;
+        cost.m_TexelsProcessed += fullTexels;
+        cost.m_Taps += fullTexels;
+        cost.m_BytesRead += fullTexels * aoSize;
+    }
+
+    AOFX_StageCost & total = estimate.m_Total;
+    total.m_Layer = m_MultiResLayerCount;
+    for (uint i = 0; i < estimate.m_StageCount; i++)
+    {
+        const AOFX_StageCost & cost = estimate.m_Stages[i];
+        total.m_Passes += cost.m_Passes;
+        total.m_ThreadGroups += cost.m_ThreadGroups;
+        total.m_TexelsProcessed += cost.m_TexelsProcessed;
+        total.m_Taps += cost.m_Taps;
+        total.m_LdsLoads += cost.m_LdsLoads;
+        total.m_BytesRead += cost.m_BytesRead;
+        total.m_BytesWritten += cost.m_BytesWritten;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Stage instrumentation: counters are always accumulated (a few integer adds per pass),
+// callbacks are only invoked when the application provided them
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::beginStage(const AOFX_Desc & desc, AOFX_STAGE stage, uint layer)
+{
+    memset(&m_StageCounters, 0, sizeof(m_StageCounters));
+    m_StageCounters.m_Stage = stage;
+    m_StageCounters.m_Layer = layer;
+    m_StateCache.ResetCounters();
+
+    if (desc.m_pInstrumentation != NULL && desc.m_pInstrumentation->m_pBeginStage != NULL)
+        desc.m_pInstrumentation->m_pBeginStage(stage, layer, desc.m_pDeviceContext, desc.m_pInstrumentation->m_pUserData);
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::endStage(const AOFX_Desc & desc)
+{
+    m_StageCounters.m_StateBinds = m_StateCache.GetMisses();
+    m_StageCounters.m_StateBindsSkipped = m_StateCache.GetHits();
+
+    if (desc.m_pInstrumentation != NULL && desc.m_pInstrumentation->m_pEndStage != NULL)
+        desc.m_pInstrumentation->m_pEndStage(m_StageCounters, desc.m_pDeviceContext, desc.m_pInstrumentation->m_pUserData);
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::countPass(uint x, uint y, uint z, size_t texels, size_t bytes)
+{
+    m_StageCounters.m_Passes++;
+    m_StageCounters.m_DispatchSize[0] = x;
+    m_StageCounters.m_DispatchSize[1] = y;
+    m_StageCounters.m_DispatchSize[2] = z;
+    m_StageCounters.m_TexelsProcessed += texels;
+    m_StageCounters.m_BytesWritten += bytes;
+}
+
+//-------------------------------------------------------------------------------------------------
+// 
+//-------------------------------------------------------------------------------------------------
+void AOFX_OpaqueDesc::countUpload(bool uploaded)
+{
+    if (uploaded)
+        m_StageCounters.m_ConstantBufferUploads++;
+    else
+        m_StageCounters.m_ConstantBufferUploadsSkipped++;
+}
 }
\ No newline at end of file
@@ -25,8 +25,12 @@
 
 #include "AMD_LIB.h"
 #include "AMD_AOFX.h"
+#include "AMD_AOFX_Permutations.h"
 
 #include <math.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 #pragma warning( disable : 4127 ) // disable conditional expression is constant warnings
 
@@ -73,6 +77,27 @@ public:
     static const uint m_BlurGroupSize = 128;
     static const uint m_BlurGroupLines = 2;
 
+    // leading slots written (or cleared) by render(), captured by AOFX_STATE_RESTORE_USED
+    static const uint m_UsedSamplerSlots = 2;
+    static const uint m_UsedConstantBufferSlots = 2;
+    static const uint m_UsedSRVSlots = 8;
+    static const uint m_UsedUAVSlots = 8;
+    static const uint m_UsedVertexBufferSlots = 8;
+
+    // Every pass of render() reads its constants from one block, blocks are allocated linearly every frame.
+    // 256 bytes is the granularity of D3D11.1 constant buffer offsets, so each block can be bound by offset
+    static const uint m_ConstantBlockSize = 256;
+
+    enum CONSTANT_BLOCK
+    {
+        CONSTANT_BLOCK_PROCESS_INPUT_CS = 0,
+        CONSTANT_BLOCK_PROCESS_INPUT_PS = CONSTANT_BLOCK_PROCESS_INPUT_CS + m_MultiResLayerCount,
+        CONSTANT_BLOCK_AMBIENT_OCCLUSION = CONSTANT_BLOCK_PROCESS_INPUT_PS + m_MultiResLayerCount,
+        CONSTANT_BLOCK_BLUR = CONSTANT_BLOCK_AMBIENT_OCCLUSION + m_MultiResLayerCount,  // both blur passes, one more block than layers,
+        CONSTANT_BLOCK_DILATE = CONSTANT_BLOCK_BLUR + m_MultiResLayerCount + 1,          // the last one blurs the blended layers
+        CONSTANT_BLOCK_COUNT,
+    };
+
     // Constant buffer layout for transferring data to the AO shaders
     struct AO_Data
     {
@@ -97,10 +122,12 @@ public:
         float                                 m_ViewDistanceDiscrad;
 
         float                                 m_FadeIntervalLength;
-        float                                 _pad[3];
+        float2                                m_InputUVMax;                 // center of the last input texel in the viewport
+        float                                 _pad;
 
         AO_Data(const AOFX_Desc & desc, unsigned int target)
         {
+            memset(this, 0, sizeof(AO_Data)); // padding included, blocks are compared bytewise before they are uploaded
             float zDistance = (desc.m_Camera.m_FarPlane - desc.m_Camera.m_NearPlane);
             this->m_CameraQ = desc.m_Camera.m_FarPlane / (zDistance); // camera_far_clip / ( camera_far_clip - camera_near_clip );
             this->m_CameraQTimesZNear = this->m_CameraQ * desc.m_Camera.m_NearPlane;                                   // cameraQ * camera_near_clip;
@@ -144,8 +171,12 @@ public:
         float                                 m_ScaleRcp;
         float2                                _pad;
 
+        float2                                m_UVScaleRcp;                 // surface size / viewport size of the sampled surfaces
+        float2                                m_UVMax;                      // center of the last sampled texel in the viewport
+
         AO_InputData(const AOFX_Desc & desc, unsigned int target)
         {
+            memset(this, 0, sizeof(AO_InputData));
             this->m_ZFar = desc.m_Camera.m_FarPlane;
             this->m_ZNear = desc.m_Camera.m_NearPlane;
             float zDistance = (desc.m_Camera.m_FarPlane - desc.m_Camera.m_NearPlane);
@@ -159,6 +190,14 @@ public:
             this->m_DepthUpsampleThreshold = desc.m_DepthUpsampleThreshold[target];
         }
 
+        void setViewportUV(const float4 & uv)
+        {
+            this->m_UVScaleRcp.x = 1.0f / uv.x;
+            this->m_UVScaleRcp.y = 1.0f / uv.y;
+            this->m_UVMax.x = uv.z;
+            this->m_UVMax.y = uv.w;
+        }
+
         AO_InputData()
         {
             memset(this, 0, sizeof(AO_InputData));
@@ -176,21 +215,52 @@ public:
     struct S_DILATE_DATA
     {
         float4                                m_PowIntensity;
+        float4                                m_LayerSize[m_MultiResLayerCount];    // layer size (xy), inv size (zw)
+        float4                                m_DepthUpsampleThreshold;             // 0.0 for layers that are not downscaled
+        float                                 m_CameraQ;
+        float                                 m_CameraQTimesZNear;
+        float                                 _pad[2];
+        float4                                m_LayerUV[m_MultiResLayerCount];      // texture coordinate scale (xy), last texel in the viewport (zw)
+        float4                                m_DepthUV;
+    };
+
+    // shader permutations a configuration renders with, compared as a whole so padding is always cleared
+    struct S_SHADER_CONFIG
+    {
+        AOFX_LAYER_PROCESS                  m_LayerProcess[m_MultiResLayerCount];
+        AOFX_NORMAL_OPTION                  m_NormalOption[m_MultiResLayerCount];
+        AOFX_TAP_TYPE                       m_TapType[m_MultiResLayerCount];
+        AOFX_KERNEL_TYPE                    m_KernelType[m_MultiResLayerCount];
+        AOFX_SAMPLE_COUNT                   m_SampleCount[m_MultiResLayerCount];
+        AOFX_BILATERAL_BLUR_RADIUS          m_BilateralBlurRadius[m_MultiResLayerCount];
+        uint                                m_Implementation;
+        uint                                m_DepthUpsample;
+    };
+
+    // bytecode of one shader permutation, LZ4 compressed when it comes from the shader archive (m_PackedSize != 0)
+    struct S_SHADER_BYTECODE
+    {
+        S_SHADER_BYTECODE(const void * pData, size_t size, size_t packedSize = 0) : m_pData(pData), m_Size(size), m_PackedSize(packedSize) {}
+
+        const void *                        m_pData;                // NULL for permutations that are compiled out
+        size_t                              m_Size;
+        size_t                              m_PackedSize;
     };
 
     // these members store current AO state and are used to optimize constant buffer updates 
     // and AO surface resize routine
     uint2                                   m_Resolution;
 
-    AO_Data                                 m_aoData[m_MultiResLayerCount];
-    AO_InputData                            m_aoInputData[m_MultiResLayerCount];
-    AO_InputData                            m_aoBilateralBlurData[m_MultiResLayerCount];
     AOFX_LAYER_PROCESS                      m_LayerProcess[m_MultiResLayerCount];
     AOFX_NORMAL_OPTION                      m_NormalOption[m_MultiResLayerCount];
     uint2                                   m_ScaledResolution[m_MultiResLayerCount];
 
+    // downscaled layers stay at their own resolution until they are blended by the dilate pass,
+    // without the depth aware dilate permutations they are upsampled into m_UpsampleAO first
     AMD::Texture2D                          m_DilateAO;
-    AMD::Texture2D                          m_AO[m_MultiResLayerCount];
+    AMD::Texture2D                          m_BlurAO;                           // full resolution bilateral blur intermediate
+    AMD::Texture2D                          m_UpsampleAO[m_MultiResLayerCount]; // full resolution copy of a downscaled layer
+    AMD::Texture2D                          m_BlurLayerAO[m_MultiResLayerCount];// layer resolution blur intermediate of a downscaled layer
     AMD::Texture2D                          m_ResultAO[m_MultiResLayerCount];
     AMD::Texture2D                          m_InputAO[m_MultiResLayerCount];
 
@@ -200,12 +270,11 @@ public:
 
     ID3D11VertexShader*                     m_vsFullscreen;
 
-    ID3D11PixelShader*                      m_psUpscale;
-
-    ID3D11ComputeShader*                    m_csProcessInput[AOFX_LAYER_PROCESS_COUNT][AOFX_NORMAL_OPTION_COUNT][AOFX_MSAA_LEVEL_COUNT];
-    ID3D11PixelShader*                      m_psProcessInput[AOFX_LAYER_PROCESS_COUNT][AOFX_NORMAL_OPTION_COUNT][AOFX_MSAA_LEVEL_COUNT];
-    ID3D11ComputeShader*                    m_csAmbientOcclusion[AOFX_LAYER_PROCESS_COUNT][AOFX_NORMAL_OPTION_COUNT][AOFX_TAP_TYPE_COUNT][AOFX_SAMPLE_COUNT_COUNT];
-    ID3D11PixelShader*                      m_psAmbientOcclusion[AOFX_LAYER_PROCESS_COUNT][AOFX_NORMAL_OPTION_COUNT][AOFX_TAP_TYPE_COUNT][AOFX_SAMPLE_COUNT_COUNT];
+    // permutations are indexed like the tables of AMD_AOFX_Precompiled.h, see AMD_AOFX_Permutations.h
+    ID3D11ComputeShader*                    m_csProcessInput[AOFX_PROCESS_INPUT_PERMUTATION_COUNT];
+    ID3D11PixelShader*                      m_psProcessInput[AOFX_PROCESS_INPUT_PERMUTATION_COUNT];
+    ID3D11ComputeShader*                    m_csAmbientOcclusion[AOFX_KERNEL_TYPE_COUNT][AOFX_AO_PERMUTATION_COUNT];
+    ID3D11PixelShader*                      m_psAmbientOcclusion[AOFX_KERNEL_TYPE_COUNT][AOFX_AO_PERMUTATION_COUNT];
 
     // new "prototype" implementation (this is not currently being used by default)
     ID3D11ComputeShader*                    m_csBilateralBlurUpsampling[AOFX_BILATERAL_BLUR_RADIUS_COUNT];
@@ -218,21 +287,47 @@ public:
     ID3D11ComputeShader*                    m_csBilateralBlurH[AOFX_BILATERAL_BLUR_RADIUS_COUNT];
     ID3D11ComputeShader*                    m_csBilateralBlurV[AOFX_BILATERAL_BLUR_RADIUS_COUNT];
 
-    ID3D11PixelShader*                      m_psDilate[2][2][2];
+    ID3D11PixelShader*                      m_psDilate[2][AOFX_DILATE_PERMUTATION_COUNT];     // [depth aware upsampling][AOFX_DILATE_PERMUTATION]
 
+    ID3D11PixelShader*                      m_psUpsample;                       // only created without AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
     ID3D11PixelShader*                      m_psOutput;
 
+    // shaders missing in AOFX_SHADER_CREATION_ON_DEMAND mode are created by render() or by a prewarm thread.
+    // Slots are only written under m_ShaderLock and never cleared while the prewarm thread runs,
+    // so render() reads the slots of m_ShaderConfigReady without locking
+    ID3D11Device*                           m_pDevice;
+    AOFX_SHADER_CREATION                    m_ShaderCreation;
+    S_SHADER_CONFIG                         m_ShaderConfigReady;                // render thread only
+    bool                                    m_ShaderConfigReadyValid;
+    std::mutex                              m_ShaderLock;
+    std::thread                             m_ShaderThread;
+    std::atomic<bool>                       m_ShaderThreadRunning;
+    std::atomic<bool>                       m_ShaderThreadCancel;
+    AOFX_ShaderStats                        m_ShaderStats;                      // guarded by m_ShaderLock
+
     // sample pattern buffer declaration
     ID3D11Buffer*                           m_cbSamplePatterns;
     ID3D11Buffer*                           m_tbSamplePatterns;
     ID3D11ShaderResourceView*               m_tbSamplePatternsSRV;
 
     // Various Constant buffers
-    ID3D11Buffer*                           m_cbAOData[m_MultiResLayerCount];
-    ID3D11Buffer*                           m_cbAOInputData[m_MultiResLayerCount];
-    ID3D11Buffer*                           m_cbBilateralBlurData[m_MultiResLayerCount];
     ID3D11Buffer*                           m_cbBilateralDilate;
-    ID3D11Buffer*                           m_cbDilateData;
+    ID3D11Buffer*                           m_cbConstantRing;                   // all blocks of a frame, NULL without constant buffer offsetting
+    ID3D11Buffer*                           m_cbConstantBlocks[CONSTANT_BLOCK_COUNT];   // one buffer per block when blocks cannot be bound by offset
+
+    // constants of the current frame and the copy last uploaded to the GPU, blocks are compared to skip uploads
+    struct S_CONSTANT_BLOCK
+    {
+        float4                              m_Data[m_ConstantBlockSize / sizeof(float4)];
+    };
+    S_CONSTANT_BLOCK                        m_Constants[CONSTANT_BLOCK_COUNT];
+    S_CONSTANT_BLOCK                        m_ConstantsUploaded[CONSTANT_BLOCK_COUNT];
+    uint                                    m_ConstantOffset[CONSTANT_BLOCK_COUNT];         // in blocks from the start of m_cbConstantRing
+    uint                                    m_ConstantOffsetUploaded[CONSTANT_BLOCK_COUNT];
+    uint                                    m_ConstantBlockCount;                           // blocks allocated this frame
+    uint                                    m_ConstantsUsed;                                // masks of CONSTANT_BLOCK bits
+    uint                                    m_ConstantsChanged;
+    uint                                    m_ConstantsValid;
 
     ID3D11SamplerState*                     m_ssPointClamp;
     ID3D11SamplerState*                     m_ssLinearClamp;
@@ -242,9 +337,19 @@ public:
     ID3D11RasterizerState*                  m_rsNoCulling;
     ID3D11BlendState*                       m_bsOutputChannel[AOFX_OUTPUT_CHANNEL_COUNT];
 
+    // counters of the stage currently being recorded, only reported when AOFX_Desc::m_pInstrumentation is set
+    AOFX_StageCounters                      m_StageCounters;
+
+    // shadow of the state bound by AOFX_Render, reset at the start of every render as the application owns the context in between
+    AMD::C_StateCache                       m_StateCache;
+
     ~AOFX_OpaqueDesc();
     AOFX_OpaqueDesc(const AOFX_Desc & desc);
 
+    static void                             generateSamplePatterns(CB_SAMPLEPATTERN_ROT_SINT4 & cbSamplePattern, CB_SAMPLEPATTERN_ROT_SBYTE2 & t1dSamplePattern);
+    static bool                             requiresResize(const AOFX_QualityLevel & level, const AOFX_Desc & desc);
+    static void                             applyQualityLevel(const AOFX_QualityLevel & level, AOFX_Desc & desc);
+
     AOFX_RETURN_CODE                        cbInitialize(const AOFX_Desc & desc);
     AOFX_RETURN_CODE                        resize(const AOFX_Desc & desc);
 
@@ -259,18 +364,53 @@ public:
     AOFX_RETURN_CODE                        psBlur(uint target, const AOFX_Desc & desc);
     AOFX_RETURN_CODE                        csBlur(uint target, const AOFX_Desc & desc);
 
+    AO_InputData                            processInputData(uint target, const AOFX_Desc & desc, bool pixelShader) const;
+    AO_Data                                 ambientOcclusionData(uint target, const AOFX_Desc & desc) const;
+    AO_InputData                            blurData(uint target, const AOFX_Desc & desc, uint2 outputSize, const float4 & inputUV) const;
+    float4                                  viewportUV(uint target, const AOFX_Desc & desc) const;
+    float4                                  layerUV(uint target, const AOFX_Desc & desc) const;
+    AMD::Texture2D &                        layerAO(uint target, const AOFX_Desc & desc);
+    S_DILATE_DATA                           dilateData(const AOFX_Desc & desc) const;
+
+    void                                    writeConstants(uint block, const void * pData, size_t size);
+    void                                    prepareConstants(const AOFX_Desc & desc);
+    void                                    uploadConstants(const AOFX_Desc & desc);
+    void                                    setConstants(uint block, bool computeShader);
     AOFX_RETURN_CODE                        psUpsampleAO(uint target, const AOFX_Desc & desc);
-
     AOFX_RETURN_CODE                        csBlurAO(uint target, const AOFX_Desc & desc);
     AOFX_RETURN_CODE                        psDilateMultiResAO(const AOFX_Desc & desc);
 
     AOFX_RETURN_CODE                        createShaders(const AOFX_Desc & desc);
+    AOFX_RETURN_CODE                        createShaders(const S_SHADER_CONFIG & config, uint & created);
+    AOFX_RETURN_CODE                        createAllShaders(uint & created);
+    AOFX_RETURN_CODE                        requireShaders(const AOFX_Desc & desc);
+    AOFX_RETURN_CODE                        prewarmShaders(const AOFX_Desc & desc, const AOFX_QualityLevel * pLevels, uint levelCount, bool background);
+    void                                    getShaderStats(AOFX_ShaderStats & stats);
+    void                                    stopShaderThread();
+
+    template <class T>
+    AOFX_RETURN_CODE                        createShader(T ** ppShader, const S_SHADER_BYTECODE & bytecode, uint & created);
+
+    static S_SHADER_CONFIG                  shaderConfig(const AOFX_Desc & desc, const AOFX_QualityLevel * pLevel);
+    static uint                             permutationCount();
+    static bool                             kernelSupported(AOFX_KERNEL_TYPE kernelType);
+
+    void                                    getMemoryUsage(AOFX_MemoryUsage & usage) const;
+    void                                    estimateCost(const AOFX_Desc & desc, AOFX_CostEstimate & estimate) const;
+
+    void                                    beginStage(const AOFX_Desc & desc, AOFX_STAGE stage, uint layer);
+    void                                    endStage(const AOFX_Desc & desc);
+    void                                    countPass(uint x, uint y, uint z, size_t texels, size_t bytes);
+    void                                    countUpload(bool uploaded);
 
     void                                    release();
     void                                    releaseShaders();
     void                                    releaseTextures();
 };
 
+// Null device switch for the pre D3D11.1 constant buffer path, see AMD_AOFX_NULL_DEVICE.cpp
+AOFX_RETURN_CODE                            AOFX_SetNullDeviceConstantBufferOffsetting(ID3D11DeviceContext * pDeviceContext, bool supported);
+
 } // namespace AMD
 
 #endif // __AMD_AOFX_OpaqueDesc_H__
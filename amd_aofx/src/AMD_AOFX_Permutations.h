@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef __AMD_AOFX_PERMUTATIONS_H__
+#define __AMD_AOFX_PERMUTATIONS_H__
+
+// Layout of the shader permutation tables in AMD_AOFX_Precompiled.h.
+// The tables, the shader arrays of AOFX_OpaqueDesc and pack_shaders.py are all indexed with the
+// AOFX_*_PERMUTATION macros below, which only use preprocessor constants so they can be evaluated by #if
+
+// Applications that only render with some of the options can compile AOFX with a subset of the permutations,
+// bit n of a mask enables enum value n. Permutations outside the masks are left out of the shader archive,
+// AOFX_SHADER_CREATION_ALL skips them and rendering with them returns AOFX_RETURN_CODE_INVALID_ARGUMENT
+#ifndef AMD_AOFX_PERMUTATION_LAYER_PROCESS_MASK
+# define AMD_AOFX_PERMUTATION_LAYER_PROCESS_MASK    0xF     // AOFX_LAYER_PROCESS
+#endif
+#ifndef AMD_AOFX_PERMUTATION_NORMAL_OPTION_MASK
+# define AMD_AOFX_PERMUTATION_NORMAL_OPTION_MASK    0x3     // AOFX_NORMAL_OPTION
+#endif
+#ifndef AMD_AOFX_PERMUTATION_TAP_TYPE_MASK
+# define AMD_AOFX_PERMUTATION_TAP_TYPE_MASK         0x7     // AOFX_TAP_TYPE
+#endif
+#ifndef AMD_AOFX_PERMUTATION_SAMPLE_COUNT_MASK
+# define AMD_AOFX_PERMUTATION_SAMPLE_COUNT_MASK     0xF     // AOFX_SAMPLE_COUNT
+#endif
+#ifndef AMD_AOFX_PERMUTATION_BLUR_RADIUS_MASK
+# define AMD_AOFX_PERMUTATION_BLUR_RADIUS_MASK      0xF     // AOFX_BILATERAL_BLUR_RADIUS, AOFX_BILATERAL_BLUR_RADIUS_NONE is always available
+#endif
+
+// dimensions of the tables, checked against the enums of AMD_AOFX.h in AMD_AOFX_OPAQUE.cpp
+#define AOFX_PERMUTATION_LAYER_PROCESS_COUNT        4
+#define AOFX_PERMUTATION_NORMAL_OPTION_COUNT        2
+#define AOFX_PERMUTATION_TAP_TYPE_COUNT             3
+#define AOFX_PERMUTATION_SAMPLE_COUNT_COUNT         4
+#define AOFX_PERMUTATION_MSAA_LEVEL_COUNT           1
+#define AOFX_PERMUTATION_BLUR_RADIUS_COUNT          4
+
+#define AOFX_PERMUTATION_MASK_HAS(MASK, VALUE)      ((((MASK) >> (VALUE)) & 1) != 0)
+
+// CS_AMD_AO, PS_AMD_AO, CS_AMD_GTAO, PS_AMD_GTAO: [layer process][normal option][tap type][sample count]
+#define AOFX_AO_PERMUTATION(LAYER, NORMAL, TAP, SAMPLE) \
+    ((((LAYER) * AOFX_PERMUTATION_NORMAL_OPTION_COUNT + (NORMAL)) * AOFX_PERMUTATION_TAP_TYPE_COUNT + (TAP)) * AOFX_PERMUTATION_SAMPLE_COUNT_COUNT + (SAMPLE))
+#define AOFX_AO_PERMUTATION_COUNT \
+    (AOFX_PERMUTATION_LAYER_PROCESS_COUNT * AOFX_PERMUTATION_NORMAL_OPTION_COUNT * AOFX_PERMUTATION_TAP_TYPE_COUNT * AOFX_PERMUTATION_SAMPLE_COUNT_COUNT)
+#define AOFX_AO_PERMUTATION_ENABLED(INDEX) \
+    (AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_SAMPLE_COUNT_MASK, (INDEX) % AOFX_PERMUTATION_SAMPLE_COUNT_COUNT) && \
+     AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_TAP_TYPE_MASK, (INDEX) / AOFX_PERMUTATION_SAMPLE_COUNT_COUNT % AOFX_PERMUTATION_TAP_TYPE_COUNT) && \
+     AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_NORMAL_OPTION_MASK, (INDEX) / (AOFX_PERMUTATION_SAMPLE_COUNT_COUNT * AOFX_PERMUTATION_TAP_TYPE_COUNT) % AOFX_PERMUTATION_NORMAL_OPTION_COUNT) && \
+     AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_LAYER_PROCESS_MASK, (INDEX) / (AOFX_PERMUTATION_SAMPLE_COUNT_COUNT * AOFX_PERMUTATION_TAP_TYPE_COUNT * AOFX_PERMUTATION_NORMAL_OPTION_COUNT)))
+
+// CS_AO_DEINTERLEAVE, PS_AO_DEINTERLEAVE: [layer process][normal option][msaa level]
+#define AOFX_PROCESS_INPUT_PERMUTATION(LAYER, NORMAL, MSAA) \
+    (((LAYER) * AOFX_PERMUTATION_NORMAL_OPTION_COUNT + (NORMAL)) * AOFX_PERMUTATION_MSAA_LEVEL_COUNT + (MSAA))
+#define AOFX_PROCESS_INPUT_PERMUTATION_COUNT \
+    (AOFX_PERMUTATION_LAYER_PROCESS_COUNT * AOFX_PERMUTATION_NORMAL_OPTION_COUNT * AOFX_PERMUTATION_MSAA_LEVEL_COUNT)
+#define AOFX_PROCESS_INPUT_PERMUTATION_ENABLED(INDEX) \
+    (AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_NORMAL_OPTION_MASK, (INDEX) / AOFX_PERMUTATION_MSAA_LEVEL_COUNT % AOFX_PERMUTATION_NORMAL_OPTION_COUNT) && \
+     AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_LAYER_PROCESS_MASK, (INDEX) / (AOFX_PERMUTATION_MSAA_LEVEL_COUNT * AOFX_PERMUTATION_NORMAL_OPTION_COUNT)))
+
+// PS_AO_DILATE, PS_AO_DILATE_UPSAMPLE: one bit per active layer, there is no shader without an active layer
+#define AOFX_DILATE_PERMUTATION(LAYER0, LAYER1, LAYER2) \
+    ((LAYER2) * 4 + (LAYER1) * 2 + (LAYER0))
+#define AOFX_DILATE_PERMUTATION_COUNT               8
+#define AOFX_DILATE_PERMUTATION_ENABLED(INDEX)      ((INDEX) != 0)
+
+// CS_AMD_BLUR, CS_BILATERAL_BLUR_SEPARABLE: [blur radius][horizontal, vertical]
+// CS_AMD_BLUR also holds the radius 32 pair, which no AOFX_BILATERAL_BLUR_RADIUS selects
+#define AOFX_BLUR_PERMUTATION(RADIUS, PASS)         ((RADIUS) * 2 + (PASS))
+#define AOFX_BLUR_PERMUTATION_COUNT                 (AOFX_PERMUTATION_BLUR_RADIUS_COUNT * 2)
+#define AOFX_BLUR_PERMUTATION_ENABLED(INDEX) \
+    ((INDEX) < AOFX_BLUR_PERMUTATION_COUNT && AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_BLUR_RADIUS_MASK, (INDEX) / 2))
+
+// CS_BILATERAL_BLUR: [blur radius]
+#define AOFX_BILATERAL_BLUR_PERMUTATION_ENABLED(INDEX) \
+    ((INDEX) < AOFX_PERMUTATION_BLUR_RADIUS_COUNT && AOFX_PERMUTATION_MASK_HAS(AMD_AOFX_PERMUTATION_BLUR_RADIUS_MASK, (INDEX)))
+
+// per table test used by the shader archive, AOFX_PERMUTATION_ENABLED(CS_AMD_AO, 17)
+#define AOFX_PERMUTATION_ENABLED(TABLE, INDEX)                          AOFX_PERMUTATION_ENABLED_##TABLE(INDEX)
+#define AOFX_PERMUTATION_ENABLED_CS_AMD_AO(INDEX)                       AOFX_AO_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_PS_AMD_AO(INDEX)                       AOFX_AO_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_CS_AMD_GTAO(INDEX)                     AOFX_AO_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_PS_AMD_GTAO(INDEX)                     AOFX_AO_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_CS_AO_DEINTERLEAVE(INDEX)              AOFX_PROCESS_INPUT_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_PS_AO_DEINTERLEAVE(INDEX)              AOFX_PROCESS_INPUT_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_PS_AO_DILATE(INDEX)                    AOFX_DILATE_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_PS_AO_DILATE_UPSAMPLE(INDEX)           AOFX_DILATE_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_CS_AMD_BLUR(INDEX)                     AOFX_BLUR_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_CS_BILATERAL_BLUR_SEPARABLE(INDEX)     AOFX_BLUR_PERMUTATION_ENABLED(INDEX)
+#define AOFX_PERMUTATION_ENABLED_CS_BILATERAL_BLUR(INDEX)               AOFX_BILATERAL_BLUR_PERMUTATION_ENABLED(INDEX)
+
+#endif // __AMD_AOFX_PERMUTATIONS_H__
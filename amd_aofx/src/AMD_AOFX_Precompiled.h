@@ -22,14 +22,70 @@
 
 #pragma once
 
-#include "Shaders\inc\CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH_NORMAL.inc"
-#include "Shaders\inc\CS_DEINTERLEAVE_X2_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\CS_DEINTERLEAVE_X2_MSAA_X1_DEPTH_NORMAL.inc"
-#include "Shaders\inc\CS_DEINTERLEAVE_X4_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\CS_DEINTERLEAVE_X4_MSAA_X1_DEPTH_NORMAL.inc"
-#include "Shaders\inc\CS_DEINTERLEAVE_X8_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\CS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_NORMAL.inc"
+// Shaders\build\pack_shaders.py records in AOFX_SHADERS_* which of the permutations below have been compiled,
+// the AMD_AOFX_*_PRECOMPILED defaults follow them
+#include "Shaders/inc/AMD_AOFX_ShaderFeatures.inc"
+
+// Depth aware upsampling permutations of psDilate, generated by fxc_compile_utility.bat
+// Until AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED is enabled, downscaled layers are upsampled by PS_UPSAMPLE to full resolution
+// surfaces before they are blurred and dilated
+#ifndef AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+# define AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED AOFX_SHADERS_DILATE_UPSAMPLE
+#endif
+
+// GTAO permutations are generated by the GTAO sections of fxc_compile_ao_cs.bat / fxc_compile_ao_ps.bat
+// Until AMD_AOFX_GTAO_PRECOMPILED is enabled, AOFX_Initialize and AOFX_Render reject active layers requesting AOFX_KERNEL_TYPE_GTAO
+// with AOFX_RETURN_CODE_INVALID_ARGUMENT, the CPU paths support both kernels
+#ifndef AMD_AOFX_GTAO_PRECOMPILED
+# define AMD_AOFX_GTAO_PRECOMPILED AOFX_SHADERS_GTAO
+#endif
+
+// AOFX_Desc::m_MaxInputSize relies on the viewport texture coordinate constants read by the process input, AO, blur, dilate
+// and output shaders, compiled in with AOFX_VIEWPORT_SCALE=1 (the default of the fxc_compile_*.bat files). pack_shaders.py reads
+// it back from the bytecode into AOFX_SHADERS_VIEWPORT_SCALE, so AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED is enabled once the shaders
+// are compiled with it. Until then AOFX_Initialize, AOFX_Resize and AOFX_Render reject a non zero m_MaxInputSize with
+// AOFX_RETURN_CODE_INVALID_ARGUMENT
+#ifndef AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED
+# define AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED AOFX_SHADERS_VIEWPORT_SCALE
+#endif
+
+// Shaders\build\pack_shaders.py packs the bytecode of every permutation in this file into Shaders\inc\AMD_AOFX_ShaderArchive.inc,
+// LZ4 compressed with identical bytecode stored once. Only the permutations AOFX creates are unpacked and permutations
+// pruned by the AMD_AOFX_PERMUTATION_*_MASK settings of AMD_AOFX_Permutations.h are not compiled in. The raw headers
+// below are the input of the packer and are compiled in instead when AMD_AOFX_SHADER_ARCHIVE is disabled
+#ifndef AMD_AOFX_SHADER_ARCHIVE
+# define AMD_AOFX_SHADER_ARCHIVE 1
+#endif
+
+#if AMD_AOFX_SHADER_ARCHIVE
+
+struct AOFX_ShaderArchiveEntry
+{
+    const BYTE *    m_pPacked;          // NULL for pruned permutations
+    unsigned int    m_PackedSize;
+    unsigned int    m_Size;
+};
+
+#include "Shaders/inc/AMD_AOFX_ShaderArchive.inc"
+
+#define AOFX_SHADER_TABLE_SIZE(TABLE)           AMD_ARRAY_SIZE(TABLE##_Packed)
+#define AOFX_SHADER_PERMUTATION(TABLE, INDEX)   AOFX_OpaqueDesc::S_SHADER_BYTECODE(TABLE##_Packed[INDEX].m_pPacked, TABLE##_Packed[INDEX].m_Size, TABLE##_Packed[INDEX].m_PackedSize)
+#define AOFX_SHADER_BYTECODE(NAME)              AOFX_OpaqueDesc::S_SHADER_BYTECODE(NAME##_Packed.m_pPacked, NAME##_Packed.m_Size, NAME##_Packed.m_PackedSize)
+
+#else // AMD_AOFX_SHADER_ARCHIVE
+
+#define AOFX_SHADER_TABLE_SIZE(TABLE)           AMD_ARRAY_SIZE(TABLE##_Data)
+#define AOFX_SHADER_PERMUTATION(TABLE, INDEX)   AOFX_OpaqueDesc::S_SHADER_BYTECODE(TABLE##_Data[INDEX], TABLE##_Size[INDEX])
+#define AOFX_SHADER_BYTECODE(NAME)              AOFX_OpaqueDesc::S_SHADER_BYTECODE(NAME##_Data, sizeof(NAME##_Data))
+
+#include "Shaders/inc/CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH_NORMAL.inc"
+#include "Shaders/inc/CS_DEINTERLEAVE_X2_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/CS_DEINTERLEAVE_X2_MSAA_X1_DEPTH_NORMAL.inc"
+#include "Shaders/inc/CS_DEINTERLEAVE_X4_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/CS_DEINTERLEAVE_X4_MSAA_X1_DEPTH_NORMAL.inc"
+#include "Shaders/inc/CS_DEINTERLEAVE_X8_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/CS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_NORMAL.inc"
 
 const BYTE * CS_AO_DEINTERLEAVE_Data[] =
 {
@@ -62,14 +118,14 @@ int          CS_AO_DEINTERLEAVE_Size[] =
 };
 
 
-#include "Shaders\inc\PS_DEINTERLEAVE_X1_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\PS_DEINTERLEAVE_X1_MSAA_X1_DEPTH_NORMAL.inc"
-#include "Shaders\inc\PS_DEINTERLEAVE_X2_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\PS_DEINTERLEAVE_X2_MSAA_X1_DEPTH_NORMAL.inc"
-#include "Shaders\inc\PS_DEINTERLEAVE_X4_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\PS_DEINTERLEAVE_X4_MSAA_X1_DEPTH_NORMAL.inc"
-#include "Shaders\inc\PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH.inc"
-#include "Shaders\inc\PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_NORMAL.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X1_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X1_MSAA_X1_DEPTH_NORMAL.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X2_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X2_MSAA_X1_DEPTH_NORMAL.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X4_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X4_MSAA_X1_DEPTH_NORMAL.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH.inc"
+#include "Shaders/inc/PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_NORMAL.inc"
 
 const BYTE * PS_AO_DEINTERLEAVE_Data[] =
 {
@@ -101,17 +157,17 @@ int          PS_AO_DEINTERLEAVE_Size[] =
   sizeof(PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_NORMAL_Data),
 };
 
-#include "Shaders\inc\VS_FULLSCREEN.inc"
+#include "Shaders/inc/VS_FULLSCREEN.inc"
 
-#include "Shaders\inc\PS_UPSAMPLE.inc"
+#include "Shaders/inc/PS_UPSAMPLE.inc"
 
-#include "Shaders\inc\PS_DILATE_YNN.inc"
-#include "Shaders\inc\PS_DILATE_NYN.inc"
-#include "Shaders\inc\PS_DILATE_NNY.inc"
-#include "Shaders\inc\PS_DILATE_YYN.inc"
-#include "Shaders\inc\PS_DILATE_YNY.inc"
-#include "Shaders\inc\PS_DILATE_NYY.inc"
-#include "Shaders\inc\PS_DILATE_YYY.inc"
+#include "Shaders/inc/PS_DILATE_YNN.inc"
+#include "Shaders/inc/PS_DILATE_NYN.inc"
+#include "Shaders/inc/PS_DILATE_NNY.inc"
+#include "Shaders/inc/PS_DILATE_YYN.inc"
+#include "Shaders/inc/PS_DILATE_YNY.inc"
+#include "Shaders/inc/PS_DILATE_NYY.inc"
+#include "Shaders/inc/PS_DILATE_YYY.inc"
 
 const BYTE * PS_AO_DILATE_Data[] =
 {
@@ -137,18 +193,54 @@ int          PS_AO_DILATE_Size[] =
   sizeof(PS_DILATE_YYY_Data),
 };
 
-#include "Shaders\inc\PS_OUTPUT.inc"
+#if AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+
+#include "Shaders/inc/PS_DILATE_UPSAMPLE_YNN.inc"
+#include "Shaders/inc/PS_DILATE_UPSAMPLE_NYN.inc"
+#include "Shaders/inc/PS_DILATE_UPSAMPLE_NNY.inc"
+#include "Shaders/inc/PS_DILATE_UPSAMPLE_YYN.inc"
+#include "Shaders/inc/PS_DILATE_UPSAMPLE_YNY.inc"
+#include "Shaders/inc/PS_DILATE_UPSAMPLE_NYY.inc"
+#include "Shaders/inc/PS_DILATE_UPSAMPLE_YYY.inc"
+
+const BYTE * PS_AO_DILATE_UPSAMPLE_Data[] =
+{
+  NULL,
+  PS_DILATE_UPSAMPLE_YNN_Data,
+  PS_DILATE_UPSAMPLE_NYN_Data,
+  PS_DILATE_UPSAMPLE_YYN_Data,
+  PS_DILATE_UPSAMPLE_NNY_Data,
+  PS_DILATE_UPSAMPLE_YNY_Data,
+  PS_DILATE_UPSAMPLE_NYY_Data,
+  PS_DILATE_UPSAMPLE_YYY_Data,
+};
+
+int          PS_AO_DILATE_UPSAMPLE_Size[] =
+{
+  0,
+  sizeof(PS_DILATE_UPSAMPLE_YNN_Data),
+  sizeof(PS_DILATE_UPSAMPLE_NYN_Data),
+  sizeof(PS_DILATE_UPSAMPLE_YYN_Data),
+  sizeof(PS_DILATE_UPSAMPLE_NNY_Data),
+  sizeof(PS_DILATE_UPSAMPLE_YNY_Data),
+  sizeof(PS_DILATE_UPSAMPLE_NYY_Data),
+  sizeof(PS_DILATE_UPSAMPLE_YYY_Data),
+};
+
+#endif // AMD_AOFX_DILATE_UPSAMPLE_PRECOMPILED
+
+#include "Shaders/inc/PS_OUTPUT.inc"
 
-#include "Shaders\inc\CS_FILTER_X_RADIUS_2.inc"
-#include "Shaders\inc\CS_FILTER_Y_RADIUS_2.inc"
-#include "Shaders\inc\CS_FILTER_X_RADIUS_4.inc"
-#include "Shaders\inc\CS_FILTER_Y_RADIUS_4.inc"
-#include "Shaders\inc\CS_FILTER_X_RADIUS_8.inc"
-#include "Shaders\inc\CS_FILTER_Y_RADIUS_8.inc"
-#include "Shaders\inc\CS_FILTER_X_RADIUS_16.inc"
-#include "Shaders\inc\CS_FILTER_Y_RADIUS_16.inc"
-#include "Shaders\inc\CS_FILTER_X_RADIUS_32.inc"
-#include "Shaders\inc\CS_FILTER_Y_RADIUS_32.inc"
+#include "Shaders/inc/CS_FILTER_X_RADIUS_2.inc"
+#include "Shaders/inc/CS_FILTER_Y_RADIUS_2.inc"
+#include "Shaders/inc/CS_FILTER_X_RADIUS_4.inc"
+#include "Shaders/inc/CS_FILTER_Y_RADIUS_4.inc"
+#include "Shaders/inc/CS_FILTER_X_RADIUS_8.inc"
+#include "Shaders/inc/CS_FILTER_Y_RADIUS_8.inc"
+#include "Shaders/inc/CS_FILTER_X_RADIUS_16.inc"
+#include "Shaders/inc/CS_FILTER_Y_RADIUS_16.inc"
+#include "Shaders/inc/CS_FILTER_X_RADIUS_32.inc"
+#include "Shaders/inc/CS_FILTER_Y_RADIUS_32.inc"
 
 const BYTE * CS_AMD_BLUR_Data[] =
 {
@@ -178,22 +270,22 @@ int          CS_AMD_BLUR_Size[] =
   sizeof(CS_FILTER_Y_RADIUS_32_Data),
 };
 
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_16.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_15.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_14.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_13.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_12.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_11.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_10.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_9.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_8.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_7.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_6.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_5.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_4.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_3.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_2.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_RADIUS_1.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_16.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_15.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_14.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_13.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_12.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_11.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_10.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_9.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_8.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_7.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_6.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_5.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_4.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_3.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_2.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_RADIUS_1.inc"
 
 const BYTE * CS_BILATERAL_BLUR_Data[] =
 {
@@ -236,39 +328,39 @@ int          CS_BILATERAL_BLUR_Size[] =
   sizeof(CS_BILATERAL_BLUR_RADIUS_16_DATA),
 };
 
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_16.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_15.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_14.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_13.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_12.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_11.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_10.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_9.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_8.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_7.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_6.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_5.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_4.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_3.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_2.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_1.inc"
-
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_16.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_15.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_14.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_13.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_12.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_11.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_10.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_9.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_8.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_7.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_6.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_5.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_4.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_3.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_2.inc"
-#include "Shaders\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_1.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_16.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_15.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_14.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_13.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_12.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_11.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_10.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_9.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_8.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_7.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_6.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_5.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_4.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_3.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_2.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_VERTICAL_RADIUS_1.inc"
+
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_16.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_15.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_14.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_13.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_12.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_11.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_10.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_9.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_8.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_7.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_6.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_5.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_4.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_3.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_2.inc"
+#include "Shaders/inc/CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_1.inc"
 
 const BYTE * CS_BILATERAL_BLUR_SEPARABLE_Data[] =
 {
@@ -320,105 +412,105 @@ int          CS_BILATERAL_BLUR_SEPARABLE_Size[] =
 };
 
 
-#include "Shaders\inc\CS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-
-#include "Shaders\inc\CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-
-#include "Shaders\inc\CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-
-#include "Shaders\inc\CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+#include "Shaders/inc/CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+#include "Shaders/inc/CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+#include "Shaders/inc/CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
 
 const BYTE * CS_AMD_AO_Data[] =
 {
@@ -667,105 +759,105 @@ int          CS_AMD_AO_Size[] =
   sizeof(CS_AO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
 };
 
-#include "Shaders\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-
-#include "Shaders\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-
-#include "Shaders\inc\PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-
-#include "Shaders\inc\PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
-#include "Shaders\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+#include "Shaders/inc/PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+#include "Shaders/inc/PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+#include "Shaders/inc/PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
 
 const BYTE * PS_AMD_AO_Data[] =
 {
@@ -1012,4 +1104,698 @@ int          PS_AMD_AO_Size[] =
   sizeof(PS_AO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
   sizeof(PS_AO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
   sizeof(PS_AO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
-};
\ No newline at end of file
+};
+
+#if AMD_AOFX_GTAO_PRECOMPILED
+
+#include "Shaders/inc/CS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/CS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+const BYTE * CS_AMD_GTAO_Data[] =
+{
+  // Layer // Normal // Tap // Sample
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+};
+
+int          CS_AMD_GTAO_Size[] =
+{
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(CS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+};
+
+#include "Shaders/inc/PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc"
+#include "Shaders/inc/PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc"
+
+const BYTE * PS_AMD_GTAO_Data[] =
+{
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data,
+
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data,
+  PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data,
+
+};
+
+int          PS_AMD_GTAO_Size[] =
+{
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data),
+
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data),
+  sizeof(PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data),
+};
+
+#endif // AMD_AOFX_GTAO_PRECOMPILED
+
+#endif // AMD_AOFX_SHADER_ARCHIVE
@@ -73,7 +73,7 @@ void csAmbientOcclusion(uint3 groupIdx    : SV_GroupID,
     position = fetchPositionFromCache(screenCoord.xy, cacheCoord, int2(0, 0));
     uint randomIndex = (dispatchIdx.x * dispatchIdx.y) % AO_RANDOM_TAPS_COUNT;
 
-    float ambientOcclusion = kernelHDAO(position, screenCoord.xy, cacheCoord, randomIndex, uint2(0, 0), 0);
+    float ambientOcclusion = kernelAO(position, screenCoord.xy, cacheCoord, randomIndex, uint2(0, 0), 0);
 
     g_t2dOutput[dispatchIdx.xy] = ambientOcclusion;
   }
@@ -90,7 +90,7 @@ void psAmbientOcclusion ( PS_FullscreenInput In )
   float3 position = fetchPositionFromCache(screenCoord, uint2(0, 0), int2(0, 0));
   uint randomIndex = (dispatchIdx.x * dispatchIdx.y) % AO_RANDOM_TAPS_COUNT;
 
-  float ambientOcclusion = kernelHDAO(position, screenCoord.xy, uint2(0, 0), randomIndex, uint2(0, 0), 0);
+  float ambientOcclusion = kernelAO(position, screenCoord.xy, uint2(0, 0), randomIndex, uint2(0, 0), 0);
 
   if ( (dispatchIdx.x < g_cbAO.m_OutputSize.x) && 
        (dispatchIdx.y < g_cbAO.m_OutputSize.y) )
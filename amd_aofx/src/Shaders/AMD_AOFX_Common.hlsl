@@ -42,6 +42,9 @@
 #define AOFX_TAP_TYPE_RANDOM_CB                  1
 #define AOFX_TAP_TYPE_RANDOM_SRV                 2
 
+#define AOFX_KERNEL_TYPE_HDAO                    0
+#define AOFX_KERNEL_TYPE_GTAO                    1
+
 #define AOFX_IMPLEMENTATION_CS                   0
 #define AOFX_IMPLEMENTATION_PS                   1
 
@@ -61,10 +64,28 @@
 #   define AOFX_TAP_TYPE                         AOFX_TAP_TYPE_FIXED
 #endif
 
+#ifndef AOFX_KERNEL_TYPE
+#   define AOFX_KERNEL_TYPE                      AOFX_KERNEL_TYPE_HDAO
+#endif
+
 #ifndef AOFX_MSAA_LEVEL
 #   define AOFX_MSAA_LEVEL                       1
 #endif
 
+// AOFX_Desc::m_MaxInputSize: passes render into the top left part of larger surfaces, so samples are clamped to that part
+// and texture coordinates rescaled to it. The packed bytecode is compiled without it, see AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED
+#ifndef AOFX_VIEWPORT_SCALE
+#   define AOFX_VIEWPORT_SCALE                   0
+#endif
+
+#if (AOFX_VIEWPORT_SCALE == 1)
+# define AOFX_VIEWPORT_CLAMP(uv, uvMax)          min(uv, uvMax)
+# define AOFX_VIEWPORT_RESCALE(uv, scaleRcp)     ((uv) * (scaleRcp))
+#else
+# define AOFX_VIEWPORT_CLAMP(uv, uvMax)          (uv)
+# define AOFX_VIEWPORT_RESCALE(uv, scaleRcp)     (uv)
+#endif
+
 #if (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_NONE)
 # define AO_INPUT_TYPE                           float
 #elif (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_READ_FROM_SRV)
@@ -108,7 +129,12 @@ struct AO_Data
   float                                          m_ViewDistanceDiscard;
 
   float                                          m_FadeIntervalLength;
+#if (AOFX_VIEWPORT_SCALE == 1)
+  float2                                         m_InputUVMax;                 // center of the last texel of g_t2dInput covered by the viewport
+  float                                          _pad;
+#else
   float3                                         _pad;
+#endif
 };
 
 struct AO_InputData
@@ -132,6 +158,11 @@ struct AO_InputData
   float                                          m_ScaleRcp;
   float                                          m_ViewDistanceFade;
   float                                          m_ViewDistanceDiscard;
+
+#if (AOFX_VIEWPORT_SCALE == 1)
+  float2                                         m_UVScaleRcp;                 // size of the sampled surfaces / viewport size
+  float2                                         m_UVMax;                      // center of the last texel covered by the viewport
+#endif
 };
 
 //======================================================================================================
@@ -219,6 +250,12 @@ static const int2                                g_SamplePattern[NUM_VALLEYS] =
 
 #endif // ULTRA_SAMPLES
 
+// GTAO reads the same number of taps as HDAO: 2 sides * GTAO_STEP_COUNT * GTAO_SLICE_COUNT == 2 * NUM_VALLEYS
+// GTAO_RADIUS_TEXELS has to stay within AO_GROUP_TEXEL_OVERLAP
+#define GTAO_STEP_COUNT                          4
+#define GTAO_SLICE_COUNT                         ( NUM_VALLEYS / GTAO_STEP_COUNT )
+#define GTAO_RADIUS_TEXELS                       12.0f
+
 //======================================================================================================
 // AO packing function
 //======================================================================================================
@@ -294,10 +331,10 @@ float3 loadCameraSpacePositionT2D( float2 screenCoord, int2 layerIdx )
 {
 
 #if (AO_DEINTERLEAVE_FACTOR == 1)
-  AO_INPUT_TYPE aoInput = g_t2dInput.SampleLevel(g_ssPointClamp, screenCoord.xy * g_cbAO.m_OutputSizeRcp, 0.0f);
+  AO_INPUT_TYPE aoInput = g_t2dInput.SampleLevel(g_ssPointClamp, AOFX_VIEWPORT_CLAMP(screenCoord.xy * g_cbAO.m_OutputSizeRcp, g_cbAO.m_InputUVMax), 0.0f);
 #else //  (AO_DEINTERLEAVE_FACTOR == 1)
   int layer = layerIdx.x + MUL_AO_DEINTERLEAVE_FACTOR(layerIdx.y);
-  AO_INPUT_TYPE aoInput = g_t2daInput.SampleLevel(g_ssPointClamp, float3((screenCoord.xy + float2(0.5, 0.5)) * g_cbAO.m_OutputSizeRcp, layer), 0.0f);
+  AO_INPUT_TYPE aoInput = g_t2daInput.SampleLevel(g_ssPointClamp, float3(AOFX_VIEWPORT_CLAMP((screenCoord.xy + float2(0.5, 0.5)) * g_cbAO.m_OutputSizeRcp, g_cbAO.m_InputUVMax), layer), 0.0f);
 #endif //  (AO_DEINTERLEAVE_FACTOR == 1)
 
 #if (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_NONE)
@@ -324,6 +361,23 @@ float3 loadCameraSpacePositionT2D( float2 screenCoord, int2 layerIdx )
   return position;
 }
 
+#if (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_READ_FROM_SRV)
+// Normal of the full resolution texel the position at screenCoord was reconstructed from, stored with a 0.5 bias
+float3 loadCameraSpaceNormalT2D( float2 screenCoord, int2 layerIdx )
+{
+
+# if (AO_DEINTERLEAVE_FACTOR == 1)
+  float2 uv = screenCoord.xy * g_cbAO.m_InputSizeRcp * 0.5f;
+# else //  (AO_DEINTERLEAVE_FACTOR == 1)
+  float2 uv = (MUL_AO_DEINTERLEAVE_FACTOR(screenCoord.xy) + layerIdx + float2(0.5, 0.5)) * g_cbAO.m_InputSizeRcp * 0.5f;
+# endif //  (AO_DEINTERLEAVE_FACTOR == 1)
+
+  float3 normal = g_t2dNormal.SampleLevel(g_ssPointClamp, uv, 0.0f).xyz - float3(0.5f, 0.5f, 0.5f);
+
+  return normalize(normal);
+}
+#endif // (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_READ_FROM_SRV)
+
 float loadCameraSpaceDepthT2D( float2 uv, float cameraQ, float cameraZNearXQ )
 {
 
@@ -79,7 +79,7 @@ void csAmbientOcclusionDeinterleave(uint3 groupIdx    : SV_GroupID,
   {
     int2 cacheCoord = threadIdx.xy + int2(AO_GROUP_TEXEL_OVERLAP, AO_GROUP_TEXEL_OVERLAP);
     position = fetchPositionFromCache(layerDispatchIdx, cacheCoord, layerIdx);
-    float ambientOcclusion = kernelHDAO(position, layerDispatchIdx.xy, cacheCoord, layerIndex, layerIdx, layerIndex);
+    float ambientOcclusion = kernelAO(position, layerDispatchIdx.xy, cacheCoord, layerIndex, layerIdx, layerIndex);
 
 # if AO_DEINTERLEAVE_OUTPUT_TO_TEXTURE2DARRAY
     g_t2daOutput[uint3(layerDispatchIdx.xy, layerIndex)] = ambientOcclusion;
@@ -101,7 +101,7 @@ void psAmbientOcclusionDeinterleave(PS_FullscreenInput In)
   int    layerIndex = layerIdx.x + layerIdx.y * AO_DEINTERLEAVE_FACTOR;
   uint2  layerDispatchIdx = dispatchIdx % deinterleavedSize;
   float3 position = fetchPositionFromCache(layerDispatchIdx.xy, uint2(0, 0), layerIdx);
-  float  ambientOcclusion = kernelHDAO(position, layerDispatchIdx.xy, int2(0, 0), layerIndex, layerIdx, layerIndex);
+  float  ambientOcclusion = kernelAO(position, layerDispatchIdx.xy, int2(0, 0), layerIndex, layerIdx, layerIndex);
 
     if ( (layerDispatchIdx.x < g_cbAO.m_OutputSize.x) &&
          (layerDispatchIdx.y < g_cbAO.m_OutputSize.y) &&
@@ -135,4 +135,111 @@ float kernelHDAO(float3 centerPosition, float2 screenCoord, int2 cacheCoord, uin
 
   float weight = saturate((centerPosition.z - g_cbAO.m_ViewDistanceFade) / g_cbAO.m_FadeIntervalLength);
   return lerp(occlusion, 1.0f, weight);
-}
\ No newline at end of file
+}
+
+//==================================================================================================
+// AO : Ground truth (horizon based) AO. Marches GTAO_SLICE_COUNT screen space slices, finds the
+// horizon on both sides of each slice and integrates cosine weighted visibility between them.
+//==================================================================================================
+float kernelGTAO(float3 centerPosition, float2 screenCoord, int2 cacheCoord, uint randomIndex, uint2 layerIdx, uint layerIndex)
+{
+  if ( centerPosition.z > g_cbAO.m_ViewDistanceDiscard ) return 1.0;
+
+  const float PI = 3.14159265f;
+  const float HALF_PI = 1.57079633f;
+
+  float3 viewDir = normalize(-centerPosition);
+
+#if ( AOFX_TAP_TYPE == AOFX_TAP_TYPE_FIXED )
+  float sliceJitter = 0.5f;
+  float stepJitter = 0.5f;
+#else // ( AOFX_TAP_TYPE == AOFX_TAP_TYPE_RANDOM_CB ) || ( AOFX_TAP_TYPE == AOFX_TAP_TYPE_RANDOM_SRV )
+  float sliceJitter = frac(randomIndex * 0.618034f);
+  float stepJitter = frac(randomIndex * 0.754878f + 0.5f);
+#endif // ( AOFX_TAP_TYPE == AOFX_TAP_TYPE_FIXED )
+
+#if (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_READ_FROM_SRV)
+  float3 normal = loadCameraSpaceNormalT2D(screenCoord, layerIdx);
+#else // (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_NONE)
+  // Reconstruct the normal from the neighbours with the smaller depth discontinuity
+  float3 right = fetchPositionFromCache(screenCoord + int2( 1,  0), cacheCoord + int2( 1,  0), layerIdx);
+  float3 left  = fetchPositionFromCache(screenCoord + int2(-1,  0), cacheCoord + int2(-1,  0), layerIdx);
+  float3 down  = fetchPositionFromCache(screenCoord + int2( 0,  1), cacheCoord + int2( 0,  1), layerIdx);
+  float3 up    = fetchPositionFromCache(screenCoord + int2( 0, -1), cacheCoord + int2( 0, -1), layerIdx);
+
+  // A clamped neighbour at the screen border is the center itself and can't be used
+  float3 dxRight = right - centerPosition, dxLeft = centerPosition - left;
+  float3 dyDown = down - centerPosition, dyUp = centerPosition - up;
+  float3 dx = ((dot(dxLeft, dxLeft) == 0.0f) || ((abs(dxRight.z) < abs(dxLeft.z)) && (dot(dxRight, dxRight) > 0.0f))) ? dxRight : dxLeft;
+  float3 dy = ((dot(dyUp, dyUp) == 0.0f) || ((abs(dyDown.z) < abs(dyUp.z)) && (dot(dyDown, dyDown) > 0.0f))) ? dyDown : dyUp;
+  float3 normal = normalize(cross(dy, dx));
+#endif // (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_READ_FROM_SRV)
+  normal = (dot(normal, viewDir) < 0.0f) ? -normal : normal;
+
+  float visibility = 0.0f;
+
+  [unroll]
+  for ( uint uSlice = 0; uSlice < GTAO_SLICE_COUNT; uSlice++ )
+  {
+    float  phi = (uSlice + sliceJitter) * (PI / GTAO_SLICE_COUNT);
+    float2 direction = float2(cos(phi), sin(phi));
+
+    // x: horizon cosine along +direction, y: along -direction
+    float2 horizonCos = float2(-1.0f, -1.0f);
+
+    [unroll]
+    for ( uint uStep = 0; uStep < GTAO_STEP_COUNT; uStep++ )
+    {
+      float stepDistance = GTAO_RADIUS_TEXELS * (uStep + 0.5f + stepJitter * 0.5f) / GTAO_STEP_COUNT;
+      int2  sampleOffset = int2(floor(direction * stepDistance + 0.5f));
+
+      float3 position[2];
+      position[0] = fetchPositionFromCache(screenCoord + sampleOffset, cacheCoord + sampleOffset, layerIdx);
+      position[1] = fetchPositionFromCache(screenCoord - sampleOffset, cacheCoord - sampleOffset, layerIdx);
+
+      [unroll]
+      for ( uint uSide = 0; uSide < 2; uSide++ )
+      {
+        float3 delta = position[uSide] - centerPosition;
+        float  deltaLength = length(delta);
+        float  falloff = (deltaLength > g_cbAO.m_AcceptRadius) ? saturate((g_cbAO.m_RejectRadius - deltaLength) * g_cbAO.m_RecipFadeOutDist) : 0.0f;
+        float  sampleCos = lerp(-1.0f, dot(delta, viewDir) / max(deltaLength, 1e-6f), falloff);
+
+        horizonCos[uSide] = max(horizonCos[uSide], sampleCos);
+      }
+    }
+
+    // Project the normal onto the slice plane
+    float3 sliceDir = float3(direction.x, -direction.y, 0.0f);
+    float3 orthoDir = sliceDir - dot(sliceDir, viewDir) * viewDir;
+    float3 axis = normalize(cross(orthoDir, viewDir));
+    float3 projectedNormal = normal - axis * dot(normal, axis);
+    float  projectedLength = length(projectedNormal);
+    float  cosN = saturate(dot(projectedNormal, viewDir) / max(projectedLength, 1e-6f));
+    float  n = ((dot(orthoDir, projectedNormal) < 0.0f) ? -1.0f : 1.0f) * acos(cosN);
+
+    // Clamp horizons to the hemisphere around the normal
+    float h0 = n + max(-acos(horizonCos.y) - n, -HALF_PI);
+    float h1 = n + min( acos(horizonCos.x) - n,  HALF_PI);
+
+    // Cosine weighted arc integral
+    float arc0 = (cosN + 2.0f * h0 * sin(n) - cos(2.0f * h0 - n)) * 0.25f;
+    float arc1 = (cosN + 2.0f * h1 * sin(n) - cos(2.0f * h1 - n)) * 0.25f;
+
+    visibility += projectedLength * (arc0 + arc1);
+  }
+
+  // Finally calculate the AO occlusion value
+  float occlusion = 1.0f - visibility / GTAO_SLICE_COUNT;
+  occlusion *= g_cbAO.m_LinearIntensity;
+  occlusion = 1.0f - saturate(occlusion);
+
+  float weight = saturate((centerPosition.z - g_cbAO.m_ViewDistanceFade) / g_cbAO.m_FadeIntervalLength);
+  return lerp(occlusion, 1.0f, weight);
+}
+
+#if ( AOFX_KERNEL_TYPE == AOFX_KERNEL_TYPE_GTAO )
+# define kernelAO                                kernelGTAO
+#else // ( AOFX_KERNEL_TYPE == AOFX_KERNEL_TYPE_HDAO )
+# define kernelAO                                kernelHDAO
+#endif // ( AOFX_KERNEL_TYPE == AOFX_KERNEL_TYPE_GTAO )
@@ -90,14 +90,16 @@ DEINTERLEAVE_TYPE LoadInput(float2 uv, float znear, float zfar)
   float q = g_cbInputData.m_CameraQ;
   float znear_x_q = g_cbInputData.m_CameraQTimesZNear; 
 
-  float depth = g_t2dDepth.SampleLevel(g_ssPointClamp, uv, 0).x;
+  float2 sampleUV = AOFX_VIEWPORT_CLAMP(uv, g_cbInputData.m_UVMax);
+
+  float depth = g_t2dDepth.SampleLevel(g_ssPointClamp, sampleUV, 0).x;
 
   float camera_z = -znear_x_q / ( depth - q );
 
 # if (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_READ_FROM_SRV)
-  float3 normal = g_t2dNormal.SampleLevel(g_ssPointClamp, uv, 0).xyz - float3(0.5, 0.5, 0.5);
+  float3 normal = g_t2dNormal.SampleLevel(g_ssPointClamp, sampleUV, 0).xyz - float3(0.5, 0.5, 0.5);
 
-  float2 camera = uv * float2(2.0f, 2.0f) - float2( 1.0f, 1.0f );
+  float2 camera = AOFX_VIEWPORT_RESCALE(uv, g_cbInputData.m_UVScaleRcp) * float2(2.0f, 2.0f) - float2( 1.0f, 1.0f );
   camera.x = camera.x * camera_z * g_cbInputData.m_CameraTanHalfFovHorizontal;
   camera.y = camera.y * camera_z * -g_cbInputData.m_CameraTanHalfFovVertical;
 
@@ -259,15 +261,16 @@ void psDeinterleave( PS_FullscreenInput In )
 
   float2 coord = ( floor((layerDispatchIdx * DEINTERLEAVE_FACTOR + layerIdx) * g_cbInputData.m_ScaleRcp) + float2(0.5f, 0.5f));
   float2 texCoord = coord * g_cbInputData.m_InputSizeRcp;
+  float2 sampleCoord = AOFX_VIEWPORT_CLAMP(texCoord, g_cbInputData.m_UVMax);
 
-  float depth    = g_t2dDepth.SampleLevel( g_ssPointClamp, texCoord, 0 ).x;
+  float depth    = g_t2dDepth.SampleLevel( g_ssPointClamp, sampleCoord, 0 ).x;
   float camera_z = -g_cbInputData.m_CameraQTimesZNear / ( depth - g_cbInputData.m_CameraQ );
 
 # if (AOFX_NORMAL_OPTION == AOFX_NORMAL_OPTION_READ_FROM_SRV)
 
-  float3 normal = g_t2dNormal.SampleLevel( g_ssPointClamp, texCoord, 0 ).xyz - float3(0.5f, 0.5f, 0.5f);
+  float3 normal = g_t2dNormal.SampleLevel( g_ssPointClamp, sampleCoord, 0 ).xyz - float3(0.5f, 0.5f, 0.5f);
 
-  float2 camera = texCoord * float2(2.0f, 2.0f) - float2( 1.0f, 1.0f );
+  float2 camera = AOFX_VIEWPORT_RESCALE(texCoord, g_cbInputData.m_UVScaleRcp) * float2(2.0f, 2.0f) - float2( 1.0f, 1.0f );
   camera.x = camera.x * camera_z * g_cbInputData.m_CameraTanHalfFovHorizontal;
   camera.y = camera.y * camera_z * -g_cbInputData.m_CameraTanHalfFovVertical;
 
@@ -67,6 +67,7 @@ groupshared AO_Depth                             g_SharedCache[AO_BLUR_GROUP_THR
 AO_Depth loadDepthAndAmbientOcclusion(float2 uv)
 {
   AO_Depth Out;
+  uv = AOFX_VIEWPORT_CLAMP(uv, g_cbInputData.m_UVMax);
   Out.m_AO = g_t2dAO.SampleLevel(g_ssLinearClamp, uv, 0.0f);
   Out.m_Depth = loadCameraSpaceDepthT2D(uv, g_cbInputData.m_CameraQ, g_cbInputData.m_CameraQTimesZNear);
 
@@ -287,7 +288,8 @@ Texture2D                                        g_t2dUpsampleDepthSmall  : regi
 Texture2D                                        g_t2dUpsampleAO     : register( t2 );
 
 //==================================================================================================
-// Upsample PS: This should really do something more fancy than a bilinear upsample
+// Upsample PS: upsamples a downscaled AO layer to full resolution ahead of the layer blur and the dilate pass,
+// used until the depth aware AO_DILATE_UPSAMPLE permutations of psDilate are precompiled
 // A depth guided upsampling can be uncommented for comparison, yet that doesn't always work well
 //==================================================================================================
 float4 psUpsample( PS_FullscreenInput In ) : SV_Target0
@@ -353,14 +355,31 @@ float4 psUpsample( PS_FullscreenInput In ) : SV_Target0
 
 //=================================================================================================================================
 // This pixel shader implements a dilate operation over 3 AO surfaces with gamma correction
+// AO surfaces are sampled at their own (possibly downscaled) resolution.
+// With AO_DILATE_UPSAMPLE=1 a downscaled layer is upsampled from the texel (out of the 4 surrounding texels)
+// that is closest in depth to the full resolution pixel, whenever the nearest texel lies across a depth discontinuity
 //=================================================================================================================================
 Texture2D                                        g_t2dDilateAO0                      : register( t0 );
 Texture2D                                        g_t2dDilateAO1                      : register( t1 );
 Texture2D                                        g_t2dDilateAO2                      : register( t2 );
+Texture2D                                        g_t2dDilateDepth                    : register( t6 );
+
+#ifndef AO_DILATE_UPSAMPLE
+# define AO_DILATE_UPSAMPLE 0
+#endif
 
 struct                                           DilateData
 {
   float4                                         m_MultiResolutionAOFactor;
+  float4                                         m_LayerSize[3];                    // layer size (xy), inv size (zw)
+  float4                                         m_DepthUpsampleThreshold;          // 0.0 disables depth aware upsampling of a layer
+  float                                          m_CameraQ;
+  float                                          m_CameraQTimesZNear;
+  float2                                         _pad;
+#if (AOFX_VIEWPORT_SCALE == 1)
+  float4                                         m_LayerUV[3];                      // texCoord scale (xy), center of the last texel in the viewport (zw)
+  float4                                         m_DepthUV;                         // texCoord scale (xy), center of the last texel in the viewport (zw)
+#endif
 };
 
 cbuffer                                          CB_DILATE_Data : register( b0 )
@@ -368,19 +387,91 @@ cbuffer                                          CB_DILATE_Data : register( b0 )
     DilateData                                   g_DilateData;
 }
 
+// texture coordinates span the viewport, each surface is sampled at its own scale and clamped to the part the viewport covers
+#if (AOFX_VIEWPORT_SCALE == 1)
+# define dilateLayerUV(texCoord, layer)          min((texCoord) * g_DilateData.m_LayerUV[layer].xy, g_DilateData.m_LayerUV[layer].zw)
+# define dilateLayerClamp(uv, layer)             min(uv, g_DilateData.m_LayerUV[layer].zw)
+# define dilateLayerTexCoord(uv, layer)          ((uv) / g_DilateData.m_LayerUV[layer].xy)
+# define dilateDepthUV(texCoord)                 min((texCoord) * g_DilateData.m_DepthUV.xy, g_DilateData.m_DepthUV.zw)
+#else
+# define dilateLayerUV(texCoord, layer)          (texCoord)
+# define dilateLayerClamp(uv, layer)             (uv)
+# define dilateLayerTexCoord(uv, layer)          (uv)
+# define dilateDepthUV(texCoord)                 (texCoord)
+#endif
+
+#if (AO_DILATE_UPSAMPLE == 1)
+float dilateCameraZ(float2 texCoord)
+{
+  // AO layers are produced from point sampled depth, so sampling full resolution depth
+  // at a layer texel center returns exactly the depth that texel was computed from
+  float2 uv = dilateDepthUV(texCoord);
+  float depth = g_t2dDilateDepth.SampleLevel( g_ssPointClamp, uv, 0 ).x;
+  return -g_DilateData.m_CameraQTimesZNear / ( depth - g_DilateData.m_CameraQ );
+}
+
+float dilateUpsample(Texture2D t2dAO, float2 uv, int layer, float threshold, float centerZ)
+{
+  float4 layerSize = g_DilateData.m_LayerSize[layer];
+  float2 nearestUV = dilateLayerClamp((floor(uv * layerSize.xy) + 0.5f) * layerSize.zw, layer);
+  float  nearestDelta = abs(dilateCameraZ(dilateLayerTexCoord(nearestUV, layer)) - centerZ);
+
+  [branch]
+  if (nearestDelta > threshold)
+  {
+    float2 baseUV = (floor(uv * layerSize.xy - 0.5f) + 0.5f) * layerSize.zw;
+
+    [unroll]
+    for (int tap = 0; tap < 4; tap++)
+    {
+      float2 tapUV = dilateLayerClamp(baseUV + float2(tap & 1, tap >> 1) * layerSize.zw, layer);
+      float  tapDelta = abs(dilateCameraZ(dilateLayerTexCoord(tapUV, layer)) - centerZ);
+
+      if (tapDelta < nearestDelta)
+      {
+        nearestDelta = tapDelta;
+        nearestUV = tapUV;
+      }
+    }
+  }
+
+  return t2dAO.SampleLevel( g_ssPointClamp, nearestUV, 0 ).x;
+}
+
+float dilateSample(Texture2D t2dAO, float2 texCoord, int layer, float centerZ)
+{
+  float threshold = g_DilateData.m_DepthUpsampleThreshold[layer];
+  float2 uv = dilateLayerUV(texCoord, layer);
+
+  [branch]
+  if (threshold > 0.0f)
+    return dilateUpsample(t2dAO, uv, layer, threshold, centerZ);
+  else
+    return t2dAO.SampleLevel( g_ssPointClamp, uv, 0 ).x;
+}
+#else
+# define dilateSample(t2dAO, texCoord, layer, centerZ) t2dAO.SampleLevel( g_ssPointClamp, dilateLayerUV(texCoord, layer), 0 ).x
+#endif
+
 float4 psDilate( PS_FullscreenInput In ) : SV_Target0
 {
     float3 ao = float3(1, 1, 1);
+#if (AO_DILATE_UPSAMPLE == 1)
+    float centerZ = dilateCameraZ(In.texCoord);
+#else
+    float centerZ = 0.0f;
+#endif
+
 #if (AO_LAYER_MASK & 1) != 0
-    ao.x = pow(g_t2dDilateAO0.SampleLevel( g_ssPointClamp, In.texCoord, 0 ).x, g_DilateData.m_MultiResolutionAOFactor.x);
+    ao.x = pow(dilateSample(g_t2dDilateAO0, In.texCoord, 0, centerZ), g_DilateData.m_MultiResolutionAOFactor.x);
 #endif
 
 #if (AO_LAYER_MASK & 2) != 0
-    ao.y = pow(g_t2dDilateAO1.SampleLevel( g_ssPointClamp, In.texCoord, 0 ).x, g_DilateData.m_MultiResolutionAOFactor.y);
+    ao.y = pow(dilateSample(g_t2dDilateAO1, In.texCoord, 1, centerZ), g_DilateData.m_MultiResolutionAOFactor.y);
 #endif
 
 #if (AO_LAYER_MASK & 4) != 0
-    ao.z = pow(g_t2dDilateAO2.SampleLevel( g_ssPointClamp, In.texCoord, 0 ).x, g_DilateData.m_MultiResolutionAOFactor.z);
+    ao.z = pow(dilateSample(g_t2dDilateAO2, In.texCoord, 2, centerZ), g_DilateData.m_MultiResolutionAOFactor.z);
 #endif
 
     return min(ao.x, min(ao.y, ao.z));
@@ -393,7 +484,12 @@ Texture2D                                        g_t2dOutputRed                :
 
 float4 psOutputRed( PS_FullscreenInput In ) : SV_Target
 {
+#if (AOFX_VIEWPORT_SCALE == 1)
+    // the source is read texel for texel, it may be larger than the viewport the output covers
+    float red = g_t2dOutputRed.Load( int3(In.position.xy, 0) ).r;
+#else
     float red = g_t2dOutputRed.Sample( g_ssLinearClamp, In.texCoord, 0 ).r;
+#endif
 
     return float4(red, red, red, red);
 }
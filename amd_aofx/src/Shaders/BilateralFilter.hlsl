@@ -24,6 +24,17 @@
 #include "AOFX_SeparableFilter\\FilterCommon.hlsl"
 
 #define PI                      ( 3.1415927f )
+
+// see AOFX_VIEWPORT_SCALE in AMD_AOFX_Common.hlsl
+#ifndef AOFX_VIEWPORT_SCALE
+# define AOFX_VIEWPORT_SCALE    0
+#endif
+
+#if (AOFX_VIEWPORT_SCALE == 1)
+# define AOFX_VIEWPORT_CLAMP(uv, uvMax) min(uv, uvMax)
+#else
+# define AOFX_VIEWPORT_CLAMP(uv, uvMax) (uv)
+#endif
 #define GAUSSIAN_DEVIATION      ( KERNEL_RADIUS * 0.5f )
 
 // The input textures
@@ -51,6 +62,11 @@ struct AO_InputData
   float                         m_ScaleRcp;
   float                         m_ViewDistanceFade;
   float                         m_ViewDistanceDiscard;
+
+#if (AOFX_VIEWPORT_SCALE == 1)
+  float2                        m_UVScaleRcp;                 // size of the sampled surfaces / viewport size
+  float2                        m_UVMax;                      // center of the last texel covered by the viewport
+#endif
 };
 
 // Constant buffer used by both the CS & PS
@@ -162,8 +178,8 @@ groupshared struct
 // Sample from chosen input(s)
 //--------------------------------------------------------------------------------------
 #define SAMPLE_FROM_INPUT( _Sampler, _f2SamplePosition, _RAWDataItem ) \
-    _RAWDataItem.fAO = g_txAO.SampleLevel( _Sampler, _f2SamplePosition, 0 ).x; \
-    _RAWDataItem.fDepth = g_txDepth.SampleLevel( _Sampler, _f2SamplePosition, 0 ).x; \
+    _RAWDataItem.fAO = g_txAO.SampleLevel( _Sampler, AOFX_VIEWPORT_CLAMP( _f2SamplePosition, g_aoInputData.m_UVMax ), 0 ).x; \
+    _RAWDataItem.fDepth = g_txDepth.SampleLevel( _Sampler, AOFX_VIEWPORT_CLAMP( _f2SamplePosition, g_aoInputData.m_UVMax ), 0 ).x; \
     _RAWDataItem.fDepth = -g_aoInputData.m_CameraQTimesZNear / ( _RAWDataItem.fDepth - g_aoInputData.m_CameraQ );
 
 
@@ -1,8 +1,11 @@
+rem the AOFX_Desc::m_MaxInputSize permutations, set AOFX_VIEWPORT_SCALE=0 for the packed constants of older releases
+if not defined AOFX_VIEWPORT_SCALE set AOFX_VIEWPORT_SCALE=1
+
 rem Compile Pixel Shader Versions
 
 rem Compile non-Deinterleaved HDAO
 
-SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /E psAmbientOcclusion ..\AMD_AOFX.hlsl /O3 /DAOFX_IMPLEMENTATION=1
+SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /E psAmbientOcclusion ..\AMD_AOFX.hlsl /O3 /DAOFX_IMPLEMENTATION=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_PS% /Fh ..\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc                          /Vn PS_AO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data                           /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1
 %FXC_COMPILE_PS% /Fh ..\inc\PS_AO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc                      /Vn PS_AO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data                       /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1  
@@ -35,7 +38,7 @@ SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /E psAmbientOcclusion ..\AMD_AOFX.h
 
 rem Compile Deinterleaved HDAO with Deinterleaving factor X2
 
-SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /E psAmbientOcclusionDeinterleave ..\AMD_AOFX_Deinterleave.hlsl /O3 /DAOFX_IMPLEMENTATION=1
+SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /E psAmbientOcclusionDeinterleave ..\AMD_AOFX_Deinterleave.hlsl /O3 /DAOFX_IMPLEMENTATION=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_PS% /Fh ..\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc                  /Vn PS_AO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data                   /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2
 %FXC_COMPILE_PS% /Fh ..\inc\PS_AO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc              /Vn PS_AO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data               /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2
@@ -125,3 +128,128 @@ rem Compile Deinterleaved HDAO with Deinterleaving factor X8
 %FXC_COMPILE_PS% /Fh ..\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc   /Vn PS_AO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data      /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8
 %FXC_COMPILE_PS% /Fh ..\inc\PS_AO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc  /Vn PS_AO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8 
 
+rem Compile non-Deinterleaved GTAO
+
+SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /E psAmbientOcclusion ..\AMD_AOFX.hlsl /O3 /DAOFX_IMPLEMENTATION=1 /DAOFX_KERNEL_TYPE=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc                     /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data                      /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc                 /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data                  /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc                /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data                 /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc            /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data             /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc        /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data         /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc       /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data        /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc                  /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data                      /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc              /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data                  /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc             /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data                 /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc         /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data             /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc     /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data         /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc    /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data        /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc                    /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data                      /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc                /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data                  /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc               /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data                 /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc           /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data             /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc       /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data         /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc      /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data        /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc                   /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data                      /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc               /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data                  /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc              /Vn PS_AO_GTAO_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data                 /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc          /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data             /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc      /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data         /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc     /Vn PS_AO_GTAO_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data        /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=1 /DAOFX_KERNEL_TYPE=1
+
+
+rem Compile Deinterleaved GTAO with Deinterleaving factor X2
+
+SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /E psAmbientOcclusionDeinterleave ..\AMD_AOFX_Deinterleave.hlsl /O3 /DAOFX_IMPLEMENTATION=1 /DAOFX_KERNEL_TYPE=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc             /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc         /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc        /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc    /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc          /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc      /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc     /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc            /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc        /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc       /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc   /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc           /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc       /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc      /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc  /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X2_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X2_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=2 /DAOFX_KERNEL_TYPE=1
+
+rem Compile Deinterleaved GTAO with Deinterleaving factor X4
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc             /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc         /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc        /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc    /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc          /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc      /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc     /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc            /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc        /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc       /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc   /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc           /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc       /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc      /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc  /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X4_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X4_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=4 /DAOFX_KERNEL_TYPE=1
+
+rem Compile Deinterleaved GTAO with Deinterleaving factor X8
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc             /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_08_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc         /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_08_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc        /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_08_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc    /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_08_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_08_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_LOW_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_08_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DLOW_SAMPLES=1     /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc          /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_16_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc      /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_16_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc     /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_16_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_16_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_16_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_MEDIUM_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_16_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DMEDIUM_SAMPLES=1  /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc            /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_24_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc        /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_24_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc       /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_24_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc   /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_24_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_24_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_HIGH_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_24_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DHIGH_SAMPLES=1    /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_FIXED.inc           /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_FIXED_SAMPLES_32_Data              /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_CB.inc       /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_CB_SAMPLES_32_Data          /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_NONE_TAP_TYPE_RANDOM_SRV.inc      /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_NONE_TAP_RANDOM_SRV_SAMPLES_32_Data         /DAOFX_NORMAL_OPTION=0 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_FIXED.inc  /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_FIXED_SAMPLES_32_Data     /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=0 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_CB.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_CB_SAMPLES_32_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=1 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+%FXC_COMPILE_PS% /Fh ..\inc\PS_AO_GTAO_DEIN_X8_ULTRA_SAMPLES_NORMAL_OPTION_READ_FROM_SRV_TAP_TYPE_RANDOM_SRV.inc /Vn PS_AO_GTAO_DEIN_X8_NORMAL_OPTION_READ_FROM_SRV_TAP_RANDOM_SRV_SAMPLES_32_Data /DAOFX_NORMAL_OPTION=1 /DAOFX_TAP_TYPE=2 /DULTRA_SAMPLES=1   /DAO_DEINTERLEAVE_FACTOR=8 /DAOFX_KERNEL_TYPE=1
+
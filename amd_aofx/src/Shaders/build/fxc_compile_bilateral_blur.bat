@@ -1,6 +1,9 @@
-SET FXC_PREPROCESS_CS=fxc.exe /nologo /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl 
+rem the AOFX_Desc::m_MaxInputSize permutations, set AOFX_VIEWPORT_SCALE=0 for the packed constants of older releases
+if not defined AOFX_VIEWPORT_SCALE set AOFX_VIEWPORT_SCALE=1
 
-SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl /DAO_BLUR_SEPARABLE=0
+SET FXC_PREPROCESS_CS=fxc.exe /nologo /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
+
+SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl /DAO_BLUR_SEPARABLE=0 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_CS% /E csBilateralBlur /Fh ..\inc\CS_BILATERAL_BLUR_RADIUS_16.inc /Vn CS_BILATERAL_BLUR_RADIUS_16_DATA /DAOFX_BLUR_RADIUS=16
 %FXC_COMPILE_CS% /E csBilateralBlur /Fh ..\inc\CS_BILATERAL_BLUR_RADIUS_15.inc /Vn CS_BILATERAL_BLUR_RADIUS_15_DATA /DAOFX_BLUR_RADIUS=15
@@ -19,7 +22,7 @@ SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_
 %FXC_COMPILE_CS% /E csBilateralBlur /Fh ..\inc\CS_BILATERAL_BLUR_RADIUS_2.inc /Vn CS_BILATERAL_BLUR_RADIUS_2_DATA /DAOFX_BLUR_RADIUS=2
 %FXC_COMPILE_CS% /E csBilateralBlur /Fh ..\inc\CS_BILATERAL_BLUR_RADIUS_1.inc /Vn CS_BILATERAL_BLUR_RADIUS_1_DATA /DAOFX_BLUR_RADIUS=1
 
-SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl /DAO_BLUR_SEPARABLE=1
+SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl /DAO_BLUR_SEPARABLE=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_CS% /E csBilateralBlurVertical /Fh ..\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_16.inc /Vn CS_BILATERAL_BLUR_VERTICAL_RADIUS_16_DATA /DAOFX_BLUR_RADIUS=16
 %FXC_COMPILE_CS% /E csBilateralBlurVertical /Fh ..\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_15.inc /Vn CS_BILATERAL_BLUR_VERTICAL_RADIUS_15_DATA /DAOFX_BLUR_RADIUS=15
@@ -38,7 +41,7 @@ SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_
 %FXC_COMPILE_CS% /E csBilateralBlurVertical /Fh ..\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_2.inc /Vn CS_BILATERAL_BLUR_VERTICAL_RADIUS_2_DATA /DAOFX_BLUR_RADIUS=2
 %FXC_COMPILE_CS% /E csBilateralBlurVertical /Fh ..\inc\CS_BILATERAL_BLUR_VERTICAL_RADIUS_1.inc /Vn CS_BILATERAL_BLUR_VERTICAL_RADIUS_1_DATA /DAOFX_BLUR_RADIUS=1
 
-SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl /DAO_BLUR_SEPARABLE=2
+SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DAOFX_IMPLEMENTATION=0 ..\AMD_Utility.hlsl /DAO_BLUR_SEPARABLE=2 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_CS% /E csBilateralBlurHorizontal /Fh ..\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_16.inc /Vn CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_16_DATA /DAOFX_BLUR_RADIUS=16
 %FXC_COMPILE_CS% /E csBilateralBlurHorizontal /Fh ..\inc\CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_15.inc /Vn CS_BILATERAL_BLUR_HORIZONTAL_RADIUS_15_DATA /DAOFX_BLUR_RADIUS=15
@@ -1,5 +1,8 @@
-SET FXC_COMPILE_VS=fxc.exe /nologo /T vs_5_0 /O3 ..\AMD_Utility.hlsl /DAOFX_IMPLEMENTATION=1
-SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /O3 ..\AMD_Utility.hlsl /DAOFX_IMPLEMENTATION=1
+rem the AOFX_Desc::m_MaxInputSize permutations, set AOFX_VIEWPORT_SCALE=0 for the packed constants of older releases
+if not defined AOFX_VIEWPORT_SCALE set AOFX_VIEWPORT_SCALE=1
+
+SET FXC_COMPILE_VS=fxc.exe /nologo /T vs_5_0 /O3 ..\AMD_Utility.hlsl /DAOFX_IMPLEMENTATION=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
+SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /O3 ..\AMD_Utility.hlsl /DAOFX_IMPLEMENTATION=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_VS% /E vsFullscreen                       /Fh ..\inc\VS_FULLSCREEN.inc                           /Vn VS_FULLSCREEN_Data
 
@@ -14,10 +17,18 @@ SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /O3 ..\AMD_Utility.hlsl /DAOFX_IMPL
 %FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_NYY.inc /Vn PS_DILATE_NYY_Data /DAO_LAYER_MASK=6
 %FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_YYY.inc /Vn PS_DILATE_YYY_Data /DAO_LAYER_MASK=7
 
+%FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_UPSAMPLE_YNN.inc /Vn PS_DILATE_UPSAMPLE_YNN_Data /DAO_LAYER_MASK=1 /DAO_DILATE_UPSAMPLE=1
+%FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_UPSAMPLE_NYN.inc /Vn PS_DILATE_UPSAMPLE_NYN_Data /DAO_LAYER_MASK=2 /DAO_DILATE_UPSAMPLE=1
+%FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_UPSAMPLE_YYN.inc /Vn PS_DILATE_UPSAMPLE_YYN_Data /DAO_LAYER_MASK=3 /DAO_DILATE_UPSAMPLE=1
+%FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_UPSAMPLE_NNY.inc /Vn PS_DILATE_UPSAMPLE_NNY_Data /DAO_LAYER_MASK=4 /DAO_DILATE_UPSAMPLE=1
+%FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_UPSAMPLE_YNY.inc /Vn PS_DILATE_UPSAMPLE_YNY_Data /DAO_LAYER_MASK=5 /DAO_DILATE_UPSAMPLE=1
+%FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_UPSAMPLE_NYY.inc /Vn PS_DILATE_UPSAMPLE_NYY_Data /DAO_LAYER_MASK=6 /DAO_DILATE_UPSAMPLE=1
+%FXC_COMPILE_PS% /E psDilate /Fh ..\inc\PS_DILATE_UPSAMPLE_YYY.inc /Vn PS_DILATE_UPSAMPLE_YYY_Data /DAO_LAYER_MASK=7 /DAO_DILATE_UPSAMPLE=1
+
 rem DEINTERLEAVE SHADERS
 
-SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 ..\AMD_Deinterleave.hlsl /DDEINTERLEAVE_IMPLEMENTATION=0 
-SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /O3 ..\AMD_Deinterleave.hlsl /DDEINTERLEAVE_IMPLEMENTATION=1
+SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 ..\AMD_Deinterleave.hlsl /DDEINTERLEAVE_IMPLEMENTATION=0 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
+SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /O3 ..\AMD_Deinterleave.hlsl /DDEINTERLEAVE_IMPLEMENTATION=1 /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_CS% /E csDeinterleave /Fh ..\inc\CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH_NORMAL.inc /Vn CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH_NORMAL_Data /DDEINTERLEAVE_FACTOR=1 /DAOFX_NORMAL_OPTION=1 /DAO_MSAA_LEVEL=1
 %FXC_COMPILE_CS% /E csDeinterleave /Fh ..\inc\CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH.inc        /Vn CS_DEINTERLEAVE_X1_MSAA_X1_DEPTH_Data        /DDEINTERLEAVE_FACTOR=1 /DAOFX_NORMAL_OPTION=0 /DAO_MSAA_LEVEL=1
@@ -37,7 +48,7 @@ SET FXC_COMPILE_PS=fxc.exe /nologo /T ps_5_0 /O3 ..\AMD_Deinterleave.hlsl /DDEIN
 %FXC_COMPILE_PS% /E psDeinterleave /Fh ..\inc\PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_NORMAL.inc /Vn PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_NORMAL_Data /DDEINTERLEAVE_FACTOR=8 /DAOFX_NORMAL_OPTION=1 /DAO_MSAA_LEVEL=1
 %FXC_COMPILE_PS% /E psDeinterleave /Fh ..\inc\PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH.inc        /Vn PS_DEINTERLEAVE_X8_MSAA_X1_DEPTH_Data        /DDEINTERLEAVE_FACTOR=8 /DAOFX_NORMAL_OPTION=0 /DAO_MSAA_LEVEL=1
 
-SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DUSE_APPROXIMATE_FILTER=1 /DUSE_COMPUTE_SHADER=1 /DLDS_PRECISION=32 ..\BilateralFilter.hlsl 
+SET FXC_COMPILE_CS=fxc.exe /nologo /T cs_5_0 /O3 /DUSE_APPROXIMATE_FILTER=1 /DUSE_COMPUTE_SHADER=1 /DLDS_PRECISION=32 ..\BilateralFilter.hlsl /DAOFX_VIEWPORT_SCALE=%AOFX_VIEWPORT_SCALE%
 
 %FXC_COMPILE_CS% /E CS_FilterX /Fh ..\inc\CS_FILTER_X_RADIUS_1.inc  /Vn CS_FILTER_X_RADIUS_1_Data  /DKERNEL_RADIUS=1
 %FXC_COMPILE_CS% /E CS_FilterY /Fh ..\inc\CS_FILTER_Y_RADIUS_1.inc  /Vn CS_FILTER_Y_RADIUS_1_Data  /DKERNEL_RADIUS=1
@@ -0,0 +1,383 @@
+#
+# Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+# Packs the fxc outputs in ..\inc into ..\inc\AMD_AOFX_ShaderArchive.inc
+#
+# The permutation tables are read from AMD_AOFX_Precompiled.h, so the archive always
+# follows the same order as the raw .inc headers. Identical bytecode is stored once and
+# every blob is compressed in the LZ4 block format, the runtime only unpacks the blobs
+# of the permutations it creates. Each blob is guarded by the AOFX_PERMUTATION_ENABLED
+# tests of its users, so permutations pruned by AMD_AOFX_Permutations.h are not compiled in.
+#
+# ..\inc\AMD_AOFX_ShaderFeatures.inc records which #if AMD_AOFX_*_PRECOMPILED sections have all of
+# their bytecode, and which shaders were compiled with AOFX_VIEWPORT_SCALE=1 (read from the reflection
+# data of the bytecode), so the AMD_AOFX_*_PRECOMPILED defaults follow the bytecode. A mix of shaders
+# compiled with and without AOFX_VIEWPORT_SCALE is rejected.
+#
+# usage: python pack_shaders.py [--verify]
+
+import hashlib
+import os
+import re
+import sys
+
+SCRIPT_DIR      = os.path.dirname(os.path.abspath(__file__))
+INC_DIR         = os.path.join(SCRIPT_DIR, '..', 'inc')
+SOURCE_DIR      = os.path.join(SCRIPT_DIR, '..', '..')
+PRECOMPILED     = os.path.join(SOURCE_DIR, 'AMD_AOFX_Precompiled.h')
+ARCHIVE_NAME    = 'AMD_AOFX_ShaderArchive'
+ARCHIVE         = os.path.join(INC_DIR, ARCHIVE_NAME + '.inc')
+FEATURES_NAME   = 'AMD_AOFX_ShaderFeatures'
+FEATURES        = os.path.join(INC_DIR, FEATURES_NAME + '.inc')
+
+MIN_MATCH       = 4
+LAST_LITERALS   = 5         # the LZ4 block format ends with at least 5 literals
+MATCH_LIMIT     = 12        # and the last match starts at least 12 bytes before the end
+MAX_OFFSET      = 65535
+
+# Constant buffer members only declared with AOFX_VIEWPORT_SCALE=1, next to a member every shader reading that
+# constant buffer declares either way. psOutputRed has no constants, with AOFX_VIEWPORT_SCALE=1 it loads texels
+# instead of sampling them and no longer binds g_ssLinearClamp
+VIEWPORT_MEMBERS = [
+    (b'm_FadeIntervalLength',   b'm_InputUVMax'),   # AO_Data
+    (b'm_ScaleRcp',             b'm_UVMax'),        # AO_InputData
+    (b'CB_DILATE_Data',         b'm_LayerUV'),      # DilateData
+]
+
+
+def lz4_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def lz4_sequence(out, literals, match_length, offset):
+    token_literals = min(len(literals), 15)
+    token_match = 0 if match_length == 0 else min(match_length - MIN_MATCH, 15)
+    out.append((token_literals << 4) | token_match)
+    if len(literals) >= 15:
+        lz4_length(out, len(literals) - 15)
+    out += literals
+    if match_length == 0:
+        return
+    out.append(offset & 0xFF)
+    out.append(offset >> 8)
+    if match_length - MIN_MATCH >= 15:
+        lz4_length(out, match_length - MIN_MATCH - 15)
+
+
+def lz4_compress(data):
+    # greedy parse over a hash table of 4 byte sequences, with a short chain to find longer matches
+    out = bytearray()
+    size = len(data)
+    if size < MATCH_LIMIT + 1:
+        lz4_sequence(out, data, 0, 0)
+        return bytes(out)
+
+    head = {}
+    chain = [-1] * size
+    anchor = 0
+    pos = 0
+    limit = size - MATCH_LIMIT
+    while pos < limit:
+        key = data[pos:pos + MIN_MATCH]
+        best_length = 0
+        best_offset = 0
+        candidate = head.get(key, -1)
+        depth = 0
+        while candidate >= 0 and pos - candidate <= MAX_OFFSET and depth < 32:
+            length = MIN_MATCH
+            end = size - LAST_LITERALS
+            while pos + length < end and data[candidate + length] == data[pos + length]:
+                length += 1
+            if length > best_length:
+                best_length = length
+                best_offset = pos - candidate
+            candidate = chain[candidate]
+            depth += 1
+        chain[pos] = head.get(key, -1)
+        head[key] = pos
+
+        if best_length < MIN_MATCH:
+            pos += 1
+            continue
+
+        lz4_sequence(out, data[anchor:pos], best_length, best_offset)
+        for skipped in range(pos + 1, min(pos + best_length, limit)):
+            skipped_key = data[skipped:skipped + MIN_MATCH]
+            chain[skipped] = head.get(skipped_key, -1)
+            head[skipped_key] = skipped
+        pos += best_length
+        anchor = pos
+
+    lz4_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def lz4_decompress(packed, size):
+    # mirrors unpackShader() in AMD_AOFX_OPAQUE.cpp
+    out = bytearray()
+    pos = 0
+    while pos < len(packed):
+        token = packed[pos]
+        pos += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                extra = packed[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        out += packed[pos:pos + length]
+        pos += length
+        if pos >= len(packed):
+            break
+        offset = packed[pos] | (packed[pos + 1] << 8)
+        pos += 2
+        length = (token & 15) + MIN_MATCH
+        if (token & 15) == 15:
+            while True:
+                extra = packed[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        start = len(out) - offset
+        for i in range(length):
+            out.append(out[start + i])
+    if len(out) != size:
+        raise ValueError('unpacked %d bytes, expected %d' % (len(out), size))
+    return bytes(out)
+
+
+def read_inc(path):
+    with open(path, 'r') as f:
+        text = f.read()
+    match = re.search(r'const BYTE (\w+)\[\] =\s*\{(.*?)\};', text, re.S)
+    if not match:
+        raise ValueError('%s: no bytecode array' % path)
+    values = [v for v in match.group(2).replace('\n', ' ').split(',') if v.strip()]
+    return match.group(1), bytes(int(v, 0) for v in values)
+
+
+def viewport_scale(name, data):
+    # None for shaders that do not depend on AOFX_VIEWPORT_SCALE
+    if name == 'PS_OUTPUT':
+        return b'g_ssLinearClamp' not in data
+    scaled = [member in data for common, member in VIEWPORT_MEMBERS if common in data]
+    if not scaled:
+        return None
+    if min(scaled) != max(scaled):
+        raise ValueError('%s: only some of its constant buffers have the AOFX_VIEWPORT_SCALE members' % name)
+    return scaled[0]
+
+
+def read_precompiled(path):
+    # returns the included arrays and the permutation tables, each with the #if guard it was declared under
+    includes = []
+    tables = []
+    guards = []
+    table = None
+    with open(path, 'r') as f:
+        for line in f:
+            line = line.strip()
+            if table is not None:
+                if line.startswith('};'):
+                    tables.append(table)
+                    table = None
+                elif line and line != '{' and not line.startswith('//'):
+                    table[2].append(line.rstrip(','))
+                continue
+
+            if line.startswith('#if'):
+                # only the #if AMD_AOFX_*_PRECOMPILED blocks select permutations
+                match = re.match(r'#if (AMD_AOFX_\w+_PRECOMPILED)$', line)
+                guards.append(match.group(1) if match else None)
+                continue
+            elif line.startswith('#endif'):
+                guards.pop()
+                continue
+
+            guard = next((g for g in reversed(guards) if g is not None), None)
+            if line.startswith('#include'):
+                name = re.search(r'"Shaders[\\/]inc[\\/](\w+)\.inc"', line).group(1)
+                if name != ARCHIVE_NAME and name != FEATURES_NAME:
+                    includes.append((name, guard))
+            else:
+                match = re.match(r'const BYTE \* (\w+)_Data\[\] =', line)
+                if match:
+                    table = (match.group(1), guard, [])
+    return includes, tables
+
+
+def read_bytecode_uses(path):
+    # shaders that are not part of a permutation table are created with AOFX_SHADER_BYTECODE(NAME)
+    names = set()
+    for source in os.listdir(path):
+        if source.endswith('.cpp'):
+            with open(os.path.join(path, source), 'r') as f:
+                names.update(re.findall(r'AOFX_SHADER_BYTECODE\((\w+)\)', f.read()))
+    return sorted(names)
+
+
+def emit_bytes(out, data):
+    for i in range(0, len(data), 16):
+        out.append('  ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+
+
+def main():
+    verify = '--verify' in sys.argv[1:]
+
+    includes, tables = read_precompiled(PRECOMPILED)
+
+    arrays = {}
+    array_of_include = {}
+    missing = set()
+    for name, guard in includes:
+        path = os.path.join(INC_DIR, name + '.inc')
+        if not os.path.exists(path):
+            if guard is None:
+                raise ValueError('%s: missing, run the fxc_compile_*.bat files first' % path)
+            missing.add(guard)
+            continue
+        array, data = read_inc(path)
+        arrays[array] = data
+        array_of_include[name] = array
+
+    # every compiled shader counts, the ones in missing sections are not packed but would be mixed in later
+    scaled = {}
+    for name, guard in includes:
+        if name in array_of_include:
+            scale = viewport_scale(name, arrays[array_of_include[name]])
+            if scale is not None:
+                scaled.setdefault(scale, []).append(name)
+    if len(scaled) > 1:
+        raise ValueError('%d shaders were compiled with AOFX_VIEWPORT_SCALE=1 and %d without it (e.g. %s), compile all of them again' %
+                         (len(scaled[True]), len(scaled[False]), scaled[False][0]))
+    viewport = True in scaled
+
+    # every table entry and every AOFX_SHADER_BYTECODE(NAME) in the sources is a user of its blob,
+    # a blob is only compiled in when one of its users is enabled by AMD_AOFX_Permutations.h
+    conditions = {}
+    for name, guard, entries in tables:
+        if guard in missing:
+            continue
+        for index, entry in enumerate(entries):
+            if entry == 'NULL':
+                continue
+            condition = 'AOFX_PERMUTATION_ENABLED(%s, %d)' % (name, index)
+            if guard is not None:
+                condition = '(%s && %s)' % (guard, condition)
+            conditions.setdefault(entry, []).append(condition)
+    standalone = [(name, array_of_include[name]) for name in read_bytecode_uses(SOURCE_DIR)]
+    for name, array in standalone:
+        conditions[array] = None
+
+    blobs = []
+    blob_of_hash = {}
+    blob_of_array = {}
+    raw_size = 0
+    packed_size = 0
+    for array in sorted(conditions):
+        data = arrays[array]
+        raw_size += len(data)
+        digest = hashlib.sha1(data).digest()
+        if digest not in blob_of_hash:
+            blob_of_hash[digest] = len(blobs)
+            packed = lz4_compress(data)
+            if verify and lz4_decompress(packed, len(data)) != data:
+                raise ValueError('%s: round trip failed' % array)
+            packed_size += len(packed)
+            blobs.append([re.sub(r'_(Data|DATA)$', '', array), data, packed, []])
+        blob = blobs[blob_of_hash[digest]]
+        blob_of_array[array] = blob
+        if conditions[array] is None or blob[3] is None:
+            blob[3] = None
+        else:
+            blob[3] += conditions[array]
+
+    out = []
+    out.append('// Generated by Shaders\\build\\pack_shaders.py from AMD_AOFX_Precompiled.h, do not edit')
+    out.append('// %d shaders, %d unique blobs, %d bytes of bytecode packed into %d bytes' %
+               (len(conditions), len(blobs), raw_size, packed_size))
+
+    for name, data, packed, users in blobs:
+        out.append('')
+        if users is not None:
+            out.append('#if ' + ' || \\\n    '.join(users))
+        out.append('const BYTE %s_LZ4[] =' % name)
+        out.append('{')
+        emit_bytes(out, packed)
+        out.append('};')
+        out.append('# define %s_PACKED { %s_LZ4, sizeof(%s_LZ4), %d }' % (name, name, name, len(data)))
+        if users is not None:
+            out.append('#else')
+            out.append('# define %s_PACKED { NULL, 0, 0 }' % name)
+            out.append('#endif')
+
+    out.append('')
+    for name, array in sorted(standalone):
+        out.append('const AOFX_ShaderArchiveEntry %s_Packed = %s_PACKED;' % (name, blob_of_array[array][0]))
+
+    for name, guard, entries in tables:
+        if guard in missing:
+            continue
+        out.append('')
+        if guard is not None:
+            out.append('#if ' + guard)
+        out.append('const AOFX_ShaderArchiveEntry %s_Packed[] =' % name)
+        out.append('{')
+        for entry in entries:
+            out.append('  %s,' % ('{ NULL, 0, 0 }' if entry == 'NULL' else blob_of_array[entry][0] + '_PACKED'))
+        out.append('};')
+        if guard is not None:
+            out.append('#endif // ' + guard)
+
+    for guard in sorted(g for g in missing if g is not None):
+        out.append('')
+        out.append('#if ' + guard)
+        out.append('# error "' + guard + ' permutations are missing, compile them with fxc and rerun pack_shaders.py"')
+        out.append('#endif // ' + guard)
+
+    with open(ARCHIVE, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+    features = []
+    features.append('// Generated by Shaders\\build\\pack_shaders.py from the bytecode in this directory, do not edit')
+    features.append('')
+    for guard in sorted(set(g for name, g in includes if g is not None)):
+        features.append('#define AOFX_SHADERS_%s %d' % (guard[len('AMD_AOFX_'):-len('_PRECOMPILED')], 0 if guard in missing else 1))
+    features.append('')
+    features.append('// %d shaders read the viewport texture coordinate constants, compiled with AOFX_VIEWPORT_SCALE=%d' %
+                    (sum(len(names) for names in scaled.values()), 1 if viewport else 0))
+    features.append('#define AOFX_SHADERS_VIEWPORT_SCALE %d' % (1 if viewport else 0))
+    with open(FEATURES, 'w') as f:
+        f.write('\n'.join(features) + '\n')
+
+    print('%d shaders, %d unique blobs' % (len(conditions), len(blobs)))
+    print('%d bytes of bytecode packed into %d bytes (%.1f%%)' % (raw_size, packed_size, 100.0 * packed_size / max(raw_size, 1)))
+    print('AOFX_VIEWPORT_SCALE=%d' % (1 if viewport else 0))
+
+if __name__ == '__main__':
+    main()
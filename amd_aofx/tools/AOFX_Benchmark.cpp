@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: AOFX_Benchmark.cpp
+//
+// CPU submission cost of AOFX_Render on the null device, per configuration:
+//
+//   aofx_benchmark [width height] [--frames N] [--budget microseconds] [--enforce]
+//
+// Every level of the built in governor ladder is measured with AOFX_BenchmarkRender under each
+// AOFX_STATE_RESTORE mode, and reported as ns per AOFX_Render next to the recorded commands per
+// render. Levels over the budget (50 us by default) are flagged; --enforce turns them into a
+// non zero exit code. The timing depends on the host, so the test build only runs it unenforced.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AMD_AOFX.h"
+
+using namespace AMD;
+
+static const char * stateRestoreName(AOFX_STATE_RESTORE stateRestore)
+{
+    static const char * names[AOFX_STATE_RESTORE_COUNT] = { "full", "used", "none" };
+    return names[stateRestore];
+}
+
+static const char * sampleCountName(AOFX_SAMPLE_COUNT sampleCount)
+{
+    static const char * names[AOFX_SAMPLE_COUNT_COUNT] = { "low", "medium", "high", "ultra" };
+    return names[sampleCount];
+}
+
+static const char * blurRadiusName(AOFX_BILATERAL_BLUR_RADIUS radius)
+{
+    static const char * names[AOFX_BILATERAL_BLUR_RADIUS_COUNT] = { "2", "4", "8", "16" };
+    return radius == AOFX_BILATERAL_BLUR_RADIUS_NONE ? "none" : names[radius];
+}
+
+static int usage()
+{
+    fprintf(stderr, "usage: aofx_benchmark [width height] [--frames N] [--budget microseconds] [--enforce]\n");
+    return 1;
+}
+
+int main(int argc, char ** argv)
+{
+    uint width = 1920, height = 1080, frames = 1000, positional = 0;
+    double budgetMicroseconds = 50.0;
+    bool enforce = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = (uint)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+            budgetMicroseconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--enforce") == 0)
+            enforce = true;
+        else if (argv[i][0] != '-' && positional < 2)
+            (positional++ == 0 ? width : height) = (uint)atoi(argv[i]);
+        else
+            return usage();
+    }
+    if (width == 0 || height == 0 || frames == 0 || budgetMicroseconds <= 0.0) return usage();
+
+    ID3D11Device * pDevice = NULL;
+    ID3D11DeviceContext * pContext = NULL;
+    if (AOFX_CreateNullDevice(&pDevice, &pContext) != AOFX_RETURN_CODE_SUCCESS)
+    {
+        fprintf(stderr, "AOFX_CreateNullDevice failed\n");
+        return 1;
+    }
+
+    D3D11_TEXTURE2D_DESC textureDesc;
+    memset(&textureDesc, 0, sizeof(textureDesc));
+    textureDesc.Width = width;
+    textureDesc.Height = height;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    textureDesc.SampleDesc.Count = 1;
+    ID3D11Texture2D * pTexture = NULL;
+    ID3D11ShaderResourceView * pSRV = NULL;
+    ID3D11RenderTargetView * pRTV = NULL;
+    pDevice->CreateTexture2D(&textureDesc, NULL, &pTexture);
+    pDevice->CreateShaderResourceView(pTexture, NULL, &pSRV);
+    pDevice->CreateRenderTargetView(pTexture, NULL, &pRTV);
+
+    AOFX_Desc desc;
+    desc.m_pDevice = pDevice;
+    desc.m_pDeviceContext = pContext;
+    desc.m_pDepthSRV = pSRV;
+    desc.m_pOutputRTV = pRTV;
+    desc.m_InputSize.x = width;
+    desc.m_InputSize.y = height;
+
+    // the built in governor ladder, applied to desc by AOFX_GovernorInitialize one level at a time
+    std::vector<AOFX_QualityLevel> levels;
+    AOFX_GovernorDesc governorDesc;
+    for (uint level = 0; ; level++)
+    {
+        AOFX_Governor governor;
+        bool resize = false;
+        governorDesc.m_StartLevel = level;
+        AOFX_GovernorInitialize(&governor, governorDesc, desc, &resize);
+        if (governor.m_Level != level) break;
+
+        AOFX_QualityLevel quality;
+        for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+        {
+            quality.m_LayerProcess[i] = desc.m_LayerProcess[i];
+            quality.m_MultiResLayerScale[i] = desc.m_MultiResLayerScale[i];
+            quality.m_SampleCount[i] = desc.m_SampleCount[i];
+            quality.m_BilateralBlurRadius[i] = desc.m_BilateralBlurRadius[i];
+        }
+        levels.push_back(quality);
+    }
+
+    if (AOFX_Initialize(desc) != AOFX_RETURN_CODE_SUCCESS || AOFX_Resize(desc) != AOFX_RETURN_CODE_SUCCESS)
+    {
+        fprintf(stderr, "AOFX_Initialize failed\n");
+        return 1;
+    }
+
+    printf("%u x %u, %u frames per level, budget %.1f us\n", width, height, frames, budgetMicroseconds);
+    printf("%-7s  %5s  %5s  %-6s  %-4s  %10s  %10s  %10s  %5s  %6s  %6s  %6s  %8s  %s\n",
+        "restore", "level", "scale", "sample", "blur", "ns/render", "min ns", "max ns", "maps", "binds", "gets", "passes", "bytes", "");
+
+    uint overBudget = 0;
+    std::vector<AOFX_RenderBenchmark> results(levels.size());
+    for (int stateRestore = 0; stateRestore < AOFX_STATE_RESTORE_COUNT; stateRestore++)
+    {
+        desc.m_StateRestore = (AOFX_STATE_RESTORE)stateRestore;
+        if (AOFX_BenchmarkRender(desc, &levels[0], (uint)levels.size(), frames, &results[0]) != AOFX_RETURN_CODE_SUCCESS)
+        {
+            fprintf(stderr, "AOFX_BenchmarkRender failed\n");
+            return 1;
+        }
+
+        for (size_t level = 0; level < levels.size(); level++)
+        {
+            const AOFX_RenderBenchmark & result = results[level];
+            const AOFX_DeviceCounters & counters = result.m_Counters;
+            bool over = result.m_NanosecondsPerRender > budgetMicroseconds * 1000.0;
+            overBudget += over ? 1 : 0;
+
+            printf("%-7s  %5u  %5.2f  %-6s  %-4s  %10.0f  %10.0f  %10.0f  %5.2f  %6.1f  %6.1f  %6.1f  %8.1f  %s\n",
+                stateRestoreName((AOFX_STATE_RESTORE)stateRestore), (uint)level, levels[level].m_MultiResLayerScale[0],
+                sampleCountName(levels[level].m_SampleCount[0]), blurRadiusName(levels[level].m_BilateralBlurRadius[0]),
+                result.m_NanosecondsPerRender, result.m_MinNanoseconds, result.m_MaxNanoseconds,
+                (double)counters.m_Maps / result.m_Frames, (double)counters.m_StateBinds / result.m_Frames, (double)counters.m_StateQueries / result.m_Frames,
+                (double)(counters.m_Dispatches + counters.m_Draws) / result.m_Frames, (double)counters.m_BytesUploaded / result.m_Frames,
+                over ? "OVER BUDGET" : "");
+        }
+    }
+
+    AOFX_Release(desc);
+    pRTV->Release();
+    pSRV->Release();
+    pTexture->Release();
+    pContext->Release();
+    pDevice->Release();
+
+    if (overBudget != 0)
+        printf("%u configuration(s) over the %.1f us budget\n", overBudget, budgetMicroseconds);
+
+    return enforce && overBudget != 0 ? 1 : 0;
+}
@@ -0,0 +1,257 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: AOFX_Pareto.cpp
+//
+// Offline AOFX_Autotune run that prints the SSIM / cost frontier of a depth corpus:
+//
+//   aofx_pareto [width height] [--images N] [--depth file width height]... [--measured] [--presets N] [--csv]
+//
+// --depth adds a raw 32 bit float hardware depth dump (row major, no header) to the corpus,
+// without it N synthetic scenes (a ground plane with boxes) of width x height are generated.
+// The search covers layer 0 with every layer process, sample count, tap type and blur radius
+// at scales 1, 0.75 and 0.5. --measured ranks by CPU time instead of the predicted taps.
+// --csv prints the frontier as comma separated values, e.g. to feed an AOFX_GovernorDesc ladder.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AMD_AOFX.h"
+
+using namespace AMD;
+
+static const float s_NearPlane = 0.1f;
+static const float s_FarPlane = 100.0f;
+static const float s_Fov = 1.0f;
+
+struct DepthImage
+{
+    std::vector<float>  m_Depth;
+    uint                m_Width;
+    uint                m_Height;
+};
+
+//--------------------------------------------------------------------------------------
+// Ground plane at y = -1 with 'scene + 1' boxes at increasing distance
+//--------------------------------------------------------------------------------------
+static void generateScene(DepthImage & image, uint scene)
+{
+    float q = s_FarPlane / (s_FarPlane - s_NearPlane);
+    float tanY = tanf(s_Fov * 0.5f), tanX = tanY * image.m_Width / image.m_Height;
+
+    image.m_Depth.resize((size_t)image.m_Width * image.m_Height);
+    for (uint y = 0; y < image.m_Height; y++)
+    {
+        for (uint x = 0; x < image.m_Width; x++)
+        {
+            float rayX = ((x + 0.5f) * 2.0f / image.m_Width - 1.0f) * tanX;
+            float rayY = -((y + 0.5f) * 2.0f / image.m_Height - 1.0f) * tanY;
+            float z = 20.0f;
+            if (rayY < 0.0f) z = std::min(z, -1.0f / rayY);
+
+            for (uint box = 0; box <= scene; box++)
+            {
+                float distance = 2.5f + 1.5f * box;
+                float center = ((box + scene) % 3 - 1.0f) * 0.8f;
+                float bx = rayX * distance, by = rayY * distance;
+                if (bx > center - 0.4f && bx < center + 0.4f && by > -1.0f && by < -0.2f + 0.2f * box)
+                    z = std::min(z, distance);
+            }
+
+            image.m_Depth[y * image.m_Width + x] = q - q * s_NearPlane / z;
+        }
+    }
+}
+
+static bool loadDepth(DepthImage & image, const char * pFileName)
+{
+    FILE * pFile = fopen(pFileName, "rb");
+    if (pFile == NULL) return false;
+
+    image.m_Depth.resize((size_t)image.m_Width * image.m_Height);
+    size_t read = fread(&image.m_Depth[0], sizeof(float), image.m_Depth.size(), pFile);
+    fclose(pFile);
+
+    return read == image.m_Depth.size();
+}
+
+static const char * processName(AOFX_LAYER_PROCESS process)
+{
+    static const char * names[AOFX_LAYER_PROCESS_COUNT] = { "full", "deint2", "deint4", "deint8" };
+    return process < AOFX_LAYER_PROCESS_COUNT ? names[process] : "none";
+}
+
+static const char * sampleCountName(AOFX_SAMPLE_COUNT sampleCount)
+{
+    static const char * names[AOFX_SAMPLE_COUNT_COUNT] = { "low", "medium", "high", "ultra" };
+    return names[sampleCount];
+}
+
+static const char * tapTypeName(AOFX_TAP_TYPE tapType)
+{
+    static const char * names[AOFX_TAP_TYPE_COUNT] = { "fixed", "random_cb", "random_srv" };
+    return names[tapType];
+}
+
+static const char * blurRadiusName(AOFX_BILATERAL_BLUR_RADIUS radius)
+{
+    static const char * names[AOFX_BILATERAL_BLUR_RADIUS_COUNT] = { "2", "4", "8", "16" };
+    return radius == AOFX_BILATERAL_BLUR_RADIUS_NONE ? "none" : names[radius];
+}
+
+static int usage()
+{
+    fprintf(stderr, "usage: aofx_pareto [width height] [--images N] [--depth file width height]... [--measured] [--presets N] [--csv]\n");
+    return 1;
+}
+
+int main(int argc, char ** argv)
+{
+    uint width = 160, height = 90, imageCount = 4, maxPresets = 16, positional = 0;
+    bool measured = false, csv = false;
+    std::vector<DepthImage> corpus;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--images") == 0 && i + 1 < argc)
+        {
+            imageCount = (uint)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--presets") == 0 && i + 1 < argc)
+        {
+            maxPresets = (uint)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--depth") == 0 && i + 3 < argc)
+        {
+            DepthImage image;
+            const char * pFileName = argv[++i];
+            image.m_Width = (uint)atoi(argv[++i]);
+            image.m_Height = (uint)atoi(argv[++i]);
+            if (!loadDepth(image, pFileName))
+            {
+                fprintf(stderr, "could not read %u x %u depth values from %s\n", image.m_Width, image.m_Height, pFileName);
+                return 1;
+            }
+            corpus.push_back(image);
+        }
+        else if (strcmp(argv[i], "--measured") == 0)
+        {
+            measured = true;
+        }
+        else if (strcmp(argv[i], "--csv") == 0)
+        {
+            csv = true;
+        }
+        else if (argv[i][0] != '-' && positional < 2)
+        {
+            (positional++ == 0 ? width : height) = (uint)atoi(argv[i]);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (maxPresets == 0) return usage();
+
+    bool loaded = !corpus.empty();
+    for (uint i = 0; !loaded && i < imageCount; i++)
+    {
+        DepthImage image;
+        image.m_Width = width;
+        image.m_Height = height;
+        generateScene(image, i);
+        corpus.push_back(image);
+    }
+    if (corpus.empty()) return usage();
+
+    std::vector<AOFX_BatchImage> images(corpus.size());
+    for (size_t i = 0; i < corpus.size(); i++)
+    {
+        images[i].m_pDepth = &corpus[i].m_Depth[0];
+        images[i].m_Size.x = corpus[i].m_Width;
+        images[i].m_Size.y = corpus[i].m_Height;
+        images[i].m_Camera.m_NearPlane = s_NearPlane;
+        images[i].m_Camera.m_FarPlane = s_FarPlane;
+        images[i].m_Camera.m_Fov = s_Fov;
+        images[i].m_Camera.m_Aspect = (float)corpus[i].m_Width / corpus[i].m_Height;
+    }
+
+    AOFX_Desc desc;
+    desc.m_LayerProcess[1] = AOFX_LAYER_PROCESS_NONE;
+    desc.m_LayerProcess[2] = AOFX_LAYER_PROCESS_NONE;
+
+    static const float layerScales[] = { 1.0f, 0.75f, 0.5f };
+    AOFX_AutotuneDesc autotune;
+    autotune.m_pImages = &images[0];
+    autotune.m_ImageCount = (uint)images.size();
+    autotune.m_LayerMask = 1;
+    autotune.m_LayerProcessMask = (1 << AOFX_LAYER_PROCESS_COUNT) - 1;
+    autotune.m_SampleCountMask = (1 << AOFX_SAMPLE_COUNT_COUNT) - 1;
+    autotune.m_TapTypeMask = (1 << AOFX_TAP_TYPE_COUNT) - 1;
+    autotune.m_BlurRadiusMask = (1 << (AOFX_BILATERAL_BLUR_RADIUS_COUNT + 1)) - 1;
+    autotune.m_pLayerScales = layerScales;
+    autotune.m_LayerScaleCount = sizeof(layerScales) / sizeof(layerScales[0]);
+    autotune.m_MeasuredCost = measured;
+
+    std::vector<AOFX_AutotunePreset> presets(maxPresets);
+    AOFX_AutotuneResult result;
+    result.m_pPresets = &presets[0];
+    result.m_MaxPresetCount = maxPresets;
+
+    AOFX_RETURN_CODE code = AOFX_Autotune(desc, autotune, &result);
+    if (code != AOFX_RETURN_CODE_SUCCESS)
+    {
+        fprintf(stderr, "AOFX_Autotune failed (%d)\n", (int)code);
+        return 1;
+    }
+
+    if (csv)
+    {
+        printf("ssim,psnr,milliseconds,taps,process,scale,sample_count,tap_type,blur_radius\n");
+    }
+    else
+    {
+        printf("%u images, %u candidates, %u on the frontier, %.2f s\n", (uint)images.size(), result.m_CandidateCount, result.m_FrontierCount, result.m_Seconds);
+        printf("%7s  %7s  %8s  %10s  %-7s  %5s  %-6s  %-10s  %-4s\n", "SSIM", "PSNR", "ms", "Mtaps", "process", "scale", "sample", "taps", "blur");
+    }
+
+    for (uint i = 0; i < result.m_PresetCount; i++)
+    {
+        const AOFX_AutotunePreset & preset = presets[i];
+        const AOFX_QualityLevel & level = preset.m_Level;
+        if (csv)
+            printf("%.6f,%.3f,%.4f,%u,%s,%.2f,%s,%s,%s\n", preset.m_SSIM, preset.m_PSNR, preset.m_Milliseconds, (uint)preset.m_PredictedCost.m_Taps,
+                processName(level.m_LayerProcess[0]), level.m_MultiResLayerScale[0], sampleCountName(level.m_SampleCount[0]), tapTypeName(preset.m_TapType), blurRadiusName(level.m_BilateralBlurRadius[0]));
+        else
+            printf("%7.4f  %7.2f  %8.3f  %10.3f  %-7s  %5.2f  %-6s  %-10s  %-4s\n", preset.m_SSIM, preset.m_PSNR, preset.m_Milliseconds, preset.m_PredictedCost.m_Taps / 1.0e6,
+                processName(level.m_LayerProcess[0]), level.m_MultiResLayerScale[0], sampleCountName(level.m_SampleCount[0]), tapTypeName(preset.m_TapType), blurRadiusName(level.m_BilateralBlurRadius[0]));
+    }
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: AOFX_Rank.cpp
+//
+// Ranks AOFX configurations by their AOFX_EstimateCost prediction, without a device:
+//
+//   aofx_rank [width height] [--top N] [--sort taps|bytes|memory]
+//
+// Every configuration applies the same layer process, sample count and blur radius to
+// its active layers, the layers keep the default AOFX_Desc scales. Like AOFX_Autotune the
+// default order is the predicted tap count.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AMD_AOFX.h"
+
+using namespace AMD;
+
+enum RANK_SORT
+{
+    RANK_SORT_TAPS = 0,
+    RANK_SORT_BYTES = 1,
+    RANK_SORT_MEMORY = 2,
+};
+
+struct RankEntry
+{
+    uint                        m_LayerCount;
+    AOFX_LAYER_PROCESS          m_LayerProcess;
+    AOFX_SAMPLE_COUNT           m_SampleCount;
+    AOFX_BILATERAL_BLUR_RADIUS  m_BlurRadius;
+
+    size_t                      m_Taps;
+    size_t                      m_Bytes;
+    size_t                      m_Memory;
+    size_t                      m_ThreadGroups;
+    uint                        m_Passes;
+};
+
+static RANK_SORT s_Sort = RANK_SORT_TAPS;
+
+static size_t sortKey(const RankEntry & entry)
+{
+    switch (s_Sort)
+    {
+    case RANK_SORT_BYTES:   return entry.m_Bytes;
+    case RANK_SORT_MEMORY:  return entry.m_Memory;
+    default:                return entry.m_Taps;
+    }
+}
+
+static bool cheaper(const RankEntry & a, const RankEntry & b)
+{
+    size_t keyA = sortKey(a), keyB = sortKey(b);
+    if (keyA != keyB) return keyA < keyB;
+    return a.m_Taps < b.m_Taps;
+}
+
+static const char * processName(AOFX_LAYER_PROCESS process)
+{
+    switch (process)
+    {
+    case AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE:  return "full";
+    case AOFX_LAYER_PROCESS_DEINTERLEAVE_2:     return "deint2";
+    case AOFX_LAYER_PROCESS_DEINTERLEAVE_4:     return "deint4";
+    case AOFX_LAYER_PROCESS_DEINTERLEAVE_8:     return "deint8";
+    default:                                    return "none";
+    }
+}
+
+static const char * sampleCountName(AOFX_SAMPLE_COUNT sampleCount)
+{
+    static const char * names[AOFX_SAMPLE_COUNT_COUNT] = { "low", "medium", "high", "ultra" };
+    return names[sampleCount];
+}
+
+static const char * blurRadiusName(AOFX_BILATERAL_BLUR_RADIUS radius)
+{
+    static const char * names[AOFX_BILATERAL_BLUR_RADIUS_COUNT] = { "2", "4", "8", "16" };
+    return radius == AOFX_BILATERAL_BLUR_RADIUS_NONE ? "none" : names[radius];
+}
+
+static int usage()
+{
+    fprintf(stderr, "usage: aofx_rank [width height] [--top N] [--sort taps|bytes|memory]\n");
+    return 1;
+}
+
+int main(int argc, char ** argv)
+{
+    uint width = 1920, height = 1080;
+    size_t top = 20;
+    uint positional = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--top") == 0 && i + 1 < argc)
+        {
+            top = (size_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--sort") == 0 && i + 1 < argc)
+        {
+            const char * sort = argv[++i];
+            if (strcmp(sort, "taps") == 0) s_Sort = RANK_SORT_TAPS;
+            else if (strcmp(sort, "bytes") == 0) s_Sort = RANK_SORT_BYTES;
+            else if (strcmp(sort, "memory") == 0) s_Sort = RANK_SORT_MEMORY;
+            else return usage();
+        }
+        else if (argv[i][0] != '-' && positional < 2)
+        {
+            (positional++ == 0 ? width : height) = (uint)atoi(argv[i]);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (width == 0 || height == 0) return usage();
+
+    std::vector<RankEntry> entries;
+    for (uint layerCount = 1; layerCount <= AOFX_Desc::m_MultiResLayerCount; layerCount++)
+    {
+        for (int process = AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE; process < AOFX_LAYER_PROCESS_COUNT; process++)
+        {
+            for (int sampleCount = 0; sampleCount < AOFX_SAMPLE_COUNT_COUNT; sampleCount++)
+            {
+                for (int radius = AOFX_BILATERAL_BLUR_RADIUS_NONE; radius < AOFX_BILATERAL_BLUR_RADIUS_COUNT; radius++)
+                {
+                    AOFX_Desc desc;
+                    desc.m_InputSize.x = width;
+                    desc.m_InputSize.y = height;
+                    for (uint layer = 0; layer < AOFX_Desc::m_MultiResLayerCount; layer++)
+                    {
+                        desc.m_LayerProcess[layer] = layer < layerCount ? (AOFX_LAYER_PROCESS)process : AOFX_LAYER_PROCESS_NONE;
+                        desc.m_SampleCount[layer] = (AOFX_SAMPLE_COUNT)sampleCount;
+                        desc.m_BilateralBlurRadius[layer] = (AOFX_BILATERAL_BLUR_RADIUS)radius;
+                    }
+
+                    AOFX_CostEstimate estimate;
+                    if (AOFX_EstimateCost(desc, &estimate) != AOFX_RETURN_CODE_SUCCESS)
+                    {
+                        fprintf(stderr, "AOFX_EstimateCost failed\n");
+                        return 1;
+                    }
+
+                    RankEntry entry;
+                    entry.m_LayerCount = layerCount;
+                    entry.m_LayerProcess = (AOFX_LAYER_PROCESS)process;
+                    entry.m_SampleCount = (AOFX_SAMPLE_COUNT)sampleCount;
+                    entry.m_BlurRadius = (AOFX_BILATERAL_BLUR_RADIUS)radius;
+                    entry.m_Taps = estimate.m_Total.m_Taps;
+                    entry.m_Bytes = estimate.m_Total.m_BytesRead + estimate.m_Total.m_BytesWritten;
+                    entry.m_Memory = estimate.m_Memory.m_Total;
+                    entry.m_ThreadGroups = estimate.m_Total.m_ThreadGroups;
+                    entry.m_Passes = estimate.m_Total.m_Passes;
+                    entries.push_back(entry);
+                }
+            }
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), cheaper);
+    if (top == 0 || top > entries.size()) top = entries.size();
+
+    printf("%u x %u, %u configurations\n", width, height, (uint)entries.size());
+    printf("%4s  %6s  %-7s  %-6s  %-4s  %10s  %10s  %10s  %10s  %6s\n",
+        "rank", "layers", "process", "sample", "blur", "Mtaps", "MB moved", "MB memory", "groups", "passes");
+    for (size_t i = 0; i < top; i++)
+    {
+        const RankEntry & entry = entries[i];
+        printf("%4u  %6u  %-7s  %-6s  %-4s  %10.2f  %10.2f  %10.2f  %10u  %6u\n",
+            (uint)(i + 1), entry.m_LayerCount, processName(entry.m_LayerProcess), sampleCountName(entry.m_SampleCount), blurRadiusName(entry.m_BlurRadius),
+            entry.m_Taps / 1.0e6, entry.m_Bytes / (1024.0 * 1024.0), entry.m_Memory / (1024.0 * 1024.0), (uint)entry.m_ThreadGroups, entry.m_Passes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: AOFX_Replay.cpp
+//
+// Renders a frame range of an AOFX capture with the CPU reference path and writes the AO:
+//
+//   aofx_replay capture [--first N] [--count N] [--threads N] [--output prefix] [--record width height frames]
+//
+// Every frame is rendered with the settings and camera it was captured with. --output writes
+// the AO of frame F to prefix_F.raw as 32 bit floats (row major, no header, the layout
+// aofx_pareto --depth reads). --record first writes a capture of a synthetic scene (a ground
+// plane with boxes moving towards the camera, the sample count changing every 4 frames) to
+// the capture file, so the tool can be run without an application that captures.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AMD_AOFX.h"
+
+using namespace AMD;
+
+static const float s_NearPlane = 0.1f;
+static const float s_FarPlane = 100.0f;
+static const float s_Fov = 1.0f;
+
+struct ReplayedFrame
+{
+    uint                m_Width;
+    uint                m_Height;
+    double              m_MeanAO;
+    double              m_MinAO;
+    bool                m_Stored;
+};
+
+struct ReplayOutput
+{
+    const char *                m_pPrefix;
+    uint                        m_FirstFrame;
+    std::vector<ReplayedFrame>  m_Frames;
+};
+
+//--------------------------------------------------------------------------------------
+// Ground plane at y = -1 with three boxes, 'frame' moves them towards the camera
+//--------------------------------------------------------------------------------------
+static void generateFrame(std::vector<float> & depth, uint width, uint height, uint frame)
+{
+    float q = s_FarPlane / (s_FarPlane - s_NearPlane);
+    float tanY = tanf(s_Fov * 0.5f), tanX = tanY * width / height;
+
+    depth.resize((size_t)width * height);
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            float rayX = ((x + 0.5f) * 2.0f / width - 1.0f) * tanX;
+            float rayY = -((y + 0.5f) * 2.0f / height - 1.0f) * tanY;
+            float z = 20.0f;
+            if (rayY < 0.0f) z = std::min(z, -1.0f / rayY);
+
+            for (uint box = 0; box < 3; box++)
+            {
+                float distance = std::max(1.5f, 3.0f + 2.0f * box - 0.1f * frame);
+                float center = (box - 1.0f) * 0.9f;
+                float bx = rayX * distance, by = rayY * distance;
+                if (bx > center - 0.4f && bx < center + 0.4f && by > -1.0f && by < -0.2f + 0.2f * box)
+                    z = std::min(z, distance);
+            }
+
+            depth[y * width + x] = q - q * s_NearPlane / z;
+        }
+    }
+}
+
+static bool recordCapture(const char * pFileName, uint width, uint height, uint frameCount)
+{
+    AOFX_CaptureStream * pStream = NULL;
+    if (AOFX_CaptureOpen(pFileName, &pStream) != AOFX_RETURN_CODE_SUCCESS)
+        return false;
+
+    AOFX_Desc desc;
+    std::vector<float> depth;
+    bool appended = true;
+    for (uint frame = 0; frame < frameCount && appended; frame++)
+    {
+        generateFrame(depth, width, height, frame);
+        desc.m_SampleCount[0] = (AOFX_SAMPLE_COUNT)(frame / 4 % AOFX_SAMPLE_COUNT_COUNT);
+
+        AOFX_BatchImage image;
+        image.m_pDepth = &depth[0];
+        image.m_Size.x = width;
+        image.m_Size.y = height;
+        image.m_Camera.m_NearPlane = s_NearPlane;
+        image.m_Camera.m_FarPlane = s_FarPlane;
+        image.m_Camera.m_Fov = s_Fov;
+        image.m_Camera.m_Aspect = (float)width / height;
+        appended = AOFX_CaptureAppendImage(pStream, desc, image) == AOFX_RETURN_CODE_SUCCESS;
+    }
+
+    AOFX_CaptureStats stats;
+    bool closed = AOFX_CaptureClose(pStream, &stats) == AOFX_RETURN_CODE_SUCCESS;
+    if (appended && closed)
+        printf("recorded %u frames of %u x %u, %.1f : 1\n", stats.m_FrameCount, width, height, stats.m_CompressedBytes > 0 ? (double)stats.m_RawBytes / stats.m_CompressedBytes : 0.0);
+    return appended && closed;
+}
+
+// Called from the batch workers, every frame only touches its own entry and file
+static bool storeFrame(const AOFX_BatchImage & image, uint index, AOFX_RETURN_CODE result, void * pUserData)
+{
+    ReplayOutput & output = *(ReplayOutput *)pUserData;
+    if (result != AOFX_RETURN_CODE_SUCCESS)
+        return false;
+
+    ReplayedFrame & frame = output.m_Frames[index - output.m_FirstFrame];
+    const size_t texels = (size_t)image.m_Size.x * image.m_Size.y;
+    double sum = 0.0, minimum = 1.0;
+    for (size_t i = 0; i < texels; i++)
+    {
+        sum += image.m_pOutput[i];
+        minimum = std::min(minimum, (double)image.m_pOutput[i]);
+    }
+    frame.m_Width = image.m_Size.x;
+    frame.m_Height = image.m_Size.y;
+    frame.m_MeanAO = sum / texels;
+    frame.m_MinAO = minimum;
+
+    if (output.m_pPrefix != NULL)
+    {
+        char fileName[1024];
+        snprintf(fileName, sizeof(fileName), "%s_%u.raw", output.m_pPrefix, index);
+        FILE * pFile = fopen(fileName, "wb");
+        if (pFile == NULL)
+            return false;
+        size_t written = fwrite(image.m_pOutput, sizeof(float), texels, pFile);
+        fclose(pFile);
+        if (written != texels)
+            return false;
+    }
+
+    frame.m_Stored = true;
+    return true;
+}
+
+static int usage()
+{
+    fprintf(stderr, "usage: aofx_replay capture [--first N] [--count N] [--threads N] [--output prefix] [--record width height frames]\n");
+    return 1;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * pCapture = NULL;
+    const char * pPrefix = NULL;
+    uint first = 0, count = 0, threadCount = 0;
+    uint recordWidth = 0, recordHeight = 0, recordFrames = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--first") == 0 && i + 1 < argc)
+        {
+            first = (uint)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+        {
+            count = (uint)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCount = (uint)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            pPrefix = argv[++i];
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 3 < argc)
+        {
+            recordWidth = (uint)atoi(argv[++i]);
+            recordHeight = (uint)atoi(argv[++i]);
+            recordFrames = (uint)atoi(argv[++i]);
+            if (recordWidth == 0 || recordHeight == 0 || recordFrames == 0) return usage();
+        }
+        else if (argv[i][0] != '-' && pCapture == NULL)
+        {
+            pCapture = argv[i];
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (pCapture == NULL) return usage();
+
+    if (recordFrames > 0 && !recordCapture(pCapture, recordWidth, recordHeight, recordFrames))
+    {
+        fprintf(stderr, "could not record %s\n", pCapture);
+        return 1;
+    }
+
+    AOFX_ReplayStream * pStream = NULL;
+    if (AOFX_ReplayOpen(pCapture, &pStream) != AOFX_RETURN_CODE_SUCCESS)
+    {
+        fprintf(stderr, "could not open capture %s\n", pCapture);
+        return 1;
+    }
+
+    uint frameCount = 0;
+    AOFX_ReplayGetFrameCount(pStream, &frameCount);
+    if (count == 0 && first < frameCount) count = frameCount - first;
+    if (count == 0 || first >= frameCount || count > frameCount - first)
+    {
+        fprintf(stderr, "frames [%u, %u) are not in the %u frames of %s\n", first, first + count, frameCount, pCapture);
+        AOFX_ReplayClose(pStream);
+        return 1;
+    }
+
+    ReplayOutput output;
+    output.m_pPrefix = pPrefix;
+    output.m_FirstFrame = first;
+    output.m_Frames.resize(count);
+    memset(&output.m_Frames[0], 0, count * sizeof(ReplayedFrame));
+
+    AOFX_BatchDesc batch;
+    batch.m_ThreadCount = threadCount;
+    batch.m_pStore = storeFrame;
+    batch.m_pUserData = &output;
+
+    AOFX_Desc desc;
+    AOFX_BatchStats stats;
+    AOFX_RETURN_CODE code = AOFX_ReplayRender(pStream, desc, first, count, batch, &stats);
+    AOFX_ReplayClose(pStream);
+
+    printf("%u of %u frames, %u threads, %.2f s, %.1f frames/s, %.1f MTexels/s\n", stats.m_ImagesProcessed, frameCount, stats.m_ThreadCount,
+        stats.m_Seconds, stats.m_ImagesPerSecond, stats.m_MegaTexelsPerSecond);
+    printf("%6s  %11s  %8s  %8s\n", "frame", "size", "mean AO", "min AO");
+    for (uint i = 0; i < count; i++)
+    {
+        const ReplayedFrame & frame = output.m_Frames[i];
+        if (frame.m_Stored)
+            printf("%6u  %5u x %-5u  %8.4f  %8.4f\n", first + i, frame.m_Width, frame.m_Height, frame.m_MeanAO, frame.m_MinAO);
+        else
+            printf("%6u  %11s\n", first + i, "failed");
+    }
+
+    if (code != AOFX_RETURN_CODE_SUCCESS || stats.m_ImagesFailed > 0)
+    {
+        fprintf(stderr, "AOFX_ReplayRender failed (%d), %u frames failed\n", (int)code, stats.m_ImagesFailed);
+        return 1;
+    }
+
+    return 0;
+}
@@ -221,6 +221,9 @@ enum IDC_VALUES
     IDC_STATIC_AO_RANDOM_TAPS,
     IDC_COMBOBOX_AO_RANDOM_TAPS,
 
+    IDC_STATIC_AO_KERNEL_TYPE,
+    IDC_COMBOBOX_AO_KERNEL_TYPE,
+
     IDC_CHECKBOX_AO_ENABLE_NORMALS,
     IDC_CHECKBOX_AO_KERNEL_IMPLEMENTATION_PS,
     IDC_CHECKBOX_AO_UTILITY_IMPLEMENTATION_PS,
@@ -478,6 +481,7 @@ void SetUIFromAO(unsigned int layer)
 
     g_HUD.m_GUI.GetCheckBox(IDC_CHECKBOX_AO_ENABLE_NORMALS)->SetChecked(g_aoDesc.m_NormalOption[layer] == AMD::AOFX_NORMAL_OPTION_READ_FROM_SRV);
     g_HUD.m_GUI.GetComboBox(IDC_COMBOBOX_AO_RANDOM_TAPS)->SetSelectedByIndex(g_aoDesc.m_TapType[layer]);
+    g_HUD.m_GUI.GetComboBox(IDC_COMBOBOX_AO_KERNEL_TYPE)->SetSelectedByIndex(g_aoDesc.m_KernelType[layer]);
     g_HUD.m_GUI.GetComboBox(IDC_COMBOBOX_AOFX_SAMPLE_COUNT)->SetSelectedByIndex(g_aoDesc.m_SampleCount[layer]);
 
 
@@ -564,6 +568,19 @@ void InitUI()
         pCombo->SetSelectedByIndex(index);
     }
 
+    g_HUD.m_GUI.AddStatic(IDC_STATIC_AO_KERNEL_TYPE, L"AO Kernel:", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight);
+    g_HUD.m_GUI.AddComboBox(IDC_COMBOBOX_AO_KERNEL_TYPE, AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, 0, true, &pCombo);
+    if (pCombo)
+    {
+        pCombo->SetDropHeight(25);
+        pCombo->AddItem(L"HDAO", NULL);
+        bool gtaoSupported = false;
+        if (AMD::AOFX_GetKernelSupport(AMD::AOFX_KERNEL_TYPE_GTAO, &gtaoSupported) == AMD::AOFX_RETURN_CODE_SUCCESS && gtaoSupported)
+            pCombo->AddItem(L"GTAO", NULL);
+        int index = (int)g_aoDesc.m_KernelType[g_aoLayer];
+        pCombo->SetSelectedByIndex(index);
+    }
+
     g_HUD.m_GUI.AddStatic(IDC_STATIC_AO_LAYER_TECH, L"AO Technique:", AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight);
     g_HUD.m_GUI.AddComboBox(IDC_COMBOBOX_AO_LAYER_TECH, AMD::HUD::iElementOffset, iY += AMD::HUD::iElementDelta, AMD::HUD::iElementWidth, AMD::HUD::iElementHeight, 0, true, &pCombo);
     if (pCombo)
@@ -1268,6 +1285,10 @@ void CALLBACK OnGUIEvent(UINT nEvent, int nControlID, CDXUTControl* pControl, vo
     g_aoDesc.m_TapType[g_aoLayer] = (AMD::AOFX_TAP_TYPE)((CDXUTComboBox*)pControl)->GetSelectedIndex();
     break;
 
+    case IDC_COMBOBOX_AO_KERNEL_TYPE:
+    g_aoDesc.m_KernelType[g_aoLayer] = (AMD::AOFX_KERNEL_TYPE)((CDXUTComboBox*)pControl)->GetSelectedIndex();
+    break;
+
     case IDC_CHECKBOX_AO_KERNEL_IMPLEMENTATION_PS:
     case IDC_CHECKBOX_AO_UTILITY_IMPLEMENTATION_PS:
     g_aoDesc.m_Implementation = AMD::AOFX_IMPLEMENTATION_MASK_BLUR_PS;
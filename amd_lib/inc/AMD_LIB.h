@@ -36,6 +36,7 @@
 #include "../src/AMD_Buffer.h"
 #include "../src/AMD_Rand.h"
 #include "../src/AMD_SaveRestoreState.h"
+#include "../src/AMD_StateCache.h"
 #include "../src/AMD_FullscreenPass.h"
 #include "../src/AMD_UnitCube.h"
 
@@ -26,8 +26,8 @@
 
 #include "AMD_FullscreenPass.h"
 
-#include "Shaders\inc\VS_FULLSCREEN.inc"
-#include "Shaders\inc\PS_FULLSCREEN.inc"
+#include "Shaders/inc/VS_FULLSCREEN.inc"
+#include "Shaders/inc/PS_FULLSCREEN.inc"
 
 #pragma warning( disable : 4100 ) // disable unreference formal parameter warnings for /W4 builds
 
@@ -82,6 +82,35 @@ namespace AMD
                                              pOutputBS, pOutputRS, 1);
     }
 
+    HRESULT RenderFullscreenPass(
+        C_StateCache &              stateCache,
+        D3D11_VIEWPORT              Viewport,
+        ID3D11VertexShader*         pVS,
+        ID3D11PixelShader*          pPS,
+        D3D11_RECT*                 pScissor,   unsigned int uNumSR,
+        ID3D11Buffer**              ppCB,       unsigned int uNumCBs,
+        ID3D11SamplerState**        ppSamplers, unsigned int uNumSamplers,
+        ID3D11ShaderResourceView**  ppSRVs,     unsigned int uNumSRVs,
+        ID3D11RenderTargetView**    ppRTVs,     unsigned int uNumRTVs,
+        ID3D11UnorderedAccessView** ppUAVs,     unsigned int uStartUAV, unsigned int uNumUAVs,
+        ID3D11DepthStencilView*     pDSV,
+        ID3D11DepthStencilState*    pOutputDSS, unsigned int uStencilRef,
+        ID3D11BlendState *          pOutputBS,
+        ID3D11RasterizerState *     pOutputRS)
+    {
+        return RenderFullscreenInstancedPass(stateCache, 
+                                             Viewport, 
+                                             pVS, NULL, pPS, 
+                                             pScissor, uNumSR,
+                                             ppCB, uNumCBs,
+                                             ppSamplers, uNumSamplers,
+                                             ppSRVs, uNumSRVs,
+                                             ppRTVs, uNumRTVs,
+                                             ppUAVs, uStartUAV, uNumUAVs,
+                                             pDSV, pOutputDSS, uStencilRef,
+                                             pOutputBS, pOutputRS, 1);
+    }
+
     HRESULT RenderFullscreenInstancedPass(
         ID3D11DeviceContext*        pDeviceContext,
         D3D11_VIEWPORT              Viewport,
@@ -99,6 +128,39 @@ namespace AMD
         ID3D11BlendState *          pOutputBS,
         ID3D11RasterizerState *     pOutputRS,
         unsigned int                instanceCount)
+    {
+        C_StateCache stateCache(pDeviceContext, false);
+
+        return RenderFullscreenInstancedPass(stateCache,
+                                             Viewport,
+                                             pVS, pGS, pPS,
+                                             pScissor, uNumSR,
+                                             ppCB, uNumCBs,
+                                             ppSamplers, uNumSamplers,
+                                             ppSRVs, uNumSRVs,
+                                             ppRTVs, uNumRTVs,
+                                             ppUAVs, uStartUAV, uNumUAVs,
+                                             pDSV, pOutputDSS, uStencilRef,
+                                             pOutputBS, pOutputRS, instanceCount);
+    }
+
+    HRESULT RenderFullscreenInstancedPass(
+        C_StateCache &              stateCache,
+        D3D11_VIEWPORT              Viewport,
+        ID3D11VertexShader*         pVS,
+        ID3D11GeometryShader*       pGS,
+        ID3D11PixelShader*          pPS,
+        D3D11_RECT*                 pScissor,   unsigned int uNumSR,
+        ID3D11Buffer**              ppCB,       unsigned int uNumCBs,
+        ID3D11SamplerState**        ppSamplers, unsigned int uNumSamplers,
+        ID3D11ShaderResourceView**  ppSRVs,     unsigned int uNumSRVs,
+        ID3D11RenderTargetView**    ppRTVs,     unsigned int uNumRTVs,
+        ID3D11UnorderedAccessView** ppUAVs,    unsigned int uStartUAV, unsigned int uNumUAVs,
+        ID3D11DepthStencilView*     pDSV,
+        ID3D11DepthStencilState*    pOutputDSS, unsigned int uStencilRef,
+        ID3D11BlendState *          pOutputBS,
+        ID3D11RasterizerState *     pOutputRS,
+        unsigned int                instanceCount)
     {
         float white[] = {1.0f, 1.0f, 1.0f, 1.0f};
         ID3D11ShaderResourceView*  pNullSRV[8]    = { NULL };
@@ -108,44 +170,44 @@ namespace AMD
         uint NullStride[8] = { 0 };
         uint NullOffset[8] = { 0 } ;
 
-        if ((pDeviceContext == NULL || pVS == NULL || pPS == NULL || (ppRTVs == NULL && pDSV == NULL && ppUAVs == NULL)))
+        if ((stateCache.GetContext() == NULL || pVS == NULL || pPS == NULL || (ppRTVs == NULL && pDSV == NULL && ppUAVs == NULL)))
         {
             AMD_OUTPUT_DEBUG_STRING("Invalid pointer argument in function %s\n", AMD_FUNCTION_NAME);
             return E_POINTER;
         }
 
-        pDeviceContext->OMSetDepthStencilState( pOutputDSS, uStencilRef );
+        stateCache.OMSetDepthStencilState( pOutputDSS, uStencilRef );
         if (ppUAVs == NULL)
-            pDeviceContext->OMSetRenderTargets( uNumRTVs, (ID3D11RenderTargetView*const*)ppRTVs, pDSV );
+            stateCache.OMSetRenderTargets( uNumRTVs, (ID3D11RenderTargetView*const*)ppRTVs, pDSV );
         else
-            pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews( uNumRTVs, (ID3D11RenderTargetView*const*)ppRTVs, pDSV, uStartUAV, uNumUAVs, ppUAVs, NULL);
-        pDeviceContext->OMSetBlendState(pOutputBS, white, 0xFFFFFFFF);
+            stateCache.OMSetRenderTargetsAndUnorderedAccessViews( uNumRTVs, (ID3D11RenderTargetView*const*)ppRTVs, pDSV, uStartUAV, uNumUAVs, ppUAVs, NULL);
+        stateCache.OMSetBlendState(pOutputBS, white, 0xFFFFFFFF);
 
-        pDeviceContext->RSSetViewports( 1, &Viewport );
-        pDeviceContext->RSSetScissorRects(uNumSR, pScissor);
-        pDeviceContext->RSSetState( pOutputRS );
+        stateCache.RSSetViewports( 1, &Viewport );
+        stateCache.RSSetScissorRects(uNumSR, pScissor);
+        stateCache.RSSetState( pOutputRS );
 
-        pDeviceContext->PSSetConstantBuffers( 0, uNumCBs, ppCB);
-        pDeviceContext->PSSetShaderResources( 0, uNumSRVs, ppSRVs );
-        pDeviceContext->PSSetSamplers( 0, uNumSamplers, ppSamplers );        
+        stateCache.PSSetConstantBuffers( 0, uNumCBs, ppCB);
+        stateCache.PSSetShaderResources( 0, uNumSRVs, ppSRVs );
+        stateCache.PSSetSamplers( 0, uNumSamplers, ppSamplers );        
 
-        pDeviceContext->IASetInputLayout( NULL );
-        pDeviceContext->IASetVertexBuffers( 0, AMD_ARRAY_SIZE(pNullBuffer), pNullBuffer, NullStride, NullOffset );
-        pDeviceContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+        stateCache.IASetInputLayout( NULL );
+        stateCache.IASetVertexBuffers( 0, AMD_ARRAY_SIZE(pNullBuffer), pNullBuffer, NullStride, NullOffset );
+        stateCache.IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
 
-        pDeviceContext->VSSetShader( pVS, NULL, 0 );
-        pDeviceContext->GSSetShader( pGS, NULL, 0 );
-        pDeviceContext->PSSetShader(pPS, NULL, 0);
+        stateCache.VSSetShader( pVS );
+        stateCache.GSSetShader( pGS );
+        stateCache.PSSetShader(pPS);
 
-        pDeviceContext->Draw( 3 * instanceCount, 0 );
+        stateCache.GetContext()->Draw( 3 * instanceCount, 0 );
 
         // Unbind RTVs and SRVs back to NULL (otherwise D3D will throw warnings)
         if (ppUAVs == NULL)
-            pDeviceContext->OMSetRenderTargets( AMD_ARRAY_SIZE(pNullRTV), pNullRTV, NULL );
+            stateCache.OMSetRenderTargets( AMD_ARRAY_SIZE(pNullRTV), pNullRTV, NULL );
         else
-            pDeviceContext->OMSetRenderTargetsAndUnorderedAccessViews( uNumRTVs, pNullRTV, NULL, uStartUAV, uNumUAVs, pNullUAV, NULL);
+            stateCache.OMSetRenderTargetsAndUnorderedAccessViews( uNumRTVs, pNullRTV, NULL, uStartUAV, uNumUAVs, pNullUAV, NULL);
 
-        pDeviceContext->PSSetShaderResources( 0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV );
+        stateCache.PSSetShaderResources( 0, AMD_ARRAY_SIZE(pNullSRV), pNullSRV );
 
         return S_OK;
     }
@@ -25,6 +25,8 @@
 
 #include <d3d11.h>
 
+#include "AMD_StateCache.h"
+
 namespace AMD
 {
     extern "C++"
@@ -48,6 +50,23 @@ namespace AMD
             ID3D11BlendState *         pOutputBS,
             ID3D11RasterizerState *    pOutputRS);
 
+        // Binds through the state cache, state shared with the previous pass is not sent to the context again
+        HRESULT RenderFullscreenPass(
+            C_StateCache &             stateCache,
+            D3D11_VIEWPORT             Viewport,
+            ID3D11VertexShader*        pVS,
+            ID3D11PixelShader*         pPS,
+            D3D11_RECT*                pScissor,   unsigned int uNumSR,
+            ID3D11Buffer**             ppCB,       unsigned int uNumCBs,
+            ID3D11SamplerState**       ppSamplers, unsigned int uNumSamplers,
+            ID3D11ShaderResourceView** ppSRVs,     unsigned int uNumSRVs,
+            ID3D11RenderTargetView**   ppRTVs,     unsigned int uNumRTVs,
+            ID3D11UnorderedAccessView**ppUAVs,     unsigned int uStartUAV, unsigned int uNumUAVs,
+            ID3D11DepthStencilView*    pDSV,
+            ID3D11DepthStencilState*   pOutputDSS, unsigned int uStencilRef,
+            ID3D11BlendState *         pOutputBS,
+            ID3D11RasterizerState *    pOutputRS);
+
         HRESULT RenderFullscreenInstancedPass(
             ID3D11DeviceContext*        pDeviceContext,
             D3D11_VIEWPORT              Viewport,
@@ -66,6 +85,24 @@ namespace AMD
             ID3D11RasterizerState *     pOutputRS,
             unsigned int                instanceCount);
 
+        HRESULT RenderFullscreenInstancedPass(
+            C_StateCache &              stateCache,
+            D3D11_VIEWPORT              Viewport,
+            ID3D11VertexShader*         pVS,
+            ID3D11GeometryShader*       pGS,
+            ID3D11PixelShader*          pPS,
+            D3D11_RECT*                 pScissor,   unsigned int uNumSR,
+            ID3D11Buffer**              ppCB,       unsigned int uNumCBs,
+            ID3D11SamplerState**        ppSamplers, unsigned int uNumSamplers,
+            ID3D11ShaderResourceView**  ppSRVs,     unsigned int uNumSRVs,
+            ID3D11RenderTargetView**    ppRTVs,     unsigned int uNumRTVs,
+            ID3D11UnorderedAccessView** ppUAVs,     unsigned int uStartUAV, unsigned int uNumUAVs,
+            ID3D11DepthStencilView*     pDSV,
+            ID3D11DepthStencilState*    pOutputDSS, unsigned int uStencilRef,
+            ID3D11BlendState *          pOutputBS,
+            ID3D11RasterizerState *     pOutputRS,
+            unsigned int                instanceCount);
+
         HRESULT RenderFullscreenAlignedQuads(
             ID3D11DeviceContext*       pDeviceContext,
             D3D11_VIEWPORT             Viewport,
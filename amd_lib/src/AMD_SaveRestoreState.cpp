@@ -24,12 +24,13 @@
 
 namespace AMD
 {
-    C_SaveRestore_IA::C_SaveRestore_IA(ID3D11DeviceContext * context)
+    C_SaveRestore_IA::C_SaveRestore_IA(ID3D11DeviceContext * context, UINT vertexBufferCount)
         : m_IAPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED)
         , m_pInputLayout(NULL)
         , m_pIAIndexBuffer(NULL)
         , m_IAIndexBufferFormat(DXGI_FORMAT_UNKNOWN)
         , m_IAIndexBufferOffset(0)
+        , m_VertexBufferCount(vertexBufferCount < D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT ? vertexBufferCount : D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT)
         , m_pContext(context)
     {
         if (context == NULL) return;
@@ -41,7 +42,7 @@ namespace AMD
         m_pContext->IAGetInputLayout( &m_pInputLayout );
         m_pContext->IAGetIndexBuffer( &m_pIAIndexBuffer, &m_IAIndexBufferFormat, &m_IAIndexBufferOffset);
         m_pContext->IAGetPrimitiveTopology( &m_IAPrimitiveTopology );
-        m_pContext->IAGetVertexBuffers(0, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, m_pIAVertexBuffers, m_pIAVertexBuffersStrides, m_pIAVertexBuffersOffsets);
+        m_pContext->IAGetVertexBuffers(0, m_VertexBufferCount, m_pIAVertexBuffers, m_pIAVertexBuffersStrides, m_pIAVertexBuffersOffsets);
     }
 
     C_SaveRestore_IA::~C_SaveRestore_IA()
@@ -51,11 +52,11 @@ namespace AMD
         m_pContext->IASetInputLayout( m_pInputLayout );
         m_pContext->IASetIndexBuffer( m_pIAIndexBuffer, m_IAIndexBufferFormat, m_IAIndexBufferOffset );
         m_pContext->IASetPrimitiveTopology( m_IAPrimitiveTopology );
-        m_pContext->IASetVertexBuffers( 0, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, m_pIAVertexBuffers, m_pIAVertexBuffersStrides, m_pIAVertexBuffersOffsets );
+        m_pContext->IASetVertexBuffers( 0, m_VertexBufferCount, m_pIAVertexBuffers, m_pIAVertexBuffersStrides, m_pIAVertexBuffersOffsets );
 
         if (m_pInputLayout) {m_pInputLayout->Release(); m_pInputLayout = NULL;}
         if (m_pIAIndexBuffer) {m_pIAIndexBuffer->Release(); m_pIAIndexBuffer = NULL;}
-        for (int i = 0; i < D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_VertexBufferCount; i++ )
         {
             if (m_pIAVertexBuffers[i]) {m_pIAVertexBuffers[i]->Release(); m_pIAVertexBuffers[i] = NULL;}
         }
@@ -128,9 +129,12 @@ namespace AMD
         m_pContext = NULL;
     }
 
-    C_SaveRestore_VS::C_SaveRestore_VS(ID3D11DeviceContext * context)
+    C_SaveRestore_VS::C_SaveRestore_VS(ID3D11DeviceContext * context, UINT samplerCount, UINT constantBufferCount, UINT srvCount)
         : m_pContext(context)
         , m_pVSShader(0)
+        , m_SamplerCount(samplerCount < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT ? samplerCount : D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT)
+        , m_ConstantBufferCount(constantBufferCount < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT ? constantBufferCount : D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+        , m_SRVCount(srvCount < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT ? srvCount : D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT)
     {
         if (context == NULL) return;
 
@@ -139,9 +143,9 @@ namespace AMD
         memset(m_pVSSRV, 0, sizeof(m_pVSSRV));
 
         m_pContext->VSGetShader(&m_pVSShader, NULL, NULL);
-        m_pContext->VSGetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pVSSamplers);
-        m_pContext->VSGetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pVSConstantBuffer);
-        m_pContext->VSGetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pVSSRV);
+        m_pContext->VSGetSamplers(0, m_SamplerCount, m_pVSSamplers);
+        m_pContext->VSGetConstantBuffers(0, m_ConstantBufferCount, m_pVSConstantBuffer);
+        m_pContext->VSGetShaderResources(0, m_SRVCount, m_pVSSRV);
     }
 
     C_SaveRestore_VS::~C_SaveRestore_VS()
@@ -149,27 +153,30 @@ namespace AMD
         if (m_pContext == NULL) return;
 
         m_pContext->VSSetShader(m_pVSShader, NULL, NULL);
-        m_pContext->VSSetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pVSSamplers);
-        m_pContext->VSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pVSConstantBuffer);
-        m_pContext->VSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pVSSRV);
+        m_pContext->VSSetSamplers(0, m_SamplerCount, m_pVSSamplers);
+        m_pContext->VSSetConstantBuffers(0, m_ConstantBufferCount, m_pVSConstantBuffer);
+        m_pContext->VSSetShaderResources(0, m_SRVCount, m_pVSSRV);
 
         if (m_pVSShader) {m_pVSShader->Release(); m_pVSShader = NULL;}
 
-        for (int i = 0; i < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SamplerCount; i++ )
         {  if (m_pVSSamplers[i]) {m_pVSSamplers[i]->Release(); m_pVSSamplers[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_ConstantBufferCount; i++ )
         {  if (m_pVSConstantBuffer[i]) {m_pVSConstantBuffer[i]->Release(); m_pVSConstantBuffer[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SRVCount; i++ )
         {  if (m_pVSSRV[i]) {m_pVSSRV[i]->Release(); m_pVSSRV[i] = NULL;} }
 
         m_pContext = NULL;
     }
 
-    C_SaveRestore_HS::C_SaveRestore_HS(ID3D11DeviceContext * context)
+    C_SaveRestore_HS::C_SaveRestore_HS(ID3D11DeviceContext * context, UINT samplerCount, UINT constantBufferCount, UINT srvCount)
         : m_pContext(context)
         , m_pHSShader(0)
+        , m_SamplerCount(samplerCount < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT ? samplerCount : D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT)
+        , m_ConstantBufferCount(constantBufferCount < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT ? constantBufferCount : D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+        , m_SRVCount(srvCount < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT ? srvCount : D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT)
     {
         if (context == NULL) return;
 
@@ -178,9 +185,9 @@ namespace AMD
         memset(m_pHSSRV, 0, sizeof(m_pHSSRV));
 
         m_pContext->HSGetShader(&m_pHSShader, NULL, NULL);
-        m_pContext->HSGetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pHSSamplers);
-        m_pContext->HSGetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pHSConstantBuffer);
-        m_pContext->HSGetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pHSSRV);
+        m_pContext->HSGetSamplers(0, m_SamplerCount, m_pHSSamplers);
+        m_pContext->HSGetConstantBuffers(0, m_ConstantBufferCount, m_pHSConstantBuffer);
+        m_pContext->HSGetShaderResources(0, m_SRVCount, m_pHSSRV);
     }
 
     C_SaveRestore_HS::~C_SaveRestore_HS()
@@ -188,27 +195,30 @@ namespace AMD
         if (m_pContext == NULL) return;
 
         m_pContext->HSSetShader(m_pHSShader, NULL, NULL);
-        m_pContext->HSSetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pHSSamplers);
-        m_pContext->HSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pHSConstantBuffer);
-        m_pContext->HSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pHSSRV);
+        m_pContext->HSSetSamplers(0, m_SamplerCount, m_pHSSamplers);
+        m_pContext->HSSetConstantBuffers(0, m_ConstantBufferCount, m_pHSConstantBuffer);
+        m_pContext->HSSetShaderResources(0, m_SRVCount, m_pHSSRV);
 
         if (m_pHSShader) {m_pHSShader->Release(); m_pHSShader = NULL;}
 
-        for (int i = 0; i < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SamplerCount; i++ )
         {  if (m_pHSSamplers[i]) {m_pHSSamplers[i]->Release(); m_pHSSamplers[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_ConstantBufferCount; i++ )
         {  if (m_pHSConstantBuffer[i]) {m_pHSConstantBuffer[i]->Release(); m_pHSConstantBuffer[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SRVCount; i++ )
         {  if (m_pHSSRV[i]) {m_pHSSRV[i]->Release(); m_pHSSRV[i] = NULL;} }
 
         m_pContext = NULL;
     }
 
-    C_SaveRestore_DS::C_SaveRestore_DS(ID3D11DeviceContext * context)
+    C_SaveRestore_DS::C_SaveRestore_DS(ID3D11DeviceContext * context, UINT samplerCount, UINT constantBufferCount, UINT srvCount)
         : m_pContext(context)
         , m_pDSShader(0)
+        , m_SamplerCount(samplerCount < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT ? samplerCount : D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT)
+        , m_ConstantBufferCount(constantBufferCount < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT ? constantBufferCount : D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+        , m_SRVCount(srvCount < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT ? srvCount : D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT)
     {
         if (context == NULL) return;
 
@@ -217,9 +227,9 @@ namespace AMD
         memset(m_pDSSRV, 0, sizeof(m_pDSSRV));
 
         m_pContext->DSGetShader(&m_pDSShader, NULL, NULL);
-        m_pContext->DSGetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pDSSamplers);
-        m_pContext->DSGetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pDSConstantBuffer);
-        m_pContext->DSGetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pDSSRV);
+        m_pContext->DSGetSamplers(0, m_SamplerCount, m_pDSSamplers);
+        m_pContext->DSGetConstantBuffers(0, m_ConstantBufferCount, m_pDSConstantBuffer);
+        m_pContext->DSGetShaderResources(0, m_SRVCount, m_pDSSRV);
     }
 
     C_SaveRestore_DS::~C_SaveRestore_DS()
@@ -227,27 +237,30 @@ namespace AMD
         if (m_pContext == NULL) return;
 
         m_pContext->DSSetShader(m_pDSShader, NULL, NULL);
-        m_pContext->DSSetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pDSSamplers);
-        m_pContext->DSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pDSConstantBuffer);
-        m_pContext->DSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pDSSRV);
+        m_pContext->DSSetSamplers(0, m_SamplerCount, m_pDSSamplers);
+        m_pContext->DSSetConstantBuffers(0, m_ConstantBufferCount, m_pDSConstantBuffer);
+        m_pContext->DSSetShaderResources(0, m_SRVCount, m_pDSSRV);
 
         if (m_pDSShader) {m_pDSShader->Release(); m_pDSShader = NULL;}
 
-        for (int i = 0; i < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SamplerCount; i++ )
         {  if (m_pDSSamplers[i]) {m_pDSSamplers[i]->Release(); m_pDSSamplers[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_ConstantBufferCount; i++ )
         {  if (m_pDSConstantBuffer[i]) {m_pDSConstantBuffer[i]->Release(); m_pDSConstantBuffer[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SRVCount; i++ )
         {  if (m_pDSSRV[i]) {m_pDSSRV[i]->Release(); m_pDSSRV[i] = NULL;} }
 
         m_pContext = NULL;
     }
 
-    C_SaveRestore_GS::C_SaveRestore_GS(ID3D11DeviceContext * context)
+    C_SaveRestore_GS::C_SaveRestore_GS(ID3D11DeviceContext * context, UINT samplerCount, UINT constantBufferCount, UINT srvCount)
         : m_pContext(context)
         , m_pGSShader(0)
+        , m_SamplerCount(samplerCount < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT ? samplerCount : D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT)
+        , m_ConstantBufferCount(constantBufferCount < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT ? constantBufferCount : D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+        , m_SRVCount(srvCount < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT ? srvCount : D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT)
     {
         if (context == NULL) return;
 
@@ -256,9 +269,9 @@ namespace AMD
         memset(m_pGSSRV, 0, sizeof(m_pGSSRV));
 
         m_pContext->GSGetShader(&m_pGSShader, NULL, NULL);
-        m_pContext->GSGetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pGSSamplers);
-        m_pContext->GSGetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pGSConstantBuffer);
-        m_pContext->GSGetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pGSSRV);
+        m_pContext->GSGetSamplers(0, m_SamplerCount, m_pGSSamplers);
+        m_pContext->GSGetConstantBuffers(0, m_ConstantBufferCount, m_pGSConstantBuffer);
+        m_pContext->GSGetShaderResources(0, m_SRVCount, m_pGSSRV);
     }
 
     C_SaveRestore_GS::~C_SaveRestore_GS()
@@ -266,27 +279,30 @@ namespace AMD
         if (m_pContext == NULL) return;
 
         m_pContext->GSSetShader(m_pGSShader, NULL, NULL);
-        m_pContext->GSSetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pGSSamplers);
-        m_pContext->GSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pGSConstantBuffer);
-        m_pContext->GSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pGSSRV);
+        m_pContext->GSSetSamplers(0, m_SamplerCount, m_pGSSamplers);
+        m_pContext->GSSetConstantBuffers(0, m_ConstantBufferCount, m_pGSConstantBuffer);
+        m_pContext->GSSetShaderResources(0, m_SRVCount, m_pGSSRV);
 
         if (m_pGSShader) {m_pGSShader->Release(); m_pGSShader = NULL;}
 
-        for (int i = 0; i < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SamplerCount; i++ )
         {  if (m_pGSSamplers[i]) {m_pGSSamplers[i]->Release(); m_pGSSamplers[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_ConstantBufferCount; i++ )
         {  if (m_pGSConstantBuffer[i]) {m_pGSConstantBuffer[i]->Release(); m_pGSConstantBuffer[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SRVCount; i++ )
         {  if (m_pGSSRV[i]) {m_pGSSRV[i]->Release(); m_pGSSRV[i] = NULL;} }
 
         m_pContext = NULL;
     }
 
-    C_SaveRestore_PS::C_SaveRestore_PS(ID3D11DeviceContext * context)
+    C_SaveRestore_PS::C_SaveRestore_PS(ID3D11DeviceContext * context, UINT samplerCount, UINT constantBufferCount, UINT srvCount)
         : m_pContext(context)
         , m_pPSShader(0)
+        , m_SamplerCount(samplerCount < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT ? samplerCount : D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT)
+        , m_ConstantBufferCount(constantBufferCount < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT ? constantBufferCount : D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+        , m_SRVCount(srvCount < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT ? srvCount : D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT)
     {
         if (context == NULL) return;
 
@@ -295,9 +311,9 @@ namespace AMD
         memset(m_pPSSRV, 0, sizeof(m_pPSSRV));
 
         m_pContext->PSGetShader(&m_pPSShader, NULL, NULL);
-        m_pContext->PSGetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pPSSamplers);
-        m_pContext->PSGetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pPSConstantBuffer);
-        m_pContext->PSGetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pPSSRV);
+        m_pContext->PSGetSamplers(0, m_SamplerCount, m_pPSSamplers);
+        m_pContext->PSGetConstantBuffers(0, m_ConstantBufferCount, m_pPSConstantBuffer);
+        m_pContext->PSGetShaderResources(0, m_SRVCount, m_pPSSRV);
     }
 
     C_SaveRestore_PS::~C_SaveRestore_PS()
@@ -305,27 +321,31 @@ namespace AMD
         if (m_pContext == NULL) return;
 
         m_pContext->PSSetShader(m_pPSShader, NULL, NULL);
-        m_pContext->PSSetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pPSSamplers);
-        m_pContext->PSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pPSConstantBuffer);
-        m_pContext->PSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pPSSRV);
+        m_pContext->PSSetSamplers(0, m_SamplerCount, m_pPSSamplers);
+        m_pContext->PSSetConstantBuffers(0, m_ConstantBufferCount, m_pPSConstantBuffer);
+        m_pContext->PSSetShaderResources(0, m_SRVCount, m_pPSSRV);
 
         if (m_pPSShader) {m_pPSShader->Release(); m_pPSShader = NULL;}
 
-        for (int i = 0; i < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SamplerCount; i++ )
         {  if (m_pPSSamplers[i]) {m_pPSSamplers[i]->Release(); m_pPSSamplers[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_ConstantBufferCount; i++ )
         {  if (m_pPSConstantBuffer[i]) {m_pPSConstantBuffer[i]->Release(); m_pPSConstantBuffer[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SRVCount; i++ )
         {  if (m_pPSSRV[i]) {m_pPSSRV[i]->Release(); m_pPSSRV[i] = NULL;} }
 
         m_pContext= NULL;
     }
 
-    C_SaveRestore_CS::C_SaveRestore_CS(ID3D11DeviceContext * context)
+    C_SaveRestore_CS::C_SaveRestore_CS(ID3D11DeviceContext * context, UINT samplerCount, UINT constantBufferCount, UINT srvCount, UINT uavCount)
         : m_pContext(context)
         , m_pCSShader(0)
+        , m_SamplerCount(samplerCount < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT ? samplerCount : D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT)
+        , m_ConstantBufferCount(constantBufferCount < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT ? constantBufferCount : D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT)
+        , m_SRVCount(srvCount < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT ? srvCount : D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT)
+        , m_UAVCount(uavCount < D3D11_PS_CS_UAV_REGISTER_COUNT ? uavCount : D3D11_PS_CS_UAV_REGISTER_COUNT)
     {
         if (context == NULL) return;
 
@@ -335,33 +355,33 @@ namespace AMD
         memset(m_pCSUAV, 0, sizeof(m_pCSUAV));
 
         m_pContext->CSGetShader(&m_pCSShader, NULL, NULL);
-        m_pContext->CSGetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pCSSamplers);
-        m_pContext->CSGetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pCSConstantBuffer);
-        m_pContext->CSGetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pCSSRV);
-        m_pContext->CSGetUnorderedAccessViews(0, D3D11_PS_CS_UAV_REGISTER_COUNT, m_pCSUAV);
+        m_pContext->CSGetSamplers(0, m_SamplerCount, m_pCSSamplers);
+        m_pContext->CSGetConstantBuffers(0, m_ConstantBufferCount, m_pCSConstantBuffer);
+        m_pContext->CSGetShaderResources(0, m_SRVCount, m_pCSSRV);
+        m_pContext->CSGetUnorderedAccessViews(0, m_UAVCount, m_pCSUAV);
     }
     C_SaveRestore_CS::~C_SaveRestore_CS()
     {
         if (m_pContext == NULL) return;
 
         m_pContext->CSSetShader(m_pCSShader, NULL, NULL);
-        m_pContext->CSSetSamplers(0, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, m_pCSSamplers);
-        m_pContext->CSSetConstantBuffers(0, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, m_pCSConstantBuffer);
-        m_pContext->CSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, m_pCSSRV);
-        m_pContext->CSSetUnorderedAccessViews(0, D3D11_PS_CS_UAV_REGISTER_COUNT, m_pCSUAV, NULL);
+        m_pContext->CSSetSamplers(0, m_SamplerCount, m_pCSSamplers);
+        m_pContext->CSSetConstantBuffers(0, m_ConstantBufferCount, m_pCSConstantBuffer);
+        m_pContext->CSSetShaderResources(0, m_SRVCount, m_pCSSRV);
+        m_pContext->CSSetUnorderedAccessViews(0, m_UAVCount, m_pCSUAV, NULL);
 
         if (m_pCSShader) {m_pCSShader->Release(); m_pCSShader = NULL;}
 
-        for (int i = 0; i < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SamplerCount; i++ )
         {  if (m_pCSSamplers[i]) {m_pCSSamplers[i]->Release(); m_pCSSamplers[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_ConstantBufferCount; i++ )
         {  if (m_pCSConstantBuffer[i]) {m_pCSConstantBuffer[i]->Release(); m_pCSConstantBuffer[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; i++ )
+        for (int i = 0; i < (int)m_SRVCount; i++ )
         {  if (m_pCSSRV[i]) {m_pCSSRV[i]->Release(); m_pCSSRV[i] = NULL;} }
 
-        for (int i = 0; i < D3D11_PS_CS_UAV_REGISTER_COUNT; i++ )
+        for (int i = 0; i < (int)m_UAVCount; i++ )
         {  if (m_pCSUAV[i]) {m_pCSUAV[i]->Release(); m_pCSUAV[i] = NULL;} }
 
         m_pContext = NULL;
@@ -27,6 +27,9 @@
 
 namespace AMD
 {
+    // Guards capture and restore slots [0, count) of every binding point, the default counts cover all slots.
+    // A caller that only binds a few leading slots can pass smaller counts to skip the rest of the pipeline.
+
     /*===========================================================================
     INPUT ASSEMBLY STATE GUARD
     ===========================================================================*/
@@ -40,10 +43,11 @@ namespace AMD
         UINT m_pIAVertexBuffersStrides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
         D3D11_PRIMITIVE_TOPOLOGY m_IAPrimitiveTopology;
         ID3D11Buffer* m_pIAVertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+        UINT m_VertexBufferCount;
         ID3D11DeviceContext * m_pContext;
 
     public:
-        C_SaveRestore_IA(ID3D11DeviceContext * context);
+        C_SaveRestore_IA(ID3D11DeviceContext * context, UINT vertexBufferCount = D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
         ~C_SaveRestore_IA();
     };
 
@@ -92,10 +96,16 @@ namespace AMD
         ID3D11SamplerState* m_pVSSamplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
         ID3D11Buffer* m_pVSConstantBuffer[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
         ID3D11ShaderResourceView* m_pVSSRV[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+        UINT m_SamplerCount;
+        UINT m_ConstantBufferCount;
+        UINT m_SRVCount;
         ID3D11DeviceContext * m_pContext;
 
     public:
-        C_SaveRestore_VS(ID3D11DeviceContext * context);
+        C_SaveRestore_VS(ID3D11DeviceContext * context,
+                         UINT samplerCount = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT,
+                         UINT constantBufferCount = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT,
+                         UINT srvCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT);
         ~C_SaveRestore_VS();
     };
 
@@ -108,10 +118,16 @@ namespace AMD
         ID3D11SamplerState* m_pHSSamplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
         ID3D11Buffer* m_pHSConstantBuffer[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
         ID3D11ShaderResourceView* m_pHSSRV[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+        UINT m_SamplerCount;
+        UINT m_ConstantBufferCount;
+        UINT m_SRVCount;
         ID3D11DeviceContext * m_pContext;
 
     public:
-        C_SaveRestore_HS(ID3D11DeviceContext * context);
+        C_SaveRestore_HS(ID3D11DeviceContext * context,
+                         UINT samplerCount = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT,
+                         UINT constantBufferCount = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT,
+                         UINT srvCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT);
         ~C_SaveRestore_HS();
     };
 
@@ -124,10 +140,16 @@ namespace AMD
         ID3D11SamplerState* m_pDSSamplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
         ID3D11Buffer* m_pDSConstantBuffer[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
         ID3D11ShaderResourceView* m_pDSSRV[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+        UINT m_SamplerCount;
+        UINT m_ConstantBufferCount;
+        UINT m_SRVCount;
         ID3D11DeviceContext * m_pContext;
 
     public:
-        C_SaveRestore_DS(ID3D11DeviceContext * context);
+        C_SaveRestore_DS(ID3D11DeviceContext * context,
+                         UINT samplerCount = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT,
+                         UINT constantBufferCount = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT,
+                         UINT srvCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT);
         ~C_SaveRestore_DS();
     };
 
@@ -140,10 +162,16 @@ namespace AMD
         ID3D11SamplerState* m_pGSSamplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
         ID3D11Buffer* m_pGSConstantBuffer[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
         ID3D11ShaderResourceView* m_pGSSRV[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+        UINT m_SamplerCount;
+        UINT m_ConstantBufferCount;
+        UINT m_SRVCount;
         ID3D11DeviceContext * m_pContext;
 
     public:
-        C_SaveRestore_GS(ID3D11DeviceContext * context);
+        C_SaveRestore_GS(ID3D11DeviceContext * context,
+                         UINT samplerCount = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT,
+                         UINT constantBufferCount = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT,
+                         UINT srvCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT);
         ~C_SaveRestore_GS();
     };
 
@@ -157,10 +185,16 @@ namespace AMD
         ID3D11SamplerState*       m_pPSSamplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
         ID3D11Buffer*             m_pPSConstantBuffer[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
         ID3D11ShaderResourceView* m_pPSSRV[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+        UINT                      m_SamplerCount;
+        UINT                      m_ConstantBufferCount;
+        UINT                      m_SRVCount;
         ID3D11DeviceContext *     m_pContext;
 
     public:
-        C_SaveRestore_PS(ID3D11DeviceContext * context);
+        C_SaveRestore_PS(ID3D11DeviceContext * context,
+                         UINT samplerCount = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT,
+                         UINT constantBufferCount = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT,
+                         UINT srvCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT);
         ~C_SaveRestore_PS();
     };
 
@@ -174,10 +208,18 @@ namespace AMD
         ID3D11Buffer* m_pCSConstantBuffer[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
         ID3D11ShaderResourceView* m_pCSSRV[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
         ID3D11UnorderedAccessView* m_pCSUAV[D3D11_PS_CS_UAV_REGISTER_COUNT];
+        UINT m_SamplerCount;
+        UINT m_ConstantBufferCount;
+        UINT m_SRVCount;
+        UINT m_UAVCount;
         ID3D11DeviceContext * m_pContext;
 
     public:
-        C_SaveRestore_CS(ID3D11DeviceContext * context);
+        C_SaveRestore_CS(ID3D11DeviceContext * context,
+                         UINT samplerCount = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT,
+                         UINT constantBufferCount = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT,
+                         UINT srvCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT,
+                         UINT uavCount = D3D11_PS_CS_UAV_REGISTER_COUNT);
         ~C_SaveRestore_CS();
     };
 };
@@ -0,0 +1,489 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <string.h>
+
+#include "AMD_LIB.h"
+
+#include "AMD_StateCache.h"
+
+namespace AMD
+{
+    // Narrows a slot array bind to the sub range [first, last) that differs from the shadow copy
+    // and updates the shadow. Returns false when the whole bind is redundant.
+    template <typename T>
+    static bool filterSlots(T ** ppShadow, UINT & valid, UINT startSlot, UINT count, T * const * ppValues, UINT & first, UINT & last)
+    {
+        first = 0;
+        last = count;
+
+        // binding nothing changes nothing
+        if (count == 0) return false;
+
+        if (ppValues == NULL || startSlot >= C_StateCache::MaxSlots || count > C_StateCache::MaxSlots - startSlot)
+        {
+            // untracked slots, forget whatever overlaps the shadow and forward the bind untouched
+            for (UINT i = startSlot; i < C_StateCache::MaxSlots && i - startSlot < count; i++)
+                valid &= ~(1u << i);
+            return true;
+        }
+
+        first = count;
+        last = 0;
+        for (UINT i = 0; i < count; i++)
+        {
+            UINT slot = startSlot + i;
+            if ((valid & (1u << slot)) == 0 || ppShadow[slot] != ppValues[i])
+            {
+                ppShadow[slot] = ppValues[i];
+                valid |= 1u << slot;
+                if (first > i) first = i;
+                last = i + 1;
+            }
+        }
+
+        return first < last;
+    }
+
+    // Same as filterSlots for buffers bound with two extra values per slot (stride and offset, or first and
+    // count of constants). Missing value arrays compare as zeros, the runtime treats them as a whole buffer bind.
+    static bool filterBufferSlots(ID3D11Buffer ** ppShadow, UINT * pShadowA, UINT * pShadowB, UINT & valid, UINT startSlot, UINT count,
+                                  ID3D11Buffer * const * ppValues, const UINT * pA, const UINT * pB, UINT & first, UINT & last)
+    {
+        first = 0;
+        last = count;
+
+        // binding nothing changes nothing
+        if (count == 0) return false;
+
+        if (ppValues == NULL || startSlot >= C_StateCache::MaxSlots || count > C_StateCache::MaxSlots - startSlot)
+        {
+            for (UINT i = startSlot; i < C_StateCache::MaxSlots && i - startSlot < count; i++)
+                valid &= ~(1u << i);
+            return true;
+        }
+
+        first = count;
+        last = 0;
+        for (UINT i = 0; i < count; i++)
+        {
+            UINT slot = startSlot + i;
+            UINT a = pA != NULL ? pA[i] : 0;
+            UINT b = pB != NULL ? pB[i] : 0;
+            if ((valid & (1u << slot)) == 0 || ppShadow[slot] != ppValues[i] || pShadowA[slot] != a || pShadowB[slot] != b)
+            {
+                ppShadow[slot] = ppValues[i];
+                pShadowA[slot] = a;
+                pShadowB[slot] = b;
+                valid |= 1u << slot;
+                if (first > i) first = i;
+                last = i + 1;
+            }
+        }
+
+        return first < last;
+    }
+
+    template <typename T>
+    static bool anyBound(T * const * ppViews, UINT count)
+    {
+        for (UINT i = 0; i < count; i++)
+            if (ppViews != NULL && ppViews[i] != NULL) return true;
+        return false;
+    }
+
+    C_StateCache::C_StateCache(ID3D11DeviceContext * context, bool filter)
+        : m_pContext(context)
+        , m_pContext1(NULL)
+        , m_Filter(filter)
+        , m_Hits(0)
+        , m_Misses(0)
+    {
+        Reset(context);
+    }
+
+    void C_StateCache::Reset(ID3D11DeviceContext * context, ID3D11DeviceContext1 * context1)
+    {
+        m_pContext = context;
+        m_pContext1 = context1;
+        m_Valid = 0;
+        m_ValidVertexBuffers = 0;
+        m_PSStage.m_ValidConstantBuffers = m_PSStage.m_ValidSRVs = m_PSStage.m_ValidSamplers = 0;
+        m_CSStage.m_ValidConstantBuffers = m_CSStage.m_ValidSRVs = m_CSStage.m_ValidSamplers = 0;
+        m_ValidCSUAVs = 0;
+    }
+
+    void C_StateCache::ResetCounters()
+    {
+        m_Hits = 0;
+        m_Misses = 0;
+    }
+
+    // Compares a single piece of state against its shadow, returns true if the bind has to reach the context
+    bool C_StateCache::filterValue(UINT flag, const void * pValue, void * pShadow, size_t size)
+    {
+        if (m_Filter && (m_Valid & flag) != 0 && memcmp(pShadow, pValue, size) == 0)
+        {
+            m_Hits++;
+            return false;
+        }
+
+        memcpy(pShadow, pValue, size);
+        m_Valid |= flag;
+        m_Misses++;
+        return true;
+    }
+
+    // The runtime unbinds shader resource views that alias a new output, and outputs that alias a new
+    // unordered access view. Shadowed views that may have been unbound are dropped so the next bind goes through.
+    void C_StateCache::invalidateOutputHazards(bool renderTargets, bool unorderedAccessViews)
+    {
+        for (UINT i = 0; i < MaxSlots; i++)
+        {
+            if (m_PSStage.m_pSRVs[i] != NULL) m_PSStage.m_ValidSRVs &= ~(1u << i);
+            if (m_CSStage.m_pSRVs[i] != NULL) m_CSStage.m_ValidSRVs &= ~(1u << i);
+            if (renderTargets && m_pCSUAVs[i] != NULL) m_ValidCSUAVs &= ~(1u << i);
+        }
+
+        if (unorderedAccessViews && (m_pDSV != NULL || anyBound(m_pRTVs, MaxRenderTargets)))
+            m_Valid &= ~VALID_RENDER_TARGETS;
+    }
+
+    // A view bound for reading while an output may alias it is rejected by the runtime, so its shadow is not trusted
+    void C_StateCache::invalidateBoundSRVs(UINT & valid, ID3D11ShaderResourceView * const * ppShadow, UINT start, UINT count)
+    {
+        bool outputsBound = (m_Valid & VALID_RENDER_TARGETS) == 0 || m_pDSV != NULL || anyBound(m_pRTVs, MaxRenderTargets);
+        for (UINT i = 0; i < MaxSlots && !outputsBound; i++)
+            outputsBound = (m_ValidCSUAVs & (1u << i)) == 0 || m_pCSUAVs[i] != NULL;
+
+        if (!outputsBound) return;
+
+        for (UINT i = start; i < start + count && i < MaxSlots; i++)
+            if (ppShadow[i] != NULL) valid &= ~(1u << i);
+    }
+
+    // Returns true if the bind has to reach the context, narrowed to [first, last)
+    bool C_StateCache::filterConstantBuffers(S_StageShadow & stage, UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers,
+                                             const UINT * pFirstConstant, const UINT * pNumConstants, UINT & first, UINT & last)
+    {
+        first = 0;
+        last = NumBuffers;
+
+        if (!m_Filter)
+        {
+            stage.m_ValidConstantBuffers = 0;
+        }
+        else if (!filterBufferSlots(stage.m_pConstantBuffers, stage.m_FirstConstant, stage.m_NumConstants, stage.m_ValidConstantBuffers,
+                                    StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, last))
+        {
+            m_Hits++;
+            return false;
+        }
+
+        m_Misses++;
+        return true;
+    }
+
+    void C_StateCache::IASetInputLayout(ID3D11InputLayout * pInputLayout)
+    {
+        if (filterValue(VALID_INPUT_LAYOUT, &pInputLayout, &m_pInputLayout, sizeof(pInputLayout)))
+            m_pContext->IASetInputLayout(pInputLayout);
+    }
+
+    void C_StateCache::IASetVertexBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppVertexBuffers, const UINT * pStrides, const UINT * pOffsets)
+    {
+        UINT first = 0, last = NumBuffers;
+
+        if (!m_Filter)
+        {
+            m_ValidVertexBuffers = 0;
+        }
+        else if (!filterBufferSlots(m_pVertexBuffers, m_VertexBufferStrides, m_VertexBufferOffsets, m_ValidVertexBuffers,
+                                    StartSlot, NumBuffers, ppVertexBuffers, pStrides, pOffsets, first, last))
+        {
+            m_Hits++;
+            return;
+        }
+
+        m_Misses++;
+        m_pContext->IASetVertexBuffers(StartSlot + first, last - first,
+                                       ppVertexBuffers != NULL ? ppVertexBuffers + first : NULL,
+                                       pStrides != NULL ? pStrides + first : NULL,
+                                       pOffsets != NULL ? pOffsets + first : NULL);
+    }
+
+    void C_StateCache::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology)
+    {
+        if (filterValue(VALID_TOPOLOGY, &Topology, &m_Topology, sizeof(Topology)))
+            m_pContext->IASetPrimitiveTopology(Topology);
+    }
+
+    void C_StateCache::VSSetShader(ID3D11VertexShader * pShader)
+    {
+        if (filterValue(VALID_VS, &pShader, &m_pVS, sizeof(pShader)))
+            m_pContext->VSSetShader(pShader, NULL, 0);
+    }
+
+    void C_StateCache::GSSetShader(ID3D11GeometryShader * pShader)
+    {
+        if (filterValue(VALID_GS, &pShader, &m_pGS, sizeof(pShader)))
+            m_pContext->GSSetShader(pShader, NULL, 0);
+    }
+
+    void C_StateCache::PSSetShader(ID3D11PixelShader * pShader)
+    {
+        if (filterValue(VALID_PS, &pShader, &m_pPS, sizeof(pShader)))
+            m_pContext->PSSetShader(pShader, NULL, 0);
+    }
+
+    void C_StateCache::CSSetShader(ID3D11ComputeShader * pShader)
+    {
+        if (filterValue(VALID_CS, &pShader, &m_pCS, sizeof(pShader)))
+            m_pContext->CSSetShader(pShader, NULL, 0);
+    }
+
+#define AMD_STATE_CACHE_SLOTS(CALL, SHADOW, VALID, START, COUNT, VALUES)        \
+    UINT first = 0, last = COUNT;                                               \
+    if (!m_Filter) { VALID = 0; }                                               \
+    else if (!filterSlots(SHADOW, VALID, START, COUNT, VALUES, first, last))    \
+    {                                                                           \
+        m_Hits++;                                                               \
+        return;                                                                 \
+    }                                                                           \
+    m_Misses++;                                                                 \
+    m_pContext->CALL(START + first, last - first, VALUES != NULL ? VALUES + first : NULL)
+
+    void C_StateCache::PSSetConstantBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers)
+    {
+        PSSetConstantBuffers1(StartSlot, NumBuffers, ppConstantBuffers, NULL, NULL);
+    }
+
+    void C_StateCache::PSSetConstantBuffers1(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers, const UINT * pFirstConstant, const UINT * pNumConstants)
+    {
+        UINT first = 0, last = NumBuffers;
+        if (!filterConstantBuffers(m_PSStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, last)) return;
+
+        if (pFirstConstant == NULL && pNumConstants == NULL)
+            m_pContext->PSSetConstantBuffers(StartSlot + first, last - first, ppConstantBuffers != NULL ? ppConstantBuffers + first : NULL);
+        else
+            m_pContext1->PSSetConstantBuffers1(StartSlot + first, last - first, ppConstantBuffers != NULL ? ppConstantBuffers + first : NULL,
+                                               pFirstConstant != NULL ? pFirstConstant + first : NULL, pNumConstants != NULL ? pNumConstants + first : NULL);
+    }
+
+    void C_StateCache::PSSetShaderResources(UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView * const * ppShaderResourceViews)
+    {
+        AMD_STATE_CACHE_SLOTS(PSSetShaderResources, m_PSStage.m_pSRVs, m_PSStage.m_ValidSRVs, StartSlot, NumViews, ppShaderResourceViews);
+        invalidateBoundSRVs(m_PSStage.m_ValidSRVs, m_PSStage.m_pSRVs, StartSlot + first, last - first);
+    }
+
+    void C_StateCache::PSSetSamplers(UINT StartSlot, UINT NumSamplers, ID3D11SamplerState * const * ppSamplers)
+    {
+        AMD_STATE_CACHE_SLOTS(PSSetSamplers, m_PSStage.m_pSamplers, m_PSStage.m_ValidSamplers, StartSlot, NumSamplers, ppSamplers);
+    }
+
+    void C_StateCache::CSSetConstantBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers)
+    {
+        CSSetConstantBuffers1(StartSlot, NumBuffers, ppConstantBuffers, NULL, NULL);
+    }
+
+    void C_StateCache::CSSetConstantBuffers1(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers, const UINT * pFirstConstant, const UINT * pNumConstants)
+    {
+        UINT first = 0, last = NumBuffers;
+        if (!filterConstantBuffers(m_CSStage, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants, first, last)) return;
+
+        if (pFirstConstant == NULL && pNumConstants == NULL)
+            m_pContext->CSSetConstantBuffers(StartSlot + first, last - first, ppConstantBuffers != NULL ? ppConstantBuffers + first : NULL);
+        else
+            m_pContext1->CSSetConstantBuffers1(StartSlot + first, last - first, ppConstantBuffers != NULL ? ppConstantBuffers + first : NULL,
+                                               pFirstConstant != NULL ? pFirstConstant + first : NULL, pNumConstants != NULL ? pNumConstants + first : NULL);
+    }
+
+    void C_StateCache::CSSetShaderResources(UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView * const * ppShaderResourceViews)
+    {
+        AMD_STATE_CACHE_SLOTS(CSSetShaderResources, m_CSStage.m_pSRVs, m_CSStage.m_ValidSRVs, StartSlot, NumViews, ppShaderResourceViews);
+        invalidateBoundSRVs(m_CSStage.m_ValidSRVs, m_CSStage.m_pSRVs, StartSlot + first, last - first);
+    }
+
+    void C_StateCache::CSSetSamplers(UINT StartSlot, UINT NumSamplers, ID3D11SamplerState * const * ppSamplers)
+    {
+        AMD_STATE_CACHE_SLOTS(CSSetSamplers, m_CSStage.m_pSamplers, m_CSStage.m_ValidSamplers, StartSlot, NumSamplers, ppSamplers);
+    }
+
+#undef AMD_STATE_CACHE_SLOTS
+
+    void C_StateCache::CSSetUnorderedAccessViews(UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView * const * ppUnorderedAccessViews, const UINT * pUAVInitialCounts)
+    {
+        UINT first = 0, last = NumUAVs;
+        bool counters = false;
+
+        // an initial count resets the hidden counter of the view, such a bind is never redundant
+        for (UINT i = 0; i < NumUAVs && pUAVInitialCounts != NULL; i++)
+            counters = counters || pUAVInitialCounts[i] != (UINT)-1;
+
+        if (!m_Filter || counters)
+        {
+            for (UINT i = StartSlot; i < MaxSlots && i - StartSlot < NumUAVs; i++)
+                m_ValidCSUAVs &= ~(1u << i);
+        }
+        else if (!filterSlots(m_pCSUAVs, m_ValidCSUAVs, StartSlot, NumUAVs, ppUnorderedAccessViews, first, last))
+        {
+            m_Hits++;
+            return;
+        }
+
+        m_Misses++;
+        m_pContext->CSSetUnorderedAccessViews(StartSlot + first, last - first,
+                                              ppUnorderedAccessViews != NULL ? ppUnorderedAccessViews + first : NULL,
+                                              pUAVInitialCounts != NULL ? pUAVInitialCounts + first : NULL);
+
+        if (anyBound(ppUnorderedAccessViews, NumUAVs))
+            invalidateOutputHazards(false, true);
+    }
+
+    void C_StateCache::RSSetState(ID3D11RasterizerState * pRasterizerState)
+    {
+        if (filterValue(VALID_RS_STATE, &pRasterizerState, &m_pRSState, sizeof(pRasterizerState)))
+            m_pContext->RSSetState(pRasterizerState);
+    }
+
+    void C_StateCache::RSSetViewports(UINT NumViewports, const D3D11_VIEWPORT * pViewports)
+    {
+        if (NumViewports > MaxViewports || (NumViewports > 0 && pViewports == NULL))
+        {
+            m_Valid &= ~VALID_VIEWPORTS;
+            m_Misses++;
+        }
+        else if (m_Filter && (m_Valid & VALID_VIEWPORTS) != 0 && m_ViewportCount == NumViewports &&
+                 memcmp(m_Viewports, pViewports, NumViewports * sizeof(D3D11_VIEWPORT)) == 0)
+        {
+            m_Hits++;
+            return;
+        }
+        else
+        {
+            m_ViewportCount = NumViewports;
+            memcpy(m_Viewports, pViewports, NumViewports * sizeof(D3D11_VIEWPORT));
+            m_Valid |= VALID_VIEWPORTS;
+            m_Misses++;
+        }
+
+        m_pContext->RSSetViewports(NumViewports, pViewports);
+    }
+
+    void C_StateCache::RSSetScissorRects(UINT NumRects, const D3D11_RECT * pRects)
+    {
+        if (NumRects > MaxViewports || (NumRects > 0 && pRects == NULL))
+        {
+            m_Valid &= ~VALID_SCISSOR_RECTS;
+            m_Misses++;
+        }
+        else if (m_Filter && (m_Valid & VALID_SCISSOR_RECTS) != 0 && m_ScissorRectCount == NumRects &&
+                 memcmp(m_ScissorRects, pRects, NumRects * sizeof(D3D11_RECT)) == 0)
+        {
+            m_Hits++;
+            return;
+        }
+        else
+        {
+            m_ScissorRectCount = NumRects;
+            memcpy(m_ScissorRects, pRects, NumRects * sizeof(D3D11_RECT));
+            m_Valid |= VALID_SCISSOR_RECTS;
+            m_Misses++;
+        }
+
+        m_pContext->RSSetScissorRects(NumRects, pRects);
+    }
+
+    void C_StateCache::OMSetRenderTargets(UINT NumViews, ID3D11RenderTargetView * const * ppRenderTargetViews, ID3D11DepthStencilView * pDepthStencilView)
+    {
+        // slots past NumViews are unbound by the call, so the full set is shadowed
+        ID3D11RenderTargetView * pRTVs[MaxRenderTargets] = { NULL };
+        for (UINT i = 0; i < NumViews && i < MaxRenderTargets && ppRenderTargetViews != NULL; i++)
+            pRTVs[i] = ppRenderTargetViews[i];
+
+        bool changed = !m_Filter || (m_Valid & VALID_RENDER_TARGETS) == 0 || m_pDSV != pDepthStencilView ||
+                       memcmp(m_pRTVs, pRTVs, sizeof(pRTVs)) != 0;
+        if (!changed)
+        {
+            m_Hits++;
+            return;
+        }
+
+        memcpy(m_pRTVs, pRTVs, sizeof(pRTVs));
+        m_pDSV = pDepthStencilView;
+        m_Valid |= VALID_RENDER_TARGETS;
+        m_Misses++;
+
+        m_pContext->OMSetRenderTargets(NumViews, ppRenderTargetViews, pDepthStencilView);
+
+        if (pDepthStencilView != NULL || anyBound(pRTVs, MaxRenderTargets))
+            invalidateOutputHazards(true, false);
+    }
+
+    void C_StateCache::OMSetRenderTargetsAndUnorderedAccessViews(UINT NumRTVs, ID3D11RenderTargetView * const * ppRenderTargetViews, ID3D11DepthStencilView * pDepthStencilView,
+                                                                 UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView * const * ppUnorderedAccessViews, const UINT * pUAVInitialCounts)
+    {
+        // pixel shader unordered access views are not shadowed, the bind is always forwarded
+        m_Misses++;
+        m_pContext->OMSetRenderTargetsAndUnorderedAccessViews(NumRTVs, ppRenderTargetViews, pDepthStencilView, UAVStartSlot, NumUAVs, ppUnorderedAccessViews, pUAVInitialCounts);
+
+        m_Valid &= ~VALID_RENDER_TARGETS;
+        invalidateOutputHazards(true, false);
+    }
+
+    void C_StateCache::OMSetBlendState(ID3D11BlendState * pBlendState, const FLOAT BlendFactor[4], UINT SampleMask)
+    {
+        static const FLOAT white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        const FLOAT * pFactor = BlendFactor != NULL ? BlendFactor : white;
+
+        if (m_Filter && (m_Valid & VALID_BLEND_STATE) != 0 && m_pBlendState == pBlendState && m_SampleMask == SampleMask &&
+            memcmp(m_BlendFactor, pFactor, sizeof(m_BlendFactor)) == 0)
+        {
+            m_Hits++;
+            return;
+        }
+
+        m_pBlendState = pBlendState;
+        m_SampleMask = SampleMask;
+        memcpy(m_BlendFactor, pFactor, sizeof(m_BlendFactor));
+        m_Valid |= VALID_BLEND_STATE;
+        m_Misses++;
+
+        m_pContext->OMSetBlendState(pBlendState, BlendFactor, SampleMask);
+    }
+
+    void C_StateCache::OMSetDepthStencilState(ID3D11DepthStencilState * pDepthStencilState, UINT StencilRef)
+    {
+        if (m_Filter && (m_Valid & VALID_DEPTH_STENCIL) != 0 && m_pDepthStencilState == pDepthStencilState && m_StencilRef == StencilRef)
+        {
+            m_Hits++;
+            return;
+        }
+
+        m_pDepthStencilState = pDepthStencilState;
+        m_StencilRef = StencilRef;
+        m_Valid |= VALID_DEPTH_STENCIL;
+        m_Misses++;
+
+        m_pContext->OMSetDepthStencilState(pDepthStencilState, StencilRef);
+    }
+}
\ No newline at end of file
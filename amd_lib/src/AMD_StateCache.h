@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef __AMD_STATE_CACHE_H__
+#define __AMD_STATE_CACHE_H__
+
+#include <d3d11_1.h>
+
+namespace AMD
+{
+    /*===========================================================================
+    SHADOW STATE CACHE
+    Mirrors the bindings made through it and only forwards the ones that change
+    the pipeline. Slot arrays are trimmed to the contiguous range that differs.
+    The shadow copy is only valid while every bind goes through the cache, call
+    Reset() whenever the context was used directly (e.g. at the start of a frame).
+    Binding a view as an output drops cached non NULL shader resource views, so
+    the read/write hazard unbinding of the runtime never leaves the cache stale.
+    ===========================================================================*/
+    class C_StateCache
+    {
+    public:
+        // slots tracked per binding point, binds past them are always forwarded
+        static const UINT MaxSlots = 16;
+        static const UINT MaxRenderTargets = D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT;
+        static const UINT MaxViewports = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+
+        // a cache created with filter == false forwards every bind
+        C_StateCache(ID3D11DeviceContext * context = NULL, bool filter = true);
+
+        // context1 is only needed by the *SetConstantBuffers1 binds, the cache does not keep a reference to either context
+        void Reset(ID3D11DeviceContext * context, ID3D11DeviceContext1 * context1 = NULL);
+        void ResetCounters();
+
+        ID3D11DeviceContext * GetContext() const { return m_pContext; }
+        UINT GetHits() const { return m_Hits; }
+        UINT GetMisses() const { return m_Misses; }
+
+        void IASetInputLayout(ID3D11InputLayout * pInputLayout);
+        void IASetVertexBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppVertexBuffers, const UINT * pStrides, const UINT * pOffsets);
+        void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology);
+
+        void VSSetShader(ID3D11VertexShader * pShader);
+        void GSSetShader(ID3D11GeometryShader * pShader);
+
+        void PSSetShader(ID3D11PixelShader * pShader);
+        void PSSetConstantBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers);
+        void PSSetConstantBuffers1(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers, const UINT * pFirstConstant, const UINT * pNumConstants);
+        void PSSetShaderResources(UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView * const * ppShaderResourceViews);
+        void PSSetSamplers(UINT StartSlot, UINT NumSamplers, ID3D11SamplerState * const * ppSamplers);
+
+        void CSSetShader(ID3D11ComputeShader * pShader);
+        void CSSetConstantBuffers(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers);
+        void CSSetConstantBuffers1(UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers, const UINT * pFirstConstant, const UINT * pNumConstants);
+        void CSSetShaderResources(UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView * const * ppShaderResourceViews);
+        void CSSetSamplers(UINT StartSlot, UINT NumSamplers, ID3D11SamplerState * const * ppSamplers);
+        void CSSetUnorderedAccessViews(UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView * const * ppUnorderedAccessViews, const UINT * pUAVInitialCounts);
+
+        void RSSetState(ID3D11RasterizerState * pRasterizerState);
+        void RSSetViewports(UINT NumViewports, const D3D11_VIEWPORT * pViewports);
+        void RSSetScissorRects(UINT NumRects, const D3D11_RECT * pRects);
+
+        void OMSetRenderTargets(UINT NumViews, ID3D11RenderTargetView * const * ppRenderTargetViews, ID3D11DepthStencilView * pDepthStencilView);
+        void OMSetRenderTargetsAndUnorderedAccessViews(UINT NumRTVs, ID3D11RenderTargetView * const * ppRenderTargetViews, ID3D11DepthStencilView * pDepthStencilView,
+                                                       UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView * const * ppUnorderedAccessViews, const UINT * pUAVInitialCounts);
+        void OMSetBlendState(ID3D11BlendState * pBlendState, const FLOAT BlendFactor[4], UINT SampleMask);
+        void OMSetDepthStencilState(ID3D11DepthStencilState * pDepthStencilState, UINT StencilRef);
+
+    private:
+        enum
+        {
+            VALID_INPUT_LAYOUT  = 1 << 0,
+            VALID_TOPOLOGY      = 1 << 1,
+            VALID_VS            = 1 << 2,
+            VALID_GS            = 1 << 3,
+            VALID_PS            = 1 << 4,
+            VALID_CS            = 1 << 5,
+            VALID_RS_STATE      = 1 << 6,
+            VALID_VIEWPORTS     = 1 << 7,
+            VALID_SCISSOR_RECTS = 1 << 8,
+            VALID_RENDER_TARGETS= 1 << 9,
+            VALID_BLEND_STATE   = 1 << 10,
+            VALID_DEPTH_STENCIL = 1 << 11,
+        };
+
+        struct S_StageShadow
+        {
+            ID3D11Buffer *              m_pConstantBuffers[MaxSlots];
+            UINT                        m_FirstConstant[MaxSlots];
+            UINT                        m_NumConstants[MaxSlots];
+            ID3D11ShaderResourceView *  m_pSRVs[MaxSlots];
+            ID3D11SamplerState *        m_pSamplers[MaxSlots];
+            UINT                        m_ValidConstantBuffers;
+            UINT                        m_ValidSRVs;
+            UINT                        m_ValidSamplers;
+        };
+
+        bool filterConstantBuffers(S_StageShadow & stage, UINT StartSlot, UINT NumBuffers, ID3D11Buffer * const * ppConstantBuffers,
+                                   const UINT * pFirstConstant, const UINT * pNumConstants, UINT & first, UINT & last);
+        bool filterValue(UINT flag, const void * pValue, void * pShadow, size_t size);
+        void invalidateOutputHazards(bool renderTargets, bool unorderedAccessViews);
+        void invalidateBoundSRVs(UINT & valid, ID3D11ShaderResourceView * const * ppShadow, UINT start, UINT count);
+
+        ID3D11DeviceContext *       m_pContext;
+        ID3D11DeviceContext1 *      m_pContext1;
+        bool                        m_Filter;
+        UINT                        m_Valid;
+        UINT                        m_Hits;
+        UINT                        m_Misses;
+
+        ID3D11InputLayout *         m_pInputLayout;
+        D3D11_PRIMITIVE_TOPOLOGY    m_Topology;
+        ID3D11Buffer *              m_pVertexBuffers[MaxSlots];
+        UINT                        m_VertexBufferStrides[MaxSlots];
+        UINT                        m_VertexBufferOffsets[MaxSlots];
+        UINT                        m_ValidVertexBuffers;
+
+        ID3D11VertexShader *        m_pVS;
+        ID3D11GeometryShader *      m_pGS;
+        ID3D11PixelShader *         m_pPS;
+        ID3D11ComputeShader *       m_pCS;
+        S_StageShadow               m_PSStage;
+        S_StageShadow               m_CSStage;
+        ID3D11UnorderedAccessView * m_pCSUAVs[MaxSlots];
+        UINT                        m_ValidCSUAVs;
+
+        ID3D11RasterizerState *     m_pRSState;
+        UINT                        m_ViewportCount;
+        D3D11_VIEWPORT              m_Viewports[MaxViewports];
+        UINT                        m_ScissorRectCount;
+        D3D11_RECT                  m_ScissorRects[MaxViewports];
+
+        ID3D11RenderTargetView *    m_pRTVs[MaxRenderTargets];
+        ID3D11DepthStencilView *    m_pDSV;
+        ID3D11BlendState *          m_pBlendState;
+        FLOAT                       m_BlendFactor[4];
+        UINT                        m_SampleMask;
+        ID3D11DepthStencilState *   m_pDepthStencilState;
+        UINT                        m_StencilRef;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -124,7 +124,7 @@ namespace
 
 struct handle_closer { void operator()(HANDLE h) { if (h) CloseHandle(h); } };
 
-typedef public std::unique_ptr<void, handle_closer> ScopedHandle;
+typedef std::unique_ptr<void, handle_closer> ScopedHandle;
 
 inline HANDLE safe_handle( HANDLE h ) { return (h == INVALID_HANDLE_VALUE) ? 0 : h; }
 
@@ -141,132 +141,6 @@ inline void SetDebugObjectName(_In_ ID3D11DeviceChild* resource, _In_ const char
 
 };
 
-//--------------------------------------------------------------------------------------
-static HRESULT LoadTextureDataFromFile( _In_z_ const wchar_t* fileName,
-                                        std::unique_ptr<uint8_t[]>& ddsData,
-                                        DDS_HEADER** header,
-                                        uint8_t** bitData,
-                                        size_t* bitSize
-                                      )
-{
-    if (!header || !bitData || !bitSize)
-    {
-        return E_POINTER;
-    }
-
-    // open the file
-#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
-    ScopedHandle hFile( safe_handle( CreateFile2( fileName,
-                                                  GENERIC_READ,
-                                                  FILE_SHARE_READ,
-                                                  OPEN_EXISTING,
-                                                  nullptr ) ) );
-#else
-    ScopedHandle hFile( safe_handle( CreateFileW( fileName,
-                                                  GENERIC_READ,
-                                                  FILE_SHARE_READ,
-                                                  nullptr,
-                                                  OPEN_EXISTING,
-                                                  FILE_ATTRIBUTE_NORMAL,
-                                                  nullptr ) ) );
-#endif
-
-    if ( !hFile )
-    {
-        return HRESULT_FROM_WIN32( GetLastError() );
-    }
-
-    // Get the file size
-    LARGE_INTEGER FileSize = { 0 };
-
-#if (_WIN32_WINNT >= _WIN32_WINNT_VISTA)
-    FILE_STANDARD_INFO fileInfo;
-    if ( !GetFileInformationByHandleEx( hFile.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo) ) )
-    {
-        return HRESULT_FROM_WIN32( GetLastError() );
-    }
-    FileSize = fileInfo.EndOfFile;
-#else
-    GetFileSizeEx( hFile.get(), &FileSize );
-#endif
-
-    // File is too big for 32-bit allocation, so reject read
-    if (FileSize.HighPart > 0)
-    {
-        return E_FAIL;
-    }
-
-    // Need at least enough data to fill the header and magic number to be a valid DDS
-    if (FileSize.LowPart < ( sizeof(DDS_HEADER) + sizeof(uint32_t) ) )
-    {
-        return E_FAIL;
-    }
-
-    // create enough space for the file data
-    ddsData.reset( new (std::nothrow) uint8_t[ FileSize.LowPart ] );
-    if (!ddsData)
-    {
-        return E_OUTOFMEMORY;
-    }
-
-    // read the data in
-    DWORD BytesRead = 0;
-    if (!ReadFile( hFile.get(),
-                   ddsData.get(),
-                   FileSize.LowPart,
-                   &BytesRead,
-                   nullptr
-                 ))
-    {
-        return HRESULT_FROM_WIN32( GetLastError() );
-    }
-
-    if (BytesRead < FileSize.LowPart)
-    {
-        return E_FAIL;
-    }
-
-    // DDS files always start with the same magic number ("DDS ")
-    uint32_t dwMagicNumber = *( const uint32_t* )( ddsData.get() );
-    if (dwMagicNumber != DDS_MAGIC)
-    {
-        return E_FAIL;
-    }
-
-    auto hdr = reinterpret_cast<DDS_HEADER*>( ddsData.get() + sizeof( uint32_t ) );
-
-    // Verify header to validate DDS file
-    if (hdr->size != sizeof(DDS_HEADER) ||
-        hdr->ddspf.size != sizeof(DDS_PIXELFORMAT))
-    {
-        return E_FAIL;
-    }
-
-    // Check for DX10 extension
-    bool bDXT10Header = false;
-    if ((hdr->ddspf.flags & DDS_FOURCC) &&
-        (MAKEFOURCC( 'D', 'X', '1', '0' ) == hdr->ddspf.fourCC))
-    {
-        // Must be long enough for both headers and magic value
-        if (FileSize.LowPart < ( sizeof(DDS_HEADER) + sizeof(uint32_t) + sizeof(DDS_HEADER_DXT10) ) )
-        {
-            return E_FAIL;
-        }
-
-        bDXT10Header = true;
-    }
-
-    // setup the pointers in the process request
-    *header = hdr;
-    ptrdiff_t offset = sizeof( uint32_t ) + sizeof( DDS_HEADER )
-                       + (bDXT10Header ? sizeof( DDS_HEADER_DXT10 ) : 0);
-    *bitData = ddsData.get() + offset;
-    *bitSize = FileSize.LowPart - offset;
-
-    return S_OK;
-}
-
-
 //--------------------------------------------------------------------------------------
 // Return the BPP for a particular format
 //--------------------------------------------------------------------------------------
@@ -420,16 +294,16 @@ static size_t BitsPerPixel( _In_ DXGI_FORMAT fmt )
 //--------------------------------------------------------------------------------------
 // Get surface information for a particular format
 //--------------------------------------------------------------------------------------
-static void GetSurfaceInfo( _In_ size_t width,
-                            _In_ size_t height,
-                            _In_ DXGI_FORMAT fmt,
-                            _Out_opt_ size_t* outNumBytes,
-                            _Out_opt_ size_t* outRowBytes,
-                            _Out_opt_ size_t* outNumRows )
+static HRESULT GetSurfaceInfo( _In_ size_t width,
+                               _In_ size_t height,
+                               _In_ DXGI_FORMAT fmt,
+                               _Out_opt_ size_t* outNumBytes,
+                               _Out_opt_ size_t* outRowBytes,
+                               _Out_opt_ size_t* outNumRows )
 {
-    size_t numBytes = 0;
-    size_t rowBytes = 0;
-    size_t numRows = 0;
+    uint64_t numBytes = 0;
+    uint64_t rowBytes = 0;
+    uint64_t numRows = 0;
 
     bool bc = false;
     bool packed = false;
@@ -494,15 +368,15 @@ static void GetSurfaceInfo( _In_ size_t width,
 
     if (bc)
     {
-        size_t numBlocksWide = 0;
+        uint64_t numBlocksWide = 0;
         if (width > 0)
         {
-            numBlocksWide = std::max<size_t>( 1, (width + 3) / 4 );
+            numBlocksWide = std::max<uint64_t>( 1, (uint64_t(width) + 3u) / 4u );
         }
-        size_t numBlocksHigh = 0;
+        uint64_t numBlocksHigh = 0;
         if (height > 0)
         {
-            numBlocksHigh = std::max<size_t>( 1, (height + 3) / 4 );
+            numBlocksHigh = std::max<uint64_t>( 1, (uint64_t(height) + 3u) / 4u );
         }
         rowBytes = numBlocksWide * bpe;
         numRows = numBlocksHigh;
@@ -510,42 +384,55 @@ static void GetSurfaceInfo( _In_ size_t width,
     }
     else if (packed)
     {
-        rowBytes = ( ( width + 1 ) >> 1 ) * bpe;
-        numRows = height;
+        rowBytes = ( ( uint64_t(width) + 1u ) >> 1 ) * bpe;
+        numRows = uint64_t(height);
         numBytes = rowBytes * height;
     }
     else if ( fmt == DXGI_FORMAT_NV11 )
     {
-        rowBytes = ( ( width + 3 ) >> 2 ) * 4;
-        numRows = height * 2; // Direct3D makes this simplifying assumption, although it is larger than the 4:1:1 data
+        rowBytes = ( ( uint64_t(width) + 3u ) >> 2 ) * 4u;
+        numRows = uint64_t(height) * 2u; // Direct3D makes this simplifying assumption, although it is larger than the 4:1:1 data
         numBytes = rowBytes * numRows;
     }
     else if (planar)
     {
-        rowBytes = ( ( width + 1 ) >> 1 ) * bpe;
-        numBytes = ( rowBytes * height ) + ( ( rowBytes * height + 1 ) >> 1 );
-        numRows = height + ( ( height + 1 ) >> 1 );
+        rowBytes = ( ( uint64_t(width) + 1u ) >> 1 ) * bpe;
+        numBytes = ( rowBytes * uint64_t(height) ) + ( ( rowBytes * uint64_t(height) + 1u ) >> 1 );
+        numRows = height + ( ( uint64_t(height) + 1u ) >> 1 );
     }
     else
     {
         size_t bpp = BitsPerPixel( fmt );
-        rowBytes = ( width * bpp + 7 ) / 8; // round up to nearest byte
-        numRows = height;
+        if (!bpp)
+        {
+            return E_INVALIDARG;
+        }
+
+        rowBytes = ( uint64_t(width) * bpp + 7u ) / 8u; // round up to nearest byte
+        numRows = uint64_t(height);
         numBytes = rowBytes * height;
     }
 
+    // Pitches are handed to Direct3D as UINTs, so anything larger can only come from a corrupt header
+    if (numBytes > UINT32_MAX || rowBytes > UINT32_MAX || numRows > UINT32_MAX)
+    {
+        return HRESULT_FROM_WIN32( ERROR_ARITHMETIC_OVERFLOW );
+    }
+
     if (outNumBytes)
     {
-        *outNumBytes = numBytes;
+        *outNumBytes = static_cast<size_t>( numBytes );
     }
     if (outRowBytes)
     {
-        *outRowBytes = rowBytes;
+        *outRowBytes = static_cast<size_t>( rowBytes );
     }
     if (outNumRows)
     {
-        *outNumRows = numRows;
+        *outNumRows = static_cast<size_t>( numRows );
     }
+
+    return S_OK;
 }
 
 
@@ -820,22 +707,17 @@ static DXGI_FORMAT MakeSRGB( _In_ DXGI_FORMAT format )
 
 
 //--------------------------------------------------------------------------------------
-static HRESULT FillInitData( _In_ size_t width,
-                             _In_ size_t height,
-                             _In_ size_t depth,
-                             _In_ size_t mipCount,
-                             _In_ size_t arraySize,
-                             _In_ DXGI_FORMAT format,
+static HRESULT FillInitData( _In_ const uint8_t* ddsData,
+                             _In_ const DDS_TEXTURE_INFO& info,
+                             _In_reads_(info.subresourceCount) const DDS_SUBRESOURCE* subresources,
                              _In_ size_t maxsize,
-                             _In_ size_t bitSize,
-                             _In_reads_bytes_(bitSize) const uint8_t* bitData,
                              _Out_ size_t& twidth,
                              _Out_ size_t& theight,
                              _Out_ size_t& tdepth,
                              _Out_ size_t& skipMip,
-                             _Out_writes_(mipCount*arraySize) D3D11_SUBRESOURCE_DATA* initData )
+                             _Out_writes_(info.subresourceCount) D3D11_SUBRESOURCE_DATA* initData )
 {
-    if ( !bitData || !initData )
+    if ( !ddsData || !subresources || !initData )
     {
         return E_POINTER;
     }
@@ -845,71 +727,32 @@ static HRESULT FillInitData( _In_ size_t width,
     theight = 0;
     tdepth = 0;
 
-    size_t NumBytes = 0;
-    size_t RowBytes = 0;
-    const uint8_t* pSrcBits = bitData;
-    const uint8_t* pEndBits = bitData + bitSize;
-
+    // The subresource table has already been bounds checked against the DDS data by ParseDDSTexture
     size_t index = 0;
-    for( size_t j = 0; j < arraySize; j++ )
+    for( size_t j = 0; j < info.subresourceCount; j++ )
     {
-        size_t w = width;
-        size_t h = height;
-        size_t d = depth;
-        for( size_t i = 0; i < mipCount; i++ )
-        {
-            GetSurfaceInfo( w,
-                            h,
-                            format,
-                            &NumBytes,
-                            &RowBytes,
-                            nullptr
-                          );
-
-            if ( (mipCount <= 1) || !maxsize || (w <= maxsize && h <= maxsize && d <= maxsize) )
-            {
-                if ( !twidth )
-                {
-                    twidth = w;
-                    theight = h;
-                    tdepth = d;
-                }
-
-                assert(index < mipCount * arraySize);
-                _Analysis_assume_(index < mipCount * arraySize);
-                initData[index].pSysMem = ( const void* )pSrcBits;
-                initData[index].SysMemPitch = static_cast<UINT>( RowBytes );
-                initData[index].SysMemSlicePitch = static_cast<UINT>( NumBytes );
-                ++index;
-            }
-            else if ( !j )
-            {
-                // Count number of skipped mipmaps (first item only)
-                ++skipMip;
-            }
+        const DDS_SUBRESOURCE& sub = subresources[ j ];
 
-            if (pSrcBits + (NumBytes*d) > pEndBits)
+        if ( (info.mipLevels <= 1) || !maxsize || (sub.width <= maxsize && sub.height <= maxsize && sub.depth <= maxsize) )
+        {
+            if ( !twidth )
             {
-                return HRESULT_FROM_WIN32( ERROR_HANDLE_EOF );
+                twidth = sub.width;
+                theight = sub.height;
+                tdepth = sub.depth;
             }
-  
-            pSrcBits += NumBytes * d;
 
-            w = w >> 1;
-            h = h >> 1;
-            d = d >> 1;
-            if (w == 0)
-            {
-                w = 1;
-            }
-            if (h == 0)
-            {
-                h = 1;
-            }
-            if (d == 0)
-            {
-                d = 1;
-            }
+            assert(index < info.subresourceCount);
+            _Analysis_assume_(index < info.subresourceCount);
+            initData[index].pSysMem = ( const void* )( ddsData + sub.offset );
+            initData[index].SysMemPitch = static_cast<UINT>( sub.rowPitch );
+            initData[index].SysMemSlicePitch = static_cast<UINT>( sub.slicePitch );
+            ++index;
+        }
+        else if ( !sub.arraySlice )
+        {
+            // Count number of skipped mipmaps (first item only)
+            ++skipMip;
         }
     }
 
@@ -1155,21 +998,75 @@ static HRESULT CreateD3DResources( _In_ ID3D11Device* d3dDevice,
 
 
 //--------------------------------------------------------------------------------------
-static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
-                                     _In_opt_ ID3D11DeviceContext* d3dContext,
-                                     _In_ const DDS_HEADER* header,
-                                     _In_reads_bytes_(bitSize) const uint8_t* bitData,
-                                     _In_ size_t bitSize,
-                                     _In_ size_t maxsize,
-                                     _In_ D3D11_USAGE usage,
-                                     _In_ unsigned int bindFlags,
-                                     _In_ unsigned int cpuAccessFlags,
-                                     _In_ unsigned int miscFlags,
-                                     _In_ bool forceSRGB,
-                                     _Outptr_opt_ ID3D11Resource** texture,
-                                     _Outptr_opt_ ID3D11ShaderResourceView** textureView )
+static DDS_ALPHA_MODE GetAlphaMode( _In_ const DDS_HEADER* header )
 {
-    HRESULT hr = S_OK;
+    if ( header->ddspf.flags & DDS_FOURCC )
+    {
+        if ( MAKEFOURCC( 'D', 'X', '1', '0' ) == header->ddspf.fourCC )
+        {
+            auto d3d10ext = reinterpret_cast<const DDS_HEADER_DXT10*>( (const char*)header + sizeof(DDS_HEADER) );
+            auto mode = static_cast<DDS_ALPHA_MODE>( d3d10ext->miscFlags2 & DDS_MISC_FLAGS2_ALPHA_MODE_MASK );
+            switch( mode )
+            {
+            case DDS_ALPHA_MODE_STRAIGHT:
+            case DDS_ALPHA_MODE_PREMULTIPLIED:
+            case DDS_ALPHA_MODE_OPAQUE:
+            case DDS_ALPHA_MODE_CUSTOM:
+                return mode;
+            }
+        }
+        else if ( ( MAKEFOURCC( 'D', 'X', 'T', '2' ) == header->ddspf.fourCC )
+                  || ( MAKEFOURCC( 'D', 'X', 'T', '4' ) == header->ddspf.fourCC ) )
+        {
+            return DDS_ALPHA_MODE_PREMULTIPLIED;
+        }
+    }
+
+    return DDS_ALPHA_MODE_UNKNOWN;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Validates the DDS headers and fills in everything but the subresource layout
+//--------------------------------------------------------------------------------------
+static HRESULT ParseHeader( _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+                            _In_ size_t ddsDataSize,
+                            _Out_ DDS_TEXTURE_INFO& info )
+{
+    // Validate DDS file in memory
+    if (ddsDataSize < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
+    {
+        return E_FAIL;
+    }
+
+    uint32_t dwMagicNumber = *( const uint32_t* )( ddsData );
+    if (dwMagicNumber != DDS_MAGIC)
+    {
+        return E_FAIL;
+    }
+
+    auto header = reinterpret_cast<const DDS_HEADER*>( ddsData + sizeof( uint32_t ) );
+
+    // Verify header to validate DDS file
+    if (header->size != sizeof(DDS_HEADER) ||
+        header->ddspf.size != sizeof(DDS_PIXELFORMAT))
+    {
+        return E_FAIL;
+    }
+
+    // Check for DX10 extension
+    bool bDXT10Header = false;
+    if ((header->ddspf.flags & DDS_FOURCC) &&
+        (MAKEFOURCC( 'D', 'X', '1', '0' ) == header->ddspf.fourCC) )
+    {
+        // Must be long enough for both headers and magic value
+        if (ddsDataSize < (sizeof(DDS_HEADER) + sizeof(uint32_t) + sizeof(DDS_HEADER_DXT10)))
+        {
+            return E_FAIL;
+        }
+
+        bDXT10Header = true;
+    }
 
     UINT width = header->width;
     UINT height = header->height;
@@ -1186,8 +1083,7 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
         mipCount = 1;
     }
 
-    if ((header->ddspf.flags & DDS_FOURCC) &&
-        (MAKEFOURCC( 'D', 'X', '1', '0' ) == header->ddspf.fourCC ))
+    if ( bDXT10Header )
     {
         auto d3d10ext = reinterpret_cast<const DDS_HEADER_DXT10*>( (const char*)header + sizeof(DDS_HEADER) );
 
@@ -1211,7 +1107,7 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
                 return HRESULT_FROM_WIN32( ERROR_NOT_SUPPORTED );
             }
         }
-           
+
         format = d3d10ext->dxgiFormat;
 
         switch ( d3d10ext->resourceDimension )
@@ -1228,6 +1124,12 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
         case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
             if (d3d10ext->miscFlag & D3D11_RESOURCE_MISC_TEXTURECUBE)
             {
+                // Bound the cube count first so the multiply below can't wrap past the array size check
+                if (arraySize > D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION / 6)
+                {
+                    return HRESULT_FROM_WIN32( ERROR_NOT_SUPPORTED );
+                }
+
                 arraySize *= 6;
                 isCubeMap = true;
             }
@@ -1265,7 +1167,7 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
         {
             resDim = D3D11_RESOURCE_DIMENSION_TEXTURE3D;
         }
-        else 
+        else
         {
             if (header->caps2 & DDS_CUBEMAP)
             {
@@ -1337,12 +1239,68 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
         return HRESULT_FROM_WIN32( ERROR_NOT_SUPPORTED );
     }
 
+    // Empty surfaces and mip chains that go past 1x1x1 would make the subresource layout meaningless
+    if (!width || !height || !depth)
+    {
+        return HRESULT_FROM_WIN32( ERROR_INVALID_DATA );
+    }
+
+    size_t fullMipCount = 1;
+    for( UINT largest = std::max<UINT>( std::max<UINT>( width, height ), depth ); largest > 1; largest >>= 1 )
+    {
+        ++fullMipCount;
+    }
+
+    if (mipCount > fullMipCount)
+    {
+        return HRESULT_FROM_WIN32( ERROR_INVALID_DATA );
+    }
+
+    info.resourceDimension = static_cast<D3D11_RESOURCE_DIMENSION>( resDim );
+    info.format = format;
+    info.width = width;
+    info.height = height;
+    info.depth = depth;
+    info.mipLevels = static_cast<uint32_t>( mipCount );
+    info.arraySize = arraySize;
+    info.isCubeMap = isCubeMap;
+    info.alphaMode = GetAlphaMode( header );
+    info.dataOffset = sizeof( uint32_t )
+                      + sizeof( DDS_HEADER )
+                      + (bDXT10Header ? sizeof( DDS_HEADER_DXT10 ) : 0);
+    info.subresourceCount = mipCount * arraySize;
+
+    return S_OK;
+}
+
+
+//--------------------------------------------------------------------------------------
+static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
+                                     _In_opt_ ID3D11DeviceContext* d3dContext,
+                                     _In_ const uint8_t* ddsData,
+                                     _In_ const DDS_TEXTURE_INFO& info,
+                                     _In_reads_(info.subresourceCount) const DDS_SUBRESOURCE* subresources,
+                                     _In_ size_t maxsize,
+                                     _In_ D3D11_USAGE usage,
+                                     _In_ unsigned int bindFlags,
+                                     _In_ unsigned int cpuAccessFlags,
+                                     _In_ unsigned int miscFlags,
+                                     _In_ bool forceSRGB,
+                                     _Outptr_opt_ ID3D11Resource** texture,
+                                     _Outptr_opt_ ID3D11ShaderResourceView** textureView )
+{
+    HRESULT hr = S_OK;
+
+    const uint32_t resDim = info.resourceDimension;
+    const size_t mipCount = info.mipLevels;
+    const size_t arraySize = info.arraySize;
+
     bool autogen = false;
     if ( mipCount == 1 && d3dContext != 0 && textureView != 0 ) // Must have context and shader-view to auto generate mipmaps
     {
         // See if format is supported for auto-gen mipmaps (varies by feature level)
         UINT fmtSupport = 0;
-        hr = d3dDevice->CheckFormatSupport( format, &fmtSupport );
+        hr = d3dDevice->CheckFormatSupport( info.format, &fmtSupport );
         if ( SUCCEEDED(hr) && ( fmtSupport & D3D11_FORMAT_SUPPORT_MIP_AUTOGEN ) )
         {
             // 10level9 feature levels do not support auto-gen mipgen for volume textures
@@ -1358,26 +1316,14 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
     {
         // Create texture with auto-generated mipmaps
         ID3D11Resource* tex = nullptr;
-        hr = CreateD3DResources( d3dDevice, resDim, width, height, depth, 0, arraySize,
-                                 format, usage,
+        hr = CreateD3DResources( d3dDevice, resDim, info.width, info.height, info.depth, 0, arraySize,
+                                 info.format, usage,
                                  bindFlags | D3D11_BIND_RENDER_TARGET,
                                  cpuAccessFlags,
                                  miscFlags | D3D11_RESOURCE_MISC_GENERATE_MIPS, forceSRGB,
-                                 isCubeMap, nullptr, &tex, textureView );
+                                 info.isCubeMap, nullptr, &tex, textureView );
         if ( SUCCEEDED(hr) )
         {
-            size_t numBytes = 0;
-            size_t rowBytes = 0;
-            GetSurfaceInfo( width, height, format, &numBytes, &rowBytes, nullptr );
-
-            if ( numBytes > bitSize )
-            {
-                (*textureView)->Release();
-                *textureView = nullptr;
-                tex->Release();
-                return HRESULT_FROM_WIN32( ERROR_HANDLE_EOF );
-            }
-
             D3D11_SHADER_RESOURCE_VIEW_DESC desc;
             (*textureView)->GetDesc( &desc );
 
@@ -1399,28 +1345,13 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
                 return E_UNEXPECTED;
             }
 
-            if ( arraySize > 1 )
+            // The file has a single mip per item, so the table holds exactly one entry per item
+            for( UINT item = 0; item < arraySize; ++item )
             {
-                const uint8_t* pSrcBits = bitData;
-                const uint8_t* pEndBits = bitData + bitSize;
-                for( UINT item = 0; item < arraySize; ++item )
-                {
-                    if ( (pSrcBits + numBytes) > pEndBits )
-                    {
-                        (*textureView)->Release();
-                        *textureView = nullptr;
-                        tex->Release();
-                        return HRESULT_FROM_WIN32( ERROR_HANDLE_EOF );
-                    }
+                const DDS_SUBRESOURCE& sub = subresources[ item ];
 
-                    UINT res = D3D11CalcSubresource( 0, item, mipLevels );
-                    d3dContext->UpdateSubresource( tex, res, nullptr, pSrcBits, static_cast<UINT>(rowBytes), static_cast<UINT>(numBytes) );
-                    pSrcBits += numBytes;
-                }
-            }
-            else
-            {
-                d3dContext->UpdateSubresource( tex, 0, nullptr, bitData, static_cast<UINT>(rowBytes), static_cast<UINT>(numBytes) );
+                UINT res = D3D11CalcSubresource( 0, item, mipLevels );
+                d3dContext->UpdateSubresource( tex, res, nullptr, ddsData + sub.offset, static_cast<UINT>(sub.rowPitch), static_cast<UINT>(sub.slicePitch) );
             }
 
             d3dContext->GenerateMips( *textureView );
@@ -1438,7 +1369,7 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
     else
     {
         // Create the texture
-        std::unique_ptr<D3D11_SUBRESOURCE_DATA[]> initData( new (std::nothrow) D3D11_SUBRESOURCE_DATA[ mipCount * arraySize ] );
+        std::unique_ptr<D3D11_SUBRESOURCE_DATA[]> initData( new (std::nothrow) D3D11_SUBRESOURCE_DATA[ info.subresourceCount ] );
         if ( !initData )
         {
             return E_OUTOFMEMORY;
@@ -1448,14 +1379,14 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
         size_t twidth = 0;
         size_t theight = 0;
         size_t tdepth = 0;
-        hr = FillInitData( width, height, depth, mipCount, arraySize, format, maxsize, bitSize, bitData,
+        hr = FillInitData( ddsData, info, subresources, maxsize,
                            twidth, theight, tdepth, skipMip, initData.get() );
 
         if ( SUCCEEDED(hr) )
         {
             hr = CreateD3DResources( d3dDevice, resDim, twidth, theight, tdepth, mipCount - skipMip, arraySize,
-                                     format, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
-                                     isCubeMap, initData.get(), texture, textureView );
+                                     info.format, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
+                                     info.isCubeMap, initData.get(), texture, textureView );
 
             if ( FAILED(hr) && !maxsize && (mipCount > 1) )
             {
@@ -1464,7 +1395,7 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
                 {
                 case D3D_FEATURE_LEVEL_9_1:
                 case D3D_FEATURE_LEVEL_9_2:
-                    if ( isCubeMap )
+                    if ( info.isCubeMap )
                     {
                         maxsize = 512 /*D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION*/;
                     }
@@ -1489,13 +1420,13 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
                     break;
                 }
 
-                hr = FillInitData( width, height, depth, mipCount, arraySize, format, maxsize, bitSize, bitData,
+                hr = FillInitData( ddsData, info, subresources, maxsize,
                                    twidth, theight, tdepth, skipMip, initData.get() );
                 if ( SUCCEEDED(hr) )
                 {
                     hr = CreateD3DResources( d3dDevice, resDim, twidth, theight, tdepth, mipCount - skipMip, arraySize,
-                                             format, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
-                                             isCubeMap, initData.get(), texture, textureView );
+                                             info.format, usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
+                                             info.isCubeMap, initData.get(), texture, textureView );
                 }
             }
         }
@@ -1506,31 +1437,246 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
 
 
 //--------------------------------------------------------------------------------------
-static DDS_ALPHA_MODE GetAlphaMode( _In_ const DDS_HEADER* header )
+static HRESULT CreateTextureFromMemory( _In_ ID3D11Device* d3dDevice,
+                                        _In_opt_ ID3D11DeviceContext* d3dContext,
+                                        _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+                                        _In_ size_t ddsDataSize,
+                                        _In_ size_t maxsize,
+                                        _In_ D3D11_USAGE usage,
+                                        _In_ unsigned int bindFlags,
+                                        _In_ unsigned int cpuAccessFlags,
+                                        _In_ unsigned int miscFlags,
+                                        _In_ bool forceSRGB,
+                                        _Outptr_opt_ ID3D11Resource** texture,
+                                        _Outptr_opt_ ID3D11ShaderResourceView** textureView,
+                                        _Out_opt_ DDS_ALPHA_MODE* alphaMode )
 {
-    if ( header->ddspf.flags & DDS_FOURCC )
+    DDS_TEXTURE_INFO info;
+    HRESULT hr = ParseDDSTexture( ddsData, ddsDataSize, &info );
+    if ( FAILED(hr) )
     {
-        if ( MAKEFOURCC( 'D', 'X', '1', '0' ) == header->ddspf.fourCC )
+        return hr;
+    }
+
+    std::unique_ptr<DDS_SUBRESOURCE[]> subresources( new (std::nothrow) DDS_SUBRESOURCE[ info.subresourceCount ] );
+    if ( !subresources )
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    hr = ParseDDSTexture( ddsData, ddsDataSize, &info, subresources.get(), info.subresourceCount );
+    if ( FAILED(hr) )
+    {
+        return hr;
+    }
+
+    hr = CreateTextureFromDDS( d3dDevice, d3dContext, ddsData, info, subresources.get(), maxsize,
+                               usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
+                               texture, textureView );
+    if ( SUCCEEDED(hr) && alphaMode )
+    {
+        *alphaMode = info.alphaMode;
+    }
+
+    return hr;
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::ParseDDSTexture( const uint8_t* ddsData,
+                                  size_t ddsDataSize,
+                                  DDS_TEXTURE_INFO* info,
+                                  DDS_SUBRESOURCE* subresources,
+                                  size_t maxSubresources )
+{
+    if ( !info )
+    {
+        return E_INVALIDARG;
+    }
+
+    memset( info, 0, sizeof(DDS_TEXTURE_INFO) );
+
+    if ( !ddsData )
+    {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = ParseHeader( ddsData, ddsDataSize, *info );
+    if ( FAILED(hr) )
+    {
+        return hr;
+    }
+
+    if ( subresources && maxSubresources < info->subresourceCount )
+    {
+        return HRESULT_FROM_WIN32( ERROR_INSUFFICIENT_BUFFER );
+    }
+
+    // Walk the layout in D3D11CalcSubresource order, every mip of the first item, then the next item
+    uint64_t offset = info->dataOffset;
+    size_t index = 0;
+    for( uint32_t item = 0; item < info->arraySize; ++item )
+    {
+        uint32_t w = info->width;
+        uint32_t h = info->height;
+        uint32_t d = info->depth;
+        for( uint32_t level = 0; level < info->mipLevels; ++level )
         {
-            auto d3d10ext = reinterpret_cast<const DDS_HEADER_DXT10*>( (const char*)header + sizeof(DDS_HEADER) );
-            auto mode = static_cast<DDS_ALPHA_MODE>( d3d10ext->miscFlags2 & DDS_MISC_FLAGS2_ALPHA_MODE_MASK );
-            switch( mode )
+            size_t numBytes = 0;
+            size_t rowBytes = 0;
+            hr = GetSurfaceInfo( w, h, info->format, &numBytes, &rowBytes, nullptr );
+            if ( FAILED(hr) )
             {
-            case DDS_ALPHA_MODE_STRAIGHT:
-            case DDS_ALPHA_MODE_PREMULTIPLIED:
-            case DDS_ALPHA_MODE_OPAQUE:
-            case DDS_ALPHA_MODE_CUSTOM:
-                return mode;
+                return hr;
             }
-        }
-        else if ( ( MAKEFOURCC( 'D', 'X', 'T', '2' ) == header->ddspf.fourCC )
-                  || ( MAKEFOURCC( 'D', 'X', 'T', '4' ) == header->ddspf.fourCC ) )
-        {
-            return DDS_ALPHA_MODE_PREMULTIPLIED;
+
+            uint64_t size = uint64_t( numBytes ) * d;
+            if ( size > ddsDataSize - offset )
+            {
+                return HRESULT_FROM_WIN32( ERROR_HANDLE_EOF );
+            }
+
+            if ( subresources )
+            {
+                DDS_SUBRESOURCE& sub = subresources[ index ];
+                sub.offset = static_cast<size_t>( offset );
+                sub.rowPitch = rowBytes;
+                sub.slicePitch = numBytes;
+                sub.size = static_cast<size_t>( size );
+                sub.width = w;
+                sub.height = h;
+                sub.depth = d;
+                sub.mipLevel = level;
+                sub.arraySlice = item;
+            }
+
+            offset += size;
+            ++index;
+
+            w = std::max<uint32_t>( w >> 1, 1 );
+            h = std::max<uint32_t>( h >> 1, 1 );
+            d = std::max<uint32_t>( d >> 1, 1 );
         }
     }
 
-    return DDS_ALPHA_MODE_UNKNOWN;
+    assert( index == info->subresourceCount );
+
+    return S_OK;
+}
+
+
+//--------------------------------------------------------------------------------------
+DDSMappedFile::DDSMappedFile() :
+    m_data( nullptr ),
+    m_size( 0 )
+{
+}
+
+DDSMappedFile::~DDSMappedFile()
+{
+    Close();
+}
+
+_Use_decl_annotations_
+HRESULT DDSMappedFile::Open( const wchar_t* fileName )
+{
+    Close();
+
+    if ( !fileName )
+    {
+        return E_INVALIDARG;
+    }
+
+    // open the file
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    ScopedHandle hFile( safe_handle( CreateFile2( fileName,
+                                                  GENERIC_READ,
+                                                  FILE_SHARE_READ,
+                                                  OPEN_EXISTING,
+                                                  nullptr ) ) );
+#else
+    ScopedHandle hFile( safe_handle( CreateFileW( fileName,
+                                                  GENERIC_READ,
+                                                  FILE_SHARE_READ,
+                                                  nullptr,
+                                                  OPEN_EXISTING,
+                                                  FILE_ATTRIBUTE_NORMAL,
+                                                  nullptr ) ) );
+#endif
+
+    if ( !hFile )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    // Get the file size
+    LARGE_INTEGER FileSize = { 0 };
+
+#if (_WIN32_WINNT >= _WIN32_WINNT_VISTA)
+    FILE_STANDARD_INFO fileInfo;
+    if ( !GetFileInformationByHandleEx( hFile.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo) ) )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+    FileSize = fileInfo.EndOfFile;
+#else
+    GetFileSizeEx( hFile.get(), &FileSize );
+#endif
+
+#if !defined(_WIN64)
+    // File is too big to map into a 32-bit address space, so reject it
+    if (FileSize.HighPart > 0)
+    {
+        return E_FAIL;
+    }
+#endif
+
+    // Need at least enough data to fill the header and magic number to be a valid DDS
+    if (FileSize.QuadPart < static_cast<LONGLONG>( sizeof(DDS_HEADER) + sizeof(uint32_t) ) )
+    {
+        return E_FAIL;
+    }
+
+    // Map the whole file read-only, the pages are only read in when the texture upload touches them
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    ScopedHandle hMapping( CreateFileMappingFromApp( hFile.get(), nullptr, PAGE_READONLY, 0, nullptr ) );
+#else
+    ScopedHandle hMapping( CreateFileMappingW( hFile.get(), nullptr, PAGE_READONLY, 0, 0, nullptr ) );
+#endif
+
+    if ( !hMapping )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    const void* view = MapViewOfFileFromApp( hMapping.get(), FILE_MAP_READ, 0, 0 );
+#else
+    const void* view = MapViewOfFile( hMapping.get(), FILE_MAP_READ, 0, 0, 0 );
+#endif
+
+    if ( !view )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    // The view keeps the mapping and the file open, and a mapped file can't be truncated,
+    // so both handles can be closed here without invalidating the bounds checked later
+    m_data = static_cast<const uint8_t*>( view );
+    m_size = static_cast<size_t>( FileSize.QuadPart );
+
+    return S_OK;
+}
+
+void DDSMappedFile::Close()
+{
+    if ( m_data )
+    {
+        UnmapViewOfFile( m_data );
+        m_data = nullptr;
+    }
+    m_size = 0;
 }
 
 
@@ -1616,49 +1762,9 @@ HRESULT DirectX::CreateDDSTextureFromMemoryEx( ID3D11Device* d3dDevice,
         return E_INVALIDARG;
     }
 
-    // Validate DDS file in memory
-    if (ddsDataSize < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
-    {
-        return E_FAIL;
-    }
-
-    uint32_t dwMagicNumber = *( const uint32_t* )( ddsData );
-    if (dwMagicNumber != DDS_MAGIC)
-    {
-        return E_FAIL;
-    }
-
-    auto header = reinterpret_cast<const DDS_HEADER*>( ddsData + sizeof( uint32_t ) );
-
-    // Verify header to validate DDS file
-    if (header->size != sizeof(DDS_HEADER) ||
-        header->ddspf.size != sizeof(DDS_PIXELFORMAT))
-    {
-        return E_FAIL;
-    }
-
-    // Check for DX10 extension
-    bool bDXT10Header = false;
-    if ((header->ddspf.flags & DDS_FOURCC) &&
-        (MAKEFOURCC( 'D', 'X', '1', '0' ) == header->ddspf.fourCC) )
-    {
-        // Must be long enough for both headers and magic value
-        if (ddsDataSize < (sizeof(DDS_HEADER) + sizeof(uint32_t) + sizeof(DDS_HEADER_DXT10)))
-        {
-            return E_FAIL;
-        }
-
-        bDXT10Header = true;
-    }
-
-    ptrdiff_t offset = sizeof( uint32_t )
-                       + sizeof( DDS_HEADER )
-                       + (bDXT10Header ? sizeof( DDS_HEADER_DXT10 ) : 0);
-
-    HRESULT hr = CreateTextureFromDDS( d3dDevice, d3dContext, header,
-                                       ddsData + offset, ddsDataSize - offset, maxsize,
-                                       usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
-                                       texture, textureView );
+    HRESULT hr = CreateTextureFromMemory( d3dDevice, d3dContext, ddsData, ddsDataSize, maxsize,
+                                          usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
+                                          texture, textureView, alphaMode );
     if ( SUCCEEDED(hr) )
     {
         if (texture != 0 && *texture != 0)
@@ -1670,9 +1776,6 @@ HRESULT DirectX::CreateDDSTextureFromMemoryEx( ID3D11Device* d3dDevice,
         {
             SetDebugObjectName(*textureView, "DDSTextureLoader");
         }
-
-        if ( alphaMode )
-            *alphaMode = GetAlphaMode( header );
     }
 
     return hr;
@@ -1756,30 +1859,21 @@ HRESULT DirectX::CreateDDSTextureFromFileEx( ID3D11Device* d3dDevice,
         return E_INVALIDARG;
     }
 
-    DDS_HEADER* header = nullptr;
-    uint8_t* bitData = nullptr;
-    size_t bitSize = 0;
-
-    std::unique_ptr<uint8_t[]> ddsData;
-    HRESULT hr = LoadTextureDataFromFile( fileName,
-                                          ddsData,
-                                          &header,
-                                          &bitData,
-                                          &bitSize
-                                        );
+    // The texture is created straight from the mapped view, the view is released on return
+    DDSMappedFile ddsFile;
+    HRESULT hr = ddsFile.Open( fileName );
     if (FAILED(hr))
     {
         return hr;
     }
 
-    hr = CreateTextureFromDDS( d3dDevice, d3dContext, header,
-                               bitData, bitSize, maxsize,
-                               usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
-                               texture, textureView );
+    hr = CreateTextureFromMemory( d3dDevice, d3dContext, ddsFile.GetData(), ddsFile.GetSize(), maxsize,
+                                  usage, bindFlags, cpuAccessFlags, miscFlags, forceSRGB,
+                                  texture, textureView, alphaMode );
 
+#if !defined(NO_D3D11_DEBUG_NAME) && ( defined(_DEBUG) || defined(PROFILE) )
     if ( SUCCEEDED(hr) )
     {
-#if !defined(NO_D3D11_DEBUG_NAME) && ( defined(_DEBUG) || defined(PROFILE) )
         if (texture != 0 || textureView != 0)
         {
             CHAR strFileA[MAX_PATH];
@@ -1821,11 +1915,8 @@ HRESULT DirectX::CreateDDSTextureFromFileEx( ID3D11Device* d3dDevice,
                 }
             }
         }
-#endif
-
-        if ( alphaMode )
-            *alphaMode = GetAlphaMode( header );
     }
+#endif
 
     return hr;
 }
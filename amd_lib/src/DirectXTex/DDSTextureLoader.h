@@ -32,6 +32,7 @@
 #if defined(_MSC_VER) && (_MSC_VER<1610) && !defined(_In_reads_)
 #define _In_reads_(exp)
 #define _Out_writes_(exp)
+#define _Out_writes_opt_(exp)
 #define _In_reads_bytes_(exp)
 #define _In_reads_opt_(exp)
 #define _Outptr_opt_
@@ -52,6 +53,67 @@ namespace DirectX
         DDS_ALPHA_MODE_CUSTOM        = 4,
     };
 
+    // Location of one subresource (mip level of an array slice or cube face) inside a DDS file
+    struct DDS_SUBRESOURCE
+    {
+        size_t      offset;         // from the start of the DDS data, including the magic number
+        size_t      rowPitch;       // bytes per row of pixels or of 4x4 blocks
+        size_t      slicePitch;     // bytes per depth slice
+        size_t      size;           // slicePitch * depth
+        uint32_t    width;
+        uint32_t    height;
+        uint32_t    depth;
+        uint32_t    mipLevel;
+        uint32_t    arraySlice;
+    };
+
+    struct DDS_TEXTURE_INFO
+    {
+        D3D11_RESOURCE_DIMENSION    resourceDimension;
+        DXGI_FORMAT                 format;
+        uint32_t                    width;
+        uint32_t                    height;
+        uint32_t                    depth;
+        uint32_t                    mipLevels;
+        uint32_t                    arraySize;          // six per cube for cube maps
+        bool                        isCubeMap;
+        DDS_ALPHA_MODE              alphaMode;
+        size_t                      dataOffset;         // offset of the first subresource
+        size_t                      subresourceCount;   // mipLevels * arraySize, ordered like D3D11CalcSubresource
+    };
+
+    // Read-only view of a whole file mapped into memory, so DDS data can be parsed and
+    // uploaded without reading it into an intermediate buffer first
+    class DDSMappedFile
+    {
+    public:
+        DDSMappedFile();
+        ~DDSMappedFile();
+
+        HRESULT Open( _In_z_ const wchar_t* szFileName );
+        void Close();
+
+        const uint8_t* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        DDSMappedFile( const DDSMappedFile& );
+        DDSMappedFile& operator=( const DDSMappedFile& );
+
+        const uint8_t*  m_data;
+        size_t          m_size;
+    };
+
+    // Validates a DDS file in memory and describes its layout, no device is required.
+    // Every subresource is bounds checked against ddsDataSize, even when subresources is null.
+    // subresources receives info->subresourceCount entries, pass null to query the count first.
+    HRESULT ParseDDSTexture( _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+                             _In_ size_t ddsDataSize,
+                             _Out_ DDS_TEXTURE_INFO* info,
+                             _Out_writes_opt_(maxSubresources) DDS_SUBRESOURCE* subresources = nullptr,
+                             _In_ size_t maxSubresources = 0
+                           );
+
     // Standard version
     HRESULT CreateDDSTextureFromMemory( _In_ ID3D11Device* d3dDevice,
                                         _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
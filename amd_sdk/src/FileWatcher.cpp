@@ -0,0 +1,578 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: FileWatcher.cpp
+//
+// Class implementation for the FileWatcher interface. The platform specific parts are the
+// change notification, the directory scan and the file reads; Windows uses
+// FindFirstChangeNotification, Linux uses inotify.
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#endif
+
+#include "FileWatcher.h"
+#include "crc.h"
+
+using namespace AMD;
+
+static const unsigned int WAIT_FOREVER = 0xFFFFFFFF;
+
+
+//--------------------------------------------------------------------------------------
+// Thread entry point
+//--------------------------------------------------------------------------------------
+#if defined(_WIN32)
+static DWORD WINAPI _WatchThreadProc( void* pParameter )
+{
+    reinterpret_cast< FileWatcher* >( pParameter )->WatchThreadProc();
+
+    return 0;
+}
+#else
+static void* _WatchThreadProc( void* pParameter )
+{
+    reinterpret_cast< FileWatcher* >( pParameter )->WatchThreadProc();
+
+    return NULL;
+}
+
+static std::string ToNarrow( const std::wstring& i_String )
+{
+    std::vector<char> narrow( i_String.size() * MB_LEN_MAX + 1, '\0' );
+    wcstombs( &narrow[0], i_String.c_str(), narrow.size() - 1 );
+
+    return std::string( &narrow[0] );
+}
+
+static std::wstring ToWide( const char* pString )
+{
+    std::vector<wchar_t> wide( strlen( pString ) + 1, L'\0' );
+    mbstowcs( &wide[0], pString, wide.size() - 1 );
+
+    return std::wstring( &wide[0] );
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------------------------------
+FileWatcher::FileWatcher()
+{
+    m_pCallback = NULL;
+    m_pUserData = NULL;
+    m_uDebounceMilliseconds = m_uDEFAULT_DEBOUNCE_MILLISECONDS;
+    m_bStop = false;
+    m_bRunning = false;
+
+#if defined(_WIN32)
+    m_hNotification = INVALID_HANDLE_VALUE;
+    m_hStopEvent = NULL;
+    m_hThread = NULL;
+#else
+    m_iNotification = -1;
+    m_StopPipe[0] = -1;
+    m_StopPipe[1] = -1;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------
+// Destructor
+//--------------------------------------------------------------------------------------
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Records the current state of the tree and starts watching it. The notification is created
+// before the scan, so changes made while scanning are not missed.
+//--------------------------------------------------------------------------------------
+bool FileWatcher::Start( const wchar_t* pwsDirectory, ChangeCallback pCallback, void* pUserData, unsigned int uDebounceMilliseconds )
+{
+    assert( NULL != pwsDirectory );
+    assert( NULL != pCallback );
+
+    Stop();
+
+    m_Directory = pwsDirectory;
+    m_pCallback = pCallback;
+    m_pUserData = pUserData;
+    m_uDebounceMilliseconds = uDebounceMilliseconds;
+    m_bStop = false;
+
+    crcInit();
+
+    if( !CreateNotification() )
+    {
+        DestroyNotification();
+
+        return false;
+    }
+
+    m_Files.clear();
+    m_PendingChanges.clear();
+    Scan( m_Directory, m_Files );
+
+#if defined(_WIN32)
+    m_hThread = CreateThread( NULL, 0, _WatchThreadProc, this, 0, NULL );
+    if( NULL == m_hThread )
+#else
+    if( 0 != pthread_create( &m_Thread, NULL, _WatchThreadProc, this ) )
+#endif
+    {
+        DestroyNotification();
+
+        return false;
+    }
+
+    m_bRunning = true;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Stops watching, waits for a callback in flight to return
+//--------------------------------------------------------------------------------------
+void FileWatcher::Stop()
+{
+    if( m_bRunning )
+    {
+        m_bStop = true;
+
+#if defined(_WIN32)
+        SetEvent( m_hStopEvent );
+        WaitForSingleObject( m_hThread, INFINITE );
+        CloseHandle( m_hThread );
+        m_hThread = NULL;
+#else
+        const char stop = 0;
+        if( write( m_StopPipe[1], &stop, 1 ) != 1 )
+        {
+            assert( false );
+        }
+        pthread_join( m_Thread, NULL );
+#endif
+
+        m_bRunning = false;
+    }
+
+    DestroyNotification();
+
+    m_Files.clear();
+    m_PendingChanges.clear();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Accessors
+//--------------------------------------------------------------------------------------
+bool FileWatcher::IsRunning() const
+{
+    return m_bRunning;
+}
+
+
+//--------------------------------------------------------------------------------------
+// The watcher's thread. Each notification restarts the debounce period, once it expires the
+// tree is rescanned. Changes the callback refuses are offered again one debounce period later.
+//--------------------------------------------------------------------------------------
+void FileWatcher::WatchThreadProc()
+{
+    bool bDirty = false;
+    unsigned long long uDeadline = 0;
+
+    while( !m_bStop )
+    {
+        unsigned int uTimeout = WAIT_FOREVER;
+        if( bDirty || !m_PendingChanges.empty() )
+        {
+            const unsigned long long uNow = GetMilliseconds();
+            uTimeout = ( uDeadline > uNow ) ? (unsigned int)( uDeadline - uNow ) : 0;
+        }
+
+        if( WaitForNotification( uTimeout ) )
+        {
+            bDirty = true;
+            uDeadline = GetMilliseconds() + m_uDebounceMilliseconds;
+            continue;
+        }
+
+        if( m_bStop )
+        {
+            break;
+        }
+
+        if( GetMilliseconds() < uDeadline )
+        {
+            continue;
+        }
+
+        if( bDirty )
+        {
+            CollectChanges();
+            bDirty = false;
+        }
+
+        if( !m_PendingChanges.empty() )
+        {
+            std::vector<std::wstring> changedFiles( m_PendingChanges.begin(), m_PendingChanges.end() );
+            if( m_pCallback( m_pUserData, changedFiles ) )
+            {
+                m_PendingChanges.clear();
+            }
+            else
+            {
+                uDeadline = GetMilliseconds() + m_uDebounceMilliseconds;
+            }
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Rescans the tree and adds the files whose contents differ from the last scan to the pending
+// changes. Only files with a new timestamp or size are read, a file that was merely touched
+// gets its new timestamp recorded but is not reported.
+//--------------------------------------------------------------------------------------
+void FileWatcher::CollectChanges()
+{
+    FileStateMap files;
+    Scan( m_Directory, files );
+
+    for( FileStateMap::iterator it = files.begin(); it != files.end(); it++ )
+    {
+        FileStateMap::const_iterator previous = m_Files.find( it->first );
+        if( previous == m_Files.end() )
+        {
+            m_PendingChanges.insert( it->first );
+        }
+        else if( ( previous->second.m_uLastWrite != it->second.m_uLastWrite ) || ( previous->second.m_uSize != it->second.m_uSize ) )
+        {
+            if( ( previous->second.m_uSize != it->second.m_uSize ) || ( previous->second.m_uCRC != it->second.m_uCRC ) )
+            {
+                m_PendingChanges.insert( it->first );
+            }
+        }
+    }
+
+    for( FileStateMap::const_iterator it = m_Files.begin(); it != m_Files.end(); it++ )
+    {
+        if( files.find( it->first ) == files.end() )
+        {
+            m_PendingChanges.insert( it->first );
+        }
+    }
+
+    m_Files.swap( files );
+}
+
+
+#if defined(_WIN32)
+
+//--------------------------------------------------------------------------------------
+// Windows: change notifications for the whole tree
+//--------------------------------------------------------------------------------------
+bool FileWatcher::CreateNotification()
+{
+    m_hStopEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+    m_hNotification = FindFirstChangeNotificationW( m_Directory.c_str(), TRUE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE );
+
+    return ( NULL != m_hStopEvent ) && ( INVALID_HANDLE_VALUE != m_hNotification );
+}
+
+void FileWatcher::DestroyNotification()
+{
+    if( INVALID_HANDLE_VALUE != m_hNotification )
+    {
+        FindCloseChangeNotification( m_hNotification );
+        m_hNotification = INVALID_HANDLE_VALUE;
+    }
+
+    if( NULL != m_hStopEvent )
+    {
+        CloseHandle( m_hStopEvent );
+        m_hStopEvent = NULL;
+    }
+}
+
+bool FileWatcher::WaitForNotification( unsigned int uTimeoutMilliseconds )
+{
+    HANDLE handles[2] = { m_hStopEvent, m_hNotification };
+    DWORD dwRet = WaitForMultipleObjects( 2, handles, FALSE, ( WAIT_FOREVER == uTimeoutMilliseconds ) ? INFINITE : uTimeoutMilliseconds );
+
+    if( dwRet == WAIT_OBJECT_0 + 1 )
+    {
+        FindNextChangeNotification( m_hNotification );
+
+        return true;
+    }
+
+    return false;
+}
+
+void FileWatcher::Scan( const std::wstring& i_Directory, FileStateMap& io_Files )
+{
+    WIN32_FIND_DATAW findData;
+    HANDLE hFind = FindFirstFileW( ( i_Directory + L"\\*" ).c_str(), &findData );
+    if( INVALID_HANDLE_VALUE == hFind )
+    {
+        return;
+    }
+
+    do
+    {
+        if( ( 0 == wcscmp( findData.cFileName, L"." ) ) || ( 0 == wcscmp( findData.cFileName, L".." ) ) )
+        {
+            continue;
+        }
+
+        const std::wstring pathName = i_Directory + L"\\" + findData.cFileName;
+        if( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY )
+        {
+            Scan( pathName, io_Files );
+            continue;
+        }
+
+        FileState state;
+        state.m_uLastWrite = ( (unsigned long long)findData.ftLastWriteTime.dwHighDateTime << 32 ) | findData.ftLastWriteTime.dwLowDateTime;
+        state.m_uSize = ( (unsigned long long)findData.nFileSizeHigh << 32 ) | findData.nFileSizeLow;
+        state.m_uCRC = 0;
+
+        // Keep the checksum of files that did not change, they are not read again
+        FileStateMap::const_iterator previous = m_Files.find( pathName );
+        if( ( previous != m_Files.end() ) && ( previous->second.m_uLastWrite == state.m_uLastWrite ) && ( previous->second.m_uSize == state.m_uSize ) )
+        {
+            state.m_uCRC = previous->second.m_uCRC;
+        }
+        else
+        {
+            ReadCRC( pathName, state.m_uCRC );
+        }
+
+        io_Files[pathName] = state;
+    }
+    while( FindNextFileW( hFind, &findData ) );
+
+    FindClose( hFind );
+}
+
+bool FileWatcher::ReadCRC( const std::wstring& i_PathName, unsigned int& o_uCRC ) const
+{
+    FILE* pFile = NULL;
+    _wfopen_s( &pFile, i_PathName.c_str(), L"rb" );
+
+    if( NULL == pFile )
+    {
+        return false;
+    }
+
+    fseek( pFile, 0, SEEK_END );
+    int iFileSize = ftell( pFile );
+    rewind( pFile );
+
+    std::vector<unsigned char> contents( iFileSize + 1 );
+    const size_t uRead = fread( &contents[0], 1, iFileSize, pFile );
+    fclose( pFile );
+
+    o_uCRC = (unsigned int)crcFast( &contents[0], (int)uRead );
+
+    return true;
+}
+
+unsigned long long FileWatcher::GetMilliseconds()
+{
+    return GetTickCount64();
+}
+
+#else
+
+//--------------------------------------------------------------------------------------
+// Linux: inotify, one watch per directory (inotify is not recursive), plus a pipe to wake
+// the thread up when stopping
+//--------------------------------------------------------------------------------------
+bool FileWatcher::CreateNotification()
+{
+    m_iNotification = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+
+    return ( m_iNotification >= 0 ) && ( 0 == pipe( m_StopPipe ) );
+}
+
+void FileWatcher::DestroyNotification()
+{
+    if( m_iNotification >= 0 )
+    {
+        close( m_iNotification );
+        m_iNotification = -1;
+    }
+
+    for( int i = 0; i < 2; i++ )
+    {
+        if( m_StopPipe[i] >= 0 )
+        {
+            close( m_StopPipe[i] );
+            m_StopPipe[i] = -1;
+        }
+    }
+}
+
+bool FileWatcher::WaitForNotification( unsigned int uTimeoutMilliseconds )
+{
+    struct pollfd fds[2];
+    fds[0].fd = m_StopPipe[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = m_iNotification;
+    fds[1].events = POLLIN;
+
+    if( poll( fds, 2, ( WAIT_FOREVER == uTimeoutMilliseconds ) ? -1 : (int)uTimeoutMilliseconds ) <= 0 )
+    {
+        return false;
+    }
+
+    if( fds[0].revents )
+    {
+        return false;
+    }
+
+    // Only the fact that something changed matters, the scan finds out what
+    char buffer[4096];
+    bool bChanged = false;
+    while( read( m_iNotification, buffer, sizeof( buffer ) ) > 0 )
+    {
+        bChanged = true;
+    }
+
+    return bChanged;
+}
+
+void FileWatcher::Scan( const std::wstring& i_Directory, FileStateMap& io_Files )
+{
+    const std::string directory = ToNarrow( i_Directory );
+
+    inotify_add_watch( m_iNotification, directory.c_str(), IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB );
+
+    DIR* pDir = opendir( directory.c_str() );
+    if( NULL == pDir )
+    {
+        return;
+    }
+
+    struct dirent* pEntry;
+    while( NULL != ( pEntry = readdir( pDir ) ) )
+    {
+        if( ( 0 == strcmp( pEntry->d_name, "." ) ) || ( 0 == strcmp( pEntry->d_name, ".." ) ) )
+        {
+            continue;
+        }
+
+        const std::wstring pathName = i_Directory + L"/" + ToWide( pEntry->d_name );
+
+        struct stat status;
+        if( 0 != stat( ( directory + "/" + pEntry->d_name ).c_str(), &status ) )
+        {
+            continue;
+        }
+
+        if( S_ISDIR( status.st_mode ) )
+        {
+            Scan( pathName, io_Files );
+            continue;
+        }
+
+        FileState state;
+        state.m_uLastWrite = (unsigned long long)status.st_mtim.tv_sec * 1000000000ull + status.st_mtim.tv_nsec;
+        state.m_uSize = (unsigned long long)status.st_size;
+        state.m_uCRC = 0;
+
+        // Keep the checksum of files that did not change, they are not read again
+        FileStateMap::const_iterator previous = m_Files.find( pathName );
+        if( ( previous != m_Files.end() ) && ( previous->second.m_uLastWrite == state.m_uLastWrite ) && ( previous->second.m_uSize == state.m_uSize ) )
+        {
+            state.m_uCRC = previous->second.m_uCRC;
+        }
+        else
+        {
+            ReadCRC( pathName, state.m_uCRC );
+        }
+
+        io_Files[pathName] = state;
+    }
+
+    closedir( pDir );
+}
+
+bool FileWatcher::ReadCRC( const std::wstring& i_PathName, unsigned int& o_uCRC ) const
+{
+    FILE* pFile = fopen( ToNarrow( i_PathName ).c_str(), "rb" );
+
+    if( NULL == pFile )
+    {
+        return false;
+    }
+
+    fseek( pFile, 0, SEEK_END );
+    int iFileSize = ftell( pFile );
+    rewind( pFile );
+
+    std::vector<unsigned char> contents( iFileSize + 1 );
+    const size_t uRead = fread( &contents[0], 1, iFileSize, pFile );
+    fclose( pFile );
+
+    o_uCRC = (unsigned int)crcFast( &contents[0], (int)uRead );
+
+    return true;
+}
+
+unsigned long long FileWatcher::GetMilliseconds()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return (unsigned long long)now.tv_sec * 1000ull + now.tv_nsec / 1000000;
+}
+
+#endif
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
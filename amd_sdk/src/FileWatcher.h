@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: FileWatcher.h
+//
+// Class definition for the FileWatcher interface. Watches a directory tree and reports the
+// files whose contents changed, once per burst of changes.
+//
+// The operating system only tells us that something in the tree changed (change notifications
+// on Windows, inotify on Linux). The watcher waits until the tree has been quiet for the debounce
+// period, then rescans it and compares each file's timestamp, size and checksum with the last
+// scan, so an editor writing a file several times, or touching it without changing it, results
+// in at most one report. When the callback cannot handle the changes yet, they are kept and
+// offered again after another debounce period, together with anything that changed meanwhile.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+namespace AMD
+{
+
+    class FileWatcher
+    {
+    public:
+
+        // Called on the watcher's thread with the changed (added, modified or deleted) files,
+        // returns false if the changes cannot be handled yet
+        typedef bool (*ChangeCallback)( void* pUserData, const std::vector<std::wstring>& i_ChangedFiles );
+
+        static const unsigned int m_uDEFAULT_DEBOUNCE_MILLISECONDS = 200;
+
+        // Construction / destruction
+        FileWatcher();
+        ~FileWatcher();
+
+        // Records the current state of the tree, then watches it on a thread of its own
+        bool Start( const wchar_t* pwsDirectory, ChangeCallback pCallback, void* pUserData, unsigned int uDebounceMilliseconds = m_uDEFAULT_DEBOUNCE_MILLISECONDS );
+        void Stop();
+        bool IsRunning() const;
+
+        // Do not call this function
+        void WatchThreadProc();
+
+    private:
+
+        struct FileState
+        {
+            unsigned long long  m_uLastWrite;
+            unsigned long long  m_uSize;
+            unsigned int        m_uCRC;
+        };
+
+        typedef std::map<std::wstring, FileState> FileStateMap;
+
+        // Platform specific methods
+        bool CreateNotification();
+        void DestroyNotification();
+        bool WaitForNotification( unsigned int uTimeoutMilliseconds );
+        void Scan( const std::wstring& i_Directory, FileStateMap& io_Files );
+        bool ReadCRC( const std::wstring& i_PathName, unsigned int& o_uCRC ) const;
+        static unsigned long long GetMilliseconds();
+
+        void CollectChanges();
+
+        // Private data
+        std::wstring            m_Directory;
+        FileStateMap            m_Files;
+        std::set<std::wstring>  m_PendingChanges;
+        ChangeCallback          m_pCallback;
+        void*                   m_pUserData;
+        unsigned int            m_uDebounceMilliseconds;
+        volatile bool           m_bStop;
+        bool                    m_bRunning;
+#if defined(_WIN32)
+        HANDLE                  m_hNotification;
+        HANDLE                  m_hStopEvent;
+        HANDLE                  m_hThread;
+#else
+        int                     m_iNotification;
+        int                     m_StopPipe[2];
+        pthread_t               m_Thread;
+#endif
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -34,12 +34,23 @@
 //--------------------------------------------------------------------------------------
 
 
+#if defined(_WIN32)
 #include "..\\..\\DXUT\\Core\\DXUT.h"
 #include "..\\..\\DXUT\\Optional\\SDKmisc.h"
+#else
+#include <windows.h>
+#include <cassert>
+#include <string>
+#include "DXUT.h"
+#include "SDKmisc.h"
+#endif
 #include "ShaderCache.h"
-#include "Process.h"
+#include "crc.h"
 
+#if defined(_WIN32)
+#include "Process.h"
 #include <Shlwapi.h>
+#endif
 #include <algorithm>
 
 #pragma warning( disable : 4100 ) // disable unreference formal parameter warnings for /W4 builds
@@ -57,6 +68,11 @@ static const wchar_t *FXC_PATH_STRING_INSTALLED_WIN_10_SDK  = L"\\Windows Kits\\
 static const wchar_t *FXC_PATH_STRING_INSTALLED_WIN_8_1_SDK = L"\\Windows Kits\\8.1\\bin\\x64\\fxc.exe";
 static const wchar_t *FXC_PATH_STRING_INSTALLED_WIN_8_0_SDK = L"\\Windows Kits\\8.0\\bin\\x64\\fxc.exe";
 static const wchar_t *DEV_PATH_STRING_INSTALLED             = L"\\Dev.exe";
+#ifdef _DEBUG
+static const wchar_t *DATABASE_FILE_STRING                  = L"Shaders\\Cache\\Object\\Debug\\Objects.db";
+#else
+static const wchar_t *DATABASE_FILE_STRING                  = L"Shaders\\Cache\\Object\\Release\\Objects.db";
+#endif
 
 //--------------------------------------------------------------------------------------
 // Constructor
@@ -80,56 +96,24 @@ ShaderCache::Shader::Shader()
     m_ISA_ALUPacking = m_previous_ISA_ALUPacking = 0.0;
 #endif
 
-    memset( m_wsTarget, '\0', sizeof( wchar_t[m_uTARGET_MAX_LENGTH] ) );
-    memset( m_wsEntryPoint, '\0', sizeof( wchar_t[m_uENTRY_POINT_MAX_LENGTH] ) );
-    memset( m_wsSourceFile, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsCanonicalName, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
+    m_wsTarget = L"";
+    m_wsEntryPoint = L"";
+    m_wsSourceFile = L"";
+    m_wsCanonicalName = L"";
 
     m_uNumMacros = 0;
     m_pMacros = NULL;
 
-    memset( m_wsRawFileName, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsHashedFileName, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsObjectFile, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsErrorFile, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsAssemblyFile, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsAssemblyFileWithHashedFilename, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsISAFile, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsPreprocessFile, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsHashFile, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsCommandLine, '\0', sizeof( wchar_t[m_uCOMMAND_LINE_MAX_LENGTH] ) );
-    memset( m_wsISACommandLine, '\0', sizeof( wchar_t[m_uCOMMAND_LINE_MAX_LENGTH] ) );
-    memset( m_wsPreprocessCommandLine, '\0', sizeof( wchar_t[m_uCOMMAND_LINE_MAX_LENGTH] ) );
-
-    memset( m_wsObjectFile_with_ISA, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-    memset( m_wsPreprocessFile_with_ISA, '\0', sizeof( wchar_t[m_uFILENAME_MAX_LENGTH] ) );
-
-    // Test that we can use paths > 255 characters with unicode file handling via \\?\ syntax
-    // Each section of the path needs to be <= 260 characters.
-    // Must first create path:
-    // C:\xpSnm8ixu8zR3lqGRtIbXMNOVE15oRgP7SwhsqRgkG7atxEOZbgsJmWXDLA7pCSUuQsqko9YN03e7aUw26Aoy9UpS3mSH1uekbTquhozgbB5KQwFxKzaBkSLpVmIWX8gQpoDd9mCTFLtbO0BCGdF7lF48KpxPFTjmNVgJK4sMfi5mavXhc
-
-    FILE* pFile = NULL;
-    wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH + 1] = { L"\\\\?\\C:\\xpSnm8ixu8zR3lqGRtIbXMNOVE15oRgP7SwhsqRgkG7atxEOZbgs"
-        L"JmWXDLA7pCSUuQsqko9YN03e7aUw26Aoy9UpS3mSH1uekbTquhozgbB5KQwFxKz"
-        L"aBkSLpVmIWX8gQpoDd9mCTFLtbO0BCGdF7lF48KpxPFTjmNVgJK4sMfi5mavXhc"
-        L"\\rqgJRzfIBHlFGEcQrb3JUPcFGEt2S0ZnhetHvO2WNerlSOvqDVbBIey9bO7k0"
-        L"tytUih5E8ijWnbPHxF65X0jCuwikbtjkOXgoMBvoNGDlpfcrS0PVS7Ww5SJ3Ivg"
-        L"KdMj5VyN7qmfWkddiLoTvOybtkSchYW99uyQEgIkiPjM0mFmlCGIsTPFRDC.txt"
-        L"\0" };
-
-    _wfopen_s( &pFile, wsShaderPathName, L"wb" );
-
-    if( pFile )
-    {
-        fwrite( "Hello, World!\0", 14, 1, pFile );
-        fclose( pFile );
-    }
-
-    //DebugBreak();
+    m_wsRawFileName = L"";
+    m_wsHashedFileName = L"";
 
+#if AMD_SDK_INTERNAL_BUILD
+    m_iMaxVGPRLimit = -1;
+    m_iMaxSGPRLimit = -1;
+#endif
 
-    m_bBeingProcessed = false;
+    m_eState = SHADER_STATE_IDLE;
+    m_bPreprocessedInProcess = false;
     m_hCompileProcessHandle = NULL;
     m_hCompileThreadHandle = NULL;
     m_iCompileWaitCount = -1;
@@ -140,6 +124,14 @@ ShaderCache::Shader::Shader()
     m_pFilenameHash = NULL;
     m_uFilenameHashLength = 0;
 
+    m_wsCompilationFlags = L"";
+    m_pContentHash = NULL;
+    m_uContentHashLength = 0;
+
+    m_Telemetry.m_wsName = m_wsRawFileName;
+    m_Telemetry.m_wsSourceFile = m_wsSourceFile;
+    m_Telemetry.Reset();
+
 }
 
 
@@ -166,6 +158,12 @@ ShaderCache::Shader::~Shader()
         m_pFilenameHash = NULL;
     }
 
+    if( NULL != m_pContentHash )
+    {
+        free( m_pContentHash );
+        m_pContentHash = NULL;
+    }
+
     for( int iElement = 0; iElement < (int)m_uNumDescElements; iElement++ )
     {
         delete[] m_pInputLayoutDesc[iElement].SemanticName;
@@ -180,14 +178,9 @@ ShaderCache::Shader::~Shader()
 ShaderCache::ShaderCache( const SHADER_AUTO_RECOMPILE_TYPE i_keAutoRecompileTouchedShadersType, const ERROR_DISPLAY_TYPE i_keErrorDisplayType,
                          const GENERATE_ISA_TYPE i_keGenerateShaderISAType, const SHADER_COMPILER_EXE_TYPE i_keShaderCompilerExeType )
 {
-    m_ShaderSourceList.clear();
-    m_ShaderList.clear();
-    m_PreprocessList.clear();
-    m_HashList.clear();
-    m_CompileList.clear();
-    m_CompileCheckList.clear();
-    m_CreateList.clear();
-    m_ErrorList.clear();
+    m_ShaderSources.clear();
+    m_Shaders.clear();
+    memset( m_uNumShadersInState, 0, sizeof( m_uNumShadersInState ) );
 
 #if AMD_SDK_INTERNAL_BUILD
     m_ISATargetList.clear();
@@ -325,6 +318,11 @@ ShaderCache::ShaderCache( const SHADER_AUTO_RECOMPILE_TYPE i_keAutoRecompileTouc
         assert( false );
     }
 
+    // Compiled objects live in one packed file, loose object files are only used until they are stored in it
+    wchar_t wsDatabasePathName[m_uPATHNAME_MAX_LENGTH];
+    CreateFullPathFromOutputFilename( wsDatabasePathName, DATABASE_FILE_STRING );
+    m_Database.Open( wsDatabasePathName );
+
     SYSTEM_INFO sysinfo;
     GetSystemInfo( &sysinfo );
     m_uNumCPUCores = sysinfo.dwNumberOfProcessors;
@@ -349,9 +347,6 @@ ShaderCache::ShaderCache( const SHADER_AUTO_RECOMPILE_TYPE i_keAutoRecompileTouc
 
     m_bForceDebugShaders = false;
 
-    m_watchHandle = NULL;
-    m_waitPoolHandle = NULL;
-
 #if AMD_SDK_INTERNAL_BUILD
     m_eTargetISA = DEFAULT_ISA_TARGET;
 #endif
@@ -368,7 +363,7 @@ ShaderCache::ShaderCache( const SHADER_AUTO_RECOMPILE_TYPE i_keAutoRecompileTouc
     m_bShowShaderErrors = (i_keErrorDisplayType == ERROR_DISPLAY_ON_SCREEN);
 #if AMD_SDK_INTERNAL_BUILD
 #if AMD_SDK_PREBUILT_RELEASE_EXE
-#error The pre-built release exe is for the public (i.e. it's external)
+#error The pre-built release exe is for the public (i.e. it is external)
 #endif
     m_bGenerateShaderISA = (i_keGenerateShaderISAType == GENERATE_ISA_ENABLED);
 #else
@@ -438,6 +433,16 @@ ShaderCache::ShaderCache( const SHADER_AUTO_RECOMPILE_TYPE i_keAutoRecompileTouc
 
     m_bShowShaderISA = m_bGenerateShaderISA;
 
+    // Share compiled objects through the directory in the environment, if there is one
+    memset( m_wsCompilerIdentity, '\0', sizeof( wchar_t[m_uPATHNAME_MAX_LENGTH] ) );
+    size_t requiredSizeForSharedCacheEnvVar;
+    wchar_t wsSharedCacheDir[MAX_PATH] = {L'\0'};
+    _wgetenv_s(&requiredSizeForSharedCacheEnvVar, wsSharedCacheDir, MAX_PATH, L"AMD_SDK_SHARED_SHADER_CACHE_DIR");
+    if( L'\0' != wsSharedCacheDir[0] )
+    {
+        SetSharedCacheDirectory( wsSharedCacheDir );
+    }
+
     if( m_bRecompileTouchedShaders )
     {
 #if defined(DEBUG) || defined(_DEBUG)
@@ -456,16 +461,19 @@ ShaderCache::ShaderCache( const SHADER_AUTO_RECOMPILE_TYPE i_keAutoRecompileTouc
 //--------------------------------------------------------------------------------------
 ShaderCache::~ShaderCache()
 {
+    // No recompiles may start while tearing down
+    m_ShaderSourceWatcher.Stop();
+
     WaitForSingleObject( s_hDoneEvent, INFINITE );
     CloseHandle( s_hDoneEvent );
 
-    for( std::list<Shader*>::iterator it = m_ShaderSourceList.begin(); it != m_ShaderSourceList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_ShaderSources.begin(); it != m_ShaderSources.end(); it++)
     {
         Shader* pShader = *it;
         delete pShader;
     }
 
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
         delete pShader;
@@ -480,14 +488,9 @@ ShaderCache::~ShaderCache()
     }
 #endif
 
-    m_ShaderSourceList.clear();
-    m_ShaderList.clear();
-    m_PreprocessList.clear();
-    m_HashList.clear();
-    m_CompileList.clear();
-    m_CompileCheckList.clear();
-    m_CreateList.clear();
-    m_ErrorList.clear();
+    m_ShaderSources.clear();
+    m_Shaders.clear();
+    m_Strings.Clear();
 
 #if AMD_SDK_INTERNAL_BUILD
     m_ISATargetList.clear();
@@ -499,18 +502,6 @@ ShaderCache::~ShaderCache()
         m_pProgressInfo = NULL;
     }
 
-    if( m_waitPoolHandle )
-    {
-        UnregisterWaitEx( m_waitPoolHandle, INVALID_HANDLE_VALUE );
-        m_waitPoolHandle = NULL;
-    }
-
-    if( m_watchHandle )
-    {
-        FindCloseChangeNotification( m_watchHandle );
-        m_watchHandle = NULL;
-    }
-
     DeleteCriticalSection( &m_GenISA_CriticalSection );
     DeleteCriticalSection( &m_CompileShaders_CriticalSection );
 
@@ -544,7 +535,7 @@ bool ShaderCache::CloneShaders( void )
     bool bRVal = true;
 
 #if AMD_SDK_INTERNAL_BUILD
-    for( std::list<Shader*>::iterator it = m_ShaderSourceList.begin(); it != m_ShaderSourceList.end(); it++ )
+    for( std::vector<Shader*>::iterator it = m_ShaderSources.begin(); it != m_ShaderSources.end(); it++ )
     {
         Shader* pShaderSource = *it;
 
@@ -611,6 +602,154 @@ void ShaderCache::InsertInputFilenameIntoCommandLine( wchar_t *pwsCommandLine, c
     }
 }
 
+//--------------------------------------------------------------------------------------
+// Moves a shader to another state of the generation process
+//--------------------------------------------------------------------------------------
+void ShaderCache::SetShaderState( Shader* pShader, SHADER_STATE State )
+{
+    assert( m_uNumShadersInState[pShader->m_eState] > 0 );
+
+    m_uNumShadersInState[pShader->m_eState]--;
+    m_uNumShadersInState[State]++;
+    pShader->m_eState = State;
+}
+
+//--------------------------------------------------------------------------------------
+// Creates the name of one of the shader's files, relative to the working dir
+//--------------------------------------------------------------------------------------
+void ShaderCache::GetShaderFileName( const Shader* pShader, SHADER_FILE_TYPE FileType, wchar_t (&pwsFileName)[m_uFILENAME_MAX_LENGTH] ) const
+{
+    switch( FileType )
+    {
+    case SHADER_FILE_OBJECT:
+#ifdef _DEBUG
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\Object\\Debug\\%s.obj", pShader->m_wsRawFileName );
+#else
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\Object\\Release\\%s.obj", pShader->m_wsRawFileName );
+#endif
+        break;
+    case SHADER_FILE_ERROR:
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\Error\\%s.txt", pShader->m_wsRawFileName );
+        break;
+    case SHADER_FILE_ASSEMBLY:
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\Assembly\\%s.asm", pShader->m_wsHashedFileName );
+        break;
+    case SHADER_FILE_ISA:
+#if AMD_SDK_INTERNAL_BUILD
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\ISA\\%s.asm.%s.dump.isa", pShader->m_wsHashedFileName, AmdTargetInfo[ pShader->m_eISATarget ].m_Name );
+#else
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\ISA\\" );
+#endif
+        break;
+    case SHADER_FILE_PREPROCESS:
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\Preprocess\\%s.ppf", pShader->m_wsRawFileName );
+        break;
+    case SHADER_FILE_HASH:
+#ifdef _DEBUG
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\Hash\\Debug\\%s.hsh", pShader->m_wsRawFileName );
+#else
+        swprintf_s( pwsFileName, L"Shaders\\Cache\\Hash\\Release\\%s.hsh", pShader->m_wsRawFileName );
+#endif
+        break;
+    default:
+        assert( false );
+        pwsFileName[0] = L'\0';
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------
+// Creates the fxc command line that compiles the shader
+//--------------------------------------------------------------------------------------
+void ShaderCache::CreateCompileCommandLine( const Shader* pShader, wchar_t (&pwsCommandLine)[m_uCOMMAND_LINE_MAX_LENGTH] ) const
+{
+    wchar_t wsFileName[m_uFILENAME_MAX_LENGTH];
+
+    pwsCommandLine[0] = L'\0';
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /T " );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_wsTarget );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_wsCompilationFlags );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /E " );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_wsEntryPoint );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /Fo " );
+    GetShaderFileName( pShader, SHADER_FILE_OBJECT, wsFileName );
+    InsertOutputFilenameIntoCommandLine( pwsCommandLine, wsFileName );
+    for( int iMacro = 0; iMacro < (int)pShader->m_uNumMacros; ++iMacro )
+    {
+        wchar_t wsValue[64];
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /D " );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_pMacros[iMacro].m_wsName );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L"=" );
+        _itow_s( pShader->m_pMacros[iMacro].m_iValue, wsValue, 10 );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
+    }
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /Fe " );
+    GetShaderFileName( pShader, SHADER_FILE_ERROR, wsFileName );
+    InsertOutputFilenameIntoCommandLine( pwsCommandLine, wsFileName );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /Fc " ); // Fx for HEX
+    GetShaderFileName( pShader, SHADER_FILE_ASSEMBLY, wsFileName );
+    InsertOutputFilenameIntoCommandLine( pwsCommandLine, wsFileName );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
+    InsertInputFilenameIntoCommandLine( pwsCommandLine, pShader->m_wsSourceFile );
+}
+
+//--------------------------------------------------------------------------------------
+// Creates the fxc /P command line that preprocesses the shader
+//--------------------------------------------------------------------------------------
+void ShaderCache::CreatePreprocessCommandLine( const Shader* pShader, wchar_t (&pwsCommandLine)[m_uCOMMAND_LINE_MAX_LENGTH] ) const
+{
+    wchar_t wsFileName[m_uFILENAME_MAX_LENGTH];
+
+    pwsCommandLine[0] = L'\0';
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /E " );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_wsEntryPoint );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
+    InsertInputFilenameIntoCommandLine( pwsCommandLine, pShader->m_wsSourceFile );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /P " );
+    GetShaderFileName( pShader, SHADER_FILE_PREPROCESS, wsFileName );
+    InsertOutputFilenameIntoCommandLine( pwsCommandLine, wsFileName );
+    for( int iMacro = 0; iMacro < (int)pShader->m_uNumMacros; ++iMacro )
+    {
+        wchar_t wsValue[64];
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /D " );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_pMacros[iMacro].m_wsName );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L"=" );
+        _itow_s( pShader->m_pMacros[iMacro].m_iValue, wsValue, 10 );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
+    }
+}
+
+#if AMD_SDK_INTERNAL_BUILD
+//--------------------------------------------------------------------------------------
+// Creates the SCDev command line options that generate the shader's ISA
+//--------------------------------------------------------------------------------------
+void ShaderCache::CreateISACommandLine( const Shader* pShader, wchar_t (&pwsCommandLine)[m_uCOMMAND_LINE_MAX_LENGTH] ) const
+{
+    pwsCommandLine[0] = L'\0';
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -q " );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -ns " );
+
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -" );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, AmdTargetInfo[ pShader->m_eISATarget ].m_Name );
+    wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
+
+    if( pShader->m_iMaxVGPRLimit > 0 )
+    {
+        wchar_t wsValue[64];
+        _itow_s( pShader->m_iMaxVGPRLimit, wsValue, 10 );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -vgprs " );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
+    }
+    if( pShader->m_iMaxSGPRLimit > 0 )
+    {
+        wchar_t wsValue[64];
+        _itow_s( pShader->m_iMaxSGPRLimit, wsValue, 10 );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -sgprs " );
+        wcscat_s( pwsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
+    }
+}
+#endif
+
 //--------------------------------------------------------------------------------------
 // User adds a shader to the cache
 //--------------------------------------------------------------------------------------
@@ -648,15 +787,15 @@ bool ShaderCache::AddShader(    ID3D11DeviceChild** ppShader,
     {
         Shader* pShaderSource = new Shader();
         pShaderSource->m_eShaderType = ShaderType;
-        wcscpy_s( pShaderSource->m_wsTarget, m_uTARGET_MAX_LENGTH, pwsTarget );
-        wcscpy_s( pShaderSource->m_wsEntryPoint, m_uENTRY_POINT_MAX_LENGTH, pwsEntryPoint );
-        wcscpy_s( pShaderSource->m_wsSourceFile, m_uFILENAME_MAX_LENGTH, pwsSourceFile );
+        pShaderSource->m_wsTarget = m_Strings.Intern( pwsTarget );
+        pShaderSource->m_wsEntryPoint = m_Strings.Intern( pwsEntryPoint );
+        pShaderSource->m_wsSourceFile = m_Strings.Intern( pwsSourceFile );
         pShaderSource->m_uNumMacros = uNumMacros;
         pShaderSource->m_uNumDescElements = uNumDescElements;
         pShaderSource->m_ppInputLayout = ppInputLayout;
         if( NULL != pwsCanonicalName )
         {
-            wcscpy_s( pShaderSource->m_wsCanonicalName, m_uFILENAME_MAX_LENGTH, pwsCanonicalName );
+            pShaderSource->m_wsCanonicalName = m_Strings.Intern( pwsCanonicalName );
         }
 #if AMD_SDK_INTERNAL_BUILD
         pShaderSource->m_ISA_VGPRs = i_iMaxVGPR;
@@ -688,7 +827,7 @@ bool ShaderCache::AddShader(    ID3D11DeviceChild** ppShader,
             }
         }
 
-        m_ShaderSourceList.push_back( pShaderSource );
+        m_ShaderSources.push_back( pShaderSource );
 #if AMD_SDK_INTERNAL_BUILD
         m_ISATargetList[m_eTargetISA]->push_back( pShaderSource );
 #endif
@@ -728,12 +867,12 @@ bool ShaderCache::AddShader(    ID3D11DeviceChild** ppShader,
         }
     }
 
-    wcscpy_s( pShader->m_wsTarget, m_uTARGET_MAX_LENGTH, pwsTarget );
-    wcscpy_s( pShader->m_wsEntryPoint, m_uENTRY_POINT_MAX_LENGTH, pwsEntryPoint );
-    wcscpy_s( pShader->m_wsSourceFile, m_uFILENAME_MAX_LENGTH, pwsSourceFile );
+    pShader->m_wsTarget = m_Strings.Intern( pwsTarget );
+    pShader->m_wsEntryPoint = m_Strings.Intern( pwsEntryPoint );
+    pShader->m_wsSourceFile = m_Strings.Intern( pwsSourceFile );
     if( NULL != pwsCanonicalName )
     {
-        wcscpy_s( pShader->m_wsCanonicalName, m_uFILENAME_MAX_LENGTH, pwsCanonicalName );
+        pShader->m_wsCanonicalName = m_Strings.Intern( pwsCanonicalName );
     }
 
     pShader->m_uNumMacros = uNumMacros;
@@ -743,21 +882,9 @@ bool ShaderCache::AddShader(    ID3D11DeviceChild** ppShader,
         memcpy( pShader->m_pMacros, pMacros, sizeof( Macro ) * pShader->m_uNumMacros );
     }
 
-    // Object, error, assembly, preprocess, and hash file names
+    // Raw file name, the object, error, assembly, preprocess, and hash file names are derived from it
     wchar_t wsFileNameBody[m_uFILENAME_MAX_LENGTH] = {0};
-#ifdef _DEBUG
-    wcscat_s( pShader->m_wsObjectFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Object\\Debug\\" );
-    wcscat_s( pShader->m_wsHashFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Hash\\Debug\\" );
-#else
-    wcscat_s( pShader->m_wsObjectFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Object\\Release\\" );
-    wcscat_s( pShader->m_wsHashFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Hash\\Release\\" );
-#endif
-    wcscat_s( pShader->m_wsErrorFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Error\\" );
-    wcscat_s( pShader->m_wsAssemblyFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Assembly\\" );
-    wcscat_s( pShader->m_wsISAFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\ISA\\" );
-    wcscat_s( pShader->m_wsPreprocessFile, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Preprocess\\" );
-
-    if( NULL != pwsCanonicalName )
+    if( L'\0' != pShader->m_wsCanonicalName[0] )
     {
         wcscat_s( wsFileNameBody, m_uFILENAME_MAX_LENGTH, pShader->m_wsCanonicalName );
     }
@@ -775,43 +902,15 @@ bool ShaderCache::AddShader(    ID3D11DeviceChild** ppShader,
         }
     }
 
-    wcscat_s( pShader->m_wsRawFileName, m_uFILENAME_MAX_LENGTH, wsFileNameBody );
-    wcscat_s( pShader->m_wsObjectFile, m_uFILENAME_MAX_LENGTH, wsFileNameBody );
-    wcscat_s( pShader->m_wsErrorFile, m_uFILENAME_MAX_LENGTH, wsFileNameBody );
-    wcscat_s( pShader->m_wsAssemblyFile, m_uFILENAME_MAX_LENGTH, wsFileNameBody );
-    wcscat_s( pShader->m_wsPreprocessFile, m_uFILENAME_MAX_LENGTH, wsFileNameBody );
-    wcscat_s( pShader->m_wsHashFile, m_uFILENAME_MAX_LENGTH, wsFileNameBody );
-
-    wcscat_s( pShader->m_wsObjectFile, m_uFILENAME_MAX_LENGTH, L".obj" );
-    wcscat_s( pShader->m_wsErrorFile, m_uFILENAME_MAX_LENGTH, L".txt" );
-    wcscat_s( pShader->m_wsAssemblyFile, m_uFILENAME_MAX_LENGTH, L".asm" );
-    wcscat_s( pShader->m_wsPreprocessFile, m_uFILENAME_MAX_LENGTH, L".ppf" );
-    wcscat_s( pShader->m_wsHashFile, m_uFILENAME_MAX_LENGTH, L".hsh" );
-
-    pShader->SetupHashedFilename();
+    pShader->m_wsRawFileName = m_Strings.Intern( wsFileNameBody );
+    pShader->m_Telemetry.m_wsName = pShader->m_wsRawFileName;
+    pShader->m_Telemetry.m_wsSourceFile = pShader->m_wsSourceFile;
 
-    // Setup Hashed Assembly Filename
-    wcscat_s( pShader->m_wsAssemblyFileWithHashedFilename, m_uFILENAME_MAX_LENGTH, L"Shaders\\Cache\\Assembly\\" );
-    wcscat_s( pShader->m_wsAssemblyFileWithHashedFilename, m_uFILENAME_MAX_LENGTH, pShader->m_wsHashedFileName );
-    wcscat_s( pShader->m_wsAssemblyFileWithHashedFilename, m_uFILENAME_MAX_LENGTH, L".asm" );
+    SetupHashedFilename( pShader );
 
 #if AMD_SDK_INTERNAL_BUILD
-    // ISA File now also uses hashed filename
-    wcscat_s( pShader->m_wsISAFile, m_uFILENAME_MAX_LENGTH, pShader->m_wsHashedFileName );
-    wcscat_s( pShader->m_wsISAFile, m_uFILENAME_MAX_LENGTH, L".asm." );
-    wcscat_s( pShader->m_wsISAFile, m_uFILENAME_MAX_LENGTH, AmdTargetInfo[ pShader->m_eISATarget ].m_Name );
-    wcscat_s( pShader->m_wsISAFile, m_uFILENAME_MAX_LENGTH, L".dump.isa" );
-
-    wcscat_s( pShader->m_wsObjectFile_with_ISA, m_uFILENAME_MAX_LENGTH, pShader->m_wsObjectFile );
-    wcscat_s( pShader->m_wsPreprocessFile_with_ISA, m_uFILENAME_MAX_LENGTH, pShader->m_wsPreprocessFile );
-
-    if( m_bGenerateShaderISA )
-    {
-        wcscat_s( pShader->m_wsObjectFile_with_ISA, m_uFILENAME_MAX_LENGTH, L"." );
-        wcscat_s( pShader->m_wsObjectFile_with_ISA, m_uFILENAME_MAX_LENGTH, AmdTargetInfo[ pShader->m_eISATarget ].m_Name );
-        wcscat_s( pShader->m_wsPreprocessFile_with_ISA, m_uFILENAME_MAX_LENGTH, L"." );
-        wcscat_s( pShader->m_wsPreprocessFile_with_ISA, m_uFILENAME_MAX_LENGTH, AmdTargetInfo[ pShader->m_eISATarget ].m_Name );
-    }
+    pShader->m_iMaxVGPRLimit = i_iMaxVGPR;
+    pShader->m_iMaxSGPRLimit = i_iMaxSGPR;
 #endif
 
     // Compilation flags based on build profile
@@ -838,80 +937,10 @@ bool ShaderCache::AddShader(    ID3D11DeviceChild** ppShader,
         wcscpy_s( wsCompilationFlags, m_uFILENAME_MAX_LENGTH, L" /O1" );
     }
 #endif
+    pShader->m_wsCompilationFlags = m_Strings.Intern( wsCompilationFlags );
 
-    // Command line
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /T " );
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pwsTarget );
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsCompilationFlags );
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /E " );
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pwsEntryPoint );
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /Fo " );
-    InsertOutputFilenameIntoCommandLine( pShader->m_wsCommandLine, pShader->m_wsObjectFile );
-    for( int iMacro = 0; iMacro < (int)pShader->m_uNumMacros; ++iMacro )
-    {
-        wchar_t wsValue[64];
-        wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /D " );
-        wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_pMacros[iMacro].m_wsName );
-        wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L"=" );
-        _itow_s( pShader->m_pMacros[iMacro].m_iValue, wsValue, 10 );
-        wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
-    }
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /Fe " );
-    InsertOutputFilenameIntoCommandLine( pShader->m_wsCommandLine, pShader->m_wsErrorFile );
-    /*    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /Fc " );
-    InsertOutputFilenameIntoCommandLine( pShader->m_wsCommandLine, pShader->m_wsAssemblyFile );*/
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /Fc " ); // Fx for HEX
-    InsertOutputFilenameIntoCommandLine( pShader->m_wsCommandLine, pShader->m_wsAssemblyFileWithHashedFilename );
-    wcscat_s( pShader->m_wsCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
-    InsertInputFilenameIntoCommandLine( pShader->m_wsCommandLine, pShader->m_wsSourceFile );
-
-#if AMD_SDK_INTERNAL_BUILD
-    // ISA SCDev Command line
-    wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -q " );
-    wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -ns " );
-
-    wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -" );
-    wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, AmdTargetInfo[ m_eTargetISA ].m_Name );
-    wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
-
-    if( i_iMaxVGPR > 0 )
-    {
-        wchar_t wsValue[64];
-        _itow_s( i_iMaxVGPR, wsValue, 10 );
-        wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -vgprs " );
-        wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
-    }
-    if( i_iMaxSGPR > 0 )
-    {
-        wchar_t wsValue[64];
-        _itow_s( i_iMaxSGPR, wsValue, 10 );
-        wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" -sgprs " );
-        wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
-    }
-    //  wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
-    //  wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L"\"" );
-    //  wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_wsAssemblyFile );
-    //  wcscat_s( pShader->m_wsISACommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L"\"" );
-#endif
-
-    // Preprocess command line
-    wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /E " );
-    wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pwsEntryPoint );
-    wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
-    InsertInputFilenameIntoCommandLine( pShader->m_wsPreprocessCommandLine, pShader->m_wsSourceFile );
-    wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /P " );
-    InsertOutputFilenameIntoCommandLine( pShader->m_wsPreprocessCommandLine, pShader->m_wsPreprocessFile );
-    for( int iMacro = 0; iMacro < (int)pShader->m_uNumMacros; ++iMacro )
-    {
-        wchar_t wsValue[64];
-        wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L" /D " );
-        wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, pShader->m_pMacros[iMacro].m_wsName );
-        wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, L"=" );
-        _itow_s( pShader->m_pMacros[iMacro].m_iValue, wsValue, 10 );
-        wcscat_s( pShader->m_wsPreprocessCommandLine, m_uCOMMAND_LINE_MAX_LENGTH, wsValue );
-    }
-
-    m_ShaderList.push_back( pShader );
+    m_Shaders.push_back( pShader );
+    m_uNumShadersInState[pShader->m_eState]++;
 
     return true;
 }
@@ -955,30 +984,31 @@ HRESULT ShaderCache::GenerateShaders( CREATE_TYPE CreateType, const bool i_kbRec
         m_bShadersCreated = false;
         m_bPrintedProgress = false;
 
-        if( i_kbRecreateShaders )
-        {
-            m_CreateList.clear();
-        }
-
-        for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++ )
+        // Every shader gets a new state, so nothing from a previous generation is created
+        // twice, whether or not i_kbRecreateShaders is set
+        for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
         {
             Shader* pShader = *it;
 
+            pShader->m_Telemetry.Reset();
+
             if( ( m_CreateType == CREATE_TYPE_COMPILE_CHANGES ) ||
                 ( m_CreateType == CREATE_TYPE_FORCE_COMPILE ) ||
                 ( !CheckObjectFile( pShader ) ) )
             {
-                m_PreprocessList.push_back( pShader );
+                SetShaderState( pShader, SHADER_STATE_PREPROCESS );
             }
             else
             {
-                m_CreateList.push_back( pShader );
+                pShader->m_Telemetry.m_eCacheResult = ShaderTelemetry::CACHE_RESULT_HIT_UNCHECKED;
+                SetShaderState( pShader, SHADER_STATE_CREATE );
             }
         }
 
-        if( m_PreprocessList.size() )
+        if( m_uNumShadersInState[SHADER_STATE_PREPROCESS] > 0 )
         {
-            m_pProgressInfo = new ProgressInfo[m_PreprocessList.size() * 2];
+            delete[] m_pProgressInfo;
+            m_pProgressInfo = new ProgressInfo[m_uNumShadersInState[SHADER_STATE_PREPROCESS] * 2];
             m_uProgressCounter = 0;
 
             ResetEvent( s_hDoneEvent );
@@ -986,6 +1016,7 @@ HRESULT ShaderCache::GenerateShaders( CREATE_TYPE CreateType, const bool i_kbRec
         }
         else
         {
+            FinishTelemetry();
             SetEvent( s_hDoneEvent );
         }
     }
@@ -1036,7 +1067,7 @@ void ShaderCache::RenderProgress( CDXUTTextHelper* g_pTxtHelper, int iFontHeight
 
     int iNumLines = (int)( ( DXUTGetDXGIBackBufferSurfaceDesc()->Height - ( iFontHeight ) ) * 0.99f / iFontHeight );
 
-    if( !m_bPrintedProgress && !m_PreprocessList.size() )
+    if( !m_bPrintedProgress && !m_uNumShadersInState[SHADER_STATE_PREPROCESS] )
     {
         swprintf_s( wsOverallProgress, L"*** Shader Cache: Creating Shaders... ***" );
         g_pTxtHelper->DrawTextLine( wsOverallProgress );
@@ -1045,7 +1076,7 @@ void ShaderCache::RenderProgress( CDXUTTextHelper* g_pTxtHelper, int iFontHeight
     }
     else
     {
-        swprintf_s( wsOverallProgress, L"*** Shader Cache: Shaders to Preprocess = %d, Compile = %d ***", (int)m_PreprocessList.size(), (int)m_CompileList.size() );
+        swprintf_s( wsOverallProgress, L"*** Shader Cache: Shaders to Preprocess = %d, Compile = %d ***", (int)m_uNumShadersInState[SHADER_STATE_PREPROCESS], (int)m_uNumShadersInState[SHADER_STATE_COMPILE] );
         g_pTxtHelper->DrawTextLine( wsOverallProgress );
     }
 
@@ -1159,7 +1190,7 @@ void ShaderCache::SetRecompileTouchedShadersFlag( const bool i_bRecompileWhenTou
     if( m_bRecompileTouchedShaders )
     {
         // Create Directory Watcher
-        if( (m_waitPoolHandle == NULL) || (m_watchHandle == NULL) )
+        if( !m_ShaderSourceWatcher.IsRunning() )
         {
 #if defined(DEBUG) || defined(_DEBUG)
             const bool kb_Success = WatchDirectoryForChanges();
@@ -1240,48 +1271,17 @@ void ShaderCache::SetTargetISA( const ISA_TARGET i_eTargetISA )
 
 bool ShaderCache::WatchDirectoryForChanges( void )
 {
-    assert( !m_watchHandle );
-    assert( !m_waitPoolHandle );
-
-    if( m_waitPoolHandle )
-    {
-        UnregisterWaitEx( m_waitPoolHandle, INVALID_HANDLE_VALUE );
-        m_waitPoolHandle = NULL;
-    }
-
-    if( m_watchHandle )
-    {
-        FindCloseChangeNotification( m_watchHandle );
-        m_watchHandle = NULL;
-    }
-
-    assert( !m_watchHandle );
-    assert( !m_waitPoolHandle );
-
-    HANDLE watchHandle = FindFirstChangeNotification( m_wsShaderSourceDir, TRUE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE );
-    if( watchHandle == INVALID_HANDLE_VALUE )
-    {
-        wchar_t wsErrorString[m_uCOMMAND_LINE_MAX_LENGTH];
-        DWORD error = GetLastError();
-        swprintf_s( wsErrorString, L"\n\n*** Shader Cache: Error '%x' in FindFirstChangeNotification while attempting to watch directory '%s' ***\n\n", error, m_wsShaderSourceDir );
-        OutputDebugStringW( wsErrorString );
-        return false;
-    }
-
-    m_watchHandle = watchHandle;
+    assert( !m_ShaderSourceWatcher.IsRunning() );
 
-    HANDLE poolHandle;
-    if( !RegisterWaitForSingleObject(&poolHandle, watchHandle, onDirectoryChangeEventTriggered, (void*) this, INFINITE, WT_EXECUTEINWAITTHREAD) )
+    if( !m_ShaderSourceWatcher.Start( m_wsShaderSourceDir, onShaderSourceFilesChanged, (void*) this ) )
     {
         wchar_t wsErrorString[m_uCOMMAND_LINE_MAX_LENGTH];
         DWORD error = GetLastError();
-        swprintf_s( wsErrorString, L"\n\n*** Shader Cache: Error '%x' in RegisterWaitForSingleObject while attempting to watch directory '%s' ***\n\n", error, m_wsShaderSourceDir );
+        swprintf_s( wsErrorString, L"\n\n*** Shader Cache: Error '%x' in FileWatcher::Start while attempting to watch directory '%s' ***\n\n", error, m_wsShaderSourceDir );
         OutputDebugStringW( wsErrorString );
         return false;
     }
 
-    m_waitPoolHandle = poolHandle;
-
     wchar_t wsErrorString[m_uCOMMAND_LINE_MAX_LENGTH];
     swprintf_s( wsErrorString, L"\n\n*** Shader Cache: Succesfully enabled watching of directory '%s' ***\n\n", m_wsShaderSourceDir );
     OutputDebugStringW( wsErrorString );
@@ -1290,31 +1290,37 @@ bool ShaderCache::WatchDirectoryForChanges( void )
 }
 
 
-void __stdcall ShaderCache::onDirectoryChangeEventTriggered( void* args, BOOLEAN /*timeout*/ )
+// Called by the watcher once a burst of saves has settled, and only for files whose contents changed.
+// Returning false while shaders are compiling makes the watcher offer the changes again later,
+// so saves made during a compile are not lost.
+bool ShaderCache::onShaderSourceFilesChanged( void* args, const std::vector<std::wstring>& i_ChangedFiles )
 {
     ShaderCache* pShaderCache = reinterpret_cast< ShaderCache * >( args );
 
-    if( pShaderCache->RecompileTouchedShaders() )
+    if( !pShaderCache->RecompileTouchedShaders() )
     {
-        // Don't recompile if shaders are currently compiling!
-        if( pShaderCache->ShadersReady() )
-        {
-            pShaderCache->GenerateShaders( AMD::ShaderCache::CREATE_TYPE_COMPILE_CHANGES, true );
+        return true;
+    }
 
-            wchar_t wsErrorString[m_uCOMMAND_LINE_MAX_LENGTH];
-            swprintf_s( wsErrorString, L"\n\n*** ShaderCache::onDirectoryChangeEventTriggered! @ [%s] ***\n\n", pShaderCache->m_wsShaderSourceDir );
-            OutputDebugStringW( wsErrorString );
-        }
-        else
-        {
-            wchar_t wsErrorString[m_uCOMMAND_LINE_MAX_LENGTH];
-            swprintf_s( wsErrorString, L"\n\n*** ShaderCache::onDirectoryChangeEventTriggered! @ [%s] -- SKIPPED, because shaders are already compiling. ***\n\n", pShaderCache->m_wsShaderSourceDir );
-            OutputDebugStringW( wsErrorString );
-        }
+    // Don't recompile if shaders are currently compiling!
+    if( !pShaderCache->ShadersReady() )
+    {
+        return false;
     }
 
-    FindNextChangeNotification( pShaderCache->m_watchHandle );
-    FindNextChangeNotification( pShaderCache->m_watchHandle ); //twice
+    pShaderCache->GenerateShaders( AMD::ShaderCache::CREATE_TYPE_COMPILE_CHANGES, true );
+
+    wchar_t wsErrorString[m_uCOMMAND_LINE_MAX_LENGTH];
+    swprintf_s( wsErrorString, L"\n\n*** ShaderCache::onShaderSourceFilesChanged! @ [%s] ***\n", pShaderCache->m_wsShaderSourceDir );
+    OutputDebugStringW( wsErrorString );
+    for( size_t i = 0; i < i_ChangedFiles.size(); i++ )
+    {
+        swprintf_s( wsErrorString, L"    %s\n", i_ChangedFiles[i].c_str() );
+        OutputDebugStringW( wsErrorString );
+    }
+    OutputDebugStringW( L"\n" );
+
+    return true;
 }
 
 //--------------------------------------------------------------------------------------
@@ -1342,16 +1348,22 @@ bool ShaderCache::GenerateShaderISA( Shader *pShader, const bool i_kbParseGPRPre
     {
         pShader->m_wsCompileStatus = L"ISA Compiler: Phase 1";
 
+        wchar_t wsAssemblyFile[m_uFILENAME_MAX_LENGTH];
+        GetShaderFileName( pShader, SHADER_FILE_ASSEMBLY, wsAssemblyFile );
+
         wchar_t wsASM[m_uPATHNAME_MAX_LENGTH];
         swprintf_s( wsASM, L"" );
         wcscat_s( wsASM, m_uFILENAME_MAX_LENGTH, L"\"" );
         wcscat_s( wsASM, m_uFILENAME_MAX_LENGTH, m_wsUnicodeWorkingDir );
         wcscat_s( wsASM, m_uFILENAME_MAX_LENGTH, L"\\" );
-        wcscat_s( wsASM, m_uFILENAME_MAX_LENGTH, pShader->m_wsAssemblyFileWithHashedFilename );
+        wcscat_s( wsASM, m_uFILENAME_MAX_LENGTH, wsAssemblyFile );
         wcscat_s( wsASM, m_uFILENAME_MAX_LENGTH, L"\"" );
 
+        wchar_t wsISACommandLine[m_uCOMMAND_LINE_MAX_LENGTH];
+        CreateISACommandLine( pShader, wsISACommandLine );
+
         wchar_t wsISACL[m_uPATHNAME_MAX_LENGTH];
-        swprintf_s( wsISACL, L"%s %s", pShader->m_wsISACommandLine, wsASM );
+        swprintf_s( wsISACL, L"%s %s", wsISACommandLine, wsASM );
 
         wchar_t wsShaderSCDEVWorkingDir[m_uPATHNAME_MAX_LENGTH];
         swprintf_s( wsShaderSCDEVWorkingDir, L"%s\\%s", m_wsSCDEVWorkingDir, AmdTargetInfo[ pShader->m_eISATarget ].m_Name );
@@ -1497,7 +1509,7 @@ bool ShaderCache::GetShaderGPRUsageFromISA( Shader *pShader, unsigned int& io_uN
 
     FILE* pFile = NULL;
     wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
-    CreateFullPathFromOutputFilename( wsShaderPathName, pShader->m_wsISAFile );
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_ISA );
     _wfopen_s( &pFile, wsShaderPathName, L"rt" );
 
     io_uNumVGPR = 0;
@@ -1635,7 +1647,7 @@ bool ShaderCache::GenerateShaderGPRUsageFromISAForAllShaders( const bool ik_bGen
 #if AMD_SDK_INTERNAL_BUILD
     bool bReturnValue = false;
 
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
         unsigned int VGPR = 0, SGPR = 0;
@@ -1729,7 +1741,7 @@ void ShaderCache::RenderISAInfo( CDXUTTextHelper* g_pTxtHelper, int iFontHeight,
         g_pTxtHelper->SetInsertionPos( 5, (m_bHasShaderErrorsToDisplay) ? 300 : 60 );
     }
 
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
 
@@ -1944,7 +1956,7 @@ private:
 //--------------------------------------------------------------------------------------
 // Creates Human-readable Hash Digest html file with hyperlinks links and plain filenames
 //--------------------------------------------------------------------------------------
-bool ShaderCache::CreateHashDigest( const std::list<Shader*>& i_ShaderList )
+bool ShaderCache::CreateHashDigest()
 {
     FILE* pFile = NULL;
     wchar_t wsPathName[m_uPATHNAME_MAX_LENGTH];
@@ -1959,17 +1971,30 @@ bool ShaderCache::CreateHashDigest( const std::list<Shader*>& i_ShaderList )
 
     int tabID = 0;
     html.StartTabTable();
-    for( std::list<Shader*>::const_iterator it = i_ShaderList.begin(); it != i_ShaderList.end(); it++ )
+    for( std::vector<Shader*>::const_iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
     {
         Shader* pShader = *it;
+        if( pShader->m_eState != SHADER_STATE_CREATE )
+        {
+            continue;
+        }
         html.AddTab( ++tabID, pShader->m_wsRawFileName );
     }
     html.EndTabTableHeader();
 
     tabID = 0;
-    for( std::list<Shader*>::const_iterator it = i_ShaderList.begin(); it != i_ShaderList.end(); it++ )
+    for( std::vector<Shader*>::const_iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
     {
         Shader* pShader = *it;
+        if( pShader->m_eState != SHADER_STATE_CREATE )
+        {
+            continue;
+        }
+        wchar_t wsFileNames[SHADER_FILE_TYPE_MAX][m_uFILENAME_MAX_LENGTH];
+        for( int iFileType = 0; iFileType < SHADER_FILE_TYPE_MAX; iFileType++ )
+        {
+            GetShaderFileName( pShader, (SHADER_FILE_TYPE)iFileType, wsFileNames[iFileType] );
+        }
         wchar_t wsShaderInfoHTML[16384];
         swprintf_s( wsShaderInfoHTML, L"Raw Filename: %s<br>\n"
             L"Entry Point: %s<br>\n"
@@ -2016,18 +2041,18 @@ bool ShaderCache::CreateHashDigest( const std::list<Shader*>& i_ShaderList )
             AmdTargetInfo[ pShader->m_eISATarget ].m_Name,
 #endif
             pShader->m_wsSourceFile, pShader->m_wsSourceFile,
-            pShader->m_wsPreprocessFile, pShader->m_wsPreprocessFile,
-            pShader->m_wsAssemblyFileWithHashedFilename, pShader->m_wsAssemblyFileWithHashedFilename,
-            pShader->m_wsObjectFile, pShader->m_wsObjectFile,
-            pShader->m_wsErrorFile, pShader->m_wsErrorFile,
-            pShader->m_wsHashFile, pShader->m_wsHashFile,
+            wsFileNames[SHADER_FILE_PREPROCESS], wsFileNames[SHADER_FILE_PREPROCESS],
+            wsFileNames[SHADER_FILE_ASSEMBLY], wsFileNames[SHADER_FILE_ASSEMBLY],
+            wsFileNames[SHADER_FILE_OBJECT], wsFileNames[SHADER_FILE_OBJECT],
+            wsFileNames[SHADER_FILE_ERROR], wsFileNames[SHADER_FILE_ERROR],
+            wsFileNames[SHADER_FILE_HASH], wsFileNames[SHADER_FILE_HASH],
 #if AMD_SDK_INTERNAL_BUILD
-            pShader->m_wsISAFile, pShader->m_wsISAFile,
+            wsFileNames[SHADER_FILE_ISA], wsFileNames[SHADER_FILE_ISA],
             AmdTargetInfo[ pShader->m_eISATarget ].m_Name, pShader->m_wsHashedFileName, AmdTargetInfo[ pShader->m_eISATarget ].m_Name, pShader->m_wsHashedFileName,
 #endif
             pShader->m_wsCompileStatus,
             pShader->m_iCompileWaitCount,
-            pShader->m_bBeingProcessed ? L"yes" : L"no",
+            ( pShader->m_eState == SHADER_STATE_HASH || pShader->m_eState == SHADER_STATE_COMPILE_CHECK ) ? L"yes" : L"no",
             pShader->m_bShaderUpToDate ? L"yes" : L"no"
 #if AMD_SDK_INTERNAL_BUILD
             ,pShader->m_bGPRsUpToDate ? L"yes" : L"no",
@@ -2059,14 +2084,20 @@ bool ShaderCache::CreateHashDigest( const std::list<Shader*>& i_ShaderList )
     html.writeHTML( L"<font face=\"Calibri\" size=\"-3\">\n" );
     // Error List
 
-    if( m_ErrorList.size() > 0 )
+    if( m_uNumShadersInState[SHADER_STATE_ERROR] > 0 )
     {
         html.writeHTML( L"<br><h1><center><font color=\"FF0000\">Error List</font></center></h1><br>\n" );
-        for( std::set<Shader*>::const_iterator it = m_ErrorList.begin(); it != m_ErrorList.end(); it++ )
+        for( std::vector<Shader*>::const_iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
         {
             Shader* pShader = *it;
+            if( pShader->m_eState != SHADER_STATE_ERROR )
+            {
+                continue;
+            }
+            wchar_t wsErrorFile[m_uFILENAME_MAX_LENGTH];
+            GetShaderFileName( pShader, SHADER_FILE_ERROR, wsErrorFile );
             wchar_t wsShaderInfoHTML[16384];
-            swprintf_s( wsShaderInfoHTML, L"%s::%s <a href=\"%s\">%s</a> <a href=\"%s\">%s</a><br>\n", pShader->m_wsRawFileName, pShader->m_wsEntryPoint, pShader->m_wsSourceFile, L"Source HLSL", pShader->m_wsErrorFile, L"Errors" );
+            swprintf_s( wsShaderInfoHTML, L"%s::%s <a href=\"%s\">%s</a> <a href=\"%s\">%s</a><br>\n", pShader->m_wsRawFileName, pShader->m_wsEntryPoint, pShader->m_wsSourceFile, L"Source HLSL", wsErrorFile, L"Errors" );
             html.writeHTML( wsShaderInfoHTML );
         }
         if( m_bHasShaderErrorsToDisplay )
@@ -2089,19 +2120,28 @@ bool ShaderCache::CreateHashDigest( const std::list<Shader*>& i_ShaderList )
     html.writeHTML( L"<br><h1><center>File Table</center></h1><br>\n" );
     html.writeHTML( L"<table><tr><td>Raw Filename</td><td>Filename Hash</td><td>Assembly File</td><td>Error File</td><td>Hash File</td><td>ISA File</td><td>Object File</td><td>Preprocess File</td></tr>\n" );
 
-    for( std::list<Shader*>::const_iterator it = i_ShaderList.begin(); it != i_ShaderList.end(); it++ )
+    for( std::vector<Shader*>::const_iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
     {
         Shader* pShader = *it;
+        if( pShader->m_eState != SHADER_STATE_CREATE )
+        {
+            continue;
+        }
+        wchar_t wsFileNames[SHADER_FILE_TYPE_MAX][m_uFILENAME_MAX_LENGTH];
+        for( int iFileType = 0; iFileType < SHADER_FILE_TYPE_MAX; iFileType++ )
+        {
+            GetShaderFileName( pShader, (SHADER_FILE_TYPE)iFileType, wsFileNames[iFileType] );
+        }
         html.writeHTML( L"\n\n<tr>" );
 
         html.AddFileTableRow( pShader->m_wsRawFileName, false );
         html.AddFileTableRow( pShader->m_wsHashedFileName, false );
-        html.AddFileTableRow( pShader->m_wsAssemblyFileWithHashedFilename );
-        html.AddFileTableRow( pShader->m_wsErrorFile );
-        html.AddFileTableRow( pShader->m_wsHashFile );
-        html.AddFileTableRow( pShader->m_wsISAFile );
-        html.AddFileTableRow( pShader->m_wsObjectFile );
-        html.AddFileTableRow( pShader->m_wsPreprocessFile );
+        html.AddFileTableRow( wsFileNames[SHADER_FILE_ASSEMBLY] );
+        html.AddFileTableRow( wsFileNames[SHADER_FILE_ERROR] );
+        html.AddFileTableRow( wsFileNames[SHADER_FILE_HASH] );
+        html.AddFileTableRow( wsFileNames[SHADER_FILE_ISA] );
+        html.AddFileTableRow( wsFileNames[SHADER_FILE_OBJECT] );
+        html.AddFileTableRow( wsFileNames[SHADER_FILE_PREPROCESS] );
 
         html.writeHTML( L"</tr>\n\n" );
 
@@ -2117,167 +2157,122 @@ bool ShaderCache::CreateHashDigest( const std::list<Shader*>& i_ShaderList )
 
 
 //--------------------------------------------------------------------------------------
-// Preprocesses shaders in the list, and generates a hash file, this is subsequently used to
-// determine if a shader has changed
+// Preprocesses the shaders waiting to be preprocessed, and generates a hash file, this is
+// subsequently used to determine if a shader has changed
 //--------------------------------------------------------------------------------------
 void ShaderCache::PreprocessShaders()
 {
     Shader* pShader = NULL;
-    unsigned int uNumWorkThreads = 0;
+    std::vector<Shader*> batch;
+    std::vector<double> processMs;
+    size_t uNextShader = 0;
+    unsigned int uBatch = 0;
 
     // Create Hash Digest File
     bool compileStatusInitialized = false;
     /*if( m_bCreateHashDigest )
     {
-        compileStatusInitialized = CreateHashDigest( m_PreprocessList );
+        compileStatusInitialized = CreateHashDigest();
     }*/
 
+    // Sources may have changed since the last pass, so let the preprocessor read them again
+    m_Preprocessor.ClearCache();
+
     // Setup Progress Info and Compile Status for all shaders
-    for( std::list<Shader*>::iterator it = m_PreprocessList.begin(); it != m_PreprocessList.end(); it++ )
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
     {
         pShader = *it;
-        pShader->m_wsCompileStatus = L"Preparing to pre-process . . ."; // Starting to Process the Shader
-        pShader->m_bBeingProcessed = false;
-        if( !compileStatusInitialized ) m_pProgressInfo[m_uProgressCounter++] = pShader; // Add this if Hash Digest hasn't already done it!
+        if( pShader->m_eState == SHADER_STATE_PREPROCESS )
+        {
+            pShader->m_wsCompileStatus = L"Preparing to pre-process . . ."; // Starting to Process the Shader
+            pShader->m_bPreprocessedInProcess = false;
+            if( !compileStatusInitialized ) m_pProgressInfo[m_uProgressCounter++] = pShader; // Add this if Hash Digest hasn't already done it!
+        }
     }
 
-    while( m_PreprocessList.size() )
+    // Work through the shaders in batches of up to one per core
+    while( !m_bAbort )
     {
-        bool bRemove = false;
+        batch.clear();
+        uBatch++;
 
-        for( std::list<Shader*>::iterator it = m_PreprocessList.begin(); it != m_PreprocessList.end(); it++ )
+        for( ; ( uNextShader < m_Shaders.size() ) && ( batch.size() < m_uNumCPUCoresToUse ); uNextShader++ )
         {
-            if( bRemove )
+            pShader = m_Shaders[uNextShader];
+
+            if( pShader->m_eState != SHADER_STATE_PREPROCESS )
             {
-                m_PreprocessList.remove( pShader );
-                bRemove = false;
+                continue;
             }
 
-            pShader = *it;
-
-            if( uNumWorkThreads < m_uNumCPUCoresToUse )
+            pShader->m_wsCompileStatus = L"Finding Shader"; // Starting to PreProcess the Shader
+            if( CheckShaderFile( pShader ) )
             {
-                // LAYLAFIXED: If we have 0 worker threads, then it implies we can't be processing a shader (so when (uNumWorkThreads == 0 ) && (m_bBeingProcessed == true), we have a bug!)
-                assert( (pShader->m_bBeingProcessed == false) || (uNumWorkThreads > 0) );
-                if( (pShader->m_bBeingProcessed == false) /*|| (uNumWorkThreads == 0)*/ )
-                {
-                    bRemove = true;
-                    pShader->m_wsCompileStatus = L"Finding Shader"; // Starting to PreProcess the Shader
-                    if( CheckShaderFile( pShader ) )
-                    {
-                        PreprocessShader( pShader );
-                        pShader->m_wsCompileStatus = L"Preprocessing"; // Starting to PreProcess the Shader
-                        //pShader->m_wsPreprocessFile_with_ISA
+                const double fStartMs = ShaderTelemetry::GetTimeMs();
+                PreprocessShader( pShader );
+                pShader->m_wsCompileStatus = L"Preprocessing"; // Starting to PreProcess the Shader
 
-                        pShader->m_bBeingProcessed = true;
-
-                        m_HashList.push_back( pShader );
-
-                        uNumWorkThreads++;
-                    }
-                    else
-                    {
-                        pShader->m_wsCompileStatus = L"ERROR: Shader Not Found!";
-                        pShader->m_bBeingProcessed = false;
-                        --uNumWorkThreads;
-                        continue;
-                    }
+                pShader->m_Telemetry.m_uPreprocessBatch = uBatch;
+                pShader->m_Telemetry.m_bPreprocessedInProcess = pShader->m_bPreprocessedInProcess;
+                if( pShader->m_bPreprocessedInProcess )
+                {
+                    pShader->m_Telemetry.m_fPreprocessMs = ShaderTelemetry::GetTimeMs() - fStartMs;
                 }
+
+                SetShaderState( pShader, SHADER_STATE_HASH );
+                batch.push_back( pShader );
             }
             else
             {
-                // else break out of the for loop, and let this batch of work finish
-                break;
+                pShader->m_wsCompileStatus = L"ERROR: Shader Not Found!";
+                pShader->m_Telemetry.m_eCacheResult = ShaderTelemetry::CACHE_RESULT_MISS_SOURCE_NOT_FOUND;
+                SetShaderState( pShader, SHADER_STATE_IDLE );
             }
-
-            Sleep(1);
-        }
-
-        if( bRemove )
-        {
-            m_PreprocessList.remove( pShader );
-            bRemove = false;
         }
 
-        if( m_bAbort )
+        if( batch.empty() )
         {
             break;
         }
 
-        // Wait for current batch of preprocessing to finish
+        // Wait for current batch of preprocessing to finish, fxc's run time is the preprocess time
+        WaitForShaderProcesses( batch, processMs );
+        for( size_t i = 0; i < batch.size(); i++ )
         {
-            HANDLE handles[MAXIMUM_WAIT_OBJECTS];
-            DWORD nHandleCount = 0;
-            for( std::list<Shader*>::iterator it = m_HashList.begin(); it != m_HashList.end(); it++ )
-            {
-                pShader = *it;
-                if( nHandleCount < MAXIMUM_WAIT_OBJECTS )
-                {
-                    handles[nHandleCount++] = pShader->m_hCompileProcessHandle;
-                }
-                if( nHandleCount == MAXIMUM_WAIT_OBJECTS )
-                {
-                    WaitForMultipleObjects(nHandleCount, handles, TRUE, INFINITE);
-                    nHandleCount = 0;
-                }
-            }
-            if( nHandleCount > 0 )
+            if( !batch[i]->m_bPreprocessedInProcess )
             {
-                WaitForMultipleObjects(nHandleCount, handles, TRUE, INFINITE);
+                batch[i]->m_Telemetry.m_fPreprocessMs = processMs[i];
             }
         }
 
-        // Close handles for current batch of preprocessing that is now finished
+        // Hash Preprocessed Shaders
+        size_t uNumHashed = 0;
+        while( ( uNumHashed < batch.size() ) && (!m_bAbort) )
         {
-            for( std::list<Shader*>::iterator it = m_HashList.begin(); it != m_HashList.end(); it++ )
+            for( std::vector<Shader*>::iterator it = batch.begin(); it != batch.end(); it++ )
             {
                 pShader = *it;
-                CloseHandle(pShader->m_hCompileProcessHandle);
-                CloseHandle(pShader->m_hCompileThreadHandle);
-                pShader->m_hCompileProcessHandle = NULL;
-                pShader->m_hCompileThreadHandle = NULL;
-            }
-        }
-
-        // Hash Preprocessed Shaders
-        while( m_HashList.size() && (!m_bAbort) )
-        {
-            bRemove = false;
 
-            for( std::list<Shader*>::iterator it = m_HashList.begin(); it != m_HashList.end(); it++ )
-            {
-                if( bRemove )
+                if( pShader->m_eState != SHADER_STATE_HASH )
                 {
-                    pShader->m_iCompileWaitCount = -1;
-                    m_HashList.remove( pShader );
-                    bRemove = false;
+                    continue;
                 }
 
-                pShader = *it;
-
-                assert(pShader->m_bBeingProcessed == true );
                 pShader->m_wsCompileStatus = L"Waiting for Preprocessor";
                 pShader->m_iCompileWaitCount++;
 
                 assert( pShader->m_hCompileProcessHandle == NULL );
 
-                /*pShader->m_iCompileWaitCount = 0;
+                const double fStartMs = ShaderTelemetry::GetTimeMs();
 
-                bool bKeepLooping = true;
-                while( bKeepLooping )
+                if( pShader->m_bPreprocessedInProcess || CreateHashFromPreprocessFile( pShader ) )
                 {
-                unsigned long exitCode = 0;
-                int rValue = GetExitCodeProcess(pShader->m_hCompileProcessHandle, &exitCode );
-                bKeepLooping = ( (rValue != 0) && (exitCode == STILL_ACTIVE) );
-                pShader->m_iCompileWaitCount++;
-                }*/
+                    ShaderTelemetry::CACHE_RESULT eCacheResult;
 
-                if( (pShader->m_bBeingProcessed == true ) && CreateHashFromPreprocessFile( pShader ) )
-                {
                     // Set Status to COMPARING HASH
                     pShader->m_wsCompileStatus = L"Comparing Hash";
-                    //m_pProgressInfo[m_uProgressCounter++] = pShader;
-                    //m_pProgressInfo[m_uProgressCounter++].m_wsFilename = pShader->m_wsPreprocessFile_with_ISA;
+
+                    CreateContentHash( pShader );
 
                     if( !CompareHash( pShader ) )
                     {
@@ -2285,295 +2280,304 @@ void ShaderCache::PreprocessShaders()
 
                         WriteHashFile( pShader );
 
-                        m_CompileList.push_back( pShader );
+                        eCacheResult = ShaderTelemetry::CACHE_RESULT_MISS_CHANGED;
                     }
                     else
                     {
-                        if( CheckObjectFile( pShader ) )
-                        {
-                            m_CreateList.push_back( pShader );
-                        }
-                        else
-                        {
-                            m_CompileList.push_back( pShader );
-                        }
+                        eCacheResult = CheckObjectFile( pShader ) ? ShaderTelemetry::CACHE_RESULT_HIT : ShaderTelemetry::CACHE_RESULT_MISS_NO_OBJECT;
                     }
 
-                    // Set Status to FINISHED
-                    pShader->m_wsCompileStatus = L"Finished Preprocessing";
-                    //m_pProgressInfo[m_uProgressCounter++] = pShader;
-                    //m_pProgressInfo[m_uProgressCounter++].m_wsFilename = pShader->m_wsPreprocessFile_with_ISA;
-
-                    pShader->m_bBeingProcessed = false;
-
-                    if ( uNumWorkThreads > 0 )
-                        uNumWorkThreads--;
-
-                    bRemove = true;
-                }
-                else
-                {
-                    Sleep(1);
-                }
-                /*else if( !bRemove )
-                {
-                // The Preprocess File Doesn't Exist; try again?
-                pShader->m_bBeingProcessed = false;
+                    if( ( eCacheResult != ShaderTelemetry::CACHE_RESULT_HIT ) && FetchSharedObjectFile( pShader ) )
+                    {
+                        eCacheResult = ShaderTelemetry::CACHE_RESULT_HIT_SHARED;
+                    }
 
-                if ( uNumWorkThreads > 0 )
-                uNumWorkThreads--;
+                    pShader->m_Telemetry.m_eCacheResult = eCacheResult;
+                    pShader->m_Telemetry.m_fHashMs = ShaderTelemetry::GetTimeMs() - fStartMs;
 
-                m_PreprocessList.push_back( pShader );
+                    const bool bCompile = ( eCacheResult == ShaderTelemetry::CACHE_RESULT_MISS_CHANGED ) || ( eCacheResult == ShaderTelemetry::CACHE_RESULT_MISS_NO_OBJECT );
+                    SetShaderState( pShader, bCompile ? SHADER_STATE_COMPILE : SHADER_STATE_CREATE );
 
-                // SET STATUS TO RETRY!
-                pShader->m_wsCompileStatus = L"Preprocessing: RETRY";
+                    // Set Status to FINISHED
+                    pShader->m_wsCompileStatus = L"Finished Preprocessing";
+                    pShader->m_iCompileWaitCount = -1;
 
-                bRemove = true;
-                //m_pProgressInfo[m_uProgressCounter++] = pShader;
-                //m_pProgressInfo[m_uProgressCounter++].m_wsFilename = pShader->m_wsPreprocessFile_with_ISA;
-                }*/
+                    uNumHashed++;
+                }
             }
 
-            if( bRemove )
+            if( uNumHashed < batch.size() )
             {
-                m_HashList.remove( pShader );
+                // The preprocess file isn't there yet, try again
+                Sleep(1);
             }
+        }
+    }
+}
 
-            if( m_bAbort )
-            {
-                break;
-            }
-
-            Sleep(1);
-
-        }
-
-    }
-
-
-
-}
-
-// a binary predicate implemented as a function:
-bool shader_duplicate_ptr(AMD::ShaderCache::Shader* pFirst, AMD::ShaderCache::Shader* pSecond)
-{
-    return ( pFirst == pSecond );
-}
 
 //--------------------------------------------------------------------------------------
-// Compiles the shaders in the list
+// Compiles the shaders waiting to be compiled
 //--------------------------------------------------------------------------------------
 void ShaderCache::CompileShaders()
 {
     Shader* pShader = NULL;
-    unsigned int uNumWorkThreads = 0;
+    std::vector<Shader*> batch;
+    std::vector<double> processMs;
+    size_t uNextShader = 0;
+    unsigned int uBatch = 0;
 
     EnterCriticalSection( &m_CompileShaders_CriticalSection );
 
-    while( m_CompileList.size() )
+    // Work through the shaders in batches of up to one per core
+    while( !m_bAbort )
     {
-        bool bRemove = false;
-
-        Sleep(1);
+        batch.clear();
+        uBatch++;
 
-        for( std::list<Shader*>::iterator it = m_CompileList.begin(); it != m_CompileList.end(); it++ )
+        for( ; ( uNextShader < m_Shaders.size() ) && ( batch.size() < m_uNumCPUCoresToUse ); uNextShader++ )
         {
+            pShader = m_Shaders[uNextShader];
 
-            Sleep(1);
-            if( bRemove )
+            if( pShader->m_eState != SHADER_STATE_COMPILE )
             {
-                m_CompileList.remove( pShader );
-                bRemove = false;
+                continue;
             }
 
-            pShader = *it;
-
-            pShader->m_wsCompileStatus = L"Waiting to Compile...";
-
-            if( uNumWorkThreads < m_uNumCPUCoresToUse )
-            {
-                if( pShader->m_bBeingProcessed == false )
-                {
-                    bRemove = true;
-                    pShader->m_wsCompileStatus = L"Compiling Shader";
-                    CompileShader( pShader );
+            pShader->m_wsCompileStatus = L"Compiling Shader";
+            CompileShader( pShader );
 
-                    pShader->m_bBeingProcessed = true;
-
-                    m_CompileCheckList.push_back( pShader );
-
-                    uNumWorkThreads++;
-                }
-            }
-            else
-            {
-                // else break out of the for loop, and let this batch of work finish
-                break;
-            }
-        }
+            pShader->m_Telemetry.m_bCompiled = true;
+            pShader->m_Telemetry.m_uCompileBatch = uBatch;
 
-        if( bRemove )
-        {
-            m_CompileList.remove( pShader );
-            bRemove = false;
+            SetShaderState( pShader, SHADER_STATE_COMPILE_CHECK );
+            batch.push_back( pShader );
         }
 
-        if( m_bAbort )
+        if( batch.empty() )
         {
             break;
         }
 
         // Wait for current batch of compiling to finish
+        WaitForShaderProcesses( batch, processMs );
+        for( size_t i = 0; i < batch.size(); i++ )
         {
-            HANDLE handles[MAXIMUM_WAIT_OBJECTS];
-            DWORD nHandleCount = 0;
-            for( std::list<Shader*>::iterator it = m_CompileCheckList.begin(); it != m_CompileCheckList.end(); it++ )
-            {
-                pShader = *it;
-                if( nHandleCount < MAXIMUM_WAIT_OBJECTS )
-                {
-                    handles[nHandleCount++] = pShader->m_hCompileProcessHandle;
-                }
-                if( nHandleCount == MAXIMUM_WAIT_OBJECTS )
-                {
-                    WaitForMultipleObjects(nHandleCount, handles, TRUE, INFINITE);
-                    nHandleCount = 0;
-                }
-            }
-            if( nHandleCount > 0 )
-            {
-                WaitForMultipleObjects(nHandleCount, handles, TRUE, INFINITE);
-            }
+            batch[i]->m_Telemetry.m_fCompileMs = processMs[i];
         }
 
-        // Close handles for current batch of compiling that is now finished
+        // Check Compiled Shaders
+        size_t uNumChecked = 0;
+        while( ( uNumChecked < batch.size() ) && (!m_bAbort) )
         {
-            for( std::list<Shader*>::iterator it = m_CompileCheckList.begin(); it != m_CompileCheckList.end(); it++ )
+            for( std::vector<Shader*>::iterator it = batch.begin(); it != batch.end(); it++ )
             {
                 pShader = *it;
-                CloseHandle(pShader->m_hCompileProcessHandle);
-                CloseHandle(pShader->m_hCompileThreadHandle);
-                pShader->m_hCompileProcessHandle = NULL;
-                pShader->m_hCompileThreadHandle = NULL;
-            }
-        }
 
-        // Check Compiled Shaders
-        while( m_CompileCheckList.size() && (!m_bAbort) )
-        {
-            bRemove = false;
-
-            for( std::list<Shader*>::iterator it = m_CompileCheckList.begin(); it != m_CompileCheckList.end(); it++ )
-            {
-                if( bRemove )
+                if( pShader->m_eState != SHADER_STATE_COMPILE_CHECK )
                 {
-                    m_CompileCheckList.remove( pShader );
-                    bRemove = false;
+                    continue;
                 }
 
-                pShader = *it;
+                bool bShaderHasCompilerError = false;
+                if( !CheckErrorFile( pShader, bShaderHasCompilerError ) )
+                {
+                    // fxc writes the error file last, wait for it
+                    continue;
+                }
 
-                bool bHasObjectFile = false;
+                if( bShaderHasCompilerError )
+                {
+                    pShader->m_bShaderUpToDate = true;
+                    pShader->m_bGPRsUpToDate = true;
+                    pShader->m_wsCompileStatus = L"Compiler Error!";
 
-                //pShader->m_wsCompileStatus = L"Waiting for Object File . . .";
-                if( CheckObjectFile( pShader ) )
+                    SetShaderState( pShader, SHADER_STATE_ERROR );
+                    uNumChecked++;
+                }
+                else if( CheckObjectFile( pShader ) )
                 {
                     pShader->m_wsCompileStatus = L"Found Object File";
-                    //m_pProgressInfo[m_uProgressCounter++].m_wsFilename = pShader->m_wsObjectFile_with_ISA;
-
-                    m_CreateList.push_back( pShader );
-
-                    bHasObjectFile = true;
 
-                    pShader->m_bBeingProcessed = false;
+                    SetShaderState( pShader, SHADER_STATE_CREATE );
+                    uNumChecked++;
 
-                    if ( uNumWorkThreads > 0 )
-                        uNumWorkThreads--;
+                    PublishSharedObjectFile( pShader );
 
-                    bRemove = true;
-                }
-
-                //pShader->m_wsCompileStatus = L"Checking For Errors . . .";
-                bool bShaderHasCompilerError = false;
-                if( /*bHasObjectFile && */CheckErrorFile( pShader, bShaderHasCompilerError ) )
-                {
-                    bRemove |= bShaderHasCompilerError;
-
-                    if( bHasObjectFile && !bShaderHasCompilerError )
+                    if( m_bGenerateShaderISA )
                     {
-                        if( m_bGenerateShaderISA )
-                        {
-                            pShader->m_wsCompileStatus = L"Generating ISA";
-                            pShader->m_bShaderUpToDate = false; // Shader Has Been Updated
-                            if( GenerateShaderISA(pShader, false) )
-                            {
-                                pShader->m_wsCompileStatus = L"Done!";
-                            }
-                        }
-                        else
+                        pShader->m_wsCompileStatus = L"Generating ISA";
+                        pShader->m_bShaderUpToDate = false; // Shader Has Been Updated
+                        if( GenerateShaderISA(pShader, false) )
                         {
                             pShader->m_wsCompileStatus = L"Done!";
-                            pShader->m_bShaderUpToDate = false; // Shader Has Been Updated
                         }
                     }
-                    else if( bShaderHasCompilerError )
-                    {
-                        pShader->m_bShaderUpToDate = true;
-                        pShader->m_bGPRsUpToDate = true;
-                        m_ErrorList.insert( pShader );
-                        pShader->m_wsCompileStatus = L"Compiler Error!";
-                        if ( uNumWorkThreads > 0 )
-                            uNumWorkThreads--;
-                    }
                     else
                     {
-                        pShader->m_wsCompileStatus = L"Still Compiling . . .";
+                        pShader->m_wsCompileStatus = L"Done!";
+                        pShader->m_bShaderUpToDate = false; // Shader Has Been Updated
                     }
                 }
                 else
                 {
-                    Sleep(1);
+                    pShader->m_wsCompileStatus = L"Still Compiling . . .";
                 }
             }
 
-            if( bRemove )
+            if( uNumChecked < batch.size() )
             {
-                m_CompileCheckList.remove( pShader );
+                Sleep(1);
             }
+        }
+    }
+
+    GenerateShaderGPRUsageFromISAForAllShaders(); // Generate GPR Usage for any shaders that still need updating
+
+    StoreObjectFiles();
+
+    FinishTelemetry();
+
+    LeaveCriticalSection( &m_CompileShaders_CriticalSection );
+
+    m_SharedCache.Trim();
+
+    if( m_bCreateHashDigest )
+    {
+        CreateHashDigest();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Waits for the fxc processes of a batch of shaders to finish, and closes their handles.
+// o_ProcessMs receives how long each process ran, 0 for shaders without one
+//--------------------------------------------------------------------------------------
+void ShaderCache::WaitForShaderProcesses( const std::vector<Shader*>& i_Shaders, std::vector<double>& o_ProcessMs )
+{
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    DWORD nHandleCount = 0;
+
+    // Shaders preprocessed in process have no handle to wait for
+    for( std::vector<Shader*>::const_iterator it = i_Shaders.begin(); it != i_Shaders.end(); it++ )
+    {
+        Shader* pShader = *it;
+        if( NULL != pShader->m_hCompileProcessHandle )
+        {
+            handles[nHandleCount++] = pShader->m_hCompileProcessHandle;
+        }
+        if( nHandleCount == MAXIMUM_WAIT_OBJECTS )
+        {
+            WaitForMultipleObjects(nHandleCount, handles, TRUE, INFINITE);
+            nHandleCount = 0;
+        }
+    }
+    if( nHandleCount > 0 )
+    {
+        WaitForMultipleObjects(nHandleCount, handles, TRUE, INFINITE);
+    }
+
+    o_ProcessMs.assign( i_Shaders.size(), 0.0 );
 
-            if( m_bAbort )
+    for( size_t i = 0; i < i_Shaders.size(); i++ )
+    {
+        Shader* pShader = i_Shaders[i];
+        if( NULL != pShader->m_hCompileProcessHandle )
+        {
+            FILETIME creationTime, exitTime, kernelTime, userTime;
+            if( GetProcessTimes( pShader->m_hCompileProcessHandle, &creationTime, &exitTime, &kernelTime, &userTime ) )
             {
-                break;
+                ULARGE_INTEGER creation, exit;
+                creation.LowPart = creationTime.dwLowDateTime;
+                creation.HighPart = creationTime.dwHighDateTime;
+                exit.LowPart = exitTime.dwLowDateTime;
+                exit.HighPart = exitTime.dwHighDateTime;
+                o_ProcessMs[i] = ( exit.QuadPart - creation.QuadPart ) / 10000.0; // 100ns units
             }
 
-            Sleep(1);
+            CloseHandle(pShader->m_hCompileProcessHandle);
+            CloseHandle(pShader->m_hCompileThreadHandle);
+        }
+        pShader->m_hCompileProcessHandle = NULL;
+        pShader->m_hCompileThreadHandle = NULL;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Completes the telemetry of the shader generation with the object sizes, and writes it out
+//--------------------------------------------------------------------------------------
+void ShaderCache::FinishTelemetry()
+{
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
+    {
+        Shader* pShader = *it;
 
+        if( pShader->m_eState != SHADER_STATE_CREATE )
+        {
+            continue;
+        }
+
+        ShaderDatabase::Blob blob;
+        if( m_Database.Find( pShader->m_pFilenameHash, blob ) )
+        {
+            pShader->m_Telemetry.m_uObjectSize = blob.m_uSize;
+        }
+        else
+        {
+            WIN32_FILE_ATTRIBUTE_DATA attributes;
+            wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
+            CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_OBJECT );
+
+            if( GetFileAttributesExW( wsShaderPathName, GetFileExInfoStandard, &attributes ) )
+            {
+                pShader->m_Telemetry.m_uObjectSize = attributes.nFileSizeLow;
+            }
         }
     }
 
-    GenerateShaderGPRUsageFromISAForAllShaders(); // Generate GPR Usage for any shaders that still need updating
+    std::vector<ShaderTelemetry::Record> records;
+    ShaderTelemetry::Summary summary;
+    GetShaderTelemetry( records, summary );
 
-    LeaveCriticalSection( &m_CompileShaders_CriticalSection );
+    wchar_t wsPathName[m_uPATHNAME_MAX_LENGTH];
+    CreateFullPathFromOutputFilename( wsPathName, L"ShaderTelemetry.jsonl" );
+    ShaderTelemetry::Write( wsPathName, records.empty() ? NULL : &records[0], (unsigned int)records.size(), summary );
+}
 
-    if( m_bCreateHashDigest )
+
+//--------------------------------------------------------------------------------------
+// Telemetry of the last shader generation
+//--------------------------------------------------------------------------------------
+void ShaderCache::GetShaderTelemetry( std::vector<ShaderTelemetry::Record>& o_Records, ShaderTelemetry::Summary& o_Summary ) const
+{
+    o_Records.resize( m_Shaders.size() );
+    for( size_t i = 0; i < m_Shaders.size(); i++ )
     {
-        CreateHashDigest( m_CreateList );
+        o_Records[i] = m_Shaders[i]->m_Telemetry;
     }
+
+    ShaderTelemetry::Summarize( o_Records.empty() ? NULL : &o_Records[0], (unsigned int)o_Records.size(), o_Summary );
 }
 
 
 //--------------------------------------------------------------------------------------
-// Creates the shaders in the list
+// Creates the shaders that are ready to be created
 //--------------------------------------------------------------------------------------
 HRESULT ShaderCache::CreateShaders()
 {
     HRESULT hr = E_FAIL;
     Shader* pShader = NULL;
 
-    for( std::list<Shader*>::iterator it = m_CreateList.begin(); it != m_CreateList.end(); it++ )
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
     {
         pShader = *it;
 
+        if( pShader->m_eState != SHADER_STATE_CREATE )
+        {
+            continue;
+        }
+
         if( pShader->m_ppShader )
         {
             if( NULL == *(pShader->m_ppShader) || (!pShader->m_bShaderUpToDate) )
@@ -2589,13 +2593,13 @@ HRESULT ShaderCache::CreateShaders()
 }
 
 //--------------------------------------------------------------------------------------
-// Invalidates the shaders in the list
+// Invalidates all shaders
 //--------------------------------------------------------------------------------------
 void ShaderCache::InvalidateShaders( void )
 {
     Shader* pShader = NULL;
 
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++ )
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
     {
         pShader = *it;
         pShader->m_bShaderUpToDate = false;
@@ -2684,7 +2688,7 @@ BOOL ShaderCache::CreateHashFromPreprocessFile( Shader* pShader )
     FILE* pFile = NULL;
     wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
 
-    CreateFullPathFromOutputFilename( wsShaderPathName, pShader->m_wsPreprocessFile );
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_PREPROCESS );
 
     const unsigned int kuMaxPath = AMD::ShaderCache::m_uPATHNAME_MAX_LENGTH;
     const size_t kPathLength = wcslen( wsShaderPathName );
@@ -2731,14 +2735,14 @@ BOOL ShaderCache::CreateHashFromPreprocessFile( Shader* pShader )
 //--------------------------------------------------------------------------------------
 // Creates a hash for the shader filename
 //--------------------------------------------------------------------------------------
-void ShaderCache::Shader::SetupHashedFilename( void )
+void ShaderCache::SetupHashedFilename( Shader* pShader )
 {
 
-    if( NULL != m_pFilenameHash )
+    if( NULL != pShader->m_pFilenameHash )
     {
-        free( m_pFilenameHash );
-        m_pFilenameHash = NULL;
-        m_uFilenameHashLength = 0;
+        free( pShader->m_pFilenameHash );
+        pShader->m_pFilenameHash = NULL;
+        pShader->m_uFilenameHashLength = 0;
     }
 
     // TODO: Convert into URL-Safe String
@@ -2746,10 +2750,12 @@ void ShaderCache::Shader::SetupHashedFilename( void )
     size_t i;
     char asciiString[ m_uPATHNAME_MAX_LENGTH ];
     memset( asciiString, '\0', sizeof( char[m_uPATHNAME_MAX_LENGTH] ) );
-    wcstombs_s( &i, asciiString, m_uPATHNAME_MAX_LENGTH, m_wsRawFileName, m_uPATHNAME_MAX_LENGTH );
-    CreateHash( asciiString, 0, &m_pFilenameHash, &m_uFilenameHashLength );
-    swprintf_s( m_wsHashedFileName, L"%x", *reinterpret_cast<unsigned long *>(m_pFilenameHash) );
-    assert( m_uFilenameHashLength == 16 );
+    wcstombs_s( &i, asciiString, m_uPATHNAME_MAX_LENGTH, pShader->m_wsRawFileName, m_uPATHNAME_MAX_LENGTH );
+    CreateHash( asciiString, 0, &pShader->m_pFilenameHash, &pShader->m_uFilenameHashLength );
+    wchar_t wsHashedFileName[m_uFILENAME_MAX_LENGTH];
+    swprintf_s( wsHashedFileName, L"%x", *reinterpret_cast<unsigned long *>(pShader->m_pFilenameHash) );
+    pShader->m_wsHashedFileName = m_Strings.Intern( wsHashedFileName );
+    assert( pShader->m_uFilenameHashLength == 16 );
 
 }
 
@@ -2850,7 +2856,7 @@ void ShaderCache::WriteHashFile( Shader* pShader )
     FILE* pFile = NULL;
     wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
 
-    CreateFullPathFromOutputFilename( wsShaderPathName, pShader->m_wsHashFile );
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_HASH );
 
     _wfopen_s( &pFile, wsShaderPathName, L"wb" );
 
@@ -2871,7 +2877,14 @@ BOOL ShaderCache::CompareHash( Shader* pShader )
     FILE* pFile = NULL;
     wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
 
-    CreateFullPathFromOutputFilename( wsShaderPathName, pShader->m_wsHashFile );
+    ShaderDatabase::Blob blob;
+    if( m_Database.Find( pShader->m_pFilenameHash, blob ) )
+    {
+        return ( pShader->m_uHashLength == ShaderDatabase::m_uHASH_LENGTH ) &&
+               !memcmp( pShader->m_pHash, blob.m_pHash, ShaderDatabase::m_uHASH_LENGTH );
+    }
+
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_HASH );
 
     _wfopen_s( &pFile, wsShaderPathName, L"rb" );
 
@@ -2899,6 +2912,288 @@ BOOL ShaderCache::CompareHash( Shader* pShader )
 }
 
 
+//--------------------------------------------------------------------------------------
+// Reads the hash file of a shader that was compiled before it had a database entry
+//--------------------------------------------------------------------------------------
+BOOL ShaderCache::ReadHashFile( Shader* pShader, BYTE* o_pHash )
+{
+    FILE* pFile = NULL;
+    wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
+
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_HASH );
+
+    _wfopen_s( &pFile, wsShaderPathName, L"rb" );
+
+    if( pFile )
+    {
+        size_t uRead = fread( o_pHash, 1, ShaderDatabase::m_uHASH_LENGTH, pFile );
+
+        fclose( pFile );
+
+        return ( uRead == ShaderDatabase::m_uHASH_LENGTH );
+    }
+
+    return FALSE;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Moves freshly compiled object files into the shader database with one append, shaders are
+// created straight from the mapped database from then on
+//--------------------------------------------------------------------------------------
+void ShaderCache::StoreObjectFiles()
+{
+    if( !m_Database.IsOpen() )
+    {
+        return;
+    }
+
+    std::vector<Shader*> shaders;
+    std::vector< std::vector<char> > objects;
+    std::vector< std::vector<BYTE> > hashes;
+
+    for( std::vector<Shader*>::const_iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++ )
+    {
+        Shader* pShader = *it;
+        FILE* pFile = NULL;
+        wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
+
+        if( pShader->m_eState != SHADER_STATE_CREATE )
+        {
+            continue;
+        }
+
+        // Shaders created from the database have no object file
+        CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_OBJECT );
+
+        _wfopen_s( &pFile, wsShaderPathName, L"rb" );
+
+        if( pFile )
+        {
+            std::vector<BYTE> hash( ShaderDatabase::m_uHASH_LENGTH );
+            bool bHasHash = false;
+            if( NULL != pShader->m_pHash && pShader->m_uHashLength == ShaderDatabase::m_uHASH_LENGTH )
+            {
+                memcpy( &hash[0], pShader->m_pHash, ShaderDatabase::m_uHASH_LENGTH );
+                bHasHash = true;
+            }
+            else
+            {
+                // Not preprocessed this run, the object was found by CheckObjectFile
+                bHasHash = ( ReadHashFile( pShader, &hash[0] ) == TRUE );
+            }
+
+            fseek( pFile, 0, SEEK_END );
+            int iFileSize = ftell( pFile );
+            rewind( pFile );
+
+            if( bHasHash && iFileSize > 0 )
+            {
+                std::vector<char> object( iFileSize );
+                if( fread( &object[0], 1, iFileSize, pFile ) == (size_t)iFileSize )
+                {
+                    shaders.push_back( pShader );
+                    objects.push_back( std::vector<char>() );
+                    objects.back().swap( object );
+                    hashes.push_back( std::vector<BYTE>() );
+                    hashes.back().swap( hash );
+                }
+            }
+
+            fclose( pFile );
+        }
+    }
+
+    if( shaders.empty() )
+    {
+        return;
+    }
+
+    std::vector<ShaderDatabase::Record> records( shaders.size() );
+    for( size_t iShader = 0; iShader < shaders.size(); iShader++ )
+    {
+        records[iShader].m_pKey = shaders[iShader]->m_pFilenameHash;
+        records[iShader].m_pHash = &hashes[iShader][0];
+        records[iShader].m_pData = &objects[iShader][0];
+        records[iShader].m_uSize = (unsigned int)objects[iShader].size();
+    }
+
+    if( m_Database.Append( &records[0], (unsigned int)records.size() ) )
+    {
+        for( size_t iShader = 0; iShader < shaders.size(); iShader++ )
+        {
+            DeleteShaderFile( shaders[iShader], SHADER_FILE_OBJECT );
+            DeleteHashFile( shaders[iShader] );
+        }
+
+        if( m_Database.NeedsCompaction() )
+        {
+            m_Database.Compact();
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Shares compiled objects with other processes through the given directory, this must be
+// called before the shaders are generated
+//--------------------------------------------------------------------------------------
+bool ShaderCache::SetSharedCacheDirectory( const wchar_t* pwsDirectory, unsigned int uMaxSizeMB )
+{
+    if( NULL == pwsDirectory )
+    {
+        m_SharedCache.Close();
+
+        return true;
+    }
+
+    if( L'\0' == m_wsCompilerIdentity[0] )
+    {
+        CreateCompilerIdentity();
+    }
+
+    return m_SharedCache.Open( pwsDirectory, uMaxSizeMB );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Identifies the compiler by the checksums of its binaries. fxc.exe is only a front end,
+// the compiler itself is d3dcompiler_47.dll, which lives next to it.
+//--------------------------------------------------------------------------------------
+void ShaderCache::CreateCompilerIdentity()
+{
+    static const wchar_t* pwsCompilerFiles[] = { L"fxc.exe", L"d3dcompiler_47.dll" };
+
+    wchar_t wsCompilerDir[m_uPATHNAME_MAX_LENGTH];
+    wcscpy_s( wsCompilerDir, m_wsFxcExePath );
+    PathRemoveFileSpec( wsCompilerDir );
+
+    crcInit();
+
+    memset( m_wsCompilerIdentity, '\0', sizeof( wchar_t[m_uPATHNAME_MAX_LENGTH] ) );
+
+    for( int iFile = 0; iFile < (int)ARRAYSIZE( pwsCompilerFiles ); iFile++ )
+    {
+        FILE* pFile = NULL;
+        wchar_t wsPathName[m_uPATHNAME_MAX_LENGTH];
+        swprintf_s( wsPathName, L"%s\\%s", wsCompilerDir, pwsCompilerFiles[iFile] );
+
+        _wfopen_s( &pFile, wsPathName, L"rb" );
+
+        unsigned int uCRC = 0;
+        int iFileSize = 0;
+        if( pFile )
+        {
+            fseek( pFile, 0, SEEK_END );
+            iFileSize = ftell( pFile );
+            rewind( pFile );
+
+            if( iFileSize > 0 )
+            {
+                std::vector<unsigned char> contents( iFileSize );
+                if( fread( &contents[0], 1, iFileSize, pFile ) == (size_t)iFileSize )
+                {
+                    uCRC = (unsigned int)crcFast( &contents[0], iFileSize );
+                }
+            }
+
+            fclose( pFile );
+        }
+
+        wchar_t wsFileIdentity[m_uFILENAME_MAX_LENGTH];
+        swprintf_s( wsFileIdentity, L"%s:%08x:%d ", pwsCompilerFiles[iFile], uCRC, iFileSize );
+        wcscat_s( m_wsCompilerIdentity, m_uPATHNAME_MAX_LENGTH, wsFileIdentity );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Creates the key of the shader in the shared cache, a hash of everything that determines
+// the compiler output: the preprocessed source, the compiler, the target, the compilation
+// flags, the entry point and the macros. Unlike the object file name, it does not depend
+// on where the shader source lives.
+//--------------------------------------------------------------------------------------
+void ShaderCache::CreateContentHash( Shader* pShader )
+{
+    if( NULL != pShader->m_pContentHash )
+    {
+        free( pShader->m_pContentHash );
+        pShader->m_pContentHash = NULL;
+        pShader->m_uContentHashLength = 0;
+    }
+
+    if( !m_SharedCache.IsOpen() || ( NULL == pShader->m_pHash ) )
+    {
+        return;
+    }
+
+    wchar_t wsContent[m_uCOMMAND_LINE_MAX_LENGTH];
+    swprintf_s( wsContent, L"%s/T %s%s /E %s", m_wsCompilerIdentity, pShader->m_wsTarget, pShader->m_wsCompilationFlags, pShader->m_wsEntryPoint );
+    for( int iMacro = 0; iMacro < (int)pShader->m_uNumMacros; ++iMacro )
+    {
+        wchar_t wsMacro[m_uFILENAME_MAX_LENGTH];
+        swprintf_s( wsMacro, L" /D %s=%d", pShader->m_pMacros[iMacro].m_wsName, pShader->m_pMacros[iMacro].m_iValue );
+        wcscat_s( wsContent, m_uCOMMAND_LINE_MAX_LENGTH, wsMacro );
+    }
+    wcscat_s( wsContent, m_uCOMMAND_LINE_MAX_LENGTH, L" " );
+    for( long i = 0; i < pShader->m_uHashLength; ++i )
+    {
+        wchar_t wsByte[3];
+        swprintf_s( wsByte, L"%02x", pShader->m_pHash[i] );
+        wcscat_s( wsContent, m_uCOMMAND_LINE_MAX_LENGTH, wsByte );
+    }
+
+    size_t i;
+    char asciiString[ m_uCOMMAND_LINE_MAX_LENGTH ];
+    memset( asciiString, '\0', sizeof( char[m_uCOMMAND_LINE_MAX_LENGTH] ) );
+    wcstombs_s( &i, asciiString, m_uCOMMAND_LINE_MAX_LENGTH, wsContent, _TRUNCATE );
+    CreateHash( asciiString, 0, &pShader->m_pContentHash, &pShader->m_uContentHashLength );
+    assert( pShader->m_uContentHashLength == SharedShaderCache::m_uKEY_LENGTH );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Copies the shader's object file from the shared cache, if another process compiled it
+//--------------------------------------------------------------------------------------
+BOOL ShaderCache::FetchSharedObjectFile( Shader* pShader )
+{
+    if( NULL == pShader->m_pContentHash )
+    {
+        return FALSE;
+    }
+
+    wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_OBJECT );
+
+    if( !m_SharedCache.Fetch( pShader->m_pContentHash, wsShaderPathName ) )
+    {
+        return FALSE;
+    }
+
+    pShader->m_wsCompileStatus = L"Found Shared Object File";
+    pShader->m_bShaderUpToDate = false; // Shader Has Been Updated
+
+    return TRUE;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Copies the shader's freshly compiled object file to the shared cache
+//--------------------------------------------------------------------------------------
+void ShaderCache::PublishSharedObjectFile( Shader* pShader )
+{
+    if( NULL == pShader->m_pContentHash )
+    {
+        return;
+    }
+
+    wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_OBJECT );
+
+    m_SharedCache.Publish( pShader->m_pContentHash, wsShaderPathName );
+}
+
+
 //--------------------------------------------------------------------------------------
 // Creates a shader
 //--------------------------------------------------------------------------------------
@@ -2912,52 +3207,71 @@ HRESULT ShaderCache::CreateShader( Shader* pShader )
     ID3D11DeviceChild* pTempD3DShader = *pShader->m_ppShader;
     *pShader->m_ppShader = NULL;
 
-    CreateFullPathFromOutputFilename( wsShaderPathName, pShader->m_wsObjectFile );
+    // Objects in the database are handed to the runtime straight from the mapped file
+    ShaderDatabase::Blob blob;
+    const char* pObject = NULL;
+    int iFileSize = 0;
+    char* pFileBuf = NULL;
 
-    _wfopen_s( &pFile, wsShaderPathName, L"rb" );
-
-    if( pFile )
+    if( m_Database.Find( pShader->m_pFilenameHash, blob ) )
     {
-        fseek( pFile, 0, SEEK_END );
-        int iFileSize = ftell( pFile );
-        rewind( pFile );
-        char* pFileBuf = new char[iFileSize];
-        fread( pFileBuf, 1, iFileSize, pFile );
+        pObject = (const char*)blob.m_pData;
+        iFileSize = (int)blob.m_uSize;
+    }
+    else
+    {
+        CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_OBJECT );
+
+        _wfopen_s( &pFile, wsShaderPathName, L"rb" );
+
+        if( pFile )
+        {
+            fseek( pFile, 0, SEEK_END );
+            iFileSize = ftell( pFile );
+            rewind( pFile );
+            pFileBuf = new char[iFileSize];
+            fread( pFileBuf, 1, iFileSize, pFile );
+            fclose( pFile );
+
+            pObject = pFileBuf;
+        }
+    }
 
+    if( pObject )
+    {
         switch( pShader->m_eShaderType )
         {
         case SHADER_TYPE_VERTEX:
-            hr = DXUTGetD3D11Device()->CreateVertexShader( pFileBuf, iFileSize, NULL, (ID3D11VertexShader**)pShader->m_ppShader );
+            hr = DXUTGetD3D11Device()->CreateVertexShader( pObject, iFileSize, NULL, (ID3D11VertexShader**)pShader->m_ppShader );
             assert( S_OK == hr );
             if( pShader->m_uNumDescElements && (pTempD3DShader == NULL) )
             { // Only create the Input Layout if one doesn't already exist (it shouldn't change at runtime... I *think*)
-                hr = DXUTGetD3D11Device()->CreateInputLayout( pShader->m_pInputLayoutDesc, pShader->m_uNumDescElements, pFileBuf, iFileSize, pShader->m_ppInputLayout );
+                hr = DXUTGetD3D11Device()->CreateInputLayout( pShader->m_pInputLayoutDesc, pShader->m_uNumDescElements, pObject, iFileSize, pShader->m_ppInputLayout );
             }
             break;
         case SHADER_TYPE_HULL:
-            hr = DXUTGetD3D11Device()->CreateHullShader( pFileBuf, iFileSize, NULL, (ID3D11HullShader**)pShader->m_ppShader );
+            hr = DXUTGetD3D11Device()->CreateHullShader( pObject, iFileSize, NULL, (ID3D11HullShader**)pShader->m_ppShader );
             assert( S_OK == hr );
             break;
         case SHADER_TYPE_DOMAIN:
-            hr = DXUTGetD3D11Device()->CreateDomainShader( pFileBuf, iFileSize, NULL, (ID3D11DomainShader**)pShader->m_ppShader );
+            hr = DXUTGetD3D11Device()->CreateDomainShader( pObject, iFileSize, NULL, (ID3D11DomainShader**)pShader->m_ppShader );
             assert( S_OK == hr );
             break;
         case SHADER_TYPE_GEOMETRY:
-            hr = DXUTGetD3D11Device()->CreateGeometryShader( pFileBuf, iFileSize, NULL, (ID3D11GeometryShader**)pShader->m_ppShader );
+            hr = DXUTGetD3D11Device()->CreateGeometryShader( pObject, iFileSize, NULL, (ID3D11GeometryShader**)pShader->m_ppShader );
             assert( S_OK == hr );
             break;
         case SHADER_TYPE_PIXEL:
-            hr = DXUTGetD3D11Device()->CreatePixelShader( pFileBuf, iFileSize, NULL, (ID3D11PixelShader**)pShader->m_ppShader );
+            hr = DXUTGetD3D11Device()->CreatePixelShader( pObject, iFileSize, NULL, (ID3D11PixelShader**)pShader->m_ppShader );
             assert( S_OK == hr );
             break;
         case SHADER_TYPE_COMPUTE:
-            hr = DXUTGetD3D11Device()->CreateComputeShader( pFileBuf, iFileSize, NULL, (ID3D11ComputeShader**)pShader->m_ppShader );
+            hr = DXUTGetD3D11Device()->CreateComputeShader( pObject, iFileSize, NULL, (ID3D11ComputeShader**)pShader->m_ppShader );
             assert( S_OK == hr );
             break;
         }
 
         delete[] pFileBuf;
-        fclose( pFile );
     }
 
     if( hr == S_OK )
@@ -2986,9 +3300,12 @@ BOOL ShaderCache::CompileShader( Shader* pShader )
     si.cb = sizeof(si);
     ZeroMemory( &pi, sizeof(pi) );
 
+    wchar_t wsCommandLine[m_uCOMMAND_LINE_MAX_LENGTH];
+    CreateCompileCommandLine( pShader, wsCommandLine );
+
     // Start the child process.
     BOOL bSuccess = CreateProcess( m_wsFxcExePath,   // Application name
-        pShader->m_wsCommandLine, // Command line
+        wsCommandLine,    // Command line
         NULL,             // Process handle not inheritable
         NULL,             // Thread handle not inheritable
         FALSE,            // Set handle inheritance to FALSE
@@ -3008,10 +3325,16 @@ BOOL ShaderCache::CompileShader( Shader* pShader )
 
 
 //--------------------------------------------------------------------------------------
-// Preprocesses a shader
+// Preprocesses a shader, in process when the ShaderPreprocessor can handle it, otherwise
+// by running fxc /P
 //--------------------------------------------------------------------------------------
 BOOL ShaderCache::PreprocessShader( Shader* pShader )
 {
+    if( PreprocessShaderInProcess( pShader ) )
+    {
+        return TRUE;
+    }
+
     STARTUPINFO si;
     PROCESS_INFORMATION pi;
 
@@ -3019,9 +3342,12 @@ BOOL ShaderCache::PreprocessShader( Shader* pShader )
     si.cb = sizeof(si);
     ZeroMemory( &pi, sizeof(pi) );
 
+    wchar_t wsCommandLine[m_uCOMMAND_LINE_MAX_LENGTH];
+    CreatePreprocessCommandLine( pShader, wsCommandLine );
+
     // Start the child process.
     BOOL bSuccess = CreateProcess( m_wsFxcExePath,   // Application name
-        pShader->m_wsPreprocessCommandLine, // Command line
+        wsCommandLine,    // Command line
         NULL,             // Process handle not inheritable
         NULL,             // Thread handle not inheritable
         FALSE,            // Set handle inheritance to FALSE
@@ -3039,6 +3365,51 @@ BOOL ShaderCache::PreprocessShader( Shader* pShader )
     return bSuccess;
 }
 
+//--------------------------------------------------------------------------------------
+// Preprocesses a shader with the built-in preprocessor, and hashes the result directly, so
+// no fxc process or preprocess file is needed. Returns false if fxc has to do it instead.
+//--------------------------------------------------------------------------------------
+bool ShaderCache::PreprocessShaderInProcess( Shader* pShader )
+{
+    wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
+    CreateFullPathFromInputFilename( wsShaderPathName, pShader->m_wsSourceFile );
+
+    // The same /D NAME=value defines as the preprocess command line
+    std::vector<std::string> defines( pShader->m_uNumMacros );
+    std::vector<const char*> pDefines( pShader->m_uNumMacros );
+    for( unsigned int iMacro = 0; iMacro < pShader->m_uNumMacros; ++iMacro )
+    {
+        char sDefine[m_uMACRO_MAX_LENGTH + 16];
+        sprintf_s( sDefine, "%S=%d", pShader->m_pMacros[iMacro].m_wsName, pShader->m_pMacros[iMacro].m_iValue );
+        defines[iMacro] = sDefine;
+        pDefines[iMacro] = defines[iMacro].c_str();
+    }
+
+    std::string output;
+    if( !m_Preprocessor.Preprocess( wsShaderPathName, pDefines.empty() ? NULL : &pDefines[0], pShader->m_uNumMacros, output ) )
+    {
+        wchar_t wsDebugText[m_uCOMMAND_LINE_MAX_LENGTH];
+        swprintf_s( wsDebugText, L"ShaderCache: falling back to fxc /P for %s (%S)\n", pShader->m_wsSourceFile, m_Preprocessor.GetLastError() );
+        OutputDebugStringW( wsDebugText );
+
+        return false;
+    }
+
+    if( NULL != pShader->m_pHash )
+    {
+        free( pShader->m_pHash );
+        pShader->m_pHash = NULL;
+        pShader->m_uHashLength = 0;
+    }
+
+    CreateHash( output.c_str(), 0, &pShader->m_pHash, &pShader->m_uHashLength );
+
+    pShader->m_bPreprocessedInProcess = true;
+
+    return true;
+}
+
+
 //--------------------------------------------------------------------------------------
 // Checks to see if the object file exists for a given shader
 //--------------------------------------------------------------------------------------
@@ -3071,7 +3442,13 @@ BOOL ShaderCache::CheckObjectFile( Shader* pShader )
     FILE* pFile = NULL;
     wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
 
-    CreateFullPathFromOutputFilename( wsShaderPathName, pShader->m_wsObjectFile );
+    ShaderDatabase::Blob blob;
+    if( m_Database.Find( pShader->m_pFilenameHash, blob ) )
+    {
+        return TRUE;
+    }
+
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_OBJECT );
 
     _wfopen_s( &pFile, wsShaderPathName, L"rt" );
 
@@ -3138,7 +3515,7 @@ BOOL ShaderCache::CheckErrorFile( Shader* pShader, bool& io_bHasShaderCompilerEr
     FILE* pFile = NULL;
     wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
 
-    CreateFullPathFromOutputFilename( wsShaderPathName, pShader->m_wsErrorFile );
+    CreateFullPathFromShaderFile( wsShaderPathName, pShader, SHADER_FILE_ERROR );
 
     _wfopen_s( &pFile, wsShaderPathName, L"rt" );
 
@@ -3150,13 +3527,16 @@ BOOL ShaderCache::CheckErrorFile( Shader* pShader, bool& io_bHasShaderCompilerEr
         if( iFileSize > 0 )
         {
             rewind( pFile );
-            if( IsAnError( pFile ) )
+            pShader->m_Telemetry.m_uNumErrors = CountErrors( pFile );
+            if( pShader->m_Telemetry.m_uNumErrors > 0 )
             {
                 io_bHasShaderCompilerError = true;
 
                 {
                     wchar_t wsShaderPathName[m_uPATHNAME_MAX_LENGTH];
-                    swprintf_s( wsShaderPathName, L"\n\n*** Shader Compiler: Errors found in [%s\\%s]\n\n", m_wsWorkingDir, pShader->m_wsErrorFile );
+                    wchar_t wsErrorFile[m_uFILENAME_MAX_LENGTH];
+                    GetShaderFileName( pShader, SHADER_FILE_ERROR, wsErrorFile );
+                    swprintf_s( wsShaderPathName, L"\n\n*** Shader Compiler: Errors found in [%s\\%s]\n\n", m_wsWorkingDir, wsErrorFile );
                     OutputDebugStringW( wsShaderPathName );
                     rewind( pFile );
                     PrintShaderErrors( pFile );
@@ -3278,30 +3658,26 @@ void ShaderCache::PrintShaderErrors( FILE* pFile )
 }
 
 //--------------------------------------------------------------------------------------
-// Checks an error file to see if there really was an error, rather than just a warning
+// Counts the errors in an error file, a file with only warnings has none
 //--------------------------------------------------------------------------------------
-BOOL ShaderCache::IsAnError( FILE* pFile )
+unsigned int ShaderCache::CountErrors( FILE* pFile )
 {
     char szLine[m_uCOMMAND_LINE_MAX_LENGTH];
     char* pLine = szLine;
     char szError[32];
     strcpy_s( szError, 32, "error" );
+    unsigned int uNumErrors = 0;
 
     while( fgets( pLine, m_uCOMMAND_LINE_MAX_LENGTH, pFile ) )
     {
-        char* pTemp = pLine;
-        while( *pTemp != '\n' )
+        // One error per line
+        if( NULL != strstr( pLine, szError ) )
         {
-            if( !strncmp( pTemp, szError, strlen( szError ) ) )
-            {
-                return TRUE;
-            }
-
-            pTemp++;
+            uNumErrors++;
         }
     }
 
-    return FALSE;
+    return uNumErrors;
 }
 
 //--------------------------------------------------------------------------------------
@@ -3318,12 +3694,24 @@ void ShaderCache::DeleteFileByFilename( const wchar_t* pwsFile ) const
 }
 
 
+//--------------------------------------------------------------------------------------
+// Deletion utility method
+//--------------------------------------------------------------------------------------
+void ShaderCache::DeleteShaderFile( const Shader* pShader, SHADER_FILE_TYPE FileType ) const
+{
+    wchar_t wsFileName[m_uFILENAME_MAX_LENGTH];
+
+    GetShaderFileName( pShader, FileType, wsFileName );
+    DeleteFileByFilename( wsFileName );
+}
+
+
 //--------------------------------------------------------------------------------------
 // Deletion utility method
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteErrorFiles()
 {
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
 
@@ -3337,7 +3725,7 @@ void ShaderCache::DeleteErrorFiles()
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteErrorFile( Shader* pShader )
 {
-    DeleteFileByFilename( pShader->m_wsErrorFile );
+    DeleteShaderFile( pShader, SHADER_FILE_ERROR );
 }
 
 
@@ -3346,7 +3734,7 @@ void ShaderCache::DeleteErrorFile( Shader* pShader )
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteAssemblyFiles()
 {
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
 
@@ -3360,8 +3748,7 @@ void ShaderCache::DeleteAssemblyFiles()
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteAssemblyFile( Shader* pShader )
 {
-    //DeleteFileByFilename( pShader->m_wsAssemblyFile );
-    DeleteFileByFilename( pShader->m_wsAssemblyFileWithHashedFilename );
+    DeleteShaderFile( pShader, SHADER_FILE_ASSEMBLY );
 }
 
 
@@ -3370,11 +3757,20 @@ void ShaderCache::DeleteAssemblyFile( Shader* pShader )
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteObjectFiles()
 {
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    std::vector<const BYTE*> keys;
+
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
 
-        DeleteObjectFile( pShader );
+        DeleteShaderFile( pShader, SHADER_FILE_OBJECT );
+        keys.push_back( pShader->m_pFilenameHash );
+    }
+
+    // One commit for all the database entries
+    if( !keys.empty() )
+    {
+        m_Database.Remove( &keys[0], (unsigned int)keys.size() );
     }
 }
 
@@ -3384,7 +3780,10 @@ void ShaderCache::DeleteObjectFiles()
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteObjectFile( Shader* pShader )
 {
-    DeleteFileByFilename( pShader->m_wsObjectFile );
+    DeleteShaderFile( pShader, SHADER_FILE_OBJECT );
+
+    const BYTE* pKey = pShader->m_pFilenameHash;
+    m_Database.Remove( &pKey, 1 );
 }
 
 
@@ -3393,7 +3792,7 @@ void ShaderCache::DeleteObjectFile( Shader* pShader )
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeletePreprocessFiles()
 {
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
 
@@ -3407,7 +3806,7 @@ void ShaderCache::DeletePreprocessFiles()
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeletePreprocessFile( Shader* pShader )
 {
-    DeleteFileByFilename( pShader->m_wsPreprocessFile );
+    DeleteShaderFile( pShader, SHADER_FILE_PREPROCESS );
 }
 
 
@@ -3416,7 +3815,7 @@ void ShaderCache::DeletePreprocessFile( Shader* pShader )
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteHashFiles()
 {
-    for( std::list<Shader*>::iterator it = m_ShaderList.begin(); it != m_ShaderList.end(); it++)
+    for( std::vector<Shader*>::iterator it = m_Shaders.begin(); it != m_Shaders.end(); it++)
     {
         Shader* pShader = *it;
 
@@ -3430,7 +3829,7 @@ void ShaderCache::DeleteHashFiles()
 //--------------------------------------------------------------------------------------
 void ShaderCache::DeleteHashFile( Shader* pShader )
 {
-    DeleteFileByFilename( pShader->m_wsHashFile );
+    DeleteShaderFile( pShader, SHADER_FILE_HASH );
 }
 
 
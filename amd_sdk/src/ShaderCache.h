@@ -26,7 +26,8 @@
 // Class definition for the ShaderCache interface. Allows the user to add shaders to a list
 // which is then compiled in parallel to object files. Future calls to create the shaders,
 // will simply re-use the object files, making craetion time very fast. The option is there,
-// to force the regeneration of object files.
+// to force the regeneration of object files. Compiled objects are kept in one packed file,
+// see ShaderDatabase.h, and can be shared with other processes, see SharedShaderCache.h.
 //
 // Assumption, relies on following directory structure:
 //
@@ -37,9 +38,15 @@
 #pragma once
 
 #include <set>
-#include <list>
 #include <vector>
 
+#include "ShaderDatabase.h"
+#include "SharedShaderCache.h"
+#include "FileWatcher.h"
+#include "ShaderPreprocessor.h"
+#include "StringPool.h"
+#include "ShaderTelemetry.h"
+
 // The following two defines (AMD_SDK_INTERNAL_BUILD and AMD_SDK_PREBUILT_RELEASE_EXE) are for internal AMD use.
 // If you don't work for AMD, you shouldn't need to touch them.
 
@@ -65,7 +72,7 @@
 // AMD_SDK_PREBUILT_RELEASE_EXE shouldn't be used with debug builds
 #if AMD_SDK_PREBUILT_RELEASE_EXE
 #if defined(DEBUG) || defined(_DEBUG)
-#error AMD_SDK_PREBUILT_RELEASE_EXE shouldn't be used with debug builds
+#error AMD_SDK_PREBUILT_RELEASE_EXE should not be used with debug builds
 #endif
 #endif
 
@@ -155,6 +162,31 @@ namespace AMD
             MAXCORES_SINGLE_THREADED    =  1
         } MAXCORES_TYPE;
 
+        // Shader state enumeration, where a shader is in the generation process
+        typedef enum _SHADER_STATE
+        {
+            SHADER_STATE_IDLE,              // Not part of the current generation
+            SHADER_STATE_PREPROCESS,        // Waiting to be preprocessed
+            SHADER_STATE_HASH,              // Preprocessing, waiting to be hashed
+            SHADER_STATE_COMPILE,           // Changed, waiting to be compiled
+            SHADER_STATE_COMPILE_CHECK,     // Compiling, waiting for the object or error file
+            SHADER_STATE_CREATE,            // Object file is up to date, ready to be created
+            SHADER_STATE_ERROR,             // Failed to compile
+            SHADER_STATE_MAX
+        }SHADER_STATE;
+
+        // Shader file type enumeration, the files a shader has in the cache directory
+        typedef enum _SHADER_FILE_TYPE
+        {
+            SHADER_FILE_OBJECT,             // Shaders\Cache\Object\<config>\<raw name>.obj
+            SHADER_FILE_ERROR,              // Shaders\Cache\Error\<raw name>.txt
+            SHADER_FILE_ASSEMBLY,           // Shaders\Cache\Assembly\<hashed name>.asm
+            SHADER_FILE_ISA,                // Shaders\Cache\ISA\<hashed name>.asm.<target>.dump.isa
+            SHADER_FILE_PREPROCESS,         // Shaders\Cache\Preprocess\<raw name>.ppf
+            SHADER_FILE_HASH,               // Shaders\Cache\Hash\<config>\<raw name>.hsh
+            SHADER_FILE_TYPE_MAX
+        }SHADER_FILE_TYPE;
+
         // The Macro structure
         class Macro
         {
@@ -177,31 +209,23 @@ namespace AMD
             ID3D11InputLayout**         m_ppInputLayout;
             D3D11_INPUT_ELEMENT_DESC*   m_pInputLayoutDesc;
             unsigned int                m_uNumDescElements;
-            wchar_t                     m_wsTarget[m_uTARGET_MAX_LENGTH];
-            wchar_t                     m_wsEntryPoint[m_uENTRY_POINT_MAX_LENGTH];
-            wchar_t                     m_wsSourceFile[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsCanonicalName[m_uFILENAME_MAX_LENGTH];
+
+            // Strings are interned in the ShaderCache's string pool, file names and
+            // command lines are derived from them when needed (see GetShaderFileName)
+            const wchar_t*              m_wsTarget;
+            const wchar_t*              m_wsEntryPoint;
+            const wchar_t*              m_wsSourceFile;
+            const wchar_t*              m_wsCanonicalName;
             unsigned int                m_uNumMacros;
             Macro*                      m_pMacros;
 
-            wchar_t                     m_wsRawFileName[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsHashedFileName[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsObjectFile[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsErrorFile[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsAssemblyFile[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsAssemblyFileWithHashedFilename[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsISAFile[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsPreprocessFile[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsHashFile[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsCommandLine[m_uCOMMAND_LINE_MAX_LENGTH];
-            wchar_t                     m_wsISACommandLine[m_uCOMMAND_LINE_MAX_LENGTH];
-            wchar_t                     m_wsPreprocessCommandLine[m_uCOMMAND_LINE_MAX_LENGTH];
-
-            wchar_t                     m_wsObjectFile_with_ISA[m_uFILENAME_MAX_LENGTH];
-            wchar_t                     m_wsPreprocessFile_with_ISA[m_uFILENAME_MAX_LENGTH];
+            const wchar_t*              m_wsRawFileName;
+            const wchar_t*              m_wsHashedFileName;
 
 #if AMD_SDK_INTERNAL_BUILD
             ISA_TARGET                  m_eISATarget;
+            int                         m_iMaxVGPRLimit;
+            int                         m_iMaxSGPRLimit;
             unsigned int                m_ISA_VGPRs;
             unsigned int                m_ISA_SGPRs;
             unsigned int                m_ISA_GPRPoolSize;
@@ -212,8 +236,9 @@ namespace AMD
             float                       m_previous_ISA_ALUPacking;
 #endif
 
+            SHADER_STATE                m_eState;
             bool                        m_bGPRsUpToDate;
-            bool                        m_bBeingProcessed;
+            bool                        m_bPreprocessedInProcess;   // m_pHash came from the ShaderPreprocessor, not from fxc /P
             bool                        m_bShaderUpToDate;
             BYTE*                       m_pHash;
             long                        m_uHashLength;
@@ -221,12 +246,16 @@ namespace AMD
             BYTE*                       m_pFilenameHash;
             long                        m_uFilenameHashLength;
 
+            const wchar_t*              m_wsCompilationFlags;
+            BYTE*                       m_pContentHash;
+            long                        m_uContentHashLength;
+
             const wchar_t*              m_wsCompileStatus;
             int                         m_iCompileWaitCount;
             HANDLE                      m_hCompileProcessHandle;
             HANDLE                      m_hCompileThreadHandle;
 
-            void SetupHashedFilename( void );
+            ShaderTelemetry::Record     m_Telemetry;
         };
 
         // Construction / destruction
@@ -292,6 +321,17 @@ namespace AMD
         // Called by the app to override optimizations when compiling shaders in release mode
         void ForceDebugShaders( bool bForce ) { m_bForceDebugShaders = bForce; }
 
+        // Called by the app to share compiled shaders with other processes and machines, through the given directory.
+        // The directory can also be set with the AMD_SDK_SHARED_SHADER_CACHE_DIR environment variable, NULL disables sharing
+        bool SetSharedCacheDirectory( const wchar_t* pwsDirectory, unsigned int uMaxSizeMB = SharedShaderCache::m_uDEFAULT_MAX_SIZE_MB );
+
+        // Telemetry of the last shader generation, also written to ShaderTelemetry.jsonl in the working dir.
+        // It is complete once ShadersReady() returns true, the record strings stay valid for the life of the cache
+        void GetShaderTelemetry( std::vector<ShaderTelemetry::Record>& o_Records, ShaderTelemetry::Summary& o_Summary ) const;
+
+        // Number of shaders in the given state, the same counts RenderProgress displays
+        unsigned int GetNumShadersInState( SHADER_STATE eState ) const { return m_uNumShadersInState[eState]; }
+
         // Do not call this function
         void GenerateShadersThreadProc();
 
@@ -300,10 +340,13 @@ namespace AMD
         // Preprocessing, compilation, and creation methods
         void PreprocessShaders();
         void CompileShaders();
+        void WaitForShaderProcesses( const std::vector<Shader*>& i_Shaders, std::vector<double>& o_ProcessMs );
+        void FinishTelemetry();
         void InvalidateShaders();
 
         HRESULT CreateShaders();
         BOOL PreprocessShader( Shader* pShader );
+        bool PreprocessShaderInProcess( Shader* pShader );
         BOOL CompileShader( Shader* pShader );
         HRESULT CreateShader( Shader* pShader );
 
@@ -313,11 +356,18 @@ namespace AMD
         static void CreateHash( const char* data, int iFileSize, BYTE** hash, long* len );
         void WriteHashFile( Shader* pShader );
         BOOL CompareHash( Shader* pShader );
-        bool CreateHashDigest( const std::list<Shader*>& i_ShaderList );
+        BOOL ReadHashFile( Shader* pShader, BYTE* o_pHash );
+        bool CreateHashDigest();
+
+        // Shared cache methods
+        void CreateCompilerIdentity();
+        void CreateContentHash( Shader* pShader );
+        BOOL FetchSharedObjectFile( Shader* pShader );
+        void PublishSharedObjectFile( Shader* pShader );
 
         // Watch methods (for automatic shader recompilation when changed)
         bool WatchDirectoryForChanges( void );
-        static void __stdcall onDirectoryChangeEventTriggered( void* args, BOOLEAN /*timeout*/ );
+        static bool onShaderSourceFilesChanged( void* args, const std::vector<std::wstring>& i_ChangedFiles );
 
         // Check methodss
         BOOL CheckFXC();
@@ -325,7 +375,7 @@ namespace AMD
         BOOL CheckShaderFile( Shader* pShader );
         BOOL CheckObjectFile( Shader* pShader );
         BOOL CheckErrorFile( Shader* pShader, bool& io_bHasShaderCompilerError );
-        BOOL IsAnError( FILE* pFile );
+        unsigned int CountErrors( FILE* pFile );
 
         // Methods to run SCDev to generate ISA
         bool GenerateISAForAllShaders();
@@ -335,12 +385,26 @@ namespace AMD
         bool GetShaderGPRUsageFromISA( Shader *pShader, unsigned int& io_uNumVGPR, unsigned int& io_uNumSGPR ) const;
         bool GenerateShaderGPRUsageFromISAForAllShaders( const bool ik_bGenerateISAOnFailure = true );
 
+        // Moves compiled object files into the shader database
+        void StoreObjectFiles();
+
+        // Shader state, file name, and command line methods
+        void SetShaderState( Shader* pShader, SHADER_STATE State );
+        void SetupHashedFilename( Shader* pShader );
+        void GetShaderFileName( const Shader* pShader, SHADER_FILE_TYPE FileType, wchar_t (&pwsFileName)[m_uFILENAME_MAX_LENGTH] ) const;
+        void CreateCompileCommandLine( const Shader* pShader, wchar_t (&pwsCommandLine)[m_uCOMMAND_LINE_MAX_LENGTH] ) const;
+        void CreatePreprocessCommandLine( const Shader* pShader, wchar_t (&pwsCommandLine)[m_uCOMMAND_LINE_MAX_LENGTH] ) const;
+#if AMD_SDK_INTERNAL_BUILD
+        void CreateISACommandLine( const Shader* pShader, wchar_t (&pwsCommandLine)[m_uCOMMAND_LINE_MAX_LENGTH] ) const;
+#endif
+
         // Prints the error message to debug output
         void PrintShaderErrors( FILE* pFile );
 
         // Various delete methods
         // LAYLANOTE: This code is horrid, it should be replaced by a single template function taking the type of file to delete.
         void DeleteFileByFilename( const wchar_t* pwsFile ) const;
+        void DeleteShaderFile( const Shader* pShader, SHADER_FILE_TYPE FileType ) const;
         void DeleteErrorFiles();
         void DeleteErrorFile( Shader* pShader );
         void DeleteAssemblyFiles();
@@ -365,6 +429,13 @@ namespace AMD
         {
             swprintf_s( pwsPath, L"%s\\%s", m_wsUnicodeShaderSourceDir, pwsFileName );
         }
+        template< size_t N >
+        void CreateFullPathFromShaderFile( wchar_t (&pwsPath)[N], const Shader* pShader, SHADER_FILE_TYPE FileType ) const
+        {
+            wchar_t wsFileName[m_uFILENAME_MAX_LENGTH];
+            GetShaderFileName( pShader, FileType, wsFileName );
+            CreateFullPathFromOutputFilename( pwsPath, wsFileName );
+        }
 
         // Private data
         CREATE_TYPE             m_CreateType;
@@ -374,14 +445,13 @@ namespace AMD
         bool                    m_bShadersCreated;
         bool                    m_bAbort;
         bool                    m_bPrintedProgress;
-        std::list<Shader*>      m_ShaderSourceList;
-        std::list<Shader*>      m_ShaderList;
-        std::list<Shader*>      m_PreprocessList;
-        std::list<Shader*>      m_HashList;
-        std::list<Shader*>      m_CompileList;
-        std::list<Shader*>      m_CompileCheckList;
-        std::list<Shader*>      m_CreateList;
-        std::set<Shader*>       m_ErrorList;
+        std::vector<Shader*>    m_ShaderSources;
+        std::vector<Shader*>    m_Shaders;
+        unsigned int            m_uNumShadersInState[SHADER_STATE_MAX];
+        StringPool              m_Strings;
+        ShaderDatabase          m_Database;
+        SharedShaderCache       m_SharedCache;
+        ShaderPreprocessor      m_Preprocessor;
 #if AMD_SDK_INTERNAL_BUILD
         std::vector< std::vector<Shader*> * > m_ISATargetList;
 #endif
@@ -400,7 +470,7 @@ namespace AMD
                 , m_pShader( i_pShader )
             {}
 
-            wchar_t*            m_wsFilename;
+            const wchar_t*      m_wsFilename;
             const wchar_t*      m_wsStatus;
             Shader*             m_pShader;
         };
@@ -409,6 +479,7 @@ namespace AMD
 
         unsigned int            m_uProgressCounter;
         wchar_t                 m_wsFxcExePath[m_uPATHNAME_MAX_LENGTH];
+        wchar_t                 m_wsCompilerIdentity[m_uPATHNAME_MAX_LENGTH];
         wchar_t                 m_wsDevExePath[m_uPATHNAME_MAX_LENGTH];
         wchar_t                 m_wsAmdSdkDir[m_uPATHNAME_MAX_LENGTH];
         wchar_t                 m_wsShaderSourceDir[m_uPATHNAME_MAX_LENGTH];
@@ -423,8 +494,7 @@ namespace AMD
 #endif
         CRITICAL_SECTION        m_CompileShaders_CriticalSection;
         CRITICAL_SECTION        m_GenISA_CriticalSection;
-        HANDLE                  m_watchHandle;
-        HANDLE                  m_waitPoolHandle;
+        FileWatcher             m_ShaderSourceWatcher;
         unsigned int            m_shaderErrorRenderedCount;
         bool                    m_bRecompileTouchedShaders;
         bool                    m_bShowShaderErrors;
@@ -0,0 +1,611 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderDatabase.cpp
+//
+// Class implementation for the ShaderDatabase interface. Stores the compiled shader objects of
+// a ShaderCache in one packed, memory mapped file.
+//
+// Layout (little endian):
+//
+// Header       magic, version, entry count, index CRC, index offset, committed size, garbage size
+// Blobs        compiled shader objects, each aligned to m_uBLOB_ALIGNMENT
+// Index        IndexEntry records sorted by key, the last one written is the one the header points at
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <windows.h>
+#include <cassert>
+#endif
+
+#include "ShaderDatabase.h"
+#include "crc.h"
+
+#include <algorithm>
+
+using namespace AMD;
+
+static const DWORD SHADER_DATABASE_MAGIC = 0x42444353; // 'SCDB'
+
+//--------------------------------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------------------------------
+ShaderDatabase::ShaderDatabase()
+{
+    memset( m_wsPathName, '\0', sizeof( wchar_t[m_uPATHNAME_MAX_LENGTH] ) );
+
+    m_hFile = INVALID_HANDLE_VALUE;
+    m_hMapping = NULL;
+    m_pView = NULL;
+    m_uViewSize = 0;
+    m_pHeader = NULL;
+    m_pIndex = NULL;
+
+    InitializeCriticalSection( &m_CriticalSection );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Destructor
+//--------------------------------------------------------------------------------------
+ShaderDatabase::~ShaderDatabase()
+{
+    Close();
+
+    DeleteCriticalSection( &m_CriticalSection );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Opens the database file, creating it if it does not exist yet. The cache can always be
+// rebuilt from the shader sources, so a file that fails validation is simply recreated.
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Open( const wchar_t* pwsPathName )
+{
+    Close();
+
+    EnterCriticalSection( &m_CriticalSection );
+
+    crcInit();
+
+    wcscpy_s( m_wsPathName, m_uPATHNAME_MAX_LENGTH, pwsPathName );
+
+    m_hFile = CreateFileW( m_wsPathName, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+
+    bool bOpened = false;
+    if( m_hFile != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER fileSize;
+        bOpened = GetFileSizeEx( m_hFile, &fileSize ) != 0;
+
+        if( bOpened && (UINT64)fileSize.QuadPart >= sizeof( Header ) )
+        {
+            bOpened = Map() && Validate();
+        }
+        else
+        {
+            bOpened = false;
+        }
+
+        if( !bOpened )
+        {
+            Unmap();
+            bOpened = Reset() && Map();
+        }
+    }
+
+    LeaveCriticalSection( &m_CriticalSection );
+
+    if( !bOpened )
+    {
+        wchar_t wsErrorString[m_uPATHNAME_MAX_LENGTH + 128];
+        swprintf_s( wsErrorString, L"\n\n*** Shader Database: Error '%x' while attempting to open '%s' ***\n\n", GetLastError(), pwsPathName );
+        OutputDebugStringW( wsErrorString );
+
+        Close();
+    }
+
+    return bOpened;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Closes the database file
+//--------------------------------------------------------------------------------------
+void ShaderDatabase::Close()
+{
+    EnterCriticalSection( &m_CriticalSection );
+
+    Unmap();
+
+    if( m_hFile != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( m_hFile );
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    LeaveCriticalSection( &m_CriticalSection );
+}
+
+
+//--------------------------------------------------------------------------------------
+// public getter methods:
+//--------------------------------------------------------------------------------------
+
+bool ShaderDatabase::IsOpen() const
+{
+    return m_pHeader != NULL;
+}
+
+unsigned int ShaderDatabase::GetNumEntries() const
+{
+    return m_pHeader ? m_pHeader->m_uNumEntries : 0;
+}
+
+UINT64 ShaderDatabase::GetFileSize() const
+{
+    return m_pHeader ? m_pHeader->m_uFileSize : 0;
+}
+
+UINT64 ShaderDatabase::GetGarbageSize() const
+{
+    return m_pHeader ? m_pHeader->m_uGarbageSize : 0;
+}
+
+//--------------------------------------------------------------------------------------
+// Compaction pays off once more than half of the file is no longer referenced
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::NeedsCompaction() const
+{
+    return m_pHeader && ( m_pHeader->m_uGarbageSize * 2 > m_pHeader->m_uFileSize );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Looks up a shader, the blob points into the mapped file so nothing is copied
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Find( const BYTE* pKey, Blob& o_Blob ) const
+{
+    if( NULL == pKey )
+    {
+        return false;
+    }
+
+    EnterCriticalSection( &m_CriticalSection );
+
+    const IndexEntry* pEntry = FindEntry( pKey );
+    if( pEntry )
+    {
+        o_Blob.m_pHash = pEntry->m_Hash;
+        o_Blob.m_pData = m_pView + pEntry->m_uOffset;
+        o_Blob.m_uSize = pEntry->m_uSize;
+    }
+
+    LeaveCriticalSection( &m_CriticalSection );
+
+    return pEntry != NULL;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Adds or replaces shaders. The blobs and the merged index are written behind the committed
+// data, and only then the header is updated to point at them.
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Append( const Record* pRecords, unsigned int uNumRecords )
+{
+    if( uNumRecords == 0 )
+    {
+        return true;
+    }
+
+    EnterCriticalSection( &m_CriticalSection );
+
+    bool bAppended = false;
+    if( IsOpen() )
+    {
+        std::vector<IndexEntry> index( m_pIndex, m_pIndex + m_pHeader->m_uNumEntries );
+        bAppended = Commit( index, pRecords, uNumRecords, m_pHeader->m_uGarbageSize );
+    }
+
+    LeaveCriticalSection( &m_CriticalSection );
+
+    return bAppended;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Removes shaders by committing an index without them
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Remove( const BYTE* const* ppKeys, unsigned int uNumKeys )
+{
+    EnterCriticalSection( &m_CriticalSection );
+
+    bool bRemoved = false;
+    if( IsOpen() )
+    {
+        std::vector<IndexEntry> index;
+        index.reserve( m_pHeader->m_uNumEntries );
+
+        UINT64 uGarbageSize = m_pHeader->m_uGarbageSize;
+        for( unsigned int iEntry = 0; iEntry < m_pHeader->m_uNumEntries; iEntry++ )
+        {
+            const IndexEntry& entry = m_pIndex[iEntry];
+
+            bool bKeep = true;
+            for( unsigned int iKey = 0; iKey < uNumKeys && bKeep; iKey++ )
+            {
+                bKeep = ( NULL == ppKeys[iKey] ) || memcmp( entry.m_Key, ppKeys[iKey], m_uKEY_LENGTH ) != 0;
+            }
+
+            if( bKeep )
+            {
+                index.push_back( entry );
+            }
+            else
+            {
+                uGarbageSize += AlignOffset( entry.m_uSize );
+            }
+        }
+
+        // Nothing to do if none of the keys is stored
+        bRemoved = ( index.size() == m_pHeader->m_uNumEntries ) || Commit( index, NULL, 0, uGarbageSize );
+    }
+
+    LeaveCriticalSection( &m_CriticalSection );
+
+    return bRemoved;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Rewrites the live blobs into a temporary file and swaps it in, so the database is either
+// the old or the new file if the process is interrupted
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Compact()
+{
+    EnterCriticalSection( &m_CriticalSection );
+
+    if( !IsOpen() )
+    {
+        LeaveCriticalSection( &m_CriticalSection );
+        return false;
+    }
+
+    wchar_t wsTempPathName[m_uPATHNAME_MAX_LENGTH];
+    swprintf_s( wsTempPathName, L"%s%s", m_wsPathName, L".tmp" );
+
+    HANDLE hFile = CreateFileW( wsTempPathName, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+    bool bWritten = ( hFile != INVALID_HANDLE_VALUE );
+
+    if( bWritten )
+    {
+        std::vector<IndexEntry> index( m_pIndex, m_pIndex + m_pHeader->m_uNumEntries );
+
+        // Blobs are written in index order, which is also the order shaders are looked up in
+        UINT64 uOffset = AlignOffset( sizeof( Header ) );
+        for( size_t iEntry = 0; iEntry < index.size() && bWritten; iEntry++ )
+        {
+            IndexEntry& entry = index[iEntry];
+            bWritten = Write( hFile, uOffset, m_pView + entry.m_uOffset, entry.m_uSize );
+            entry.m_uOffset = uOffset;
+            uOffset = AlignOffset( uOffset + entry.m_uSize );
+        }
+
+        Header header;
+        memset( &header, 0, sizeof( header ) );
+        header.m_uMagic = SHADER_DATABASE_MAGIC;
+        header.m_uVersion = m_uVERSION;
+        header.m_uNumEntries = (DWORD)index.size();
+        header.m_uIndexCRC = index.empty() ? 0 : (DWORD)crcFast( (const unsigned char*)&index[0], (int)(index.size() * sizeof( IndexEntry )) );
+        header.m_uIndexOffset = uOffset;
+        header.m_uFileSize = uOffset + index.size() * sizeof( IndexEntry );
+        header.m_uGarbageSize = 0;
+
+        bWritten = bWritten && ( index.empty() || Write( hFile, uOffset, &index[0], index.size() * sizeof( IndexEntry ) ) );
+        bWritten = bWritten && Write( hFile, 0, &header, sizeof( header ) );
+        bWritten = bWritten && FlushFileBuffers( hFile );
+
+        CloseHandle( hFile );
+    }
+
+    bool bCompacted = false;
+    if( bWritten )
+    {
+        // The mapping and the handle have to go before the file can be replaced
+        Unmap();
+        CloseHandle( m_hFile );
+        m_hFile = INVALID_HANDLE_VALUE;
+
+        bCompacted = MoveFileExW( wsTempPathName, m_wsPathName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+    }
+    else
+    {
+        DeleteFileW( wsTempPathName );
+    }
+
+    if( m_hFile == INVALID_HANDLE_VALUE )
+    {
+        m_hFile = CreateFileW( m_wsPathName, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+        bCompacted = bCompacted && ( m_hFile != INVALID_HANDLE_VALUE ) && Map() && Validate();
+    }
+
+    LeaveCriticalSection( &m_CriticalSection );
+
+    return bCompacted;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Orders index entries by key
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::CompareEntries( const IndexEntry& i_First, const IndexEntry& i_Second )
+{
+    return memcmp( i_First.m_Key, i_Second.m_Key, m_uKEY_LENGTH ) < 0;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Rounds an offset up to the blob alignment
+//--------------------------------------------------------------------------------------
+UINT64 ShaderDatabase::AlignOffset( UINT64 uOffset )
+{
+    return ( uOffset + m_uBLOB_ALIGNMENT - 1 ) & ~(UINT64)( m_uBLOB_ALIGNMENT - 1 );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Binary search of the mapped index
+//--------------------------------------------------------------------------------------
+const ShaderDatabase::IndexEntry* ShaderDatabase::FindEntry( const BYTE* pKey ) const
+{
+    if( !IsOpen() )
+    {
+        return NULL;
+    }
+
+    IndexEntry key;
+    memcpy( key.m_Key, pKey, m_uKEY_LENGTH );
+
+    const IndexEntry* pEnd = m_pIndex + m_pHeader->m_uNumEntries;
+    const IndexEntry* pEntry = std::lower_bound( m_pIndex, pEnd, key, CompareEntries );
+
+    if( pEntry != pEnd && memcmp( pEntry->m_Key, pKey, m_uKEY_LENGTH ) == 0 )
+    {
+        return pEntry;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Checks the mapped header and index before anything is read through them
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Validate() const
+{
+    const Header& header = *m_pHeader;
+
+    if( header.m_uMagic != SHADER_DATABASE_MAGIC || header.m_uVersion != m_uVERSION )
+    {
+        return false;
+    }
+
+    const UINT64 uIndexSize = (UINT64)header.m_uNumEntries * sizeof( IndexEntry );
+    if( header.m_uFileSize > m_uViewSize ||
+        header.m_uIndexOffset < sizeof( Header ) ||
+        header.m_uIndexOffset + uIndexSize > header.m_uFileSize )
+    {
+        return false;
+    }
+
+    if( uIndexSize && header.m_uIndexCRC != (DWORD)crcFast( m_pView + header.m_uIndexOffset, (int)uIndexSize ) )
+    {
+        return false;
+    }
+
+    for( unsigned int iEntry = 0; iEntry < header.m_uNumEntries; iEntry++ )
+    {
+        const IndexEntry& entry = m_pIndex[iEntry];
+        if( entry.m_uOffset < sizeof( Header ) || entry.m_uOffset + entry.m_uSize > header.m_uIndexOffset )
+        {
+            return false;
+        }
+        if( iEntry > 0 && !CompareEntries( m_pIndex[iEntry - 1], entry ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Truncates the file to an empty database
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Reset()
+{
+    Header header;
+    memset( &header, 0, sizeof( header ) );
+    header.m_uMagic = SHADER_DATABASE_MAGIC;
+    header.m_uVersion = m_uVERSION;
+    header.m_uIndexOffset = sizeof( Header );
+    header.m_uFileSize = sizeof( Header );
+
+    LARGE_INTEGER position;
+    position.QuadPart = sizeof( Header );
+
+    return Write( m_hFile, 0, &header, sizeof( header ) ) &&
+           SetFilePointerEx( m_hFile, position, NULL, FILE_BEGIN ) &&
+           SetEndOfFile( m_hFile ) &&
+           FlushFileBuffers( m_hFile );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Maps the whole file for reading
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Map()
+{
+    assert( m_pView == NULL );
+
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx( m_hFile, &fileSize ) || (UINT64)fileSize.QuadPart < sizeof( Header ) )
+    {
+        return false;
+    }
+
+    m_hMapping = CreateFileMappingW( m_hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+    if( NULL == m_hMapping )
+    {
+        return false;
+    }
+
+    m_pView = (const BYTE*)MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 );
+    if( NULL == m_pView )
+    {
+        Unmap();
+        return false;
+    }
+
+    m_uViewSize = fileSize.QuadPart;
+    m_pHeader = (const Header*)m_pView;
+    m_pIndex = (const IndexEntry*)( m_pView + m_pHeader->m_uIndexOffset );
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Releases the mapping, all blobs handed out by Find become invalid
+//--------------------------------------------------------------------------------------
+void ShaderDatabase::Unmap()
+{
+    if( NULL != m_pView )
+    {
+        UnmapViewOfFile( m_pView );
+        m_pView = NULL;
+    }
+
+    if( NULL != m_hMapping )
+    {
+        CloseHandle( m_hMapping );
+        m_hMapping = NULL;
+    }
+
+    m_uViewSize = 0;
+    m_pHeader = NULL;
+    m_pIndex = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Writes a block of data at an absolute file offset
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Write( HANDLE hFile, UINT64 uOffset, const void* pData, size_t uSize ) const
+{
+    LARGE_INTEGER position;
+    position.QuadPart = uOffset;
+
+    if( !SetFilePointerEx( hFile, position, NULL, FILE_BEGIN ) )
+    {
+        return false;
+    }
+
+    DWORD uWritten = 0;
+    return WriteFile( hFile, pData, (DWORD)uSize, &uWritten, NULL ) && ( uWritten == uSize );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Writes the new blobs and the merged index behind the committed data, flushes them, and then
+// commits them by rewriting the header. The blobs of replaced entries and the previous index
+// become garbage for Compact() to reclaim.
+//--------------------------------------------------------------------------------------
+bool ShaderDatabase::Commit( std::vector<IndexEntry>& io_Index, const Record* pRecords, unsigned int uNumRecords, UINT64 uGarbageSize )
+{
+    UINT64 uOffset = AlignOffset( m_pHeader->m_uFileSize );
+    uGarbageSize += AlignOffset( m_pHeader->m_uNumEntries * sizeof( IndexEntry ) );
+
+    for( unsigned int iRecord = 0; iRecord < uNumRecords; iRecord++ )
+    {
+        const Record& record = pRecords[iRecord];
+
+        if( !Write( m_hFile, uOffset, record.m_pData, record.m_uSize ) )
+        {
+            return false;
+        }
+
+        IndexEntry entry;
+        memset( &entry, 0, sizeof( entry ) );
+        memcpy( entry.m_Key, record.m_pKey, m_uKEY_LENGTH );
+        memcpy( entry.m_Hash, record.m_pHash, m_uHASH_LENGTH );
+        entry.m_uOffset = uOffset;
+        entry.m_uSize = record.m_uSize;
+
+        std::vector<IndexEntry>::iterator it = std::lower_bound( io_Index.begin(), io_Index.end(), entry, CompareEntries );
+        if( it != io_Index.end() && !CompareEntries( entry, *it ) )
+        {
+            uGarbageSize += AlignOffset( it->m_uSize );
+            *it = entry;
+        }
+        else
+        {
+            io_Index.insert( it, entry );
+        }
+
+        uOffset = AlignOffset( uOffset + record.m_uSize );
+    }
+
+    const size_t uIndexSize = io_Index.size() * sizeof( IndexEntry );
+
+    Header header;
+    memset( &header, 0, sizeof( header ) );
+    header.m_uMagic = SHADER_DATABASE_MAGIC;
+    header.m_uVersion = m_uVERSION;
+    header.m_uNumEntries = (DWORD)io_Index.size();
+    header.m_uIndexCRC = uIndexSize ? (DWORD)crcFast( (const unsigned char*)&io_Index[0], (int)uIndexSize ) : 0;
+    header.m_uIndexOffset = uOffset;
+    header.m_uFileSize = uOffset + uIndexSize;
+    header.m_uGarbageSize = uGarbageSize;
+
+    // The header is only written once everything it points at is on disk
+    if( ( uIndexSize && !Write( m_hFile, uOffset, &io_Index[0], uIndexSize ) ) || !FlushFileBuffers( m_hFile ) )
+    {
+        return false;
+    }
+
+    Unmap();
+
+    bool bCommitted = Write( m_hFile, 0, &header, sizeof( header ) ) && FlushFileBuffers( m_hFile );
+
+    return Map() && bCommitted;
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderDatabase.h
+//
+// Class definition for the ShaderDatabase interface. Stores the compiled shader objects of
+// a ShaderCache in one packed file, instead of an object and a hash file per shader.
+//
+// The file is a header, followed by blobs and a sorted index keyed by the hash of the shader's
+// file name. It is memory mapped, so shaders are created straight from the mapped blobs.
+// New blobs and a new index are appended behind the committed data, and the header that points
+// at them is written last, so an interrupted append leaves the previous contents intact.
+// Blobs replaced by an append are reclaimed by Compact(), which rewrites the file and swaps it in.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <vector>
+
+namespace AMD
+{
+
+    class ShaderDatabase
+    {
+    public:
+
+        // Constants used for the file layout
+        static const unsigned int m_uKEY_LENGTH = 16;       // MD5 of the shader's raw file name
+        static const unsigned int m_uHASH_LENGTH = 16;      // MD5 of the preprocessed shader source
+        static const unsigned int m_uVERSION = 1;
+        static const unsigned int m_uBLOB_ALIGNMENT = 16;
+        static const unsigned int m_uPATHNAME_MAX_LENGTH = 512;
+
+        // A compiled shader to store
+        struct Record
+        {
+            const BYTE*     m_pKey;
+            const BYTE*     m_pHash;
+            const void*     m_pData;
+            unsigned int    m_uSize;
+        };
+
+        // A stored shader, the pointers stay valid until the next Append, Remove, Compact or Close
+        struct Blob
+        {
+            const BYTE*     m_pHash;
+            const void*     m_pData;
+            unsigned int    m_uSize;
+        };
+
+        // Construction / destruction
+        ShaderDatabase();
+        ~ShaderDatabase();
+
+        // Opens or creates the database, a file that fails validation is recreated empty
+        bool Open( const wchar_t* pwsPathName );
+        void Close();
+        bool IsOpen() const;
+
+        // Looks up a shader by the hash of its file name
+        bool Find( const BYTE* pKey, Blob& o_Blob ) const;
+
+        // Adds or replaces shaders, all of them are committed at once
+        bool Append( const Record* pRecords, unsigned int uNumRecords );
+
+        // Removes shaders, all of them are committed at once
+        bool Remove( const BYTE* const* ppKeys, unsigned int uNumKeys );
+
+        // Rewrites the file without the blobs that were replaced or removed
+        bool Compact();
+        bool NeedsCompaction() const;
+
+        unsigned int GetNumEntries() const;
+        UINT64 GetFileSize() const;
+        UINT64 GetGarbageSize() const;
+
+    private:
+
+        struct Header
+        {
+            DWORD           m_uMagic;
+            DWORD           m_uVersion;
+            DWORD           m_uNumEntries;
+            DWORD           m_uIndexCRC;
+            UINT64          m_uIndexOffset;
+            UINT64          m_uFileSize;        // End of the committed data, anything behind it is an interrupted append
+            UINT64          m_uGarbageSize;     // Bytes of blobs and indices that are no longer referenced
+            UINT64          m_uReserved;
+        };
+
+        struct IndexEntry
+        {
+            BYTE            m_Key[m_uKEY_LENGTH];
+            BYTE            m_Hash[m_uHASH_LENGTH];
+            UINT64          m_uOffset;
+            DWORD           m_uSize;
+            DWORD           m_uReserved;
+        };
+
+        static bool CompareEntries( const IndexEntry& i_First, const IndexEntry& i_Second );
+        static UINT64 AlignOffset( UINT64 uOffset );
+
+        const IndexEntry* FindEntry( const BYTE* pKey ) const;
+        bool Validate() const;
+        bool Reset();
+        bool Map();
+        void Unmap();
+        bool Write( HANDLE hFile, UINT64 uOffset, const void* pData, size_t uSize ) const;
+        bool Commit( std::vector<IndexEntry>& io_Index, const Record* pRecords, unsigned int uNumRecords, UINT64 uGarbageSize );
+
+        // Private data
+        wchar_t             m_wsPathName[m_uPATHNAME_MAX_LENGTH];
+        HANDLE              m_hFile;
+        HANDLE              m_hMapping;
+        const BYTE*         m_pView;
+        UINT64              m_uViewSize;
+        const Header*       m_pHeader;
+        const IndexEntry*   m_pIndex;
+        mutable CRITICAL_SECTION m_CriticalSection;
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,1728 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderPreprocessor.cpp
+//
+// Class implementation for the ShaderPreprocessor interface.
+//
+// Macro expansion follows the hide set algorithm of the C standard (Prosser): every token
+// carries the names of the macros that produced it, and a macro is not expanded again inside
+// its own expansion. Files are split into lines once, comments and line continuations removed,
+// and kept tokenized in the cache.
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <dirent.h>
+#include <strings.h>
+#include <sys/stat.h>
+#endif
+
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+using namespace AMD;
+
+#if defined(_WIN32)
+static const wchar_t PATH_SEPARATOR = L'\\';
+#else
+static const wchar_t PATH_SEPARATOR = L'/';
+#endif
+
+enum TOKEN_TYPE
+{
+    TOKEN_IDENTIFIER,
+    TOKEN_NUMBER,
+    TOKEN_STRING,
+    TOKEN_PUNCTUATOR,
+    TOKEN_OTHER,
+    TOKEN_SPACE,
+    TOKEN_NEWLINE,
+    TOKEN_PLACEMARKER,  // Stands in for an empty macro argument while pasting
+};
+
+struct ShaderPreprocessor::Token
+{
+    TOKEN_TYPE                  m_Type;
+    std::string                 m_Text;
+    std::vector<std::string>    m_HideSet;      // Sorted names of the macros this token came from
+
+    Token() : m_Type( TOKEN_OTHER ) {}
+    Token( TOKEN_TYPE Type, const std::string& Text ) : m_Type( Type ), m_Text( Text ) {}
+
+    bool Is( const char* pText ) const { return ( m_Type == TOKEN_PUNCTUATOR ) && ( m_Text == pText ); }
+    bool IsSpace() const { return ( m_Type == TOKEN_SPACE ) || ( m_Type == TOKEN_NEWLINE ); }
+};
+
+struct ShaderPreprocessor::Line
+{
+    bool                        m_bDirective;   // The tokens of a directive start after the '#'
+    TokenList                   m_Tokens;       // Text lines end in a TOKEN_NEWLINE
+};
+
+struct ShaderPreprocessor::File
+{
+    std::wstring                m_PathName;
+    bool                        m_bExists;
+    std::vector<Line>           m_Lines;
+};
+
+struct ShaderPreprocessor::Macro
+{
+    bool                        m_bFunctionLike;
+    bool                        m_bVariadic;
+    std::vector<std::string>    m_Parameters;
+    TokenList                   m_Body;
+};
+
+struct ShaderPreprocessor::Context
+{
+    struct Condition
+    {
+        bool                    m_bActive;      // This block is being processed
+        bool                    m_bTaken;       // A block of this #if chain was (or can no longer be) taken
+        bool                    m_bParentActive;
+        bool                    m_bSeenElse;
+    };
+
+    std::map<std::string, Macro>    m_Macros;
+    std::vector<Condition>          m_Conditions;
+    std::set<std::wstring>          m_OnceFiles;
+    std::vector<std::wstring>       m_Dependencies;
+    std::string                     m_Output;
+    std::string                     m_Error;
+    bool                            m_bErrorLocated;    // m_Error already names the file and line
+
+    Context() : m_bErrorLocated( false ) {}
+
+    bool IsActive() const { return m_Conditions.empty() || m_Conditions.back().m_bActive; }
+};
+
+
+//--------------------------------------------------------------------------------------
+// Helpers
+//--------------------------------------------------------------------------------------
+static bool IsIdentifierStart( char c )
+{
+    return ( ( c >= 'a' ) && ( c <= 'z' ) ) || ( ( c >= 'A' ) && ( c <= 'Z' ) ) || ( c == '_' );
+}
+
+static bool IsDigit( char c )
+{
+    return ( c >= '0' ) && ( c <= '9' );
+}
+
+static bool IsIdentifierChar( char c )
+{
+    return IsIdentifierStart( c ) || IsDigit( c );
+}
+
+static void AddToHideSet( std::vector<std::string>& io_HideSet, const std::vector<std::string>& i_Names )
+{
+    std::vector<std::string> merged;
+    std::set_union( io_HideSet.begin(), io_HideSet.end(), i_Names.begin(), i_Names.end(), std::back_inserter( merged ) );
+    io_HideSet.swap( merged );
+}
+
+static bool InHideSet( const std::vector<std::string>& i_HideSet, const std::string& i_Name )
+{
+    return std::binary_search( i_HideSet.begin(), i_HideSet.end(), i_Name );
+}
+
+static std::wstring ToWide( const std::string& i_String )
+{
+    return std::wstring( i_String.begin(), i_String.end() );
+}
+
+static std::string ToNarrow( const std::wstring& i_String )
+{
+    std::string narrow;
+    for( size_t i = 0; i < i_String.size(); i++ )
+    {
+        narrow += ( i_String[i] < 128 ) ? (char)i_String[i] : '?';
+    }
+
+    return narrow;
+}
+
+#if !defined(_WIN32)
+//--------------------------------------------------------------------------------------
+// fxc runs on Windows, where file names are not case sensitive, and shaders rely on it
+// (e.g. "../../../AMD_LIB/..." for amd_lib). Components that do not exist are matched
+// against their directory without case.
+//--------------------------------------------------------------------------------------
+static std::string FindWithoutCase( const std::string& i_PathName )
+{
+    std::string found = ( !i_PathName.empty() && ( i_PathName[0] == '/' ) ) ? "/" : "";
+    size_t uStart = found.size();
+    while( uStart < i_PathName.size() )
+    {
+        size_t uEnd = i_PathName.find( '/', uStart );
+        if( uEnd == std::string::npos )
+        {
+            uEnd = i_PathName.size();
+        }
+
+        const std::string component = i_PathName.substr( uStart, uEnd - uStart );
+        std::string candidate = found + component;
+        struct stat status;
+        if( ( 0 != stat( candidate.c_str(), &status ) ) && ( component != "." ) && ( component != ".." ) )
+        {
+            DIR* pDirectory = opendir( found.empty() ? "." : found.c_str() );
+            if( NULL != pDirectory )
+            {
+                for( struct dirent* pEntry = readdir( pDirectory ); NULL != pEntry; pEntry = readdir( pDirectory ) )
+                {
+                    if( 0 == strcasecmp( pEntry->d_name, component.c_str() ) )
+                    {
+                        candidate = found + pEntry->d_name;
+                        break;
+                    }
+                }
+                closedir( pDirectory );
+            }
+        }
+
+        found = candidate + ( ( uEnd < i_PathName.size() ) ? "/" : "" );
+        uStart = uEnd + 1;
+    }
+
+    return found;
+}
+#endif
+
+static bool ReadTextFile( const std::wstring& i_PathName, std::string& o_Text )
+{
+    FILE* pFile = NULL;
+#if defined(_WIN32)
+    _wfopen_s( &pFile, i_PathName.c_str(), L"rb" );
+#else
+    std::vector<char> narrow( i_PathName.size() * MB_LEN_MAX + 1, '\0' );
+    wcstombs( &narrow[0], i_PathName.c_str(), narrow.size() - 1 );
+    pFile = fopen( &narrow[0], "rb" );
+    if( NULL == pFile )
+    {
+        pFile = fopen( FindWithoutCase( &narrow[0] ).c_str(), "rb" );
+    }
+#endif
+
+    if( NULL == pFile )
+    {
+        return false;
+    }
+
+    fseek( pFile, 0, SEEK_END );
+    long iFileSize = ftell( pFile );
+    rewind( pFile );
+
+    o_Text.resize( iFileSize > 0 ? iFileSize : 0 );
+    const size_t uRead = ( iFileSize > 0 ) ? fread( &o_Text[0], 1, iFileSize, pFile ) : 0;
+    o_Text.resize( uRead );
+    fclose( pFile );
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Integer expression evaluation for #if and #elif, after defined() and macro expansion.
+//
+// Like a C preprocessor (and fxc), values are intmax_t, or uintmax_t as soon as an operand is
+// unsigned (a u suffix, or a literal too large for intmax_t), so (-1 < 0u) is false. The right
+// operand of && and ||, and the branch of ?: that is not taken, are parsed but not evaluated,
+// so (1 ? 2 : 1 / 0) is valid. Arithmetic wraps instead of overflowing.
+//--------------------------------------------------------------------------------------
+class ShaderPreprocessor::ExpressionParser
+{
+public:
+
+    ExpressionParser( const TokenList& i_Tokens ) : m_Tokens( i_Tokens ), m_uIndex( 0 ), m_uUnevaluated( 0 ), m_bError( false ) {}
+
+    bool Evaluate( long long& o_iValue )
+    {
+        o_iValue = Conditional().m_iValue;
+
+        return !m_bError && ( m_uIndex == m_Tokens.size() );
+    }
+
+private:
+
+    struct Value
+    {
+        long long   m_iValue;
+        bool        m_bUnsigned;
+
+        Value( long long iValue, bool bUnsigned ) : m_iValue( iValue ), m_bUnsigned( bUnsigned ) {}
+
+        unsigned long long Bits() const { return (unsigned long long)m_iValue; }
+        bool IsTrue() const { return ( 0 != m_iValue ); }
+    };
+
+    typedef Value ( ExpressionParser::*Rule )();
+
+    static Value Signed( long long iValue ) { return Value( iValue, false ); }
+    static Value Truth( bool bValue ) { return Value( bValue ? 1 : 0, false ); }
+
+    // The usual arithmetic conversions: unsigned if either operand is
+    static Value Converted( const Value& i_Left, const Value& i_Right, unsigned long long uBits )
+    {
+        return Value( (long long)uBits, i_Left.m_bUnsigned || i_Right.m_bUnsigned );
+    }
+
+    static bool Less( const Value& i_Left, const Value& i_Right )
+    {
+        return ( i_Left.m_bUnsigned || i_Right.m_bUnsigned ) ? ( i_Left.Bits() < i_Right.Bits() ) : ( i_Left.m_iValue < i_Right.m_iValue );
+    }
+
+    bool Accept( const char* pText )
+    {
+        if( ( m_uIndex < m_Tokens.size() ) && m_Tokens[m_uIndex].Is( pText ) )
+        {
+            m_uIndex++;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Parses an operand, only evaluating it if bEvaluate is set
+    Value Operand( Rule pRule, bool bEvaluate )
+    {
+        m_uUnevaluated += bEvaluate ? 0 : 1;
+        Value value = ( this->*pRule )();
+        m_uUnevaluated -= bEvaluate ? 0 : 1;
+
+        return value;
+    }
+
+    Value Conditional()
+    {
+        Value condition = LogicalOr();
+        if( Accept( "?" ) )
+        {
+            Value whenTrue = Operand( &ExpressionParser::Conditional, condition.IsTrue() );
+            if( !Accept( ":" ) )
+            {
+                m_bError = true;
+            }
+            Value whenFalse = Operand( &ExpressionParser::Conditional, !condition.IsTrue() );
+
+            return Converted( whenTrue, whenFalse, condition.IsTrue() ? whenTrue.Bits() : whenFalse.Bits() );
+        }
+
+        return condition;
+    }
+
+    Value LogicalOr()
+    {
+        Value value = LogicalAnd();
+        while( Accept( "||" ) )
+        {
+            Value right = Operand( &ExpressionParser::LogicalAnd, !value.IsTrue() );
+            value = Truth( value.IsTrue() || right.IsTrue() );
+        }
+
+        return value;
+    }
+
+    Value LogicalAnd()
+    {
+        Value value = BitwiseOr();
+        while( Accept( "&&" ) )
+        {
+            Value right = Operand( &ExpressionParser::BitwiseOr, value.IsTrue() );
+            value = Truth( value.IsTrue() && right.IsTrue() );
+        }
+
+        return value;
+    }
+
+    Value BitwiseOr()
+    {
+        Value value = BitwiseXor();
+        while( Accept( "|" ) )
+        {
+            Value right = BitwiseXor();
+            value = Converted( value, right, value.Bits() | right.Bits() );
+        }
+
+        return value;
+    }
+
+    Value BitwiseXor()
+    {
+        Value value = BitwiseAnd();
+        while( Accept( "^" ) )
+        {
+            Value right = BitwiseAnd();
+            value = Converted( value, right, value.Bits() ^ right.Bits() );
+        }
+
+        return value;
+    }
+
+    Value BitwiseAnd()
+    {
+        Value value = Equality();
+        while( Accept( "&" ) )
+        {
+            Value right = Equality();
+            value = Converted( value, right, value.Bits() & right.Bits() );
+        }
+
+        return value;
+    }
+
+    Value Equality()
+    {
+        Value value = Relational();
+        for( ;; )
+        {
+            if( Accept( "==" ) )      { value = Truth( value.Bits() == Relational().Bits() ); }
+            else if( Accept( "!=" ) ) { value = Truth( value.Bits() != Relational().Bits() ); }
+            else                      { return value; }
+        }
+    }
+
+    Value Relational()
+    {
+        Value value = Shift();
+        for( ;; )
+        {
+            if( Accept( "<=" ) )      { value = Truth( !Less( Shift(), value ) ); }
+            else if( Accept( ">=" ) ) { value = Truth( !Less( value, Shift() ) ); }
+            else if( Accept( "<" ) )  { value = Truth( Less( value, Shift() ) ); }
+            else if( Accept( ">" ) )  { value = Truth( Less( Shift(), value ) ); }
+            else                      { return value; }
+        }
+    }
+
+    // The result has the type of the left operand
+    Value Shift()
+    {
+        Value value = Additive();
+        for( ;; )
+        {
+            if( Accept( "<<" ) )
+            {
+                value.m_iValue = (long long)( value.Bits() << ( Additive().Bits() & 63 ) );
+            }
+            else if( Accept( ">>" ) )
+            {
+                const unsigned long long uShift = Additive().Bits() & 63;
+                value.m_iValue = value.m_bUnsigned ? (long long)( value.Bits() >> uShift ) : ( value.m_iValue >> uShift );
+            }
+            else
+            {
+                return value;
+            }
+        }
+    }
+
+    Value Additive()
+    {
+        Value value = Multiplicative();
+        for( ;; )
+        {
+            if( Accept( "+" ) )       { Value right = Multiplicative(); value = Converted( value, right, value.Bits() + right.Bits() ); }
+            else if( Accept( "-" ) )  { Value right = Multiplicative(); value = Converted( value, right, value.Bits() - right.Bits() ); }
+            else                      { return value; }
+        }
+    }
+
+    Value Multiplicative()
+    {
+        Value value = Unary();
+        for( ;; )
+        {
+            if( Accept( "*" ) )
+            {
+                Value right = Unary();
+                value = Converted( value, right, value.Bits() * right.Bits() );
+            }
+            else if( Accept( "/" ) || Accept( "%" ) )
+            {
+                const bool bDivide = m_Tokens[m_uIndex - 1].Is( "/" );
+                Value right = Unary();
+                if( !right.IsTrue() )
+                {
+                    // Only an error where the division is evaluated
+                    m_bError = m_bError || ( 0 == m_uUnevaluated );
+                    value = Converted( value, right, 0 );
+                }
+                else if( value.m_bUnsigned || right.m_bUnsigned )
+                {
+                    value = Converted( value, right, bDivide ? ( value.Bits() / right.Bits() ) : ( value.Bits() % right.Bits() ) );
+                }
+                else if( -1 == right.m_iValue )
+                {
+                    // LLONG_MIN / -1 wraps like the other operators
+                    value = Signed( bDivide ? (long long)( 0 - value.Bits() ) : 0 );
+                }
+                else
+                {
+                    value = Signed( bDivide ? ( value.m_iValue / right.m_iValue ) : ( value.m_iValue % right.m_iValue ) );
+                }
+            }
+            else
+            {
+                return value;
+            }
+        }
+    }
+
+    Value Unary()
+    {
+        if( Accept( "!" ) ) { return Truth( !Unary().IsTrue() ); }
+        if( Accept( "~" ) ) { Value value = Unary(); value.m_iValue = (long long)~value.Bits(); return value; }
+        if( Accept( "-" ) ) { Value value = Unary(); value.m_iValue = (long long)( 0 - value.Bits() ); return value; }
+        if( Accept( "+" ) ) { return Unary(); }
+
+        return Primary();
+    }
+
+    Value Primary()
+    {
+        if( m_uIndex >= m_Tokens.size() )
+        {
+            m_bError = true;
+            return Signed( 0 );
+        }
+
+        if( Accept( "(" ) )
+        {
+            Value value = Conditional();
+            if( !Accept( ")" ) )
+            {
+                m_bError = true;
+            }
+            return value;
+        }
+
+        const Token& token = m_Tokens[m_uIndex++];
+
+        // Identifiers left after macro expansion evaluate to 0
+        if( token.m_Type == TOKEN_IDENTIFIER )
+        {
+            return Signed( 0 );
+        }
+
+        if( token.m_Type == TOKEN_NUMBER )
+        {
+            std::string text = token.m_Text;
+            bool bUnsigned = false;
+            while( !text.empty() && ( strchr( "uUlL", text[text.size() - 1] ) != NULL ) )
+            {
+                bUnsigned = bUnsigned || ( text[text.size() - 1] == 'u' ) || ( text[text.size() - 1] == 'U' );
+                text.erase( text.size() - 1 );
+            }
+
+            char* pEnd = NULL;
+            const unsigned long long uValue = strtoull( text.c_str(), &pEnd, 0 );
+            if( ( NULL == pEnd ) || ( '\0' != *pEnd ) )
+            {
+                m_bError = true;
+            }
+
+            // A literal too large for intmax_t is unsigned
+            return Value( (long long)uValue, bUnsigned || ( uValue > (unsigned long long)LLONG_MAX ) );
+        }
+
+        if( ( token.m_Type == TOKEN_STRING ) && ( token.m_Text.size() >= 3 ) && ( token.m_Text[0] == '\'' ) )
+        {
+            return Signed( ( token.m_Text[1] == '\\' ) ? (long long)token.m_Text[2] : (long long)token.m_Text[1] );
+        }
+
+        m_bError = true;
+        return Signed( 0 );
+    }
+
+    const TokenList&    m_Tokens;
+    size_t              m_uIndex;
+    unsigned int        m_uUnevaluated;     // Nesting depth of operands that are parsed but not evaluated
+    bool                m_bError;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------------------------------
+ShaderPreprocessor::ShaderPreprocessor()
+{
+}
+
+
+//--------------------------------------------------------------------------------------
+// Destructor
+//--------------------------------------------------------------------------------------
+ShaderPreprocessor::~ShaderPreprocessor()
+{
+    ClearCache();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Preprocesses a source file with the given /D style defines
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::Preprocess( const wchar_t* pwsSourceFile, const char* const* ppDefines, unsigned int uNumDefines,
+    std::string& o_Output, std::vector<std::wstring>* o_pDependencies )
+{
+    assert( NULL != pwsSourceFile );
+
+    Context context;
+    m_LastError.clear();
+
+    for( unsigned int i = 0; i < uNumDefines; i++ )
+    {
+        // NAME=VALUE becomes "NAME VALUE", a bare NAME is defined as 1 like fxc does
+        std::string define = ppDefines[i];
+        const size_t uEquals = define.find( '=' );
+        if( uEquals == std::string::npos )
+        {
+            define += " 1";
+        }
+        else
+        {
+            define[uEquals] = ' ';
+        }
+
+        std::vector<Line> lines;
+        Tokenize( define, lines );
+        if( lines.empty() || !DefineMacro( context, lines[0].m_Tokens, 0 ) )
+        {
+            m_LastError = "invalid define: " + std::string( ppDefines[i] );
+            return false;
+        }
+    }
+
+    o_Output.clear();
+
+    if( !ProcessFile( context, ResolveInclude( L"", ToNarrow( pwsSourceFile ) ), 0 ) )
+    {
+        m_LastError = context.m_Error;
+        return false;
+    }
+
+    o_Output.swap( context.m_Output );
+
+    if( NULL != o_pDependencies )
+    {
+        o_pDependencies->swap( context.m_Dependencies );
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Forgets the cached files
+//--------------------------------------------------------------------------------------
+void ShaderPreprocessor::ClearCache()
+{
+    for( std::map<std::wstring, File*>::iterator it = m_Files.begin(); it != m_Files.end(); it++ )
+    {
+        delete it->second;
+    }
+
+    m_Files.clear();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Accessors
+//--------------------------------------------------------------------------------------
+const char* ShaderPreprocessor::GetLastError() const
+{
+    return m_LastError.c_str();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Returns the cached file, reading and tokenizing it on first use
+//--------------------------------------------------------------------------------------
+const ShaderPreprocessor::File* ShaderPreprocessor::LoadFile( const std::wstring& i_PathName )
+{
+    std::map<std::wstring, File*>::const_iterator it = m_Files.find( i_PathName );
+    if( it != m_Files.end() )
+    {
+        return it->second;
+    }
+
+    File* pFile = new File;
+    pFile->m_PathName = i_PathName;
+
+    std::string text;
+    pFile->m_bExists = ReadTextFile( i_PathName, text );
+    if( pFile->m_bExists )
+    {
+        Tokenize( text, pFile->m_Lines );
+    }
+
+    m_Files[i_PathName] = pFile;
+
+    return pFile;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Splits text into lines of tokens. Line continuations are joined and comments become a
+// single space, so a block comment spanning lines also joins them, as in C.
+//--------------------------------------------------------------------------------------
+void ShaderPreprocessor::Tokenize( const std::string& i_Text, std::vector<Line>& o_Lines )
+{
+    static const char* pPunctuators[] =
+    {
+        "<<=", ">>=", "...",
+        "##", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||",
+        "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "::",
+    };
+
+    // Join continued lines and drop carriage returns
+    std::string text;
+    text.reserve( i_Text.size() + 1 );
+    for( size_t i = 0; i < i_Text.size(); i++ )
+    {
+        if( i_Text[i] == '\r' )
+        {
+            continue;
+        }
+        if( ( i_Text[i] == '\\' ) && ( i + 1 < i_Text.size() ) && ( ( i_Text[i + 1] == '\n' ) || ( ( i_Text[i + 1] == '\r' ) && ( i + 2 < i_Text.size() ) && ( i_Text[i + 2] == '\n' ) ) ) )
+        {
+            i += ( i_Text[i + 1] == '\r' ) ? 2 : 1;
+            continue;
+        }
+        text += i_Text[i];
+    }
+    text += '\n';
+
+    Line line;
+    line.m_bDirective = false;
+
+    size_t i = 0;
+    while( i < text.size() )
+    {
+        const char c = text[i];
+
+        if( c == '\n' )
+        {
+            // A '#' as the first token makes this a directive
+            size_t uFirst = SkipSpaces( line.m_Tokens, 0 );
+            if( ( uFirst < line.m_Tokens.size() ) && line.m_Tokens[uFirst].Is( "#" ) )
+            {
+                line.m_bDirective = true;
+                line.m_Tokens.erase( line.m_Tokens.begin(), line.m_Tokens.begin() + uFirst + 1 );
+            }
+            else
+            {
+                line.m_Tokens.push_back( Token( TOKEN_NEWLINE, "\n" ) );
+            }
+
+            o_Lines.push_back( line );
+            line.m_bDirective = false;
+            line.m_Tokens.clear();
+            i++;
+            continue;
+        }
+
+        if( ( c == ' ' ) || ( c == '\t' ) || ( c == '\f' ) || ( c == '\v' ) )
+        {
+            if( line.m_Tokens.empty() || ( line.m_Tokens.back().m_Type != TOKEN_SPACE ) )
+            {
+                line.m_Tokens.push_back( Token( TOKEN_SPACE, " " ) );
+            }
+            i++;
+            continue;
+        }
+
+        if( ( c == '/' ) && ( i + 1 < text.size() ) && ( text[i + 1] == '/' ) )
+        {
+            while( text[i] != '\n' )
+            {
+                i++;
+            }
+            continue;
+        }
+
+        if( ( c == '/' ) && ( i + 1 < text.size() ) && ( text[i + 1] == '*' ) )
+        {
+            const size_t uEnd = text.find( "*/", i + 2 );
+            i = ( uEnd == std::string::npos ) ? text.size() - 1 : uEnd + 2;
+            if( line.m_Tokens.empty() || ( line.m_Tokens.back().m_Type != TOKEN_SPACE ) )
+            {
+                line.m_Tokens.push_back( Token( TOKEN_SPACE, " " ) );
+            }
+            continue;
+        }
+
+        if( IsIdentifierStart( c ) )
+        {
+            size_t uEnd = i + 1;
+            while( IsIdentifierChar( text[uEnd] ) )
+            {
+                uEnd++;
+            }
+            line.m_Tokens.push_back( Token( TOKEN_IDENTIFIER, text.substr( i, uEnd - i ) ) );
+            i = uEnd;
+            continue;
+        }
+
+        if( IsDigit( c ) || ( ( c == '.' ) && IsDigit( text[i + 1] ) ) )
+        {
+            size_t uEnd = i + 1;
+            for( ;; )
+            {
+                if( strchr( "eEpP", text[uEnd] ) && ( ( text[uEnd + 1] == '+' ) || ( text[uEnd + 1] == '-' ) ) )
+                {
+                    uEnd += 2;
+                }
+                else if( IsIdentifierChar( text[uEnd] ) || ( text[uEnd] == '.' ) )
+                {
+                    uEnd++;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            line.m_Tokens.push_back( Token( TOKEN_NUMBER, text.substr( i, uEnd - i ) ) );
+            i = uEnd;
+            continue;
+        }
+
+        if( ( c == '"' ) || ( c == '\'' ) )
+        {
+            size_t uEnd = i + 1;
+            while( ( text[uEnd] != c ) && ( text[uEnd] != '\n' ) )
+            {
+                uEnd += ( ( text[uEnd] == '\\' ) && ( text[uEnd + 1] != '\n' ) ) ? 2 : 1;
+            }
+            if( text[uEnd] == c )
+            {
+                uEnd++;
+            }
+            line.m_Tokens.push_back( Token( TOKEN_STRING, text.substr( i, uEnd - i ) ) );
+            i = uEnd;
+            continue;
+        }
+
+        bool bPunctuator = false;
+        for( size_t p = 0; p < sizeof( pPunctuators ) / sizeof( pPunctuators[0] ); p++ )
+        {
+            const size_t uLength = strlen( pPunctuators[p] );
+            if( 0 == text.compare( i, uLength, pPunctuators[p] ) )
+            {
+                line.m_Tokens.push_back( Token( TOKEN_PUNCTUATOR, pPunctuators[p] ) );
+                i += uLength;
+                bPunctuator = true;
+                break;
+            }
+        }
+        if( bPunctuator )
+        {
+            continue;
+        }
+
+        line.m_Tokens.push_back( Token( strchr( "!#%&()*+,-./:;<=>?[]^{|}~", c ) ? TOKEN_PUNCTUATOR : TOKEN_OTHER, std::string( 1, c ) ) );
+        i++;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Resolves an include relative to the directory of the including file, and normalizes the
+// result, so every file has one name in the cache regardless of how it was included
+//--------------------------------------------------------------------------------------
+std::wstring ShaderPreprocessor::ResolveInclude( const std::wstring& i_IncludingFile, const std::string& i_Name )
+{
+    std::wstring pathName = ToWide( i_Name );
+
+    const bool bAbsolute = ( !pathName.empty() && ( ( pathName[0] == L'\\' ) || ( pathName[0] == L'/' ) ) ) ||
+        ( ( pathName.size() > 1 ) && ( pathName[1] == L':' ) );
+    if( !bAbsolute )
+    {
+        const size_t uSeparator = i_IncludingFile.find_last_of( L"\\/" );
+        if( uSeparator != std::wstring::npos )
+        {
+            pathName = i_IncludingFile.substr( 0, uSeparator + 1 ) + pathName;
+        }
+    }
+
+    // Keep the root: a \\?\ long path prefix, the \\ of a UNC path, or a single separator
+    std::wstring root;
+#if !defined(_WIN32)
+    // POSIX has no long path prefix, the path after it is used as it is
+    if( 0 == pathName.compare( 0, 4, L"\\\\?\\" ) )
+    {
+        pathName.erase( 0, 4 );
+    }
+#endif
+    if( 0 == pathName.compare( 0, 4, L"\\\\?\\" ) )
+    {
+        root = pathName.substr( 0, 4 );
+    }
+    else
+    {
+        for( size_t i = 0; ( i < 2 ) && ( i < pathName.size() ) && ( ( pathName[i] == L'\\' ) || ( pathName[i] == L'/' ) ); i++ )
+        {
+            root += PATH_SEPARATOR;
+        }
+    }
+
+    // Split the rest into components, dropping "." and resolving ".." where possible
+    std::vector<std::wstring> components;
+    size_t uStart = root.size();
+    while( uStart <= pathName.size() )
+    {
+        size_t uEnd = pathName.find_first_of( L"\\/", uStart );
+        if( uEnd == std::wstring::npos )
+        {
+            uEnd = pathName.size();
+        }
+
+        const std::wstring component = pathName.substr( uStart, uEnd - uStart );
+        if( component == L".." )
+        {
+            if( !components.empty() && ( components.back() != L".." ) )
+            {
+                components.pop_back();
+            }
+            else
+            {
+                components.push_back( component );
+            }
+        }
+        else if( !component.empty() && ( component != L"." ) )
+        {
+            components.push_back( component );
+        }
+
+        uStart = uEnd + 1;
+    }
+
+    std::wstring normalized = root;
+    for( size_t i = 0; i < components.size(); i++ )
+    {
+        if( i > 0 )
+        {
+            normalized += PATH_SEPARATOR;
+        }
+        normalized += components[i];
+    }
+
+    return normalized;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Processes the lines of a file, text is collected until the next directive and then expanded
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::ProcessFile( Context& io_Context, const std::wstring& i_PathName, unsigned int uDepth )
+{
+    if( uDepth > m_uMAX_INCLUDE_DEPTH )
+    {
+        io_Context.m_Error = "#include nested too deeply: " + ToNarrow( i_PathName );
+        return false;
+    }
+
+    if( io_Context.m_OnceFiles.count( i_PathName ) )
+    {
+        return true;
+    }
+
+    const File* pFile = LoadFile( i_PathName );
+    if( !pFile->m_bExists )
+    {
+        io_Context.m_Error = "cannot open file: " + ToNarrow( i_PathName );
+        return false;
+    }
+
+    if( std::find( io_Context.m_Dependencies.begin(), io_Context.m_Dependencies.end(), i_PathName ) == io_Context.m_Dependencies.end() )
+    {
+        io_Context.m_Dependencies.push_back( i_PathName );
+    }
+
+    const size_t uConditionDepth = io_Context.m_Conditions.size();
+    TokenList pending;
+
+    for( size_t uLine = 0; uLine < pFile->m_Lines.size(); uLine++ )
+    {
+        const Line& line = pFile->m_Lines[uLine];
+
+        if( line.m_bDirective )
+        {
+            if( !Flush( io_Context, pending ) )
+            {
+                return false;
+            }
+
+            const size_t uName = SkipSpaces( line.m_Tokens, 0 );
+            const std::string directive = ( uName < line.m_Tokens.size() ) ? line.m_Tokens[uName].m_Text : std::string();
+            if( ( ( directive == "elif" ) || ( directive == "else" ) || ( directive == "endif" ) ) && ( io_Context.m_Conditions.size() <= uConditionDepth ) )
+            {
+                io_Context.m_Error = "#" + directive + " without #if in " + ToNarrow( i_PathName );
+                return false;
+            }
+
+            if( !ProcessDirective( io_Context, *pFile, line, uDepth ) )
+            {
+                if( !io_Context.m_bErrorLocated )
+                {
+                    io_Context.m_Error = ToNarrow( i_PathName ) + "(" + std::to_string( (unsigned long long)( uLine + 1 ) ) + "): " + io_Context.m_Error;
+                    io_Context.m_bErrorLocated = true;
+                }
+                return false;
+            }
+        }
+        else if( io_Context.IsActive() )
+        {
+            pending.insert( pending.end(), line.m_Tokens.begin(), line.m_Tokens.end() );
+        }
+    }
+
+    if( !Flush( io_Context, pending ) )
+    {
+        return false;
+    }
+
+    if( io_Context.m_Conditions.size() != uConditionDepth )
+    {
+        io_Context.m_Error = "unterminated #if in " + ToNarrow( i_PathName );
+        return false;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Handles one directive. Conditionals are tracked in inactive blocks too, everything else
+// only in active ones.
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::ProcessDirective( Context& io_Context, const File& i_File, const Line& i_Line, unsigned int uDepth )
+{
+    const TokenList& tokens = i_Line.m_Tokens;
+    const size_t uName = SkipSpaces( tokens, 0 );
+
+    // The null directive
+    if( uName >= tokens.size() )
+    {
+        return true;
+    }
+
+    const std::string& name = tokens[uName].m_Text;
+    const size_t uArguments = SkipSpaces( tokens, uName + 1 );
+
+    if( ( name == "if" ) || ( name == "ifdef" ) || ( name == "ifndef" ) )
+    {
+        Context::Condition condition;
+        condition.m_bParentActive = io_Context.IsActive();
+        condition.m_bSeenElse = false;
+        condition.m_bActive = false;
+        condition.m_bTaken = true;
+
+        if( condition.m_bParentActive )
+        {
+            bool bResult = false;
+            if( name == "if" )
+            {
+                if( !EvaluateCondition( io_Context, tokens, uArguments, bResult ) )
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                if( ( uArguments >= tokens.size() ) || ( tokens[uArguments].m_Type != TOKEN_IDENTIFIER ) )
+                {
+                    io_Context.m_Error = "#" + name + " without a macro name";
+                    return false;
+                }
+                bResult = ( io_Context.m_Macros.count( tokens[uArguments].m_Text ) != 0 ) == ( name == "ifdef" );
+            }
+
+            condition.m_bActive = bResult;
+            condition.m_bTaken = bResult;
+        }
+
+        io_Context.m_Conditions.push_back( condition );
+        return true;
+    }
+
+    if( name == "elif" )
+    {
+        Context::Condition& condition = io_Context.m_Conditions.back();
+        if( condition.m_bSeenElse )
+        {
+            io_Context.m_Error = "#elif after #else";
+            return false;
+        }
+
+        condition.m_bActive = false;
+        if( !condition.m_bTaken )
+        {
+            bool bResult = false;
+            if( !EvaluateCondition( io_Context, tokens, uArguments, bResult ) )
+            {
+                return false;
+            }
+            condition.m_bActive = bResult;
+            condition.m_bTaken = bResult;
+        }
+        return true;
+    }
+
+    if( name == "else" )
+    {
+        Context::Condition& condition = io_Context.m_Conditions.back();
+        if( condition.m_bSeenElse )
+        {
+            io_Context.m_Error = "#else after #else";
+            return false;
+        }
+
+        condition.m_bActive = !condition.m_bTaken;
+        condition.m_bTaken = true;
+        condition.m_bSeenElse = true;
+        return true;
+    }
+
+    if( name == "endif" )
+    {
+        io_Context.m_Conditions.pop_back();
+        return true;
+    }
+
+    if( !io_Context.IsActive() )
+    {
+        return true;
+    }
+
+    if( name == "include" )
+    {
+        std::string include;
+        if( ( uArguments < tokens.size() ) && ( tokens[uArguments].m_Type == TOKEN_STRING ) && ( tokens[uArguments].m_Text[0] == '"' ) )
+        {
+            include = tokens[uArguments].m_Text.substr( 1, tokens[uArguments].m_Text.size() - 2 );
+        }
+        else if( ( uArguments < tokens.size() ) && tokens[uArguments].Is( "<" ) )
+        {
+            size_t i = uArguments + 1;
+            for( ; ( i < tokens.size() ) && !tokens[i].Is( ">" ); i++ )
+            {
+                include += tokens[i].m_Text;
+            }
+            if( i == tokens.size() )
+            {
+                io_Context.m_Error = "#include expects \"FILENAME\" or <FILENAME>";
+                return false;
+            }
+        }
+        else
+        {
+            io_Context.m_Error = "#include expects \"FILENAME\" or <FILENAME>";
+            return false;
+        }
+
+        return ProcessFile( io_Context, ResolveInclude( i_File.m_PathName, include ), uDepth + 1 );
+    }
+
+    if( name == "define" )
+    {
+        return DefineMacro( io_Context, tokens, uArguments );
+    }
+
+    if( name == "undef" )
+    {
+        if( ( uArguments >= tokens.size() ) || ( tokens[uArguments].m_Type != TOKEN_IDENTIFIER ) )
+        {
+            io_Context.m_Error = "#undef without a macro name";
+            return false;
+        }
+        io_Context.m_Macros.erase( tokens[uArguments].m_Text );
+        return true;
+    }
+
+    if( name == "pragma" )
+    {
+        if( ( uArguments < tokens.size() ) && ( tokens[uArguments].m_Text == "once" ) )
+        {
+            io_Context.m_OnceFiles.insert( i_File.m_PathName );
+            return true;
+        }
+
+        // Pragmas affect compilation, so they are part of the output
+        TokenList pragma( tokens.begin() + uName, tokens.end() );
+        pragma.insert( pragma.begin(), Token( TOKEN_PUNCTUATOR, "#" ) );
+        pragma.push_back( Token( TOKEN_NEWLINE, "\n" ) );
+        Emit( pragma, io_Context.m_Output );
+        return true;
+    }
+
+    if( name == "line" )
+    {
+        return true;
+    }
+
+    if( name == "error" )
+    {
+        std::string message;
+        Emit( TokenList( tokens.begin() + uArguments, tokens.end() ), message );
+        io_Context.m_Error = "#error " + message.substr( 0, message.find_last_not_of( '\n' ) + 1 );
+        return false;
+    }
+
+    io_Context.m_Error = "unsupported directive #" + name;
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Parses "NAME BODY" or "NAME(PARAMETERS) BODY"
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::DefineMacro( Context& io_Context, const TokenList& i_Tokens, size_t uStart )
+{
+    uStart = SkipSpaces( i_Tokens, uStart );
+    if( ( uStart >= i_Tokens.size() ) || ( i_Tokens[uStart].m_Type != TOKEN_IDENTIFIER ) )
+    {
+        io_Context.m_Error = "#define without a macro name";
+        return false;
+    }
+
+    const std::string& name = i_Tokens[uStart].m_Text;
+    Macro macro;
+    macro.m_bFunctionLike = false;
+    macro.m_bVariadic = false;
+
+    size_t i = uStart + 1;
+
+    // A '(' right after the name, without space, makes the macro function-like
+    if( ( i < i_Tokens.size() ) && i_Tokens[i].Is( "(" ) )
+    {
+        macro.m_bFunctionLike = true;
+        i = SkipSpaces( i_Tokens, i + 1 );
+        while( ( i < i_Tokens.size() ) && !i_Tokens[i].Is( ")" ) )
+        {
+            if( i_Tokens[i].Is( "..." ) )
+            {
+                macro.m_bVariadic = true;
+                macro.m_Parameters.push_back( "__VA_ARGS__" );
+            }
+            else if( i_Tokens[i].m_Type == TOKEN_IDENTIFIER )
+            {
+                macro.m_Parameters.push_back( i_Tokens[i].m_Text );
+            }
+            else
+            {
+                io_Context.m_Error = "invalid parameter list for macro " + name;
+                return false;
+            }
+
+            i = SkipSpaces( i_Tokens, i + 1 );
+            if( ( i < i_Tokens.size() ) && i_Tokens[i].Is( "," ) && !macro.m_bVariadic )
+            {
+                i = SkipSpaces( i_Tokens, i + 1 );
+            }
+            else if( ( i >= i_Tokens.size() ) || !i_Tokens[i].Is( ")" ) )
+            {
+                io_Context.m_Error = "invalid parameter list for macro " + name;
+                return false;
+            }
+        }
+
+        if( i >= i_Tokens.size() )
+        {
+            io_Context.m_Error = "invalid parameter list for macro " + name;
+            return false;
+        }
+        i++;
+    }
+
+    // The body, without leading and trailing space
+    i = SkipSpaces( i_Tokens, i );
+    size_t uEnd = i_Tokens.size();
+    while( ( uEnd > i ) && i_Tokens[uEnd - 1].IsSpace() )
+    {
+        uEnd--;
+    }
+    macro.m_Body.assign( i_Tokens.begin() + i, i_Tokens.begin() + uEnd );
+
+    if( !macro.m_Body.empty() && ( macro.m_Body.front().Is( "##" ) || macro.m_Body.back().Is( "##" ) ) )
+    {
+        io_Context.m_Error = "'##' cannot appear at either end of macro " + name;
+        return false;
+    }
+
+    io_Context.m_Macros[name] = macro;
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Evaluates the expression of an #if or #elif
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::EvaluateCondition( Context& io_Context, const TokenList& i_Tokens, size_t uStart, bool& o_bResult )
+{
+    // defined X and defined( X ) are replaced before expansion
+    TokenQueue input;
+    for( size_t i = uStart; i < i_Tokens.size(); i++ )
+    {
+        if( ( i_Tokens[i].m_Type == TOKEN_IDENTIFIER ) && ( i_Tokens[i].m_Text == "defined" ) )
+        {
+            size_t j = SkipSpaces( i_Tokens, i + 1 );
+            const bool bParenthesis = ( j < i_Tokens.size() ) && i_Tokens[j].Is( "(" );
+            if( bParenthesis )
+            {
+                j = SkipSpaces( i_Tokens, j + 1 );
+            }
+            if( ( j >= i_Tokens.size() ) || ( i_Tokens[j].m_Type != TOKEN_IDENTIFIER ) )
+            {
+                io_Context.m_Error = "'defined' without a macro name";
+                return false;
+            }
+            const bool bDefined = ( io_Context.m_Macros.count( i_Tokens[j].m_Text ) != 0 );
+            if( bParenthesis )
+            {
+                j = SkipSpaces( i_Tokens, j + 1 );
+                if( ( j >= i_Tokens.size() ) || !i_Tokens[j].Is( ")" ) )
+                {
+                    io_Context.m_Error = "missing ')' after 'defined'";
+                    return false;
+                }
+            }
+            input.push_back( Token( TOKEN_NUMBER, bDefined ? "1" : "0" ) );
+            i = j;
+            continue;
+        }
+        input.push_back( i_Tokens[i] );
+    }
+
+    TokenList expanded;
+    if( !Expand( io_Context, input, expanded ) )
+    {
+        return false;
+    }
+
+    TokenList expression;
+    for( size_t i = 0; i < expanded.size(); i++ )
+    {
+        if( !expanded[i].IsSpace() && ( expanded[i].m_Type != TOKEN_PLACEMARKER ) )
+        {
+            expression.push_back( expanded[i] );
+        }
+    }
+
+    long long iValue = 0;
+    ExpressionParser parser( expression );
+    if( expression.empty() || !parser.Evaluate( iValue ) )
+    {
+        std::string text;
+        Emit( expression, text );
+        io_Context.m_Error = "invalid #if expression: " + text.substr( 0, text.find_last_not_of( '\n' ) + 1 );
+        return false;
+    }
+
+    o_bResult = ( iValue != 0 );
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Expands macros until none are left. The expansion of a macro is put back in front of the
+// input, so it is rescanned together with the tokens that follow it.
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::Expand( Context& io_Context, TokenQueue& io_Input, TokenList& o_Output )
+{
+    while( !io_Input.empty() )
+    {
+        Token token = io_Input.front();
+        io_Input.pop_front();
+
+        std::map<std::string, Macro>::const_iterator it;
+        if( ( token.m_Type != TOKEN_IDENTIFIER ) || InHideSet( token.m_HideSet, token.m_Text ) ||
+            ( ( it = io_Context.m_Macros.find( token.m_Text ) ) == io_Context.m_Macros.end() ) )
+        {
+            o_Output.push_back( token );
+            continue;
+        }
+
+        const Macro& macro = it->second;
+        std::vector<std::string> hideSet( 1, token.m_Text );
+        std::vector<TokenList> arguments;
+
+        if( macro.m_bFunctionLike )
+        {
+            // Without a '(' a function-like macro name is just an identifier
+            size_t i = 0;
+            while( ( i < io_Input.size() ) && io_Input[i].IsSpace() )
+            {
+                i++;
+            }
+            if( ( i >= io_Input.size() ) || !io_Input[i].Is( "(" ) )
+            {
+                o_Output.push_back( token );
+                continue;
+            }
+
+            // Split the arguments at top level commas
+            int iDepth = 0;
+            arguments.push_back( TokenList() );
+            for( i = i + 1; i < io_Input.size(); i++ )
+            {
+                const Token& argument = io_Input[i];
+                if( argument.Is( ")" ) && ( 0 == iDepth ) )
+                {
+                    break;
+                }
+                if( argument.Is( "(" ) )
+                {
+                    iDepth++;
+                }
+                else if( argument.Is( ")" ) )
+                {
+                    iDepth--;
+                }
+                else if( argument.Is( "," ) && ( 0 == iDepth ) && !( macro.m_bVariadic && ( arguments.size() == macro.m_Parameters.size() ) ) )
+                {
+                    arguments.push_back( TokenList() );
+                    continue;
+                }
+
+                if( argument.IsSpace() )
+                {
+                    if( !arguments.back().empty() && ( arguments.back().back().m_Type != TOKEN_SPACE ) )
+                    {
+                        arguments.back().push_back( Token( TOKEN_SPACE, " " ) );
+                    }
+                }
+                else
+                {
+                    arguments.back().push_back( argument );
+                }
+            }
+
+            if( i >= io_Input.size() )
+            {
+                io_Context.m_Error = "unterminated invocation of macro " + token.m_Text;
+                return false;
+            }
+
+            // The hide set of the expansion is the intersection of the name's and the ')''s, plus the name
+            const std::vector<std::string>& closingHideSet = io_Input[i].m_HideSet;
+            std::vector<std::string> intersection;
+            std::set_intersection( token.m_HideSet.begin(), token.m_HideSet.end(), closingHideSet.begin(), closingHideSet.end(), std::back_inserter( intersection ) );
+            AddToHideSet( hideSet, intersection );
+
+            io_Input.erase( io_Input.begin(), io_Input.begin() + i + 1 );
+
+            for( size_t a = 0; a < arguments.size(); a++ )
+            {
+                while( !arguments[a].empty() && ( arguments[a].back().m_Type == TOKEN_SPACE ) )
+                {
+                    arguments[a].pop_back();
+                }
+            }
+
+            if( macro.m_Parameters.empty() && ( arguments.size() == 1 ) && arguments[0].empty() )
+            {
+                arguments.clear();
+            }
+            if( macro.m_bVariadic && ( arguments.size() + 1 == macro.m_Parameters.size() ) )
+            {
+                arguments.push_back( TokenList() );
+            }
+            if( arguments.size() != macro.m_Parameters.size() )
+            {
+                io_Context.m_Error = "wrong number of arguments for macro " + token.m_Text;
+                return false;
+            }
+        }
+        else
+        {
+            AddToHideSet( hideSet, token.m_HideSet );
+        }
+
+        TokenList expansion;
+        if( !Substitute( io_Context, macro, arguments, hideSet, expansion ) )
+        {
+            return false;
+        }
+
+        io_Input.insert( io_Input.begin(), expansion.begin(), expansion.end() );
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Replaces the parameters in a macro body: # stringizes an argument, ## pastes tokens
+// together, other arguments are fully expanded first
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::Substitute( Context& io_Context, const Macro& i_Macro, const std::vector<TokenList>& i_Arguments,
+    const std::vector<std::string>& i_HideSet, TokenList& o_Output )
+{
+    const TokenList& body = i_Macro.m_Body;
+
+    o_Output.clear();
+
+    for( size_t i = 0; i < body.size(); i++ )
+    {
+        const Token& token = body[i];
+
+        int iParameter = -1;
+        if( token.m_Type == TOKEN_IDENTIFIER )
+        {
+            std::vector<std::string>::const_iterator it = std::find( i_Macro.m_Parameters.begin(), i_Macro.m_Parameters.end(), token.m_Text );
+            iParameter = ( it == i_Macro.m_Parameters.end() ) ? -1 : (int)( it - i_Macro.m_Parameters.begin() );
+        }
+
+        if( token.Is( "#" ) && i_Macro.m_bFunctionLike )
+        {
+            const size_t j = SkipSpaces( body, i + 1 );
+            std::vector<std::string>::const_iterator it = ( j < body.size() ) ? std::find( i_Macro.m_Parameters.begin(), i_Macro.m_Parameters.end(), body[j].m_Text ) : i_Macro.m_Parameters.end();
+            if( it == i_Macro.m_Parameters.end() )
+            {
+                io_Context.m_Error = "'#' is not followed by a macro parameter";
+                return false;
+            }
+
+            std::string text = "\"";
+            const TokenList& argument = i_Arguments[it - i_Macro.m_Parameters.begin()];
+            for( size_t a = 0; a < argument.size(); a++ )
+            {
+                for( size_t c = 0; c < argument[a].m_Text.size(); c++ )
+                {
+                    const char character = argument[a].m_Text[c];
+                    if( ( argument[a].m_Type == TOKEN_STRING ) && ( ( character == '"' ) || ( character == '\\' ) ) )
+                    {
+                        text += '\\';
+                    }
+                    text += character;
+                }
+            }
+            text += "\"";
+
+            o_Output.push_back( Token( TOKEN_STRING, text ) );
+            i = j;
+            continue;
+        }
+
+        if( token.Is( "##" ) )
+        {
+            while( !o_Output.empty() && ( o_Output.back().m_Type == TOKEN_SPACE ) )
+            {
+                o_Output.pop_back();
+            }
+
+            const size_t j = SkipSpaces( body, i + 1 );
+            std::vector<std::string>::const_iterator it = std::find( i_Macro.m_Parameters.begin(), i_Macro.m_Parameters.end(), body[j].m_Text );
+            TokenList right;
+            if( ( body[j].m_Type == TOKEN_IDENTIFIER ) && ( it != i_Macro.m_Parameters.end() ) )
+            {
+                right = i_Arguments[it - i_Macro.m_Parameters.begin()];
+            }
+            else
+            {
+                right.push_back( body[j] );
+            }
+            i = j;
+
+            Token left( TOKEN_PLACEMARKER, "" );
+            if( !o_Output.empty() )
+            {
+                left = o_Output.back();
+                o_Output.pop_back();
+            }
+
+            if( right.empty() )
+            {
+                o_Output.push_back( left );
+                continue;
+            }
+
+            // Paste the spellings and retokenize the result
+            std::vector<Line> pasted;
+            Tokenize( left.m_Text + right[0].m_Text, pasted );
+            for( size_t p = 0; p < pasted[0].m_Tokens.size(); p++ )
+            {
+                if( pasted[0].m_Tokens[p].m_Type != TOKEN_NEWLINE )
+                {
+                    o_Output.push_back( pasted[0].m_Tokens[p] );
+                }
+            }
+            o_Output.insert( o_Output.end(), right.begin() + 1, right.end() );
+            continue;
+        }
+
+        if( iParameter >= 0 )
+        {
+            const TokenList& argument = i_Arguments[iParameter];
+            const size_t j = SkipSpaces( body, i + 1 );
+            if( ( j < body.size() ) && body[j].Is( "##" ) )
+            {
+                // An operand of ## is not expanded
+                if( argument.empty() )
+                {
+                    o_Output.push_back( Token( TOKEN_PLACEMARKER, "" ) );
+                }
+                o_Output.insert( o_Output.end(), argument.begin(), argument.end() );
+            }
+            else
+            {
+                TokenQueue input( argument.begin(), argument.end() );
+                TokenList expanded;
+                if( !Expand( io_Context, input, expanded ) )
+                {
+                    return false;
+                }
+                o_Output.insert( o_Output.end(), expanded.begin(), expanded.end() );
+            }
+            continue;
+        }
+
+        o_Output.push_back( token );
+    }
+
+    TokenList output;
+    output.reserve( o_Output.size() );
+    for( size_t i = 0; i < o_Output.size(); i++ )
+    {
+        if( o_Output[i].m_Type != TOKEN_PLACEMARKER )
+        {
+            output.push_back( o_Output[i] );
+            AddToHideSet( output.back().m_HideSet, i_HideSet );
+        }
+    }
+    o_Output.swap( output );
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Expands the text collected since the last directive and appends it to the output
+//--------------------------------------------------------------------------------------
+bool ShaderPreprocessor::Flush( Context& io_Context, TokenList& io_Pending )
+{
+    if( io_Pending.empty() )
+    {
+        return true;
+    }
+
+    TokenQueue input( io_Pending.begin(), io_Pending.end() );
+    io_Pending.clear();
+
+    TokenList expanded;
+    if( !Expand( io_Context, input, expanded ) )
+    {
+        return false;
+    }
+
+    Emit( expanded, io_Context.m_Output );
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Appends tokens as normalized text: one space between tokens where the source had space,
+// or where the tokens would otherwise run together, and no empty lines
+//--------------------------------------------------------------------------------------
+void ShaderPreprocessor::Emit( const TokenList& i_Tokens, std::string& io_Output )
+{
+    bool bLineHasTokens = false;
+    bool bPendingSpace = false;
+    TOKEN_TYPE PreviousType = TOKEN_SPACE;
+
+    for( size_t i = 0; i < i_Tokens.size(); i++ )
+    {
+        const Token& token = i_Tokens[i];
+
+        if( token.m_Type == TOKEN_NEWLINE )
+        {
+            if( bLineHasTokens )
+            {
+                io_Output += '\n';
+            }
+            bLineHasTokens = false;
+            bPendingSpace = false;
+            continue;
+        }
+
+        if( token.m_Type == TOKEN_SPACE )
+        {
+            bPendingSpace = bLineHasTokens;
+            continue;
+        }
+
+        if( token.m_Type == TOKEN_PLACEMARKER )
+        {
+            continue;
+        }
+
+        const bool bWord = ( token.m_Type == TOKEN_IDENTIFIER ) || ( token.m_Type == TOKEN_NUMBER );
+        const bool bPreviousWord = ( PreviousType == TOKEN_IDENTIFIER ) || ( PreviousType == TOKEN_NUMBER );
+        if( bLineHasTokens && ( bPendingSpace || ( bWord && bPreviousWord ) || ( ( token.m_Type == TOKEN_PUNCTUATOR ) && ( PreviousType == TOKEN_PUNCTUATOR ) ) ) )
+        {
+            io_Output += ' ';
+        }
+
+        io_Output += token.m_Text;
+        bLineHasTokens = true;
+        bPendingSpace = false;
+        PreviousType = token.m_Type;
+    }
+
+    if( bLineHasTokens )
+    {
+        io_Output += '\n';
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Returns the index of the first token at or after uIndex that is not space
+//--------------------------------------------------------------------------------------
+size_t ShaderPreprocessor::SkipSpaces( const TokenList& i_Tokens, size_t uIndex )
+{
+    while( ( uIndex < i_Tokens.size() ) && i_Tokens[uIndex].IsSpace() )
+    {
+        uIndex++;
+    }
+
+    return uIndex;
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderPreprocessor.h
+//
+// Class definition for the ShaderPreprocessor interface. An in-process C preprocessor for HLSL,
+// so the ShaderCache can hash a shader permutation without launching fxc /P for it.
+//
+// Supports #include (resolved relative to the including file, like fxc does, and without case
+// as on Windows), #pragma once, #define / #undef with object-like, function-like and variadic
+// macros including # and ##, #if / #ifdef / #ifndef / #elif / #else / #endif with full integer
+// expressions, and passes #pragma through. Included files are read and tokenized once, and
+// shared by all permutations until ClearCache() is called.
+//
+// The output is a normalized token stream (one line per source line that produced tokens,
+// single spaces between tokens, no comments or #line directives). It is meant for hashing and
+// dependency tracking, not for feeding the compiler. Anything the preprocessor does not handle
+// (e.g. #error in an active block, or an include it cannot find) makes Preprocess() fail, so the
+// caller can fall back to fxc.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace AMD
+{
+
+    class ShaderPreprocessor
+    {
+    public:
+
+        static const unsigned int m_uMAX_INCLUDE_DEPTH = 64;
+
+        // Construction / destruction
+        ShaderPreprocessor();
+        ~ShaderPreprocessor();
+
+        // Preprocesses a source file, ppDefines are /D style "NAME=VALUE" or "NAME" strings.
+        // o_pDependencies receives the source file and every file it included.
+        bool Preprocess( const wchar_t* pwsSourceFile, const char* const* ppDefines, unsigned int uNumDefines,
+            std::string& o_Output, std::vector<std::wstring>* o_pDependencies = NULL );
+
+        // Forgets the cached files, call this when sources may have changed
+        void ClearCache();
+
+        // Describes why the last Preprocess() failed
+        const char* GetLastError() const;
+
+    private:
+
+        struct Token;
+        struct Line;
+        struct File;
+        struct Macro;
+        struct Context;
+        class ExpressionParser;
+
+        typedef std::vector<Token> TokenList;
+        typedef std::deque<Token> TokenQueue;
+
+        // File handling
+        const File* LoadFile( const std::wstring& i_PathName );
+        static void Tokenize( const std::string& i_Text, std::vector<Line>& o_Lines );
+        static std::wstring ResolveInclude( const std::wstring& i_IncludingFile, const std::string& i_Name );
+
+        // Directive handling
+        bool ProcessFile( Context& io_Context, const std::wstring& i_PathName, unsigned int uDepth );
+        bool ProcessDirective( Context& io_Context, const File& i_File, const Line& i_Line, unsigned int uDepth );
+        bool DefineMacro( Context& io_Context, const TokenList& i_Tokens, size_t uStart );
+        bool EvaluateCondition( Context& io_Context, const TokenList& i_Tokens, size_t uStart, bool& o_bResult );
+
+        // Macro expansion
+        bool Expand( Context& io_Context, TokenQueue& io_Input, TokenList& o_Output );
+        bool Substitute( Context& io_Context, const Macro& i_Macro, const std::vector<TokenList>& i_Arguments,
+            const std::vector<std::string>& i_HideSet, TokenList& o_Output );
+        bool Flush( Context& io_Context, TokenList& io_Pending );
+        static void Emit( const TokenList& i_Tokens, std::string& io_Output );
+        static size_t SkipSpaces( const TokenList& i_Tokens, size_t uIndex );
+
+        // Private data
+        std::map<std::wstring, File*>   m_Files;
+        std::string                     m_LastError;
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
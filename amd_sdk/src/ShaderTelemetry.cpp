@@ -0,0 +1,358 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderTelemetry.cpp
+//
+// Class implementation for the ShaderTelemetry interface.
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <string>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "ShaderTelemetry.h"
+
+using namespace AMD;
+
+
+static const char* s_pCacheResultNames[ShaderTelemetry::CACHE_RESULT_MAX] =
+{
+    "none",
+    "hit",
+    "hit_unchecked",
+    "hit_shared",
+    "miss_changed",
+    "miss_no_object",
+    "miss_source_not_found",
+};
+
+
+//--------------------------------------------------------------------------------------
+// Clears a record, keeping its strings
+//--------------------------------------------------------------------------------------
+void ShaderTelemetry::Record::Reset()
+{
+    m_eCacheResult = CACHE_RESULT_NONE;
+    m_bPreprocessedInProcess = false;
+    m_bCompiled = false;
+    m_uPreprocessBatch = 0;
+    m_uCompileBatch = 0;
+    m_fPreprocessMs = 0.0;
+    m_fHashMs = 0.0;
+    m_fCompileMs = 0.0;
+    m_uObjectSize = 0;
+    m_uNumErrors = 0;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Summarizes an array of records
+//--------------------------------------------------------------------------------------
+void ShaderTelemetry::Summarize( const Record* pRecords, unsigned int uNumRecords, Summary& o_Summary )
+{
+    memset( &o_Summary, 0, sizeof( o_Summary ) );
+    o_Summary.m_uNumShaders = uNumRecords;
+
+    // Slowest time of each batch, batches run one after the other
+    std::vector<double> preprocessBatches;
+    std::vector<double> compileBatches;
+
+    for( unsigned int i = 0; i < uNumRecords; i++ )
+    {
+        const Record& record = pRecords[i];
+
+        o_Summary.m_uNumResults[record.m_eCacheResult]++;
+        o_Summary.m_uNumHits += IsHit( record.m_eCacheResult ) ? 1 : 0;
+        o_Summary.m_uNumMisses += IsMiss( record.m_eCacheResult ) ? 1 : 0;
+        o_Summary.m_uNumCompiled += record.m_bCompiled ? 1 : 0;
+        o_Summary.m_uNumWithErrors += ( record.m_uNumErrors > 0 ) ? 1 : 0;
+        o_Summary.m_fTotalPreprocessMs += record.m_fPreprocessMs;
+        o_Summary.m_fTotalHashMs += record.m_fHashMs;
+        o_Summary.m_fTotalCompileMs += record.m_fCompileMs;
+        o_Summary.m_uTotalObjectSize += record.m_uObjectSize;
+
+        if( record.m_uPreprocessBatch > 0 )
+        {
+            if( preprocessBatches.size() < record.m_uPreprocessBatch )
+            {
+                preprocessBatches.resize( record.m_uPreprocessBatch, 0.0 );
+            }
+            double& fBatch = preprocessBatches[record.m_uPreprocessBatch - 1];
+            fBatch = std::max( fBatch, record.m_fPreprocessMs + record.m_fHashMs );
+        }
+
+        if( record.m_uCompileBatch > 0 )
+        {
+            if( compileBatches.size() < record.m_uCompileBatch )
+            {
+                compileBatches.resize( record.m_uCompileBatch, 0.0 );
+            }
+            double& fBatch = compileBatches[record.m_uCompileBatch - 1];
+            fBatch = std::max( fBatch, record.m_fCompileMs );
+        }
+
+        // Keep the slowest shaders sorted, slowest first
+        const double fTotalMs = record.GetTotalMs();
+        if( fTotalMs > 0.0 )
+        {
+            unsigned int uSlot = o_Summary.m_uNumSlowest;
+            while( uSlot > 0 && pRecords[o_Summary.m_uSlowest[uSlot - 1]].GetTotalMs() < fTotalMs )
+            {
+                if( uSlot < m_uNUM_SLOWEST )
+                {
+                    o_Summary.m_uSlowest[uSlot] = o_Summary.m_uSlowest[uSlot - 1];
+                }
+                uSlot--;
+            }
+            if( uSlot < m_uNUM_SLOWEST )
+            {
+                o_Summary.m_uSlowest[uSlot] = i;
+                if( o_Summary.m_uNumSlowest < m_uNUM_SLOWEST )
+                {
+                    o_Summary.m_uNumSlowest++;
+                }
+            }
+        }
+    }
+
+    const unsigned int uNumChecked = o_Summary.m_uNumHits + o_Summary.m_uNumMisses;
+    o_Summary.m_fHitRate = ( uNumChecked > 0 ) ? (double)o_Summary.m_uNumHits / uNumChecked : 1.0;
+
+    for( size_t i = 0; i < preprocessBatches.size(); i++ )
+    {
+        o_Summary.m_fCriticalPathMs += preprocessBatches[i];
+    }
+    for( size_t i = 0; i < compileBatches.size(); i++ )
+    {
+        o_Summary.m_fCriticalPathMs += compileBatches[i];
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Writes the records and their summary to a JSON Lines file
+//--------------------------------------------------------------------------------------
+bool ShaderTelemetry::Write( const wchar_t* pwsPathName, const Record* pRecords, unsigned int uNumRecords, const Summary& i_Summary )
+{
+    FILE* pFile = NULL;
+
+#if defined(_WIN32)
+    _wfopen_s( &pFile, pwsPathName, L"wb" );
+#else
+    // ShaderCache passes a Windows path, with a \\?\ prefix and backslashes
+    std::wstring posixPathName( pwsPathName );
+    if( 0 == posixPathName.compare( 0, 4, L"\\\\?\\" ) )
+    {
+        posixPathName.erase( 0, 4 );
+    }
+    std::replace( posixPathName.begin(), posixPathName.end(), L'\\', L'/' );
+
+    std::vector<char> pathName( posixPathName.size() * MB_CUR_MAX + 1 );
+    if( wcstombs( &pathName[0], posixPathName.c_str(), pathName.size() ) != (size_t)-1 )
+    {
+        pFile = fopen( &pathName[0], "wb" );
+    }
+#endif
+
+    if( !pFile )
+    {
+        return false;
+    }
+
+    Write( pFile, pRecords, uNumRecords, i_Summary );
+
+    const bool bWritten = ( 0 == ferror( pFile ) );
+    fclose( pFile );
+
+    return bWritten;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Writes the records and their summary as JSON Lines
+//--------------------------------------------------------------------------------------
+void ShaderTelemetry::Write( FILE* pFile, const Record* pRecords, unsigned int uNumRecords, const Summary& i_Summary )
+{
+    for( unsigned int i = 0; i < uNumRecords; i++ )
+    {
+        const Record& record = pRecords[i];
+
+        fputs( "{\"type\":\"shader\",\"name\":", pFile );
+        WriteString( pFile, record.m_wsName );
+        fputs( ",\"source\":", pFile );
+        WriteString( pFile, record.m_wsSourceFile );
+        fprintf( pFile, ",\"cache\":\"%s\",\"in_process_preprocess\":%s,\"compiled\":%s"
+            ",\"preprocess_batch\":%u,\"compile_batch\":%u"
+            ",\"preprocess_ms\":%.3f,\"hash_ms\":%.3f,\"compile_ms\":%.3f"
+            ",\"object_size\":%u,\"errors\":%u}\n",
+            GetCacheResultName( record.m_eCacheResult ),
+            record.m_bPreprocessedInProcess ? "true" : "false",
+            record.m_bCompiled ? "true" : "false",
+            record.m_uPreprocessBatch, record.m_uCompileBatch,
+            record.m_fPreprocessMs, record.m_fHashMs, record.m_fCompileMs,
+            record.m_uObjectSize, record.m_uNumErrors );
+    }
+
+    fprintf( pFile, "{\"type\":\"summary\",\"shaders\":%u,\"hits\":%u,\"misses\":%u,\"hit_rate\":%.4f"
+        ",\"compiled\":%u,\"with_errors\":%u"
+        ",\"preprocess_ms\":%.3f,\"hash_ms\":%.3f,\"compile_ms\":%.3f,\"critical_path_ms\":%.3f"
+        ",\"object_size\":%llu,\"results\":{",
+        i_Summary.m_uNumShaders, i_Summary.m_uNumHits, i_Summary.m_uNumMisses, i_Summary.m_fHitRate,
+        i_Summary.m_uNumCompiled, i_Summary.m_uNumWithErrors,
+        i_Summary.m_fTotalPreprocessMs, i_Summary.m_fTotalHashMs, i_Summary.m_fTotalCompileMs, i_Summary.m_fCriticalPathMs,
+        i_Summary.m_uTotalObjectSize );
+
+    for( int iResult = 0; iResult < CACHE_RESULT_MAX; iResult++ )
+    {
+        fprintf( pFile, "%s\"%s\":%u", ( iResult > 0 ) ? "," : "", GetCacheResultName( (CACHE_RESULT)iResult ), i_Summary.m_uNumResults[iResult] );
+    }
+
+    fputs( "},\"slowest\":[", pFile );
+
+    for( unsigned int i = 0; i < i_Summary.m_uNumSlowest; i++ )
+    {
+        const Record& record = pRecords[i_Summary.m_uSlowest[i]];
+
+        fputs( ( i > 0 ) ? ",{\"name\":" : "{\"name\":", pFile );
+        WriteString( pFile, record.m_wsName );
+        fprintf( pFile, ",\"total_ms\":%.3f}", record.GetTotalMs() );
+    }
+
+    fputs( "]}\n", pFile );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Name of a cache result
+//--------------------------------------------------------------------------------------
+const char* ShaderTelemetry::GetCacheResultName( CACHE_RESULT eCacheResult )
+{
+    assert( eCacheResult >= CACHE_RESULT_NONE && eCacheResult < CACHE_RESULT_MAX );
+
+    return s_pCacheResultNames[eCacheResult];
+}
+
+
+//--------------------------------------------------------------------------------------
+// Milliseconds on a monotonic clock
+//--------------------------------------------------------------------------------------
+double ShaderTelemetry::GetTimeMs()
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER s_Frequency = { 0 };
+    if( 0 == s_Frequency.QuadPart )
+    {
+        QueryPerformanceFrequency( &s_Frequency );
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter( &counter );
+
+    return (double)counter.QuadPart * 1000.0 / (double)s_Frequency.QuadPart;
+#else
+    return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------
+// Cache result classification
+//--------------------------------------------------------------------------------------
+bool ShaderTelemetry::IsHit( CACHE_RESULT eCacheResult )
+{
+    return ( eCacheResult == CACHE_RESULT_HIT ) || ( eCacheResult == CACHE_RESULT_HIT_UNCHECKED ) || ( eCacheResult == CACHE_RESULT_HIT_SHARED );
+}
+
+bool ShaderTelemetry::IsMiss( CACHE_RESULT eCacheResult )
+{
+    return ( eCacheResult == CACHE_RESULT_MISS_CHANGED ) || ( eCacheResult == CACHE_RESULT_MISS_NO_OBJECT );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Writes a JSON string, as UTF-8
+//--------------------------------------------------------------------------------------
+void ShaderTelemetry::WriteString( FILE* pFile, const wchar_t* pwsString )
+{
+    fputc( '"', pFile );
+
+    for( const wchar_t* pChar = pwsString ? pwsString : L""; *pChar; pChar++ )
+    {
+        unsigned int uChar = (unsigned int)*pChar;
+
+        if( uChar == '"' || uChar == '\\' )
+        {
+            fputc( '\\', pFile );
+            fputc( (int)uChar, pFile );
+        }
+        else if( uChar < 0x20 )
+        {
+            fprintf( pFile, "\\u%04x", uChar );
+        }
+        else if( uChar < 0x80 )
+        {
+            fputc( (int)uChar, pFile );
+        }
+        else if( uChar < 0x800 )
+        {
+            fputc( (int)( 0xC0 | ( uChar >> 6 ) ), pFile );
+            fputc( (int)( 0x80 | ( uChar & 0x3F ) ), pFile );
+        }
+        else if( uChar >= 0xD800 && uChar <= 0xDFFF )
+        {
+            // UTF-16 surrogates (wchar_t is 16 bit on Windows), JSON escapes them as is
+            fprintf( pFile, "\\u%04x", uChar );
+        }
+        else if( uChar < 0x10000 )
+        {
+            fputc( (int)( 0xE0 | ( uChar >> 12 ) ), pFile );
+            fputc( (int)( 0x80 | ( ( uChar >> 6 ) & 0x3F ) ), pFile );
+            fputc( (int)( 0x80 | ( uChar & 0x3F ) ), pFile );
+        }
+        else
+        {
+            fputc( (int)( 0xF0 | ( uChar >> 18 ) ), pFile );
+            fputc( (int)( 0x80 | ( ( uChar >> 12 ) & 0x3F ) ), pFile );
+            fputc( (int)( 0x80 | ( ( uChar >> 6 ) & 0x3F ) ), pFile );
+            fputc( (int)( 0x80 | ( uChar & 0x3F ) ), pFile );
+        }
+    }
+
+    fputc( '"', pFile );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderTelemetry.h
+//
+// Class definition for the ShaderTelemetry interface. Holds the per-shader build telemetry
+// the ShaderCache records while generating shaders (preprocess, hash and compile times, cache
+// hit or miss reason, object size, error count), summarizes it, and writes it out as JSON Lines:
+// one {"type":"shader",...} object per shader, followed by one {"type":"summary",...} object.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <cstdio>
+
+namespace AMD
+{
+
+    class ShaderTelemetry
+    {
+    public:
+
+        static const unsigned int m_uNUM_SLOWEST = 10;
+
+        // Cache result enumeration, why a shader was or wasn't compiled
+        typedef enum _CACHE_RESULT
+        {
+            CACHE_RESULT_NONE,                  // Not generated
+            CACHE_RESULT_HIT,                   // Unchanged, the object file or database entry was reused
+            CACHE_RESULT_HIT_UNCHECKED,         // CREATE_TYPE_USE_CACHED, the object was reused without preprocessing
+            CACHE_RESULT_HIT_SHARED,            // The object was fetched from the shared cache
+            CACHE_RESULT_MISS_CHANGED,          // The preprocessed source changed, or was never hashed
+            CACHE_RESULT_MISS_NO_OBJECT,        // Unchanged, but there was no object to reuse
+            CACHE_RESULT_MISS_SOURCE_NOT_FOUND, // The source file is missing
+            CACHE_RESULT_MAX
+        }CACHE_RESULT;
+
+        // The telemetry of one shader, strings are owned by the ShaderCache
+        struct Record
+        {
+            const wchar_t*      m_wsName;
+            const wchar_t*      m_wsSourceFile;
+            CACHE_RESULT        m_eCacheResult;
+            bool                m_bPreprocessedInProcess;
+            bool                m_bCompiled;
+            unsigned int        m_uPreprocessBatch;     // 1 based, 0 if not preprocessed
+            unsigned int        m_uCompileBatch;        // 1 based, 0 if not compiled
+            double              m_fPreprocessMs;
+            double              m_fHashMs;
+            double              m_fCompileMs;
+            unsigned int        m_uObjectSize;          // Bytes
+            unsigned int        m_uNumErrors;
+
+            void Reset();
+            double GetTotalMs() const { return m_fPreprocessMs + m_fHashMs + m_fCompileMs; }
+        };
+
+        // The summary of one shader generation
+        struct Summary
+        {
+            unsigned int        m_uNumShaders;
+            unsigned int        m_uNumResults[CACHE_RESULT_MAX];
+            unsigned int        m_uNumHits;
+            unsigned int        m_uNumMisses;
+            unsigned int        m_uNumCompiled;
+            unsigned int        m_uNumWithErrors;
+            double              m_fHitRate;             // Hits / ( hits + misses ), 1 if nothing was checked
+            double              m_fTotalPreprocessMs;
+            double              m_fTotalHashMs;
+            double              m_fTotalCompileMs;
+            double              m_fCriticalPathMs;      // Sum over batches of the slowest shader in each batch
+            unsigned long long  m_uTotalObjectSize;
+            unsigned int        m_uNumSlowest;
+            unsigned int        m_uSlowest[m_uNUM_SLOWEST];    // Record indices, slowest first
+        };
+
+        // Summarizes an array of records
+        static void Summarize( const Record* pRecords, unsigned int uNumRecords, Summary& o_Summary );
+
+        // Writes the records and their summary as JSON Lines
+        static bool Write( const wchar_t* pwsPathName, const Record* pRecords, unsigned int uNumRecords, const Summary& i_Summary );
+        static void Write( FILE* pFile, const Record* pRecords, unsigned int uNumRecords, const Summary& i_Summary );
+
+        // Name of a cache result, as written to the JSON
+        static const char* GetCacheResultName( CACHE_RESULT eCacheResult );
+
+        // Milliseconds on a monotonic clock, for timing the build steps
+        static double GetTimeMs();
+
+    private:
+
+        static bool IsHit( CACHE_RESULT eCacheResult );
+        static bool IsMiss( CACHE_RESULT eCacheResult );
+        static void WriteString( FILE* pFile, const wchar_t* pwsString );
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,395 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: SharedShaderCache.cpp
+//
+// Class implementation for the SharedShaderCache interface. A content addressed store of
+// compiled shader objects, shared between processes without any locking.
+//
+// Layout:
+//
+// Directory\XX\<key>.obj                   a published object, XX are the first two hex digits of the key
+// Directory\XX\<key>.obj.<pid>.<tid>.tmp   an object being published, renamed to <key>.obj when complete
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <windows.h>
+#include <cassert>
+#endif
+
+#include "SharedShaderCache.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace AMD;
+
+// Temporary files older than this were left behind by a process that died while publishing
+static const UINT64 STALE_TEMPORARY_FILE_AGE = 60ull * 60ull * 10000000ull; // 1 hour in FILETIME units
+
+// Trimming stops below this share of the size limit, so not every publish triggers a trim
+static const UINT64 TRIM_TARGET_PERCENTAGE = 90;
+
+
+//--------------------------------------------------------------------------------------
+// Helper for converting a FILETIME
+//--------------------------------------------------------------------------------------
+static UINT64 ToUINT64( const FILETIME& i_Time )
+{
+    return ( (UINT64)i_Time.dwHighDateTime << 32 ) | (UINT64)i_Time.dwLowDateTime;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------------------------------
+SharedShaderCache::SharedShaderCache()
+{
+    memset( m_wsDirectory, '\0', sizeof( wchar_t[m_uPATHNAME_MAX_LENGTH] ) );
+
+    m_uMaxSize = (UINT64)m_uDEFAULT_MAX_SIZE_MB << 20;
+    m_uPublishedSize = 0;
+    m_bOpen = false;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Destructor
+//--------------------------------------------------------------------------------------
+SharedShaderCache::~SharedShaderCache()
+{
+    Close();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Uses the given directory as the store, creating it if it does not exist yet. The directory
+// may already be populated by other processes.
+//--------------------------------------------------------------------------------------
+bool SharedShaderCache::Open( const wchar_t* pwsDirectory, unsigned int uMaxSizeMB )
+{
+    assert( NULL != pwsDirectory );
+
+    Close();
+
+    if( ( NULL == pwsDirectory ) || ( L'\0' == pwsDirectory[0] ) || ( 0 == uMaxSizeMB ) )
+    {
+        return false;
+    }
+
+    wcscpy_s( m_wsDirectory, m_uPATHNAME_MAX_LENGTH, pwsDirectory );
+
+    size_t uLength = wcslen( m_wsDirectory );
+    while( ( uLength > 0 ) && ( ( L'\\' == m_wsDirectory[uLength - 1] ) || ( L'/' == m_wsDirectory[uLength - 1] ) ) )
+    {
+        m_wsDirectory[--uLength] = L'\0';
+    }
+
+    CreateDirectoryW( m_wsDirectory, NULL );
+
+    DWORD uAttributes = GetFileAttributesW( m_wsDirectory );
+    if( ( INVALID_FILE_ATTRIBUTES == uAttributes ) || !( uAttributes & FILE_ATTRIBUTE_DIRECTORY ) )
+    {
+        memset( m_wsDirectory, '\0', sizeof( wchar_t[m_uPATHNAME_MAX_LENGTH] ) );
+
+        return false;
+    }
+
+    m_uMaxSize = (UINT64)uMaxSizeMB << 20;
+    m_uPublishedSize = 0;
+    m_bOpen = true;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Stops using the store, the objects in it are left for other processes
+//--------------------------------------------------------------------------------------
+void SharedShaderCache::Close()
+{
+    memset( m_wsDirectory, '\0', sizeof( wchar_t[m_uPATHNAME_MAX_LENGTH] ) );
+
+    m_uPublishedSize = 0;
+    m_bOpen = false;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Accessors
+//--------------------------------------------------------------------------------------
+bool SharedShaderCache::IsOpen() const
+{
+    return m_bOpen;
+}
+
+UINT64 SharedShaderCache::GetMaxSize() const
+{
+    return m_uMaxSize;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Copies a stored object to the given file. Published objects are never modified, so
+// the copy needs no synchronization with other processes.
+//--------------------------------------------------------------------------------------
+bool SharedShaderCache::Fetch( const BYTE* pKey, const wchar_t* pwsObjectPathName )
+{
+    assert( NULL != pKey );
+    assert( NULL != pwsObjectPathName );
+
+    if( !m_bOpen )
+    {
+        return false;
+    }
+
+    wchar_t wsDirectory[m_uPATHNAME_MAX_LENGTH];
+    wchar_t wsPathName[m_uPATHNAME_MAX_LENGTH];
+    CreateObjectPathName( pKey, wsDirectory, wsPathName );
+
+    if( !CopyFileW( wsPathName, pwsObjectPathName, FALSE ) )
+    {
+        return false;
+    }
+
+    Touch( wsPathName );
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Stores the object in the given file. The object is copied to a temporary file that is
+// unique to this process and thread, then renamed to its final name. The rename never replaces
+// an existing object, if another process won the race its object is identical to ours.
+//--------------------------------------------------------------------------------------
+bool SharedShaderCache::Publish( const BYTE* pKey, const wchar_t* pwsObjectPathName )
+{
+    assert( NULL != pKey );
+    assert( NULL != pwsObjectPathName );
+
+    if( !m_bOpen )
+    {
+        return false;
+    }
+
+    wchar_t wsDirectory[m_uPATHNAME_MAX_LENGTH];
+    wchar_t wsPathName[m_uPATHNAME_MAX_LENGTH];
+    CreateObjectPathName( pKey, wsDirectory, wsPathName );
+
+    if( INVALID_FILE_ATTRIBUTES != GetFileAttributesW( wsPathName ) )
+    {
+        Touch( wsPathName );
+
+        return true;
+    }
+
+    CreateDirectoryW( wsDirectory, NULL );
+
+    wchar_t wsTemporaryPathName[m_uPATHNAME_MAX_LENGTH];
+    swprintf_s( wsTemporaryPathName, m_uPATHNAME_MAX_LENGTH, L"%s.%u.%u.tmp", wsPathName, GetCurrentProcessId(), GetCurrentThreadId() );
+
+    if( !CopyFileW( pwsObjectPathName, wsTemporaryPathName, FALSE ) )
+    {
+        DeleteFileW( wsTemporaryPathName );
+
+        return false;
+    }
+
+    WIN32_FILE_ATTRIBUTE_DATA Data;
+    UINT64 uSize = 0;
+    if( GetFileAttributesExW( wsTemporaryPathName, GetFileExInfoStandard, &Data ) )
+    {
+        uSize = ( (UINT64)Data.nFileSizeHigh << 32 ) | (UINT64)Data.nFileSizeLow;
+    }
+
+    if( !MoveFileExW( wsTemporaryPathName, wsPathName, MOVEFILE_WRITE_THROUGH ) )
+    {
+        DeleteFileW( wsTemporaryPathName );
+
+        return ( INVALID_FILE_ATTRIBUTES != GetFileAttributesW( wsPathName ) );
+    }
+
+    Touch( wsPathName );
+
+    m_uPublishedSize += uSize;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Deletes the least recently used objects while the store exceeds its size limit, and any
+// stale temporary files. Files that cannot be deleted (e.g. because another process is
+// copying them right now) are skipped, the next trim will try again.
+//--------------------------------------------------------------------------------------
+void SharedShaderCache::Trim()
+{
+    if( !m_bOpen || ( 0 == m_uPublishedSize ) )
+    {
+        return;
+    }
+
+    m_uPublishedSize = 0;
+
+    FILETIME Now;
+    GetSystemTimeAsFileTime( &Now );
+    const UINT64 uNow = ToUINT64( Now );
+
+    std::vector<ObjectFile> Objects;
+    UINT64 uTotalSize = 0;
+
+    wchar_t wsSearch[m_uPATHNAME_MAX_LENGTH];
+    swprintf_s( wsSearch, m_uPATHNAME_MAX_LENGTH, L"%s\\*", m_wsDirectory );
+
+    WIN32_FIND_DATAW DirectoryData;
+    HANDLE hDirectories = FindFirstFileW( wsSearch, &DirectoryData );
+    if( INVALID_HANDLE_VALUE == hDirectories )
+    {
+        return;
+    }
+
+    do
+    {
+        if( !( DirectoryData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) || ( 2 != wcslen( DirectoryData.cFileName ) ) || ( L'.' == DirectoryData.cFileName[0] ) )
+        {
+            continue;
+        }
+
+        swprintf_s( wsSearch, m_uPATHNAME_MAX_LENGTH, L"%s\\%s\\*", m_wsDirectory, DirectoryData.cFileName );
+
+        WIN32_FIND_DATAW FileData;
+        HANDLE hFiles = FindFirstFileW( wsSearch, &FileData );
+        if( INVALID_HANDLE_VALUE == hFiles )
+        {
+            continue;
+        }
+
+        do
+        {
+            if( FileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY )
+            {
+                continue;
+            }
+
+            const wchar_t* pwsExtension = wcsrchr( FileData.cFileName, L'.' );
+            if( NULL == pwsExtension )
+            {
+                continue;
+            }
+
+            ObjectFile Object;
+            swprintf_s( Object.m_wsPathName, m_uPATHNAME_MAX_LENGTH, L"%s\\%s\\%s", m_wsDirectory, DirectoryData.cFileName, FileData.cFileName );
+            Object.m_uSize = ( (UINT64)FileData.nFileSizeHigh << 32 ) | (UINT64)FileData.nFileSizeLow;
+            Object.m_uLastAccess = std::max( ToUINT64( FileData.ftLastAccessTime ), ToUINT64( FileData.ftLastWriteTime ) );
+
+            if( 0 == _wcsicmp( pwsExtension, L".tmp" ) )
+            {
+                if( uNow > Object.m_uLastAccess + STALE_TEMPORARY_FILE_AGE )
+                {
+                    DeleteFileW( Object.m_wsPathName );
+                }
+            }
+            else if( 0 == _wcsicmp( pwsExtension, L".obj" ) )
+            {
+                uTotalSize += Object.m_uSize;
+                Objects.push_back( Object );
+            }
+        }
+        while( FindNextFileW( hFiles, &FileData ) );
+
+        FindClose( hFiles );
+    }
+    while( FindNextFileW( hDirectories, &DirectoryData ) );
+
+    FindClose( hDirectories );
+
+    if( uTotalSize <= m_uMaxSize )
+    {
+        return;
+    }
+
+    std::sort( Objects.begin(), Objects.end(), CompareLastAccess );
+
+    const UINT64 uTargetSize = m_uMaxSize / 100 * TRIM_TARGET_PERCENTAGE;
+    for( size_t i = 0; ( i < Objects.size() ) && ( uTotalSize > uTargetSize ); ++i )
+    {
+        if( DeleteFileW( Objects[i].m_wsPathName ) )
+        {
+            uTotalSize -= Objects[i].m_uSize;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Orders objects from least to most recently used
+//--------------------------------------------------------------------------------------
+bool SharedShaderCache::CompareLastAccess( const ObjectFile& i_First, const ObjectFile& i_Second )
+{
+    return ( i_First.m_uLastAccess < i_Second.m_uLastAccess );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Records a use of the object. Many volumes do not update the last access time on reads,
+// so it is set explicitly, this is what Trim orders the objects by.
+//--------------------------------------------------------------------------------------
+void SharedShaderCache::Touch( const wchar_t* pwsPathName )
+{
+    HANDLE hFile = CreateFileW( pwsPathName, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( INVALID_HANDLE_VALUE == hFile )
+    {
+        return;
+    }
+
+    FILETIME Now;
+    GetSystemTimeAsFileTime( &Now );
+    SetFileTime( hFile, NULL, &Now, NULL );
+
+    CloseHandle( hFile );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Builds the fan out directory and the path name of the object with the given key
+//--------------------------------------------------------------------------------------
+void SharedShaderCache::CreateObjectPathName( const BYTE* pKey, wchar_t* o_pwsDirectory, wchar_t* o_pwsPathName ) const
+{
+    wchar_t wsKey[m_uKEY_LENGTH * 2 + 1];
+    for( unsigned int i = 0; i < m_uKEY_LENGTH; ++i )
+    {
+        swprintf_s( &wsKey[i * 2], 3, L"%02x", pKey[i] );
+    }
+
+    swprintf_s( o_pwsDirectory, m_uPATHNAME_MAX_LENGTH, L"%s\\%.2s", m_wsDirectory, wsKey );
+    swprintf_s( o_pwsPathName, m_uPATHNAME_MAX_LENGTH, L"%s\\%s.obj", o_pwsDirectory, wsKey );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: SharedShaderCache.h
+//
+// Class definition for the SharedShaderCache interface. A content addressed store of compiled
+// shader objects that can be shared by several output directories, processes and machines
+// (e.g. on a network share).
+//
+// Objects are keyed by a hash of everything that determines the compiler output: the preprocessed
+// source, the compiler binaries, the target profile, the compilation flags, the entry point and
+// the macros. They are stored as Directory\XX\<key>.obj, where XX are the first two hex digits
+// of the key.
+//
+// No locks are taken. An object is written to a temporary file and renamed into place, so readers
+// either find the complete object or none at all, and two processes publishing the same key
+// publish identical objects. When the store grows beyond its size limit, the least recently
+// used objects are deleted.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+namespace AMD
+{
+
+    class SharedShaderCache
+    {
+    public:
+
+        // Constants used for the directory layout
+        static const unsigned int m_uKEY_LENGTH = 16;           // MD5 of the compiler inputs
+        static const unsigned int m_uPATHNAME_MAX_LENGTH = 512;
+        static const unsigned int m_uDEFAULT_MAX_SIZE_MB = 1024;
+
+        // Construction / destruction
+        SharedShaderCache();
+        ~SharedShaderCache();
+
+        // Uses (and creates) the given directory, objects beyond uMaxSizeMB are trimmed
+        bool Open( const wchar_t* pwsDirectory, unsigned int uMaxSizeMB = m_uDEFAULT_MAX_SIZE_MB );
+        void Close();
+        bool IsOpen() const;
+
+        // Copies a stored object to the given file
+        bool Fetch( const BYTE* pKey, const wchar_t* pwsObjectPathName );
+
+        // Stores the object in the given file, unless an object with the same key is stored already
+        bool Publish( const BYTE* pKey, const wchar_t* pwsObjectPathName );
+
+        // Deletes the least recently used objects while the store exceeds its size limit,
+        // this only scans the directory if something was published since the last call
+        void Trim();
+
+        UINT64 GetMaxSize() const;
+
+    private:
+
+        struct ObjectFile
+        {
+            wchar_t         m_wsPathName[m_uPATHNAME_MAX_LENGTH];
+            UINT64          m_uSize;
+            UINT64          m_uLastAccess;
+        };
+
+        static bool CompareLastAccess( const ObjectFile& i_First, const ObjectFile& i_Second );
+        static void Touch( const wchar_t* pwsPathName );
+
+        void CreateObjectPathName( const BYTE* pKey, wchar_t* o_pwsDirectory, wchar_t* o_pwsPathName ) const;
+
+        // Private data
+        wchar_t             m_wsDirectory[m_uPATHNAME_MAX_LENGTH];
+        UINT64              m_uMaxSize;
+        UINT64              m_uPublishedSize;
+        bool                m_bOpen;
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: StringPool.cpp
+//
+// Class implementation for the StringPool interface.
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <cassert>
+#include <cstring>
+#include <cwchar>
+#endif
+
+#include "StringPool.h"
+
+using namespace AMD;
+
+
+//--------------------------------------------------------------------------------------
+// FNV-1a over the characters of the string
+//--------------------------------------------------------------------------------------
+size_t StringPool::StringHash::operator()( const wchar_t* pwsString ) const
+{
+    size_t uHash = (size_t)2166136261u;
+    for( const wchar_t* pChar = pwsString; *pChar; pChar++ )
+    {
+        uHash = ( uHash ^ (size_t)*pChar ) * (size_t)16777619u;
+    }
+
+    return uHash;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Compares the characters, not the addresses
+//--------------------------------------------------------------------------------------
+bool StringPool::StringEqual::operator()( const wchar_t* pwsLeft, const wchar_t* pwsRight ) const
+{
+    return ( 0 == wcscmp( pwsLeft, pwsRight ) );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Constructor
+//--------------------------------------------------------------------------------------
+StringPool::StringPool()
+    : m_uBlockUsed( m_uBLOCK_LENGTH )
+    , m_uNumBytes( 0 )
+{
+}
+
+
+//--------------------------------------------------------------------------------------
+// Destructor
+//--------------------------------------------------------------------------------------
+StringPool::~StringPool()
+{
+    Clear();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Returns the pooled copy of the string
+//--------------------------------------------------------------------------------------
+const wchar_t* StringPool::Intern( const wchar_t* pwsString )
+{
+    assert( NULL != pwsString );
+
+    std::unordered_set<const wchar_t*, StringHash, StringEqual>::const_iterator it = m_Strings.find( pwsString );
+    if( it != m_Strings.end() )
+    {
+        return *it;
+    }
+
+    const size_t uLength = wcslen( pwsString ) + 1;
+    wchar_t* pwsPooled = NULL;
+
+    if( uLength > m_uBLOCK_LENGTH / 4 )
+    {
+        // Long strings get a block of their own, in front of the current one, so the space
+        // left in the current block is not wasted
+        pwsPooled = new wchar_t[uLength];
+        m_Blocks.insert( m_Blocks.empty() ? m_Blocks.end() : m_Blocks.end() - 1, pwsPooled );
+        m_uNumBytes += uLength * sizeof( wchar_t );
+    }
+    else
+    {
+        if( m_uBlockUsed + uLength > m_uBLOCK_LENGTH )
+        {
+            m_Blocks.push_back( new wchar_t[m_uBLOCK_LENGTH] );
+            m_uBlockUsed = 0;
+            m_uNumBytes += m_uBLOCK_LENGTH * sizeof( wchar_t );
+        }
+
+        pwsPooled = m_Blocks.back() + m_uBlockUsed;
+        m_uBlockUsed += uLength;
+    }
+
+    memcpy( pwsPooled, pwsString, uLength * sizeof( wchar_t ) );
+    m_Strings.insert( pwsPooled );
+
+    return pwsPooled;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Frees all strings
+//--------------------------------------------------------------------------------------
+void StringPool::Clear()
+{
+    for( size_t i = 0; i < m_Blocks.size(); i++ )
+    {
+        delete[] m_Blocks[i];
+    }
+
+    m_Blocks.clear();
+    m_Strings.clear();
+    m_uBlockUsed = m_uBLOCK_LENGTH;
+    m_uNumBytes = 0;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Accessors
+//--------------------------------------------------------------------------------------
+size_t StringPool::GetNumStrings() const
+{
+    return m_Strings.size();
+}
+
+size_t StringPool::GetNumBytes() const
+{
+    return m_uNumBytes;
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
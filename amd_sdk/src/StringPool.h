@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: StringPool.h
+//
+// Class definition for the StringPool interface. Interns strings: each distinct string is
+// stored once, in large blocks that are never moved or freed until the pool is cleared, so the
+// returned pointers can be kept and compared by address.
+//
+// Not thread safe, intern strings from one thread (or under a lock), reading them is safe.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+namespace AMD
+{
+
+    class StringPool
+    {
+    public:
+
+        static const size_t m_uBLOCK_LENGTH = 16 * 1024;   // Characters
+
+        // Construction / destruction
+        StringPool();
+        ~StringPool();
+
+        // Returns the pooled copy of the string, adding it if it is new
+        const wchar_t* Intern( const wchar_t* pwsString );
+
+        // Frees all strings, every pointer returned so far becomes invalid
+        void Clear();
+
+        // Statistics
+        size_t GetNumStrings() const;
+        size_t GetNumBytes() const;
+
+    private:
+
+        struct StringHash
+        {
+            size_t operator()( const wchar_t* pwsString ) const;
+        };
+
+        struct StringEqual
+        {
+            bool operator()( const wchar_t* pwsLeft, const wchar_t* pwsRight ) const;
+        };
+
+        // Not copyable, the pooled strings belong to this pool
+        StringPool( const StringPool& );
+        StringPool& operator=( const StringPool& );
+
+        // Private data
+        std::unordered_set<const wchar_t*, StringHash, StringEqual> m_Strings;
+        std::vector<wchar_t*>   m_Blocks;
+        size_t                  m_uBlockUsed;       // Characters used in the last block
+        size_t                  m_uNumBytes;
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
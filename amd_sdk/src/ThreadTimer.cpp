@@ -0,0 +1,458 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ThreadTimer.cpp
+//
+// Class implementation for the ThreadTimer interface.
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <windows.h>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#endif
+
+#include "ThreadTimer.h"
+
+using namespace AMD;
+
+
+//--------------------------------------------------------------------------------------
+// One scope of a thread's tree. The owning thread creates nodes and adds to the counters, the
+// merging thread only reads nodes below the published node count and exchanges the counters.
+//--------------------------------------------------------------------------------------
+struct ThreadTimer::Node
+{
+    Handle                              m_Handle;
+    unsigned int                        m_uParent;
+    unsigned int                        m_uFirstChild;      // Owning thread only
+    unsigned int                        m_uNext;            // Owning thread only
+    volatile LONG64                     m_iTicks;
+    volatile LONG                       m_iCount;
+};
+
+
+//--------------------------------------------------------------------------------------
+// The timer tree of one thread, m_Nodes[0] is the root and is never timed
+//--------------------------------------------------------------------------------------
+struct ThreadTimer::Tree
+{
+    Node                                m_Nodes[m_uMAX_NODES];
+    volatile LONG                       m_iNumNodes;        // Changed by the owning thread only
+
+    // Scopes the owning thread is in
+    unsigned int                        m_uStack[m_uMAX_DEPTH];
+    unsigned long long                  m_uStartTicks[m_uMAX_DEPTH];
+    unsigned int                        m_uDepth;
+
+    volatile LONG                       m_iInUse;
+    Tree*                               m_pNext;
+
+    // Merging thread only, maps m_Nodes to the merged nodes
+    std::vector<unsigned int>           m_MergedIndex;
+};
+
+
+//--------------------------------------------------------------------------------------
+// Reads a value another thread published with an interlocked function
+//--------------------------------------------------------------------------------------
+static LONG LoadAcquire( const volatile LONG* pValue )
+{
+    return InterlockedCompareExchange( const_cast<volatile LONG*>( pValue ), 0, 0 );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Construction / destruction
+//--------------------------------------------------------------------------------------
+ThreadTimer& ThreadTimer::Instance()
+{
+    static ThreadTimer inst;
+    return inst;
+}
+
+
+ThreadTimer::ThreadTimer() :
+    m_iNumTimers( 0 ),
+    m_pTrees( NULL )
+{
+    InitializeCriticalSection( &m_RegisterCriticalSection );
+
+    // The callback hands a thread's tree back for reuse when the thread exits
+    m_dwTreeIndex = FlsAlloc( &ThreadTimer::ReleaseTree );
+    assert( FLS_OUT_OF_INDEXES != m_dwTreeIndex );
+
+    for( unsigned int i = 0; i < m_uMAX_TIMERS; ++i )
+    {
+        m_pNames[i] = NULL;
+    }
+}
+
+
+ThreadTimer::~ThreadTimer()
+{
+    // Before the trees go, so no thread exiting later releases a deleted tree
+    FlsFree( m_dwTreeIndex );
+
+    Tree* pTree = m_pTrees;
+    while( NULL != pTree )
+    {
+        Tree* pNext = pTree->m_pNext;
+        delete pTree;
+        pTree = pNext;
+    }
+    m_pTrees = NULL;
+
+    DeleteCriticalSection( &m_RegisterCriticalSection );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Timer names
+//--------------------------------------------------------------------------------------
+ThreadTimer::Handle ThreadTimer::Register( const wchar_t* pwsName )
+{
+    assert( NULL != pwsName );
+
+    EnterCriticalSection( &m_RegisterCriticalSection );
+
+    const wchar_t* pwsInterned = m_Names.Intern( pwsName );
+    const unsigned int uNumTimers = (unsigned int)LoadAcquire( &m_iNumTimers );
+    Handle hTimer = m_uINVALID_HANDLE;
+
+    std::unordered_map<const wchar_t*, Handle>::const_iterator it = m_Handles.find( pwsInterned );
+    if( it != m_Handles.end() )
+    {
+        hTimer = it->second;
+    }
+    else if( uNumTimers < m_uMAX_TIMERS )
+    {
+        hTimer = uNumTimers;
+        m_pNames[hTimer] = pwsInterned;
+        m_Handles[pwsInterned] = hTimer;
+
+        // Publish the name to GetName()
+        InterlockedExchange( &m_iNumTimers, (LONG)( hTimer + 1 ) );
+    }
+    else
+    {
+        assert( false && "Too many timers registered, increase ThreadTimer::m_uMAX_TIMERS" );
+    }
+
+    LeaveCriticalSection( &m_RegisterCriticalSection );
+
+    return hTimer;
+}
+
+
+const wchar_t* ThreadTimer::GetName( Handle hTimer ) const
+{
+    if( hTimer >= (unsigned int)LoadAcquire( &m_iNumTimers ) )
+    {
+        return NULL;
+    }
+
+    return m_pNames[hTimer];
+}
+
+
+//--------------------------------------------------------------------------------------
+// Per thread trees
+//--------------------------------------------------------------------------------------
+ThreadTimer::Tree* ThreadTimer::GetTree()
+{
+    Tree* pTree = (Tree*)FlsGetValue( m_dwTreeIndex );
+
+    if( NULL == pTree )
+    {
+        pTree = AcquireTree();
+        FlsSetValue( m_dwTreeIndex, pTree );
+    }
+
+    return pTree;
+}
+
+
+ThreadTimer::Tree* ThreadTimer::AcquireTree()
+{
+    // Reuse the tree of a thread that has exited, its scopes are still valid
+    Tree* pHead = (Tree*)InterlockedCompareExchangePointer( (PVOID volatile*)&m_pTrees, NULL, NULL );
+    for( Tree* pTree = pHead; NULL != pTree; pTree = pTree->m_pNext )
+    {
+        if( 0 == InterlockedCompareExchange( &pTree->m_iInUse, 1, 0 ) )
+        {
+            pTree->m_uDepth = 0;
+            return pTree;
+        }
+    }
+
+    // Otherwise add a new one, this is the only allocation a thread makes
+    Tree* pTree = new Tree;
+
+    Node& root = pTree->m_Nodes[0];
+    root.m_Handle = m_uINVALID_HANDLE;
+    root.m_uParent = m_uINVALID_HANDLE;
+    root.m_uFirstChild = m_uINVALID_HANDLE;
+    root.m_uNext = m_uINVALID_HANDLE;
+    root.m_iTicks = 0;
+    root.m_iCount = 0;
+    pTree->m_iNumNodes = 1;
+
+    pTree->m_uDepth = 0;
+    pTree->m_iInUse = 1;
+    pTree->m_MergedIndex.reserve( m_uMAX_NODES );
+
+    // Publish the tree to Merge() and the other threads
+    for( ;; )
+    {
+        pTree->m_pNext = pHead;
+        Tree* pPrevious = (Tree*)InterlockedCompareExchangePointer( (PVOID volatile*)&m_pTrees, pTree, pHead );
+        if( pPrevious == pHead )
+        {
+            break;
+        }
+        pHead = pPrevious;
+    }
+
+    return pTree;
+}
+
+
+void WINAPI ThreadTimer::ReleaseTree( PVOID pTree )
+{
+    InterlockedExchange( &( (Tree*)pTree )->m_iInUse, 0 );
+}
+
+
+unsigned int ThreadTimer::FindChild( const Tree& i_Tree, unsigned int uParent, Handle hTimer )
+{
+    unsigned int uNode = i_Tree.m_Nodes[uParent].m_uFirstChild;
+    while( m_uINVALID_HANDLE != uNode )
+    {
+        if( i_Tree.m_Nodes[uNode].m_Handle == hTimer )
+        {
+            return uNode;
+        }
+        uNode = i_Tree.m_Nodes[uNode].m_uNext;
+    }
+
+    return m_uINVALID_HANDLE;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Timing
+//--------------------------------------------------------------------------------------
+void ThreadTimer::Start( Handle hTimer )
+{
+    Tree* pTree = GetTree();
+
+    // Scopes nested deeper than m_uMAX_DEPTH, or that don't fit the tree, are not timed
+    // but still counted, so Start and Stop stay balanced
+    unsigned int uParent = m_uINVALID_HANDLE;
+    if( 0 == pTree->m_uDepth )
+    {
+        uParent = 0;
+    }
+    else if( pTree->m_uDepth <= m_uMAX_DEPTH )
+    {
+        uParent = pTree->m_uStack[pTree->m_uDepth - 1];
+    }
+
+    unsigned int uNode = m_uINVALID_HANDLE;
+    if( m_uINVALID_HANDLE != uParent && m_uINVALID_HANDLE != hTimer )
+    {
+        uNode = FindChild( *pTree, uParent, hTimer );
+        if( m_uINVALID_HANDLE == uNode )
+        {
+            unsigned int uNumNodes = (unsigned int)LoadAcquire( &pTree->m_iNumNodes );
+            if( uNumNodes < m_uMAX_NODES )
+            {
+                Node& node = pTree->m_Nodes[uNumNodes];
+                node.m_Handle = hTimer;
+                node.m_uParent = uParent;
+                node.m_uFirstChild = m_uINVALID_HANDLE;
+                node.m_uNext = pTree->m_Nodes[uParent].m_uFirstChild;
+                node.m_iTicks = 0;
+                node.m_iCount = 0;
+                pTree->m_Nodes[uParent].m_uFirstChild = uNumNodes;
+
+                // Publish the node to Merge()
+                InterlockedExchange( &pTree->m_iNumNodes, (LONG)( uNumNodes + 1 ) );
+                uNode = uNumNodes;
+            }
+            else
+            {
+                assert( false && "Too many scopes on this thread, increase ThreadTimer::m_uMAX_NODES" );
+            }
+        }
+    }
+
+    if( pTree->m_uDepth < m_uMAX_DEPTH )
+    {
+        pTree->m_uStack[pTree->m_uDepth] = uNode;
+        pTree->m_uStartTicks[pTree->m_uDepth] = GetTicks();
+    }
+    ++pTree->m_uDepth;
+}
+
+
+void ThreadTimer::Stop()
+{
+    unsigned long long uTicks = GetTicks();
+
+    Tree* pTree = GetTree();
+
+    assert( "Start(...) not called before Stop()" && ( pTree->m_uDepth > 0 ) );
+    if( 0 == pTree->m_uDepth )
+    {
+        return;
+    }
+
+    --pTree->m_uDepth;
+    if( pTree->m_uDepth < m_uMAX_DEPTH )
+    {
+        unsigned int uNode = pTree->m_uStack[pTree->m_uDepth];
+        if( m_uINVALID_HANDLE != uNode )
+        {
+            Node& node = pTree->m_Nodes[uNode];
+            InterlockedExchangeAdd64( &node.m_iTicks, (LONG64)( uTicks - pTree->m_uStartTicks[pTree->m_uDepth] ) );
+            InterlockedIncrement( &node.m_iCount );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Merging
+//--------------------------------------------------------------------------------------
+unsigned int ThreadTimer::AddMergedNode( std::vector<MergedNode>& io_Nodes, unsigned int uParent, Handle hTimer )
+{
+    // Top level nodes are chained from node 0, children from their parent
+    unsigned int uLast = m_uINVALID_HANDLE;
+    unsigned int uNode = m_uINVALID_HANDLE;
+    if( m_uINVALID_HANDLE == uParent )
+    {
+        uNode = io_Nodes.empty() ? m_uINVALID_HANDLE : 0;
+    }
+    else
+    {
+        uNode = io_Nodes[uParent].m_uFirstChild;
+    }
+
+    while( m_uINVALID_HANDLE != uNode )
+    {
+        if( io_Nodes[uNode].m_Handle == hTimer )
+        {
+            return uNode;
+        }
+        uLast = uNode;
+        uNode = io_Nodes[uNode].m_uNext;
+    }
+
+    MergedNode node;
+    node.m_Handle = hTimer;
+    node.m_uParent = uParent;
+    node.m_uFirstChild = m_uINVALID_HANDLE;
+    node.m_uNext = m_uINVALID_HANDLE;
+    node.m_uTicks = 0;
+    node.m_uCount = 0;
+
+    uNode = (unsigned int)io_Nodes.size();
+    io_Nodes.push_back( node );
+
+    // Keep the order the scopes were first seen in
+    if( m_uINVALID_HANDLE != uLast )
+    {
+        io_Nodes[uLast].m_uNext = uNode;
+    }
+    else if( m_uINVALID_HANDLE != uParent )
+    {
+        io_Nodes[uParent].m_uFirstChild = uNode;
+    }
+
+    return uNode;
+}
+
+
+void ThreadTimer::Merge( std::vector<MergedNode>& o_Nodes )
+{
+    o_Nodes.clear();
+
+    Tree* pHead = (Tree*)InterlockedCompareExchangePointer( (PVOID volatile*)&m_pTrees, NULL, NULL );
+    for( Tree* pTree = pHead; NULL != pTree; pTree = pTree->m_pNext )
+    {
+        // Nodes are only ever added, and a parent always comes before its children
+        unsigned int uNumNodes = (unsigned int)LoadAcquire( &pTree->m_iNumNodes );
+        pTree->m_MergedIndex.resize( uNumNodes );
+        pTree->m_MergedIndex[0] = m_uINVALID_HANDLE;
+
+        for( unsigned int i = 1; i < uNumNodes; ++i )
+        {
+            Node& node = pTree->m_Nodes[i];
+
+            unsigned int uMerged = AddMergedNode( o_Nodes, pTree->m_MergedIndex[node.m_uParent], node.m_Handle );
+            pTree->m_MergedIndex[i] = uMerged;
+
+            o_Nodes[uMerged].m_uTicks += (unsigned long long)InterlockedExchange64( &node.m_iTicks, 0 );
+            o_Nodes[uMerged].m_uCount += (unsigned int)InterlockedExchange( &node.m_iCount, 0 );
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Clock. QueryPerformanceCounter on Windows, where Visual Studio 2012 and 2013 implement
+// std::chrono::steady_clock with the system time, and clock_gettime( CLOCK_MONOTONIC ) elsewhere.
+//--------------------------------------------------------------------------------------
+unsigned long long ThreadTimer::GetTicks()
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter( &counter );
+    return (unsigned long long)counter.QuadPart;
+#else
+    return (unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+
+double ThreadTimer::GetTicksPerSecond()
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency( &frequency );
+    return (double)frequency.QuadPart;
+#else
+    return (double)std::chrono::steady_clock::period::den / (double)std::chrono::steady_clock::period::num;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ThreadTimer.h
+//
+// Class definition for the ThreadTimer interface. CPU scope timing that is safe to use from any
+// thread: timer names are registered once and referred to by handle, every thread records into
+// its own timer tree, and the trees are merged into one at frame end.
+//
+// Start/Stop only touch the calling thread's tree, they take no lock and never allocate once the
+// thread has seen the scope before. Merge() reads the trees without stopping the threads that are
+// recording into them, and should be called from one thread at a time (TimerEx::Reset does).
+//
+// Built on interlocked functions, fiber local storage and a critical section rather than <atomic>,
+// thread_local and <mutex>, which Visual Studio 2010 to 2013 don't all have.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "StringPool.h"
+
+namespace AMD
+{
+
+    class ThreadTimer
+    {
+    public:
+
+        typedef unsigned int Handle;
+
+        static const Handle         m_uINVALID_HANDLE = 0xFFFFFFFF;
+        static const unsigned int   m_uMAX_TIMERS = 1024;           // Registered names
+        static const unsigned int   m_uMAX_NODES = 1024;            // Distinct scopes (name and parent scope) per thread
+        static const unsigned int   m_uMAX_DEPTH = 64;              // Nested scopes per thread
+
+        // One scope of the merged tree, parents come before their children
+        struct MergedNode
+        {
+            Handle              m_Handle;
+            unsigned int        m_uParent;          // Index into the merged nodes, m_uINVALID_HANDLE for a top level scope
+            unsigned int        m_uFirstChild;
+            unsigned int        m_uNext;
+            unsigned long long  m_uTicks;           // Summed over all threads since the last merge
+            unsigned int        m_uCount;           // Scopes stopped since the last merge
+        };
+
+        static ThreadTimer& Instance();
+
+        // Returns the handle of a timer name, registering it on first use. Takes a lock,
+        // so register handles up front rather than in the timed code.
+        Handle Register( const wchar_t* pwsName );
+        const wchar_t* GetName( Handle hTimer ) const;
+
+        // Times a scope on the calling thread
+        void Start( Handle hTimer );
+        void Stop();
+
+        // Collects and clears the time recorded by all threads since the last merge
+        void Merge( std::vector<MergedNode>& o_Nodes );
+
+        // Monotonic clock shared by all CPU timers
+        static unsigned long long GetTicks();
+        static double GetTicksPerSecond();
+
+    private:
+
+        struct Node;
+        struct Tree;
+
+        ThreadTimer();
+        ~ThreadTimer();
+
+        // Not copyable, there is only the one instance
+        ThreadTimer( const ThreadTimer& );
+        ThreadTimer& operator=( const ThreadTimer& );
+
+        Tree* GetTree();
+        Tree* AcquireTree();
+        static void WINAPI ReleaseTree( PVOID pTree );
+        static unsigned int FindChild( const Tree& i_Tree, unsigned int uParent, Handle hTimer );
+        static unsigned int AddMergedNode( std::vector<MergedNode>& io_Nodes, unsigned int uParent, Handle hTimer );
+
+        // Private data
+        CRITICAL_SECTION                                m_RegisterCriticalSection;
+        StringPool                                      m_Names;
+        std::unordered_map<const wchar_t*, Handle>      m_Handles;
+        const wchar_t*                                  m_pNames[m_uMAX_TIMERS];
+        volatile LONG                                   m_iNumTimers;
+        Tree* volatile                                  m_pTrees;       // Never shrinks, trees of exited threads are reused
+        DWORD                                           m_dwTreeIndex;  // Fiber local storage slot of the calling thread's tree
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
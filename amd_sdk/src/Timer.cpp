@@ -41,14 +41,6 @@
 #define SAFE_DELETE_ARRAY(p) if(p){delete[] p; p=NULL;}
 #endif
 
-#if USE_RDTSC
-__declspec(naked) LONGLONG __cdecl rdtsc_time(void)
-{
-    __asm rdtsc
-    __asm ret
-}
-#endif
-
 //-----------------------------------------------------------------------------
 Timer::Timer() :
     m_LastTime(0.0),
@@ -77,25 +69,26 @@ double Timer::GetTimeNumFrames()
     return m_NumFrames;
 }
 
-//-----------------------------------------------------------------------------
-
-CpuTimer::CpuTimer() :
-    Timer()
+const AMD::TimerHistogram& Timer::GetHistogram()
 {
-    LARGE_INTEGER freq;
-    QueryPerformanceFrequency(&freq);
-    m_freq = static_cast<double>(freq.QuadPart);
+    FinishCollection();
 
-#if USE_RDTSC
-    const double calibrationTime = 0.1;
+    return m_Histogram;
+}
 
-    LONGLONG start, stop;
-    start = rdtsc_time();
-    Delay(calibrationTime);
-    stop = rdtsc_time();
+double Timer::GetPercentile( double percentile )
+{
+    return GetHistogram().GetPercentile( percentile );
+}
 
-    m_freqRdtsc = static_cast<double>(stop - start) / calibrationTime;
-#endif
+//-----------------------------------------------------------------------------
+
+CpuTimer::CpuTimer() :
+    Timer(),
+    m_startTime(0),
+    m_timed(false)
+{
+    m_freq = AMD::ThreadTimer::GetTicksPerSecond();
 }
 
 CpuTimer::~CpuTimer()
@@ -104,59 +97,56 @@ CpuTimer::~CpuTimer()
 
 void CpuTimer::Reset( bool bResetSum )
 {
-    m_LastTime = 0.0;
     if( bResetSum )
     {
         m_SumTime = 0.0;
         m_NumFrames = 0;
+        m_Histogram.Reset();
     }
     else
     {
+        if( m_timed )
+            m_Histogram.Add( m_LastTime );
         ++m_NumFrames;
     }
+    m_LastTime = 0.0;
+    m_timed = false;
 }
 
 void CpuTimer::Start()
 {
-#if USE_RDTSC
-    m_startTime.QuadPart = rdtsc_time();
-#else
-    QueryPerformanceCounter(&m_startTime);
-#endif
+    m_startTime = AMD::ThreadTimer::GetTicks();
 }
 
 void CpuTimer::Stop()
 {
-    LARGE_INTEGER t;
-    double freq;
-
-#if USE_RDTSC
-    t.QuadPart = rdtsc_time();
-    freq = m_freqRdtsc;
-#else
-    QueryPerformanceCounter(&t);
-    freq = m_freq;
-#endif
+    UINT64 t = AMD::ThreadTimer::GetTicks();
 
-    m_LastTime += static_cast<double>(t.QuadPart - m_startTime.QuadPart) / freq;
-    m_SumTime +=  static_cast<double>(t.QuadPart - m_startTime.QuadPart) / freq;
+    AddTime( static_cast<double>(t - m_startTime) / m_freq );
 }
 
 void CpuTimer::Delay(double sec)
 {
-    LARGE_INTEGER start, stop;
+    UINT64 start, stop;
     double t;
 
-    QueryPerformanceCounter(&start);
+    start = AMD::ThreadTimer::GetTicks();
 
     do
     {
-        QueryPerformanceCounter(&stop);
+        stop = AMD::ThreadTimer::GetTicks();
 
-        t = static_cast<double>(stop.QuadPart - start.QuadPart) / m_freq;
+        t = static_cast<double>(stop - start) / m_freq;
     } while (t < sec);
 }
 
+void CpuTimer::AddTime(double sec)
+{
+    m_LastTime += sec;
+    m_SumTime +=  sec;
+    m_timed = true;
+}
+
 //-----------------------------------------------------------------------------
 
 GpuTimer::GpuTimer(ID3D11Device* pDev, UINT64 freq, UINT numTimeStamps ) :
@@ -230,6 +220,7 @@ void GpuTimer::Reset( bool bResetSum )
         m_LastTime  = 0.0;
         m_SumTime   = 0.0;
         m_NumFrames = 0;
+        m_Histogram.Reset();
     }
 }
 
@@ -281,6 +272,7 @@ void GpuTimer::WaitIdle()
         m_LastTime = m_CurTime;
         m_SumTime +=  m_CurTime;
         ++m_NumFrames;
+        m_Histogram.Add( m_CurTime );
     }
 }
 
@@ -308,6 +300,7 @@ bool GpuTimer::CollectData(UINT idx, BOOL stall)
             m_LastTime = m_CurTime;
             m_SumTime +=  m_CurTime;
             ++m_NumFrames;
+            m_Histogram.Add( m_CurTime );
         }
 
         // start collecting time data of the next frame
@@ -453,12 +446,12 @@ void GpuCpuTimer::WaitIdle()
 TimingEvent::TimingEvent( ) :
     m_name(NULL),
     m_nameLen(0),
+    m_gpu(NULL),
     m_used( false ),
     m_parent(NULL),
     m_firstChild(NULL),
     m_next(NULL)
 {
-    m_gpu = (NULL != TimerEx::Instance().GetDevice()) ? new GpuTimer( TimerEx::Instance().GetDevice(), 0, 16 ) : NULL;
 }
 
 TimingEvent::~TimingEvent()
@@ -487,6 +480,10 @@ LPCWSTR TimingEvent::GetName( )
 
 void TimingEvent::Start( )
 {
+    // the GPU timer is created on first use, so events only filled in from ThreadTimer don't create queries
+    if( NULL == m_gpu && NULL != TimerEx::Instance().GetDevice() )
+        m_gpu = new GpuTimer( TimerEx::Instance().GetDevice(), 0, 16 );
+
     m_used = true;
     if( NULL != m_gpu ) m_gpu->Start();
     m_cpu.Start();
@@ -537,42 +534,43 @@ double TimingEvent::GetAvgTime( TimerType type, bool stall )
     }
 }
 
-TimingEvent* TimingEvent::GetTimer(LPCWSTR timerId)
+double TimingEvent::GetPercentile( TimerType type, double percentile, bool stall )
 {
-    size_t len = wcslen(timerId);
-    size_t seperator = wcscspn( timerId, L"/|\\" );
-
-    if( seperator<len )
+    switch( type )
     {
-        LPWSTR idCopy = new WCHAR[len+1];
-        wcscpy_s( idCopy, len+1, timerId );
-        idCopy[seperator] = 0;
-
-        TimingEvent* te = m_firstChild;
-        while( te )
+    case ttCpu:
+        return m_cpu.GetPercentile( percentile );
+    case ttGpu:
+        if( NULL != m_gpu )
         {
-            if( !wcscmp(idCopy, te->m_name ) )
-            {
-                te = te->GetTimerRec( &idCopy[seperator+1] );
-                delete[] idCopy;
-                return te;
-            }
-            te = te->m_next;
+            if( stall )
+                m_gpu->WaitIdle();
+            return m_gpu->GetPercentile( percentile );
         }
-
-        delete[] idCopy;
+        // else fallthrough
+    default:
+        return 0.0f;
     }
-    else
+}
+
+const AMD::TimerHistogram* TimingEvent::GetHistogram( TimerType type )
+{
+    switch( type )
     {
-        TimingEvent* te = m_firstChild;
-        while( te )
-        {
-            if( !wcscmp(timerId, te->m_name ) )
-                return te;
-            te = te->m_next;
-        }
+    case ttCpu:
+        return &m_cpu.GetHistogram();
+    case ttGpu:
+        if( NULL != m_gpu )
+            return &m_gpu->GetHistogram();
+        // else fallthrough
+    default:
+        return NULL;
     }
-    return NULL;
+}
+
+TimingEvent* TimingEvent::GetTimer(LPCWSTR timerId)
+{
+    return FindTimer( m_firstChild, timerId );
 }
 
 TimingEvent* TimingEvent::GetParent( )
@@ -590,25 +588,25 @@ TimingEvent* TimingEvent::GetNextTimer( )
     return m_next;
 }
 
-// when this function is called we know we're working on a copy of the name, so we can "destruct" it
-TimingEvent* TimingEvent::GetTimerRec( LPWSTR timerId )
+// compares each path element in place, so looking up a timer doesn't allocate
+TimingEvent* TimingEvent::FindTimer( TimingEvent* te, LPCWSTR timerId )
 {
-    size_t len = wcslen(timerId);
-    size_t seperator = wcscspn( timerId, L"/|\\" );
-    if( seperator<len )
-        timerId[seperator] = 0;
-
-    TimingEvent* te = m_firstChild;
-    while( te )
+    while( NULL != te )
     {
-        if( !wcscmp(timerId, te->m_name ) )
+        size_t seperator = wcscspn( timerId, L"/|\\" );
+
+        while( NULL != te )
         {
-            if( seperator<len )
-                te = te->GetTimerRec( &timerId[seperator+1] );
+            if( !wcsncmp( timerId, te->m_name, seperator ) && ( 0 == te->m_name[seperator] ) )
+                break;
+            te = te->m_next;
+        }
 
+        if( NULL == te || 0 == timerId[seperator] )
             return te;
-        }
-        te = te->m_next;
+
+        timerId = &timerId[seperator+1];
+        te = te->m_firstChild;
     }
 
     return NULL;
@@ -630,6 +628,7 @@ TimingEvent* TimingEvent::FindLastChildUsed()
 
 TimerEx::TimerEx( ) :
     m_pDev(NULL),
+    m_Root(NULL),
     m_Current(NULL),
     m_Unused(NULL)
 {
@@ -733,6 +732,8 @@ void TimerEx::Reset( bool bResetSum )
 
     if( NULL != m_Root )
         Reset( m_Root, bResetSum );
+
+    MergeThreadTimers();
 }
 
 void TimerEx::Start( LPCWSTR timerId )
@@ -741,62 +742,68 @@ void TimerEx::Start( LPCWSTR timerId )
 
     TimingEvent* te = (NULL == m_Current) ? GetTimer(timerId) : m_Current->GetTimer(timerId);
     if( NULL == te )
+        te = AddTimer( m_Current, timerId );
+
+    m_Current = te;
+    m_Current->Start();
+}
+
+TimingEvent* TimerEx::AddTimer( TimingEvent* parent, LPCWSTR timerId )
+{
+    // create new timer event
+    TimingEvent* te;
+    if( NULL == m_Unused )
     {
-        // create new timer event
-        if( NULL == m_Unused )
-        {
-            te = new TimingEvent();
-        }
-        else
-        {
-            te = m_Unused;
-            m_Unused = te->m_next;
-            te->m_next = NULL;
-        }
+        te = new TimingEvent();
+    }
+    else
+    {
+        te = m_Unused;
+        m_Unused = te->m_next;
+        te->m_next = NULL;
+    }
 
-        te->SetName( timerId );
-        te->m_parent = m_Current;
+    te->SetName( timerId );
+    te->m_parent = parent;
 
-        // now look where to insert it
-        TimingEvent* lu = NULL;
-        if( NULL == m_Current )
-        {
-            TimingEvent* tmp = m_Root;
-            while( tmp )
-            {
-                if( tmp->m_used )
-                    lu = tmp;
-                tmp = tmp->m_next;
-            }
-        }
-        else
+    // now look where to insert it
+    TimingEvent* lu = NULL;
+    if( NULL == parent )
+    {
+        TimingEvent* tmp = m_Root;
+        while( tmp )
         {
-            lu = m_Current->FindLastChildUsed();
+            if( tmp->m_used )
+                lu = tmp;
+            tmp = tmp->m_next;
         }
+    }
+    else
+    {
+        lu = parent->FindLastChildUsed();
+    }
 
-        if( NULL != lu )
+    if( NULL != lu )
+    {
+        te->m_next = lu->m_next;
+        lu->m_next = te;
+    }
+    else
+    {
+        if( NULL == parent )
         {
-            te->m_next = lu->m_next;
-            lu->m_next = te;
+            te->m_next = m_Root;
+            m_Root = te;
         }
         else
         {
-            if( NULL == m_Current )
-            {
-                te->m_next = m_Root;
-                m_Root = te;
-            }
-            else
-            {
-                te->m_next = m_Current->m_firstChild;
-                m_Current->m_firstChild = te;
-            }
-
+            te->m_next = parent->m_firstChild;
+            parent->m_firstChild = te;
         }
+
     }
 
-    m_Current = te;
-    m_Current->Start();
+    return te;
 }
 
 void TimerEx::Stop( )
@@ -838,6 +845,20 @@ double TimerEx::GetAvgTime( TimerType type, LPCWSTR timerId, bool stall )
     return ( NULL != te ) ? te->GetAvgTime(type, stall) : 0.0;
 }
 
+double TimerEx::GetPercentile( TimerType type, LPCWSTR timerId, double percentile, bool stall )
+{
+    _ASSERT( "init not called or called with NULL" && (m_pDev != NULL) );
+
+    TimingEvent* te = NULL;
+
+    if( NULL != m_Current )
+        te = m_Current->GetTimer( timerId );
+
+    if( NULL == te )
+        te = GetTimer( timerId );
+
+    return ( NULL != te ) ? te->GetPercentile(type, percentile, stall) : 0.0;
+}
 
 TimingEvent* TimerEx::GetTimer( LPCWSTR timerId )
 {
@@ -846,35 +867,93 @@ TimingEvent* TimerEx::GetTimer( LPCWSTR timerId )
 
     _ASSERT( "init not called" && (m_pDev != NULL) );
 
-    size_t len = wcslen(timerId);
-    size_t seperator = wcscspn( timerId, L"/|\\" );
-    if( seperator < len )
+    return TimingEvent::FindTimer( m_Root, timerId );
+}
+
+TimerHandle TimerEx::RegisterTimer( LPCWSTR timerId )
+{
+    return AMD::ThreadTimer::Instance().Register( timerId );
+}
+
+void TimerEx::StartThread( TimerHandle timer )
+{
+    AMD::ThreadTimer::Instance().Start( timer );
+}
+
+void TimerEx::StopThread( )
+{
+    AMD::ThreadTimer::Instance().Stop();
+}
+
+void TimerEx::MergeThreadTimers( )
+{
+    AMD::ThreadTimer& threadTimer = AMD::ThreadTimer::Instance();
+    threadTimer.Merge( m_Merged );
+
+    // a scope is reported if it or one of its children ran since the last merge,
+    // children come after their parents so walk backwards
+    for( size_t i = m_Merged.size(); i-- > 0; )
     {
-        LPWSTR idCopy = new WCHAR[len+1];
-        wcscpy_s( idCopy, len+1, timerId );
-        idCopy[seperator] = 0;
-        TimingEvent* te = m_Root;
-        while( te )
-        {
-            if( !wcscmp(idCopy, te->m_name ) )
-            {
-                te = te->GetTimerRec( &idCopy[seperator+1] );
-                delete[] idCopy;
-                return te;
-            }
-            te = te->m_next;
-        }
-        delete[] idCopy;
+        const AMD::ThreadTimer::MergedNode& node = m_Merged[i];
+        if( 0 != node.m_uCount && AMD::ThreadTimer::m_uINVALID_HANDLE != node.m_uParent && 0 == m_Merged[node.m_uParent].m_uCount )
+            m_Merged[node.m_uParent].m_uCount = 1;
     }
-    else
+
+    const double freq = AMD::ThreadTimer::GetTicksPerSecond();
+
+    m_MergedEvents.resize( m_Merged.size() );
+    for( size_t i = 0; i < m_Merged.size(); ++i )
     {
-        TimingEvent* te = m_Root;
-        while( te )
-        {
-            if( !wcscmp(timerId, te->m_name ) )
-                return te;
-            te = te->m_next;
-        }
+        const AMD::ThreadTimer::MergedNode& node = m_Merged[i];
+        m_MergedEvents[i] = NULL;
+        if( 0 == node.m_uCount )
+            continue;
+
+        TimingEvent* parent = ( AMD::ThreadTimer::m_uINVALID_HANDLE == node.m_uParent ) ? NULL : m_MergedEvents[node.m_uParent];
+        LPCWSTR name = threadTimer.GetName( node.m_Handle );
+
+        TimingEvent* te = TimingEvent::FindTimer( ( NULL == parent ) ? m_Root : parent->m_firstChild, name );
+        if( NULL == te )
+            te = AddTimer( parent, name );
+
+        te->m_cpu.AddTime( static_cast<double>(node.m_uTicks) / freq );
+        te->m_used = true;
+        m_MergedEvents[i] = te;
     }
-    return NULL;
+}
+
+void TimerEx::GetExportEvents( TimingEvent* te, unsigned int parent, unsigned int depth, std::vector<AMD::TimerExport::Event>& events )
+{
+    while( NULL != te )
+    {
+        AMD::TimerExport::Event event;
+        event.m_wsName = te->GetName();
+        event.m_uParent = parent;
+        event.m_uDepth = depth;
+        event.m_fCpuTime = te->GetTime( ttCpu );
+        event.m_fGpuTime = te->GetTime( ttGpu );
+        event.m_pCpuHistogram = te->GetHistogram( ttCpu );
+        event.m_pGpuHistogram = te->GetHistogram( ttGpu );
+
+        events.push_back( event );
+        GetExportEvents( te->m_firstChild, static_cast<unsigned int>(events.size() - 1), depth + 1, events );
+
+        te = te->m_next;
+    }
+}
+
+bool TimerEx::WriteCSV( LPCWSTR fileName )
+{
+    std::vector<AMD::TimerExport::Event> events;
+    GetExportEvents( m_Root, AMD::TimerExport::m_uNO_PARENT, 0, events );
+
+    return AMD::TimerExport::WriteCSV( fileName, events.empty() ? NULL : &events[0], static_cast<unsigned int>(events.size()) );
+}
+
+bool TimerEx::WriteChromeTrace( LPCWSTR fileName )
+{
+    std::vector<AMD::TimerExport::Event> events;
+    GetExportEvents( m_Root, AMD::TimerExport::m_uNO_PARENT, 0, events );
+
+    return AMD::TimerExport::WriteChromeTrace( fileName, events.empty() ? NULL : &events[0], static_cast<unsigned int>(events.size()) );
 }
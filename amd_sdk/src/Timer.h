@@ -86,6 +86,26 @@
 *   This macro stalls the CPU until the result of a GPU timer is available.
 *   Since it forces the CPU to idle, this macro should not be used in time critical parts of your app.
 *
+* TIMER_GetPercentile( Cpu_Gpu, name, percentile )
+*   Estimate a percentile (0 to 100, e.g. 99 for the p99) of the per frame times of a timer, over all
+*   frames since the last TIMER_FullReset. Every timer keeps a fixed size histogram of its frame times
+*   for this (see TimerHistogram.h), so spikes that the averages hide can be found.
+*
+* TIMER_WriteCSV( fileName ) / TIMER_WriteChromeTrace( fileName )
+*   Write the timer tree with the last frame's times and the p50/p95/p99/max of each timer, either as
+*   CSV or as Chrome Trace Event JSON to open in chrome://tracing or Perfetto (see TimerExport.h).
+*
+* TIMER_Register( name )
+*   Returns a TimerHandle for a name, to be used with TIMER_BeginThread. Registering takes a lock,
+*   so do it once up front (e.g. into a static) and not inside the code being timed.
+*
+* TIMER_BeginThread( handle ) / TIMER_EndThread( ) / TIMER_ProfileThreadBlock( handle )
+*   CPU only counterparts of TIMER_Begin, TIMER_End and TIMER_ProfileCodeBlock that may be used from
+*   any thread. Each thread records into its own timer tree without locking or allocating, and
+*   TIMER_Reset merges all thread trees into the TimerEx tree (top level, same names summed over
+*   threads). Their times are therefore those of the previous frame, available from TIMER_GetTime
+*   for the whole of the current frame.
+*
 *
 * Classes
 * -------
@@ -104,7 +124,13 @@
 *     - Reset           : notify all timers that a new frame starts, remove unused timer events
 *     - Start           : start a timer
 *     - Stop            : stop a timer
+*     - RegisterTimer   : get the handle of a timer name, for use with StartThread
+*     - StartThread     : start a CPU timer on the calling thread, safe to use from any thread
+*     - StopThread      : stop a CPU timer on the calling thread
 *     - GetTime         : retrieve the timing result of a timer
+*     - GetPercentile   : estimate a percentile of the frame times of a timer
+*     - WriteCSV        : write the timer tree and its statistics as CSV
+*     - WriteChromeTrace: write the timer tree and its statistics as Chrome Trace Event JSON
 *     - GetTimer        : retrieve a TimerEvent*. This ptr should not be kept past a reset.
 *                         it can be used to manually iterate through the timer tree
 *
@@ -335,6 +361,30 @@
 *  TIMER_GetTime( Gpu, name );  TimerEx::Instance( ).GetTime( ttGpu, name [optional param bool stall CPU?] );
 *  TIMER_GetTime( Cpu, name );  TimerEx::Instance( ).GetTime( ttCpu, name [optional param is ignored] );
 *  TIMER_GetTimer( name );      TimerEx::Instance( ).GetTimer( name );
+*  TIMER_Register( name );      TimerEx::Instance( ).RegisterTimer( name );
+*  TIMER_BeginThread( handle ); TimerEx::Instance( ).StartThread( handle );
+*  TIMER_EndThread( );          TimerEx::Instance( ).StopThread( );
+*
+* Worker threads
+* --------------
+*
+*   // once, e.g. at initialization
+*   static const TimerHandle s_hCull = TIMER_Register( L"Cull" );
+*   static const TimerHandle s_hCullBatch = TIMER_Register( L"Batch" );
+*
+*   // on any number of worker threads, every frame
+*   {
+*     TIMER_ProfileThreadBlock( s_hCull );
+*     for( each batch )
+*     {
+*       TIMER_ProfileThreadBlock( s_hCullBatch );
+*       // cull the batch
+*     }
+*   }
+*
+*   // after the next TIMER_Reset( ), on the main thread: CPU time of the last frame summed over all threads
+*   double cull = TIMER_GetTime( Cpu, L"Cull" );
+*   double cullBatches = TIMER_GetTime( Cpu, L"Cull|Batch" );
 *
 * Timer
 * -----
@@ -410,10 +460,15 @@
 #ifndef _TIMER_H
 #define _TIMER_H
 
+#include <vector>
+
+#include "ThreadTimer.h"
+#include "TimerExport.h"
+#include "TimerHistogram.h"
+
 //namespace AMD
 //{
 
-#define USE_RDTSC 0
 #define WATCH_BAD_TS_VAL 0
 #define CHECK_DISJOINT   0
 
@@ -442,11 +497,17 @@ public:
     double GetSumTime();
     double GetTimeNumFrames();
 
+    // distribution of the per frame times, a frame ends with Reset( false )
+    const AMD::TimerHistogram& GetHistogram();
+    double GetPercentile( double percentile );
+
 protected:
     double          m_LastTime;
     double          m_SumTime;
     unsigned int    m_NumFrames;
 
+    AMD::TimerHistogram m_Histogram;
+
     virtual void FinishCollection() {}
 };
 
@@ -463,14 +524,12 @@ public:
     virtual void Stop();
 
     void Delay(double sec);
+    void AddTime(double sec);   // account time measured elsewhere, e.g. by ThreadTimer
 
 private:
-    LARGE_INTEGER m_startTime;
+    UINT64 m_startTime;
     double m_freq;
-
-#if USE_RDTSC
-    double m_freqRdtsc;
-#endif
+    bool   m_timed;     // time was added this frame, so it goes into the histogram
 };
 
 //-----------------------------------------------------------------------------
@@ -557,6 +616,8 @@ class TimingEvent
 public:
     double          GetTime         ( TimerType type, bool stall = false );
     double          GetAvgTime      ( TimerType type, bool stall = false );
+    double          GetPercentile   ( TimerType type, double percentile, bool stall = false );
+    const AMD::TimerHistogram* GetHistogram( TimerType type );  // NULL if there is no such timer
 
     TimingEvent*    GetTimer        ( LPCWSTR timerId );    // get a child-timer by name
     TimingEvent*    GetParent       ( );                    // walk through timer tree
@@ -572,7 +633,7 @@ private:
     TimingEvent( );
     virtual ~TimingEvent();
 
-    TimingEvent*    GetTimerRec         ( LPWSTR timerId );
+    static TimingEvent* FindTimer       ( TimingEvent* te, LPCWSTR timerId );   // walk a path from the siblings of te
     void            Reset               ( );
     void            Start               ( );
     void            Stop                ( );
@@ -593,6 +654,8 @@ private:
     TimingEvent*    m_next;
 };
 
+typedef AMD::ThreadTimer::Handle TimerHandle;
+
 class TimerEx
 {
 public:
@@ -614,20 +677,36 @@ public:
     void            Stop            ( );
     double          GetTime         ( TimerType type, LPCWSTR timerId, bool stall = false );
     double          GetAvgTime      ( TimerType type, LPCWSTR timerId, bool stall = false );
+    double          GetPercentile   ( TimerType type, LPCWSTR timerId, double percentile, bool stall = false );
     TimingEvent*    GetTimer        ( LPCWSTR timerId = NULL ); // returns the first child of root if NULL, else searches childnodes for timer with that name
 
+    // thread safe CPU timing, merged into the timer tree by Reset
+    TimerHandle     RegisterTimer   ( LPCWSTR timerId );        // takes a lock, register once and keep the handle
+    void            StartThread     ( TimerHandle timer );      // no lock, no allocation once the thread has seen the scope
+    void            StopThread      ( );
+
+    // export of the timer tree with the percentiles of every timer
+    bool            WriteCSV        ( LPCWSTR fileName );
+    bool            WriteChromeTrace( LPCWSTR fileName );
+
 private:
     TimerEx             ( );
     virtual ~TimerEx    ( );
 
     void Reset          ( TimingEvent* te, bool bResetSum );
     void DeleteTimerTree( TimingEvent* te );
+    TimingEvent* AddTimer( TimingEvent* parent, LPCWSTR timerId );
+    void MergeThreadTimers( );
+    void GetExportEvents( TimingEvent* te, unsigned int parent, unsigned int depth, std::vector<AMD::TimerExport::Event>& events );
 
 protected:
     ID3D11Device*   m_pDev;
     TimingEvent*    m_Root;     // timer tree
     TimingEvent*    m_Current;  // current position in timer tree
     TimingEvent*    m_Unused;   // unused timers (for faster reuse)
+
+    std::vector<AMD::ThreadTimer::MergedNode>   m_Merged;       // kept to avoid reallocating every frame
+    std::vector<TimingEvent*>                   m_MergedEvents;
 };
 
 #if ENABLE_AMD_TIMER
@@ -652,6 +731,15 @@ protected:
 #define TIMER_GetAvgTime( Cpu_Gpu, name )               \
     TimerEx::Instance( ).GetAvgTime( tt##Cpu_Gpu, name )
 
+#define TIMER_GetPercentile( Cpu_Gpu, name, percentile )    \
+    TimerEx::Instance( ).GetPercentile( tt##Cpu_Gpu, name, percentile )
+
+#define TIMER_WriteCSV( fileName )                  \
+    TimerEx::Instance( ).WriteCSV( fileName )
+
+#define TIMER_WriteChromeTrace( fileName )          \
+    TimerEx::Instance( ).WriteChromeTrace( fileName )
+
 // makros, analogue to PIX
 #define TIMER_Begin( col, name )                    \
     TimerEx::Instance( ).Start( name );
@@ -662,6 +750,15 @@ protected:
     TimerEx::Instance( ).Stop( );
 //      DXUT_EndPerfEvent( );
 //      D3DPERF_EndEvent( );
+
+#define TIMER_Register( name )                      \
+    TimerEx::Instance( ).RegisterTimer( name )
+
+#define TIMER_BeginThread( handle )                 \
+    TimerEx::Instance( ).StartThread( handle );
+
+#define TIMER_EndThread( )                          \
+    TimerEx::Instance( ).StopThread( );
 #else
 #define TIMER_Init( device )
 #define TIMER_Destroy( )
@@ -669,8 +766,14 @@ protected:
 #define TIMER_GetTime( Cpu_Gpu, name )          0
 #define TIMER_WaitForGpuAndGetTime( name )      0
 #define TIMER_GetAvgTime( Cpu_Gpu, name )       0
+#define TIMER_GetPercentile( Cpu_Gpu, name, percentile )    0
+#define TIMER_WriteCSV( fileName )              false
+#define TIMER_WriteChromeTrace( fileName )      false
 #define TIMER_Begin( col, name )
 #define TIMER_End( )
+#define TIMER_Register( name )                  0
+#define TIMER_BeginThread( handle )
+#define TIMER_EndThread( )
 #endif
 
 class TimerExHelper
@@ -687,11 +790,29 @@ public:
     }
 };
 
+class TimerExThreadHelper
+{
+public:
+    TimerExThreadHelper( TimerHandle timer )
+    {
+        (void)&timer;
+        TIMER_BeginThread( timer );
+    }
+    virtual ~TimerExThreadHelper( )
+    {
+        TIMER_EndThread( );
+    }
+};
+
 #if ENABLE_AMD_TIMER
 #define TIMER_ProfileCodeBlock( col, name )         \
     TimerExHelper __codeblock_timer( col, name );
+
+#define TIMER_ProfileThreadBlock( handle )          \
+    TimerExThreadHelper __codeblock_thread_timer( handle );
 #else
 #define TIMER_ProfileCodeBlock( col, name )
+#define TIMER_ProfileThreadBlock( handle )
 #endif
 //} // namespace AMD
 
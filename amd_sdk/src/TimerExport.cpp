@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: TimerExport.cpp
+//
+// Class implementation for the TimerExport interface.
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <cstdlib>
+#include <cwchar>
+#endif
+
+#include <vector>
+
+#include "TimerExport.h"
+
+using namespace AMD;
+
+
+static const double s_fPercentiles[] = { 50.0, 95.0, 99.0 };
+static const unsigned int s_uNumPercentiles = sizeof( s_fPercentiles ) / sizeof( s_fPercentiles[0] );
+
+
+//--------------------------------------------------------------------------------------
+// Files
+//--------------------------------------------------------------------------------------
+FILE* TimerExport::OpenFile( const wchar_t* pwsPathName )
+{
+    FILE* pFile = NULL;
+
+#if defined(_WIN32)
+    _wfopen_s( &pFile, pwsPathName, L"wb" );
+#else
+    std::vector<char> pathName( wcslen( pwsPathName ) * MB_CUR_MAX + 1 );
+    if( wcstombs( &pathName[0], pwsPathName, pathName.size() ) != (size_t)-1 )
+    {
+        pFile = fopen( &pathName[0], "wb" );
+    }
+#endif
+
+    return pFile;
+}
+
+
+bool TimerExport::CloseFile( FILE* pFile )
+{
+    const bool bWritten = ( 0 == ferror( pFile ) );
+    fclose( pFile );
+
+    return bWritten;
+}
+
+
+//--------------------------------------------------------------------------------------
+// CSV
+//--------------------------------------------------------------------------------------
+bool TimerExport::WriteCSV( const wchar_t* pwsPathName, const Event* pEvents, unsigned int uNumEvents )
+{
+    FILE* pFile = OpenFile( pwsPathName );
+    if( !pFile )
+    {
+        return false;
+    }
+
+    WriteCSV( pFile, pEvents, uNumEvents );
+
+    return CloseFile( pFile );
+}
+
+
+void TimerExport::WriteCSV( FILE* pFile, const Event* pEvents, unsigned int uNumEvents )
+{
+    fputs( "path,depth"
+        ",cpu_ms,cpu_mean_ms,cpu_p50_ms,cpu_p95_ms,cpu_p99_ms,cpu_max_ms,cpu_frames"
+        ",gpu_ms,gpu_mean_ms,gpu_p50_ms,gpu_p95_ms,gpu_p99_ms,gpu_max_ms,gpu_frames\r\n", pFile );
+
+    for( unsigned int i = 0; i < uNumEvents; i++ )
+    {
+        const Event& event = pEvents[i];
+
+        fputc( '"', pFile );
+        WriteCSVPath( pFile, pEvents, i );
+        fprintf( pFile, "\",%u", event.m_uDepth );
+        WriteCSVStatistics( pFile, event.m_fCpuTime, event.m_pCpuHistogram );
+        WriteCSVStatistics( pFile, event.m_fGpuTime, event.m_pGpuHistogram );
+        fputs( "\r\n", pFile );
+    }
+}
+
+
+// Writes the names from the top level down to the event, separated by |
+void TimerExport::WriteCSVPath( FILE* pFile, const Event* pEvents, unsigned int uEvent )
+{
+    if( m_uNO_PARENT != pEvents[uEvent].m_uParent )
+    {
+        WriteCSVPath( pFile, pEvents, pEvents[uEvent].m_uParent );
+        fputc( '|', pFile );
+    }
+
+    WriteString( pFile, pEvents[uEvent].m_wsName, true );
+}
+
+
+// Empty fields if there is no such timer
+void TimerExport::WriteCSVStatistics( FILE* pFile, double fTime, const TimerHistogram* pHistogram )
+{
+    if( NULL == pHistogram )
+    {
+        fputs( ",,,,,,,", pFile );
+        return;
+    }
+
+    fprintf( pFile, ",%.4f,%.4f", fTime * 1000.0, pHistogram->GetMean() * 1000.0 );
+
+    for( unsigned int i = 0; i < s_uNumPercentiles; i++ )
+    {
+        fprintf( pFile, ",%.4f", pHistogram->GetPercentile( s_fPercentiles[i] ) * 1000.0 );
+    }
+
+    fprintf( pFile, ",%.4f,%u", pHistogram->GetMax() * 1000.0, pHistogram->GetCount() );
+}
+
+
+//--------------------------------------------------------------------------------------
+// Chrome Trace Event JSON
+//--------------------------------------------------------------------------------------
+bool TimerExport::WriteChromeTrace( const wchar_t* pwsPathName, const Event* pEvents, unsigned int uNumEvents )
+{
+    FILE* pFile = OpenFile( pwsPathName );
+    if( !pFile )
+    {
+        return false;
+    }
+
+    WriteChromeTrace( pFile, pEvents, uNumEvents );
+
+    return CloseFile( pFile );
+}
+
+
+void TimerExport::WriteChromeTrace( FILE* pFile, const Event* pEvents, unsigned int uNumEvents )
+{
+    fputs( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}", pFile );
+
+    WriteTraceTrack( pFile, pEvents, uNumEvents, false );
+    WriteTraceTrack( pFile, pEvents, uNumEvents, true );
+
+    fputs( "\n]}\n", pFile );
+}
+
+
+// Writes the complete ("X") events of the CPU or GPU track
+void TimerExport::WriteTraceTrack( FILE* pFile, const Event* pEvents, unsigned int uNumEvents, bool bGpu )
+{
+    // Where the next child of each event starts, in microseconds
+    std::vector<double> nextStart( uNumEvents, 0.0 );
+    double fNextTopLevelStart = 0.0;
+
+    for( unsigned int i = 0; i < uNumEvents; i++ )
+    {
+        const Event& event = pEvents[i];
+        const TimerHistogram* pHistogram = bGpu ? event.m_pGpuHistogram : event.m_pCpuHistogram;
+        const double fDuration = ( bGpu ? event.m_fGpuTime : event.m_fCpuTime ) * 1000000.0;
+
+        double& fStart = ( m_uNO_PARENT == event.m_uParent ) ? fNextTopLevelStart : nextStart[event.m_uParent];
+        nextStart[i] = fStart;
+
+        if( NULL == pHistogram )
+        {
+            continue;
+        }
+
+        fputs( ",\n{\"name\":", pFile );
+        WriteString( pFile, event.m_wsName, false );
+        fprintf( pFile, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"mean_ms\":%.4f",
+            bGpu ? "gpu" : "cpu", bGpu ? 2 : 1, fStart, fDuration, pHistogram->GetMean() * 1000.0 );
+
+        for( unsigned int j = 0; j < s_uNumPercentiles; j++ )
+        {
+            fprintf( pFile, ",\"p%.0f_ms\":%.4f", s_fPercentiles[j], pHistogram->GetPercentile( s_fPercentiles[j] ) * 1000.0 );
+        }
+
+        fprintf( pFile, ",\"max_ms\":%.4f,\"frames\":%u}}", pHistogram->GetMax() * 1000.0, pHistogram->GetCount() );
+
+        fStart += fDuration;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Writes a string as UTF-8, escaped for a JSON string or a quoted CSV field
+//--------------------------------------------------------------------------------------
+void TimerExport::WriteString( FILE* pFile, const wchar_t* pwsString, bool bCSV )
+{
+    if( !bCSV )
+    {
+        fputc( '"', pFile );
+    }
+
+    for( const wchar_t* pChar = pwsString ? pwsString : L""; *pChar; pChar++ )
+    {
+        unsigned int uChar = (unsigned int)*pChar;
+
+        if( bCSV && uChar == '"' )
+        {
+            fputs( "\"\"", pFile );
+        }
+        else if( !bCSV && ( uChar == '"' || uChar == '\\' ) )
+        {
+            fputc( '\\', pFile );
+            fputc( (int)uChar, pFile );
+        }
+        else if( !bCSV && uChar < 0x20 )
+        {
+            fprintf( pFile, "\\u%04x", uChar );
+        }
+        else if( uChar < 0x80 )
+        {
+            fputc( (int)uChar, pFile );
+        }
+        else if( uChar < 0x800 )
+        {
+            fputc( (int)( 0xC0 | ( uChar >> 6 ) ), pFile );
+            fputc( (int)( 0x80 | ( uChar & 0x3F ) ), pFile );
+        }
+        else if( uChar >= 0xD800 && uChar <= 0xDFFF )
+        {
+            // UTF-16 surrogates (wchar_t is 16 bit on Windows) are not encoded, names are expected to be plain text
+            fputc( '?', pFile );
+        }
+        else if( uChar < 0x10000 )
+        {
+            fputc( (int)( 0xE0 | ( uChar >> 12 ) ), pFile );
+            fputc( (int)( 0x80 | ( ( uChar >> 6 ) & 0x3F ) ), pFile );
+            fputc( (int)( 0x80 | ( uChar & 0x3F ) ), pFile );
+        }
+        else
+        {
+            fputc( (int)( 0xF0 | ( uChar >> 18 ) ), pFile );
+            fputc( (int)( 0x80 | ( ( uChar >> 12 ) & 0x3F ) ), pFile );
+            fputc( (int)( 0x80 | ( ( uChar >> 6 ) & 0x3F ) ), pFile );
+            fputc( (int)( 0x80 | ( uChar & 0x3F ) ), pFile );
+        }
+    }
+
+    if( !bCSV )
+    {
+        fputc( '"', pFile );
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: TimerExport.h
+//
+// Class definition for the TimerExport interface. Writes a tree of timing events (as kept by
+// TimerEx) with their percentile statistics, either as CSV with one row per event, or as Chrome
+// Trace Event JSON that opens in chrome://tracing, Perfetto and other trace viewers. The trace
+// lays out the last frame: each event starts where its previous sibling ended, on a CPU and a
+// GPU track, with the percentiles in the event's args.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <cstdio>
+
+#include "TimerHistogram.h"
+
+namespace AMD
+{
+
+    class TimerExport
+    {
+    public:
+
+        static const unsigned int m_uNO_PARENT = 0xFFFFFFFF;
+
+        // One timing event, parents come before their children
+        struct Event
+        {
+            const wchar_t*          m_wsName;
+            unsigned int            m_uParent;          // Index of the parent event, m_uNO_PARENT at the top level
+            unsigned int            m_uDepth;
+            double                  m_fCpuTime;         // Seconds, last frame
+            double                  m_fGpuTime;
+            const TimerHistogram*   m_pCpuHistogram;    // NULL if there is no such timer
+            const TimerHistogram*   m_pGpuHistogram;
+        };
+
+        // CSV, with the path of each event, its last time and percentiles in milliseconds
+        static bool WriteCSV( const wchar_t* pwsPathName, const Event* pEvents, unsigned int uNumEvents );
+        static void WriteCSV( FILE* pFile, const Event* pEvents, unsigned int uNumEvents );
+
+        // Chrome Trace Event JSON, times in microseconds
+        static bool WriteChromeTrace( const wchar_t* pwsPathName, const Event* pEvents, unsigned int uNumEvents );
+        static void WriteChromeTrace( FILE* pFile, const Event* pEvents, unsigned int uNumEvents );
+
+    private:
+
+        static FILE* OpenFile( const wchar_t* pwsPathName );
+        static bool CloseFile( FILE* pFile );
+        static void WriteCSVPath( FILE* pFile, const Event* pEvents, unsigned int uEvent );
+        static void WriteCSVStatistics( FILE* pFile, double fTime, const TimerHistogram* pHistogram );
+        static void WriteTraceTrack( FILE* pFile, const Event* pEvents, unsigned int uNumEvents, bool bGpu );
+        static void WriteString( FILE* pFile, const wchar_t* pwsString, bool bCSV );
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: TimerHistogram.cpp
+//
+// Class implementation for the TimerHistogram interface.
+//--------------------------------------------------------------------------------------
+
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#else
+#include <cassert>
+#include <cstring>
+#endif
+
+#include <cmath>
+
+#include "TimerHistogram.h"
+
+using namespace AMD;
+
+
+static const double s_fRelativeAccuracy = 0.01;
+static const double s_fMinTime = 1.0e-6;
+static const double s_fMaxTime = 10.0;
+static const double s_fGamma = ( 1.0 + s_fRelativeAccuracy ) / ( 1.0 - s_fRelativeAccuracy );
+static const double s_fLogGamma = 0.020000666706669435;    // log( s_fGamma ), a constant so Timers in other static objects can use it
+
+
+//--------------------------------------------------------------------------------------
+// Construction
+//--------------------------------------------------------------------------------------
+TimerHistogram::TimerHistogram()
+{
+    // The bucket count is fixed so the histogram needs no allocation, check it covers the range
+    assert( m_uNUM_BUCKETS == 2 + (unsigned int)ceil( log( s_fMaxTime / s_fMinTime ) / s_fLogGamma ) );
+    assert( fabs( s_fLogGamma - log( s_fGamma ) ) < 1.0e-15 );
+
+    Reset();
+}
+
+
+void TimerHistogram::Reset()
+{
+    memset( m_uBuckets, 0, sizeof( m_uBuckets ) );
+    m_uCount = 0;
+    m_fSum = 0.0;
+    m_fMin = 0.0;
+    m_fMax = 0.0;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Adds one time
+//--------------------------------------------------------------------------------------
+void TimerHistogram::Add( double fTime )
+{
+    m_uBuckets[GetBucket( fTime )]++;
+
+    if( 0 == m_uCount || fTime < m_fMin )
+    {
+        m_fMin = fTime;
+    }
+    if( 0 == m_uCount || fTime > m_fMax )
+    {
+        m_fMax = fTime;
+    }
+
+    m_uCount++;
+    m_fSum += fTime;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Estimates a percentile: the time of the bucket holding the sample of that rank
+//--------------------------------------------------------------------------------------
+double TimerHistogram::GetPercentile( double fPercentile ) const
+{
+    if( 0 == m_uCount )
+    {
+        return 0.0;
+    }
+
+    if( fPercentile <= 0.0 )
+    {
+        return m_fMin;
+    }
+    if( fPercentile >= 100.0 )
+    {
+        return m_fMax;
+    }
+
+    const double fRank = fPercentile / 100.0 * ( m_uCount - 1 );
+
+    unsigned int uBucket = 0;
+    double fCount = m_uBuckets[0];
+    while( fCount <= fRank && uBucket + 1 < m_uNUM_BUCKETS )
+    {
+        uBucket++;
+        fCount += m_uBuckets[uBucket];
+    }
+
+    // The under- and overflow buckets have no time of their own, and no estimate
+    // should lie outside the times that were actually added
+    double fTime = GetBucketTime( uBucket );
+    if( fTime < m_fMin || 0 == uBucket )
+    {
+        fTime = m_fMin;
+    }
+    if( fTime > m_fMax || m_uNUM_BUCKETS - 1 == uBucket )
+    {
+        fTime = m_fMax;
+    }
+
+    return fTime;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Bucket mapping
+//--------------------------------------------------------------------------------------
+unsigned int TimerHistogram::GetBucket( double fTime )
+{
+    if( !( fTime > s_fMinTime ) )
+    {
+        return 0;
+    }
+
+    const double fBucket = ceil( log( fTime / s_fMinTime ) / s_fLogGamma );
+    if( fBucket >= (double)( m_uNUM_BUCKETS - 1 ) )
+    {
+        return m_uNUM_BUCKETS - 1;
+    }
+
+    return ( fBucket < 1.0 ) ? 1 : (unsigned int)fBucket;
+}
+
+
+// The time within 1% of every time in the bucket
+double TimerHistogram::GetBucketTime( unsigned int uBucket )
+{
+    return s_fMinTime * 2.0 * pow( s_fGamma, (double)uBucket ) / ( s_fGamma + 1.0 );
+}
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
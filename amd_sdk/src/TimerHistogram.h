@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: TimerHistogram.h
+//
+// Class definition for the TimerHistogram interface. A fixed size histogram of frame times
+// with logarithmic buckets (as in DDSketch), so percentiles can be estimated for every timer
+// without keeping the samples: any percentile is within 1% of the true sample value between
+// 1 microsecond and 10 seconds. Minimum, maximum and mean are exact.
+//--------------------------------------------------------------------------------------
+
+
+#pragma once
+
+namespace AMD
+{
+
+    class TimerHistogram
+    {
+    public:
+
+        // Bucket 0 holds times up to 1us, the last bucket times over 10s,
+        // bucket i in between holds ( 1us * gamma^(i-1), 1us * gamma^i ], gamma = 1.01 / 0.99
+        static const unsigned int m_uNUM_BUCKETS = 808;
+
+        // Construction
+        TimerHistogram();
+
+        // Adds one time, in seconds
+        void Add( double fTime );
+        void Reset();
+
+        // Estimates a percentile (0 to 100) of the times added, 0 if none were
+        double GetPercentile( double fPercentile ) const;
+
+        unsigned int GetCount() const { return m_uCount; }
+        double GetMin() const { return m_fMin; }
+        double GetMax() const { return m_fMax; }
+        double GetMean() const { return ( m_uCount > 0 ) ? m_fSum / m_uCount : 0.0; }
+
+    private:
+
+        static unsigned int GetBucket( double fTime );
+        static double GetBucketTime( unsigned int uBucket );
+
+        // Private data
+        unsigned int    m_uBuckets[m_uNUM_BUCKETS];
+        unsigned int    m_uCount;
+        double          m_fSum;
+        double          m_fMin;
+        double          m_fMax;
+    };
+
+} // namespace AMD
+
+
+//--------------------------------------------------------------------------------------
+// EOF
+//--------------------------------------------------------------------------------------
@@ -55,7 +55,8 @@ typedef unsigned short  crc;
 
 #elif defined(CRC32)
 
-typedef unsigned long  crc;
+/* unsigned long is 64 bits on LP64 hosts, WIDTH has to be 32 */
+typedef unsigned int  crc;
 
 #define CRC_NAME      "CRC-32"
 #define POLYNOMIAL      0x04C11DB7
@@ -0,0 +1,303 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderCacheBench.cpp
+//
+// Memory and throughput of ShaderCache with many synthetic permutations:
+//
+//   sdk_shader_cache_bench --fxc path [--shaders N] [--generate N]
+//
+// N permutations (10000 by default) of one pixel shader, four macros each, are registered
+// with AddShader. The heap is counted through the global operator new, so the bytes per
+// permutation include the interned strings and the vector of shaders, next to the
+// AddShader rate. Then the first --generate permutations (256 by default, 0 skips it) go
+// through a cold generation that compiles them all, a warm one where every hash hits, and a
+// cached one that skips preprocessing, with the time per permutation of each.
+//
+// ShaderCache needs the sample directory layout and an fxc in the Windows 10 SDK: they are
+// made under ShaderCacheBench in the current directory, with --fxc (a real fxc.exe, or the
+// stub compiler of the tests) copied in as fxc.exe.
+//--------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include "..\\..\\DXUT\\Core\\DXUT.h"
+#include "..\\..\\DXUT\\Optional\\SDKmisc.h"
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#include "DXUT.h"
+#include "SDKmisc.h"
+#endif
+
+#include "ShaderCache.h"
+#if !defined(_WIN32)
+#include "AMD_AOFX.h"
+#endif
+
+using namespace AMD;
+
+//--------------------------------------------------------------------------------------
+// Heap accounting: every allocation carries its size in front of it
+//--------------------------------------------------------------------------------------
+static std::atomic<long long> s_HeapBytes(0);
+static std::atomic<long long> s_HeapAllocations(0);
+
+static const size_t HEADER_SIZE = 16;
+
+static void * allocate(size_t uSize)
+{
+    char * pBlock = (char *)malloc(uSize + HEADER_SIZE);
+    if (!pBlock) throw std::bad_alloc();
+    *(size_t *)pBlock = uSize;
+    s_HeapBytes += (long long)uSize;
+    s_HeapAllocations++;
+    return pBlock + HEADER_SIZE;
+}
+
+static void release(void * p)
+{
+    if (!p) return;
+    char * pBlock = (char *)p - HEADER_SIZE;
+    s_HeapBytes -= (long long)*(size_t *)pBlock;
+    s_HeapAllocations--;
+    free(pBlock);
+}
+
+void * operator new(size_t uSize) { return allocate(uSize); }
+void * operator new[](size_t uSize) { return allocate(uSize); }
+void operator delete(void * p) noexcept { release(p); }
+void operator delete[](void * p) noexcept { release(p); }
+
+//--------------------------------------------------------------------------------------
+// The sample layout
+//--------------------------------------------------------------------------------------
+static std::string s_Root;
+
+static bool makeDirectory(const std::string & pathName)
+{
+#if defined(_WIN32)
+    return _mkdir(pathName.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(pathName.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+static bool copyExecutable(const char * pSource, const std::string & target)
+{
+    FILE * pSourceFile = fopen(pSource, "rb");
+    FILE * pTargetFile = fopen(target.c_str(), "wb");
+    bool bCopied = pSourceFile && pTargetFile;
+    char buffer[65536];
+    size_t uRead;
+    while (bCopied && (uRead = fread(buffer, 1, sizeof(buffer), pSourceFile)) > 0)
+    {
+        bCopied = fwrite(buffer, 1, uRead, pTargetFile) == uRead;
+    }
+    if (pSourceFile) fclose(pSourceFile);
+    if (pTargetFile) bCopied = (fclose(pTargetFile) == 0) && bCopied;
+#if !defined(_WIN32)
+    bCopied = bCopied && chmod(target.c_str(), 0755) == 0;
+#endif
+    return bCopied;
+}
+
+static bool layOut(const char * pFxc)
+{
+    char currentDir[MAX_PATH * 4];
+    if (!getcwd(currentDir, sizeof(currentDir))) return false;
+    s_Root = std::string(currentDir) + "/ShaderCacheBench";
+
+    const char * pDirectories[] = { "", "/bin", "/src", "/src/Shaders", "/sdk", "/sdk/Windows Kits", "/sdk/Windows Kits/10", "/sdk/Windows Kits/10/bin", "/sdk/Windows Kits/10/bin/x64" };
+    for (size_t i = 0; i < ARRAYSIZE(pDirectories); i++)
+    {
+        if (!makeDirectory(s_Root + pDirectories[i])) return false;
+    }
+    if (!copyExecutable(pFxc, s_Root + "/sdk/Windows Kits/10/bin/x64/fxc.exe")) return false;
+
+    FILE * pFile = fopen((s_Root + "/src/Shaders/Bench.hlsl").c_str(), "wb");
+    if (!pFile) return false;
+    fputs("float4 PS_Bench() : SV_Target { return float4(AO_LAYERS, AO_SAMPLES, AO_NORMALS, AO_TAP); }\n", pFile);
+    fclose(pFile);
+
+#if defined(_WIN32)
+    _putenv_s("ProgramFiles(x86)", (s_Root + "/sdk").c_str());
+#else
+    setenv("ProgramFiles(x86)", (s_Root + "/sdk").c_str(), 1);
+    unsetenv("AMD_SDK_SHARED_SHADER_CACHE_DIR");
+#endif
+    return chdir((s_Root + "/bin").c_str()) == 0;
+}
+
+static double nowMs()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The permutation with the given index, every index gives other macro values
+static void addPermutation(ShaderCache & cache, unsigned int uIndex, ID3D11PixelShader ** ppShader)
+{
+    static const wchar_t * pwsNames[] = { L"AO_LAYERS", L"AO_SAMPLES", L"AO_NORMALS", L"AO_TAP" };
+    ShaderCache::Macro macros[4];
+    for (unsigned int m = 0; m < 4; m++)
+    {
+        wcscpy_s(macros[m].m_wsName, pwsNames[m]);
+        macros[m].m_iValue = (int)((uIndex >> (m * 8)) & 0xFF);
+    }
+    cache.AddShader((ID3D11DeviceChild **)ppShader, ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PS_Bench", L"Bench.hlsl", 4, macros, NULL, NULL, 0);
+}
+
+// Milliseconds until the shaders are ready, -1 if they never are
+static double generate(ShaderCache & cache, ShaderCache::CREATE_TYPE createType)
+{
+    CDXUTTextHelper textHelper;
+    const double fStartMs = nowMs();
+    cache.GenerateShaders(createType);
+    for (;;)
+    {
+        cache.RenderProgress(&textHelper, 15, DirectX::XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f));
+        if (cache.ShadersReady()) return nowMs() - fStartMs;
+        if (nowMs() - fStartMs > 600000.0) return -1.0;
+        Sleep(1);
+    }
+}
+
+static int usage()
+{
+    fprintf(stderr, "usage: sdk_shader_cache_bench --fxc path [--shaders N] [--generate N]\n");
+    return 1;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * pFxc = NULL;
+    unsigned int uShaders = 10000, uGenerate = 256;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--fxc") == 0 && i + 1 < argc)
+            pFxc = argv[++i];
+        else if (strcmp(argv[i], "--shaders") == 0 && i + 1 < argc)
+            uShaders = (unsigned int)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc)
+            uGenerate = (unsigned int)atoi(argv[++i]);
+        else
+            return usage();
+    }
+    if (!pFxc || uShaders == 0 || uShaders > (1u << 24) || uGenerate > uShaders) return usage();
+
+    if (!layOut(pFxc))
+    {
+        fprintf(stderr, "cannot lay out the sample under %s\n", s_Root.c_str());
+        return 1;
+    }
+
+#if !defined(_WIN32)
+    ID3D11Device * pDevice = NULL;
+    ID3D11DeviceContext * pContext = NULL;
+    AOFX_CreateNullDevice(&pDevice, &pContext);
+    CompatDXUT::device() = pDevice;
+#endif
+
+    int iResult = 0;
+    {
+        std::vector<ID3D11PixelShader *> shaders(uShaders, NULL);
+
+        const long long iHeapBefore = s_HeapBytes;
+        const long long iAllocationsBefore = s_HeapAllocations;
+        ShaderCache * pCache = new ShaderCache(ShaderCache::SHADER_AUTO_RECOMPILE_DISABLED, ShaderCache::ERROR_DISPLAY_IN_DEBUG_OUTPUT);
+        const long long iHeapEmpty = s_HeapBytes;
+
+        const double fStartMs = nowMs();
+        for (unsigned int i = 0; i < uShaders; i++)
+        {
+            addPermutation(*pCache, i, &shaders[i]);
+        }
+        const double fAddMs = nowMs() - fStartMs;
+        const long long iHeapAdded = s_HeapBytes;
+
+        printf("%u permutations, sizeof(Shader) %u bytes\n", uShaders, (unsigned int)sizeof(ShaderCache::Shader));
+        printf("  empty cache       %10.1f KB\n", (iHeapEmpty - iHeapBefore) / 1024.0);
+        printf("  with permutations %10.1f KB, %.0f bytes per permutation, %.1f allocations per permutation\n",
+            (iHeapAdded - iHeapBefore) / 1024.0, (double)(iHeapAdded - iHeapEmpty) / uShaders,
+            (double)(s_HeapAllocations - iAllocationsBefore) / uShaders);
+        printf("  AddShader         %10.1f ms, %.0f permutations/s\n", fAddMs, fAddMs > 0.0 ? uShaders * 1000.0 / fAddMs : 0.0);
+        delete pCache;
+
+        if (uGenerate > 0)
+        {
+            ShaderCache cache(ShaderCache::SHADER_AUTO_RECOMPILE_DISABLED, ShaderCache::ERROR_DISPLAY_IN_DEBUG_OUTPUT);
+            for (unsigned int i = 0; i < uGenerate; i++)
+            {
+                addPermutation(cache, i, &shaders[i]);
+            }
+
+            static const struct { ShaderCache::CREATE_TYPE m_eType; const char * m_pName; } generations[] =
+            {
+                { ShaderCache::CREATE_TYPE_FORCE_COMPILE, "cold (compile all)" },
+                { ShaderCache::CREATE_TYPE_COMPILE_CHANGES, "warm (hash hits)" },
+                { ShaderCache::CREATE_TYPE_USE_CACHED, "cached" },
+            };
+
+            printf("%u permutations generated\n", uGenerate);
+            printf("  %-20s  %10s  %12s  %8s  %8s\n", "generation", "ms", "ms/shader", "compiled", "hit rate");
+            for (size_t g = 0; g < ARRAYSIZE(generations); g++)
+            {
+                const double fMs = generate(cache, generations[g].m_eType);
+
+                std::vector<ShaderTelemetry::Record> records;
+                ShaderTelemetry::Summary summary;
+                cache.GetShaderTelemetry(records, summary);
+
+                printf("  %-20s  %10.1f  %12.3f  %8u  %8.2f\n", generations[g].m_pName, fMs, fMs / uGenerate, summary.m_uNumCompiled, summary.m_fHitRate);
+                if (fMs < 0.0 || cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE) != uGenerate)
+                {
+                    printf("  %u of %u permutations were created\n", cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), uGenerate);
+                    iResult = 1;
+                }
+            }
+
+            for (unsigned int i = 0; i < uGenerate; i++)
+            {
+                SAFE_RELEASE(shaders[i]);
+            }
+        }
+    }
+
+#if !defined(_WIN32)
+    SAFE_RELEASE(pContext);
+    SAFE_RELEASE(pDevice);
+#endif
+
+    return iResult;
+}
@@ -0,0 +1,245 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+// File: ThreadTimerBench.cpp
+//
+// Per scope cost of ThreadTimer::Start/Stop, from 1 to 32 threads recording at once:
+//
+//   sdk_thread_timer_bench [--threads N] [--scopes N] [--budget nanoseconds] [--enforce]
+//
+// Every thread count (powers of two up to --threads, 32 by default) runs the same loop of two
+// nested scopes per thread, once untimed and once timed, while the main thread merges every
+// millisecond as TimerEx::Reset would at frame end. The difference in thread CPU time, so more
+// threads than cores do not count each other's time slices, is reported as ns per scope,
+// averaged over the threads and for the slowest one, next to the cost of a merge. Scopes the
+// merges did not hand out are an error. Thread counts over the budget (100 ns by default) are
+// flagged; --enforce turns them into a non zero exit code. The timing depends on the host, so
+// the test build only runs it unenforced.
+//--------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "ThreadTimer.h"
+
+using namespace AMD;
+
+struct Run
+{
+    double              m_NanosecondsPerScope;      // Averaged over the threads
+    double              m_MaxNanosecondsPerScope;   // The slowest thread
+    unsigned int        m_uMerges;
+    double              m_MicrosecondsPerMerge;
+    unsigned long long  m_uScopesMerged;
+};
+
+// CPU time of the calling thread in 100 ns units
+static unsigned long long threadTime()
+{
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    return (((unsigned long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime) +
+        (((unsigned long long)user.dwHighDateTime << 32) | user.dwLowDateTime);
+}
+
+// The work inside the scopes, the same in the untimed and the timed loop, on a thread's own sink
+static void work(volatile unsigned int & io_uSink, unsigned int i)
+{
+    io_uSink = io_uSink + i;
+}
+
+// Runs uScopes iterations on every thread, two nested scopes each if bTimed, and returns the
+// CPU time of every thread. The calling thread merges every millisecond until the threads are done.
+static std::vector<unsigned long long> runThreads(unsigned int uThreads, unsigned int uScopes, bool bTimed,
+    ThreadTimer::Handle hOuter, ThreadTimer::Handle hInner, Run & io_Run)
+{
+    ThreadTimer & timer = ThreadTimer::Instance();
+    std::vector<unsigned long long> times(uThreads, 0);
+    std::atomic<unsigned int> uReady(0), uDone(0);
+    std::atomic<bool> bStart(false);
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < uThreads; t++)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            // the first scope allocates this thread's nodes, keep it out of the measurement
+            if (bTimed)
+            {
+                timer.Start(hOuter);
+                timer.Start(hInner);
+                timer.Stop();
+                timer.Stop();
+            }
+
+            volatile unsigned int uSink = 0;
+            uReady++;
+            while (!bStart)
+            {
+                std::this_thread::yield();
+            }
+
+            unsigned long long uStart = threadTime();
+            if (bTimed)
+            {
+                for (unsigned int i = 0; i < uScopes; i++)
+                {
+                    timer.Start(hOuter);
+                    timer.Start(hInner);
+                    work(uSink, i);
+                    timer.Stop();
+                    timer.Stop();
+                }
+            }
+            else
+            {
+                for (unsigned int i = 0; i < uScopes; i++)
+                {
+                    work(uSink, i);
+                }
+            }
+            times[t] = threadTime() - uStart;
+            uDone++;
+        }));
+    }
+
+    while (uReady < uThreads)
+    {
+        std::this_thread::yield();
+    }
+    std::vector<ThreadTimer::MergedNode> nodes;
+    timer.Merge(nodes);
+    bStart = true;
+
+    // frame end merges while the threads record
+    const unsigned long long uMergeInterval = (unsigned long long)(ThreadTimer::GetTicksPerSecond() / 1000.0);
+    unsigned long long uMergeTicks = 0, uLastMerge = ThreadTimer::GetTicks();
+    bool bDone = false;
+    while (!bDone)
+    {
+        bDone = (uDone == uThreads);
+        if (!bDone && ThreadTimer::GetTicks() - uLastMerge < uMergeInterval)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        unsigned long long uStart = ThreadTimer::GetTicks();
+        timer.Merge(nodes);
+        uLastMerge = ThreadTimer::GetTicks();
+        uMergeTicks += uLastMerge - uStart;
+        io_Run.m_uMerges++;
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            io_Run.m_uScopesMerged += nodes[i].m_uCount;
+        }
+    }
+
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        threads[t].join();
+    }
+
+    io_Run.m_MicrosecondsPerMerge = 1000000.0 * uMergeTicks / ThreadTimer::GetTicksPerSecond() / io_Run.m_uMerges;
+    return times;
+}
+
+static Run measure(unsigned int uThreads, unsigned int uScopes, ThreadTimer::Handle hOuter, ThreadTimer::Handle hInner)
+{
+    Run untimed, timed;
+    memset(&untimed, 0, sizeof(untimed));
+    memset(&timed, 0, sizeof(timed));
+    std::vector<unsigned long long> baseline = runThreads(uThreads, uScopes, false, hOuter, hInner, untimed);
+    std::vector<unsigned long long> times = runThreads(uThreads, uScopes, true, hOuter, hInner, timed);
+
+    // two scopes per iteration, times are in 100 ns units
+    double sum = 0.0;
+    for (unsigned int t = 0; t < uThreads; t++)
+    {
+        double overhead = ((double)times[t] - (double)baseline[t]) * 100.0 / (2.0 * uScopes);
+        overhead = overhead > 0.0 ? overhead : 0.0;
+        sum += overhead;
+        timed.m_MaxNanosecondsPerScope = overhead > timed.m_MaxNanosecondsPerScope ? overhead : timed.m_MaxNanosecondsPerScope;
+    }
+    timed.m_NanosecondsPerScope = sum / uThreads;
+    return timed;
+}
+
+static int usage()
+{
+    fprintf(stderr, "usage: sdk_thread_timer_bench [--threads N] [--scopes N] [--budget nanoseconds] [--enforce]\n");
+    return 1;
+}
+
+int main(int argc, char ** argv)
+{
+    unsigned int uMaxThreads = 32, uScopes = 1000000;
+    double budgetNanoseconds = 100.0;
+    bool enforce = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            uMaxThreads = (unsigned int)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scopes") == 0 && i + 1 < argc)
+            uScopes = (unsigned int)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+            budgetNanoseconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--enforce") == 0)
+            enforce = true;
+        else
+            return usage();
+    }
+    if (uMaxThreads == 0 || uMaxThreads > 32 || uScopes == 0 || budgetNanoseconds <= 0.0) return usage();
+
+    ThreadTimer & timer = ThreadTimer::Instance();
+    ThreadTimer::Handle hOuter = timer.Register(L"Bench Outer");
+    ThreadTimer::Handle hInner = timer.Register(L"Bench Inner");
+
+    printf("%u scopes per thread, %u hardware threads, budget %.1f ns\n", uScopes * 2, std::thread::hardware_concurrency(), budgetNanoseconds);
+    printf("%7s  %8s  %8s  %6s  %8s  %s\n", "threads", "ns/scope", "max ns", "merges", "us/merge", "");
+
+    unsigned int uOverBudget = 0, uLost = 0;
+    for (unsigned int uThreads = 1; uThreads <= uMaxThreads; uThreads = (uThreads * 2 > uMaxThreads && uThreads < uMaxThreads) ? uMaxThreads : uThreads * 2)
+    {
+        Run run = measure(uThreads, uScopes, hOuter, hInner);
+        bool over = run.m_NanosecondsPerScope > budgetNanoseconds;
+        bool lost = run.m_uScopesMerged != 2ull * uScopes * uThreads;
+        uOverBudget += over ? 1 : 0;
+        uLost += lost ? 1 : 0;
+
+        printf("%7u  %8.1f  %8.1f  %6u  %8.2f  %s%s\n", uThreads, run.m_NanosecondsPerScope, run.m_MaxNanosecondsPerScope,
+            run.m_uMerges, run.m_MicrosecondsPerMerge, over ? "OVER BUDGET" : "", lost ? "LOST SCOPES" : "");
+    }
+
+    if (uOverBudget != 0)
+        printf("%u thread count(s) over the %.1f ns budget\n", uOverBudget, budgetNanoseconds);
+    if (uLost != 0)
+        printf("%u thread count(s) lost scopes in the merge\n", uLost);
+
+    return (uLost != 0 || (enforce && uOverBudget != 0)) ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: AMD_Test.h
+//
+// Minimal checks shared by the unit tests: a failed check is reported with its location
+// and the test keeps running, main() returns AMD_TEST_RESULT() so ctest sees the failure.
+//--------------------------------------------------------------------------------------
+
+#ifndef _AMD_TEST_H_
+#define _AMD_TEST_H_
+
+#include <cstdio>
+#include <cmath>
+
+inline int & amdTestFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define AMD_TEST_CHECK(expr) \
+    do { if (!(expr)) { printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #expr); amdTestFailures()++; } } while (0)
+
+#define AMD_TEST_CHECK_EQUAL(actual, expected) \
+    do { \
+        long long amdActual = (long long)(actual), amdExpected = (long long)(expected); \
+        if (amdActual != amdExpected) { printf("%s(%d): %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, amdActual, amdExpected); amdTestFailures()++; } \
+    } while (0)
+
+#define AMD_TEST_CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        double amdActual = (double)(actual), amdExpected = (double)(expected); \
+        if (!(fabs(amdActual - amdExpected) <= (double)(tolerance))) { printf("%s(%d): %s is %g, expected %g +- %g\n", __FILE__, __LINE__, #actual, amdActual, amdExpected, (double)(tolerance)); amdTestFailures()++; } \
+    } while (0)
+
+#define AMD_TEST_RESULT() \
+    (printf("%s: %d failed check(s)\n", __FILE__, amdTestFailures()), amdTestFailures() == 0 ? 0 : 1)
+
+#endif // _AMD_TEST_H_
@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: AutotuneTest.cpp
+//
+// Checks the SSE image metrics of AOFX_Autotune against a scalar double precision
+// reference, and that the presets AOFX_Autotune returns form a quality / cost frontier.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "AMD_AOFX_CPU.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+//--------------------------------------------------------------------------------------
+// Scalar reference: the same 8x8 windows every 4 texels, accumulated in double precision
+//--------------------------------------------------------------------------------------
+static double referenceSSIM(const float * pImage, const float * pReference, uint width, uint height)
+{
+    const double c1 = 0.01 * 0.01, c2 = 0.03 * 0.03;
+    double ssim = 0.0;
+    uint windows = 0;
+
+    for (uint y = 0; y + 8 <= height; y += 4)
+    {
+        for (uint x = 0; x + 8 <= width; x += 4)
+        {
+            double sumA = 0.0, sumB = 0.0, sumAA = 0.0, sumBB = 0.0, sumAB = 0.0;
+            for (uint row = y; row < y + 8; row++)
+            {
+                for (uint column = x; column < x + 8; column++)
+                {
+                    double a = pImage[row * width + column], b = pReference[row * width + column];
+                    sumA += a; sumB += b; sumAA += a * a; sumBB += b * b; sumAB += a * b;
+                }
+            }
+
+            double meanA = sumA / 64.0, meanB = sumB / 64.0;
+            double varianceA = sumAA / 64.0 - meanA * meanA;
+            double varianceB = sumBB / 64.0 - meanB * meanB;
+            double covariance = sumAB / 64.0 - meanA * meanB;
+
+            ssim += ((2.0 * meanA * meanB + c1) * (2.0 * covariance + c2)) / ((meanA * meanA + meanB * meanB + c1) * (varianceA + varianceB + c2));
+            windows++;
+        }
+    }
+
+    return windows > 0 ? ssim / windows : 1.0;
+}
+
+static double referencePSNR(const float * pImage, const float * pReference, uint width, uint height)
+{
+    double squaredError = 0.0;
+    for (size_t i = 0; i < (size_t)width * height; i++)
+        squaredError += ((double)pImage[i] - pReference[i]) * ((double)pImage[i] - pReference[i]);
+
+    double rmse = sqrt(squaredError / ((double)width * height));
+    return rmse > 0.0 ? std::min(-20.0 * log10(rmse), 100.0) : 100.0;
+}
+
+// AO like content: a smooth gradient with occluded blobs, and a noisy copy of it
+static void makeImages(std::vector<float> & image, std::vector<float> & reference, uint width, uint height, float noise, uint seed)
+{
+    image.resize((size_t)width * height);
+    reference.resize((size_t)width * height);
+
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            float value = 0.6f + 0.3f * sinf(x * 0.11f) * cosf(y * 0.07f);
+            if (((x / 13) + (y / 9)) % 5 == 0) value *= 0.4f;
+
+            seed = seed * 1664525u + 1013904223u;
+            float jitter = ((float)(seed >> 8) / (float)(1 << 24) * 2.0f - 1.0f) * noise;
+
+            reference[y * width + x] = value;
+            image[y * width + x] = std::min(std::max(value + jitter, 0.0f), 1.0f);
+        }
+    }
+}
+
+static void testMetricsMatchScalarReference()
+{
+    static const uint sizes[][2] = { { 8, 8 }, { 64, 48 }, { 67, 33 }, { 131, 97 }, { 320, 180 } };
+    static const float noise[] = { 0.0f, 0.01f, 0.1f, 0.5f };
+
+    for (uint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        for (uint n = 0; n < sizeof(noise) / sizeof(noise[0]); n++)
+        {
+            std::vector<float> image, reference;
+            uint width = sizes[s][0], height = sizes[s][1];
+            makeImages(image, reference, width, height, noise[n], s * 31 + n);
+
+            double ssim = AOFX_CpuSSIM(&image[0], &reference[0], width, height);
+            double psnr = AOFX_CpuPSNR(&image[0], &reference[0], width, height);
+
+            // single precision sums of 64 values in [0, 1] against double precision
+            AMD_TEST_CHECK_NEAR(ssim, referenceSSIM(&image[0], &reference[0], width, height), 1.0e-4);
+            AMD_TEST_CHECK_NEAR(psnr, referencePSNR(&image[0], &reference[0], width, height), 1.0e-3);
+        }
+    }
+}
+
+static void testMetricBounds()
+{
+    std::vector<float> image, reference;
+    makeImages(image, reference, 64, 64, 0.0f, 7);
+
+    AMD_TEST_CHECK_NEAR(AOFX_CpuSSIM(&image[0], &reference[0], 64, 64), 1.0, 1.0e-6);
+    AMD_TEST_CHECK_NEAR(AOFX_CpuPSNR(&image[0], &reference[0], 64, 64), 100.0, 0.0);
+
+    // a constant error of 0.1 is 20 dB
+    for (size_t i = 0; i < image.size(); i++) image[i] = reference[i] - 0.1f;
+    AMD_TEST_CHECK_NEAR(AOFX_CpuPSNR(&image[0], &reference[0], 64, 64), 20.0, 1.0e-3);
+
+    // no complete window: SSIM falls back to 1.0
+    AMD_TEST_CHECK_NEAR(AOFX_CpuSSIM(&image[0], &reference[0], 7, 7), 1.0, 0.0);
+}
+
+//--------------------------------------------------------------------------------------
+// Ground plane with a box, camera space depth stored as hardware depth
+//--------------------------------------------------------------------------------------
+static void makeDepth(std::vector<float> & depth, uint width, uint height, float boxDistance, const AOFX_Desc::Camera & camera)
+{
+    float n = camera.m_NearPlane, f = camera.m_FarPlane, q = f / (f - n);
+    float tanY = tanf(camera.m_Fov * 0.5f), tanX = tanY * camera.m_Aspect;
+
+    depth.resize((size_t)width * height);
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            float rayX = ((x + 0.5f) * 2.0f / width - 1.0f) * tanX;
+            float rayY = -((y + 0.5f) * 2.0f / height - 1.0f) * tanY;
+            float z = 8.0f;
+            if (rayY < 0.0f) z = std::min(z, -1.0f / rayY);
+            if (fabsf(rayX * boxDistance) < 0.5f && rayY * boxDistance > -1.0f && rayY * boxDistance < 0.0f) z = std::min(z, boxDistance);
+            depth[y * width + x] = q - q * n / z;
+        }
+    }
+}
+
+static void testFrontier()
+{
+    AOFX_Desc desc;
+    desc.m_LayerProcess[1] = AOFX_LAYER_PROCESS_NONE;
+    desc.m_LayerProcess[2] = AOFX_LAYER_PROCESS_NONE;
+
+    const uint width = 96, height = 64;
+    std::vector<float> depth[2];
+    AOFX_BatchImage images[2];
+    for (uint i = 0; i < 2; i++)
+    {
+        images[i].m_Camera.m_NearPlane = 0.1f;
+        images[i].m_Camera.m_FarPlane = 100.0f;
+        images[i].m_Camera.m_Fov = 1.0f;
+        images[i].m_Camera.m_Aspect = 1.5f;
+        makeDepth(depth[i], width, height, 3.0f + 2.0f * i, images[i].m_Camera);
+        images[i].m_pDepth = &depth[i][0];
+        images[i].m_Size.x = width;
+        images[i].m_Size.y = height;
+    }
+
+    AOFX_AutotuneDesc autotune;
+    autotune.m_pImages = images;
+    autotune.m_ImageCount = 2;
+    autotune.m_LayerProcessMask = (1 << AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE) | (1 << AOFX_LAYER_PROCESS_DEINTERLEAVE_2);
+    autotune.m_SampleCountMask = 0xF;
+    autotune.m_BlurRadiusMask = 0x7;
+
+    AOFX_AutotunePreset presets[64];
+    AOFX_AutotuneResult result;
+    result.m_pPresets = presets;
+    result.m_MaxPresetCount = 64;
+
+    AMD_TEST_CHECK_EQUAL(AOFX_Autotune(desc, autotune, &result), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(result.m_CandidateCount, 2 * 4 * 3);
+    AMD_TEST_CHECK(result.m_PresetCount > 1);
+    AMD_TEST_CHECK_EQUAL(result.m_PresetCount, result.m_FrontierCount);
+
+    // highest quality first: quality and cost both strictly decrease
+    for (uint i = 1; i < result.m_PresetCount; i++)
+    {
+        AMD_TEST_CHECK(presets[i].m_SSIM < presets[i - 1].m_SSIM);
+        AMD_TEST_CHECK(presets[i].m_PredictedCost.m_Taps <= presets[i - 1].m_PredictedCost.m_Taps);
+    }
+    for (uint i = 0; i < result.m_PresetCount; i++)
+    {
+        AMD_TEST_CHECK(presets[i].m_SSIM > 0.0 && presets[i].m_SSIM <= 1.0 + 1.0e-9);
+        AMD_TEST_CHECK(presets[i].m_PSNR > 0.0 && presets[i].m_PSNR <= 100.0);
+    }
+
+    // thinning keeps both ends of the frontier
+    AOFX_AutotunePreset thinned[2];
+    AOFX_AutotuneResult thinnedResult;
+    thinnedResult.m_pPresets = thinned;
+    thinnedResult.m_MaxPresetCount = 2;
+    AMD_TEST_CHECK_EQUAL(AOFX_Autotune(desc, autotune, &thinnedResult), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(thinnedResult.m_PresetCount, 2);
+    AMD_TEST_CHECK_NEAR(thinned[0].m_SSIM, presets[0].m_SSIM, 1.0e-12);
+    AMD_TEST_CHECK_NEAR(thinned[1].m_SSIM, presets[result.m_PresetCount - 1].m_SSIM, 1.0e-12);
+}
+
+int main()
+{
+    testMetricsMatchScalarReference();
+    testMetricBounds();
+    testFrontier();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,666 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: CaptureTest.cpp
+//
+// Checks that the capture plane codec round trips 8, 16 and 32 bit planes bit exactly, that it
+// rejects truncated planes and never writes past its output on corrupt ones, and that capture
+// files replay every float bit pattern, their settings and camera. Captures that were never
+// closed, cut short or corrupted replay the frames that are intact. Replayed frame ranges render
+// the same AO as AOFX_RenderBatch on the captured images.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "AMD_AOFX_CPU.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const char * s_CaptureFile = "CaptureTest.cap";
+static const char * s_DamagedFile = "CaptureTest_damaged.cap";
+
+static const size_t s_FileHeaderSize = 16;      // magic, version, frame header size
+static const size_t s_FooterSize = 16;          // index offset, frame count, magic
+static const uint32 s_Guard = 0xA5A5A5A5;
+
+static std::mt19937 s_Random(20160913);
+
+//--------------------------------------------------------------------------------------
+// Codec
+//--------------------------------------------------------------------------------------
+
+// Encodes and decodes a plane, returns the encoded size
+template <typename T>
+static size_t roundTrip(const std::vector<T> & data, uint width, uint height, uint lanes)
+{
+    std::vector<uint8> encoded;
+    AOFX_CpuEncodePlanes(&data[0], width, height, lanes, encoded);
+    AMD_TEST_CHECK(!encoded.empty());
+
+    // decoded into a poisoned buffer with guard texels behind it
+    std::vector<T> decoded(data.size() + 4, (T)s_Guard);
+    bool decodedAll = AOFX_CpuDecodePlanes(&encoded[0], encoded.size(), width, height, lanes, &decoded[0]);
+    AMD_TEST_CHECK(decodedAll);
+    AMD_TEST_CHECK(memcmp(&decoded[0], &data[0], data.size() * sizeof(T)) == 0);
+    for (size_t i = data.size(); i < decoded.size(); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(decoded[i], (T)s_Guard);
+    }
+    if (!decodedAll || memcmp(&decoded[0], &data[0], data.size() * sizeof(T)) != 0)
+    {
+        printf("%u bit plane %ux%u, %u lanes does not round trip\n", (uint)sizeof(T) * 8, width, height, lanes);
+    }
+
+    // every bit of the last byte is needed, so is the byte
+    AMD_TEST_CHECK(!AOFX_CpuDecodePlanes(&encoded[0], encoded.size() - 1, width, height, lanes, &decoded[0]));
+
+    return encoded.size();
+}
+
+template <typename T>
+static void roundTripPatterns(uint width, uint height, uint lanes)
+{
+    const size_t count = (size_t)width * height * lanes;
+    const T maxValue = (T)~(T)0;
+    std::vector<T> random(count), alternating(count), ramp(count), constant(count, maxValue), noisy(count);
+
+    const T base = (T)s_Random();
+    for (size_t i = 0; i < count; i++)
+    {
+        random[i] = (T)s_Random();
+        alternating[i] = (i & 1) ? maxValue : 0;    // residuals of the whole word, escaped
+        ramp[i] = (T)(base + i * 3);                // wraps around
+        noisy[i] = (T)(base + s_Random() % (1u << (s_Random() % (sizeof(T) * 8))));
+    }
+
+    roundTrip(random, width, height, lanes);
+    roundTrip(alternating, width, height, lanes);
+    roundTrip(ramp, width, height, lanes);
+    roundTrip(noisy, width, height, lanes);
+
+    // a constant plane costs about a bit per texel
+    size_t constantSize = roundTrip(constant, width, height, lanes);
+    AMD_TEST_CHECK(constantSize <= count / 4 + sizeof(T) * 8);
+}
+
+static void testCodecRoundTrip()
+{
+    // single rows and columns take the first row and column predictors only
+    static const uint sizes[][2] = { { 1, 1 }, { 1, 7 }, { 7, 1 }, { 2, 2 }, { 37, 23 }, { 64, 64 }, { 3, 300 }, { 300, 3 } };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        for (uint lanes = 1; lanes <= 4; lanes++)
+        {
+            roundTripPatterns<uint8>(sizes[i][0], sizes[i][1], lanes);
+            roundTripPatterns<uint16>(sizes[i][0], sizes[i][1], lanes);
+            roundTripPatterns<uint32>(sizes[i][0], sizes[i][1], lanes);
+        }
+    }
+
+    // normal texels of up to 16 bytes
+    roundTripPatterns<uint8>(19, 11, 16);
+
+    for (uint i = 0; i < 100; i++)
+    {
+        roundTripPatterns<uint32>(1 + s_Random() % 90, 1 + s_Random() % 90, 1);
+    }
+}
+
+// A smooth depth buffer with edges and a background, the data captures are made of
+static std::vector<float> sceneDepth(uint width, uint height, float phase)
+{
+    const float nearPlane = 0.1f, farPlane = 100.0f;
+    std::vector<float> depth((size_t)width * height);
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            float z = 2.0f + 30.0f * y / height + 3.0f * sinf(x * 0.02f + phase);
+            if (((x / 40 + y / 50) & 3) == 0)
+                z = 5.0f + 0.01f * x;
+            if (y > height * 0.8f)
+                z = farPlane;
+            depth[y * width + x] = farPlane / (farPlane - nearPlane) * (1.0f - nearPlane / z);
+        }
+    }
+    return depth;
+}
+
+static void testCodecCorruption()
+{
+    const uint width = 64, height = 48;
+    std::vector<float> depth = sceneDepth(width, height, 0.0f);
+    std::vector<uint32> words(depth.size());
+    memcpy(&words[0], &depth[0], words.size() * sizeof(uint32));
+
+    std::vector<uint8> encoded;
+    AOFX_CpuEncodePlanes(&words[0], width, height, 1, encoded);
+    AMD_TEST_CHECK(encoded.size() < words.size() * sizeof(uint32));
+
+    // every truncation is detected, down to no data at all
+    std::vector<uint32> decoded(words.size() + 4, s_Guard);
+    uint truncationsAccepted = 0;
+    for (size_t size = 0; size < encoded.size(); size++)
+    {
+        if (AOFX_CpuDecodePlanes(size ? &encoded[0] : NULL, size, width, height, 1, &decoded[0]))
+            truncationsAccepted++;
+    }
+    AMD_TEST_CHECK_EQUAL(truncationsAccepted, 0);
+
+    // flipped bits decode to something or fail, within the output either way
+    uint detected = 0;
+    for (uint i = 0; i < 500; i++)
+    {
+        std::vector<uint8> corrupt = encoded;
+        for (uint flip = 0; flip <= i % 4; flip++)
+        {
+            corrupt[s_Random() % corrupt.size()] ^= (uint8)(1 << (s_Random() % 8));
+        }
+
+        decoded.assign(words.size() + 4, s_Guard);
+        if (!AOFX_CpuDecodePlanes(&corrupt[0], corrupt.size(), width, height, 1, &decoded[0]))
+            detected++;
+        for (size_t t = words.size(); t < decoded.size(); t++)
+        {
+            AMD_TEST_CHECK_EQUAL(decoded[t], s_Guard);
+        }
+    }
+
+    // flips change the code lengths that follow them, most run past the end of the plane
+    AMD_TEST_CHECK(detected > 0);
+}
+
+//--------------------------------------------------------------------------------------
+// Capture files
+//--------------------------------------------------------------------------------------
+
+struct CapturedFrame
+{
+    std::vector<float>      m_Depth;
+    AOFX_Desc::uint2        m_Size;
+    AOFX_Desc::Camera       m_Camera;
+    AOFX_SAMPLE_COUNT       m_SampleCount;
+    AOFX_KERNEL_TYPE        m_KernelType;
+    float                   m_PowIntensity;
+};
+
+static float floatBits(uint32 bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Depth buffers with every kind of float in them, each frame with its own settings and camera
+static std::vector<CapturedFrame> makeFrames()
+{
+    static const uint sizes[][2] = { { 320, 180 }, { 320, 180 }, { 1, 1 }, { 200, 150 }, { 16384, 2 }, { 3, 250 }, { 200, 150 }, { 97, 61 } };
+    static const uint32 specials[] = { 0x7FC00000, 0x7FC00001, 0xFFFFFFFF, 0x7F800001, 0x7F800000, 0xFF800000, 0x80000000, 0x00000001, 0x807FFFFF, 0x3F800000 };
+
+    std::vector<CapturedFrame> frames(sizeof(sizes) / sizeof(sizes[0]));
+    for (uint f = 0; f < frames.size(); f++)
+    {
+        CapturedFrame & frame = frames[f];
+        frame.m_Size.x = sizes[f][0];
+        frame.m_Size.y = sizes[f][1];
+        frame.m_Depth = sceneDepth(frame.m_Size.x, frame.m_Size.y, f * 0.3f);
+
+        const size_t texels = frame.m_Depth.size();
+        for (size_t i = 0; i < sizeof(specials) / sizeof(specials[0]) && texels > 1; i++)
+        {
+            frame.m_Depth[(i * 7919) % texels] = floatBits(specials[i]);
+        }
+        if (f == 6)
+        {
+            // no two neighbours alike
+            for (size_t i = 0; i < texels; i++)
+                frame.m_Depth[i] = floatBits((uint32)s_Random());
+        }
+
+        memset(&frame.m_Camera, 0, sizeof(frame.m_Camera));
+        frame.m_Camera.m_NearPlane = 0.1f;
+        frame.m_Camera.m_FarPlane = 100.0f + f;
+        frame.m_Camera.m_Fov = 0.8f + 0.01f * f;
+        frame.m_Camera.m_Aspect = (float)frame.m_Size.x / frame.m_Size.y;
+        frame.m_Camera.m_Position.x = -3.0f * f;
+        frame.m_SampleCount = (AOFX_SAMPLE_COUNT)(f % AOFX_SAMPLE_COUNT_COUNT);
+        frame.m_KernelType = (AOFX_KERNEL_TYPE)(f / 4 % AOFX_KERNEL_TYPE_COUNT);
+        frame.m_PowIntensity = 1.0f + 0.25f * f;
+    }
+    return frames;
+}
+
+static AOFX_CaptureStats writeCapture(const char * pFileName, const std::vector<CapturedFrame> & frames)
+{
+    AOFX_CaptureStats stats;
+    AOFX_CaptureStream * pStream = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_CaptureOpen(pFileName, &pStream), AOFX_RETURN_CODE_SUCCESS);
+    if (pStream == NULL)
+        return stats;
+
+    for (uint f = 0; f < frames.size(); f++)
+    {
+        AOFX_Desc desc;
+        desc.m_SampleCount[1] = frames[f].m_SampleCount;
+        desc.m_KernelType[0] = frames[f].m_KernelType;
+        desc.m_PowIntensity[2] = frames[f].m_PowIntensity;
+
+        AOFX_BatchImage image;
+        image.m_pDepth = &frames[f].m_Depth[0];
+        image.m_Size = frames[f].m_Size;
+        image.m_Camera = frames[f].m_Camera;
+        AMD_TEST_CHECK_EQUAL(AOFX_CaptureAppendImage(pStream, desc, image), AOFX_RETURN_CODE_SUCCESS);
+    }
+
+    AMD_TEST_CHECK_EQUAL(AOFX_CaptureClose(pStream, &stats), AOFX_RETURN_CODE_SUCCESS);
+    return stats;
+}
+
+// Opens a capture and checks it holds the first frameCount frames, bit exact
+static void checkReplay(const char * pFileName, const std::vector<CapturedFrame> & frames, uint frameCount)
+{
+    AOFX_ReplayStream * pStream = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayOpen(pFileName, &pStream), AOFX_RETURN_CODE_SUCCESS);
+    if (pStream == NULL)
+        return;
+
+    uint count = 0;
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayGetFrameCount(pStream, &count), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(count, frameCount);
+
+    // in reverse, every read seeks
+    for (uint f = count; f-- > 0 && f < frames.size();)
+    {
+        AOFX_ReplayFrame replay;
+        AOFX_Desc desc;
+        AMD_TEST_CHECK_EQUAL(AOFX_ReplayReadFrame(pStream, f, &replay, &desc), AOFX_RETURN_CODE_SUCCESS);
+
+        const CapturedFrame & frame = frames[f];
+        AMD_TEST_CHECK_EQUAL(replay.m_FrameIndex, f);
+        AMD_TEST_CHECK_EQUAL(replay.m_Size.x, frame.m_Size.x);
+        AMD_TEST_CHECK_EQUAL(replay.m_Size.y, frame.m_Size.y);
+        AMD_TEST_CHECK_EQUAL(replay.m_DepthFormat, DXGI_FORMAT_R32_FLOAT);
+        AMD_TEST_CHECK_EQUAL(replay.m_NormalFormat, DXGI_FORMAT_UNKNOWN);
+        AMD_TEST_CHECK(replay.m_pNormal == NULL);
+        AMD_TEST_CHECK(replay.m_Size.x != frame.m_Size.x || replay.m_Size.y != frame.m_Size.y ||
+                       memcmp(replay.m_pDepth, &frame.m_Depth[0], frame.m_Depth.size() * sizeof(float)) == 0);
+        AMD_TEST_CHECK(memcmp(&replay.m_Camera, &frame.m_Camera, sizeof(frame.m_Camera)) == 0);
+
+        AMD_TEST_CHECK_EQUAL(desc.m_SampleCount[1], frame.m_SampleCount);
+        AMD_TEST_CHECK_EQUAL(desc.m_KernelType[0], frame.m_KernelType);
+        AMD_TEST_CHECK_EQUAL(desc.m_PowIntensity[2], frame.m_PowIntensity);
+        AMD_TEST_CHECK(memcmp(&desc.m_Camera, &frame.m_Camera, sizeof(frame.m_Camera)) == 0);
+        AMD_TEST_CHECK_EQUAL(desc.m_InputSize.x, frame.m_Size.x);
+        AMD_TEST_CHECK_EQUAL(desc.m_InputSize.y, frame.m_Size.y);
+    }
+
+    AOFX_ReplayFrame replay;
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayReadFrame(pStream, count, &replay, NULL), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayClose(pStream), AOFX_RETURN_CODE_SUCCESS);
+}
+
+static std::vector<uint8> readFile(const char * pFileName)
+{
+    std::vector<uint8> bytes;
+    FILE * pFile = fopen(pFileName, "rb");
+    if (pFile == NULL)
+        return bytes;
+    fseek(pFile, 0, SEEK_END);
+    bytes.resize((size_t)ftell(pFile));
+    fseek(pFile, 0, SEEK_SET);
+    if (!bytes.empty() && fread(&bytes[0], 1, bytes.size(), pFile) != bytes.size())
+        bytes.clear();
+    fclose(pFile);
+    return bytes;
+}
+
+static void writeFile(const char * pFileName, const std::vector<uint8> & bytes, size_t size)
+{
+    FILE * pFile = fopen(pFileName, "wb");
+    AMD_TEST_CHECK(pFile != NULL);
+    if (pFile == NULL)
+        return;
+    AMD_TEST_CHECK(size == 0 || fwrite(&bytes[0], 1, size, pFile) == size);
+    fclose(pFile);
+}
+
+// The frame offsets of a closed capture, read from its index
+static std::vector<uint64> frameOffsets(const std::vector<uint8> & bytes)
+{
+    uint64 indexOffset;
+    uint frameCount;
+    memcpy(&indexOffset, &bytes[bytes.size() - s_FooterSize], sizeof(indexOffset));
+    memcpy(&frameCount, &bytes[bytes.size() - s_FooterSize + 8], sizeof(frameCount));
+
+    std::vector<uint64> offsets(frameCount);
+    memcpy(&offsets[0], &bytes[(size_t)indexOffset], frameCount * sizeof(uint64));
+    offsets.push_back(indexOffset);
+    return offsets;
+}
+
+static void testCaptureRoundTrip()
+{
+    const std::vector<CapturedFrame> frames = makeFrames();
+    AOFX_CaptureStats stats = writeCapture(s_CaptureFile, frames);
+
+    uint64 rawBytes = 0;
+    for (uint f = 0; f < frames.size(); f++)
+    {
+        rawBytes += frames[f].m_Depth.size() * sizeof(float);
+    }
+    AMD_TEST_CHECK_EQUAL(stats.m_FrameCount, frames.size());
+    AMD_TEST_CHECK_EQUAL(stats.m_RawBytes, rawBytes);
+    AMD_TEST_CHECK_EQUAL(stats.m_CompressedBytes, readFile(s_CaptureFile).size());
+    AMD_TEST_CHECK(stats.m_CompressedBytes < stats.m_RawBytes);
+
+    checkReplay(s_CaptureFile, frames, (uint)frames.size());
+
+    // images a capture can't hold
+    AOFX_CaptureStream * pStream = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_CaptureOpen(s_DamagedFile, &pStream), AOFX_RETURN_CODE_SUCCESS);
+    AOFX_Desc desc;
+    AOFX_BatchImage image;
+    AMD_TEST_CHECK_EQUAL(AOFX_CaptureAppendImage(pStream, desc, image), AOFX_RETURN_CODE_INVALID_POINTER);
+    image.m_pDepth = &frames[0].m_Depth[0];
+    image.m_Size.x = 0;
+    image.m_Size.y = 1;
+    AMD_TEST_CHECK_EQUAL(AOFX_CaptureAppendImage(pStream, desc, image), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    image.m_Size.x = 16385;
+    AMD_TEST_CHECK_EQUAL(AOFX_CaptureAppendImage(pStream, desc, image), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    AMD_TEST_CHECK_EQUAL(AOFX_CaptureClose(pStream, NULL), AOFX_RETURN_CODE_SUCCESS);
+
+    // a capture without frames
+    checkReplay(s_DamagedFile, frames, 0);
+    remove(s_DamagedFile);
+}
+
+static void testTruncatedCapture()
+{
+    const std::vector<CapturedFrame> frames = makeFrames();
+    writeCapture(s_CaptureFile, frames);
+    const std::vector<uint8> bytes = readFile(s_CaptureFile);
+    const std::vector<uint64> offsets = frameOffsets(bytes);
+    const uint frameCount = (uint)frames.size();
+    AMD_TEST_CHECK_EQUAL(offsets.size(), frameCount + 1);
+    AMD_TEST_CHECK_EQUAL(offsets[0], s_FileHeaderSize);
+
+    // never closed: the frames are found by scanning
+    writeFile(s_DamagedFile, bytes, (size_t)offsets[frameCount]);
+    checkReplay(s_DamagedFile, frames, frameCount);
+
+    // part of the index, or a footer that points elsewhere
+    writeFile(s_DamagedFile, bytes, bytes.size() - 1);
+    checkReplay(s_DamagedFile, frames, frameCount);
+    std::vector<uint8> moved = bytes;
+    moved[moved.size() - s_FooterSize] ^= 0x08;
+    writeFile(s_DamagedFile, moved, moved.size());
+    checkReplay(s_DamagedFile, frames, frameCount);
+
+    // cut inside a frame's planes and inside its header: the frames before it
+    for (uint f = 0; f < frameCount; f++)
+    {
+        writeFile(s_DamagedFile, bytes, (size_t)offsets[f + 1] - 1);
+        checkReplay(s_DamagedFile, frames, f);
+        writeFile(s_DamagedFile, bytes, (size_t)offsets[f] + 5);
+        checkReplay(s_DamagedFile, frames, f);
+    }
+
+    // not a capture, or a capture of another version
+    static const size_t sizes[] = { 0, 5, s_FileHeaderSize - 1 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        writeFile(s_DamagedFile, bytes, sizes[i]);
+        AOFX_ReplayStream * pStream = NULL;
+        AMD_TEST_CHECK_EQUAL(AOFX_ReplayOpen(s_DamagedFile, &pStream), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+        AMD_TEST_CHECK(pStream == NULL);
+    }
+    for (size_t byte = 0; byte < s_FileHeaderSize; byte += 4)
+    {
+        std::vector<uint8> header = bytes;
+        header[byte] ^= 0x01;
+        writeFile(s_DamagedFile, header, header.size());
+        AOFX_ReplayStream * pStream = NULL;
+        AMD_TEST_CHECK_EQUAL(AOFX_ReplayOpen(s_DamagedFile, &pStream), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+        AMD_TEST_CHECK(pStream == NULL);
+    }
+
+    AOFX_ReplayStream * pStream = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayOpen("no_such_directory/CaptureTest.cap", &pStream), AOFX_RETURN_CODE_FAIL);
+    AMD_TEST_CHECK(pStream == NULL);
+
+    remove(s_DamagedFile);
+}
+
+static void testCorruptCapture()
+{
+    const std::vector<CapturedFrame> frames = makeFrames();
+    writeCapture(s_CaptureFile, frames);
+    const std::vector<uint8> bytes = readFile(s_CaptureFile);
+    const std::vector<uint64> offsets = frameOffsets(bytes);
+    const uint frameCount = (uint)frames.size();
+
+    // a frame with a broken header fails on its own
+    std::vector<uint8> corrupt = bytes;
+    corrupt[(size_t)offsets[3]] ^= 0xFF;
+    writeFile(s_DamagedFile, corrupt, corrupt.size());
+    AOFX_ReplayStream * pStream = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayOpen(s_DamagedFile, &pStream), AOFX_RETURN_CODE_SUCCESS);
+    for (uint f = 0; pStream != NULL && f < frameCount; f++)
+    {
+        AOFX_ReplayFrame replay;
+        AMD_TEST_CHECK_EQUAL(AOFX_ReplayReadFrame(pStream, f, &replay, NULL), f == 3 ? AOFX_RETURN_CODE_FAIL : AOFX_RETURN_CODE_SUCCESS);
+    }
+    AOFX_ReplayClose(pStream);
+
+    // without an index the scan stops there
+    writeFile(s_DamagedFile, corrupt, (size_t)offsets[frameCount]);
+    checkReplay(s_DamagedFile, frames, 3);
+
+    // flipped bits in the planes of one frame leave the other frames intact
+    uint32 frameHeaderSize;
+    memcpy(&frameHeaderSize, &bytes[12], sizeof(frameHeaderSize));
+    uint detected = 0;
+    for (uint i = 0; i < 48; i++)
+    {
+        const uint f = i % frameCount;
+        const size_t planes = (size_t)offsets[f] + frameHeaderSize;
+
+        corrupt = bytes;
+        for (uint flip = 0; flip <= i % 3; flip++)
+        {
+            corrupt[planes + s_Random() % (size_t)(offsets[f + 1] - planes)] ^= (uint8)(1 << (s_Random() % 8));
+        }
+        writeFile(s_DamagedFile, corrupt, corrupt.size());
+
+        pStream = NULL;
+        AMD_TEST_CHECK_EQUAL(AOFX_ReplayOpen(s_DamagedFile, &pStream), AOFX_RETURN_CODE_SUCCESS);
+        for (uint other = 0; pStream != NULL && other < frameCount; other++)
+        {
+            AOFX_ReplayFrame replay;
+            AOFX_RETURN_CODE result = AOFX_ReplayReadFrame(pStream, other, &replay, NULL);
+            if (other != f)
+            {
+                AMD_TEST_CHECK_EQUAL(result, AOFX_RETURN_CODE_SUCCESS);
+                AMD_TEST_CHECK(result != AOFX_RETURN_CODE_SUCCESS ||
+                               memcmp(replay.m_pDepth, &frames[other].m_Depth[0], frames[other].m_Depth.size() * sizeof(float)) == 0);
+            }
+            else if (result != AOFX_RETURN_CODE_SUCCESS)
+            {
+                AMD_TEST_CHECK_EQUAL(result, AOFX_RETURN_CODE_FAIL);
+                detected++;
+            }
+        }
+        AOFX_ReplayClose(pStream);
+    }
+    AMD_TEST_CHECK(detected > 0);
+
+    // anything at all in the frame headers, nothing crashes
+    for (uint i = 0; i < 48; i++)
+    {
+        corrupt = bytes;
+        const uint f = i % frameCount;
+        corrupt[(size_t)offsets[f] + s_Random() % 64] ^= (uint8)(1 << (s_Random() % 8));
+        writeFile(s_DamagedFile, corrupt, i % 2 ? corrupt.size() : (size_t)offsets[frameCount]);
+
+        pStream = NULL;
+        if (AOFX_ReplayOpen(s_DamagedFile, &pStream) != AOFX_RETURN_CODE_SUCCESS)
+            continue;
+        uint count = 0;
+        AOFX_ReplayGetFrameCount(pStream, &count);
+        for (uint other = 0; other < count; other++)
+        {
+            AOFX_ReplayFrame replay;
+            AOFX_ReplayReadFrame(pStream, other, &replay, NULL);
+        }
+        AOFX_ReplayClose(pStream);
+    }
+
+    remove(s_DamagedFile);
+    remove(s_CaptureFile);
+}
+
+//--------------------------------------------------------------------------------------
+
+struct ReplayedAO
+{
+    std::vector< std::vector<float> >   m_AO;       // by frame number
+};
+
+static bool storeReplayedAO(const AOFX_BatchImage & image, uint index, AOFX_RETURN_CODE result, void * pUserData)
+{
+    ReplayedAO & replayed = *(ReplayedAO *)pUserData;
+    if (result != AOFX_RETURN_CODE_SUCCESS || index >= replayed.m_AO.size())
+        return false;
+    replayed.m_AO[index].assign(image.m_pOutput, image.m_pOutput + (size_t)image.m_Size.x * image.m_Size.y);
+    return true;
+}
+
+// A replayed frame range has to match rendering the captured images directly with AOFX_RenderBatch,
+// bit exact, including frames whose settings differ from their neighbours
+static void testReplayMatchesBatch()
+{
+    static const uint frameCount = 7, width = 96, height = 64;
+    std::vector<CapturedFrame> frames(frameCount);
+    for (uint f = 0; f < frameCount; f++)
+    {
+        CapturedFrame & frame = frames[f];
+        frame.m_Size.x = width;
+        frame.m_Size.y = height + (f == 4 ? 8 : 0);
+        frame.m_Depth = sceneDepth(frame.m_Size.x, frame.m_Size.y, f * 0.5f);
+        memset(&frame.m_Camera, 0, sizeof(frame.m_Camera));
+        frame.m_Camera.m_NearPlane = 0.1f;
+        frame.m_Camera.m_FarPlane = 100.0f;
+        frame.m_Camera.m_Fov = 0.9f + 0.02f * f;
+        frame.m_Camera.m_Aspect = (float)frame.m_Size.x / frame.m_Size.y;
+        frame.m_SampleCount = f < 3 ? AOFX_SAMPLE_COUNT_LOW : AOFX_SAMPLE_COUNT_MEDIUM;
+        frame.m_KernelType = f == 5 ? AOFX_KERNEL_TYPE_GTAO : AOFX_KERNEL_TYPE_HDAO;
+        frame.m_PowIntensity = 1.0f + (f == 6 ? 0.5f : 0.0f);
+    }
+    writeCapture(s_CaptureFile, frames);
+
+    AOFX_ReplayStream * pStream = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayOpen(s_CaptureFile, &pStream), AOFX_RETURN_CODE_SUCCESS);
+    if (pStream == NULL)
+        return;
+
+    static const uint ranges[][2] = { { 0, frameCount }, { 2, 3 }, { 6, 1 } };
+    for (uint r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++)
+    {
+        const uint first = ranges[r][0], count = ranges[r][1];
+
+        ReplayedAO replayed;
+        replayed.m_AO.resize(frameCount);
+        AOFX_BatchDesc batch;
+        batch.m_ThreadCount = 1 + r;
+        batch.m_pStore = storeReplayedAO;
+        batch.m_pUserData = &replayed;
+
+        AOFX_Desc desc;
+        desc.m_PowIntensity[0] = 3.0f;
+        AOFX_BatchStats stats;
+        AMD_TEST_CHECK_EQUAL(AOFX_ReplayRender(pStream, desc, first, count, batch, &stats), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, count);
+        AMD_TEST_CHECK_EQUAL(stats.m_ImagesFailed, 0);
+        AMD_TEST_CHECK_EQUAL(desc.m_PowIntensity[0], 3.0f);
+
+        for (uint f = 0; f < frameCount; f++)
+        {
+            if (f < first || f >= first + count)
+            {
+                AMD_TEST_CHECK(replayed.m_AO[f].empty());
+                continue;
+            }
+
+            // the settings writeCapture stores with each frame
+            const CapturedFrame & frame = frames[f];
+            AOFX_Desc direct;
+            direct.m_SampleCount[1] = frame.m_SampleCount;
+            direct.m_KernelType[0] = frame.m_KernelType;
+            direct.m_PowIntensity[2] = frame.m_PowIntensity;
+
+            std::vector<float> ao(frame.m_Depth.size());
+            AOFX_BatchImage image;
+            image.m_pDepth = &frame.m_Depth[0];
+            image.m_pOutput = &ao[0];
+            image.m_Size = frame.m_Size;
+            image.m_Camera = frame.m_Camera;
+            AOFX_BatchDesc directBatch;
+            directBatch.m_pImages = &image;
+            directBatch.m_ImageCount = 1;
+            directBatch.m_ThreadCount = 1;
+            AMD_TEST_CHECK_EQUAL(AOFX_RenderBatch(direct, directBatch, NULL), AOFX_RETURN_CODE_SUCCESS);
+
+            AMD_TEST_CHECK_EQUAL(replayed.m_AO[f].size(), ao.size());
+            if (replayed.m_AO[f].size() == ao.size())
+                AMD_TEST_CHECK(memcmp(&replayed.m_AO[f][0], &ao[0], ao.size() * sizeof(float)) == 0);
+        }
+    }
+
+    // out of range
+    AOFX_Desc desc;
+    AOFX_BatchDesc batch;
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayRender(pStream, desc, frameCount, 1, batch, NULL), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayRender(pStream, desc, 2, frameCount - 1, batch, NULL), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayRender(pStream, desc, 0, 0, batch, NULL), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+
+    AMD_TEST_CHECK_EQUAL(AOFX_ReplayClose(pStream), AOFX_RETURN_CODE_SUCCESS);
+    remove(s_CaptureFile);
+}
+
+int main()
+{
+    testCodecRoundTrip();
+    testCodecCorruption();
+    testCaptureRoundTrip();
+    testTruncatedCapture();
+    testCorruptCapture();
+    testReplayMatchesBatch();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+//--------------------------------------------------------------------------------------
+// File: CompareKernelsTest.cpp
+//
+// The CPU GTAO kernel on planes and creases, its convergence with the slice count, and
+// AOFX_CompareKernels scoring both kernels against one shared reference.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "AMD_AOFX_CPU.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+//--------------------------------------------------------------------------------------
+// Wall facing the camera at wallDistance, with a floor when floorHeight > 0, stored as hardware depth
+//--------------------------------------------------------------------------------------
+static void makeImage(AOFX_BatchImage & image, std::vector<float> & depth, uint width, uint height, float wallDistance, float floorHeight)
+{
+    image.m_Camera.m_NearPlane = 0.1f;
+    image.m_Camera.m_FarPlane = 100.0f;
+    image.m_Camera.m_Fov = 1.0f;
+    image.m_Camera.m_Aspect = (float)width / height;
+
+    float n = image.m_Camera.m_NearPlane, f = image.m_Camera.m_FarPlane, q = f / (f - n);
+    float tanY = tanf(image.m_Camera.m_Fov * 0.5f);
+
+    depth.resize((size_t)width * height);
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            float rayY = -((y + 0.5f) * 2.0f / height - 1.0f) * tanY;
+            float z = wallDistance;
+            if (floorHeight > 0.0f && rayY < 0.0f) z = std::min(z, floorHeight / -rayY);
+            depth[y * width + x] = q - q * n / z;
+        }
+    }
+
+    image.m_pDepth = &depth[0];
+    image.m_Size.x = width;
+    image.m_Size.y = height;
+}
+
+// a single full resolution layer without blur, so the output is the kernel result
+static void setupDesc(AOFX_Desc & desc)
+{
+    desc.m_LayerProcess[1] = AOFX_LAYER_PROCESS_NONE;
+    desc.m_LayerProcess[2] = AOFX_LAYER_PROCESS_NONE;
+    desc.m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_NONE;
+}
+
+static void renderGTAO(AOFX_CpuDesc & cpuDesc, const AOFX_Desc & desc, AOFX_BatchImage & image, std::vector<float> & output, uint sliceCount, uint stepCount)
+{
+    AOFX_CpuDesc::AO_KernelData kernelData[AOFX_Desc::m_MultiResLayerCount];
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        kernelData[i] = AOFX_CpuDesc::AO_KernelData(desc, i, AOFX_KERNEL_TYPE_GTAO, AOFX_SAMPLE_COUNT_ULTRA);
+        kernelData[i].m_TapType = AOFX_TAP_TYPE_FIXED;
+        kernelData[i].m_SliceCount = sliceCount;
+        kernelData[i].m_StepCount = stepCount;
+    }
+
+    output.resize((size_t)image.m_Size.x * image.m_Size.y);
+    image.m_pOutput = &output[0];
+    AMD_TEST_CHECK_EQUAL(cpuDesc.render(desc, image, kernelData), AOFX_RETURN_CODE_SUCCESS);
+}
+
+static double rmse(const std::vector<float> & a, const std::vector<float> & b)
+{
+    double squaredError = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+        squaredError += (double)(a[i] - b[i]) * (a[i] - b[i]);
+    return sqrt(squaredError / a.size());
+}
+
+//--------------------------------------------------------------------------------------
+// Nothing occludes a wall facing the camera, a floor meeting it darkens the crease
+//--------------------------------------------------------------------------------------
+static void testGTAOPlanes()
+{
+    AOFX_Desc desc;
+    setupDesc(desc);
+
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4>  cbSamplePattern(1);
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SBYTE2> t1dSamplePattern(1);
+    AOFX_OpaqueDesc::generateSamplePatterns(cbSamplePattern[0], t1dSamplePattern[0]);
+    AOFX_CpuDesc cpuDesc(&cbSamplePattern[0]);
+
+    const uint width = 64, height = 48, border = 13;
+    std::vector<float> depth, output;
+    AOFX_BatchImage image;
+
+    makeImage(image, depth, width, height, 4.0f, 0.0f);
+    for (int sample = 0; sample < AOFX_SAMPLE_COUNT_COUNT; sample++)
+    {
+        AOFX_CpuDesc::AO_KernelData kernelData[AOFX_Desc::m_MultiResLayerCount];
+        for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+            kernelData[i] = AOFX_CpuDesc::AO_KernelData(desc, i, AOFX_KERNEL_TYPE_GTAO, (AOFX_SAMPLE_COUNT)sample);
+
+        output.resize((size_t)width * height);
+        image.m_pOutput = &output[0];
+        AMD_TEST_CHECK_EQUAL(cpuDesc.render(desc, image, kernelData), AOFX_RETURN_CODE_SUCCESS);
+
+        // taps are clamped to the image, so texels within the GTAO radius of the border see a crease
+        float minAO = 1.0f;
+        for (uint y = border; y < height - border; y++)
+            for (uint x = border; x < width - border; x++)
+                minAO = std::min(minAO, output[y * width + x]);
+        AMD_TEST_CHECK_NEAR(minAO, 1.0f, 0.01f);
+    }
+
+    // the floor meets the wall a quarter of the image height below the center
+    makeImage(image, depth, width, height, 4.0f, 4.0f * tanf(0.5f) * 0.5f);
+    renderGTAO(cpuDesc, desc, image, output, 8, 4);
+
+    uint crease = height * 3 / 4;
+    float creaseAO = output[(crease - 1) * width + width / 2];
+    float wallAO = output[(height / 4) * width + width / 2];
+    float floorAO = output[(height - 2) * width + width / 2];
+    AMD_TEST_CHECK(creaseAO < wallAO - 0.05f);
+    AMD_TEST_CHECK(creaseAO < floorAO - 0.05f);
+    for (size_t i = 0; i < output.size(); i++)
+        AMD_TEST_CHECK(output[i] >= 0.0f && output[i] <= 1.0f);
+}
+
+//--------------------------------------------------------------------------------------
+// More slices move the fixed tap GTAO result towards a densely marched one
+//--------------------------------------------------------------------------------------
+static void testGTAOConvergence()
+{
+    AOFX_Desc desc;
+    setupDesc(desc);
+
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4>  cbSamplePattern(1);
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SBYTE2> t1dSamplePattern(1);
+    AOFX_OpaqueDesc::generateSamplePatterns(cbSamplePattern[0], t1dSamplePattern[0]);
+    AOFX_CpuDesc cpuDesc(&cbSamplePattern[0]);
+
+    std::vector<float> depth, reference, coarse, fine;
+    AOFX_BatchImage image;
+    makeImage(image, depth, 64, 48, 4.0f, 4.0f * tanf(0.5f) * 0.5f);
+
+    renderGTAO(cpuDesc, desc, image, reference, 64, 16);
+    renderGTAO(cpuDesc, desc, image, coarse, 2, 16);
+    renderGTAO(cpuDesc, desc, image, fine, 16, 16);
+
+    double coarseError = rmse(coarse, reference), fineError = rmse(fine, reference);
+    printf("GTAO RMSE against 64 slices: 2 slices %.5f, 16 slices %.5f\n", coarseError, fineError);
+    AMD_TEST_CHECK(fineError < coarseError);
+}
+
+//--------------------------------------------------------------------------------------
+// Every result is scored against the same GTAO reference, whichever kernel produced it
+//--------------------------------------------------------------------------------------
+static void testCompareKernels()
+{
+    AOFX_Desc desc;
+    setupDesc(desc);
+
+    std::vector<float> depth;
+    AOFX_BatchImage image;
+    makeImage(image, depth, 64, 48, 4.0f, 4.0f * tanf(0.5f) * 0.5f);
+
+    AOFX_KernelComparison results[AOFX_KERNEL_TYPE_COUNT * AOFX_SAMPLE_COUNT_COUNT];
+    AMD_TEST_CHECK_EQUAL(AOFX_CompareKernels(desc, image, 1, NULL), AOFX_RETURN_CODE_INVALID_POINTER);
+    AMD_TEST_CHECK_EQUAL(AOFX_CompareKernels(desc, image, 1, results), AOFX_RETURN_CODE_SUCCESS);
+
+    for (int kernel = 0; kernel < AOFX_KERNEL_TYPE_COUNT; kernel++)
+    {
+        for (int sample = 0; sample < AOFX_SAMPLE_COUNT_COUNT; sample++)
+        {
+            const AOFX_KernelComparison & comparison = results[kernel * AOFX_SAMPLE_COUNT_COUNT + sample];
+            AMD_TEST_CHECK_EQUAL(comparison.m_KernelType, kernel);
+            AMD_TEST_CHECK_EQUAL(comparison.m_SampleCount, sample);
+            AMD_TEST_CHECK(comparison.m_RMSE > 0.0);
+            AMD_TEST_CHECK_NEAR(comparison.m_PSNR, -20.0 * log10(comparison.m_RMSE), 1e-9);
+        }
+    }
+
+    // recompute the reference and one result of each kernel, the errors have to match the reported ones
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SINT4>  cbSamplePattern(1);
+    std::vector<AOFX_OpaqueDesc::CB_SAMPLEPATTERN_ROT_SBYTE2> t1dSamplePattern(1);
+    AOFX_OpaqueDesc::generateSamplePatterns(cbSamplePattern[0], t1dSamplePattern[0]);
+    AOFX_CpuDesc cpuDesc(&cbSamplePattern[0]);
+
+    std::vector<float> reference, result(depth.size());
+    renderGTAO(cpuDesc, desc, image, reference, 16, 16);
+
+    for (int kernel = 0; kernel < AOFX_KERNEL_TYPE_COUNT; kernel++)
+    {
+        AOFX_CpuDesc::AO_KernelData kernelData[AOFX_Desc::m_MultiResLayerCount];
+        for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+            kernelData[i] = AOFX_CpuDesc::AO_KernelData(desc, i, (AOFX_KERNEL_TYPE)kernel, AOFX_SAMPLE_COUNT_HIGH);
+
+        image.m_pOutput = &result[0];
+        AMD_TEST_CHECK_EQUAL(cpuDesc.render(desc, image, kernelData), AOFX_RETURN_CODE_SUCCESS);
+
+        const AOFX_KernelComparison & comparison = results[kernel * AOFX_SAMPLE_COUNT_COUNT + AOFX_SAMPLE_COUNT_HIGH];
+        AMD_TEST_CHECK_NEAR(comparison.m_RMSE, rmse(result, reference), 1e-9);
+    }
+
+    // the GTAO error shrinks towards the reference it is a denser version of
+    AMD_TEST_CHECK(results[AOFX_KERNEL_TYPE_GTAO * AOFX_SAMPLE_COUNT_COUNT + AOFX_SAMPLE_COUNT_ULTRA].m_RMSE <
+                   results[AOFX_KERNEL_TYPE_GTAO * AOFX_SAMPLE_COUNT_COUNT + AOFX_SAMPLE_COUNT_LOW].m_RMSE);
+
+    for (int i = 0; i < AOFX_KERNEL_TYPE_COUNT * AOFX_SAMPLE_COUNT_COUNT; i++)
+        printf("%s %2d: %.5f RMSE, %.2f dB\n", results[i].m_KernelType == AOFX_KERNEL_TYPE_GTAO ? "GTAO" : "HDAO",
+               8 * (results[i].m_SampleCount + 1), results[i].m_RMSE, results[i].m_PSNR);
+}
+
+//--------------------------------------------------------------------------------------
+// A kernel is reported as supported exactly when AOFX_Initialize accepts a layer using it
+//--------------------------------------------------------------------------------------
+static void testKernelSupport()
+{
+    bool supported = false;
+    AMD_TEST_CHECK_EQUAL(AOFX_GetKernelSupport(AOFX_KERNEL_TYPE_HDAO, NULL), AOFX_RETURN_CODE_INVALID_POINTER);
+    AMD_TEST_CHECK_EQUAL(AOFX_GetKernelSupport(AOFX_KERNEL_TYPE_COUNT, &supported), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+
+    ID3D11Device * pDevice = NULL;
+    ID3D11DeviceContext * pContext = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&pDevice, &pContext), AOFX_RETURN_CODE_SUCCESS);
+
+    for (int kernel = 0; kernel < AOFX_KERNEL_TYPE_COUNT; kernel++)
+    {
+        AMD_TEST_CHECK_EQUAL(AOFX_GetKernelSupport((AOFX_KERNEL_TYPE)kernel, &supported), AOFX_RETURN_CODE_SUCCESS);
+
+        AOFX_Desc desc;
+        desc.m_pDevice = pDevice;
+        desc.m_KernelType[0] = (AOFX_KERNEL_TYPE)kernel;
+        AOFX_RETURN_CODE result = AOFX_Initialize(desc);
+        AMD_TEST_CHECK_EQUAL(result, supported ? AOFX_RETURN_CODE_SUCCESS : AOFX_RETURN_CODE_INVALID_ARGUMENT);
+        AOFX_Release(desc);
+    }
+
+    AMD_TEST_CHECK_EQUAL(AOFX_GetKernelSupport(AOFX_KERNEL_TYPE_HDAO, &supported), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK(supported);
+
+    pContext->Release();
+    pDevice->Release();
+}
+
+int main()
+{
+    testGTAOPlanes();
+    testGTAOConvergence();
+    testCompareKernels();
+    testKernelSupport();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ConstantUploadTest.cpp
+//
+// Counts the constant buffer maps AOFX_Render records per frame on the null device, with
+// D3D11.1 constant buffer offsetting (one discard map of the whole ring when anything
+// changed) and without it (one map per changed block), and checks that a frame with no
+// parameter change maps nothing.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cstring>
+
+#include "AMD_AOFX_OPAQUE.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const uint s_BlockSize = AOFX_OpaqueDesc::m_ConstantBlockSize;
+static const uint s_RingSize = s_BlockSize * AOFX_OpaqueDesc::CONSTANT_BLOCK_COUNT;
+
+struct UploadFixture
+{
+    ID3D11Device *              m_pDevice;
+    ID3D11DeviceContext *       m_pContext;
+    ID3D11Texture2D *           m_pTexture;
+    ID3D11ShaderResourceView *  m_pSRV;
+    ID3D11RenderTargetView *    m_pRTV;
+    AOFX_Desc                   m_Desc;
+
+    UploadFixture(bool offsetting)
+        : m_pDevice(NULL), m_pContext(NULL), m_pTexture(NULL), m_pSRV(NULL), m_pRTV(NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&m_pDevice, &m_pContext), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_SetNullDeviceConstantBufferOffsetting(m_pContext, offsetting), AOFX_RETURN_CODE_SUCCESS);
+
+        D3D11_TEXTURE2D_DESC textureDesc;
+        memset(&textureDesc, 0, sizeof(textureDesc));
+        textureDesc.Width = 1280;
+        textureDesc.Height = 720;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        textureDesc.SampleDesc.Count = 1;
+        m_pDevice->CreateTexture2D(&textureDesc, NULL, &m_pTexture);
+        m_pDevice->CreateShaderResourceView(m_pTexture, NULL, &m_pSRV);
+        m_pDevice->CreateRenderTargetView(m_pTexture, NULL, &m_pRTV);
+
+        m_Desc.m_pDevice = m_pDevice;
+        m_Desc.m_pDeviceContext = m_pContext;
+        m_Desc.m_pDepthSRV = m_pSRV;
+        m_Desc.m_pOutputRTV = m_pRTV;
+        m_Desc.m_InputSize.x = textureDesc.Width;
+        m_Desc.m_InputSize.y = textureDesc.Height;
+        AMD_TEST_CHECK_EQUAL(AOFX_Initialize(m_Desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_Resize(m_Desc), AOFX_RETURN_CODE_SUCCESS);
+    }
+
+    ~UploadFixture()
+    {
+        AOFX_Release(m_Desc);
+        m_pRTV->Release();
+        m_pSRV->Release();
+        m_pTexture->Release();
+        m_pContext->Release();
+        m_pDevice->Release();
+    }
+
+    // renders one frame and returns its counters
+    AOFX_DeviceCounters render()
+    {
+        AOFX_DeviceCounters counters;
+        AMD_TEST_CHECK_EQUAL(AOFX_ResetDeviceCounters(m_pContext), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_Render(m_Desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(counters.m_Maps, counters.m_Unmaps);
+        return counters;
+    }
+};
+
+//--------------------------------------------------------------------------------------
+// D3D11.1: every frame that changes a block discards and refills the ring with one map
+//--------------------------------------------------------------------------------------
+static void testRingUpload()
+{
+    UploadFixture fixture(true);
+    AOFX_Desc & desc = fixture.m_Desc;
+
+    AOFX_DeviceCounters counters = fixture.render();
+    AMD_TEST_CHECK_EQUAL(counters.m_Maps, 1);
+    AMD_TEST_CHECK_EQUAL(counters.m_BytesUploaded, s_RingSize);
+
+    for (uint frame = 0; frame < 3; frame++)
+    {
+        counters = fixture.render();
+        AMD_TEST_CHECK_EQUAL(counters.m_Maps, 0);
+        AMD_TEST_CHECK_EQUAL(counters.m_BytesUploaded, 0);
+    }
+
+    // a zooming camera touches six blocks, still one map per frame
+    for (uint frame = 0; frame < 8; frame++)
+    {
+        desc.m_Camera.m_Fov += 0.01f;
+        counters = fixture.render();
+        AMD_TEST_CHECK_EQUAL(counters.m_Maps, 1);
+        AMD_TEST_CHECK_EQUAL(counters.m_BytesUploaded, s_RingSize);
+    }
+
+    desc.m_PowIntensity[0] += 0.1f;
+    AMD_TEST_CHECK_EQUAL(fixture.render().m_Maps, 1);
+
+    desc.m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_4;
+    AMD_TEST_CHECK_EQUAL(fixture.render().m_Maps, 1);
+    AMD_TEST_CHECK_EQUAL(fixture.render().m_Maps, 0);
+}
+
+//--------------------------------------------------------------------------------------
+// Before D3D11.1: one buffer per block, only the blocks whose contents changed are mapped
+//--------------------------------------------------------------------------------------
+static void testPerBlockUpload()
+{
+    UploadFixture fixture(false);
+    AOFX_Desc & desc = fixture.m_Desc;
+
+    // default desc: three compute layers without blur, process input and AO per layer plus the dilate
+    AOFX_DeviceCounters counters = fixture.render();
+    AMD_TEST_CHECK_EQUAL(counters.m_Maps, 7);
+    AMD_TEST_CHECK_EQUAL(counters.m_BytesUploaded, 7 * s_BlockSize);
+
+    for (uint frame = 0; frame < 3; frame++)
+    {
+        counters = fixture.render();
+        AMD_TEST_CHECK_EQUAL(counters.m_Maps, 0);
+        AMD_TEST_CHECK_EQUAL(counters.m_BytesUploaded, 0);
+    }
+
+    // the camera feeds the process input and AO blocks of every layer, not the dilate
+    for (uint frame = 0; frame < 8; frame++)
+    {
+        desc.m_Camera.m_Fov += 0.01f;
+        counters = fixture.render();
+        AMD_TEST_CHECK_EQUAL(counters.m_Maps, 6);
+        AMD_TEST_CHECK_EQUAL(counters.m_BytesUploaded, 6 * s_BlockSize);
+    }
+
+    // the pow intensities only reach the dilate
+    desc.m_PowIntensity[0] += 0.1f;
+    counters = fixture.render();
+    AMD_TEST_CHECK_EQUAL(counters.m_Maps, 1);
+    AMD_TEST_CHECK_EQUAL(counters.m_BytesUploaded, s_BlockSize);
+
+    // enabling a blur radius adds the block its horizontal and vertical pass share
+    desc.m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_4;
+    AMD_TEST_CHECK_EQUAL(fixture.render().m_Maps, 1);
+    AMD_TEST_CHECK_EQUAL(fixture.render().m_Maps, 0);
+
+    desc.m_BilateralBlurRadius[1] = AOFX_BILATERAL_BLUR_RADIUS_8;
+    AMD_TEST_CHECK_EQUAL(fixture.render().m_Maps, 1);
+    AMD_TEST_CHECK_EQUAL(fixture.render().m_Maps, 0);
+}
+
+static void testOffsettingArguments()
+{
+    AMD_TEST_CHECK_EQUAL(AOFX_SetNullDeviceConstantBufferOffsetting(NULL, false), AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT);
+}
+
+int main()
+{
+    testRingUpload();
+    testPerBlockUpload();
+    testOffsettingArguments();
+
+    return AMD_TEST_RESULT();
+}
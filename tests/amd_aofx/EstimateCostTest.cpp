@@ -0,0 +1,527 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: EstimateCostTest.cpp
+//
+// Pins the AOFX_EstimateCost dispatch math to hand computed values and checks that the
+// estimate lists the stages, passes and dispatch sizes AOFX_Render records on the null device.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cstring>
+#include <vector>
+
+#include "AMD_AOFX.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+// AOFX internals the expectations below are derived from (AMD_AOFX_OPAQUE.h)
+static const size_t s_GroupDim = 32;        // m_AOGroupDim, m_DeinterleaveGroupDim
+static const size_t s_BlurRun = 128;        // m_BlurGroupSize
+static const size_t s_BlurLines = 2;        // m_BlurGroupLines
+static const size_t s_AOSize = 1;           // DXGI_FORMAT_R8_UNORM
+static const size_t s_DepthSize = 2;        // DXGI_FORMAT_R16_FLOAT
+static const size_t s_DepthReadSize = 4;    // application depth, counted as 32 bit
+
+static size_t divUp(size_t value, size_t divisor) { return (value + divisor - 1) / divisor; }
+
+//--------------------------------------------------------------------------------------
+// Only the given layer is enabled, everything else keeps the AOFX_Desc defaults
+//--------------------------------------------------------------------------------------
+static void setSingleLayer(AOFX_Desc & desc, uint layer, AOFX_LAYER_PROCESS process, float scale, AOFX_BILATERAL_BLUR_RADIUS blurRadius)
+{
+    desc.m_InputSize.x = 1920;
+    desc.m_InputSize.y = 1080;
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        desc.m_LayerProcess[i] = i == layer ? process : AOFX_LAYER_PROCESS_NONE;
+    }
+    desc.m_MultiResLayerScale[layer] = scale;
+    desc.m_BilateralBlurRadius[layer] = blurRadius;
+}
+
+static const AOFX_StageCost * findStage(const AOFX_CostEstimate & estimate, AOFX_STAGE stage, uint layer)
+{
+    for (uint i = 0; i < estimate.m_StageCount; i++)
+    {
+        if (estimate.m_Stages[i].m_Stage == stage && estimate.m_Stages[i].m_Layer == layer) return &estimate.m_Stages[i];
+    }
+    return NULL;
+}
+
+static void checkBlurPass(size_t & groups, size_t & ldsLoads, size_t width, size_t height, bool vertical, int radius)
+{
+    size_t kernelRadius = (size_t)2 << radius;
+    size_t passGroups = divUp(width, vertical ? s_BlurLines : s_BlurRun) * divUp(height, vertical ? s_BlurRun : s_BlurLines);
+    groups += passGroups;
+    ldsLoads += passGroups * s_BlurLines * (s_BlurRun + 2 * kernelRadius);
+}
+
+//--------------------------------------------------------------------------------------
+// One full resolution layer on the compute paths, blurred once after the dilate
+//--------------------------------------------------------------------------------------
+static void testFullResolutionLayer()
+{
+    AOFX_Desc desc;
+    setSingleLayer(desc, 0, AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE, 1.0f, AOFX_BILATERAL_BLUR_RADIUS_4);
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+
+    const size_t texels = 1920 * 1080;
+    const uint L = AOFX_Desc::m_MultiResLayerCount;
+
+    AMD_TEST_CHECK_EQUAL(estimate.m_StageCount, 5);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[0].m_Stage, AOFX_STAGE_PROCESS_INPUT);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[1].m_Stage, AOFX_STAGE_AMBIENT_OCCLUSION);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[2].m_Stage, AOFX_STAGE_DILATE);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[3].m_Stage, AOFX_STAGE_BLUR);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[4].m_Stage, AOFX_STAGE_OUTPUT);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[0].m_Layer, 0);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[1].m_Layer, 0);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Stages[3].m_Layer, L);
+
+    // 60 x 34 groups of 32 x 32 threads, one depth tap each
+    const AOFX_StageCost & input = estimate.m_Stages[0];
+    size_t inputGroups = divUp(1920, s_GroupDim) * divUp(1080, s_GroupDim);
+    AMD_TEST_CHECK_EQUAL(inputGroups, 60 * 34);
+    AMD_TEST_CHECK_EQUAL(input.m_Passes, 1);
+    AMD_TEST_CHECK_EQUAL(input.m_ThreadGroups, inputGroups);
+    AMD_TEST_CHECK_EQUAL(input.m_TexelsProcessed, texels);
+    AMD_TEST_CHECK_EQUAL(input.m_Taps, inputGroups * s_GroupDim * s_GroupDim);
+    AMD_TEST_CHECK_EQUAL(input.m_LdsLoads, inputGroups * s_GroupDim * s_GroupDim);
+    AMD_TEST_CHECK_EQUAL(input.m_BytesRead, inputGroups * s_GroupDim * s_GroupDim * s_DepthReadSize);
+    AMD_TEST_CHECK_EQUAL(input.m_BytesWritten, texels * s_DepthSize);
+
+    // AOFX_SAMPLE_COUNT_LOW: 8 valleys of two taps plus the center, a 64 x 64 tile per group
+    const AOFX_StageCost & ao = estimate.m_Stages[1];
+    AMD_TEST_CHECK_EQUAL(ao.m_Passes, 1);
+    AMD_TEST_CHECK_EQUAL(ao.m_ThreadGroups, 60 * 34);
+    AMD_TEST_CHECK_EQUAL(ao.m_Taps, texels * 17);
+    AMD_TEST_CHECK_EQUAL(ao.m_LdsLoads, 60 * 34 * 64 * 64);
+    AMD_TEST_CHECK_EQUAL(ao.m_BytesRead, 60 * 34 * 64 * 64 * s_DepthSize);
+    AMD_TEST_CHECK_EQUAL(ao.m_BytesWritten, texels * s_AOSize);
+
+    const AOFX_StageCost & dilate = estimate.m_Stages[2];
+    AMD_TEST_CHECK_EQUAL(dilate.m_Passes, 1);
+    AMD_TEST_CHECK_EQUAL(dilate.m_ThreadGroups, 0);
+    AMD_TEST_CHECK_EQUAL(dilate.m_Taps, texels);
+    AMD_TEST_CHECK_EQUAL(dilate.m_BytesRead, texels * s_AOSize);
+
+    // horizontal 15 x 540 runs, vertical 960 x 9 runs, radius 4 loads a 4 texel apron on both sides
+    const AOFX_StageCost & blur = estimate.m_Stages[3];
+    size_t blurGroups = 0, blurLds = 0;
+    checkBlurPass(blurGroups, blurLds, 1920, 1080, false, AOFX_BILATERAL_BLUR_RADIUS_4);
+    checkBlurPass(blurGroups, blurLds, 1920, 1080, true, AOFX_BILATERAL_BLUR_RADIUS_4);
+    AMD_TEST_CHECK_EQUAL(blurGroups, 15 * 540 + 960 * 9);
+    AMD_TEST_CHECK_EQUAL(blur.m_Passes, 2);
+    AMD_TEST_CHECK_EQUAL(blur.m_ThreadGroups, blurGroups);
+    AMD_TEST_CHECK_EQUAL(blur.m_TexelsProcessed, 2 * texels);
+    AMD_TEST_CHECK_EQUAL(blur.m_Taps, 2 * texels * 5);
+    AMD_TEST_CHECK_EQUAL(blur.m_LdsLoads, blurLds);
+    AMD_TEST_CHECK_EQUAL(blur.m_BytesRead, blurLds * (s_AOSize + 4));
+    AMD_TEST_CHECK_EQUAL(blur.m_BytesWritten, 2 * texels * s_AOSize);
+
+    const AOFX_StageCost & output = estimate.m_Stages[4];
+    AMD_TEST_CHECK_EQUAL(output.m_Passes, 1);
+    AMD_TEST_CHECK_EQUAL(output.m_Taps, texels);
+    AMD_TEST_CHECK_EQUAL(output.m_BytesWritten, 0);
+
+    // the total is the sum of the stages
+    AOFX_StageCost sum;
+    for (uint i = 0; i < estimate.m_StageCount; i++)
+    {
+        sum.m_Passes += estimate.m_Stages[i].m_Passes;
+        sum.m_ThreadGroups += estimate.m_Stages[i].m_ThreadGroups;
+        sum.m_Taps += estimate.m_Stages[i].m_Taps;
+        sum.m_BytesRead += estimate.m_Stages[i].m_BytesRead;
+        sum.m_BytesWritten += estimate.m_Stages[i].m_BytesWritten;
+    }
+    AMD_TEST_CHECK_EQUAL(estimate.m_Total.m_Passes, sum.m_Passes);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Total.m_ThreadGroups, sum.m_ThreadGroups);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Total.m_Taps, sum.m_Taps);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Total.m_BytesRead, sum.m_BytesRead);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Total.m_BytesWritten, sum.m_BytesWritten);
+
+    const AOFX_MemoryUsage & memory = estimate.m_Memory;
+    AMD_TEST_CHECK_EQUAL(memory.m_DilateAO, texels * s_AOSize);
+    AMD_TEST_CHECK_EQUAL(memory.m_BlurAO, texels * s_AOSize);
+    AMD_TEST_CHECK_EQUAL(memory.m_ResultAO[0], texels * s_AOSize);
+    AMD_TEST_CHECK_EQUAL(memory.m_InputAO[0], texels * s_DepthSize);
+    AMD_TEST_CHECK_EQUAL(memory.m_ResultAO[1], 0);
+    AMD_TEST_CHECK_EQUAL(memory.m_UpsampleAO[0], 0);
+    AMD_TEST_CHECK_EQUAL(memory.m_Total, 3 * texels * s_AOSize + texels * s_DepthSize + memory.m_Buffers);
+}
+
+//--------------------------------------------------------------------------------------
+// A half resolution layer deinterleaved 4 x 4: the AO dispatch covers every slice
+//--------------------------------------------------------------------------------------
+static void testDeinterleavedHalfResolutionLayer()
+{
+    AOFX_Desc desc;
+    setSingleLayer(desc, 1, AOFX_LAYER_PROCESS_DEINTERLEAVE_4, 0.5f, AOFX_BILATERAL_BLUR_RADIUS_NONE);
+    desc.m_SampleCount[1] = AOFX_SAMPLE_COUNT_ULTRA;
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+
+    const size_t texels = 960 * 540;
+
+    const AOFX_StageCost * input = findStage(estimate, AOFX_STAGE_PROCESS_INPUT, 1);
+    AMD_TEST_CHECK(input != NULL);
+    if (input != NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(input->m_ThreadGroups, 30 * 17);
+        AMD_TEST_CHECK_EQUAL(input->m_TexelsProcessed, texels);
+    }
+
+    // 240 x 135 texels per slice: 8 x 5 groups per slice, 4 x 4 slices
+    const AOFX_StageCost * ao = findStage(estimate, AOFX_STAGE_AMBIENT_OCCLUSION, 1);
+    AMD_TEST_CHECK(ao != NULL);
+    if (ao != NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(ao->m_ThreadGroups, (8 * 4) * (5 * 4));
+        AMD_TEST_CHECK_EQUAL(ao->m_Taps, texels * (1 + 2 * 32));
+        AMD_TEST_CHECK_EQUAL(ao->m_LdsLoads, (8 * 4) * (5 * 4) * 64 * 64);
+    }
+
+    AMD_TEST_CHECK(findStage(estimate, AOFX_STAGE_BLUR, 1) == NULL);
+    AMD_TEST_CHECK(findStage(estimate, AOFX_STAGE_BLUR, AOFX_Desc::m_MultiResLayerCount) == NULL);
+
+    const AOFX_MemoryUsage & memory = estimate.m_Memory;
+    AMD_TEST_CHECK_EQUAL(memory.m_ResultAO[1], texels * s_AOSize);
+    AMD_TEST_CHECK_EQUAL(memory.m_InputAO[1], 240 * 135 * 16 * s_DepthSize);
+
+    // without the depth aware dilate permutations the layer is upsampled to full resolution first
+    const AOFX_StageCost * upsample = findStage(estimate, AOFX_STAGE_UPSAMPLE, 1);
+    AMD_TEST_CHECK((upsample != NULL) == (memory.m_UpsampleAO[1] != 0));
+    if (upsample != NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(upsample->m_Passes, 1);
+        AMD_TEST_CHECK_EQUAL(upsample->m_TexelsProcessed, 1920 * 1080);
+        AMD_TEST_CHECK_EQUAL(memory.m_UpsampleAO[1], 1920 * 1080 * s_AOSize);
+    }
+}
+
+//--------------------------------------------------------------------------------------
+// Layers with different blur radiuses are blurred one by one at the size the layer is blurred at
+//--------------------------------------------------------------------------------------
+static void testSeparateBlur()
+{
+    AOFX_Desc desc;
+    desc.m_InputSize.x = 1920;
+    desc.m_InputSize.y = 1080;
+    desc.m_LayerProcess[2] = AOFX_LAYER_PROCESS_NONE;
+    desc.m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_2;
+    desc.m_BilateralBlurRadius[1] = AOFX_BILATERAL_BLUR_RADIUS_8;
+
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+
+    AMD_TEST_CHECK(findStage(estimate, AOFX_STAGE_BLUR, AOFX_Desc::m_MultiResLayerCount) == NULL);
+
+    const AOFX_StageCost * blur0 = findStage(estimate, AOFX_STAGE_BLUR, 0);
+    const AOFX_StageCost * blur1 = findStage(estimate, AOFX_STAGE_BLUR, 1);
+    AMD_TEST_CHECK(blur0 != NULL && blur1 != NULL);
+    if (blur0 == NULL || blur1 == NULL) return;
+
+    size_t groups0 = 0, lds0 = 0;
+    checkBlurPass(groups0, lds0, 1920, 1080, false, AOFX_BILATERAL_BLUR_RADIUS_2);
+    checkBlurPass(groups0, lds0, 1920, 1080, true, AOFX_BILATERAL_BLUR_RADIUS_2);
+    AMD_TEST_CHECK_EQUAL(blur0->m_ThreadGroups, groups0);
+    AMD_TEST_CHECK_EQUAL(blur0->m_LdsLoads, lds0);
+
+    // both passes of a layer run at the same size: the upsampled full resolution surface,
+    // or the layer itself once the depth aware dilate permutations are precompiled
+    bool upsampled = findStage(estimate, AOFX_STAGE_UPSAMPLE, 1) != NULL;
+    size_t width = upsampled ? 1920 : 960;
+    size_t height = upsampled ? 1080 : 540;
+    size_t groups1 = 0, lds1 = 0;
+    checkBlurPass(groups1, lds1, width, height, false, AOFX_BILATERAL_BLUR_RADIUS_8);
+    checkBlurPass(groups1, lds1, width, height, true, AOFX_BILATERAL_BLUR_RADIUS_8);
+    AMD_TEST_CHECK_EQUAL(blur1->m_ThreadGroups, groups1);
+    AMD_TEST_CHECK_EQUAL(blur1->m_LdsLoads, lds1);
+    AMD_TEST_CHECK_EQUAL(blur1->m_TexelsProcessed, 2 * width * height);
+    AMD_TEST_CHECK_EQUAL(blur1->m_Taps, 2 * width * height * (1 + 8));
+
+    // the blur stages run after the upsample stages and before the dilate
+    uint blurIndex = (uint)(blur0 - estimate.m_Stages);
+    uint dilateIndex = (uint)(findStage(estimate, AOFX_STAGE_DILATE, AOFX_Desc::m_MultiResLayerCount) - estimate.m_Stages);
+    AMD_TEST_CHECK(blurIndex < dilateIndex);
+    AMD_TEST_CHECK(estimate.m_StageCount <= AOFX_CostEstimate::m_MaxStageCount);
+}
+
+//--------------------------------------------------------------------------------------
+// The pixel shader paths add a pass per stage but no thread groups
+//--------------------------------------------------------------------------------------
+static void testPixelShaderPaths()
+{
+    AOFX_Desc desc;
+    setSingleLayer(desc, 0, AOFX_LAYER_PROCESS_DEINTERLEAVE_2, 1.0f, AOFX_BILATERAL_BLUR_RADIUS_NONE);
+    desc.m_Implementation = AOFX_IMPLEMENTATION_MASK_KERNEL_PS | AOFX_IMPLEMENTATION_MASK_UTILITY_PS | AOFX_IMPLEMENTATION_MASK_BLUR_CS;
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+
+    const size_t texels = 1920 * 1080;
+    const AOFX_StageCost * input = findStage(estimate, AOFX_STAGE_PROCESS_INPUT, 0);
+    const AOFX_StageCost * ao = findStage(estimate, AOFX_STAGE_AMBIENT_OCCLUSION, 0);
+    AMD_TEST_CHECK(input != NULL && ao != NULL);
+    if (input == NULL || ao == NULL) return;
+
+    AMD_TEST_CHECK_EQUAL(input->m_Passes, 1);
+    AMD_TEST_CHECK_EQUAL(input->m_ThreadGroups, 0);
+    AMD_TEST_CHECK_EQUAL(input->m_TexelsProcessed, texels);
+    AMD_TEST_CHECK_EQUAL(ao->m_Passes, 1);
+    AMD_TEST_CHECK_EQUAL(ao->m_ThreadGroups, 0);
+    AMD_TEST_CHECK_EQUAL(ao->m_LdsLoads, 0);
+    AMD_TEST_CHECK_EQUAL(ao->m_BytesRead, texels * 17 * s_DepthSize);
+}
+
+static void testArguments()
+{
+    AOFX_Desc desc;
+    AOFX_CostEstimate estimate;
+    desc.m_InputSize.x = 1920;
+    desc.m_InputSize.y = 1080;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, NULL), AOFX_RETURN_CODE_INVALID_POINTER);
+
+    desc.m_InputSize.y = 0;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+
+    // no active layer: only the shared surfaces are allocated and nothing is rendered
+    desc.m_InputSize.y = 1080;
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++) desc.m_LayerProcess[i] = AOFX_LAYER_PROCESS_NONE;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(estimate.m_StageCount, 0);
+    AMD_TEST_CHECK_EQUAL(estimate.m_Memory.m_Total, 2 * 1920 * 1080 * s_AOSize + estimate.m_Memory.m_Buffers);
+}
+
+//--------------------------------------------------------------------------------------
+// AOFX_Render on the null device records the stages the estimate predicts
+//--------------------------------------------------------------------------------------
+static void recordStage(const AOFX_StageCounters & counters, ID3D11DeviceContext *, void * pUserData)
+{
+    ((std::vector<AOFX_StageCounters> *)pUserData)->push_back(counters);
+}
+
+static void checkAgainstRender(ID3D11Device * pDevice, ID3D11DeviceContext * pContext, ID3D11ShaderResourceView * pDepthSRV, ID3D11RenderTargetView * pOutputRTV, AOFX_Desc & desc)
+{
+    std::vector<AOFX_StageCounters> recorded;
+    AOFX_Instrumentation instrumentation;
+    instrumentation.m_pEndStage = recordStage;
+    instrumentation.m_pUserData = &recorded;
+
+    desc.m_pDevice = pDevice;
+    desc.m_pDeviceContext = pContext;
+    desc.m_pDepthSRV = pDepthSRV;
+    desc.m_pOutputRTV = pOutputRTV;
+    desc.m_pInstrumentation = &instrumentation;
+
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(recorded.size(), estimate.m_StageCount);
+
+    for (uint i = 0; i < recorded.size() && i < estimate.m_StageCount; i++)
+    {
+        const AOFX_StageCounters & counters = recorded[i];
+        const AOFX_StageCost & cost = estimate.m_Stages[i];
+        AMD_TEST_CHECK_EQUAL(counters.m_Stage, cost.m_Stage);
+        AMD_TEST_CHECK_EQUAL(counters.m_Layer, cost.m_Layer);
+        AMD_TEST_CHECK_EQUAL(counters.m_Passes, cost.m_Passes);
+        AMD_TEST_CHECK_EQUAL(counters.m_TexelsProcessed, cost.m_TexelsProcessed);
+
+        // a single compute pass records its dispatch, which has to match the predicted groups
+        if (cost.m_Passes == 1 && cost.m_ThreadGroups != 0)
+        {
+            size_t groups = (size_t)counters.m_DispatchSize[0] * counters.m_DispatchSize[1] * counters.m_DispatchSize[2];
+            AMD_TEST_CHECK_EQUAL(groups, cost.m_ThreadGroups);
+        }
+    }
+
+    desc.m_pInstrumentation = NULL;
+    AOFX_Release(desc);
+}
+
+static void testMatchesRender()
+{
+    ID3D11Device * pDevice = NULL;
+    ID3D11DeviceContext * pContext = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&pDevice, &pContext), AOFX_RETURN_CODE_SUCCESS);
+    if (pDevice == NULL || pContext == NULL) return;
+
+    D3D11_TEXTURE2D_DESC textureDesc;
+    memset(&textureDesc, 0, sizeof(textureDesc));
+    textureDesc.Width = 1920;
+    textureDesc.Height = 1080;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    textureDesc.SampleDesc.Count = 1;
+    ID3D11Texture2D * pTexture = NULL;
+    ID3D11ShaderResourceView * pSRV = NULL;
+    ID3D11RenderTargetView * pRTV = NULL;
+    pDevice->CreateTexture2D(&textureDesc, NULL, &pTexture);
+    pDevice->CreateShaderResourceView(pTexture, NULL, &pSRV);
+    pDevice->CreateRenderTargetView(pTexture, NULL, &pRTV);
+
+    AOFX_Desc full;
+    setSingleLayer(full, 0, AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE, 1.0f, AOFX_BILATERAL_BLUR_RADIUS_4);
+    checkAgainstRender(pDevice, pContext, pSRV, pRTV, full);
+
+    AOFX_Desc deinterleaved;
+    setSingleLayer(deinterleaved, 1, AOFX_LAYER_PROCESS_DEINTERLEAVE_4, 0.5f, AOFX_BILATERAL_BLUR_RADIUS_2);
+    checkAgainstRender(pDevice, pContext, pSRV, pRTV, deinterleaved);
+
+    AOFX_Desc layers;
+    layers.m_InputSize.x = 1920;
+    layers.m_InputSize.y = 1080;
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        layers.m_BilateralBlurRadius[i] = (AOFX_BILATERAL_BLUR_RADIUS)(AOFX_BILATERAL_BLUR_RADIUS_2 + i);
+        layers.m_SampleCount[i] = (AOFX_SAMPLE_COUNT)i;
+    }
+    checkAgainstRender(pDevice, pContext, pSRV, pRTV, layers);
+
+    AOFX_Desc pixel;
+    setSingleLayer(pixel, 0, AOFX_LAYER_PROCESS_DEINTERLEAVE_2, 1.0f, AOFX_BILATERAL_BLUR_RADIUS_8);
+    pixel.m_Implementation = AOFX_IMPLEMENTATION_MASK_KERNEL_PS | AOFX_IMPLEMENTATION_MASK_UTILITY_PS | AOFX_IMPLEMENTATION_MASK_BLUR_CS;
+    checkAgainstRender(pDevice, pContext, pSRV, pRTV, pixel);
+
+    pRTV->Release();
+    pSRV->Release();
+    pTexture->Release();
+    pContext->Release();
+    pDevice->Release();
+}
+
+//--------------------------------------------------------------------------------------
+// The CPU backend runs the stages of the estimate at the same sizes, plus the shared depth
+// linearization, and never upsamples: a layer blurred on its own is blurred at its scale
+//--------------------------------------------------------------------------------------
+static void checkAgainstCpuRender(AOFX_Desc & desc, uint width, uint height)
+{
+    std::vector<AOFX_StageCounters> recorded;
+    AOFX_Instrumentation instrumentation;
+    instrumentation.m_pEndStage = recordStage;
+    instrumentation.m_pUserData = &recorded;
+
+    desc.m_InputSize.x = width;
+    desc.m_InputSize.y = height;
+    desc.m_pInstrumentation = &instrumentation;
+
+    std::vector<float> depth((size_t)width * height, 0.5f), output((size_t)width * height);
+    AOFX_BatchImage image;
+    image.m_pDepth = &depth[0];
+    image.m_pOutput = &output[0];
+    image.m_Size.x = width;
+    image.m_Size.y = height;
+    image.m_Camera.m_NearPlane = 0.1f;
+    image.m_Camera.m_FarPlane = 100.0f;
+
+    AOFX_BatchDesc batch;
+    batch.m_pImages = &image;
+    batch.m_ImageCount = 1;
+    batch.m_ThreadCount = 1;
+    AMD_TEST_CHECK_EQUAL(AOFX_RenderBatch(desc, batch, NULL), AOFX_RETURN_CODE_SUCCESS);
+    desc.m_pInstrumentation = NULL;
+
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+
+    AMD_TEST_CHECK(recorded.size() > 0);
+    if (recorded.size() == 0) return;
+    AMD_TEST_CHECK_EQUAL(recorded[0].m_Stage, AOFX_STAGE_PROCESS_INPUT);
+    AMD_TEST_CHECK_EQUAL(recorded[0].m_Layer, AOFX_Desc::m_MultiResLayerCount);
+
+    uint upsampled = 0;
+    for (uint i = 0; i < estimate.m_StageCount; i++)
+        upsampled += estimate.m_Stages[i].m_Stage == AOFX_STAGE_UPSAMPLE ? 1 : 0;
+    AMD_TEST_CHECK_EQUAL(recorded.size(), 1 + estimate.m_StageCount - upsampled);
+
+    uint stage = 1;
+    for (uint i = 0; i < estimate.m_StageCount && stage < recorded.size(); i++)
+    {
+        const AOFX_StageCost & cost = estimate.m_Stages[i];
+        if (cost.m_Stage == AOFX_STAGE_UPSAMPLE) continue;
+
+        const AOFX_StageCounters & counters = recorded[stage++];
+        AMD_TEST_CHECK_EQUAL(counters.m_Stage, cost.m_Stage);
+        AMD_TEST_CHECK_EQUAL(counters.m_Layer, cost.m_Layer);
+        AMD_TEST_CHECK_EQUAL(counters.m_Passes, cost.m_Passes);
+
+        // the estimate blurs an upsampled layer at full resolution
+        bool upsampledBlur = cost.m_Stage == AOFX_STAGE_BLUR && cost.m_Layer < AOFX_Desc::m_MultiResLayerCount &&
+                             findStage(estimate, AOFX_STAGE_UPSAMPLE, cost.m_Layer) != NULL;
+        if (!upsampledBlur)
+        {
+            AMD_TEST_CHECK_EQUAL(counters.m_TexelsProcessed, cost.m_TexelsProcessed);
+        }
+    }
+
+    for (uint i = 1; i < recorded.size(); i++)
+    {
+        const AOFX_StageCounters & counters = recorded[i];
+        if (counters.m_Stage != AOFX_STAGE_BLUR || counters.m_Layer == AOFX_Desc::m_MultiResLayerCount) continue;
+
+        size_t layerWidth = (size_t)(width * desc.m_MultiResLayerScale[counters.m_Layer]);
+        size_t layerHeight = (size_t)(height * desc.m_MultiResLayerScale[counters.m_Layer]);
+        AMD_TEST_CHECK_EQUAL(counters.m_Passes, 2);
+        AMD_TEST_CHECK_EQUAL(counters.m_TexelsProcessed, 2 * layerWidth * layerHeight);
+        AMD_TEST_CHECK_EQUAL(counters.m_DispatchSize[0], layerWidth);
+        AMD_TEST_CHECK_EQUAL(counters.m_DispatchSize[1], layerHeight);
+    }
+}
+
+static void testMatchesCpuRender()
+{
+    AOFX_Desc separate;
+    separate.m_LayerProcess[2] = AOFX_LAYER_PROCESS_NONE;
+    separate.m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_2;
+    separate.m_BilateralBlurRadius[1] = AOFX_BILATERAL_BLUR_RADIUS_8;
+    checkAgainstCpuRender(separate, 160, 96);
+
+    AOFX_Desc blended;
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+        blended.m_BilateralBlurRadius[i] = AOFX_BILATERAL_BLUR_RADIUS_4;
+    checkAgainstCpuRender(blended, 160, 96);
+
+    AOFX_Desc single;
+    setSingleLayer(single, 2, AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE, 0.25f, AOFX_BILATERAL_BLUR_RADIUS_2);
+    checkAgainstCpuRender(single, 160, 96);
+}
+
+int main()
+{
+    testFullResolutionLayer();
+    testDeinterleavedHalfResolutionLayer();
+    testSeparateBlur();
+    testPixelShaderPaths();
+    testArguments();
+    testMatchesRender();
+    testMatchesCpuRender();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: GovernorTest.cpp
+//
+// Drives AOFX_GovernorUpdate with synthetic frame time traces. Each level of the built in
+// ladder costs a fixed time, scaled by a per frame load and a deterministic noise term, so
+// every run sees the same trace and the level and resize history can be pinned.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <vector>
+
+#include "AMD_AOFX.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const uint s_LevelCount = 6;         // built in ladder, levels 4 and 5 halve the layer
+static const uint s_FirstResizeLevel = 4;
+
+struct Trace
+{
+    float               m_LevelMilliseconds[s_LevelCount];
+    float               m_Noise;            // relative, uniform in [-m_Noise, m_Noise]
+    uint                m_SpikePeriod;      // every m_SpikePeriod frames one frame takes m_SpikeMilliseconds
+    float               m_SpikeMilliseconds;
+    uint                m_Seed;
+
+    Trace(float l0, float l1, float l2, float l3, float l4, float l5)
+        : m_Noise(0.0f), m_SpikePeriod(0), m_SpikeMilliseconds(0.0f), m_Seed(1)
+    {
+        m_LevelMilliseconds[0] = l0; m_LevelMilliseconds[1] = l1; m_LevelMilliseconds[2] = l2;
+        m_LevelMilliseconds[3] = l3; m_LevelMilliseconds[4] = l4; m_LevelMilliseconds[5] = l5;
+    }
+
+    float frame(uint frame, uint level)
+    {
+        m_Seed = m_Seed * 1664525u + 1013904223u;
+        float noise = ((float)(m_Seed >> 8) / (float)(1 << 24) * 2.0f - 1.0f) * m_Noise;
+        if (m_SpikePeriod != 0 && frame % m_SpikePeriod == m_SpikePeriod - 1)
+            return m_SpikeMilliseconds;
+        return m_LevelMilliseconds[level] * (1.0f + noise);
+    }
+};
+
+struct Simulation
+{
+    AOFX_Governor       m_Governor;
+    std::vector<uint>   m_Levels;           // level after every frame
+    std::vector<uint>   m_ResizeFrames;
+    bool                m_InitialResize;
+
+    void run(Trace & trace, uint frames, uint startLevel = 0)
+    {
+        AOFX_Desc desc;
+        AOFX_GovernorDesc governorDesc;
+        governorDesc.m_StartLevel = startLevel;
+
+        AMD_TEST_CHECK_EQUAL(AOFX_GovernorInitialize(&m_Governor, governorDesc, desc, &m_InitialResize), AOFX_RETURN_CODE_SUCCESS);
+        continueRun(trace, frames, desc);
+    }
+
+    void continueRun(Trace & trace, uint frames, AOFX_Desc & desc)
+    {
+        for (uint frame = 0; frame < frames; frame++)
+        {
+            bool resize = false;
+            AMD_TEST_CHECK_EQUAL(AOFX_GovernorUpdate(&m_Governor, trace.frame((uint)m_Levels.size(), m_Governor.m_Level), desc, &resize), AOFX_RETURN_CODE_SUCCESS);
+            if (resize) m_ResizeFrames.push_back((uint)m_Levels.size());
+            m_Levels.push_back(m_Governor.m_Level);
+        }
+    }
+
+    uint levelChanges() const
+    {
+        uint changes = 0;
+        for (size_t i = 1; i < m_Levels.size(); i++) changes += m_Levels[i] != m_Levels[i - 1] ? 1 : 0;
+        return changes;
+    }
+};
+
+//--------------------------------------------------------------------------------------
+// Over budget from the start: one step per m_DowngradeFrames until the first level that fits
+//--------------------------------------------------------------------------------------
+static void testSettlesOnFirstLevelInBudget()
+{
+    Trace trace(4.0f, 3.0f, 2.4f, 1.8f, 1.2f, 0.8f);
+    trace.m_Noise = 0.05f;
+    Simulation simulation;
+    simulation.run(trace, 2000);
+
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_Level, 3);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_LevelChanges, 3);
+    AMD_TEST_CHECK(simulation.m_ResizeFrames.empty());
+
+    // default m_DowngradeFrames: the average restarts on every level, 4 frames over budget per step
+    AMD_TEST_CHECK_EQUAL(simulation.m_Levels[2], 0);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Levels[3], 1);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Levels[7], 2);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Levels[11], 3);
+}
+
+//--------------------------------------------------------------------------------------
+// Times inside the hysteresis band (0.85 - 1.0 of the budget) never change the level
+//--------------------------------------------------------------------------------------
+static void testHysteresisBandHoldsLevel()
+{
+    Trace trace(1.85f, 1.85f, 1.85f, 1.85f, 1.85f, 1.85f);
+    trace.m_Noise = 0.07f;
+    Simulation simulation;
+    simulation.run(trace, 10000, 2);
+
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_LevelChanges, 0);
+    AMD_TEST_CHECK_EQUAL(simulation.levelChanges(), 0);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_Level, 2);
+
+    // just below the band quality is raised one level per m_UpgradeFrames
+    Trace cheap(1.6f, 1.6f, 1.6f, 1.6f, 1.6f, 1.6f);
+    Simulation raised;
+    raised.run(cheap, 200, 2);
+    AMD_TEST_CHECK_EQUAL(raised.m_Governor.m_Level, 0);
+    AMD_TEST_CHECK_EQUAL(raised.m_Levels[58], 2);
+    AMD_TEST_CHECK_EQUAL(raised.m_Levels[59], 1);
+    AMD_TEST_CHECK_EQUAL(raised.m_Levels[119], 0);
+}
+
+//--------------------------------------------------------------------------------------
+// Single frame spikes are absorbed by the smoothed average before they reach a resize step
+//--------------------------------------------------------------------------------------
+static void testSpikesDoNotResize()
+{
+    Trace trace(4.0f, 3.0f, 2.4f, 1.8f, 1.2f, 0.8f);
+    trace.m_Noise = 0.05f;
+    trace.m_SpikePeriod = 97;
+    trace.m_SpikeMilliseconds = 10.0f;
+    Simulation simulation;
+    simulation.run(trace, 20000, 3);
+
+    AMD_TEST_CHECK(simulation.m_ResizeFrames.empty());
+    uint lowest = 0;
+    for (size_t i = 0; i < simulation.m_Levels.size(); i++) lowest = simulation.m_Levels[i] > lowest ? simulation.m_Levels[i] : lowest;
+    AMD_TEST_CHECK(lowest < s_FirstResizeLevel);
+}
+
+//--------------------------------------------------------------------------------------
+// A level just over budget above one well under it: each failed probe of the upper level
+// doubles the wait before the next one, so the resizes thin out instead of thrashing
+//--------------------------------------------------------------------------------------
+static void testNoResizeThrash()
+{
+    Trace trace(4.0f, 3.0f, 2.6f, 2.1f, 1.0f, 0.7f);
+    Simulation simulation;
+    simulation.run(trace, 60000, 3);
+
+    const std::vector<uint> & resizes = simulation.m_ResizeFrames;
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_Resizes, resizes.size() + (simulation.m_InitialResize ? 1 : 0));
+
+    // the first drop to level 4 waits m_DowngradeFrames * m_ResizeFrameScale frames
+    AMD_TEST_CHECK(!resizes.empty());
+    if (!resizes.empty()) AMD_TEST_CHECK_EQUAL(resizes[0], 15);
+
+    // probes come in pairs (up, down again after m_DowngradeFrames * m_ResizeFrameScale) and every
+    // failed probe doubles the m_UpgradeFrames * m_ResizeFrameScale wait before the next one, up to 64x
+    AMD_TEST_CHECK(resizes.size() % 2 == 1);
+    uint backoff = 1;
+    for (size_t i = 1; i + 1 < resizes.size(); i += 2)
+    {
+        AMD_TEST_CHECK_EQUAL(resizes[i] - resizes[i - 1], 60 * 4 * backoff);
+        AMD_TEST_CHECK_EQUAL(resizes[i + 1] - resizes[i], 4 * 4);
+        backoff = backoff < 64 ? backoff * 2 : 64;
+    }
+
+    // 60000 frames hold 8 probes: 240 * (1 + 2 + 4 + 8 + 16 + 32 + 64 + 64) frames of waiting
+    AMD_TEST_CHECK_EQUAL(resizes.size(), 1 + 2 * 8);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_UpgradeBackoff, 64);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_Level, 4);
+}
+
+//--------------------------------------------------------------------------------------
+// After a heavy phase the governor climbs back once the load drops, and a stable upgrade resets the backoff
+//--------------------------------------------------------------------------------------
+static void testRecoversAfterLoadDrops()
+{
+    Trace heavy(8.0f, 6.0f, 5.0f, 4.0f, 1.9f, 1.2f);
+    Trace light(1.0f, 0.8f, 0.6f, 0.5f, 0.4f, 0.3f);
+
+    AOFX_Desc desc;
+    AOFX_GovernorDesc governorDesc;
+    Simulation simulation;
+    AMD_TEST_CHECK_EQUAL(AOFX_GovernorInitialize(&simulation.m_Governor, governorDesc, desc, &simulation.m_InitialResize), AOFX_RETURN_CODE_SUCCESS);
+
+    simulation.continueRun(heavy, 1000, desc);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_Level, 4);
+    AMD_TEST_CHECK_EQUAL(simulation.m_ResizeFrames.size(), 1);
+    AMD_TEST_CHECK(desc.m_MultiResLayerScale[0] == 0.5f);
+
+    simulation.continueRun(light, 2000, desc);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_Level, 0);
+    AMD_TEST_CHECK_EQUAL(simulation.m_ResizeFrames.size(), 2);
+    AMD_TEST_CHECK_EQUAL(simulation.m_Governor.m_UpgradeBackoff, 1);
+    AMD_TEST_CHECK(desc.m_MultiResLayerScale[0] == 1.0f);
+    AMD_TEST_CHECK_EQUAL(desc.m_SampleCount[0], AOFX_SAMPLE_COUNT_ULTRA);
+}
+
+//--------------------------------------------------------------------------------------
+// The same trace always produces the same level history
+//--------------------------------------------------------------------------------------
+static void testDeterministic()
+{
+    Trace first(4.0f, 3.0f, 2.2f, 1.95f, 1.2f, 0.8f);
+    first.m_Noise = 0.2f;
+    first.m_SpikePeriod = 31;
+    first.m_SpikeMilliseconds = 6.0f;
+    Trace second = first;
+
+    Simulation a, b;
+    a.run(first, 5000);
+    b.run(second, 5000);
+    AMD_TEST_CHECK(a.m_Levels == b.m_Levels);
+    AMD_TEST_CHECK(a.m_ResizeFrames == b.m_ResizeFrames);
+}
+
+static void testArguments()
+{
+    AOFX_Desc desc;
+    AOFX_GovernorDesc governorDesc;
+    AOFX_Governor governor;
+    bool resize = false;
+
+    AMD_TEST_CHECK_EQUAL(AOFX_GovernorInitialize(NULL, governorDesc, desc, &resize), AOFX_RETURN_CODE_INVALID_POINTER);
+    AMD_TEST_CHECK_EQUAL(AOFX_GovernorInitialize(&governor, governorDesc, desc, NULL), AOFX_RETURN_CODE_INVALID_POINTER);
+
+    governorDesc.m_Hysteresis = 1.0f;
+    AMD_TEST_CHECK_EQUAL(AOFX_GovernorInitialize(&governor, governorDesc, desc, &resize), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    governorDesc.m_Hysteresis = 0.15f;
+
+    // the start level is clamped to the ladder
+    governorDesc.m_StartLevel = 100;
+    AMD_TEST_CHECK_EQUAL(AOFX_GovernorInitialize(&governor, governorDesc, desc, &resize), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(governor.m_Level, s_LevelCount - 1);
+    AMD_TEST_CHECK(resize);
+
+    AMD_TEST_CHECK_EQUAL(AOFX_GovernorUpdate(&governor, -1.0f, desc, &resize), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+}
+
+int main()
+{
+    testSettlesOnFirstLevelInBudget();
+    testHysteresisBandHoldsLevel();
+    testSpikesDoNotResize();
+    testNoResizeThrash();
+    testRecoversAfterLoadDrops();
+    testDeterministic();
+    testArguments();
+
+    return AMD_TEST_RESULT();
+}
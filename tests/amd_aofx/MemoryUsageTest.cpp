@@ -0,0 +1,233 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: MemoryUsageTest.cpp
+//
+// AOFX_GetMemoryUsage on the null device. After AOFX_Resize every surface reports the
+// size it was allocated at, the same sizes AOFX_EstimateCost predicts, disabled layers
+// and released descs report nothing. A downscaled layer holds either a full resolution
+// upsample surface or a layer resolution blur intermediate, depending on whether the
+// depth aware dilate permutations are compiled in.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cstring>
+
+#include "AMD_AOFX.h"
+#include "AMD_Test.h"
+
+// the library follows the bytecode, see AMD_AOFX_Precompiled.h
+#include "Shaders/inc/AMD_AOFX_ShaderFeatures.inc"
+
+using namespace AMD;
+
+// AOFX internals the expectations below are derived from (AMD_AOFX_OPAQUE.h)
+static const size_t s_AOSize = 1;           // DXGI_FORMAT_R8_UNORM
+static const size_t s_DepthSize = 2;        // DXGI_FORMAT_R16_FLOAT
+static const size_t s_DepthNormalSize = 8;  // DXGI_FORMAT_R16G16B16A16_FLOAT
+
+struct MemoryFixture
+{
+    ID3D11Device *              m_pDevice;
+    ID3D11DeviceContext *       m_pContext;
+    ID3D11Texture2D *           m_pTexture;
+    ID3D11ShaderResourceView *  m_pSRV;
+    ID3D11RenderTargetView *    m_pRTV;
+    AOFX_Desc                   m_Desc;
+
+    MemoryFixture()
+        : m_pDevice(NULL), m_pContext(NULL), m_pTexture(NULL), m_pSRV(NULL), m_pRTV(NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&m_pDevice, &m_pContext), AOFX_RETURN_CODE_SUCCESS);
+
+        D3D11_TEXTURE2D_DESC textureDesc;
+        memset(&textureDesc, 0, sizeof(textureDesc));
+        textureDesc.Width = 1920;
+        textureDesc.Height = 1080;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        textureDesc.SampleDesc.Count = 1;
+        m_pDevice->CreateTexture2D(&textureDesc, NULL, &m_pTexture);
+        m_pDevice->CreateShaderResourceView(m_pTexture, NULL, &m_pSRV);
+        m_pDevice->CreateRenderTargetView(m_pTexture, NULL, &m_pRTV);
+
+        m_Desc.m_pDevice = m_pDevice;
+        m_Desc.m_pDeviceContext = m_pContext;
+        m_Desc.m_pDepthSRV = m_pSRV;
+        m_Desc.m_pOutputRTV = m_pRTV;
+        m_Desc.m_InputSize.x = 1920;
+        m_Desc.m_InputSize.y = 1080;
+    }
+
+    ~MemoryFixture()
+    {
+        AOFX_Release(m_Desc);
+        m_pRTV->Release();
+        m_pSRV->Release();
+        m_pTexture->Release();
+        m_pContext->Release();
+        m_pDevice->Release();
+    }
+
+    AOFX_MemoryUsage usage()
+    {
+        AOFX_MemoryUsage usage;
+        AMD_TEST_CHECK_EQUAL(AOFX_GetMemoryUsage(m_Desc, &usage), AOFX_RETURN_CODE_SUCCESS);
+        return usage;
+    }
+};
+
+static void checkEqual(const AOFX_MemoryUsage & usage, const AOFX_MemoryUsage & expected)
+{
+    AMD_TEST_CHECK_EQUAL(usage.m_DilateAO, expected.m_DilateAO);
+    AMD_TEST_CHECK_EQUAL(usage.m_BlurAO, expected.m_BlurAO);
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        AMD_TEST_CHECK_EQUAL(usage.m_ResultAO[i], expected.m_ResultAO[i]);
+        AMD_TEST_CHECK_EQUAL(usage.m_InputAO[i], expected.m_InputAO[i]);
+        AMD_TEST_CHECK_EQUAL(usage.m_UpsampleAO[i], expected.m_UpsampleAO[i]);
+        AMD_TEST_CHECK_EQUAL(usage.m_BlurLayerAO[i], expected.m_BlurLayerAO[i]);
+    }
+    AMD_TEST_CHECK_EQUAL(usage.m_Buffers, expected.m_Buffers);
+    AMD_TEST_CHECK_EQUAL(usage.m_Total, expected.m_Total);
+}
+
+static void checkTotal(const AOFX_MemoryUsage & usage)
+{
+    size_t total = usage.m_DilateAO + usage.m_BlurAO + usage.m_Buffers;
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+        total += usage.m_ResultAO[i] + usage.m_InputAO[i] + usage.m_UpsampleAO[i] + usage.m_BlurLayerAO[i];
+    AMD_TEST_CHECK_EQUAL(usage.m_Total, total);
+}
+
+static void checkEstimate(AOFX_Desc & desc, const AOFX_MemoryUsage & usage)
+{
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+    checkEqual(usage, estimate.m_Memory);
+}
+
+//--------------------------------------------------------------------------------------
+// The default desc: a full, a half and a quarter resolution layer
+//--------------------------------------------------------------------------------------
+static void testDefaultLayers()
+{
+    MemoryFixture fixture;
+    AOFX_Desc & desc = fixture.m_Desc;
+
+    AOFX_MemoryUsage usage;
+    AMD_TEST_CHECK_EQUAL(AOFX_GetMemoryUsage(desc, NULL), AOFX_RETURN_CODE_INVALID_POINTER);
+    AMD_TEST_CHECK_EQUAL(AOFX_GetMemoryUsage(desc, &usage), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(usage.m_Total, 0);
+
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    usage = fixture.usage();
+
+    const size_t texels = 1920 * 1080;
+    const size_t layerTexels[] = { texels, 960 * 540, 480 * 270 };
+    AMD_TEST_CHECK_EQUAL(usage.m_DilateAO, texels * s_AOSize);
+    AMD_TEST_CHECK_EQUAL(usage.m_BlurAO, texels * s_AOSize);
+    for (uint i = 0; i < AOFX_Desc::m_MultiResLayerCount; i++)
+    {
+        AMD_TEST_CHECK_EQUAL(usage.m_ResultAO[i], layerTexels[i] * s_AOSize);
+        AMD_TEST_CHECK_EQUAL(usage.m_InputAO[i], layerTexels[i] * s_DepthSize);
+
+        // the full resolution layer needs neither, a downscaled one exactly one of them
+        bool downscaled = i > 0;
+        AMD_TEST_CHECK_EQUAL(usage.m_UpsampleAO[i], downscaled && !AOFX_SHADERS_DILATE_UPSAMPLE ? texels * s_AOSize : 0);
+        AMD_TEST_CHECK_EQUAL(usage.m_BlurLayerAO[i], downscaled && AOFX_SHADERS_DILATE_UPSAMPLE ? layerTexels[i] * s_AOSize : 0);
+    }
+    AMD_TEST_CHECK(usage.m_Buffers > 0);
+    checkTotal(usage);
+    checkEstimate(desc, usage);
+
+    // rendering allocates nothing more
+    AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+    checkEqual(fixture.usage(), usage);
+
+    AMD_TEST_CHECK_EQUAL(AOFX_Release(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(fixture.usage().m_Total, 0);
+}
+
+//--------------------------------------------------------------------------------------
+// Resizes, disabled layers, deinterleaving and normals are reflected after AOFX_Resize
+//--------------------------------------------------------------------------------------
+static void testFollowsResize()
+{
+    MemoryFixture fixture;
+    AOFX_Desc & desc = fixture.m_Desc;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    const AOFX_MemoryUsage full = fixture.usage();
+
+    // sizes reflect the last AOFX_Resize, not the desc
+    desc.m_InputSize.x = 1280;
+    desc.m_InputSize.y = 720;
+    checkEqual(fixture.usage(), full);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AOFX_MemoryUsage usage = fixture.usage();
+    AMD_TEST_CHECK_EQUAL(usage.m_DilateAO, 1280 * 720 * s_AOSize);
+    AMD_TEST_CHECK(usage.m_Total < full.m_Total);
+    checkTotal(usage);
+    checkEstimate(desc, usage);
+
+    // a disabled layer releases its surfaces
+    desc.m_LayerProcess[2] = AOFX_LAYER_PROCESS_NONE;
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    usage = fixture.usage();
+    AMD_TEST_CHECK_EQUAL(usage.m_ResultAO[2] + usage.m_InputAO[2] + usage.m_UpsampleAO[2] + usage.m_BlurLayerAO[2], 0);
+    checkTotal(usage);
+    checkEstimate(desc, usage);
+
+    // a deinterleaved layer rounds its slices up, normals widen its input
+    desc.m_LayerProcess[1] = AOFX_LAYER_PROCESS_DEINTERLEAVE_4;
+    desc.m_MultiResLayerScale[1] = 0.75f;
+    desc.m_NormalOption[0] = AOFX_NORMAL_OPTION_READ_FROM_SRV;
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    usage = fixture.usage();
+    AMD_TEST_CHECK_EQUAL(usage.m_InputAO[0], 1280 * 720 * s_DepthNormalSize);
+    AMD_TEST_CHECK_EQUAL(usage.m_ResultAO[1], 960 * 540 * s_AOSize);
+    AMD_TEST_CHECK_EQUAL(usage.m_InputAO[1], 240 * 135 * 16 * s_DepthSize);
+    AMD_TEST_CHECK_EQUAL(usage.m_UpsampleAO[1] + usage.m_BlurLayerAO[1],
+                         AOFX_SHADERS_DILATE_UPSAMPLE ? 960 * 540 * s_AOSize : 1280 * 720 * s_AOSize);
+    checkTotal(usage);
+    checkEstimate(desc, usage);
+
+    // a layer back at full resolution drops its upsample surface or blur intermediate
+    desc.m_MultiResLayerScale[1] = 1.0f;
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    usage = fixture.usage();
+    AMD_TEST_CHECK_EQUAL(usage.m_UpsampleAO[1] + usage.m_BlurLayerAO[1], 0);
+    checkTotal(usage);
+    checkEstimate(desc, usage);
+}
+
+int main()
+{
+    testDefaultLayers();
+    testFollowsResize();
+
+    return AMD_TEST_RESULT();
+}
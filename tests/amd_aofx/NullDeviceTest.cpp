@@ -0,0 +1,685 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: NullDeviceTest.cpp
+//
+// Checks the commands AOFX_Render records on the null device: one dispatch per compute
+// pass and one draw per pixel shader pass of the AOFX_EstimateCost stages, no object
+// creation after AOFX_Resize, AOFX_BenchmarkRender counters summed over its frames,
+// application state left unchanged by AOFX_STATE_RESTORE_USED, and the shader objects of
+// AOFX_SHADER_CREATION_ON_DEMAND with and without AOFX_PrewarmShaders.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cstdio>
+#include <cstring>
+
+#include "AMD_AOFX.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+struct NullDevice
+{
+    ID3D11Device *              m_pDevice;
+    ID3D11DeviceContext *       m_pContext;
+    ID3D11Texture2D *           m_pTexture;
+    ID3D11ShaderResourceView *  m_pSRV;
+    ID3D11RenderTargetView *    m_pRTV;
+
+    NullDevice(uint width, uint height)
+        : m_pDevice(NULL), m_pContext(NULL), m_pTexture(NULL), m_pSRV(NULL), m_pRTV(NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&m_pDevice, &m_pContext), AOFX_RETURN_CODE_SUCCESS);
+
+        D3D11_TEXTURE2D_DESC textureDesc;
+        memset(&textureDesc, 0, sizeof(textureDesc));
+        textureDesc.Width = width;
+        textureDesc.Height = height;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        textureDesc.SampleDesc.Count = 1;
+        m_pDevice->CreateTexture2D(&textureDesc, NULL, &m_pTexture);
+        m_pDevice->CreateShaderResourceView(m_pTexture, NULL, &m_pSRV);
+        m_pDevice->CreateRenderTargetView(m_pTexture, NULL, &m_pRTV);
+    }
+
+    ~NullDevice()
+    {
+        m_pRTV->Release();
+        m_pSRV->Release();
+        m_pTexture->Release();
+        m_pContext->Release();
+        m_pDevice->Release();
+    }
+
+    void bind(AOFX_Desc & desc)
+    {
+        desc.m_pDevice = m_pDevice;
+        desc.m_pDeviceContext = m_pContext;
+        desc.m_pDepthSRV = m_pSRV;
+        desc.m_pOutputRTV = m_pRTV;
+    }
+};
+
+static void countPasses(const AOFX_Desc & desc, uint & computePasses, uint & pixelPasses)
+{
+    AOFX_CostEstimate estimate;
+    AMD_TEST_CHECK_EQUAL(AOFX_EstimateCost(desc, &estimate), AOFX_RETURN_CODE_SUCCESS);
+
+    computePasses = pixelPasses = 0;
+    for (uint i = 0; i < estimate.m_StageCount; i++)
+        (estimate.m_Stages[i].m_ThreadGroups != 0 ? computePasses : pixelPasses) += estimate.m_Stages[i].m_Passes;
+}
+
+//--------------------------------------------------------------------------------------
+// Every configuration records exactly the passes the estimate lists, and nothing is created per frame
+//--------------------------------------------------------------------------------------
+static void testRecordedCommandsPerRender()
+{
+    static const uint implementations[] =
+    {
+        AOFX_IMPLEMENTATION_MASK_KERNEL_CS | AOFX_IMPLEMENTATION_MASK_UTILITY_CS | AOFX_IMPLEMENTATION_MASK_BLUR_CS,
+        AOFX_IMPLEMENTATION_MASK_KERNEL_PS | AOFX_IMPLEMENTATION_MASK_UTILITY_PS | AOFX_IMPLEMENTATION_MASK_BLUR_CS,
+        AOFX_IMPLEMENTATION_MASK_KERNEL_CS | AOFX_IMPLEMENTATION_MASK_UTILITY_PS | AOFX_IMPLEMENTATION_MASK_BLUR_CS,
+    };
+
+    NullDevice device(1280, 720);
+    AOFX_Desc desc;
+    device.bind(desc);
+    desc.m_InputSize.x = 1280;
+    desc.m_InputSize.y = 720;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+
+    for (uint implementation = 0; implementation < sizeof(implementations) / sizeof(implementations[0]); implementation++)
+    {
+        for (uint layerCount = 1; layerCount <= AOFX_Desc::m_MultiResLayerCount; layerCount++)
+        {
+            for (int radius = AOFX_BILATERAL_BLUR_RADIUS_NONE; radius <= AOFX_BILATERAL_BLUR_RADIUS_8; radius++)
+            {
+                desc.m_Implementation = implementations[implementation];
+                for (uint layer = 0; layer < AOFX_Desc::m_MultiResLayerCount; layer++)
+                {
+                    desc.m_LayerProcess[layer] = layer < layerCount ? (AOFX_LAYER_PROCESS)(layer % AOFX_LAYER_PROCESS_COUNT) : AOFX_LAYER_PROCESS_NONE;
+                    desc.m_BilateralBlurRadius[layer] = (AOFX_BILATERAL_BLUR_RADIUS)radius;
+                }
+                AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+                AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+
+                AMD_TEST_CHECK_EQUAL(AOFX_ResetDeviceCounters(device.m_pContext), AOFX_RETURN_CODE_SUCCESS);
+                desc.m_Camera.m_Fov += 0.01f;
+                AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+
+                AOFX_DeviceCounters counters;
+                AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(device.m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+
+                uint computePasses = 0, pixelPasses = 0;
+                countPasses(desc, computePasses, pixelPasses);
+                AMD_TEST_CHECK_EQUAL(counters.m_Dispatches, computePasses);
+                AMD_TEST_CHECK_EQUAL(counters.m_Draws, pixelPasses);
+                AMD_TEST_CHECK_EQUAL(counters.m_Maps, counters.m_Unmaps);
+                AMD_TEST_CHECK(counters.m_Maps >= 1);
+                AMD_TEST_CHECK(counters.m_BytesUploaded > 0);
+                AMD_TEST_CHECK_EQUAL(counters.m_ObjectsCreated, 0);
+                AMD_TEST_CHECK_EQUAL(counters.m_Copies, 0);
+                AMD_TEST_CHECK_EQUAL(counters.m_Clears, 0);
+                AMD_TEST_CHECK(counters.m_StateBinds > 0);
+            }
+        }
+    }
+
+    AOFX_Release(desc);
+}
+
+//--------------------------------------------------------------------------------------
+// AOFX_BenchmarkRender sums the counters of its measured frames and restores the desc
+//--------------------------------------------------------------------------------------
+static void testBenchmarkCounters()
+{
+    NullDevice device(1920, 1080);
+    AOFX_Desc desc;
+    device.bind(desc);
+    desc.m_InputSize.x = 1920;
+    desc.m_InputSize.y = 1080;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+
+    AOFX_QualityLevel levels[2];
+    for (uint i = 0; i < 2; i++)
+    {
+        levels[i].m_LayerProcess[0] = AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE;
+        levels[i].m_MultiResLayerScale[0] = i == 0 ? 1.0f : 0.5f;
+        levels[i].m_SampleCount[0] = i == 0 ? AOFX_SAMPLE_COUNT_ULTRA : AOFX_SAMPLE_COUNT_LOW;
+        levels[i].m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_4;
+    }
+
+    const uint frames = 25;
+    AOFX_RenderBenchmark results[2];
+    AMD_TEST_CHECK_EQUAL(AOFX_BenchmarkRender(desc, levels, 2, frames, results), AOFX_RETURN_CODE_SUCCESS);
+
+    for (uint i = 0; i < 2; i++)
+    {
+        const AOFX_RenderBenchmark & result = results[i];
+        AMD_TEST_CHECK_EQUAL(result.m_Frames, frames);
+        AMD_TEST_CHECK(result.m_NanosecondsPerRender > 0.0);
+        AMD_TEST_CHECK(result.m_MinNanoseconds <= result.m_NanosecondsPerRender);
+        AMD_TEST_CHECK(result.m_NanosecondsPerRender <= result.m_MaxNanoseconds);
+
+        // the level is applied and warmed up before the measured frames
+        AOFX_Desc levelDesc;
+        for (uint layer = 0; layer < AOFX_Desc::m_MultiResLayerCount; layer++)
+        {
+            levelDesc.m_LayerProcess[layer] = levels[i].m_LayerProcess[layer];
+            levelDesc.m_MultiResLayerScale[layer] = levels[i].m_MultiResLayerScale[layer];
+            levelDesc.m_SampleCount[layer] = levels[i].m_SampleCount[layer];
+            levelDesc.m_BilateralBlurRadius[layer] = levels[i].m_BilateralBlurRadius[layer];
+        }
+        levelDesc.m_InputSize = desc.m_InputSize;
+
+        uint computePasses = 0, pixelPasses = 0;
+        countPasses(levelDesc, computePasses, pixelPasses);
+        AMD_TEST_CHECK_EQUAL(result.m_Counters.m_Dispatches, frames * computePasses);
+        AMD_TEST_CHECK_EQUAL(result.m_Counters.m_Draws, frames * pixelPasses);
+        AMD_TEST_CHECK_EQUAL(result.m_Counters.m_ObjectsCreated, 0);
+        AMD_TEST_CHECK(result.m_Counters.m_Maps <= frames);
+        AMD_TEST_CHECK_EQUAL(result.m_Counters.m_Maps, result.m_Counters.m_Unmaps);
+    }
+
+    // the original settings are back
+    AMD_TEST_CHECK_EQUAL(desc.m_LayerProcess[1], AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE);
+    AMD_TEST_CHECK(desc.m_MultiResLayerScale[0] == 1.0f);
+    AMD_TEST_CHECK_EQUAL(desc.m_SampleCount[0], AOFX_SAMPLE_COUNT_LOW);
+
+    AOFX_Release(desc);
+}
+
+//--------------------------------------------------------------------------------------
+// Application state bound in and past the slots AOFX_STATE_RESTORE_USED captures
+//--------------------------------------------------------------------------------------
+struct AppState
+{
+    // the restore captures the leading 2 samplers and constant buffers, 8 views and 8 vertex buffers,
+    // two slots past each of them are bound as well, D3D11.0 has no UAV slot past the captured ones
+    static const uint m_SamplerSlots = 4;
+    static const uint m_ConstantBufferSlots = 4;
+    static const uint m_ViewSlots = 10;
+    static const uint m_UAVSlots = D3D11_PS_CS_UAV_REGISTER_COUNT;
+
+    ID3D11SamplerState *            m_pSamplers[m_SamplerSlots];
+    ID3D11Buffer *                  m_pConstantBuffers[m_ConstantBufferSlots];
+    ID3D11ShaderResourceView *      m_pSRVs[m_ViewSlots];
+    ID3D11UnorderedAccessView *     m_pUAVs[m_UAVSlots];
+    ID3D11Buffer *                  m_pVertexBuffers[m_ViewSlots];
+    UINT                            m_Strides[m_ViewSlots];
+    UINT                            m_Offsets[m_ViewSlots];
+    ID3D11RenderTargetView *        m_pRTVs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    ID3D11VertexShader *            m_pVS;
+    ID3D11GeometryShader *          m_pGS;
+    ID3D11PixelShader *             m_pPS;
+    ID3D11ComputeShader *           m_pCS;
+    ID3D11BlendState *              m_pBlendState;
+    ID3D11RasterizerState *         m_pRasterizerState;
+    D3D11_VIEWPORT                  m_Viewports[2];
+
+    AppState(ID3D11Device * pDevice, ID3D11Texture2D * pTexture)
+    {
+        static const BYTE bytecode[4] = {};
+
+        D3D11_SAMPLER_DESC samplerDesc;
+        memset(&samplerDesc, 0, sizeof(samplerDesc));
+        for (uint i = 0; i < m_SamplerSlots; i++)
+            pDevice->CreateSamplerState(&samplerDesc, &m_pSamplers[i]);
+
+        D3D11_BUFFER_DESC bufferDesc;
+        memset(&bufferDesc, 0, sizeof(bufferDesc));
+        bufferDesc.ByteWidth = 256;
+        for (uint i = 0; i < m_ConstantBufferSlots; i++)
+            pDevice->CreateBuffer(&bufferDesc, NULL, &m_pConstantBuffers[i]);
+
+        for (uint i = 0; i < m_ViewSlots; i++)
+        {
+            pDevice->CreateShaderResourceView(pTexture, NULL, &m_pSRVs[i]);
+            pDevice->CreateBuffer(&bufferDesc, NULL, &m_pVertexBuffers[i]);
+            m_Strides[i] = 16;
+            m_Offsets[i] = 16 * i;
+        }
+        for (uint i = 0; i < m_UAVSlots; i++)
+            pDevice->CreateUnorderedAccessView(pTexture, NULL, &m_pUAVs[i]);
+        for (uint i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
+            pDevice->CreateRenderTargetView(pTexture, NULL, &m_pRTVs[i]);
+
+        pDevice->CreateVertexShader(bytecode, sizeof(bytecode), NULL, &m_pVS);
+        pDevice->CreateGeometryShader(bytecode, sizeof(bytecode), NULL, &m_pGS);
+        pDevice->CreatePixelShader(bytecode, sizeof(bytecode), NULL, &m_pPS);
+        pDevice->CreateComputeShader(bytecode, sizeof(bytecode), NULL, &m_pCS);
+
+        D3D11_BLEND_DESC blendDesc;
+        memset(&blendDesc, 0, sizeof(blendDesc));
+        pDevice->CreateBlendState(&blendDesc, &m_pBlendState);
+        D3D11_RASTERIZER_DESC rasterizerDesc;
+        memset(&rasterizerDesc, 0, sizeof(rasterizerDesc));
+        pDevice->CreateRasterizerState(&rasterizerDesc, &m_pRasterizerState);
+
+        for (uint i = 0; i < 2; i++)
+        {
+            D3D11_VIEWPORT viewport = { 10.0f * i, 20.0f, 300.0f, 200.0f, 0.0f, 1.0f };
+            m_Viewports[i] = viewport;
+        }
+    }
+
+    ~AppState()
+    {
+        for (uint i = 0; i < m_SamplerSlots; i++) m_pSamplers[i]->Release();
+        for (uint i = 0; i < m_ConstantBufferSlots; i++) m_pConstantBuffers[i]->Release();
+        for (uint i = 0; i < m_ViewSlots; i++)
+        {
+            m_pSRVs[i]->Release();
+            m_pVertexBuffers[i]->Release();
+        }
+        for (uint i = 0; i < m_UAVSlots; i++) m_pUAVs[i]->Release();
+        for (uint i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++) m_pRTVs[i]->Release();
+        m_pVS->Release();
+        m_pGS->Release();
+        m_pPS->Release();
+        m_pCS->Release();
+        m_pBlendState->Release();
+        m_pRasterizerState->Release();
+    }
+
+    void bind(ID3D11DeviceContext * pContext)
+    {
+        const FLOAT blendFactor[4] = { 0.25f, 0.5f, 0.75f, 1.0f };
+
+        pContext->PSSetSamplers(0, m_SamplerSlots, m_pSamplers);
+        pContext->PSSetConstantBuffers(0, m_ConstantBufferSlots, m_pConstantBuffers);
+        pContext->PSSetShaderResources(0, m_ViewSlots, m_pSRVs);
+        pContext->PSSetShader(m_pPS, NULL, 0);
+        pContext->CSSetSamplers(0, m_SamplerSlots, m_pSamplers);
+        pContext->CSSetConstantBuffers(0, m_ConstantBufferSlots, m_pConstantBuffers);
+        pContext->CSSetShaderResources(0, m_ViewSlots, m_pSRVs);
+        pContext->CSSetUnorderedAccessViews(0, m_UAVSlots, m_pUAVs, NULL);
+        pContext->CSSetShader(m_pCS, NULL, 0);
+        pContext->VSSetShader(m_pVS, NULL, 0);
+        pContext->GSSetShader(m_pGS, NULL, 0);
+        pContext->IASetVertexBuffers(0, m_ViewSlots, m_pVertexBuffers, m_Strides, m_Offsets);
+        pContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+        pContext->RSSetState(m_pRasterizerState);
+        pContext->RSSetViewports(2, m_Viewports);
+        pContext->OMSetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, m_pRTVs, NULL);
+        pContext->OMSetBlendState(m_pBlendState, blendFactor, 0x0F);
+    }
+};
+
+// every returned reference is released, the objects stay alive through the application's references
+template <class Object>
+static void checkSlots(Object * const * ppExpected, Object ** ppBound, uint count)
+{
+    for (uint i = 0; i < count; i++)
+    {
+        AMD_TEST_CHECK(ppBound[i] == ppExpected[i]);
+        if (ppBound[i] != NULL) ppBound[i]->Release();
+    }
+}
+
+static void checkAppState(ID3D11DeviceContext * pContext, AppState & app)
+{
+    ID3D11SamplerState * pSamplers[AppState::m_SamplerSlots];
+    ID3D11Buffer * pConstantBuffers[AppState::m_ConstantBufferSlots];
+    ID3D11ShaderResourceView * pSRVs[AppState::m_ViewSlots];
+    ID3D11UnorderedAccessView * pUAVs[AppState::m_UAVSlots];
+    ID3D11Buffer * pVertexBuffers[AppState::m_ViewSlots];
+    UINT strides[AppState::m_ViewSlots], offsets[AppState::m_ViewSlots];
+    ID3D11RenderTargetView * pRTVs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+    ID3D11DepthStencilView * pDSV = NULL;
+
+    pContext->PSGetSamplers(0, AppState::m_SamplerSlots, pSamplers);
+    checkSlots(app.m_pSamplers, pSamplers, AppState::m_SamplerSlots);
+    pContext->PSGetConstantBuffers(0, AppState::m_ConstantBufferSlots, pConstantBuffers);
+    checkSlots(app.m_pConstantBuffers, pConstantBuffers, AppState::m_ConstantBufferSlots);
+    pContext->PSGetShaderResources(0, AppState::m_ViewSlots, pSRVs);
+    checkSlots(app.m_pSRVs, pSRVs, AppState::m_ViewSlots);
+
+    pContext->CSGetSamplers(0, AppState::m_SamplerSlots, pSamplers);
+    checkSlots(app.m_pSamplers, pSamplers, AppState::m_SamplerSlots);
+    pContext->CSGetConstantBuffers(0, AppState::m_ConstantBufferSlots, pConstantBuffers);
+    checkSlots(app.m_pConstantBuffers, pConstantBuffers, AppState::m_ConstantBufferSlots);
+    pContext->CSGetShaderResources(0, AppState::m_ViewSlots, pSRVs);
+    checkSlots(app.m_pSRVs, pSRVs, AppState::m_ViewSlots);
+    pContext->CSGetUnorderedAccessViews(0, AppState::m_UAVSlots, pUAVs);
+    checkSlots(app.m_pUAVs, pUAVs, AppState::m_UAVSlots);
+
+    ID3D11VertexShader * pVS = NULL;
+    ID3D11GeometryShader * pGS = NULL;
+    ID3D11PixelShader * pPS = NULL;
+    ID3D11ComputeShader * pCS = NULL;
+    pContext->VSGetShader(&pVS, NULL, NULL);
+    checkSlots(&app.m_pVS, &pVS, 1);
+    pContext->GSGetShader(&pGS, NULL, NULL);
+    checkSlots(&app.m_pGS, &pGS, 1);
+    pContext->PSGetShader(&pPS, NULL, NULL);
+    checkSlots(&app.m_pPS, &pPS, 1);
+    pContext->CSGetShader(&pCS, NULL, NULL);
+    checkSlots(&app.m_pCS, &pCS, 1);
+
+    pContext->IAGetVertexBuffers(0, AppState::m_ViewSlots, pVertexBuffers, strides, offsets);
+    checkSlots(app.m_pVertexBuffers, pVertexBuffers, AppState::m_ViewSlots);
+    AMD_TEST_CHECK(memcmp(strides, app.m_Strides, sizeof(strides)) == 0);
+    AMD_TEST_CHECK(memcmp(offsets, app.m_Offsets, sizeof(offsets)) == 0);
+    D3D11_PRIMITIVE_TOPOLOGY topology;
+    pContext->IAGetPrimitiveTopology(&topology);
+    AMD_TEST_CHECK_EQUAL(topology, D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
+
+    ID3D11RasterizerState * pRasterizerState = NULL;
+    pContext->RSGetState(&pRasterizerState);
+    checkSlots(&app.m_pRasterizerState, &pRasterizerState, 1);
+    D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+    UINT viewportCount = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+    pContext->RSGetViewports(&viewportCount, viewports);
+    AMD_TEST_CHECK_EQUAL(viewportCount, 2);
+    AMD_TEST_CHECK(memcmp(viewports, app.m_Viewports, sizeof(app.m_Viewports)) == 0);
+
+    pContext->OMGetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, pRTVs, &pDSV);
+    checkSlots(app.m_pRTVs, pRTVs, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+    AMD_TEST_CHECK(pDSV == NULL);
+    ID3D11BlendState * pBlendState = NULL;
+    FLOAT blendFactor[4];
+    UINT sampleMask = 0;
+    pContext->OMGetBlendState(&pBlendState, blendFactor, &sampleMask);
+    checkSlots(&app.m_pBlendState, &pBlendState, 1);
+    AMD_TEST_CHECK(blendFactor[0] == 0.25f && blendFactor[3] == 1.0f);
+    AMD_TEST_CHECK_EQUAL(sampleMask, 0x0F);
+}
+
+//--------------------------------------------------------------------------------------
+// AOFX_STATE_RESTORE_USED leaves application state in the captured slots and past them unchanged,
+// for every pass implementation
+//--------------------------------------------------------------------------------------
+static void testStateRestoreUsed()
+{
+    static const uint implementations[] =
+    {
+        AOFX_IMPLEMENTATION_MASK_KERNEL_CS | AOFX_IMPLEMENTATION_MASK_UTILITY_CS | AOFX_IMPLEMENTATION_MASK_BLUR_CS,
+        AOFX_IMPLEMENTATION_MASK_KERNEL_PS | AOFX_IMPLEMENTATION_MASK_UTILITY_PS | AOFX_IMPLEMENTATION_MASK_BLUR_CS,
+        AOFX_IMPLEMENTATION_MASK_KERNEL_CS | AOFX_IMPLEMENTATION_MASK_UTILITY_PS | AOFX_IMPLEMENTATION_MASK_BLUR_CS,
+    };
+
+    NullDevice device(640, 360);
+    AppState app(device.m_pDevice, device.m_pTexture);
+    AOFX_Desc desc;
+    device.bind(desc);
+    desc.m_InputSize.x = 640;
+    desc.m_InputSize.y = 360;
+    desc.m_StateRestore = AOFX_STATE_RESTORE_USED;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+
+    for (uint implementation = 0; implementation < sizeof(implementations) / sizeof(implementations[0]); implementation++)
+    {
+        desc.m_Implementation = implementations[implementation];
+        for (uint layer = 0; layer < AOFX_Desc::m_MultiResLayerCount; layer++)
+            desc.m_BilateralBlurRadius[layer] = AOFX_BILATERAL_BLUR_RADIUS_4;
+        AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+
+        // the second render runs with the state cache warm
+        for (uint frame = 0; frame < 2; frame++)
+        {
+            app.bind(device.m_pContext);
+            AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+            checkAppState(device.m_pContext, app);
+        }
+    }
+
+    AOFX_Release(desc);
+}
+
+//--------------------------------------------------------------------------------------
+// Shader objects AOFX holds, on the device side: every created object that was not released
+// again, minus the ones the fixture created
+//--------------------------------------------------------------------------------------
+static uint liveObjects(NullDevice & device)
+{
+    AOFX_DeviceCounters counters;
+    AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(device.m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+    return counters.m_ObjectsCreated - counters.m_ObjectsReleased;
+}
+
+static AOFX_ShaderStats shaderStats(const AOFX_Desc & desc)
+{
+    AOFX_ShaderStats stats;
+    AMD_TEST_CHECK_EQUAL(AOFX_GetShaderStats(desc, &stats), AOFX_RETURN_CODE_SUCCESS);
+    return stats;
+}
+
+// levels only differ in what selects shaders, so no level needs AOFX_Resize
+static void shaderLadder(AOFX_QualityLevel * pLevels, uint levelCount)
+{
+    for (uint i = 0; i < levelCount; i++)
+    {
+        for (uint layer = 0; layer < AOFX_Desc::m_MultiResLayerCount; layer++)
+        {
+            pLevels[i].m_LayerProcess[layer] = AOFX_LAYER_PROCESS_DEINTERLEAVE_NONE;
+            pLevels[i].m_MultiResLayerScale[layer] = AOFX_Desc().m_MultiResLayerScale[layer];
+            pLevels[i].m_SampleCount[layer] = (AOFX_SAMPLE_COUNT)(i % AOFX_SAMPLE_COUNT_COUNT);
+            pLevels[i].m_BilateralBlurRadius[layer] = (AOFX_BILATERAL_BLUR_RADIUS)(i / AOFX_SAMPLE_COUNT_COUNT % AOFX_BILATERAL_BLUR_RADIUS_COUNT);
+        }
+    }
+}
+
+static void applyLevel(const AOFX_QualityLevel & level, AOFX_Desc & desc)
+{
+    for (uint layer = 0; layer < AOFX_Desc::m_MultiResLayerCount; layer++)
+    {
+        desc.m_LayerProcess[layer] = level.m_LayerProcess[layer];
+        desc.m_MultiResLayerScale[layer] = level.m_MultiResLayerScale[layer];
+        desc.m_SampleCount[layer] = level.m_SampleCount[layer];
+        desc.m_BilateralBlurRadius[layer] = level.m_BilateralBlurRadius[layer];
+    }
+}
+
+//--------------------------------------------------------------------------------------
+// AOFX_SHADER_CREATION_ON_DEMAND creates a fraction of the objects of ALL at initialization,
+// and the missing shaders of a new configuration on its first render only
+//--------------------------------------------------------------------------------------
+static void testShaderCreationOnDemand()
+{
+    uint objects[AOFX_SHADER_CREATION_COUNT] = {};
+    uint shaders[AOFX_SHADER_CREATION_COUNT] = {};
+
+    for (int creation = 0; creation < AOFX_SHADER_CREATION_COUNT; creation++)
+    {
+        NullDevice device(640, 360);
+        AOFX_Desc desc;
+        device.bind(desc);
+        desc.m_InputSize.x = 640;
+        desc.m_InputSize.y = 360;
+        desc.m_ShaderCreation = (AOFX_SHADER_CREATION)creation;
+
+        uint fixtureObjects = liveObjects(device);
+        AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+        objects[creation] = liveObjects(device) - fixtureObjects;
+
+        AOFX_ShaderStats stats = shaderStats(desc);
+        shaders[creation] = stats.m_ShadersCreated;
+        AMD_TEST_CHECK(stats.m_InitializeMilliseconds > 0.0f);
+        printf("%-9s AOFX_Initialize: %3u shaders of %u permutations, %4u device objects, %8.3f ms, %8.3f ms creating shaders\n",
+               creation == AOFX_SHADER_CREATION_ALL ? "ALL" : "ON_DEMAND", stats.m_ShadersCreated, stats.m_PermutationCount,
+               objects[creation], stats.m_InitializeMilliseconds, stats.m_CreateMilliseconds);
+
+        AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(shaderStats(desc).m_ShadersCreatedByRender, 0);
+
+        // a configuration change creates its shaders on the first render after it, and only there
+        uint objectsBefore = liveObjects(device);
+        desc.m_SampleCount[0] = AOFX_SAMPLE_COUNT_ULTRA;
+        desc.m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_8;
+        for (uint frame = 0; frame < 3; frame++)
+        {
+            AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+
+            stats = shaderStats(desc);
+            AMD_TEST_CHECK_EQUAL(liveObjects(device) - objectsBefore, stats.m_ShadersCreatedByRender);
+            AMD_TEST_CHECK_EQUAL(stats.m_ShadersCreated, shaders[creation] + stats.m_ShadersCreatedByRender);
+            if (creation == AOFX_SHADER_CREATION_ALL) AMD_TEST_CHECK_EQUAL(stats.m_ShadersCreatedByRender, 0);
+            else AMD_TEST_CHECK(stats.m_ShadersCreatedByRender > 0);
+        }
+
+        AOFX_Release(desc);
+        AMD_TEST_CHECK_EQUAL(liveObjects(device), fixtureObjects);
+    }
+
+    // both modes create the same surfaces and buffers, ON_DEMAND only skips shaders
+    AMD_TEST_CHECK(shaders[AOFX_SHADER_CREATION_ON_DEMAND] * 4 < shaders[AOFX_SHADER_CREATION_ALL]);
+    AMD_TEST_CHECK_EQUAL(objects[AOFX_SHADER_CREATION_ALL] - objects[AOFX_SHADER_CREATION_ON_DEMAND],
+                         shaders[AOFX_SHADER_CREATION_ALL] - shaders[AOFX_SHADER_CREATION_ON_DEMAND]);
+}
+
+//--------------------------------------------------------------------------------------
+// Rendering while a background prewarm creates the same shaders: a shader created by both
+// threads is kept once and the other object is released, and once the prewarm is done
+// every level renders without creating anything
+//--------------------------------------------------------------------------------------
+static void testPrewarmWhileRendering()
+{
+    static const uint levelCount = AOFX_SAMPLE_COUNT_COUNT * 3;
+    AOFX_QualityLevel levels[levelCount];
+    shaderLadder(levels, levelCount);
+
+    // the shaders a synchronous prewarm of the ladder ends up with
+    uint expectedShaders = 0;
+    {
+        NullDevice device(640, 360);
+        AOFX_Desc desc;
+        device.bind(desc);
+        desc.m_ShaderCreation = AOFX_SHADER_CREATION_ON_DEMAND;
+        AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_PrewarmShaders(desc, levels, levelCount, false), AOFX_RETURN_CODE_SUCCESS);
+        expectedShaders = shaderStats(desc).m_ShadersCreated;
+        AOFX_Release(desc);
+    }
+
+    NullDevice device(640, 360);
+    AOFX_Desc desc;
+    device.bind(desc);
+    desc.m_InputSize.x = 640;
+    desc.m_InputSize.y = 360;
+    desc.m_ShaderCreation = AOFX_SHADER_CREATION_ON_DEMAND;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    uint initializeShaders = shaderStats(desc).m_ShadersCreated;
+    uint objectsBefore = liveObjects(device);
+
+    AMD_TEST_CHECK_EQUAL(AOFX_PrewarmShaders(desc, levels, levelCount, true), AOFX_RETURN_CODE_SUCCESS);
+
+    // the render thread walks the ladder backwards so it meets the worker halfway
+    for (uint i = levelCount; i-- > 0;)
+    {
+        applyLevel(levels[i], desc);
+        AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+    }
+
+    // a second prewarm waits for the first one
+    AMD_TEST_CHECK_EQUAL(AOFX_PrewarmShaders(desc, levels, levelCount, false), AOFX_RETURN_CODE_SUCCESS);
+
+    AOFX_ShaderStats stats = shaderStats(desc);
+    AMD_TEST_CHECK(!stats.m_PrewarmPending);
+    AMD_TEST_CHECK_EQUAL(stats.m_ShadersCreated, expectedShaders);
+    AMD_TEST_CHECK_EQUAL(stats.m_ShadersCreated, initializeShaders + stats.m_ShadersCreatedByRender + stats.m_ShadersPrewarmed);
+    AMD_TEST_CHECK_EQUAL(liveObjects(device) - objectsBefore, stats.m_ShadersCreated - initializeShaders);
+
+    AMD_TEST_CHECK_EQUAL(AOFX_ResetDeviceCounters(device.m_pContext), AOFX_RETURN_CODE_SUCCESS);
+    for (uint i = 0; i < levelCount; i++)
+    {
+        applyLevel(levels[i], desc);
+        AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+    }
+
+    AOFX_DeviceCounters counters;
+    AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(device.m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(counters.m_ObjectsCreated, 0);
+    AMD_TEST_CHECK_EQUAL(shaderStats(desc).m_ShadersCreated, stats.m_ShadersCreated);
+    AMD_TEST_CHECK_EQUAL(shaderStats(desc).m_ShadersCreatedByRender, stats.m_ShadersCreatedByRender);
+
+    AOFX_Release(desc);
+}
+
+//--------------------------------------------------------------------------------------
+// AOFX_Release stops a pending prewarm, the worker does not touch the released state and
+// every object it created is released
+//--------------------------------------------------------------------------------------
+static void testReleaseDuringPrewarm()
+{
+    static const uint levelCount = AOFX_SAMPLE_COUNT_COUNT * AOFX_BILATERAL_BLUR_RADIUS_COUNT;
+    AOFX_QualityLevel levels[levelCount];
+    shaderLadder(levels, levelCount);
+
+    for (uint repeat = 0; repeat < 8; repeat++)
+    {
+        NullDevice device(640, 360);
+        uint fixtureObjects = liveObjects(device);
+
+        AOFX_Desc desc;
+        device.bind(desc);
+        desc.m_ShaderCreation = AOFX_SHADER_CREATION_ON_DEMAND;
+        AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_PrewarmShaders(desc, levels, levelCount, true), AOFX_RETURN_CODE_SUCCESS);
+
+        AOFX_Release(desc);
+        AMD_TEST_CHECK_EQUAL(liveObjects(device), fixtureObjects);
+
+        // the released desc can be initialized again
+        AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK(!shaderStats(desc).m_PrewarmPending);
+        AMD_TEST_CHECK_EQUAL(shaderStats(desc).m_ShadersPrewarmed, 0);
+        AOFX_Release(desc);
+    }
+}
+
+static void testCounterArguments()
+{
+    NullDevice device(64, 64);
+    AOFX_DeviceCounters counters;
+
+    AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(NULL, &counters), AOFX_RETURN_CODE_INVALID_DEVICE_CONTEXT);
+    AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(device.m_pContext, NULL), AOFX_RETURN_CODE_INVALID_POINTER);
+
+    // the views created by the fixture count as device objects until the counters are reset
+    AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(device.m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(counters.m_ObjectsCreated, 3);
+    AMD_TEST_CHECK_EQUAL(AOFX_ResetDeviceCounters(device.m_pContext), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(device.m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(counters.m_ObjectsCreated, 0);
+}
+
+int main()
+{
+    testRecordedCommandsPerRender();
+    testBenchmarkCounters();
+    testCounterArguments();
+    testStateRestoreUsed();
+    testShaderCreationOnDemand();
+    testPrewarmWhileRendering();
+    testReleaseDuringPrewarm();
+
+    return AMD_TEST_RESULT();
+}
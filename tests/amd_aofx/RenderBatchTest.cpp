@@ -0,0 +1,324 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: RenderBatchTest.cpp
+//
+// Runs AOFX_CpuRenderBatch directly: worker scratch reuse, failing load and store
+// callbacks, images without an output buffer, and multi-threaded results against a
+// single-threaded run.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "AMD_AOFX_CPU.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+//--------------------------------------------------------------------------------------
+// Ground plane with a box, camera space depth stored as hardware depth
+//--------------------------------------------------------------------------------------
+static void makeImage(AOFX_BatchImage & image, std::vector<float> & depth, uint width, uint height, float boxDistance)
+{
+    image.m_Camera.m_NearPlane = 0.1f;
+    image.m_Camera.m_FarPlane = 100.0f;
+    image.m_Camera.m_Fov = 1.0f;
+    image.m_Camera.m_Aspect = (float)width / height;
+
+    float n = image.m_Camera.m_NearPlane, f = image.m_Camera.m_FarPlane, q = f / (f - n);
+    float tanY = tanf(image.m_Camera.m_Fov * 0.5f), tanX = tanY * image.m_Camera.m_Aspect;
+
+    depth.resize((size_t)width * height);
+    for (uint y = 0; y < height; y++)
+    {
+        for (uint x = 0; x < width; x++)
+        {
+            float rayX = ((x + 0.5f) * 2.0f / width - 1.0f) * tanX;
+            float rayY = -((y + 0.5f) * 2.0f / height - 1.0f) * tanY;
+            float z = 8.0f;
+            if (rayY < 0.0f) z = std::min(z, -1.0f / rayY);
+            if (fabsf(rayX * boxDistance) < 0.5f && rayY * boxDistance > -1.0f && rayY * boxDistance < 0.0f) z = std::min(z, boxDistance);
+            depth[y * width + x] = q - q * n / z;
+        }
+    }
+
+    image.m_pDepth = &depth[0];
+    image.m_Size.x = width;
+    image.m_Size.y = height;
+}
+
+// one layer with random taps and a blur, so the shared sample pattern table and every stage are used
+static void setupDesc(AOFX_Desc & desc)
+{
+    desc.m_LayerProcess[1] = AOFX_LAYER_PROCESS_NONE;
+    desc.m_LayerProcess[2] = AOFX_LAYER_PROCESS_NONE;
+    desc.m_TapType[0] = AOFX_TAP_TYPE_RANDOM_CB;
+    desc.m_SampleCount[0] = AOFX_SAMPLE_COUNT_MEDIUM;
+    desc.m_BilateralBlurRadius[0] = AOFX_BILATERAL_BLUR_RADIUS_4;
+}
+
+struct BatchRecord
+{
+    std::mutex                    m_Mutex;
+    std::vector<std::vector<float> > m_Stored;
+    std::vector<AOFX_RETURN_CODE> m_Results;
+    std::vector<int>              m_StoreCalls;
+    uint                          m_FailLoad;
+    uint                          m_FailStore;
+
+    BatchRecord(uint count) : m_Stored(count), m_Results(count, AOFX_RETURN_CODE_SUCCESS), m_StoreCalls(count, 0), m_FailLoad(~0u), m_FailStore(~0u) {}
+};
+
+static bool loadImage(AOFX_BatchImage & image, uint index, void * pUserData)
+{
+    BatchRecord & record = *(BatchRecord *)pUserData;
+    return index != record.m_FailLoad;
+}
+
+// copies the result out, m_pOutput may be worker scratch memory that is only valid during the call
+static bool storeImage(const AOFX_BatchImage & image, uint index, AOFX_RETURN_CODE result, void * pUserData)
+{
+    BatchRecord & record = *(BatchRecord *)pUserData;
+    std::lock_guard<std::mutex> lock(record.m_Mutex);
+
+    record.m_StoreCalls[index]++;
+    record.m_Results[index] = result;
+    if (result == AOFX_RETURN_CODE_SUCCESS && image.m_pOutput != NULL)
+        record.m_Stored[index].assign(image.m_pOutput, image.m_pOutput + (size_t)image.m_Size.x * image.m_Size.y);
+
+    return index != record.m_FailStore;
+}
+
+//--------------------------------------------------------------------------------------
+// A worker reallocates its scratch surfaces only when the image size changes
+//--------------------------------------------------------------------------------------
+static void testScratchReuse()
+{
+    AOFX_Desc desc;
+    setupDesc(desc);
+
+    std::vector<float> depth[3];
+    std::vector<float> output[6];
+    AOFX_BatchImage sizes[3];
+    makeImage(sizes[0], depth[0], 64, 48, 3.0f);
+    makeImage(sizes[1], depth[1], 64, 48, 5.0f);
+    makeImage(sizes[2], depth[2], 40, 30, 3.0f);
+
+    // one worker, so the images are processed in order: A A B B A A
+    static const uint order[] = { 0, 1, 2, 2, 0, 1 };
+    AOFX_BatchImage images[6];
+    for (uint i = 0; i < 6; i++)
+    {
+        images[i] = sizes[order[i]];
+        output[i].resize((size_t)images[i].m_Size.x * images[i].m_Size.y);
+        images[i].m_pOutput = &output[i][0];
+    }
+
+    AOFX_BatchDesc batch;
+    batch.m_pImages = images;
+    batch.m_ImageCount = 2;
+    batch.m_ThreadCount = 1;
+
+    // the full resolution surfaces and the layer surfaces are allocated once per size
+    AOFX_BatchStats stats;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, 2);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesFailed, 0);
+    AMD_TEST_CHECK_EQUAL(stats.m_ThreadCount, 1);
+    AMD_TEST_CHECK_EQUAL(stats.m_ScratchAllocations, 2);
+
+    batch.m_ImageCount = 6;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, 6);
+    AMD_TEST_CHECK_EQUAL(stats.m_ScratchAllocations, 6);
+
+    // reusing the scratch surfaces of an earlier size leaves nothing behind
+    AMD_TEST_CHECK(output[0] == output[4]);
+    AMD_TEST_CHECK(output[1] == output[5]);
+    AMD_TEST_CHECK(output[2] == output[3]);
+    AMD_TEST_CHECK(output[0] != output[1]);
+
+    // the thread count is clamped to the image count
+    batch.m_ImageCount = 2;
+    batch.m_ThreadCount = 8;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(stats.m_ThreadCount, 2);
+}
+
+//--------------------------------------------------------------------------------------
+// A failing callback fails its own image only, store still sees the images that failed
+//--------------------------------------------------------------------------------------
+static void testFailingCallbacks()
+{
+    AOFX_Desc desc;
+    setupDesc(desc);
+    const uint count = 5;
+
+    std::vector<float> depth[count];
+    AOFX_BatchImage images[count];
+    for (uint i = 0; i < count; i++)
+        makeImage(images[i], depth[i], 32, 24, 2.0f + i);
+
+    BatchRecord record(count);
+    record.m_FailLoad = 1;
+    record.m_FailStore = 3;
+
+    AOFX_BatchDesc batch;
+    batch.m_pImages = images;
+    batch.m_ImageCount = count;
+    batch.m_ThreadCount = 2;
+    batch.m_pLoad = loadImage;
+    batch.m_pStore = storeImage;
+    batch.m_pUserData = &record;
+
+    AOFX_BatchStats stats;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_FAIL);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, count - 2);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesFailed, 2);
+
+    for (uint i = 0; i < count; i++)
+    {
+        AMD_TEST_CHECK_EQUAL(record.m_StoreCalls[i], 1);
+        AMD_TEST_CHECK_EQUAL(record.m_Results[i], i == record.m_FailLoad ? AOFX_RETURN_CODE_FAIL : AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(record.m_Stored[i].size(), i == record.m_FailLoad ? 0 : 32 * 24);
+    }
+
+    // without a load callback a NULL depth pointer fails in the worker
+    images[2].m_pDepth = NULL;
+    BatchRecord storeOnly(count);
+    batch.m_pLoad = NULL;
+    batch.m_pUserData = &storeOnly;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_FAIL);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, count - 1);
+    AMD_TEST_CHECK_EQUAL(storeOnly.m_Results[2], AOFX_RETURN_CODE_INVALID_POINTER);
+}
+
+//--------------------------------------------------------------------------------------
+// Without m_pOutput the result is only handed to the store callback, in worker scratch memory
+//--------------------------------------------------------------------------------------
+static void testNullOutput()
+{
+    AOFX_Desc desc;
+    setupDesc(desc);
+    const uint count = 3;
+
+    std::vector<float> depth[count];
+    std::vector<float> output[count];
+    AOFX_BatchImage images[count];
+    for (uint i = 0; i < count; i++)
+        makeImage(images[i], depth[i], 48, 32, 2.5f + i);
+
+    // no output and no store callback: nowhere to put the result
+    AOFX_BatchDesc batch;
+    batch.m_pImages = images;
+    batch.m_ImageCount = count;
+    batch.m_ThreadCount = 1;
+
+    AOFX_BatchStats stats;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_FAIL);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, 0);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesFailed, count);
+
+    BatchRecord record(count);
+    batch.m_pStore = storeImage;
+    batch.m_pUserData = &record;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, count);
+
+    // the images themselves are not modified, the same batch with output buffers gives the stored values
+    for (uint i = 0; i < count; i++)
+    {
+        AMD_TEST_CHECK(images[i].m_pOutput == NULL);
+        output[i].resize(48 * 32);
+        images[i].m_pOutput = &output[i][0];
+    }
+    batch.m_pStore = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_SUCCESS);
+    for (uint i = 0; i < count; i++)
+        AMD_TEST_CHECK(record.m_Stored[i] == output[i]);
+}
+
+//--------------------------------------------------------------------------------------
+// Workers share the sample pattern table and nothing else, so results do not depend on
+// the thread count. The table does not touch the C runtime generator of the application
+//--------------------------------------------------------------------------------------
+static void testThreadCountInvariance()
+{
+    AOFX_Desc desc;
+    setupDesc(desc);
+    const uint count = 12;
+
+    std::vector<float> depth[count];
+    std::vector<float> single[count], multi[count];
+    AOFX_BatchImage images[count];
+    for (uint i = 0; i < count; i++)
+    {
+        makeImage(images[i], depth[i], 32 + 8 * (i % 3), 24 + 4 * (i % 2), 2.0f + 0.5f * i);
+        single[i].resize((size_t)images[i].m_Size.x * images[i].m_Size.y);
+        multi[i].resize(single[i].size());
+    }
+
+    AOFX_BatchDesc batch;
+    batch.m_pImages = images;
+    batch.m_ImageCount = count;
+
+    srand(1234);
+    int expected = rand();
+
+    for (uint i = 0; i < count; i++) images[i].m_pOutput = &single[i][0];
+    batch.m_ThreadCount = 1;
+    srand(1234);
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, NULL), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(rand(), expected);
+
+    for (uint i = 0; i < count; i++) images[i].m_pOutput = &multi[i][0];
+    batch.m_ThreadCount = 4;
+    AOFX_BatchStats stats;
+    AMD_TEST_CHECK_EQUAL(AOFX_CpuRenderBatch(desc, batch, &stats), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(stats.m_ThreadCount, 4);
+    AMD_TEST_CHECK_EQUAL(stats.m_ImagesProcessed, count);
+
+    for (uint i = 0; i < count; i++)
+        AMD_TEST_CHECK(memcmp(&single[i][0], &multi[i][0], single[i].size() * sizeof(float)) == 0);
+
+    // and the result is not trivially white
+    float minimum = 1.0f;
+    for (size_t i = 0; i < single[0].size(); i++) minimum = std::min(minimum, single[0][i]);
+    AMD_TEST_CHECK(minimum < 0.95f);
+}
+
+int main()
+{
+    testScratchReuse();
+    testFailingCallbacks();
+    testNullOutput();
+    testThreadCountInvariance();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ViewportScaleTest.cpp
+//
+// AOFX_Desc::m_MaxInputSize on the null device. Built against a library with
+// AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED, a sweep of input sizes within the maximum
+// creates no object and only re-uploads constants. Built against the default library
+// while the bytecode lacks the viewport constants, every entry point rejects a non zero
+// m_MaxInputSize instead of ignoring it.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cstring>
+
+#include "AMD_AOFX.h"
+#include "AMD_Test.h"
+
+// the default library follows the bytecode, see AMD_AOFX_Precompiled.h
+#include "Shaders/inc/AMD_AOFX_ShaderFeatures.inc"
+
+#ifndef AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED
+# define AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED AOFX_SHADERS_VIEWPORT_SCALE
+#endif
+
+using namespace AMD;
+
+static const uint s_MaxWidth = 1920;
+static const uint s_MaxHeight = 1080;
+
+struct ViewportFixture
+{
+    ID3D11Device *              m_pDevice;
+    ID3D11DeviceContext *       m_pContext;
+    ID3D11Texture2D *           m_pTexture;
+    ID3D11ShaderResourceView *  m_pSRV;
+    ID3D11RenderTargetView *    m_pRTV;
+    AOFX_Desc                   m_Desc;
+
+    ViewportFixture()
+        : m_pDevice(NULL), m_pContext(NULL), m_pTexture(NULL), m_pSRV(NULL), m_pRTV(NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&m_pDevice, &m_pContext), AOFX_RETURN_CODE_SUCCESS);
+
+        // the application surfaces are allocated at the maximum as well
+        D3D11_TEXTURE2D_DESC textureDesc;
+        memset(&textureDesc, 0, sizeof(textureDesc));
+        textureDesc.Width = s_MaxWidth;
+        textureDesc.Height = s_MaxHeight;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        textureDesc.SampleDesc.Count = 1;
+        m_pDevice->CreateTexture2D(&textureDesc, NULL, &m_pTexture);
+        m_pDevice->CreateShaderResourceView(m_pTexture, NULL, &m_pSRV);
+        m_pDevice->CreateRenderTargetView(m_pTexture, NULL, &m_pRTV);
+
+        m_Desc.m_pDevice = m_pDevice;
+        m_Desc.m_pDeviceContext = m_pContext;
+        m_Desc.m_pDepthSRV = m_pSRV;
+        m_Desc.m_pOutputRTV = m_pRTV;
+        m_Desc.m_InputSize.x = 1280;
+        m_Desc.m_InputSize.y = 720;
+    }
+
+    ~ViewportFixture()
+    {
+        AOFX_Release(m_Desc);
+        m_pRTV->Release();
+        m_pSRV->Release();
+        m_pTexture->Release();
+        m_pContext->Release();
+        m_pDevice->Release();
+    }
+
+    // resizes to and renders every size of the sweep, returns the objects created on the way
+    uint sweep()
+    {
+        static const uint sizes[][2] =
+        {
+            { 1280, 720 }, { 1152, 648 }, { 1024, 576 }, { 960, 540 }, { 1600, 900 }, { 1920, 1080 },
+            { 1917, 1079 }, { 1366, 768 }, { 853, 480 }, { 640, 360 }, { 1, 1 }, { 1920, 1 }, { 1, 1080 },
+        };
+
+        AMD_TEST_CHECK_EQUAL(AOFX_ResetDeviceCounters(m_pContext), AOFX_RETURN_CODE_SUCCESS);
+        for (uint i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        {
+            m_Desc.m_InputSize.x = sizes[i][0];
+            m_Desc.m_InputSize.y = sizes[i][1];
+            AMD_TEST_CHECK_EQUAL(AOFX_Resize(m_Desc), AOFX_RETURN_CODE_SUCCESS);
+            AMD_TEST_CHECK_EQUAL(AOFX_Render(m_Desc), AOFX_RETURN_CODE_SUCCESS);
+        }
+
+        AOFX_DeviceCounters counters;
+        AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+        return counters.m_ObjectsCreated;
+    }
+};
+
+#if AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED
+
+static void testNoReallocationWithinMaximum()
+{
+    for (uint blur = 0; blur < 2; blur++)
+    {
+        ViewportFixture fixture;
+        AOFX_Desc & desc = fixture.m_Desc;
+        desc.m_MaxInputSize.x = s_MaxWidth;
+        desc.m_MaxInputSize.y = s_MaxHeight;
+        desc.m_MultiResLayerScale[1] = 0.75f;
+        desc.m_BilateralBlurRadius[0] = blur ? AOFX_BILATERAL_BLUR_RADIUS_4 : AOFX_BILATERAL_BLUR_RADIUS_NONE;
+        desc.m_BilateralBlurRadius[1] = blur ? AOFX_BILATERAL_BLUR_RADIUS_8 : AOFX_BILATERAL_BLUR_RADIUS_NONE;
+        AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+
+        AMD_TEST_CHECK_EQUAL(fixture.sweep(), 0);
+
+        // a size change only changes constants: the bilateral dilate buffer AOFX_Resize fills and one ring upload
+        AMD_TEST_CHECK_EQUAL(AOFX_ResetDeviceCounters(fixture.m_pContext), AOFX_RETURN_CODE_SUCCESS);
+        desc.m_InputSize.x = 1280;
+        desc.m_InputSize.y = 720;
+        AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+
+        AOFX_DeviceCounters counters;
+        AMD_TEST_CHECK_EQUAL(AOFX_GetDeviceCounters(fixture.m_pContext, &counters), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK_EQUAL(counters.m_ObjectsCreated, 0);
+        AMD_TEST_CHECK_EQUAL(counters.m_Maps, 2);
+    }
+}
+
+static void testReallocationWithoutMaximum()
+{
+    ViewportFixture fixture;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(fixture.m_Desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(fixture.m_Desc), AOFX_RETURN_CODE_SUCCESS);
+
+    AMD_TEST_CHECK(fixture.sweep() > 0);
+}
+
+static void testSizesOverMaximum()
+{
+    ViewportFixture fixture;
+    AOFX_Desc & desc = fixture.m_Desc;
+    desc.m_MaxInputSize.x = 1280;
+    desc.m_MaxInputSize.y = 720;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+
+    desc.m_InputSize.x = 1281;
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+
+    // a maximum needs both dimensions
+    desc.m_InputSize.x = 1280;
+    desc.m_MaxInputSize.y = 0;
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+}
+
+#else // AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED
+
+static void testMaximumRejected()
+{
+    ViewportFixture fixture;
+    AOFX_Desc & desc = fixture.m_Desc;
+    desc.m_MaxInputSize.x = s_MaxWidth;
+    desc.m_MaxInputSize.y = s_MaxHeight;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+
+    desc.m_MaxInputSize.x = desc.m_MaxInputSize.y = 0;
+    AMD_TEST_CHECK_EQUAL(AOFX_Initialize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_SUCCESS);
+    AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+
+    desc.m_MaxInputSize.x = s_MaxWidth;
+    AMD_TEST_CHECK_EQUAL(AOFX_Resize(desc), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+    AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_INVALID_ARGUMENT);
+
+    desc.m_MaxInputSize.x = 0;
+    AMD_TEST_CHECK_EQUAL(AOFX_Render(desc), AOFX_RETURN_CODE_SUCCESS);
+}
+
+#endif // AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED
+
+int main()
+{
+#if AMD_AOFX_VIEWPORT_SCALE_PRECOMPILED
+    testNoReallocationWithinMaximum();
+    testReallocationWithoutMaximum();
+    testSizesOverMaximum();
+#else
+    testMaximumRejected();
+#endif
+
+    return AMD_TEST_RESULT();
+}
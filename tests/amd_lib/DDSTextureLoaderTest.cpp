@@ -0,0 +1,536 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: DDSTextureLoaderTest.cpp
+//
+// ParseDDSTexture on DDS files built in memory: legacy and DX10 headers, the subresource
+// table of mip chains, arrays, cube maps and volumes, packed row pitches, and the errors for
+// truncated headers and data, malformed sizes and counts that would overflow. Files are parsed
+// from exact size heap copies so reads past the end show up under a sanitizer. DDSMappedFile
+// maps a file and rejects missing and short ones.
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "DirectXTex/DDSTextureLoader.h"
+#include "AMD_Test.h"
+
+using namespace DirectX;
+
+#define TEST_FOURCC(a, b, c, d) ((uint32_t)(uint8_t)(a) | ((uint32_t)(uint8_t)(b) << 8) | ((uint32_t)(uint8_t)(c) << 16) | ((uint32_t)(uint8_t)(d) << 24))
+
+static const uint32_t s_DX10 = TEST_FOURCC('D', 'X', '1', '0');
+
+// DDS_HEADER and DDS_PIXELFORMAT as laid out in the file
+struct DdsHeader
+{
+    uint32_t    m_Size;
+    uint32_t    m_Flags;
+    uint32_t    m_Height;
+    uint32_t    m_Width;
+    uint32_t    m_PitchOrLinearSize;
+    uint32_t    m_Depth;
+    uint32_t    m_MipMapCount;
+    uint32_t    m_Reserved1[11];
+    uint32_t    m_PixelFormatSize;
+    uint32_t    m_PixelFormatFlags;
+    uint32_t    m_FourCC;
+    uint32_t    m_RGBBitCount;
+    uint32_t    m_RBitMask;
+    uint32_t    m_GBitMask;
+    uint32_t    m_BBitMask;
+    uint32_t    m_ABitMask;
+    uint32_t    m_Caps;
+    uint32_t    m_Caps2;
+    uint32_t    m_Caps3;
+    uint32_t    m_Caps4;
+    uint32_t    m_Reserved2;
+};
+
+struct DdsHeaderDX10
+{
+    uint32_t    m_Format;
+    uint32_t    m_ResourceDimension;
+    uint32_t    m_MiscFlag;
+    uint32_t    m_ArraySize;
+    uint32_t    m_MiscFlags2;
+};
+
+static const size_t s_HeaderSize = 4 + sizeof(DdsHeader);
+
+static DdsHeader header(uint32_t width, uint32_t height, uint32_t mipCount)
+{
+    DdsHeader result;
+    memset(&result, 0, sizeof(result));
+    result.m_Size = sizeof(DdsHeader);
+    result.m_Flags = 0x1007 | 0x20000;              // caps, height, width, pixel format, mip count
+    result.m_Width = width;
+    result.m_Height = height;
+    result.m_MipMapCount = mipCount;
+    result.m_PixelFormatSize = 32;
+    return result;
+}
+
+static DdsHeader fourCCHeader(uint32_t width, uint32_t height, uint32_t mipCount, uint32_t fourCC)
+{
+    DdsHeader result = header(width, height, mipCount);
+    result.m_PixelFormatFlags = 0x4;
+    result.m_FourCC = fourCC;
+    return result;
+}
+
+static DdsHeader rgbaHeader(uint32_t width, uint32_t height, uint32_t mipCount)
+{
+    DdsHeader result = header(width, height, mipCount);
+    result.m_PixelFormatFlags = 0x41;
+    result.m_RGBBitCount = 32;
+    result.m_RBitMask = 0x000000FF;
+    result.m_GBitMask = 0x0000FF00;
+    result.m_BBitMask = 0x00FF0000;
+    result.m_ABitMask = 0xFF000000;
+    return result;
+}
+
+static DdsHeaderDX10 dx10Header(DXGI_FORMAT format, D3D11_RESOURCE_DIMENSION dimension, uint32_t arraySize, uint32_t miscFlag = 0, uint32_t alphaMode = 0)
+{
+    DdsHeaderDX10 result = { (uint32_t)format, (uint32_t)dimension, miscFlag, arraySize, alphaMode };
+    return result;
+}
+
+// Magic, headers and dataSize bytes of pixel data
+static std::vector<uint8_t> makeFile(const DdsHeader & ddsHeader, const DdsHeaderDX10 * pDX10Header, size_t dataSize)
+{
+    const size_t headerSize = s_HeaderSize + (pDX10Header ? sizeof(DdsHeaderDX10) : 0);
+    std::vector<uint8_t> file(headerSize + dataSize);
+
+    const uint32_t magic = TEST_FOURCC('D', 'D', 'S', ' ');
+    memcpy(&file[0], &magic, sizeof(magic));
+    memcpy(&file[4], &ddsHeader, sizeof(ddsHeader));
+    if (pDX10Header)
+        memcpy(&file[s_HeaderSize], pDX10Header, sizeof(*pDX10Header));
+
+    for (size_t i = headerSize; i < file.size(); i++)
+        file[i] = (uint8_t)(i * 31);
+
+    return file;
+}
+
+static DdsHeader & fileHeader(std::vector<uint8_t> & file)
+{
+    return *(DdsHeader *)&file[4];
+}
+
+// Parses an exact size copy, with and without the subresource table
+static HRESULT parse(const std::vector<uint8_t> & file, DDS_TEXTURE_INFO & info, std::vector<DDS_SUBRESOURCE> & subresources)
+{
+    uint8_t * pData = (uint8_t *)malloc(file.empty() ? 1 : file.size());
+    if (!file.empty())
+        memcpy(pData, &file[0], file.size());
+
+    HRESULT hr = ParseDDSTexture(pData, file.size(), &info);
+    subresources.clear();
+    if (SUCCEEDED(hr))
+    {
+        subresources.resize(info.subresourceCount);
+        AMD_TEST_CHECK_EQUAL(ParseDDSTexture(pData, file.size(), &info, &subresources[0], subresources.size()), hr);
+    }
+
+    free(pData);
+    return hr;
+}
+
+// Subresources follow one another in D3D11CalcSubresource order and end where the data ends
+static void checkLayout(const DDS_TEXTURE_INFO & info, const std::vector<DDS_SUBRESOURCE> & subresources, size_t dataEnd)
+{
+    AMD_TEST_CHECK_EQUAL(subresources.size(), (size_t)info.mipLevels * info.arraySize);
+
+    size_t offset = info.dataOffset;
+    for (size_t i = 0; i < subresources.size(); i++)
+    {
+        const DDS_SUBRESOURCE & subresource = subresources[i];
+        AMD_TEST_CHECK_EQUAL(subresource.offset, offset);
+        AMD_TEST_CHECK_EQUAL(subresource.mipLevel, i % info.mipLevels);
+        AMD_TEST_CHECK_EQUAL(subresource.arraySlice, i / info.mipLevels);
+        AMD_TEST_CHECK_EQUAL(subresource.width, std::max<uint32_t>(info.width >> subresource.mipLevel, 1));
+        AMD_TEST_CHECK_EQUAL(subresource.height, std::max<uint32_t>(info.height >> subresource.mipLevel, 1));
+        AMD_TEST_CHECK_EQUAL(subresource.depth, std::max<uint32_t>(info.depth >> subresource.mipLevel, 1));
+        AMD_TEST_CHECK_EQUAL(subresource.size, subresource.slicePitch * subresource.depth);
+        offset += subresource.size;
+    }
+    AMD_TEST_CHECK_EQUAL(offset, dataEnd);
+}
+
+static size_t blockSurfaceSize(uint32_t width, uint32_t height, uint32_t mipCount, size_t blockBytes)
+{
+    size_t size = 0;
+    for (uint32_t mip = 0; mip < mipCount; mip++)
+    {
+        size_t blocksWide = std::max<size_t>(1, ((width >> mip) + 3) / 4);
+        size_t blocksHigh = std::max<size_t>(1, ((height >> mip) + 3) / 4);
+        size += blocksWide * blocksHigh * blockBytes;
+    }
+    return size;
+}
+
+static void testLegacyMipChain()
+{
+    DDS_TEXTURE_INFO info;
+    std::vector<DDS_SUBRESOURCE> subresources;
+
+    // BC1 256x256, the full chain down to a single block
+    std::vector<uint8_t> file = makeFile(fourCCHeader(256, 256, 9, TEST_FOURCC('D', 'X', 'T', '1')), NULL, blockSurfaceSize(256, 256, 9, 8));
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK_EQUAL(info.resourceDimension, D3D11_RESOURCE_DIMENSION_TEXTURE2D);
+    AMD_TEST_CHECK_EQUAL(info.format, DXGI_FORMAT_BC1_UNORM);
+    AMD_TEST_CHECK_EQUAL(info.mipLevels, 9);
+    AMD_TEST_CHECK_EQUAL(info.arraySize, 1);
+    AMD_TEST_CHECK(!info.isCubeMap);
+    AMD_TEST_CHECK_EQUAL(info.dataOffset, s_HeaderSize);
+    if (subresources.size() == 9)
+    {
+        AMD_TEST_CHECK_EQUAL(subresources[0].rowPitch, 64 * 8);
+        AMD_TEST_CHECK_EQUAL(subresources[0].slicePitch, 64 * 64 * 8);
+        AMD_TEST_CHECK_EQUAL(subresources[7].rowPitch, 8);     // 2x2 still takes a whole block
+        AMD_TEST_CHECK_EQUAL(subresources[8].size, 8);
+    }
+    checkLayout(info, subresources, file.size());
+
+    // a table one entry short is not written to
+    std::vector<DDS_SUBRESOURCE> table(9);
+    memset(&table[0], 0xCD, table.size() * sizeof(table[0]));
+    AMD_TEST_CHECK_EQUAL(ParseDDSTexture(&file[0], file.size(), &info, &table[0], 8), HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER));
+    AMD_TEST_CHECK_EQUAL(info.subresourceCount, 9);
+    AMD_TEST_CHECK_EQUAL(table[0].offset, (size_t)0xCDCDCDCDCDCDCDCDull);
+
+    // DXT4 is premultiplied BC3, a mip count of 0 means a single level
+    file = makeFile(fourCCHeader(4, 4, 0, TEST_FOURCC('D', 'X', 'T', '4')), NULL, 16);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK_EQUAL(info.format, DXGI_FORMAT_BC3_UNORM);
+    AMD_TEST_CHECK_EQUAL(info.alphaMode, DDS_ALPHA_MODE_PREMULTIPLIED);
+    AMD_TEST_CHECK_EQUAL(info.mipLevels, 1);
+    checkLayout(info, subresources, file.size());
+
+    // odd sizes round down per level, RGBA rows are packed
+    file = makeFile(rgbaHeader(13, 5, 4), NULL, (13 * 5 + 6 * 2 + 3 * 1 + 1 * 1) * 4);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK_EQUAL(info.format, DXGI_FORMAT_R8G8B8A8_UNORM);
+    if (subresources.size() == 4)
+    {
+        AMD_TEST_CHECK_EQUAL(subresources[0].rowPitch, 13 * 4);
+        AMD_TEST_CHECK_EQUAL(subresources[1].rowPitch, 6 * 4);
+        AMD_TEST_CHECK_EQUAL(subresources[3].slicePitch, 4);
+    }
+    checkLayout(info, subresources, file.size());
+}
+
+static void testDX10Headers()
+{
+    DDS_TEXTURE_INFO info;
+    std::vector<DDS_SUBRESOURCE> subresources;
+
+    // BC7 array of 3 with 4 mips each, premultiplied alpha
+    const size_t itemSize = blockSurfaceSize(64, 64, 4, 16);
+    DdsHeaderDX10 dx10 = dx10Header(DXGI_FORMAT_BC7_UNORM_SRGB, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 3, 0, DDS_ALPHA_MODE_PREMULTIPLIED);
+    std::vector<uint8_t> file = makeFile(fourCCHeader(64, 64, 4, s_DX10), &dx10, itemSize * 3);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK_EQUAL(info.format, DXGI_FORMAT_BC7_UNORM_SRGB);
+    AMD_TEST_CHECK_EQUAL(info.arraySize, 3);
+    AMD_TEST_CHECK_EQUAL(info.dataOffset, s_HeaderSize + sizeof(DdsHeaderDX10));
+    AMD_TEST_CHECK_EQUAL(info.alphaMode, DDS_ALPHA_MODE_PREMULTIPLIED);
+    if (subresources.size() == 12)
+    {
+        // the second item starts after every mip of the first
+        AMD_TEST_CHECK_EQUAL(subresources[4].arraySlice, 1);
+        AMD_TEST_CHECK_EQUAL(subresources[4].mipLevel, 0);
+        AMD_TEST_CHECK_EQUAL(subresources[4].offset, info.dataOffset + itemSize);
+        AMD_TEST_CHECK_EQUAL(subresources[11].offset, file.size() - 2 * 2 * 16);
+    }
+    checkLayout(info, subresources, file.size());
+
+    // 1D array, the height is ignored
+    dx10 = dx10Header(DXGI_FORMAT_R32_FLOAT, D3D11_RESOURCE_DIMENSION_TEXTURE1D, 2, 0, DDS_ALPHA_MODE_OPAQUE);
+    file = makeFile(fourCCHeader(32, 1, 6, s_DX10), &dx10, (32 + 16 + 8 + 4 + 2 + 1) * 4 * 2);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK_EQUAL(info.resourceDimension, D3D11_RESOURCE_DIMENSION_TEXTURE1D);
+    AMD_TEST_CHECK_EQUAL(info.height, 1);
+    AMD_TEST_CHECK_EQUAL(info.alphaMode, DDS_ALPHA_MODE_OPAQUE);
+    checkLayout(info, subresources, file.size());
+
+    // volume of half floats, not a power of two
+    DdsHeader volume = fourCCHeader(5, 3, 3, s_DX10);
+    volume.m_Flags |= 0x800000;
+    volume.m_Depth = 7;
+    dx10 = dx10Header(DXGI_FORMAT_R16G16B16A16_FLOAT, D3D11_RESOURCE_DIMENSION_TEXTURE3D, 1);
+    file = makeFile(volume, &dx10, (5 * 3 * 7 + 2 * 1 * 3 + 1 * 1 * 1) * 8);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK_EQUAL(info.resourceDimension, D3D11_RESOURCE_DIMENSION_TEXTURE3D);
+    AMD_TEST_CHECK_EQUAL(info.depth, 7);
+    checkLayout(info, subresources, file.size());
+
+    // planar video: the chroma rows follow the luma rows of the same subresource
+    dx10 = dx10Header(DXGI_FORMAT_NV12, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 1);
+    file = makeFile(fourCCHeader(6, 4, 1, s_DX10), &dx10, 6 * 4 + 6 * 2);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    checkLayout(info, subresources, file.size());
+
+    // formats and dimensions a DX10 header can't have
+    dx10 = dx10Header(DXGI_FORMAT_UNKNOWN, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 1);
+    AMD_TEST_CHECK(FAILED(parse(makeFile(fourCCHeader(4, 4, 1, s_DX10), &dx10, 64), info, subresources)));
+    dx10 = dx10Header(DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_RESOURCE_DIMENSION_BUFFER, 1);
+    AMD_TEST_CHECK(FAILED(parse(makeFile(fourCCHeader(4, 4, 1, s_DX10), &dx10, 64), info, subresources)));
+    dx10 = dx10Header(DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 0);
+    AMD_TEST_CHECK_EQUAL(parse(makeFile(fourCCHeader(4, 4, 1, s_DX10), &dx10, 64), info, subresources), HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+}
+
+static void testCubeMaps()
+{
+    DDS_TEXTURE_INFO info;
+    std::vector<DDS_SUBRESOURCE> subresources;
+
+    // legacy RGBA cube, all six faces with 5 mips
+    size_t faceSize = 0;
+    for (uint32_t mip = 0; mip < 5; mip++)
+        faceSize += (size_t)(16 >> mip) * (16 >> mip) * 4;
+    DdsHeader cube = rgbaHeader(16, 16, 5);
+    cube.m_Caps2 = 0xFE00;
+    std::vector<uint8_t> file = makeFile(cube, NULL, faceSize * 6);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK(info.isCubeMap);
+    AMD_TEST_CHECK_EQUAL(info.arraySize, 6);
+    if (subresources.size() == 30)
+    {
+        AMD_TEST_CHECK_EQUAL(subresources[0].rowPitch, 64);
+        AMD_TEST_CHECK_EQUAL(subresources[5].arraySlice, 1);
+        AMD_TEST_CHECK_EQUAL(subresources[25].offset, info.dataOffset + faceSize * 5);
+    }
+    checkLayout(info, subresources, file.size());
+
+    // a cube with faces missing
+    cube.m_Caps2 = 0x0600;
+    AMD_TEST_CHECK_EQUAL(parse(makeFile(cube, NULL, faceSize * 6), info, subresources), HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+
+    // DX10 array of two BC3 cubes
+    DdsHeaderDX10 dx10 = dx10Header(DXGI_FORMAT_BC3_UNORM, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 2, D3D11_RESOURCE_MISC_TEXTURECUBE);
+    file = makeFile(fourCCHeader(8, 8, 1, s_DX10), &dx10, 4 * 16 * 12);
+    AMD_TEST_CHECK_EQUAL(parse(file, info, subresources), S_OK);
+    AMD_TEST_CHECK(info.isCubeMap);
+    AMD_TEST_CHECK_EQUAL(info.arraySize, 12);
+    checkLayout(info, subresources, file.size());
+
+    // a cube count whose face count wraps around 32 bits
+    dx10.m_ArraySize = 0x2AAAAAAB;
+    AMD_TEST_CHECK_EQUAL(parse(makeFile(fourCCHeader(8, 8, 1, s_DX10), &dx10, 64), info, subresources), HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED));
+}
+
+static void testTruncation()
+{
+    DDS_TEXTURE_INFO info;
+    std::vector<DDS_SUBRESOURCE> subresources;
+
+    const std::vector<uint8_t> legacy = makeFile(fourCCHeader(64, 64, 7, TEST_FOURCC('D', 'X', 'T', '5')), NULL, blockSurfaceSize(64, 64, 7, 16));
+    DdsHeaderDX10 dx10 = dx10Header(DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 2);
+    const std::vector<uint8_t> extended = makeFile(fourCCHeader(8, 8, 4, s_DX10), &dx10, (64 + 16 + 4 + 1) * 4 * 2);
+    AMD_TEST_CHECK_EQUAL(parse(legacy, info, subresources), S_OK);
+    AMD_TEST_CHECK_EQUAL(parse(extended, info, subresources), S_OK);
+
+    // every length short of the whole file: headers cut off fail to parse, data cut off runs into the end
+    uint headerFailures = 0, dataFailures = 0, accepted = 0;
+    for (size_t size = 0; size < extended.size(); size++)
+    {
+        const HRESULT expected = size < extended.size() - (64 + 16 + 4 + 1) * 4 * 2 ? E_FAIL : HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        const HRESULT hr = parse(std::vector<uint8_t>(extended.begin(), extended.begin() + size), info, subresources);
+        accepted += SUCCEEDED(hr) ? 1 : 0;
+        headerFailures += (hr == E_FAIL) ? 1 : 0;
+        dataFailures += (hr == HRESULT_FROM_WIN32(ERROR_HANDLE_EOF)) ? 1 : 0;
+        AMD_TEST_CHECK_EQUAL(hr, expected);
+    }
+    AMD_TEST_CHECK_EQUAL(accepted, 0);
+    AMD_TEST_CHECK_EQUAL(headerFailures, s_HeaderSize + sizeof(DdsHeaderDX10));
+
+    for (size_t size = 0; size < legacy.size(); size += (size < 2 * s_HeaderSize) ? 1 : 61)
+    {
+        const HRESULT hr = parse(std::vector<uint8_t>(legacy.begin(), legacy.begin() + size), info, subresources);
+        AMD_TEST_CHECK_EQUAL(hr, size < s_HeaderSize ? E_FAIL : HRESULT_FROM_WIN32(ERROR_HANDLE_EOF));
+    }
+
+    // a DX10 four character code without the extension header after it
+    AMD_TEST_CHECK_EQUAL(parse(makeFile(fourCCHeader(4, 4, 1, s_DX10), NULL, sizeof(DdsHeaderDX10) - 1), info, subresources), E_FAIL);
+
+    // no data at all
+    AMD_TEST_CHECK_EQUAL(ParseDDSTexture(NULL, 0, &info), E_INVALIDARG);
+    AMD_TEST_CHECK_EQUAL(ParseDDSTexture(&legacy[0], legacy.size(), NULL), E_INVALIDARG);
+}
+
+static void testMalformedHeaders()
+{
+    DDS_TEXTURE_INFO info;
+    std::vector<DDS_SUBRESOURCE> subresources;
+    const std::vector<uint8_t> file = makeFile(fourCCHeader(256, 256, 9, TEST_FOURCC('D', 'X', 'T', '1')), NULL, blockSurfaceSize(256, 256, 9, 8));
+
+    // magic and structure sizes
+    std::vector<uint8_t> bad = file;
+    bad[0] = 'X';
+    AMD_TEST_CHECK_EQUAL(parse(bad, info, subresources), E_FAIL);
+    bad = file;
+    fileHeader(bad).m_Size = 128;
+    AMD_TEST_CHECK_EQUAL(parse(bad, info, subresources), E_FAIL);
+    bad = file;
+    fileHeader(bad).m_PixelFormatSize = 0;
+    AMD_TEST_CHECK_EQUAL(parse(bad, info, subresources), E_FAIL);
+
+    // dimensions and mip counts
+    bad = file;
+    fileHeader(bad).m_Width = 0;
+    AMD_TEST_CHECK_EQUAL(parse(bad, info, subresources), HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+    bad = file;
+    fileHeader(bad).m_Height = 0;
+    AMD_TEST_CHECK_EQUAL(parse(bad, info, subresources), HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+    bad = file;
+    fileHeader(bad).m_MipMapCount = 10;
+    AMD_TEST_CHECK_EQUAL(parse(bad, info, subresources), HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+    bad = file;
+    fileHeader(bad).m_FourCC = TEST_FOURCC('A', 'B', 'C', 'D');
+    AMD_TEST_CHECK(FAILED(parse(bad, info, subresources)));
+
+    // a volume without depth
+    DdsHeader volume = rgbaHeader(8, 8, 1);
+    volume.m_Flags |= 0x800000;
+    AMD_TEST_CHECK_EQUAL(parse(makeFile(volume, NULL, 8 * 8 * 4), info, subresources), HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+
+    // sizes whose byte counts don't fit, rejected before anything is read or allocated
+    DdsHeaderDX10 dx10 = dx10Header(DXGI_FORMAT_R32G32B32A32_FLOAT, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 2048);
+    AMD_TEST_CHECK_EQUAL(parse(makeFile(fourCCHeader(16384, 16384, 15, s_DX10), &dx10, 64), info, subresources), HRESULT_FROM_WIN32(ERROR_ARITHMETIC_OVERFLOW));
+    dx10 = dx10Header(DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 0xFFFFFFFF);
+    AMD_TEST_CHECK(FAILED(parse(makeFile(fourCCHeader(1, 1, 1, s_DX10), &dx10, 64), info, subresources)));
+}
+
+// Random edits to the headers of valid files: whatever parses stays inside the file
+static void testRandomHeaders()
+{
+    std::vector< std::vector<uint8_t> > corpus;
+    corpus.push_back(makeFile(fourCCHeader(64, 32, 7, TEST_FOURCC('D', 'X', 'T', '1')), NULL, blockSurfaceSize(64, 32, 7, 8)));
+    DdsHeader cube = rgbaHeader(8, 8, 4);
+    cube.m_Caps2 = 0xFE00;
+    corpus.push_back(makeFile(cube, NULL, (64 + 16 + 4 + 1) * 4 * 6));
+    DdsHeaderDX10 dx10 = dx10Header(DXGI_FORMAT_BC7_UNORM, D3D11_RESOURCE_DIMENSION_TEXTURE2D, 3);
+    corpus.push_back(makeFile(fourCCHeader(16, 16, 3, s_DX10), &dx10, blockSurfaceSize(16, 16, 3, 16) * 3));
+    DdsHeader volume = fourCCHeader(5, 3, 3, s_DX10);
+    volume.m_Flags |= 0x800000;
+    volume.m_Depth = 7;
+    dx10 = dx10Header(DXGI_FORMAT_R16G16B16A16_FLOAT, D3D11_RESOURCE_DIMENSION_TEXTURE3D, 1);
+    corpus.push_back(makeFile(volume, &dx10, (5 * 3 * 7 + 2 * 1 * 3 + 1 * 1 * 1) * 8));
+
+    std::mt19937 random(20160913);
+    DDS_TEXTURE_INFO info;
+    std::vector<DDS_SUBRESOURCE> subresources;
+    uint parsed = 0;
+    for (uint i = 0; i < 20000; i++)
+    {
+        std::vector<uint8_t> file = corpus[random() % corpus.size()];
+        for (uint edit = 0; edit <= random() % 4; edit++)
+        {
+            const size_t position = random() % std::min<size_t>(file.size(), s_HeaderSize + sizeof(DdsHeaderDX10));
+            switch (random() % 4)
+            {
+            case 0: file[position] ^= (uint8_t)(1 << (random() % 8)); break;
+            case 1: file[position] = (uint8_t)random(); break;
+            case 2:
+                {
+                    // small counts and sizes are the interesting ones
+                    const uint32_t value = (random() % 3) ? random() % 40 : (uint32_t)random();
+                    if ((position & ~3u) + 4 <= file.size())
+                        memcpy(&file[position & ~3u], &value, sizeof(value));
+                }
+                break;
+            default: file.resize(std::max<size_t>(1, random() % (file.size() + 1))); break;
+            }
+        }
+
+        if (FAILED(parse(file, info, subresources)))
+            continue;
+
+        parsed++;
+        AMD_TEST_CHECK(!subresources.empty());
+        if (!subresources.empty())
+        {
+            checkLayout(info, subresources, subresources.back().offset + subresources.back().size);
+            AMD_TEST_CHECK(subresources.back().offset + subresources.back().size <= file.size());
+        }
+    }
+    AMD_TEST_CHECK(parsed > 0);
+}
+
+static void testMappedFile()
+{
+    const std::vector<uint8_t> file = makeFile(fourCCHeader(16, 16, 5, TEST_FOURCC('D', 'X', 'T', '1')), NULL, blockSurfaceSize(16, 16, 5, 8));
+
+    FILE * pFile = fopen("DDSTextureLoaderTest.dds", "wb");
+    AMD_TEST_CHECK(pFile != NULL);
+    if (pFile == NULL)
+        return;
+    fwrite(&file[0], 1, file.size(), pFile);
+    fclose(pFile);
+
+    DDSMappedFile mapped;
+    AMD_TEST_CHECK_EQUAL(mapped.Open(L"DDSTextureLoaderTest.dds"), S_OK);
+    AMD_TEST_CHECK_EQUAL(mapped.GetSize(), file.size());
+    AMD_TEST_CHECK(mapped.GetData() != NULL && memcmp(mapped.GetData(), &file[0], file.size()) == 0);
+
+    DDS_TEXTURE_INFO info;
+    AMD_TEST_CHECK(mapped.GetData() != NULL && ParseDDSTexture(mapped.GetData(), mapped.GetSize(), &info) == S_OK);
+    AMD_TEST_CHECK_EQUAL(info.subresourceCount, 5);
+
+    // reopening unmaps the previous view, a failed open leaves nothing mapped
+    AMD_TEST_CHECK_EQUAL(mapped.Open(L"DDSTextureLoaderTest_missing.dds"), HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+    AMD_TEST_CHECK(mapped.GetData() == NULL);
+    AMD_TEST_CHECK_EQUAL(mapped.GetSize(), 0);
+    AMD_TEST_CHECK_EQUAL(mapped.Open(NULL), E_INVALIDARG);
+
+    // too short for the headers
+    pFile = fopen("DDSTextureLoaderTest.dds", "wb");
+    fwrite(&file[0], 1, s_HeaderSize - 1, pFile);
+    fclose(pFile);
+    AMD_TEST_CHECK_EQUAL(mapped.Open(L"DDSTextureLoaderTest.dds"), E_FAIL);
+    AMD_TEST_CHECK(mapped.GetData() == NULL);
+
+    mapped.Close();
+    remove("DDSTextureLoaderTest.dds");
+}
+
+int main()
+{
+    testLegacyMipChain();
+    testDX10Headers();
+    testCubeMaps();
+    testTruncation();
+    testMalformedHeaders();
+    testRandomHeaders();
+    testMappedFile();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//--------------------------------------------------------------------------------------
+// File: StateCacheTest.cpp
+//
+// C_StateCache in front of the null device context: redundant binds are dropped, slot
+// arrays reach the context trimmed to the range that changed, a buffer rebound at another
+// offset goes through, and views an output bind may have unbound are bound again. Binds
+// that go around the cache mark what reached the context, since the cache trusts its shadow.
+//--------------------------------------------------------------------------------------
+
+#include <d3d11.h>
+#include <cstring>
+
+#include "AMD_AOFX.h"
+#include "AMD_StateCache.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+struct NullContext
+{
+    ID3D11Device *              m_pDevice;
+    ID3D11DeviceContext *       m_pContext;
+    ID3D11DeviceContext1 *      m_pContext1;
+    ID3D11Texture2D *           m_pTexture;
+
+    NullContext() : m_pDevice(NULL), m_pContext(NULL), m_pContext1(NULL), m_pTexture(NULL)
+    {
+        AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&m_pDevice, &m_pContext), AOFX_RETURN_CODE_SUCCESS);
+        AMD_TEST_CHECK(SUCCEEDED(m_pContext->QueryInterface(__uuidof(ID3D11DeviceContext1), (void **)&m_pContext1)));
+
+        D3D11_TEXTURE2D_DESC textureDesc;
+        memset(&textureDesc, 0, sizeof(textureDesc));
+        textureDesc.Width = 64;
+        textureDesc.Height = 64;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        textureDesc.SampleDesc.Count = 1;
+        m_pDevice->CreateTexture2D(&textureDesc, NULL, &m_pTexture);
+    }
+
+    ~NullContext()
+    {
+        m_pTexture->Release();
+        m_pContext1->Release();
+        m_pContext->Release();
+        m_pDevice->Release();
+    }
+
+    // binds that reached the context
+    uint binds()
+    {
+        AOFX_DeviceCounters counters;
+        AOFX_GetDeviceCounters(m_pContext, &counters);
+        return counters.m_StateBinds;
+    }
+
+    ID3D11ShaderResourceView * createSRV() { ID3D11ShaderResourceView * pSRV = NULL; m_pDevice->CreateShaderResourceView(m_pTexture, NULL, &pSRV); return pSRV; }
+    ID3D11UnorderedAccessView * createUAV() { ID3D11UnorderedAccessView * pUAV = NULL; m_pDevice->CreateUnorderedAccessView(m_pTexture, NULL, &pUAV); return pUAV; }
+    ID3D11RenderTargetView * createRTV() { ID3D11RenderTargetView * pRTV = NULL; m_pDevice->CreateRenderTargetView(m_pTexture, NULL, &pRTV); return pRTV; }
+
+    ID3D11Buffer * createBuffer()
+    {
+        D3D11_BUFFER_DESC bufferDesc;
+        memset(&bufferDesc, 0, sizeof(bufferDesc));
+        bufferDesc.ByteWidth = 4096;
+        ID3D11Buffer * pBuffer = NULL;
+        m_pDevice->CreateBuffer(&bufferDesc, NULL, &pBuffer);
+        return pBuffer;
+    }
+};
+
+// the context returns a reference, the test keeps its own so the object stays alive
+template <class Object>
+static Object * bound(Object * pObject)
+{
+    if (pObject != NULL) pObject->Release();
+    return pObject;
+}
+
+static ID3D11ShaderResourceView * boundPSSRV(ID3D11DeviceContext * pContext, UINT slot) { ID3D11ShaderResourceView * pSRV = NULL; pContext->PSGetShaderResources(slot, 1, &pSRV); return bound(pSRV); }
+static ID3D11ShaderResourceView * boundCSSRV(ID3D11DeviceContext * pContext, UINT slot) { ID3D11ShaderResourceView * pSRV = NULL; pContext->CSGetShaderResources(slot, 1, &pSRV); return bound(pSRV); }
+
+// the cache only trusts shader resource views once it knows no output is bound
+static void bindNoOutputs(C_StateCache & cache)
+{
+    ID3D11UnorderedAccessView * pNullUAV[C_StateCache::MaxSlots] = { NULL };
+    cache.OMSetRenderTargets(0, NULL, NULL);
+    cache.CSSetUnorderedAccessViews(0, C_StateCache::MaxSlots, pNullUAV, NULL);
+}
+
+//--------------------------------------------------------------------------------------
+// A bind of what is already bound never reaches the context, unless the cache was reset
+// or does not filter
+//--------------------------------------------------------------------------------------
+static void testRedundantBinds()
+{
+    NullContext null;
+    C_StateCache cache(null.m_pContext);
+
+    ID3D11Buffer * pBuffer = null.createBuffer();
+    ID3D11ShaderResourceView * pSRV[2] = { null.createSRV(), null.createSRV() };
+    ID3D11RenderTargetView * pRTV = null.createRTV();
+    D3D11_VIEWPORT viewport = { 0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f };
+    const FLOAT blendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    UINT stride = 16, offset = 0;
+
+    for (uint pass = 0; pass < 3; pass++)
+    {
+        cache.ResetCounters();
+        uint binds = null.binds();
+
+        cache.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        cache.IASetInputLayout(NULL);
+        cache.IASetVertexBuffers(0, 1, &pBuffer, &stride, &offset);
+        cache.PSSetConstantBuffers(0, 1, &pBuffer);
+        cache.CSSetConstantBuffers(0, 1, &pBuffer);
+        cache.RSSetViewports(1, &viewport);
+        cache.OMSetBlendState(NULL, blendFactor, 0xFFFFFFFF);
+        cache.OMSetDepthStencilState(NULL, 0);
+        cache.OMSetRenderTargets(1, &pRTV, NULL);
+
+        // the first pass binds everything, the second nothing, the third everything after a reset
+        uint expected = pass == 1 ? 0 : 9;
+        AMD_TEST_CHECK_EQUAL(null.binds() - binds, expected);
+        AMD_TEST_CHECK_EQUAL(cache.GetMisses(), expected);
+        AMD_TEST_CHECK_EQUAL(cache.GetHits(), 9 - expected);
+
+        if (pass == 1) cache.Reset(null.m_pContext, null.m_pContext1);
+    }
+
+    // a blend state without a factor is the same as a white factor
+    uint binds = null.binds();
+    cache.OMSetBlendState(NULL, NULL, 0xFFFFFFFF);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 0);
+
+    // NULL and no bind at all are different states
+    cache.OMSetRenderTargets(0, NULL, NULL);
+    cache.CSSetShader(NULL);
+    cache.CSSetShader(NULL);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+
+    // a cache created without filtering forwards every bind
+    C_StateCache forward(null.m_pContext, false);
+    binds = null.binds();
+    for (uint i = 0; i < 3; i++)
+    {
+        forward.PSSetShaderResources(0, 2, pSRV);
+        forward.RSSetViewports(1, &viewport);
+    }
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 6);
+    AMD_TEST_CHECK_EQUAL(forward.GetHits(), 0);
+
+    pBuffer->Release();
+    pSRV[0]->Release();
+    pSRV[1]->Release();
+    pRTV->Release();
+}
+
+//--------------------------------------------------------------------------------------
+// Only the contiguous range of slots that changed is forwarded, slots outside of it are
+// left to whatever the context holds
+//--------------------------------------------------------------------------------------
+static void testRangeTrimming()
+{
+    NullContext null;
+    C_StateCache cache(null.m_pContext);
+    bindNoOutputs(cache);
+
+    ID3D11ShaderResourceView * pSRV[6];
+    for (uint i = 0; i < 6; i++) pSRV[i] = null.createSRV();
+    ID3D11ShaderResourceView * pMarker = null.createSRV();
+
+    ID3D11ShaderResourceView * pFirst[4] = { pSRV[0], pSRV[1], pSRV[2], pSRV[3] };
+    cache.PSSetShaderResources(0, 4, pFirst);
+
+    // slots 0 and 3 are changed around the cache, the second bind only touches slots 1 and 2
+    null.m_pContext->PSSetShaderResources(0, 1, &pMarker);
+    null.m_pContext->PSSetShaderResources(3, 1, &pMarker);
+
+    uint binds = null.binds();
+    ID3D11ShaderResourceView * pSecond[4] = { pSRV[0], pSRV[4], pSRV[5], pSRV[3] };
+    cache.PSSetShaderResources(0, 4, pSecond);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 1);
+    AMD_TEST_CHECK(boundPSSRV(null.m_pContext, 0) == pMarker);
+    AMD_TEST_CHECK(boundPSSRV(null.m_pContext, 1) == pSRV[4]);
+    AMD_TEST_CHECK(boundPSSRV(null.m_pContext, 2) == pSRV[5]);
+    AMD_TEST_CHECK(boundPSSRV(null.m_pContext, 3) == pMarker);
+
+    // a bind starting past the changed slot keeps its own offset
+    cache.PSSetShaderResources(2, 2, &pSecond[1]);
+    AMD_TEST_CHECK(boundPSSRV(null.m_pContext, 2) == pSRV[4]);
+    AMD_TEST_CHECK(boundPSSRV(null.m_pContext, 3) == pSRV[5]);
+
+    // an array reaching past the shadowed slots is forwarded untouched and forgets the overlap,
+    // so the same view is bound again, slots past the shadow always go through
+    ID3D11ShaderResourceView * pWide[C_StateCache::MaxSlots + 2] = { NULL };
+    pWide[0] = pSRV[0];
+    binds = null.binds();
+    cache.PSSetShaderResources(0, AMD_ARRAY_SIZE(pWide), pWide);
+    cache.PSSetShaderResources(0, 1, pWide);
+    cache.PSSetShaderResources(0, 1, pWide);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+    cache.PSSetShaderResources(C_StateCache::MaxSlots, 1, pWide);
+    cache.PSSetShaderResources(C_StateCache::MaxSlots, 1, pWide);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 4);
+
+    // samplers and unordered access views are trimmed the same way
+    D3D11_SAMPLER_DESC samplerDesc;
+    memset(&samplerDesc, 0, sizeof(samplerDesc));
+    ID3D11SamplerState * pSamplers[3];
+    for (uint i = 0; i < 3; i++) null.m_pDevice->CreateSamplerState(&samplerDesc, &pSamplers[i]);
+    cache.CSSetSamplers(0, 2, pSamplers);
+    null.m_pContext->CSSetSamplers(0, 1, &pSamplers[2]);
+    ID3D11SamplerState * pChanged[2] = { pSamplers[0], pSamplers[2] };
+    cache.CSSetSamplers(0, 2, pChanged);
+    ID3D11SamplerState * pBound[2] = { NULL, NULL };
+    null.m_pContext->CSGetSamplers(0, 2, pBound);
+    AMD_TEST_CHECK(bound(pBound[0]) == pSamplers[2]);
+    AMD_TEST_CHECK(bound(pBound[1]) == pSamplers[2]);
+
+    ID3D11UnorderedAccessView * pUAV[2] = { null.createUAV(), null.createUAV() };
+    ID3D11UnorderedAccessView * pUAVMarker = null.createUAV();
+    cache.CSSetUnorderedAccessViews(0, 2, pUAV, NULL);
+    null.m_pContext->CSSetUnorderedAccessViews(1, 1, &pUAVMarker, NULL);
+    ID3D11UnorderedAccessView * pUAVChanged[2] = { pUAVMarker, pUAV[1] };
+    cache.CSSetUnorderedAccessViews(0, 2, pUAVChanged, NULL);
+    ID3D11UnorderedAccessView * pUAVBound[2] = { NULL, NULL };
+    null.m_pContext->CSGetUnorderedAccessViews(0, 2, pUAVBound);
+    AMD_TEST_CHECK(bound(pUAVBound[0]) == pUAVMarker);
+    AMD_TEST_CHECK(bound(pUAVBound[1]) == pUAVMarker);
+
+    // an initial count resets the hidden counter, such a bind is never dropped
+    const UINT initialCounts[2] = { 0, 0 };
+    binds = null.binds();
+    cache.CSSetUnorderedAccessViews(0, 2, pUAVChanged, initialCounts);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 1);
+
+    for (uint i = 0; i < 6; i++) pSRV[i]->Release();
+    for (uint i = 0; i < 3; i++) pSamplers[i]->Release();
+    pMarker->Release();
+    pUAV[0]->Release();
+    pUAV[1]->Release();
+    pUAVMarker->Release();
+}
+
+//--------------------------------------------------------------------------------------
+// A buffer bound again at another offset or range is a new binding, for constant and
+// vertex buffers, and only the slot that moved is forwarded
+//--------------------------------------------------------------------------------------
+static void testBufferOffsets()
+{
+    NullContext null;
+    C_StateCache cache(null.m_pContext, true);
+    cache.Reset(null.m_pContext, null.m_pContext1);
+
+    ID3D11Buffer * pRing = null.createBuffer();
+    ID3D11Buffer * pMarker = null.createBuffer();
+
+    ID3D11Buffer * pBuffers[2] = { pRing, pRing };
+    UINT firstConstant[2] = { 0, 16 };
+    UINT numConstants[2] = { 16, 16 };
+    cache.CSSetConstantBuffers1(0, 2, pBuffers, firstConstant, numConstants);
+
+    uint binds = null.binds();
+    cache.CSSetConstantBuffers1(0, 2, pBuffers, firstConstant, numConstants);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 0);
+
+    // slot 1 moves to the next block, slot 0 is not bound again
+    null.m_pContext->CSSetConstantBuffers(0, 1, &pMarker);
+    firstConstant[1] = 32;
+    cache.CSSetConstantBuffers1(0, 2, pBuffers, firstConstant, numConstants);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+
+    ID3D11Buffer * pBound[2] = { NULL, NULL };
+    UINT boundFirst[2] = { 0, 0 }, boundNum[2] = { 0, 0 };
+    null.m_pContext1->CSGetConstantBuffers1(0, 2, pBound, boundFirst, boundNum);
+    AMD_TEST_CHECK(bound(pBound[0]) == pMarker);
+    AMD_TEST_CHECK(bound(pBound[1]) == pRing);
+    AMD_TEST_CHECK_EQUAL(boundFirst[1], 32);
+    AMD_TEST_CHECK_EQUAL(boundNum[1], 16);
+
+    // a different range size at the same offset, and the whole buffer, are new bindings as well
+    binds = null.binds();
+    numConstants[1] = 32;
+    cache.CSSetConstantBuffers1(0, 2, pBuffers, firstConstant, numConstants);
+    cache.CSSetConstantBuffers(1, 1, &pRing);
+    cache.CSSetConstantBuffers(1, 1, &pRing);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+    null.m_pContext1->CSGetConstantBuffers1(1, 1, pBound, boundFirst, boundNum);
+    bound(pBound[0]);
+    AMD_TEST_CHECK_EQUAL(boundFirst[0], 0);
+    AMD_TEST_CHECK_EQUAL(boundNum[0], D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT);
+
+    // the pixel shader stage has its own shadow
+    cache.PSSetConstantBuffers1(0, 2, pBuffers, firstConstant, numConstants);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 3);
+
+    // vertex buffers compare stride and offset
+    UINT strides[2] = { 16, 16 }, offsets[2] = { 0, 256 };
+    cache.IASetVertexBuffers(0, 2, pBuffers, strides, offsets);
+    binds = null.binds();
+    offsets[0] = 512;
+    cache.IASetVertexBuffers(0, 2, pBuffers, strides, offsets);
+    strides[1] = 32;
+    cache.IASetVertexBuffers(0, 2, pBuffers, strides, offsets);
+    cache.IASetVertexBuffers(0, 2, pBuffers, strides, offsets);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+
+    UINT boundStrides[2] = { 0, 0 }, boundOffsets[2] = { 0, 0 };
+    null.m_pContext->IAGetVertexBuffers(0, 2, pBound, boundStrides, boundOffsets);
+    bound(pBound[0]);
+    bound(pBound[1]);
+    AMD_TEST_CHECK_EQUAL(boundOffsets[0], 512);
+    AMD_TEST_CHECK_EQUAL(boundOffsets[1], 256);
+    AMD_TEST_CHECK_EQUAL(boundStrides[1], 32);
+
+    pRing->Release();
+    pMarker->Release();
+}
+
+//--------------------------------------------------------------------------------------
+// The runtime unbinds a shader resource view when a view of the same resource is bound as
+// an output, and outputs when a compute UAV aliases them. The null context does not, so
+// the unbinding is done around the cache; the next bind of the view has to go through.
+//--------------------------------------------------------------------------------------
+static void testOutputHazards()
+{
+    NullContext null;
+    C_StateCache cache(null.m_pContext);
+    bindNoOutputs(cache);
+
+    ID3D11ShaderResourceView * pSRV = null.createSRV();
+    ID3D11UnorderedAccessView * pUAV = null.createUAV();
+    ID3D11RenderTargetView * pRTV = null.createRTV();
+    ID3D11ShaderResourceView * pNullSRV = NULL;
+    ID3D11UnorderedAccessView * pNullUAV = NULL;
+
+    // without outputs the view is trusted
+    cache.PSSetShaderResources(0, 1, &pSRV);
+    cache.CSSetShaderResources(0, 1, &pSRV);
+    uint binds = null.binds();
+    cache.PSSetShaderResources(0, 1, &pSRV);
+    cache.CSSetShaderResources(0, 1, &pSRV);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 0);
+
+    // render target: both stages drop their views
+    cache.OMSetRenderTargets(1, &pRTV, NULL);
+    null.m_pContext->PSSetShaderResources(0, 1, &pNullSRV);
+    null.m_pContext->CSSetShaderResources(0, 1, &pNullSRV);
+    cache.OMSetRenderTargets(0, NULL, NULL);
+    binds = null.binds();
+    cache.PSSetShaderResources(0, 1, &pSRV);
+    cache.CSSetShaderResources(0, 1, &pSRV);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+    AMD_TEST_CHECK(boundPSSRV(null.m_pContext, 0) == pSRV);
+    AMD_TEST_CHECK(boundCSSRV(null.m_pContext, 0) == pSRV);
+
+    // compute UAV: same for the views
+    cache.CSSetUnorderedAccessViews(0, 1, &pUAV, NULL);
+    null.m_pContext->CSSetShaderResources(0, 1, &pNullSRV);
+    cache.CSSetUnorderedAccessViews(0, 1, &pNullUAV, NULL);
+    binds = null.binds();
+    cache.CSSetShaderResources(0, 1, &pSRV);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 1);
+    AMD_TEST_CHECK(boundCSSRV(null.m_pContext, 0) == pSRV);
+
+    // a view bound while an output is bound may have been rejected, it is not trusted either
+    cache.OMSetRenderTargets(1, &pRTV, NULL);
+    binds = null.binds();
+    cache.PSSetShaderResources(0, 1, &pSRV);
+    cache.PSSetShaderResources(0, 1, &pSRV);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+
+    // a compute UAV unbinds aliasing render targets, a render target unbinds aliasing compute UAVs
+    binds = null.binds();
+    cache.CSSetUnorderedAccessViews(0, 1, &pUAV, NULL);
+    cache.OMSetRenderTargets(1, &pRTV, NULL);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+    binds = null.binds();
+    cache.CSSetUnorderedAccessViews(0, 1, &pUAV, NULL);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 1);
+
+    // UAVs bound with the render targets are not shadowed, the bind always goes through and drops the shadow
+    binds = null.binds();
+    cache.OMSetRenderTargetsAndUnorderedAccessViews(1, &pRTV, NULL, 1, 1, &pUAV, NULL);
+    cache.OMSetRenderTargets(1, &pRTV, NULL);
+    AMD_TEST_CHECK_EQUAL(null.binds() - binds, 2);
+
+    pSRV->Release();
+    pUAV->Release();
+    pRTV->Release();
+}
+
+int main()
+{
+    testRedundantBinds();
+    testRangeTrimming();
+    testBufferOffsets();
+    testOutputHazards();
+
+    return AMD_TEST_RESULT();
+}
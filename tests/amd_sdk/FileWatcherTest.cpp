@@ -0,0 +1,393 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: FileWatcherTest.cpp
+//
+// FileWatcher coalescing on a real directory tree: the ways editors save a file (several
+// writes, write a temporary and rename it over the original, move the original away and
+// write a new one) are reported once, with only the saved file; saves that do not change
+// the contents are not reported; renames report both names; changes the callback refuses
+// are offered again together with later ones.
+//
+// The checks wait for a report with a generous timeout, then for several debounce periods
+// of silence, so they do not depend on the speed of the host.
+//--------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileWatcher.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const wchar_t * s_wsRoot = L"FileWatcherTest";
+static const unsigned int s_uDebounceMilliseconds = 50;
+static const unsigned int s_uTimeoutMilliseconds = 5000;
+
+typedef std::set<std::wstring> Files;
+
+// Records the reports, paths relative to the watched directory with '/' separators
+class Recorder
+{
+public:
+
+    Recorder() : m_bRefuse(false), m_uOffers(0) {}
+
+    static bool onChanged(void * pUserData, const std::vector<std::wstring> & i_ChangedFiles)
+    {
+        Recorder * pRecorder = (Recorder *)pUserData;
+        std::lock_guard<std::mutex> lock(pRecorder->m_Lock);
+        pRecorder->m_uOffers++;
+        if (pRecorder->m_bRefuse)
+        {
+            return false;
+        }
+
+        Files files;
+        for (size_t i = 0; i < i_ChangedFiles.size(); i++)
+        {
+            std::wstring pathName = i_ChangedFiles[i].substr(wcslen(s_wsRoot) + 1);
+            for (size_t j = 0; j < pathName.size(); j++)
+            {
+                if (pathName[j] == L'\\') pathName[j] = L'/';
+            }
+            files.insert(pathName);
+        }
+        pRecorder->m_Reports.push_back(files);
+        return true;
+    }
+
+    void refuse(bool bRefuse)
+    {
+        std::lock_guard<std::mutex> lock(m_Lock);
+        m_bRefuse = bRefuse;
+    }
+
+    unsigned int offers()
+    {
+        std::lock_guard<std::mutex> lock(m_Lock);
+        return m_uOffers;
+    }
+
+    // Waits for uCount offers (accepted or not) to have been made since the start
+    bool waitForOffers(unsigned int uCount)
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(s_uTimeoutMilliseconds);
+        while (offers() < uCount && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return offers() >= uCount;
+    }
+
+    // Waits for the next report, then for the tree to stay quiet, and returns every report since the last call
+    std::vector<Files> collect(bool bExpectReport)
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(bExpectReport ? s_uTimeoutMilliseconds : 0);
+        for (;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Lock);
+                if (!m_Reports.empty()) break;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(s_uDebounceMilliseconds * 6));
+
+        std::lock_guard<std::mutex> lock(m_Lock);
+        std::vector<Files> reports;
+        reports.swap(m_Reports);
+        return reports;
+    }
+
+private:
+
+    std::mutex              m_Lock;
+    std::vector<Files>      m_Reports;
+    bool                    m_bRefuse;
+    unsigned int            m_uOffers;
+};
+
+static std::wstring pathName(const wchar_t * pwsRelative)
+{
+    std::wstring result = std::wstring(s_wsRoot) + L"\\" + pwsRelative;
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        if (result[i] == L'/') result[i] = L'\\';
+    }
+    return result;
+}
+
+static void writeFile(const wchar_t * pwsRelative, const char * pContents)
+{
+    HANDLE hFile = CreateFileW(pathName(pwsRelative).c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    AMD_TEST_CHECK(INVALID_HANDLE_VALUE != hFile);
+    if (INVALID_HANDLE_VALUE != hFile)
+    {
+        DWORD uWritten = 0;
+        AMD_TEST_CHECK(WriteFile(hFile, pContents, (DWORD)strlen(pContents), &uWritten, NULL));
+        CloseHandle(hFile);
+    }
+}
+
+static void moveFile(const wchar_t * pwsFrom, const wchar_t * pwsTo)
+{
+    AMD_TEST_CHECK(MoveFileExW(pathName(pwsFrom).c_str(), pathName(pwsTo).c_str(), MOVEFILE_REPLACE_EXISTING));
+}
+
+// MOVEFILE_REPLACE_EXISTING cannot be used with directories
+static void moveDirectory(const wchar_t * pwsFrom, const wchar_t * pwsTo)
+{
+    AMD_TEST_CHECK(MoveFileExW(pathName(pwsFrom).c_str(), pathName(pwsTo).c_str(), 0));
+}
+
+static void deleteFile(const wchar_t * pwsRelative)
+{
+    AMD_TEST_CHECK(DeleteFileW(pathName(pwsRelative).c_str()));
+}
+
+static void createDirectory(const wchar_t * pwsRelative)
+{
+    AMD_TEST_CHECK(CreateDirectoryW(pathName(pwsRelative).c_str(), NULL));
+}
+
+static void removeTree(const std::wstring & directory)
+{
+    WIN32_FIND_DATAW data;
+    HANDLE hFind = FindFirstFileW((directory + L"\\*").c_str(), &data);
+    if (INVALID_HANDLE_VALUE != hFind)
+    {
+        do
+        {
+            std::wstring name = data.cFileName;
+            if (name == L"." || name == L"..") continue;
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            {
+                removeTree(directory + L"\\" + name);
+            }
+            else
+            {
+                DeleteFileW((directory + L"\\" + name).c_str());
+            }
+        }
+        while (FindNextFileW(hFind, &data));
+        FindClose(hFind);
+    }
+    RemoveDirectoryW(directory.c_str());
+}
+
+static Files files(const wchar_t * pwsFirst, const wchar_t * pwsSecond = NULL, const wchar_t * pwsThird = NULL)
+{
+    Files result;
+    result.insert(pwsFirst);
+    if (pwsSecond) result.insert(pwsSecond);
+    if (pwsThird) result.insert(pwsThird);
+    return result;
+}
+
+// One report with exactly the given files
+static bool reportedOnce(const std::vector<Files> & reports, const Files & expected)
+{
+    if (reports.size() != 1 || reports[0] != expected)
+    {
+        printf("expected one report of %u file(s), got %u report(s):", (unsigned int)expected.size(), (unsigned int)reports.size());
+        for (size_t i = 0; i < reports.size(); i++)
+        {
+            for (Files::const_iterator it = reports[i].begin(); it != reports[i].end(); it++)
+            {
+                printf(" %ls", it->c_str());
+            }
+            printf(" |");
+        }
+        printf("\n");
+        return false;
+    }
+    return true;
+}
+
+struct WatchedTree
+{
+    FileWatcher     m_Watcher;
+    Recorder        m_Recorder;
+
+    WatchedTree()
+    {
+        removeTree(s_wsRoot);
+        AMD_TEST_CHECK(CreateDirectoryW(s_wsRoot, NULL));
+        createDirectory(L"inc");
+        writeFile(L"a.hlsl", "float4 a;\n");
+        writeFile(L"b.hlsl", "float4 b;\n");
+        writeFile(L"inc/common.hlsl", "#define COMMON 1\n");
+
+        AMD_TEST_CHECK(m_Watcher.Start(s_wsRoot, Recorder::onChanged, &m_Recorder, s_uDebounceMilliseconds));
+        AMD_TEST_CHECK(m_Watcher.IsRunning());
+    }
+
+    ~WatchedTree()
+    {
+        m_Watcher.Stop();
+        removeTree(s_wsRoot);
+    }
+};
+
+//--------------------------------------------------------------------------------------
+// Editors saving a file
+//--------------------------------------------------------------------------------------
+static void testSaves()
+{
+    WatchedTree tree;
+    Recorder & recorder = tree.m_Recorder;
+
+    AMD_TEST_CHECK(recorder.collect(false).empty());
+
+    // several writes within the debounce period
+    for (int i = 0; i < 5; i++)
+    {
+        char contents[64];
+        snprintf(contents, sizeof(contents), "float4 a; // %d\n", i);
+        writeFile(L"a.hlsl", contents);
+    }
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"a.hlsl")));
+
+    // atomic save: a temporary file renamed over the original, the temporary is never reported
+    writeFile(L"a.hlsl.tmp", "float4 a; // atomic save\n");
+    moveFile(L"a.hlsl.tmp", L"a.hlsl");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"a.hlsl")));
+
+    // the same with the temporary in a subdirectory
+    writeFile(L"inc/.common.hlsl.swp", "#define COMMON 2\n");
+    moveFile(L"inc/.common.hlsl.swp", L"inc/common.hlsl");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"inc/common.hlsl")));
+
+    // backup save: the original moved away, a new file written, the backup deleted
+    moveFile(L"b.hlsl", L"b.hlsl~");
+    writeFile(L"b.hlsl", "float4 b; // backup save\n");
+    deleteFile(L"b.hlsl~");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"b.hlsl")));
+
+    // saves that leave the contents as they were
+    writeFile(L"a.hlsl", "float4 a; // atomic save\n");
+    writeFile(L"b.hlsl.tmp", "float4 b; // backup save\n");
+    moveFile(L"b.hlsl.tmp", L"b.hlsl");
+    AMD_TEST_CHECK(recorder.collect(false).empty());
+
+    // a temporary file that is created and deleted again
+    writeFile(L"scratch.tmp", "scratch");
+    deleteFile(L"scratch.tmp");
+    AMD_TEST_CHECK(recorder.collect(false).empty());
+}
+
+//--------------------------------------------------------------------------------------
+// Renames, new and deleted files and directories
+//--------------------------------------------------------------------------------------
+static void testRenames()
+{
+    WatchedTree tree;
+    Recorder & recorder = tree.m_Recorder;
+
+    // a rename reports the old and the new name
+    moveFile(L"a.hlsl", L"c.hlsl");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"a.hlsl", L"c.hlsl")));
+
+    // renaming a file back and forth within the debounce period changes nothing
+    moveFile(L"c.hlsl", L"d.hlsl");
+    moveFile(L"d.hlsl", L"c.hlsl");
+    AMD_TEST_CHECK(recorder.collect(false).empty());
+
+    // a renamed directory reports everything in it, and is watched under its new name
+    moveDirectory(L"inc", L"include");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"inc/common.hlsl", L"include/common.hlsl")));
+    writeFile(L"include/common.hlsl", "#define COMMON 3\n");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"include/common.hlsl")));
+
+    // a new directory with a file, and a deletion, in one burst
+    createDirectory(L"new");
+    writeFile(L"new/e.hlsl", "float4 e;\n");
+    deleteFile(L"b.hlsl");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"new/e.hlsl", L"b.hlsl")));
+    writeFile(L"new/e.hlsl", "float4 e; // changed\n");
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"new/e.hlsl")));
+}
+
+//--------------------------------------------------------------------------------------
+// A callback that is busy (e.g. compiling) refuses the changes, they are offered again with
+// whatever changed meanwhile and are reported once when accepted
+//--------------------------------------------------------------------------------------
+static void testRefusedChanges()
+{
+    WatchedTree tree;
+    Recorder & recorder = tree.m_Recorder;
+
+    recorder.refuse(true);
+    writeFile(L"a.hlsl", "float4 a; // while busy\n");
+    AMD_TEST_CHECK(recorder.waitForOffers(2));
+
+    writeFile(L"a.hlsl.tmp", "float4 a; // still busy\n");
+    moveFile(L"a.hlsl.tmp", L"a.hlsl");
+    writeFile(L"inc/common.hlsl", "#define COMMON 4\n");
+    unsigned int uOffers = recorder.offers();
+    AMD_TEST_CHECK(recorder.waitForOffers(uOffers + 2));
+    AMD_TEST_CHECK(recorder.collect(false).empty());
+
+    recorder.refuse(false);
+    AMD_TEST_CHECK(reportedOnce(recorder.collect(true), files(L"a.hlsl", L"inc/common.hlsl")));
+    AMD_TEST_CHECK(recorder.collect(false).empty());
+}
+
+static void testStop()
+{
+    FileWatcher watcher;
+    AMD_TEST_CHECK(!watcher.IsRunning());
+    watcher.Stop();
+
+    {
+        WatchedTree tree;
+        tree.m_Watcher.Stop();
+        AMD_TEST_CHECK(!tree.m_Watcher.IsRunning());
+
+        // nothing is reported once stopped, a restart takes the current tree as its baseline
+        writeFile(L"a.hlsl", "float4 a; // while stopped\n");
+        AMD_TEST_CHECK(tree.m_Recorder.collect(false).empty());
+        AMD_TEST_CHECK(tree.m_Watcher.Start(s_wsRoot, Recorder::onChanged, &tree.m_Recorder, s_uDebounceMilliseconds));
+        AMD_TEST_CHECK(tree.m_Recorder.collect(false).empty());
+        writeFile(L"b.hlsl", "float4 b; // after the restart\n");
+        AMD_TEST_CHECK(reportedOnce(tree.m_Recorder.collect(true), files(L"b.hlsl")));
+    }
+}
+
+int main()
+{
+    testSaves();
+    testRenames();
+    testRefusedChanges();
+    testStop();
+
+    return AMD_TEST_RESULT();
+}
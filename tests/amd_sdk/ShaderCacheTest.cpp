@@ -0,0 +1,534 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderCacheTest.cpp
+//
+// ShaderCache driven through the stub fxc (StubFxc.cpp) and the AOFX null device. The test
+// lays out a sample under ShaderCacheTest: bin is the working directory, src/Shaders has the
+// sources and sdk stands in for Program Files (x86), with the stub as the Windows 10 SDK fxc.
+// The command lines ShaderCache builds are read back from the stub's log, the file names
+// from the cache directories, and the shader states from GetNumShadersInState, across
+// forced, incremental and cached generations, and the telemetry of each generation from
+// GetShaderTelemetry and ShaderTelemetry.jsonl.
+//--------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "DXUT.h"
+#include "SDKmisc.h"
+#include "ShaderCache.h"
+#include "AMD_AOFX.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static std::wstring s_wsRoot;
+
+static std::wstring widen(const char * pText)
+{
+    std::wstring result;
+    for (; *pText; ++pText) result += (wchar_t)(unsigned char)*pText;
+    return result;
+}
+
+static std::string narrow(const std::wstring & text)
+{
+    std::string result;
+    for (size_t i = 0; i < text.size(); i++) result += (char)text[i];
+    return result;
+}
+
+// The path as ShaderCache builds it with PathCombine, with backslashes
+static std::string windowsPath(const std::wstring & pathName)
+{
+    std::string result = narrow(pathName);
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        if (result[i] == '/') result[i] = '\\';
+    }
+    return result;
+}
+
+static void removeTree(const std::wstring & directory)
+{
+    WIN32_FIND_DATAW data;
+    HANDLE hFind = FindFirstFileW((directory + L"/*").c_str(), &data);
+    if (INVALID_HANDLE_VALUE != hFind)
+    {
+        do
+        {
+            std::wstring name = data.cFileName;
+            if (name == L"." || name == L"..") continue;
+            std::wstring pathName = directory + L"/" + name;
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) removeTree(pathName);
+            else DeleteFileW(pathName.c_str());
+        }
+        while (FindNextFileW(hFind, &data));
+        FindClose(hFind);
+    }
+    RemoveDirectoryW(directory.c_str());
+}
+
+static bool fileExists(const std::wstring & pathName) { return GetFileAttributesW(pathName.c_str()) != INVALID_FILE_ATTRIBUTES; }
+
+static long fileSize(const std::wstring & pathName)
+{
+    FILE * pFile = fopen(narrow(pathName).c_str(), "rb");
+    if (!pFile) return -1;
+    fseek(pFile, 0, SEEK_END);
+    long iSize = ftell(pFile);
+    fclose(pFile);
+    return iSize;
+}
+
+static void writeSource(const wchar_t * pwsName, const char * pText)
+{
+    FILE * pFile = fopen(narrow(s_wsRoot + L"/src/Shaders/" + pwsName).c_str(), "wb");
+    AMD_TEST_CHECK(pFile != NULL);
+    if (!pFile) return;
+    fputs(pText, pFile);
+    fclose(pFile);
+}
+
+static std::wstring fxcDirectory() { return s_wsRoot + L"/sdk/Windows Kits/10/bin/x64"; }
+
+// The command lines the stub fxc ran since the last call
+static std::vector<std::string> takeFxcLog()
+{
+    std::vector<std::string> lines;
+    const std::wstring logPathName = fxcDirectory() + L"/fxc.log";
+    FILE * pFile = fopen(narrow(logPathName).c_str(), "rb");
+    if (!pFile) return lines;
+    char line[ShaderCache::m_uCOMMAND_LINE_MAX_LENGTH];
+    while (fgets(line, sizeof(line), pFile))
+    {
+        lines.push_back(line);
+        if (!lines.back().empty() && lines.back()[lines.back().size() - 1] == '\n') lines.back().erase(lines.back().size() - 1);
+    }
+    fclose(pFile);
+    DeleteFileW(logPathName.c_str());
+    return lines;
+}
+
+// The name of the assembly file: the first 4 bytes of the MD5 of the raw name
+static std::string hashedName(const char * pRawName)
+{
+    HCRYPTPROV hProv = 0;
+    HCRYPTHASH hHash = 0;
+    BYTE hash[16];
+    DWORD dwHashLength = sizeof(hash);
+    AMD_TEST_CHECK(CryptAcquireContext(&hProv, NULL, NULL, PROV_RSA_FULL, 0));
+    AMD_TEST_CHECK(CryptCreateHash(hProv, CALG_MD5, 0, 0, &hHash));
+    AMD_TEST_CHECK(CryptHashData(hHash, (const BYTE *)pRawName, (DWORD)strlen(pRawName), 0));
+    AMD_TEST_CHECK(CryptGetHashParam(hHash, HP_HASHVAL, hash, &dwHashLength, 0));
+    CryptDestroyHash(hHash);
+    CryptReleaseContext(hProv, 0);
+
+    char name[16];
+    snprintf(name, sizeof(name), "%x", (unsigned int)(hash[0] | (hash[1] << 8) | (hash[2] << 16) | ((unsigned int)hash[3] << 24)));
+    return name;
+}
+
+// Lays out the sample and makes its bin directory the current one
+static void setUp()
+{
+    wchar_t wsCurrentDir[MAX_PATH];
+    AMD_TEST_CHECK(GetCurrentDirectoryW(MAX_PATH, wsCurrentDir) > 0);
+    s_wsRoot = std::wstring(wsCurrentDir) + L"/ShaderCacheTest";
+    removeTree(s_wsRoot);
+
+    const wchar_t * pwsDirectories[] = { L"", L"/bin", L"/src", L"/src/Shaders", L"/sdk", L"/sdk/Windows Kits", L"/sdk/Windows Kits/10", L"/sdk/Windows Kits/10/bin", L"/sdk/Windows Kits/10/bin/x64" };
+    for (size_t i = 0; i < ARRAYSIZE(pwsDirectories); i++)
+    {
+        AMD_TEST_CHECK(CreateDirectoryW((s_wsRoot + pwsDirectories[i]).c_str(), NULL));
+    }
+
+    const std::wstring fxcPathName = fxcDirectory() + L"/fxc.exe";
+    AMD_TEST_CHECK(CopyFileW(widen(AMD_STUB_FXC).c_str(), fxcPathName.c_str(), FALSE));
+    AMD_TEST_CHECK(chmod(narrow(fxcPathName).c_str(), 0755) == 0);
+
+    setenv("ProgramFiles(x86)", narrow(s_wsRoot + L"/sdk").c_str(), 1);
+    unsetenv("AMD_SDK_SHARED_SHADER_CACHE_DIR");
+    AMD_TEST_CHECK(chdir(narrow(s_wsRoot + L"/bin").c_str()) == 0);
+}
+
+// Renders the progress until the shaders are ready, as a sample does every frame
+static bool generate(ShaderCache & cache, ShaderCache::CREATE_TYPE createType)
+{
+    CDXUTTextHelper textHelper;
+    AMD_TEST_CHECK_EQUAL(cache.GenerateShaders(createType), S_OK);
+    for (int i = 0; i < 30000; i++)
+    {
+        cache.RenderProgress(&textHelper, 15, DirectX::XMVectorSet(1.0f, 1.0f, 0.0f, 1.0f));
+        if (cache.ShadersReady()) return true;
+        Sleep(1);
+    }
+    return false;
+}
+
+static ShaderCache::Macro macro(const wchar_t * pwsName, int iValue)
+{
+    ShaderCache::Macro result;
+    wcscpy_s(result.m_wsName, pwsName);
+    result.m_iValue = iValue;
+    return result;
+}
+
+static const char * s_pSimpleSource =
+    "float4 PS_Main() : SV_Target { return A + B; }\n"
+    "[numthreads(8, 8, 1)] void CS_Main() {}\n"
+    "float4 VS_Main() : SV_Position { return 0; }\n";
+
+static void testCommandLinesAndFileNames()
+{
+    writeSource(L"Simple.hlsl", s_pSimpleSource);
+    takeFxcLog();
+
+    ID3D11PixelShader * pPixelShader = NULL;
+    ID3D11ComputeShader * pComputeShader = NULL;
+    ID3D11VertexShader * pVertexShader = NULL;
+    {
+        ShaderCache cache(ShaderCache::SHADER_AUTO_RECOMPILE_DISABLED, ShaderCache::ERROR_DISPLAY_IN_DEBUG_OUTPUT);
+
+        ShaderCache::Macro macros[] = { macro(L"A", 1), macro(L"B", -2) };
+        AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pPixelShader, ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PS_Main", L"Simple.hlsl", 2, macros, NULL, NULL, 0));
+        AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pComputeShader, ShaderCache::SHADER_TYPE_COMPUTE, L"cs_5_0", L"CS_Main", L"Simple.hlsl", 0, NULL, NULL, NULL, 0, L"CS_Canonical"));
+        cache.ForceDebugShaders(true);
+        AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pVertexShader, ShaderCache::SHADER_TYPE_VERTEX, L"vs_5_0", L"VS_Main", L"Simple.hlsl", 0, NULL, NULL, NULL, 0));
+        AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_IDLE), 3);
+
+        AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_FORCE_COMPILE));
+        AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), 3);
+        AMD_TEST_CHECK(pPixelShader != NULL && pComputeShader != NULL && pVertexShader != NULL);
+    }
+    SAFE_RELEASE(pPixelShader);
+    SAFE_RELEASE(pComputeShader);
+    SAFE_RELEASE(pVertexShader);
+
+    // fxc gets the \\?\ paths of the working and source directories
+    const std::string workingDir = "\\\\?\\" + windowsPath(s_wsRoot + L"/bin");
+    const std::string sourceFile = "\\\\?\\" + windowsPath(s_wsRoot + L"/src/Shaders/Simple.hlsl");
+#ifdef _DEBUG
+    const std::string flags = "/Zi /Od /Gfp", object = "Object\\Debug\\";
+#else
+    const std::string flags = "/O1", object = "Object\\Release\\";
+#endif
+    const std::string expected[] =
+    {
+        "/T ps_5_0 " + flags + " /E PS_Main /Fo " + workingDir + "\\Shaders\\Cache\\" + object + "PS_Main_A=1_B=-2.obj /D A=1 /D B=-2"
+            " /Fe " + workingDir + "\\Shaders\\Cache\\Error\\PS_Main_A=1_B=-2.txt /Fc " + workingDir + "\\Shaders\\Cache\\Assembly\\" + hashedName("PS_Main_A=1_B=-2") + ".asm " + sourceFile,
+        "/T cs_5_0 " + flags + " /E CS_Main /Fo " + workingDir + "\\Shaders\\Cache\\" + object + "CS_Canonical.obj"
+            " /Fe " + workingDir + "\\Shaders\\Cache\\Error\\CS_Canonical.txt /Fc " + workingDir + "\\Shaders\\Cache\\Assembly\\" + hashedName("CS_Canonical") + ".asm " + sourceFile,
+#ifdef _DEBUG
+        "/T vs_5_0 " + flags + " /E VS_Main /Fo " + workingDir + "\\Shaders\\Cache\\" + object + "VS_Main.obj"
+#else
+        "/T vs_5_0 /Od /E VS_Main /Fo " + workingDir + "\\Shaders\\Cache\\" + object + "VS_Main.obj"
+#endif
+            " /Fe " + workingDir + "\\Shaders\\Cache\\Error\\VS_Main.txt /Fc " + workingDir + "\\Shaders\\Cache\\Assembly\\" + hashedName("VS_Main") + ".asm " + sourceFile,
+    };
+
+    // One compile per shader, in the order they were added: one core leaves one shader per batch
+    std::vector<std::string> log = takeFxcLog();
+    AMD_TEST_CHECK_EQUAL(log.size(), ARRAYSIZE(expected));
+    for (size_t i = 0; i < log.size() && i < ARRAYSIZE(expected); i++)
+    {
+        if (log[i] != expected[i]) printf("fxc command line\n  %s\nexpected\n  %s\n", log[i].c_str(), expected[i].c_str());
+        AMD_TEST_CHECK(log[i] == expected[i]);
+    }
+
+    // The objects and hashes went into the database, the error and assembly files stay
+    const std::wstring cacheDir = s_wsRoot + L"/bin/Shaders/Cache/";
+    const wchar_t * pwsRawNames[] = { L"PS_Main_A=1_B=-2", L"CS_Canonical", L"VS_Main" };
+    for (size_t i = 0; i < ARRAYSIZE(pwsRawNames); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(fileSize(cacheDir + L"Error/" + pwsRawNames[i] + L".txt"), 0);
+        AMD_TEST_CHECK(fileSize(cacheDir + L"Assembly/" + widen(hashedName(narrow(pwsRawNames[i]).c_str()).c_str()) + L".asm") > 0);
+        AMD_TEST_CHECK(!fileExists(cacheDir + L"Object/Release/" + pwsRawNames[i] + L".obj"));
+        AMD_TEST_CHECK(!fileExists(cacheDir + L"Hash/Release/" + pwsRawNames[i] + L".hsh"));
+    }
+    AMD_TEST_CHECK(fileSize(cacheDir + L"Object/Release/Objects.db") > 0);
+}
+
+static void testPreprocessCommandLine()
+{
+    // #error stops the in process preprocessor, so fxc /P preprocesses, then the compile fails
+    writeSource(L"Broken.hlsl", "#if X == 3\n#error broken on purpose\n#endif\nfloat4 PS_Broken() : SV_Target { return 0; }\n");
+    takeFxcLog();
+
+    ID3D11PixelShader * pPixelShader = NULL;
+    {
+        ShaderCache cache(ShaderCache::SHADER_AUTO_RECOMPILE_DISABLED, ShaderCache::ERROR_DISPLAY_IN_DEBUG_OUTPUT);
+        ShaderCache::Macro macros[] = { macro(L"X", 3) };
+        AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pPixelShader, ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PS_Broken", L"Broken.hlsl", 1, macros, NULL, NULL, 0));
+
+        AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_COMPILE_CHANGES));
+        AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_ERROR), 1);
+        AMD_TEST_CHECK(pPixelShader == NULL);
+    }
+
+    const std::string workingDir = "\\\\?\\" + windowsPath(s_wsRoot + L"/bin");
+    const std::string expected = "/E PS_Broken \\\\?\\" + windowsPath(s_wsRoot + L"/src/Shaders/Broken.hlsl") +
+        " /P " + workingDir + "\\Shaders\\Cache\\Preprocess\\PS_Broken_X=3.ppf /D X=3";
+
+    std::vector<std::string> log = takeFxcLog();
+    AMD_TEST_CHECK_EQUAL(log.size(), 2);
+    if (!log.empty())
+    {
+        if (log[0] != expected) printf("fxc command line\n  %s\nexpected\n  %s\n", log[0].c_str(), expected.c_str());
+        AMD_TEST_CHECK(log[0] == expected);
+    }
+    if (log.size() > 1) AMD_TEST_CHECK(log[1].compare(0, 10, "/T ps_5_0 ") == 0);
+
+    AMD_TEST_CHECK(fileSize(s_wsRoot + L"/bin/Shaders/Cache/Error/PS_Broken_X=3.txt") > 0);
+}
+
+// Which state each generation leaves the shaders in, and what it compiles
+static void testStates()
+{
+    writeSource(L"States.hlsl", s_pSimpleSource);
+    takeFxcLog();
+
+    ID3D11PixelShader * pPixelShaders[3] = { NULL, NULL, NULL };
+    ShaderCache cache(ShaderCache::SHADER_AUTO_RECOMPILE_DISABLED, ShaderCache::ERROR_DISPLAY_IN_DEBUG_OUTPUT);
+    for (int i = 0; i < 3; i++)
+    {
+        ShaderCache::Macro macros[] = { macro(L"A", i), macro(L"B", 0) };
+        AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pPixelShaders[i], ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PS_Main", L"States.hlsl", 2, macros, NULL, NULL, 0));
+    }
+    ID3D11PixelShader * pMissingShader = NULL;
+    AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pMissingShader, ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PS_Main", L"Missing.hlsl", 0, NULL, NULL, NULL, 0));
+
+    const unsigned int uIdle[ShaderCache::SHADER_STATE_MAX] = { 4, 0, 0, 0, 0, 0, 0 };
+    for (int s = 0; s < ShaderCache::SHADER_STATE_MAX; s++)
+    {
+        AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState((ShaderCache::SHADER_STATE)s), uIdle[s]);
+    }
+
+    // Nothing cached yet: everything found is compiled, the missing source goes back to idle
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_COMPILE_CHANGES));
+    AMD_TEST_CHECK_EQUAL(takeFxcLog().size(), 3);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), 3);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_IDLE), 1);
+    AMD_TEST_CHECK(pPixelShaders[0] != NULL && pPixelShaders[1] != NULL && pPixelShaders[2] != NULL);
+    AMD_TEST_CHECK(pMissingShader == NULL);
+
+    // Unchanged sources are preprocessed and hashed, but not compiled again
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_COMPILE_CHANGES));
+    AMD_TEST_CHECK_EQUAL(takeFxcLog().size(), 0);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), 3);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_IDLE), 1);
+
+    // A change to the preprocessed source of one permutation only recompiles that one
+    writeSource(L"States.hlsl", (std::string("#if A == 1\nfloat4 Extra() { return 1; }\n#endif\n") + s_pSimpleSource).c_str());
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_COMPILE_CHANGES));
+    std::vector<std::string> log = takeFxcLog();
+    AMD_TEST_CHECK_EQUAL(log.size(), 1);
+    if (!log.empty()) AMD_TEST_CHECK(log[0].find("PS_Main_A=1_B=0.obj") != std::string::npos);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), 3);
+
+    // Cached objects are created without preprocessing; a shader without one still is
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_USE_CACHED));
+    AMD_TEST_CHECK_EQUAL(takeFxcLog().size(), 0);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), 3);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_IDLE), 1);
+
+    // A compile error leaves that shader in the error state, the others are still created
+    writeSource(L"States.hlsl", (std::string("#if A == 2\n#error broken on purpose\n#endif\n") + s_pSimpleSource).c_str());
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_COMPILE_CHANGES));
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_ERROR), 1);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), 2);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_IDLE), 1);
+    takeFxcLog();
+
+    // Forcing compiles everything that has a source again
+    writeSource(L"States.hlsl", s_pSimpleSource);
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_FORCE_COMPILE));
+    AMD_TEST_CHECK_EQUAL(takeFxcLog().size(), 3);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_CREATE), 3);
+    AMD_TEST_CHECK_EQUAL(cache.GetNumShadersInState(ShaderCache::SHADER_STATE_ERROR), 0);
+
+    for (int i = 0; i < 3; i++) SAFE_RELEASE(pPixelShaders[i]);
+}
+
+static const ShaderTelemetry::Record * findRecord(const std::vector<ShaderTelemetry::Record> & records, const wchar_t * pwsName)
+{
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        if (wcscmp(records[i].m_wsName, pwsName) == 0) return &records[i];
+    }
+    AMD_TEST_CHECK(!"no telemetry record");
+    return NULL;
+}
+
+// The times and cache results recorded for each generation. The stub fxc sleeps 30 ms per
+// compile, so compile times have a floor; the permutation with an #error is preprocessed by
+// fxc /P, its preprocess time is the run time of that process
+static void testTelemetry()
+{
+    writeSource(L"Telemetry.hlsl", "// STUB_FXC_SLEEP_MS=30\n#if A == 2\n#error broken on purpose\n#endif\nfloat4 PS_Telemetry() : SV_Target { return A; }\n");
+    DeleteFileW((s_wsRoot + L"/bin/ShaderTelemetry.jsonl").c_str());
+
+    ID3D11PixelShader * pPixelShaders[4] = { NULL, NULL, NULL, NULL };
+    ShaderCache cache(ShaderCache::SHADER_AUTO_RECOMPILE_DISABLED, ShaderCache::ERROR_DISPLAY_IN_DEBUG_OUTPUT);
+    for (int i = 0; i < 3; i++)
+    {
+        ShaderCache::Macro macros[] = { macro(L"A", i) };
+        AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pPixelShaders[i], ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PS_Telemetry", L"Telemetry.hlsl", 1, macros, NULL, NULL, 0));
+    }
+    AMD_TEST_CHECK(cache.AddShader((ID3D11DeviceChild **)&pPixelShaders[3], ShaderCache::SHADER_TYPE_PIXEL, L"ps_5_0", L"PS_Missing", L"Missing.hlsl", 0, NULL, NULL, NULL, 0));
+
+    std::vector<ShaderTelemetry::Record> records;
+    ShaderTelemetry::Summary summary;
+
+    // Never hashed: both good permutations miss and compile, the broken one compiles with an error
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_COMPILE_CHANGES));
+    cache.GetShaderTelemetry(records, summary);
+    AMD_TEST_CHECK_EQUAL(records.size(), 4);
+    for (int i = 0; i < 2; i++)
+    {
+        const ShaderTelemetry::Record * pRecord = findRecord(records, i == 0 ? L"PS_Telemetry_A=0" : L"PS_Telemetry_A=1");
+        if (!pRecord) continue;
+        AMD_TEST_CHECK_EQUAL(pRecord->m_eCacheResult, ShaderTelemetry::CACHE_RESULT_MISS_CHANGED);
+        AMD_TEST_CHECK(pRecord->m_bPreprocessedInProcess);
+        AMD_TEST_CHECK(pRecord->m_bCompiled);
+        AMD_TEST_CHECK(pRecord->m_uPreprocessBatch > 0 && pRecord->m_uCompileBatch > 0);
+        AMD_TEST_CHECK(pRecord->m_fPreprocessMs > 0.0);
+        AMD_TEST_CHECK(pRecord->m_fHashMs > 0.0);
+        AMD_TEST_CHECK(pRecord->m_fCompileMs >= 30.0);
+        AMD_TEST_CHECK_EQUAL(pRecord->m_uObjectSize, strlen("DXBC ps_5_0 PS_Telemetry A=0\n"));
+        AMD_TEST_CHECK_EQUAL(pRecord->m_uNumErrors, 0);
+    }
+    const ShaderTelemetry::Record * pBroken = findRecord(records, L"PS_Telemetry_A=2");
+    if (pBroken)
+    {
+        AMD_TEST_CHECK_EQUAL(pBroken->m_eCacheResult, ShaderTelemetry::CACHE_RESULT_MISS_CHANGED);
+        AMD_TEST_CHECK(!pBroken->m_bPreprocessedInProcess);
+        AMD_TEST_CHECK(pBroken->m_bCompiled);
+        AMD_TEST_CHECK(pBroken->m_fPreprocessMs > 0.0);
+        AMD_TEST_CHECK(pBroken->m_fCompileMs >= 30.0);
+        AMD_TEST_CHECK_EQUAL(pBroken->m_uObjectSize, 0);
+        AMD_TEST_CHECK_EQUAL(pBroken->m_uNumErrors, 1);
+    }
+    const ShaderTelemetry::Record * pMissing = findRecord(records, L"PS_Missing");
+    if (pMissing)
+    {
+        AMD_TEST_CHECK_EQUAL(pMissing->m_eCacheResult, ShaderTelemetry::CACHE_RESULT_MISS_SOURCE_NOT_FOUND);
+        AMD_TEST_CHECK(!pMissing->m_bCompiled);
+        AMD_TEST_CHECK_EQUAL(pMissing->m_fPreprocessMs + pMissing->m_fHashMs + pMissing->m_fCompileMs, 0.0);
+    }
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumCompiled, 3);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumWithErrors, 1);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumResults[ShaderTelemetry::CACHE_RESULT_MISS_CHANGED], 3);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumResults[ShaderTelemetry::CACHE_RESULT_MISS_SOURCE_NOT_FOUND], 1);
+    AMD_TEST_CHECK_NEAR(summary.m_fHitRate, 0.0, 1e-9);
+    AMD_TEST_CHECK(summary.m_fTotalCompileMs >= 90.0);
+    AMD_TEST_CHECK(summary.m_fCriticalPathMs >= 30.0);
+    AMD_TEST_CHECK(summary.m_uNumSlowest == 3 && records[summary.m_uSlowest[0]].m_bCompiled);
+
+    // The same telemetry is in the working directory, one line per shader and the summary
+    FILE * pFile = fopen(narrow(s_wsRoot + L"/bin/ShaderTelemetry.jsonl").c_str(), "rb");
+    AMD_TEST_CHECK(pFile != NULL);
+    if (pFile)
+    {
+        unsigned int uLines = 0;
+        bool bNotFound = false;
+        char line[4096];
+        while (fgets(line, sizeof(line), pFile))
+        {
+            uLines++;
+            bNotFound = bNotFound || strstr(line, "\"miss_source_not_found\"") != NULL;
+        }
+        fclose(pFile);
+        AMD_TEST_CHECK_EQUAL(uLines, 5);
+        AMD_TEST_CHECK(bNotFound);
+    }
+
+    // Unchanged: the good permutations hit, the broken one kept no hash and compiles again; the
+    // missing source counts as neither a hit nor a miss
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_COMPILE_CHANGES));
+    cache.GetShaderTelemetry(records, summary);
+    for (int i = 0; i < 2; i++)
+    {
+        const ShaderTelemetry::Record * pRecord = findRecord(records, i == 0 ? L"PS_Telemetry_A=0" : L"PS_Telemetry_A=1");
+        if (!pRecord) continue;
+        AMD_TEST_CHECK_EQUAL(pRecord->m_eCacheResult, ShaderTelemetry::CACHE_RESULT_HIT);
+        AMD_TEST_CHECK(!pRecord->m_bCompiled);
+        AMD_TEST_CHECK(pRecord->m_fHashMs > 0.0);
+        AMD_TEST_CHECK_EQUAL(pRecord->m_fCompileMs, 0.0);
+        AMD_TEST_CHECK_EQUAL(pRecord->m_uCompileBatch, 0);
+        AMD_TEST_CHECK(pRecord->m_uObjectSize > 0);
+    }
+    pBroken = findRecord(records, L"PS_Telemetry_A=2");
+    if (pBroken) AMD_TEST_CHECK_EQUAL(pBroken->m_eCacheResult, ShaderTelemetry::CACHE_RESULT_MISS_CHANGED);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumCompiled, 1);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumHits, 2);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumMisses, 1);
+    AMD_TEST_CHECK_NEAR(summary.m_fHitRate, 2.0 / 3.0, 1e-9);
+
+    // Cached: objects are reused unchecked, nothing is preprocessed for them
+    AMD_TEST_CHECK(generate(cache, ShaderCache::CREATE_TYPE_USE_CACHED));
+    cache.GetShaderTelemetry(records, summary);
+    for (int i = 0; i < 2; i++)
+    {
+        const ShaderTelemetry::Record * pRecord = findRecord(records, i == 0 ? L"PS_Telemetry_A=0" : L"PS_Telemetry_A=1");
+        if (!pRecord) continue;
+        AMD_TEST_CHECK_EQUAL(pRecord->m_eCacheResult, ShaderTelemetry::CACHE_RESULT_HIT_UNCHECKED);
+        AMD_TEST_CHECK_EQUAL(pRecord->m_uPreprocessBatch, 0);
+        AMD_TEST_CHECK_EQUAL(pRecord->m_fPreprocessMs + pRecord->m_fHashMs + pRecord->m_fCompileMs, 0.0);
+    }
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumResults[ShaderTelemetry::CACHE_RESULT_HIT_UNCHECKED], 2);
+
+    for (int i = 0; i < 4; i++) SAFE_RELEASE(pPixelShaders[i]);
+}
+
+int main()
+{
+    ID3D11Device * pDevice = NULL;
+    ID3D11DeviceContext * pContext = NULL;
+    AMD_TEST_CHECK_EQUAL(AOFX_CreateNullDevice(&pDevice, &pContext), AOFX_RETURN_CODE_SUCCESS);
+    CompatDXUT::device() = pDevice;
+
+    wchar_t wsCurrentDir[MAX_PATH];
+    GetCurrentDirectoryW(MAX_PATH, wsCurrentDir);
+
+    setUp();
+    testCommandLinesAndFileNames();
+    testPreprocessCommandLine();
+    testStates();
+    testTelemetry();
+
+    AMD_TEST_CHECK(chdir(narrow(wsCurrentDir).c_str()) == 0);
+    removeTree(s_wsRoot);
+
+    SAFE_RELEASE(pContext);
+    SAFE_RELEASE(pDevice);
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,510 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderDatabaseTest.cpp
+//
+// ShaderDatabase round trips, replaced (stale) records and their compaction, and recovery
+// from damaged files: bytes left behind the committed data by an interrupted append keep
+// the previous contents, a file that fails validation is recreated empty.
+//--------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ShaderDatabase.h"
+#include "crc.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const char * s_PathName = "ShaderDatabaseTest.db";
+static const wchar_t * s_wsPathName = L"ShaderDatabaseTest.db";
+
+// File layout, see ShaderDatabase.cpp
+static const long s_HeaderSize = 48;
+static const long s_NumEntriesOffset = 8;
+static const long s_IndexCRCOffset = 12;
+static const long s_IndexOffsetOffset = 16;
+static const long s_FileSizeOffset = 24;
+static const long s_IndexEntrySize = 48;
+static const long s_EntryOffsetOffset = 32;
+
+// A generation of shaders: the same keys with different hashes and contents
+struct Shaders
+{
+    std::vector<BYTE>                       m_Keys;
+    std::vector<BYTE>                       m_Hashes;
+    std::vector< std::vector<BYTE> >        m_Data;
+
+    Shaders(unsigned int uCount, unsigned int uGeneration)
+        : m_Keys(uCount * ShaderDatabase::m_uKEY_LENGTH), m_Hashes(uCount * ShaderDatabase::m_uHASH_LENGTH), m_Data(uCount)
+    {
+        for (unsigned int i = 0; i < uCount; i++)
+        {
+            // keys are appended out of order, the index has to sort them
+            unsigned int uKey = (i * 37) % uCount;
+            for (unsigned int j = 0; j < ShaderDatabase::m_uKEY_LENGTH; j++)
+            {
+                // the leading bytes spell the key number, so keys stay unique past 256 shaders
+                m_Keys[i * ShaderDatabase::m_uKEY_LENGTH + j] = (BYTE)(j < 4 ? uKey >> (j * 8) : uKey * 131 + j);
+                m_Hashes[i * ShaderDatabase::m_uHASH_LENGTH + j] = (BYTE)(uKey * 7 + j + uGeneration * 101);
+            }
+            m_Data[i].resize(1 + (uKey * 97 + uGeneration * 13) % 700);
+            for (size_t j = 0; j < m_Data[i].size(); j++)
+            {
+                m_Data[i][j] = (BYTE)(j * 3 + uKey + uGeneration * 59);
+            }
+        }
+    }
+
+    const BYTE * key(unsigned int i) const { return &m_Keys[i * ShaderDatabase::m_uKEY_LENGTH]; }
+    const BYTE * hash(unsigned int i) const { return &m_Hashes[i * ShaderDatabase::m_uHASH_LENGTH]; }
+
+    bool append(ShaderDatabase & database, unsigned int uFirst, unsigned int uCount) const
+    {
+        std::vector<ShaderDatabase::Record> records(uCount);
+        for (unsigned int i = 0; i < uCount; i++)
+        {
+            records[i].m_pKey = key(uFirst + i);
+            records[i].m_pHash = hash(uFirst + i);
+            records[i].m_pData = &m_Data[uFirst + i][0];
+            records[i].m_uSize = (unsigned int)m_Data[uFirst + i].size();
+        }
+        return database.Append(&records[0], uCount);
+    }
+
+    // true if the database holds exactly this generation's version of shader i
+    bool matches(const ShaderDatabase & database, unsigned int i) const
+    {
+        ShaderDatabase::Blob blob;
+        return database.Find(key(i), blob) &&
+               ((size_t)blob.m_pData % ShaderDatabase::m_uBLOB_ALIGNMENT) == 0 &&
+               memcmp(blob.m_pHash, hash(i), ShaderDatabase::m_uHASH_LENGTH) == 0 &&
+               blob.m_uSize == m_Data[i].size() &&
+               memcmp(blob.m_pData, &m_Data[i][0], blob.m_uSize) == 0;
+    }
+};
+
+static std::vector<BYTE> readFile()
+{
+    std::vector<BYTE> contents;
+    FILE * pFile = fopen(s_PathName, "rb");
+    if (pFile)
+    {
+        fseek(pFile, 0, SEEK_END);
+        contents.resize((size_t)ftell(pFile));
+        fseek(pFile, 0, SEEK_SET);
+        if (!contents.empty() && fread(&contents[0], contents.size(), 1, pFile) != 1) contents.clear();
+        fclose(pFile);
+    }
+    return contents;
+}
+
+static void writeFile(const std::vector<BYTE> & contents)
+{
+    FILE * pFile = fopen(s_PathName, "wb");
+    AMD_TEST_CHECK(pFile != NULL);
+    if (pFile)
+    {
+        if (!contents.empty()) fwrite(&contents[0], contents.size(), 1, pFile);
+        fclose(pFile);
+    }
+}
+
+template <class T> static T & field(std::vector<BYTE> & contents, size_t uOffset) { return *(T *)&contents[uOffset]; }
+
+// Recomputes the index CRC, so a damaged index entry is caught by the checks behind it
+static void resealIndex(std::vector<BYTE> & contents)
+{
+    UINT64 uIndexOffset = field<UINT64>(contents, s_IndexOffsetOffset);
+    DWORD uNumEntries = field<DWORD>(contents, s_NumEntriesOffset);
+    crcInit();
+    field<DWORD>(contents, s_IndexCRCOffset) = (DWORD)crcFast(&contents[(size_t)uIndexOffset], (int)(uNumEntries * s_IndexEntrySize));
+}
+
+//--------------------------------------------------------------------------------------
+// Round trip through Append, Find and a reopen, with enough shaders that the file and its
+// mapping grow many times, then a replacement of all of them and a compaction
+//--------------------------------------------------------------------------------------
+static void testAppendAndFind()
+{
+    remove(s_PathName);
+
+    // 37 and the count are coprime, every key is generated once
+    const unsigned int uCount = 4096;
+    Shaders shaders(uCount, 0);
+
+    ShaderDatabase database;
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK(database.IsOpen());
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), 0);
+    AMD_TEST_CHECK_EQUAL(database.GetFileSize(), s_HeaderSize);
+
+    // two commits of half the shaders each
+    AMD_TEST_CHECK(shaders.append(database, 0, uCount / 2));
+    AMD_TEST_CHECK(shaders.append(database, uCount / 2, uCount / 2));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(shaders.matches(database, i));
+    }
+
+    // the first commit's index is the only thing the second one left unreferenced
+    AMD_TEST_CHECK_EQUAL(database.GetGarbageSize(), uCount / 2 * s_IndexEntrySize);
+
+    BYTE unknownKey[ShaderDatabase::m_uKEY_LENGTH];
+    memset(unknownKey, 0xff, sizeof(unknownKey));
+    ShaderDatabase::Blob blob;
+    AMD_TEST_CHECK(!database.Find(unknownKey, blob));
+    AMD_TEST_CHECK(!database.Find(NULL, blob));
+
+    database.Close();
+    AMD_TEST_CHECK(!database.IsOpen());
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(shaders.matches(database, i));
+    }
+
+    // the next generation replaces every shader in commits of growing size, which leaves
+    // most of the file unreferenced
+    Shaders next(uCount, 1);
+    for (unsigned int uFirst = 0, uBatch = 1; uFirst < uCount; uFirst += uBatch, uBatch *= 2)
+    {
+        AMD_TEST_CHECK(next.append(database, uFirst, uBatch < uCount - uFirst ? uBatch : uCount - uFirst));
+    }
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    AMD_TEST_CHECK(database.NeedsCompaction());
+    UINT64 uFileSize = database.GetFileSize();
+
+    AMD_TEST_CHECK(database.Compact());
+    AMD_TEST_CHECK(!database.NeedsCompaction());
+    AMD_TEST_CHECK_EQUAL(database.GetGarbageSize(), 0);
+    AMD_TEST_CHECK(database.GetFileSize() * 2 < uFileSize);
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(next.matches(database, i));
+    }
+
+    database.Close();
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(next.matches(database, i));
+    }
+
+    database.Close();
+    remove(s_PathName);
+}
+
+//--------------------------------------------------------------------------------------
+// Replaced and removed records: never returned again, counted as garbage until Compact
+//--------------------------------------------------------------------------------------
+static void testStaleRecords()
+{
+    remove(s_PathName);
+
+    const unsigned int uCount = 48;
+    Shaders first(uCount, 0), second(uCount, 1);
+
+    ShaderDatabase database;
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK(first.append(database, 0, uCount));
+    UINT64 uGarbageSize = database.GetGarbageSize();
+    AMD_TEST_CHECK_EQUAL(uGarbageSize, 0);
+    AMD_TEST_CHECK(!database.NeedsCompaction());
+
+    // recompiling half of the shaders leaves their previous blobs behind
+    AMD_TEST_CHECK(second.append(database, 0, uCount / 2));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(i < uCount / 2 ? second.matches(database, i) : first.matches(database, i));
+        AMD_TEST_CHECK(i < uCount / 2 ? !first.matches(database, i) : !second.matches(database, i));
+    }
+    AMD_TEST_CHECK(database.GetGarbageSize() > uGarbageSize);
+    uGarbageSize = database.GetGarbageSize();
+
+    // replacing a shader twice in one commit keeps the last record
+    std::vector<ShaderDatabase::Record> records(2);
+    records[0].m_pKey = records[1].m_pKey = first.key(uCount - 1);
+    records[0].m_pHash = second.hash(uCount - 1);
+    records[0].m_pData = &second.m_Data[uCount - 1][0];
+    records[0].m_uSize = (unsigned int)second.m_Data[uCount - 1].size();
+    records[1].m_pHash = first.hash(uCount - 1);
+    records[1].m_pData = &first.m_Data[uCount - 1][0];
+    records[1].m_uSize = (unsigned int)first.m_Data[uCount - 1].size();
+    AMD_TEST_CHECK(database.Append(&records[0], 2));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    AMD_TEST_CHECK(first.matches(database, uCount - 1));
+    AMD_TEST_CHECK(database.GetGarbageSize() > uGarbageSize);
+
+    // removing the other half
+    std::vector<const BYTE *> removedKeys;
+    for (unsigned int i = uCount / 2; i < uCount; i++)
+    {
+        removedKeys.push_back(first.key(i));
+    }
+    AMD_TEST_CHECK(database.Remove(&removedKeys[0], (unsigned int)removedKeys.size()));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount / 2);
+    AMD_TEST_CHECK(database.NeedsCompaction());
+
+    // removing keys that are not stored changes nothing
+    BYTE unknownKey[ShaderDatabase::m_uKEY_LENGTH];
+    memset(unknownKey, 0xff, sizeof(unknownKey));
+    const BYTE * pUnknownKey = unknownKey;
+    AMD_TEST_CHECK(database.Remove(&pUnknownKey, 1));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount / 2);
+
+    // the stale records stay unreachable after a reopen
+    database.Close();
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount / 2);
+    UINT64 uFileSize = database.GetFileSize();
+    uGarbageSize = database.GetGarbageSize();
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        ShaderDatabase::Blob blob;
+        AMD_TEST_CHECK(i < uCount / 2 ? second.matches(database, i) : !database.Find(first.key(i), blob));
+    }
+
+    // compaction drops exactly the garbage
+    AMD_TEST_CHECK(database.Compact());
+    AMD_TEST_CHECK_EQUAL(database.GetGarbageSize(), 0);
+    AMD_TEST_CHECK(!database.NeedsCompaction());
+    AMD_TEST_CHECK(database.GetFileSize() <= uFileSize - uGarbageSize);
+    AMD_TEST_CHECK_EQUAL((UINT64)readFile().size(), database.GetFileSize());
+    for (unsigned int i = 0; i < uCount / 2; i++)
+    {
+        AMD_TEST_CHECK(second.matches(database, i));
+    }
+
+    database.Close();
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount / 2);
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        ShaderDatabase::Blob blob;
+        AMD_TEST_CHECK(i < uCount / 2 ? second.matches(database, i) : !database.Find(first.key(i), blob));
+    }
+
+    database.Close();
+    remove(s_PathName);
+}
+
+//--------------------------------------------------------------------------------------
+// An append interrupted before its header was written leaves blobs and an index behind
+// the committed size, the previous contents are what the next Open sees
+//--------------------------------------------------------------------------------------
+static void testInterruptedAppend()
+{
+    remove(s_PathName);
+
+    const unsigned int uCount = 32;
+    Shaders first(uCount, 0), second(uCount, 1);
+
+    ShaderDatabase database;
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK(first.append(database, 0, uCount));
+    UINT64 uCommittedSize = database.GetFileSize();
+    database.Close();
+
+    // the tail of a complete append of the second generation, without its header
+    std::vector<BYTE> committed = readFile();
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK(second.append(database, 0, uCount));
+    database.Close();
+    std::vector<BYTE> appended = readFile();
+    AMD_TEST_CHECK(appended.size() > committed.size());
+    memcpy(&appended[0], &committed[0], (size_t)s_HeaderSize);
+    writeFile(appended);
+
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    AMD_TEST_CHECK_EQUAL(database.GetFileSize(), uCommittedSize);
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(first.matches(database, i));
+    }
+
+    // the next append is written over the tail instead of behind it
+    AMD_TEST_CHECK(second.append(database, 0, 1));
+    AMD_TEST_CHECK(second.matches(database, 0));
+    AMD_TEST_CHECK(database.GetFileSize() < (UINT64)appended.size());
+    AMD_TEST_CHECK_EQUAL(readFile().size(), appended.size());
+
+    // a torn tail of garbage bytes is no different
+    database.Close();
+    std::vector<BYTE> torn = readFile();
+    torn.resize(torn.size() + 1000, 0xcd);
+    writeFile(torn);
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    AMD_TEST_CHECK(second.matches(database, 0));
+    for (unsigned int i = 1; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(first.matches(database, i));
+    }
+
+    database.Close();
+    remove(s_PathName);
+}
+
+//--------------------------------------------------------------------------------------
+// Every kind of damage Validate catches: the file is recreated empty and stays usable
+//--------------------------------------------------------------------------------------
+enum Damage
+{
+    DAMAGE_MAGIC,
+    DAMAGE_VERSION,
+    DAMAGE_INDEX_BYTE,
+    DAMAGE_INDEX_OFFSET,
+    DAMAGE_FILE_SIZE,
+    DAMAGE_TRUNCATED,
+    DAMAGE_TRUNCATED_HEADER,
+    DAMAGE_ENTRY_OFFSET,
+    DAMAGE_ENTRY_SIZE,
+    DAMAGE_ENTRY_ORDER,
+    DAMAGE_COUNT
+};
+
+static void damage(std::vector<BYTE> & contents, Damage eDamage)
+{
+    size_t uIndexOffset = (size_t)field<UINT64>(contents, s_IndexOffsetOffset);
+    switch (eDamage)
+    {
+    case DAMAGE_MAGIC:
+        contents[0] ^= 0x01;
+        break;
+    case DAMAGE_VERSION:
+        field<DWORD>(contents, 4) = ShaderDatabase::m_uVERSION + 1;
+        break;
+    case DAMAGE_INDEX_BYTE:
+        contents[uIndexOffset + s_IndexEntrySize + 5] ^= 0x5a;
+        break;
+    case DAMAGE_INDEX_OFFSET:
+        field<UINT64>(contents, s_IndexOffsetOffset) = field<UINT64>(contents, s_FileSizeOffset) - s_IndexEntrySize;
+        break;
+    case DAMAGE_FILE_SIZE:
+        field<UINT64>(contents, s_FileSizeOffset) = contents.size() + 1;
+        break;
+    case DAMAGE_TRUNCATED:
+        contents.resize(contents.size() - 1);
+        break;
+    case DAMAGE_TRUNCATED_HEADER:
+        contents.resize((size_t)s_HeaderSize - 1);
+        break;
+    case DAMAGE_ENTRY_OFFSET:
+        field<UINT64>(contents, uIndexOffset + s_EntryOffsetOffset) = 0;
+        resealIndex(contents);
+        break;
+    case DAMAGE_ENTRY_SIZE:
+        field<DWORD>(contents, uIndexOffset + s_EntryOffsetOffset + 8) = (DWORD)uIndexOffset;
+        resealIndex(contents);
+        break;
+    case DAMAGE_ENTRY_ORDER:
+        {
+            std::vector<BYTE> entry(&contents[uIndexOffset], &contents[uIndexOffset] + s_IndexEntrySize);
+            memcpy(&contents[uIndexOffset], &contents[uIndexOffset + s_IndexEntrySize], s_IndexEntrySize);
+            memcpy(&contents[uIndexOffset + s_IndexEntrySize], &entry[0], s_IndexEntrySize);
+            resealIndex(contents);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void testCorruptFiles()
+{
+    const unsigned int uCount = 16;
+    Shaders shaders(uCount, 0);
+
+    remove(s_PathName);
+    ShaderDatabase database;
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK(shaders.append(database, 0, uCount));
+    database.Close();
+    const std::vector<BYTE> intact = readFile();
+
+    for (int eDamage = 0; eDamage < DAMAGE_COUNT; eDamage++)
+    {
+        std::vector<BYTE> contents = intact;
+        damage(contents, (Damage)eDamage);
+        writeFile(contents);
+
+        AMD_TEST_CHECK(database.Open(s_wsPathName));
+        if (database.GetNumEntries() != 0)
+        {
+            printf("damage %d was not detected\n", eDamage);
+        }
+        AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), 0);
+        AMD_TEST_CHECK_EQUAL(database.GetFileSize(), s_HeaderSize);
+        AMD_TEST_CHECK_EQUAL(database.GetGarbageSize(), 0);
+        AMD_TEST_CHECK_EQUAL(readFile().size(), s_HeaderSize);
+
+        ShaderDatabase::Blob blob;
+        AMD_TEST_CHECK(!database.Find(shaders.key(0), blob));
+
+        // the recreated file takes new records and survives a reopen
+        AMD_TEST_CHECK(shaders.append(database, 0, 2));
+        database.Close();
+        AMD_TEST_CHECK(database.Open(s_wsPathName));
+        AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), 2);
+        AMD_TEST_CHECK(shaders.matches(database, 0));
+        AMD_TEST_CHECK(shaders.matches(database, 1));
+        database.Close();
+    }
+
+    // an empty file is a new database
+    writeFile(std::vector<BYTE>());
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), 0);
+    database.Close();
+
+    // the intact file still opens with everything in it
+    writeFile(intact);
+    AMD_TEST_CHECK(database.Open(s_wsPathName));
+    AMD_TEST_CHECK_EQUAL(database.GetNumEntries(), uCount);
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        AMD_TEST_CHECK(shaders.matches(database, i));
+    }
+
+    database.Close();
+    remove(s_PathName);
+}
+
+int main()
+{
+    testAppendAndFind();
+    testStaleRecords();
+    testInterruptedAppend();
+    testCorruptFiles();
+
+    return AMD_TEST_RESULT();
+}
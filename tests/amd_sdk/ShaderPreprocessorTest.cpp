@@ -0,0 +1,362 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderPreprocessorTest.cpp
+//
+// ShaderPreprocessor #if evaluation against the C rules (signedness, unevaluated operands),
+// and a golden suite: the sources in preprocessor/ with the output of a reference C
+// preprocessor (cpp -P -undef -nostdinc), compared token by token since the spacing differs,
+// and every AOFX shader permutation of the build .bat files against preprocessor/aofx.golden.
+//--------------------------------------------------------------------------------------
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ShaderPreprocessor.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const char * s_PathName = "ShaderPreprocessorTest.hlsl";
+static const wchar_t * s_wsPathName = L"ShaderPreprocessorTest.hlsl";
+
+static std::wstring widen(const std::string & text)
+{
+    return std::wstring(text.begin(), text.end());
+}
+
+static bool readFile(const std::string & pathName, std::string & text)
+{
+    FILE * pFile = fopen(pathName.c_str(), "rb");
+    if (pFile == NULL)
+    {
+        return false;
+    }
+
+    char buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    {
+        text.append(buffer, size);
+    }
+    fclose(pFile);
+    return true;
+}
+
+// C tokens, enough to compare preprocessor outputs that only differ in whitespace
+static std::vector<std::string> tokenize(const std::string & text)
+{
+    static const char * punctuators[] =
+    {
+        "<<=", ">>=", "...", "##", "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||",
+        "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "::",
+    };
+
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < text.size())
+    {
+        const size_t start = i;
+        const char c = text[i];
+        if (isspace((unsigned char)c))
+        {
+            i++;
+            continue;
+        }
+
+        if (c == '"' || c == '\'')
+        {
+            for (i++; i < text.size() && text[i] != c; i++)
+            {
+                i += (text[i] == '\\') ? 1 : 0;
+            }
+            i++;
+        }
+        else if (isalpha((unsigned char)c) || c == '_')
+        {
+            while (i < text.size() && (isalnum((unsigned char)text[i]) || text[i] == '_'))
+            {
+                i++;
+            }
+        }
+        else if (isdigit((unsigned char)c) || (c == '.' && i + 1 < text.size() && isdigit((unsigned char)text[i + 1])))
+        {
+            // a pp-number: exponent signs belong to it
+            for (i++; i < text.size(); i++)
+            {
+                if (strchr("eEpP", text[i - 1]) != NULL && (text[i] == '+' || text[i] == '-'))
+                {
+                    continue;
+                }
+                if (!isalnum((unsigned char)text[i]) && text[i] != '_' && text[i] != '.')
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            i++;
+            for (size_t p = 0; p < sizeof(punctuators) / sizeof(punctuators[0]); p++)
+            {
+                if (text.compare(start, strlen(punctuators[p]), punctuators[p]) == 0)
+                {
+                    i = start + strlen(punctuators[p]);
+                    break;
+                }
+            }
+        }
+
+        tokens.push_back(text.substr(start, i - start));
+    }
+
+    return tokens;
+}
+
+// Preprocesses "#if expression", returns -1 if the preprocessor rejected it
+static int evaluate(const char * pExpression)
+{
+    FILE * pFile = fopen(s_PathName, "wb");
+    fprintf(pFile, "#if %s\n1\n#else\n0\n#endif\n", pExpression);
+    fclose(pFile);
+
+    ShaderPreprocessor preprocessor;
+    std::string output;
+    if (!preprocessor.Preprocess(s_wsPathName, NULL, 0, output))
+    {
+        return -1;
+    }
+
+    const std::vector<std::string> tokens = tokenize(output);
+    return (tokens.size() == 1) ? atoi(tokens[0].c_str()) : -1;
+}
+
+static void testExpressions()
+{
+    // results of cpp for the same lines
+    static const struct { const char * m_pExpression; int m_Result; } expressions[] =
+    {
+        // signedness: intmax_t, or uintmax_t as soon as one operand is unsigned
+        { "(-1 < 0u) == 0", 1 },
+        { "-1 > 0u", 1 },
+        { "-1 < 0", 1 },
+        { "(0u - 1) >> 63 == 1", 1 },
+        { "-1 >> 63 == -1", 1 },
+        { "-1 / 2u == 0x7FFFFFFFFFFFFFFF", 1 },
+        { "-1 / 2 == 0", 1 },
+        { "-7 % 3 == -1", 1 },
+        { "0xFFFFFFFFFFFFFFFF > 0", 1 },
+        { "18446744073709551615 == -1", 1 },
+        { "(1 ? -1 : 0u) > 0", 1 },
+        { "(1 ? -1 : 0) > 0", 0 },
+        { "~0u > 0", 1 },
+        { "~0 < 0", 1 },
+        { "1u << 63 > 0", 1 },
+
+        // wrapping instead of overflowing
+        { "-0x7FFFFFFFFFFFFFFF - 1 < 0", 1 },
+        { "(-0x7FFFFFFFFFFFFFFF - 1) / -1 < 0", 1 },
+        { "1 << 63 < 0", 1 },
+
+        // operands that are not evaluated may divide by zero
+        { "1 ? 2 : (1/0)", 1 },
+        { "0 ? 1/0 : 3", 1 },
+        { "0 && 1/0", 0 },
+        { "1 || 1/0", 1 },
+        { "0 && (1 ? 2 : 1/0)", 0 },
+        { "(2 || 1/0) + (0 && 1/0) == 1", 1 },
+
+        { "'A' == 65", 1 },
+        { "UNDEFINED == 0", 1 },
+
+        // rejected
+        { "1/0", -1 },
+        { "0 || 1/0", -1 },
+        { "1 && 1 % 0", -1 },
+        { "0 ? 1 : 1/0", -1 },
+        { "(1", -1 },
+        { "1 ? 2", -1 },
+        { "1 +", -1 },
+    };
+
+    for (size_t i = 0; i < sizeof(expressions) / sizeof(expressions[0]); i++)
+    {
+        const int result = evaluate(expressions[i].m_pExpression);
+        if (result != expressions[i].m_Result)
+        {
+            printf("#if %s\n", expressions[i].m_pExpression);
+        }
+        AMD_TEST_CHECK_EQUAL(result, expressions[i].m_Result);
+    }
+
+    remove(s_PathName);
+}
+
+static void testGolden(ShaderPreprocessor & preprocessor, const char * pSource, const char * const * ppDefines,
+    unsigned int uNumDefines, const char * pExpected, size_t uNumDependencies)
+{
+    const std::string directory = AMD_TEST_DATA_DIR;
+    std::string expected;
+    AMD_TEST_CHECK(readFile(directory + "/" + pExpected, expected));
+
+    std::string output;
+    std::vector<std::wstring> dependencies;
+    const bool bResult = preprocessor.Preprocess(widen(directory + "/" + pSource).c_str(), ppDefines, uNumDefines, output, &dependencies);
+    if (!bResult)
+    {
+        printf("%s: %s\n", pSource, preprocessor.GetLastError());
+    }
+    AMD_TEST_CHECK(bResult);
+    AMD_TEST_CHECK_EQUAL(dependencies.size(), uNumDependencies);
+
+    const std::vector<std::string> actualTokens = tokenize(output);
+    const std::vector<std::string> expectedTokens = tokenize(expected);
+    size_t i = 0;
+    while (i < actualTokens.size() && i < expectedTokens.size() && actualTokens[i] == expectedTokens[i])
+    {
+        i++;
+    }
+    if (i < actualTokens.size() || i < expectedTokens.size())
+    {
+        printf("%s: token %d is '%s', expected '%s'\n", pExpected, (int)i,
+            i < actualTokens.size() ? actualTokens[i].c_str() : "",
+            i < expectedTokens.size() ? expectedTokens[i].c_str() : "");
+    }
+    AMD_TEST_CHECK(actualTokens == expectedTokens);
+}
+
+static void testGoldenSuite()
+{
+    // one preprocessor for all of them, the way the ShaderCache shares included files between permutations
+    ShaderPreprocessor preprocessor;
+
+    testGolden(preprocessor, "macros.hlsl", NULL, 0, "macros.expected", 1);
+
+    static const char * quality1[] = { "QUALITY=1", "USE_KERNEL" };
+    static const char * quality2[] = { "QUALITY=2", "USE_KERNEL" };
+    testGolden(preprocessor, "includes.hlsl", quality1, 2, "includes_quality1.expected", 4);
+    testGolden(preprocessor, "includes.hlsl", quality2, 2, "includes_quality2.expected", 4);
+
+    // #error in the active block
+    static const char * quality0[] = { "QUALITY=0" };
+    std::string output;
+    const std::string source = std::string(AMD_TEST_DATA_DIR) + "/includes.hlsl";
+    AMD_TEST_CHECK(!preprocessor.Preprocess(widen(source).c_str(), quality0, 1, output));
+}
+
+// 64 bit FNV-1a of the tokens, each followed by '\n', as written by preprocessor/aofx_goldens.py
+static unsigned long long fnv1a(const std::vector<std::string> & tokens)
+{
+    unsigned long long uDigest = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        const std::string token = tokens[i] + "\n";
+        for (size_t j = 0; j < token.size(); j++)
+        {
+            uDigest = (uDigest ^ (unsigned char)token[j]) * 0x100000001b3ull;
+        }
+    }
+    return uDigest;
+}
+
+//--------------------------------------------------------------------------------------
+// Every permutation of the AOFX build .bat files, preprocessed from the shaders in the tree,
+// against the token counts and digests of the cpp output in preprocessor/aofx.golden
+//--------------------------------------------------------------------------------------
+static void testAofxGoldens()
+{
+    std::string golden;
+    AMD_TEST_CHECK(readFile(std::string(AMD_TEST_DATA_DIR) + "/aofx.golden", golden));
+
+    ShaderPreprocessor preprocessor;
+    unsigned int uPermutations = 0, uMismatches = 0;
+    size_t uStart = 0;
+    while (uStart < golden.size())
+    {
+        size_t uEnd = golden.find('\n', uStart);
+        if (uEnd == std::string::npos)
+        {
+            uEnd = golden.size();
+        }
+        // the checkout may have CRLF line endings
+        const size_t uLength = (uEnd > uStart && golden[uEnd - 1] == '\r') ? uEnd - 1 - uStart : uEnd - uStart;
+        const std::string line = golden.substr(uStart, uLength);
+        uStart = uEnd + 1;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        // name source tokens fnv1a defines...
+        std::vector<std::string> fields;
+        for (size_t i = line.find_first_not_of(' '); i != std::string::npos; i = line.find_first_not_of(' ', i))
+        {
+            const size_t uFieldEnd = line.find(' ', i);
+            fields.push_back(line.substr(i, uFieldEnd - i));
+            i = uFieldEnd;
+        }
+        AMD_TEST_CHECK(fields.size() >= 4);
+        if (fields.size() < 4)
+        {
+            continue;
+        }
+
+        std::vector<const char *> defines;
+        for (size_t i = 4; i < fields.size(); i++)
+        {
+            defines.push_back(fields[i].c_str());
+        }
+
+        std::string output;
+        const std::string source = std::string(AMD_AOFX_SHADER_DIR) + "/" + fields[1];
+        const bool bResult = preprocessor.Preprocess(widen(source).c_str(), defines.empty() ? NULL : &defines[0], (unsigned int)defines.size(), output);
+        const std::vector<std::string> tokens = tokenize(output);
+        const unsigned long long uExpectedDigest = strtoull(fields[3].c_str(), NULL, 16);
+        if (!bResult || tokens.size() != strtoul(fields[2].c_str(), NULL, 10) || fnv1a(tokens) != uExpectedDigest)
+        {
+            // the first few are enough to find the cause, run aofx_goldens.py for the full cpp output
+            if (uMismatches++ < 4)
+            {
+                printf("%s: %s, %d tokens, expected %s\n", line.c_str(), bResult ? "different tokens" : preprocessor.GetLastError(),
+                    (int)tokens.size(), fields[2].c_str());
+            }
+        }
+        uPermutations++;
+    }
+
+    AMD_TEST_CHECK(uPermutations > 0);
+    AMD_TEST_CHECK_EQUAL(uMismatches, 0);
+}
+
+int main()
+{
+    testExpressions();
+    testGoldenSuite();
+    testAofxGoldens();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,288 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ShaderTelemetryTest.cpp
+//
+// ShaderTelemetry summaries and their JSON Lines output: every line is parsed back with a
+// strict JSON parser, names survive escaping and UTF-8 encoding, and the shader and summary
+// objects carry the fields and values the records and summary hold.
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ShaderTelemetry.h"
+#include "AMD_Test.h"
+#include "amd_sdk/TestJson.h"
+
+using namespace AMD;
+
+typedef ShaderTelemetry::Record Record;
+typedef ShaderTelemetry::Summary Summary;
+
+// Writes the records and their summary, and parses the lines back
+static std::vector<Json> writeAndParse(const Record * pRecords, unsigned int uNumRecords, const Summary & summary)
+{
+    FILE * pFile = tmpfile();
+    ShaderTelemetry::Write(pFile, pRecords, uNumRecords, summary);
+    rewind(pFile);
+
+    std::string text;
+    char buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    {
+        text.append(buffer, size);
+    }
+    fclose(pFile);
+
+    // one object per line, every line terminated
+    std::vector<Json> lines;
+    AMD_TEST_CHECK(!text.empty() && text[text.size() - 1] == '\n');
+    size_t start = 0;
+    for (size_t end = text.find('\n'); end != std::string::npos; end = text.find('\n', start))
+    {
+        lines.push_back(Json());
+        const std::string line = text.substr(start, end - start);
+        const bool bParsed = JsonParser(line).parse(lines.back());
+        if (!bParsed)
+        {
+            printf("not JSON: %s\n", line.c_str());
+        }
+        AMD_TEST_CHECK(bParsed);
+        AMD_TEST_CHECK_EQUAL(lines.back().m_Type, Json::OBJECT);
+        start = end + 1;
+    }
+    AMD_TEST_CHECK_EQUAL(start, text.size());
+
+    return lines;
+}
+
+static Record makeRecord(const wchar_t * pwsName, ShaderTelemetry::CACHE_RESULT eCacheResult, double fPreprocessMs, double fHashMs, double fCompileMs)
+{
+    Record record;
+    record.m_wsName = pwsName;
+    record.m_wsSourceFile = L"Shaders\\AMD_AOFX.hlsl";
+    record.Reset();
+    record.m_eCacheResult = eCacheResult;
+    record.m_fPreprocessMs = fPreprocessMs;
+    record.m_fHashMs = fHashMs;
+    record.m_fCompileMs = fCompileMs;
+    return record;
+}
+
+static void testRecords()
+{
+    // names that need escaping, and characters outside ASCII: e acute, the euro sign and an emoji,
+    // which is a surrogate pair where wchar_t is 16 bit
+    static const wchar_t s_wsName[] = L"CS_AO \"quoted\" back\\slash\ttab\x01 \x00e9\x20ac";
+    static const char s_Utf8Name[] = "CS_AO \"quoted\" back\\slash\ttab\x01 \xc3\xa9\xe2\x82\xac";
+    std::wstring emoji = (sizeof(wchar_t) == 2) ? std::wstring(1, (wchar_t)0xD83D) + (wchar_t)0xDE00 : std::wstring(1, (wchar_t)0x1F600);
+
+    Record records[3] =
+    {
+        makeRecord(s_wsName, ShaderTelemetry::CACHE_RESULT_MISS_CHANGED, 1.25, 0.5, 40.0),
+        makeRecord(emoji.c_str(), ShaderTelemetry::CACHE_RESULT_HIT_SHARED, 2.0, 0.25, 0.0),
+        makeRecord(NULL, ShaderTelemetry::CACHE_RESULT_NONE, 0.0, 0.0, 0.0),
+    };
+    records[0].m_bPreprocessedInProcess = true;
+    records[0].m_bCompiled = true;
+    records[0].m_uPreprocessBatch = 1;
+    records[0].m_uCompileBatch = 2;
+    records[0].m_uObjectSize = 4096;
+    records[0].m_uNumErrors = 3;
+    records[1].m_wsSourceFile = NULL;
+
+    Summary summary;
+    ShaderTelemetry::Summarize(records, 3, summary);
+    const std::vector<Json> lines = writeAndParse(records, 3, summary);
+    AMD_TEST_CHECK_EQUAL(lines.size(), 4);
+    if (lines.size() != 4)
+    {
+        return;
+    }
+
+    const Json & shader = lines[0];
+    AMD_TEST_CHECK(shader["type"].m_String == "shader");
+    AMD_TEST_CHECK(shader["name"].m_String == s_Utf8Name);
+    AMD_TEST_CHECK(shader["source"].m_String == "Shaders\\AMD_AOFX.hlsl");
+    AMD_TEST_CHECK(shader["cache"].m_String == "miss_changed");
+    AMD_TEST_CHECK_EQUAL(shader["in_process_preprocess"].m_Type, Json::BOOLEAN);
+    AMD_TEST_CHECK(shader["in_process_preprocess"].m_String == "true");
+    AMD_TEST_CHECK(shader["compiled"].m_String == "true");
+    AMD_TEST_CHECK_EQUAL(shader["preprocess_batch"].m_Number, 1);
+    AMD_TEST_CHECK_EQUAL(shader["compile_batch"].m_Number, 2);
+    AMD_TEST_CHECK_NEAR(shader["preprocess_ms"].m_Number, 1.25, 1e-9);
+    AMD_TEST_CHECK_NEAR(shader["hash_ms"].m_Number, 0.5, 1e-9);
+    AMD_TEST_CHECK_NEAR(shader["compile_ms"].m_Number, 40.0, 1e-9);
+    AMD_TEST_CHECK_EQUAL(shader["object_size"].m_Number, 4096);
+    AMD_TEST_CHECK_EQUAL(shader["errors"].m_Number, 3);
+    AMD_TEST_CHECK_EQUAL(shader.m_Object.size(), 13);
+
+    AMD_TEST_CHECK(lines[1]["name"].m_String == "\xf0\x9f\x98\x80");
+    AMD_TEST_CHECK(lines[1]["source"].m_String == "");
+    AMD_TEST_CHECK(lines[1]["cache"].m_String == "hit_shared");
+    AMD_TEST_CHECK(lines[1]["compiled"].m_String == "false");
+    AMD_TEST_CHECK_EQUAL(lines[2]["name"].m_Type, Json::STRING);
+    AMD_TEST_CHECK(lines[2]["cache"].m_String == "none");
+
+    const Json & total = lines[3];
+    AMD_TEST_CHECK(total["type"].m_String == "summary");
+    AMD_TEST_CHECK_EQUAL(total["shaders"].m_Number, 3);
+    AMD_TEST_CHECK_EQUAL(total["hits"].m_Number, 1);
+    AMD_TEST_CHECK_EQUAL(total["misses"].m_Number, 1);
+    AMD_TEST_CHECK_NEAR(total["hit_rate"].m_Number, 0.5, 1e-9);
+    AMD_TEST_CHECK_EQUAL(total["compiled"].m_Number, 1);
+    AMD_TEST_CHECK_EQUAL(total["with_errors"].m_Number, 1);
+    AMD_TEST_CHECK_NEAR(total["preprocess_ms"].m_Number, 3.25, 1e-9);
+    AMD_TEST_CHECK_NEAR(total["hash_ms"].m_Number, 0.75, 1e-9);
+    AMD_TEST_CHECK_NEAR(total["compile_ms"].m_Number, 40.0, 1e-9);
+    AMD_TEST_CHECK_EQUAL(total["object_size"].m_Number, 4096);
+
+    // every cache result is listed, by name
+    const Json & results = total["results"];
+    AMD_TEST_CHECK_EQUAL(results.m_Object.size(), ShaderTelemetry::CACHE_RESULT_MAX);
+    for (int i = 0; i < ShaderTelemetry::CACHE_RESULT_MAX; i++)
+    {
+        const Json & count = results[ShaderTelemetry::GetCacheResultName((ShaderTelemetry::CACHE_RESULT)i)];
+        AMD_TEST_CHECK_EQUAL(count.m_Type, Json::NUMBER);
+        AMD_TEST_CHECK_EQUAL(count.m_Number, summary.m_uNumResults[i]);
+    }
+
+    // shaders that took no time are not among the slowest
+    const Json & slowest = total["slowest"];
+    AMD_TEST_CHECK_EQUAL(slowest.m_Array.size(), 2);
+    if (slowest.m_Array.size() == 2)
+    {
+        AMD_TEST_CHECK(slowest.m_Array[0]["name"].m_String == s_Utf8Name);
+        AMD_TEST_CHECK_NEAR(slowest.m_Array[0]["total_ms"].m_Number, 41.75, 1e-9);
+        AMD_TEST_CHECK_NEAR(slowest.m_Array[1]["total_ms"].m_Number, 2.25, 1e-9);
+    }
+}
+
+static void testSummary()
+{
+    // more shaders than slowest slots, in two preprocess and two compile batches
+    static const unsigned int count = ShaderTelemetry::m_uNUM_SLOWEST + 6;
+    wchar_t names[count][16];
+    Record records[count];
+    for (unsigned int i = 0; i < count; i++)
+    {
+        swprintf(names[i], 16, L"PS_%u", i);
+        const double fMs = (double)((i * 7) % count) + 1.0;
+        records[i] = makeRecord(names[i], (i % 4 == 0) ? ShaderTelemetry::CACHE_RESULT_HIT : ShaderTelemetry::CACHE_RESULT_MISS_NO_OBJECT, fMs, 0.0, fMs * 10.0);
+        records[i].m_uPreprocessBatch = 1 + i % 2;
+        records[i].m_uCompileBatch = 1 + i / (count / 2);
+        records[i].m_bCompiled = true;
+    }
+    records[3].m_eCacheResult = ShaderTelemetry::CACHE_RESULT_MISS_SOURCE_NOT_FOUND;
+
+    Summary summary;
+    ShaderTelemetry::Summarize(records, count, summary);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumHits, 4);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumMisses, count - 5);
+    AMD_TEST_CHECK_NEAR(summary.m_fHitRate, 4.0 / (count - 1), 1e-12);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumResults[ShaderTelemetry::CACHE_RESULT_MISS_SOURCE_NOT_FOUND], 1);
+
+    // the critical path is the slowest shader of each batch, batches one after the other
+    double fPreprocess[2] = { 0.0, 0.0 };
+    double fCompile[2] = { 0.0, 0.0 };
+    for (unsigned int i = 0; i < count; i++)
+    {
+        double & fBatchPreprocess = fPreprocess[records[i].m_uPreprocessBatch - 1];
+        double & fBatchCompile = fCompile[records[i].m_uCompileBatch - 1];
+        fBatchPreprocess = (records[i].m_fPreprocessMs > fBatchPreprocess) ? records[i].m_fPreprocessMs : fBatchPreprocess;
+        fBatchCompile = (records[i].m_fCompileMs > fBatchCompile) ? records[i].m_fCompileMs : fBatchCompile;
+    }
+    AMD_TEST_CHECK_NEAR(summary.m_fCriticalPathMs, fPreprocess[0] + fPreprocess[1] + fCompile[0] + fCompile[1], 1e-9);
+
+    // the slowest, slowest first, and no others
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumSlowest, ShaderTelemetry::m_uNUM_SLOWEST);
+    for (unsigned int i = 0; i < summary.m_uNumSlowest; i++)
+    {
+        AMD_TEST_CHECK_NEAR(records[summary.m_uSlowest[i]].GetTotalMs(), (double)(count - i) * 11.0, 1e-9);
+    }
+
+    const std::vector<Json> lines = writeAndParse(records, count, summary);
+    AMD_TEST_CHECK_EQUAL(lines.size(), count + 1);
+    if (lines.size() == count + 1)
+    {
+        AMD_TEST_CHECK_EQUAL(lines[count]["slowest"].m_Array.size(), ShaderTelemetry::m_uNUM_SLOWEST);
+        AMD_TEST_CHECK_NEAR(lines[count]["critical_path_ms"].m_Number, summary.m_fCriticalPathMs, 1e-3);
+        AMD_TEST_CHECK_NEAR(lines[count]["hit_rate"].m_Number, summary.m_fHitRate, 1e-4);
+    }
+}
+
+static void testEmpty()
+{
+    Summary summary;
+    ShaderTelemetry::Summarize(NULL, 0, summary);
+    AMD_TEST_CHECK_EQUAL(summary.m_uNumShaders, 0);
+    AMD_TEST_CHECK_EQUAL(summary.m_fHitRate, 1);
+
+    // a summary line only
+    const std::vector<Json> lines = writeAndParse(NULL, 0, summary);
+    AMD_TEST_CHECK_EQUAL(lines.size(), 1);
+    if (lines.size() == 1)
+    {
+        AMD_TEST_CHECK(lines[0]["type"].m_String == "summary");
+        AMD_TEST_CHECK_EQUAL(lines[0]["hit_rate"].m_Number, 1);
+        AMD_TEST_CHECK_EQUAL(lines[0]["slowest"].m_Type, Json::ARRAY);
+        AMD_TEST_CHECK_EQUAL(lines[0]["slowest"].m_Array.size(), 0);
+    }
+}
+
+static void testFile()
+{
+    Record record = makeRecord(L"VS_FULLSCREEN", ShaderTelemetry::CACHE_RESULT_HIT, 1.0, 1.0, 0.0);
+    Summary summary;
+    ShaderTelemetry::Summarize(&record, 1, summary);
+
+    AMD_TEST_CHECK(ShaderTelemetry::Write(L"ShaderTelemetryTest.jsonl", &record, 1, summary));
+    FILE * pFile = fopen("ShaderTelemetryTest.jsonl", "rb");
+    AMD_TEST_CHECK(pFile != NULL);
+    if (pFile != NULL)
+    {
+        int numLines = 0;
+        for (int c = fgetc(pFile); c != EOF; c = fgetc(pFile))
+        {
+            numLines += (c == '\n') ? 1 : 0;
+        }
+        fclose(pFile);
+        AMD_TEST_CHECK_EQUAL(numLines, 2);
+    }
+    remove("ShaderTelemetryTest.jsonl");
+
+    AMD_TEST_CHECK(!ShaderTelemetry::Write(L"no_such_directory/ShaderTelemetryTest.jsonl", &record, 1, summary));
+}
+
+int main()
+{
+    testRecords();
+    testSummary();
+    testEmpty();
+    testFile();
+
+    return AMD_TEST_RESULT();
+}
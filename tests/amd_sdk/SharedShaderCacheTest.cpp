@@ -0,0 +1,643 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: SharedShaderCacheTest.cpp
+//
+// SharedShaderCache with concurrent writers. Every writer and reader is a child process
+// running this test binary again, all of them on one directory as on a share: fetched
+// objects are always complete, racing publishes of one key leave exactly one of the
+// candidates, no temporary file is left behind. Trim deletes the least recently used
+// objects and stale temporaries.
+//--------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SharedShaderCache.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const wchar_t * s_wsStore = L"SharedShaderCacheTest";
+static const wchar_t * s_wsWork = L"SharedShaderCacheTest.work";
+
+// Unique per index, the first byte spreads the keys over the fan out directories
+static void makeKey(unsigned int uKey, BYTE * pKey)
+{
+    for (unsigned int j = 0; j < SharedShaderCache::m_uKEY_LENGTH; j++)
+    {
+        pKey[j] = j < 4 ? (BYTE)(uKey >> (j * 8)) : (BYTE)(uKey * 131 + j * 17);
+    }
+}
+
+// Objects are large enough for a torn copy to be seen, writers of one key may disagree on the contents
+static std::vector<BYTE> makeObject(unsigned int uKey, unsigned int uWriter, size_t uSize)
+{
+    std::vector<BYTE> object(uSize);
+    for (size_t j = 0; j < uSize; j++)
+    {
+        object[j] = (BYTE)(uKey * 7 + uWriter * 29 + j * 13);
+    }
+    return object;
+}
+
+static std::wstring workPathName(unsigned int uThread, unsigned int uKey)
+{
+    wchar_t wsPathName[SharedShaderCache::m_uPATHNAME_MAX_LENGTH];
+    swprintf_s(wsPathName, SharedShaderCache::m_uPATHNAME_MAX_LENGTH, L"%s\\%u.%u.obj", s_wsWork, uThread, uKey);
+    return wsPathName;
+}
+
+// The documented layout: Directory\XX\<key>.obj
+static std::wstring objectPathName(const wchar_t * pwsStore, const BYTE * pKey)
+{
+    wchar_t wsKey[SharedShaderCache::m_uKEY_LENGTH * 2 + 1];
+    for (unsigned int i = 0; i < SharedShaderCache::m_uKEY_LENGTH; i++)
+    {
+        swprintf_s(&wsKey[i * 2], 3, L"%02x", pKey[i]);
+    }
+    wchar_t wsPathName[SharedShaderCache::m_uPATHNAME_MAX_LENGTH];
+    swprintf_s(wsPathName, SharedShaderCache::m_uPATHNAME_MAX_LENGTH, L"%s\\%.2s\\%s.obj", pwsStore, wsKey, wsKey);
+    return wsPathName;
+}
+
+static bool writeFile(const std::wstring & pathName, const std::vector<BYTE> & contents)
+{
+    HANDLE hFile = CreateFileW(pathName.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == hFile) return false;
+    DWORD uWritten = 0;
+    BOOL bWritten = WriteFile(hFile, &contents[0], (DWORD)contents.size(), &uWritten, NULL);
+    CloseHandle(hFile);
+    return bWritten && uWritten == contents.size();
+}
+
+static std::vector<BYTE> readFile(const std::wstring & pathName)
+{
+    std::vector<BYTE> contents;
+    HANDLE hFile = CreateFileW(pathName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == hFile) return contents;
+    BYTE buffer[4096];
+    DWORD uRead = 0;
+    while (ReadFile(hFile, buffer, sizeof(buffer), &uRead, NULL) && uRead > 0)
+    {
+        contents.insert(contents.end(), buffer, buffer + uRead);
+    }
+    CloseHandle(hFile);
+    return contents;
+}
+
+static void setFileTime(const std::wstring & pathName, UINT64 uAgeSeconds)
+{
+    FILETIME time;
+    GetSystemTimeAsFileTime(&time);
+    UINT64 uTime = (((UINT64)time.dwHighDateTime << 32) | time.dwLowDateTime) - uAgeSeconds * 10000000ull;
+    time.dwLowDateTime = (DWORD)uTime;
+    time.dwHighDateTime = (DWORD)(uTime >> 32);
+
+    HANDLE hFile = CreateFileW(pathName.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    AMD_TEST_CHECK(INVALID_HANDLE_VALUE != hFile);
+    if (INVALID_HANDLE_VALUE != hFile)
+    {
+        AMD_TEST_CHECK(SetFileTime(hFile, NULL, &time, &time));
+        CloseHandle(hFile);
+    }
+}
+
+// Counts (or deletes) the files below a directory whose name ends in the given extension
+static unsigned int walk(const std::wstring & directory, const wchar_t * pwsExtension, bool bDelete)
+{
+    unsigned int uCount = 0;
+    WIN32_FIND_DATAW data;
+    HANDLE hFind = FindFirstFileW((directory + L"\\*").c_str(), &data);
+    if (INVALID_HANDLE_VALUE == hFind) return 0;
+    do
+    {
+        std::wstring name = data.cFileName;
+        if (name == L"." || name == L"..") continue;
+        std::wstring pathName = directory + L"\\" + name;
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            uCount += walk(pathName, pwsExtension, bDelete);
+            if (bDelete) RemoveDirectoryW(pathName.c_str());
+        }
+        else if (NULL == pwsExtension || (name.size() > wcslen(pwsExtension) && name.compare(name.size() - wcslen(pwsExtension), std::wstring::npos, pwsExtension) == 0))
+        {
+            uCount++;
+            if (bDelete) DeleteFileW(pathName.c_str());
+        }
+    }
+    while (FindNextFileW(hFind, &data));
+    FindClose(hFind);
+    return uCount;
+}
+
+static void removeTree(const wchar_t * pwsDirectory)
+{
+    walk(pwsDirectory, NULL, true);
+    RemoveDirectoryW(pwsDirectory);
+}
+
+static void resetDirectories()
+{
+    removeTree(s_wsStore);
+    removeTree(s_wsWork);
+    AMD_TEST_CHECK(CreateDirectoryW(s_wsWork, NULL));
+}
+
+static void testArguments()
+{
+    resetDirectories();
+
+    SharedShaderCache cache;
+    BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+    makeKey(0, key);
+
+    AMD_TEST_CHECK(!cache.IsOpen());
+    AMD_TEST_CHECK(!cache.Fetch(key, workPathName(0, 0).c_str()));
+    AMD_TEST_CHECK(!cache.Open(L"", 16));
+    AMD_TEST_CHECK(!cache.Open(s_wsStore, 0));
+
+    // a trailing separator is accepted, the store directory is created
+    AMD_TEST_CHECK(cache.Open((std::wstring(s_wsStore) + L"\\").c_str(), 16));
+    AMD_TEST_CHECK(cache.IsOpen());
+    AMD_TEST_CHECK_EQUAL(cache.GetMaxSize(), 16ull << 20);
+    AMD_TEST_CHECK(GetFileAttributesW(s_wsStore) & FILE_ATTRIBUTE_DIRECTORY);
+
+    // a miss, then a round trip to the documented path name
+    AMD_TEST_CHECK(!cache.Fetch(key, workPathName(0, 1).c_str()));
+    std::vector<BYTE> object = makeObject(0, 0, 1000);
+    AMD_TEST_CHECK(writeFile(workPathName(0, 0), object));
+    AMD_TEST_CHECK(cache.Publish(key, workPathName(0, 0).c_str()));
+    AMD_TEST_CHECK(readFile(objectPathName(s_wsStore, key)) == object);
+    AMD_TEST_CHECK(cache.Fetch(key, workPathName(0, 1).c_str()));
+    AMD_TEST_CHECK(readFile(workPathName(0, 1)) == object);
+
+    // publishing an existing key keeps the stored object
+    AMD_TEST_CHECK(writeFile(workPathName(0, 2), makeObject(0, 1, 1000)));
+    AMD_TEST_CHECK(cache.Publish(key, workPathName(0, 2).c_str()));
+    AMD_TEST_CHECK(readFile(objectPathName(s_wsStore, key)) == object);
+
+    // a missing source publishes nothing
+    BYTE otherKey[SharedShaderCache::m_uKEY_LENGTH];
+    makeKey(1, otherKey);
+    AMD_TEST_CHECK(!cache.Publish(otherKey, workPathName(0, 99).c_str()));
+    AMD_TEST_CHECK_EQUAL(walk(s_wsStore, L".tmp", false), 0);
+    AMD_TEST_CHECK_EQUAL(walk(s_wsStore, L".obj", false), 1);
+
+    cache.Close();
+    AMD_TEST_CHECK(!cache.IsOpen());
+    AMD_TEST_CHECK(!cache.Publish(otherKey, workPathName(0, 0).c_str()));
+}
+
+//--------------------------------------------------------------------------------------
+// Child processes: the test binary is run again with a role and its arguments on the
+// command line. Children tell the parent they opened the store with a .ready file in the
+// work directory, and wait for the parent's start file, so all of them race on the store.
+//--------------------------------------------------------------------------------------
+static std::wstring flagPathName(const wchar_t * pwsName)
+{
+    return std::wstring(s_wsWork) + L"\\" + pwsName;
+}
+
+static bool isFlagSet(const wchar_t * pwsName)
+{
+    return INVALID_FILE_ATTRIBUTES != GetFileAttributesW(flagPathName(pwsName).c_str());
+}
+
+static void setFlag(const wchar_t * pwsName)
+{
+    AMD_TEST_CHECK(writeFile(flagPathName(pwsName), std::vector<BYTE>(1, 0)));
+}
+
+static void signalReady(unsigned int uProcess)
+{
+    wchar_t wsName[64];
+    swprintf_s(wsName, 64, L"%u.ready", uProcess);
+    setFlag(wsName);
+}
+
+static void waitForFlag(const wchar_t * pwsName)
+{
+    while (!isFlagSet(pwsName))
+    {
+        std::this_thread::yield();
+    }
+}
+
+static HANDLE spawnChild(const wchar_t * pwsArguments)
+{
+    wchar_t wsExecutable[SharedShaderCache::m_uPATHNAME_MAX_LENGTH];
+    AMD_TEST_CHECK(GetModuleFileNameW(NULL, wsExecutable, SharedShaderCache::m_uPATHNAME_MAX_LENGTH) > 0);
+
+    // CreateProcessW may write to the command line
+    wchar_t wsCommandLine[SharedShaderCache::m_uPATHNAME_MAX_LENGTH * 2];
+    swprintf_s(wsCommandLine, SharedShaderCache::m_uPATHNAME_MAX_LENGTH * 2, L"\"%s\" %s", wsExecutable, pwsArguments);
+
+    STARTUPINFOW startupInfo;
+    memset(&startupInfo, 0, sizeof(startupInfo));
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo;
+    if (!CreateProcessW(wsExecutable, wsCommandLine, NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &processInfo))
+    {
+        AMD_TEST_CHECK(!"CreateProcessW failed");
+        return NULL;
+    }
+    CloseHandle(processInfo.hThread);
+    return processInfo.hProcess;
+}
+
+// The exit code of the child, which is not 0 if any of its checks failed
+static DWORD waitForChild(HANDLE hProcess)
+{
+    DWORD uExitCode = 1;
+    if (NULL == hProcess) return uExitCode;
+    AMD_TEST_CHECK_EQUAL(WaitForSingleObject(hProcess, INFINITE), WAIT_OBJECT_0);
+    AMD_TEST_CHECK(GetExitCodeProcess(hProcess, &uExitCode));
+    CloseHandle(hProcess);
+    return uExitCode;
+}
+
+static void waitForReadyChildren(unsigned int uChildren)
+{
+    while (walk(s_wsWork, L".ready", false) < uChildren)
+    {
+        std::this_thread::yield();
+    }
+}
+
+//--------------------------------------------------------------------------------------
+// Many writers, one correct object per key: each process compiles what it cannot fetch
+//--------------------------------------------------------------------------------------
+static const unsigned int s_uWriterKeys = 64, s_uWriterPasses = 2;
+
+struct WriterCounts
+{
+    unsigned int m_uFetched;
+    unsigned int m_uPublished;
+    unsigned int m_uCorruptFetches;
+    unsigned int m_uFailedPublishes;
+};
+
+static std::wstring writerCountsPathName(unsigned int uProcess)
+{
+    wchar_t wsName[64];
+    swprintf_s(wsName, 64, L"%u.counts", uProcess);
+    return flagPathName(wsName);
+}
+
+static void runWriter(unsigned int uProcess)
+{
+    SharedShaderCache cache;
+    AMD_TEST_CHECK(cache.Open(s_wsStore, 64));
+    signalReady(uProcess);
+    waitForFlag(L"start");
+
+    WriterCounts counts;
+    memset(&counts, 0, sizeof(counts));
+    for (unsigned int uPass = 0; uPass < s_uWriterPasses; uPass++)
+    {
+        for (unsigned int i = 0; i < s_uWriterKeys; i++)
+        {
+            // every process walks the keys in its own order
+            unsigned int uKey = (i * 13 + uProcess * 7) % s_uWriterKeys;
+            BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+            makeKey(uKey, key);
+            std::vector<BYTE> object = makeObject(uKey, 0, 16384 + uKey * 512);
+            std::wstring pathName = workPathName(uProcess, uKey);
+
+            if (cache.Fetch(key, pathName.c_str()))
+            {
+                counts.m_uFetched++;
+                if (readFile(pathName) != object) counts.m_uCorruptFetches++;
+            }
+            else
+            {
+                counts.m_uPublished++;
+                if (!writeFile(pathName, object) || !cache.Publish(key, pathName.c_str())) counts.m_uFailedPublishes++;
+            }
+        }
+    }
+    cache.Trim();
+
+    const BYTE * pCounts = (const BYTE *)&counts;
+    AMD_TEST_CHECK(writeFile(writerCountsPathName(uProcess), std::vector<BYTE>(pCounts, pCounts + sizeof(counts))));
+}
+
+static void testConcurrentWriters()
+{
+    resetDirectories();
+
+    const unsigned int uProcesses = 8;
+    std::vector<HANDLE> children;
+    for (unsigned int uProcess = 0; uProcess < uProcesses; uProcess++)
+    {
+        wchar_t wsArguments[64];
+        swprintf_s(wsArguments, 64, L"writer %u", uProcess);
+        children.push_back(spawnChild(wsArguments));
+    }
+    waitForReadyChildren(uProcesses);
+    setFlag(L"start");
+
+    unsigned int uFailedChildren = 0;
+    WriterCounts total;
+    memset(&total, 0, sizeof(total));
+    for (unsigned int uProcess = 0; uProcess < uProcesses; uProcess++)
+    {
+        if (waitForChild(children[uProcess]) != 0) uFailedChildren++;
+
+        std::vector<BYTE> contents = readFile(writerCountsPathName(uProcess));
+        AMD_TEST_CHECK_EQUAL(contents.size(), sizeof(WriterCounts));
+        if (contents.size() != sizeof(WriterCounts)) continue;
+        WriterCounts counts;
+        memcpy(&counts, &contents[0], sizeof(counts));
+        total.m_uFetched += counts.m_uFetched;
+        total.m_uPublished += counts.m_uPublished;
+        total.m_uCorruptFetches += counts.m_uCorruptFetches;
+        total.m_uFailedPublishes += counts.m_uFailedPublishes;
+    }
+
+    AMD_TEST_CHECK_EQUAL(uFailedChildren, 0);
+    AMD_TEST_CHECK_EQUAL(total.m_uCorruptFetches, 0);
+    AMD_TEST_CHECK_EQUAL(total.m_uFailedPublishes, 0);
+    AMD_TEST_CHECK_EQUAL(total.m_uFetched + total.m_uPublished, uProcesses * s_uWriterKeys * s_uWriterPasses);
+    AMD_TEST_CHECK(total.m_uPublished >= s_uWriterKeys);
+
+    // the second pass of every process only fetches
+    AMD_TEST_CHECK(total.m_uFetched >= uProcesses * s_uWriterKeys * (s_uWriterPasses - 1));
+
+    AMD_TEST_CHECK_EQUAL(walk(s_wsStore, L".tmp", false), 0);
+    AMD_TEST_CHECK_EQUAL(walk(s_wsStore, L".obj", false), s_uWriterKeys);
+
+    SharedShaderCache cache;
+    AMD_TEST_CHECK(cache.Open(s_wsStore, 64));
+    for (unsigned int uKey = 0; uKey < s_uWriterKeys; uKey++)
+    {
+        BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+        makeKey(uKey, key);
+        AMD_TEST_CHECK(cache.Fetch(key, workPathName(uProcesses, uKey).c_str()));
+        AMD_TEST_CHECK(readFile(workPathName(uProcesses, uKey)) == makeObject(uKey, 0, 16384 + uKey * 512));
+    }
+}
+
+//--------------------------------------------------------------------------------------
+// Writers racing on one key with different objects (e.g. a nondeterministic compiler):
+// the first rename wins, readers see the winner or nothing, never a mix
+//--------------------------------------------------------------------------------------
+static const unsigned int s_uConflictingWriters = 6, s_uConflictReaders = 2;
+
+static std::vector<BYTE> conflictCandidate(unsigned int uRound, unsigned int uWriter)
+{
+    return makeObject(uRound, uWriter, 32768 + uWriter * 4096);
+}
+
+static void runConflictingWriter(unsigned int uRound, unsigned int uWriter)
+{
+    BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+    makeKey(uRound, key);
+
+    SharedShaderCache cache;
+    AMD_TEST_CHECK(cache.Open(s_wsStore, 64));
+    signalReady(uWriter);
+    waitForFlag(L"start");
+    AMD_TEST_CHECK(cache.Publish(key, workPathName(uWriter, uRound).c_str()));
+}
+
+static void runConflictReader(unsigned int uRound, unsigned int uReader)
+{
+    BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+    makeKey(uRound, key);
+
+    std::vector< std::vector<BYTE> > candidates;
+    for (unsigned int uWriter = 0; uWriter < s_uConflictingWriters; uWriter++)
+    {
+        candidates.push_back(conflictCandidate(uRound, uWriter));
+    }
+
+    SharedShaderCache cache;
+    AMD_TEST_CHECK(cache.Open(s_wsStore, 64));
+    std::wstring pathName = workPathName(s_uConflictingWriters + uReader, uRound);
+    signalReady(s_uConflictingWriters + uReader);
+    waitForFlag(L"start");
+
+    unsigned int uTornFetches = 0;
+    bool bPublished;
+    do
+    {
+        // the flag is read before the fetch, so the last fetch sees a published object
+        bPublished = isFlagSet(L"published");
+        if (cache.Fetch(key, pathName.c_str()))
+        {
+            std::vector<BYTE> fetched = readFile(pathName);
+            bool bCandidate = false;
+            for (size_t i = 0; i < candidates.size(); i++)
+            {
+                bCandidate = bCandidate || (fetched == candidates[i]);
+            }
+            if (!bCandidate) uTornFetches++;
+        }
+        else
+        {
+            AMD_TEST_CHECK(!bPublished);
+        }
+    }
+    while (!bPublished);
+
+    AMD_TEST_CHECK_EQUAL(uTornFetches, 0);
+}
+
+static void testConflictingWriters()
+{
+    const unsigned int uRounds = 20;
+    unsigned int uFailedChildren = 0, uWrongWinners = 0;
+
+    for (unsigned int uRound = 0; uRound < uRounds; uRound++)
+    {
+        resetDirectories();
+
+        BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+        makeKey(uRound, key);
+
+        std::vector< std::vector<BYTE> > candidates;
+        for (unsigned int uWriter = 0; uWriter < s_uConflictingWriters; uWriter++)
+        {
+            candidates.push_back(conflictCandidate(uRound, uWriter));
+            AMD_TEST_CHECK(writeFile(workPathName(uWriter, uRound), candidates.back()));
+        }
+
+        std::vector<HANDLE> writers, readers;
+        for (unsigned int uWriter = 0; uWriter < s_uConflictingWriters; uWriter++)
+        {
+            wchar_t wsArguments[64];
+            swprintf_s(wsArguments, 64, L"conflicting-writer %u %u", uRound, uWriter);
+            writers.push_back(spawnChild(wsArguments));
+        }
+        for (unsigned int uReader = 0; uReader < s_uConflictReaders; uReader++)
+        {
+            wchar_t wsArguments[64];
+            swprintf_s(wsArguments, 64, L"conflict-reader %u %u", uRound, uReader);
+            readers.push_back(spawnChild(wsArguments));
+        }
+
+        waitForReadyChildren(s_uConflictingWriters + s_uConflictReaders);
+        setFlag(L"start");
+        for (size_t i = 0; i < writers.size(); i++)
+        {
+            if (waitForChild(writers[i]) != 0) uFailedChildren++;
+        }
+        setFlag(L"published");
+        for (size_t i = 0; i < readers.size(); i++)
+        {
+            if (waitForChild(readers[i]) != 0) uFailedChildren++;
+        }
+
+        // exactly one of the candidates is stored, and it is not replaced by a later publish
+        std::vector<BYTE> stored = readFile(objectPathName(s_wsStore, key));
+        unsigned int uMatches = 0;
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            uMatches += (stored == candidates[i]) ? 1 : 0;
+        }
+        if (uMatches != 1) uWrongWinners++;
+
+        AMD_TEST_CHECK_EQUAL(walk(s_wsStore, L".tmp", false), 0);
+        AMD_TEST_CHECK_EQUAL(walk(s_wsStore, L".obj", false), 1);
+    }
+
+    AMD_TEST_CHECK_EQUAL(uFailedChildren, 0);
+    AMD_TEST_CHECK_EQUAL(uWrongWinners, 0);
+}
+
+//--------------------------------------------------------------------------------------
+// Trim deletes the least recently used objects down to 90% of the limit, and temporary files
+// an hour old, while fresh temporary files may still be renamed by their writer
+//--------------------------------------------------------------------------------------
+static void testTrim()
+{
+    resetDirectories();
+
+    const unsigned int uObjects = 300, uObjectSize = 10240, uRecent = 20;
+    SharedShaderCache cache;
+    AMD_TEST_CHECK(cache.Open(s_wsStore, 1));
+
+    // nothing published, nothing to trim
+    cache.Trim();
+
+    std::vector<BYTE> object = makeObject(0, 0, uObjectSize);
+    AMD_TEST_CHECK(writeFile(workPathName(0, 0), object));
+    for (unsigned int i = 0; i < uObjects; i++)
+    {
+        BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+        makeKey(1000 + i, key);
+        AMD_TEST_CHECK(cache.Publish(key, workPathName(0, 0).c_str()));
+
+        // published one second apart, in order, regardless of the timestamp resolution
+        setFileTime(objectPathName(s_wsStore, key), 1000 + uObjects - i);
+    }
+
+    // the oldest objects are used again
+    for (unsigned int i = 0; i < uRecent; i++)
+    {
+        BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+        makeKey(1000 + i, key);
+        AMD_TEST_CHECK(cache.Fetch(key, workPathName(0, 1).c_str()));
+    }
+
+    // a temporary file left by a process that died while publishing, and one being written now
+    BYTE deadKey[SharedShaderCache::m_uKEY_LENGTH], liveKey[SharedShaderCache::m_uKEY_LENGTH];
+    makeKey(1000, deadKey);
+    makeKey(1001, liveKey);
+    std::wstring deadPathName = objectPathName(s_wsStore, deadKey) + L".1.1.tmp";
+    std::wstring livePathName = objectPathName(s_wsStore, liveKey) + L".1.2.tmp";
+    AMD_TEST_CHECK(writeFile(deadPathName, object));
+    AMD_TEST_CHECK(writeFile(livePathName, object));
+    setFileTime(deadPathName, 2 * 60 * 60);
+
+    cache.Trim();
+
+    AMD_TEST_CHECK(INVALID_FILE_ATTRIBUTES == GetFileAttributesW(deadPathName.c_str()));
+    AMD_TEST_CHECK(INVALID_FILE_ATTRIBUTES != GetFileAttributesW(livePathName.c_str()));
+
+    unsigned int uStored = walk(s_wsStore, L".obj", false);
+    AMD_TEST_CHECK((UINT64)uStored * uObjectSize <= cache.GetMaxSize() / 100 * 90);
+    AMD_TEST_CHECK((UINT64)(uStored + 1) * uObjectSize > cache.GetMaxSize() / 100 * 90);
+
+    // the recently used objects and the newest ones are kept, the oldest unused ones are gone
+    for (unsigned int i = 0; i < uObjects; i++)
+    {
+        BYTE key[SharedShaderCache::m_uKEY_LENGTH];
+        makeKey(1000 + i, key);
+        bool bKept = INVALID_FILE_ATTRIBUTES != GetFileAttributesW(objectPathName(s_wsStore, key).c_str());
+        AMD_TEST_CHECK(bKept == (i < uRecent || i >= uObjects - (uStored - uRecent)));
+    }
+
+    // a trim without a publish since the last one does not scan
+    AMD_TEST_CHECK(writeFile(deadPathName, object));
+    setFileTime(deadPathName, 2 * 60 * 60);
+    cache.Trim();
+    AMD_TEST_CHECK(INVALID_FILE_ATTRIBUTES != GetFileAttributesW(deadPathName.c_str()));
+}
+
+// Runs a child process role, see spawnChild
+static int runChild(int argc, char ** argv)
+{
+    if (argc == 3 && strcmp(argv[1], "writer") == 0)
+    {
+        runWriter((unsigned int)atoi(argv[2]));
+    }
+    else if (argc == 4 && strcmp(argv[1], "conflicting-writer") == 0)
+    {
+        runConflictingWriter((unsigned int)atoi(argv[2]), (unsigned int)atoi(argv[3]));
+    }
+    else if (argc == 4 && strcmp(argv[1], "conflict-reader") == 0)
+    {
+        runConflictReader((unsigned int)atoi(argv[2]), (unsigned int)atoi(argv[3]));
+    }
+    else
+    {
+        AMD_TEST_CHECK(!"unknown child role");
+    }
+    return AMD_TEST_RESULT();
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc > 1)
+    {
+        return runChild(argc, argv);
+    }
+
+    testArguments();
+    testConcurrentWriters();
+    testConflictingWriters();
+    testTrim();
+
+    removeTree(s_wsStore);
+    removeTree(s_wsWork);
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: StringPoolTest.cpp
+//
+// StringPool interning: equal strings share one address whatever buffer they came from,
+// different strings never do, and pooled strings keep their address and contents while
+// the pool grows, until Clear().
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <vector>
+
+#include "StringPool.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static std::wstring shaderName(int i)
+{
+    wchar_t name[64];
+    swprintf(name, sizeof(name) / sizeof(name[0]), L"Shaders\\AMD_AOFX_%d.hlsl", i);
+    return name;
+}
+
+static void testIdentity()
+{
+    StringPool pool;
+
+    // the same characters from different buffers
+    std::wstring first = L"csAmbientOcclusion";
+    std::wstring second = first;
+    const wchar_t * pPooled = pool.Intern(first.c_str());
+    AMD_TEST_CHECK(pPooled != first.c_str());
+    AMD_TEST_CHECK(wcscmp(pPooled, L"csAmbientOcclusion") == 0);
+    AMD_TEST_CHECK(pool.Intern(second.c_str()) == pPooled);
+    AMD_TEST_CHECK(pool.Intern(L"csAmbientOcclusion") == pPooled);
+    AMD_TEST_CHECK(pool.Intern(pPooled) == pPooled);
+
+    // the pool copies, changing the source later does not change the pooled string
+    first[0] = L'p';
+    AMD_TEST_CHECK(wcscmp(pPooled, L"csAmbientOcclusion") == 0);
+    AMD_TEST_CHECK(pool.Intern(first.c_str()) != pPooled);
+
+    // prefixes, case and the empty string are all different strings
+    static const wchar_t * strings[] = { L"cs_5_0", L"cs_5", L"CS_5_0", L"cs_5_0 ", L"", L"c" };
+    const wchar_t * pooled[sizeof(strings) / sizeof(strings[0])];
+    for (size_t i = 0; i < sizeof(strings) / sizeof(strings[0]); i++)
+    {
+        pooled[i] = pool.Intern(strings[i]);
+        AMD_TEST_CHECK(wcscmp(pooled[i], strings[i]) == 0);
+        for (size_t j = 0; j < i; j++)
+        {
+            AMD_TEST_CHECK(pooled[i] != pooled[j]);
+        }
+    }
+    for (size_t i = 0; i < sizeof(strings) / sizeof(strings[0]); i++)
+    {
+        AMD_TEST_CHECK(pool.Intern(std::wstring(strings[i]).c_str()) == pooled[i]);
+    }
+
+    AMD_TEST_CHECK_EQUAL(pool.GetNumStrings(), 2 + sizeof(strings) / sizeof(strings[0]));
+}
+
+static void testGrowth()
+{
+    StringPool pool;
+    const int count = 10000;
+
+    // enough strings for many blocks, with long strings in between that get blocks of their own
+    std::vector<const wchar_t *> pooled;
+    std::vector<std::wstring> contents;
+    for (int i = 0; i < count; i++)
+    {
+        contents.push_back(shaderName(i));
+        if (i % 1000 == 0)
+        {
+            contents.back().append(StringPool::m_uBLOCK_LENGTH, L'x');
+        }
+        pooled.push_back(pool.Intern(contents.back().c_str()));
+    }
+
+    AMD_TEST_CHECK_EQUAL(pool.GetNumStrings(), count);
+
+    // nothing moved, nothing was overwritten
+    for (int i = 0; i < count; i++)
+    {
+        AMD_TEST_CHECK(contents[i] == pooled[i]);
+        AMD_TEST_CHECK(pool.Intern(contents[i].c_str()) == pooled[i]);
+    }
+    AMD_TEST_CHECK_EQUAL(pool.GetNumStrings(), count);
+
+    // each string is stored once: interning everything again adds no memory
+    const size_t numBytes = pool.GetNumBytes();
+    size_t stringBytes = 0;
+    for (int i = 0; i < count; i++)
+    {
+        stringBytes += (contents[i].size() + 1) * sizeof(wchar_t);
+        pool.Intern(std::wstring(contents[i]).c_str());
+    }
+    AMD_TEST_CHECK_EQUAL(pool.GetNumBytes(), numBytes);
+
+    // the long strings did not waste the rest of the block they interrupted
+    AMD_TEST_CHECK(numBytes >= stringBytes);
+    AMD_TEST_CHECK(numBytes < stringBytes + 2 * StringPool::m_uBLOCK_LENGTH * sizeof(wchar_t));
+}
+
+static void testClear()
+{
+    StringPool pool;
+    pool.Intern(L"AMD_AOFX.hlsl");
+    pool.Intern(std::wstring(StringPool::m_uBLOCK_LENGTH, L'y').c_str());
+    AMD_TEST_CHECK_EQUAL(pool.GetNumStrings(), 2);
+    AMD_TEST_CHECK(pool.GetNumBytes() > 0);
+
+    pool.Clear();
+    AMD_TEST_CHECK_EQUAL(pool.GetNumStrings(), 0);
+    AMD_TEST_CHECK_EQUAL(pool.GetNumBytes(), 0);
+
+    // interning works again afterwards, and a string is pooled once more
+    const wchar_t * pPooled = pool.Intern(L"AMD_AOFX.hlsl");
+    AMD_TEST_CHECK(wcscmp(pPooled, L"AMD_AOFX.hlsl") == 0);
+    AMD_TEST_CHECK(pool.Intern(L"AMD_AOFX.hlsl") == pPooled);
+    AMD_TEST_CHECK_EQUAL(pool.GetNumStrings(), 1);
+    AMD_TEST_CHECK_EQUAL(pool.GetNumBytes(), StringPool::m_uBLOCK_LENGTH * sizeof(wchar_t));
+
+    pool.Clear();
+    pool.Clear();
+    AMD_TEST_CHECK_EQUAL(pool.GetNumStrings(), 0);
+}
+
+int main()
+{
+    testIdentity();
+    testGrowth();
+    testClear();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: StubFxc.cpp
+//
+// Stands in for fxc.exe when ShaderCache is tested without the Windows SDK. It takes the
+// options ShaderCache passes:
+//
+//   fxc /T target [flags] /E entry /Fo object [/D NAME=VALUE ...] /Fe errors /Fc assembly source
+//   fxc /E entry source /P preprocessed [/D NAME=VALUE ...]
+//
+// Every command line is appended to fxc.log next to the executable. Compiling writes an
+// object made of the target, entry and defines, and an empty error file; a source with an
+// active #error gets an error file with one "error" line per #error instead, and no object.
+// Of the preprocessor only #if NAME == VALUE ... #endif is understood, for the #error. The error file is written last, as ShaderCache waits for it. STUB_FXC_SLEEP_MS=N in
+// a source makes its compile take at least N ms. /P copies the source, after a #line.
+//
+// Paths can be Windows paths, with a \\?\ prefix and backslashes.
+//--------------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+static std::string toPosix(const std::string & pathName)
+{
+    std::string result = pathName.compare(0, 4, "\\\\?\\") == 0 ? pathName.substr(4) : pathName;
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        if (result[i] == '\\') result[i] = '/';
+    }
+    return result;
+}
+
+static bool readFile(const std::string & pathName, std::string & o_Text)
+{
+    FILE * pFile = fopen(pathName.c_str(), "rb");
+    if (!pFile) return false;
+    char buffer[4096];
+    size_t uRead;
+    o_Text.clear();
+    while ((uRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0) o_Text.append(buffer, uRead);
+    fclose(pFile);
+    return true;
+}
+
+static bool writeFile(const std::string & pathName, const std::string & text)
+{
+    FILE * pFile = fopen(pathName.c_str(), "wb");
+    if (!pFile) return false;
+    bool bWritten = fwrite(text.data(), 1, text.size(), pFile) == text.size();
+    return (fclose(pFile) == 0) && bWritten;
+}
+
+// One write, so concurrent compiles do not interleave their lines
+static void appendLog(const std::string & line)
+{
+    char executable[4096];
+    const ssize_t iLength = readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+    executable[iLength > 0 ? iLength : 0] = '\0';
+    const std::string pathName = executable;
+    const size_t uSeparator = pathName.find_last_of('/');
+    const std::string logPathName = (uSeparator == std::string::npos ? std::string() : pathName.substr(0, uSeparator + 1)) + "fxc.log";
+    FILE * pFile = fopen(logPathName.c_str(), "ab");
+    if (!pFile) return;
+    fwrite(line.data(), 1, line.size(), pFile);
+    fclose(pFile);
+}
+
+static bool isOption(const char * pArgument)
+{
+    return pArgument[0] == '/' && pArgument[1] != '\0' && strchr(pArgument + 2, '/') == NULL;
+}
+
+int main(int argc, char ** argv)
+{
+    // The Windows command line has no program name when ShaderCache passes an application
+    // name, so argv[0] is an option then
+    const int iFirst = (argc > 0 && isOption(argv[0])) ? 0 : 1;
+
+    std::string line;
+    for (int i = iFirst; i < argc; i++)
+    {
+        line += (i > iFirst ? " " : "") + std::string(argv[i]);
+    }
+    appendLog(line + "\n");
+
+    std::string target, entry, object, errors, assembly, preprocessed, source, defines;
+    for (int i = iFirst; i < argc; i++)
+    {
+        const bool bValue = i + 1 < argc;
+        if (!strcmp(argv[i], "/T") && bValue) target = argv[++i];
+        else if (!strcmp(argv[i], "/E") && bValue) entry = argv[++i];
+        else if (!strcmp(argv[i], "/Fo") && bValue) object = toPosix(argv[++i]);
+        else if (!strcmp(argv[i], "/Fe") && bValue) errors = toPosix(argv[++i]);
+        else if (!strcmp(argv[i], "/Fc") && bValue) assembly = toPosix(argv[++i]);
+        else if (!strcmp(argv[i], "/P") && bValue) preprocessed = toPosix(argv[++i]);
+        else if (!strcmp(argv[i], "/D") && bValue) defines += " " + std::string(argv[++i]);
+        else if (argv[i][0] != '/') source = toPosix(argv[i]);
+    }
+
+    std::string text;
+    if (source.empty() || !readFile(source, text))
+    {
+        fprintf(stderr, "stub fxc: cannot open source '%s'\n", source.c_str());
+        if (!errors.empty()) writeFile(errors, source + "(1,1): error X1507: failed to open source file\n");
+        return 1;
+    }
+
+    if (!preprocessed.empty())
+    {
+        return writeFile(preprocessed, "#line 1 \"" + source + "\"\n" + text) ? 0 : 1;
+    }
+
+    const size_t uSleep = text.find("STUB_FXC_SLEEP_MS=");
+    if (uSleep != std::string::npos)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(atoi(text.c_str() + uSleep + strlen("STUB_FXC_SLEEP_MS="))));
+    }
+
+    // #error counts where it is active, with the /D values for the #if NAME == VALUE around it
+    std::string errorText;
+    std::vector<bool> active(1, true);
+    unsigned int uLine = 0;
+    for (size_t uStart = 0; uStart < text.size(); uStart = text.find('\n', uStart) + 1)
+    {
+        uLine++;
+        const std::string sourceLine = text.substr(uStart, text.find('\n', uStart) - uStart);
+        char name[64];
+        int iValue;
+        if (sscanf(sourceLine.c_str(), "#if %63s == %d", name, &iValue) == 2)
+        {
+            char define[96];
+            snprintf(define, sizeof(define), " %s=%d ", name, iValue);
+            active.push_back(active.back() && (defines + " ").find(define) != std::string::npos);
+        }
+        else if (sourceLine.compare(0, 6, "#endif") == 0 && active.size() > 1)
+        {
+            active.pop_back();
+        }
+        else if (sourceLine.compare(0, 6, "#error") == 0 && active.back())
+        {
+            char location[32];
+            snprintf(location, sizeof(location), "(%u,1)", uLine);
+            errorText += source + location + ": error X1503: #error directive\n";
+        }
+        if (text.find('\n', uStart) == std::string::npos) break;
+    }
+
+    if (errorText.empty())
+    {
+        if (!writeFile(object, "DXBC " + target + " " + entry + defines + "\n")) return 1;
+        if (!assembly.empty()) writeFile(assembly, "// " + target + " " + entry + defines + "\n");
+    }
+
+    return (writeFile(errors, errorText) && errorText.empty()) ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: TestJson.h
+//
+// A strict JSON parser for the tests that check JSON output, it fails on anything RFC 8259
+// does not allow, so a test can tell valid output from output a lenient viewer would accept.
+//--------------------------------------------------------------------------------------
+
+#ifndef _AMD_TEST_JSON_H_
+#define _AMD_TEST_JSON_H_
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+// A parsed JSON value
+struct Json
+{
+    enum Type { NONE, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type                            m_Type;
+    double                          m_Number;
+    std::string                     m_String;       // UTF-8, also "true" / "false"
+    std::vector<Json>               m_Array;
+    std::map<std::string, Json>     m_Object;
+
+    Json() : m_Type(NONE), m_Number(0.0) {}
+
+    const Json & operator[](const char * pKey) const
+    {
+        static const Json none;
+        std::map<std::string, Json>::const_iterator it = m_Object.find(pKey);
+        return (it != m_Object.end()) ? it->second : none;
+    }
+};
+
+// Strict RFC 8259 parsing of one value, fails on anything else
+class JsonParser
+{
+public:
+
+    JsonParser(const std::string & text) : m_Text(text), m_Index(0), m_bError(false) {}
+
+    bool parse(Json & value)
+    {
+        parseValue(value);
+        skipSpaces();
+        return !m_bError && m_Index == m_Text.size();
+    }
+
+private:
+
+    char peek() const { return (m_Index < m_Text.size()) ? m_Text[m_Index] : '\0'; }
+
+    bool accept(char c)
+    {
+        skipSpaces();
+        if (peek() != c)
+        {
+            return false;
+        }
+        m_Index++;
+        return true;
+    }
+
+    void expect(char c)
+    {
+        m_bError = m_bError || !accept(c);
+    }
+
+    void skipSpaces()
+    {
+        while (peek() == ' ' || peek() == '\t' || peek() == '\r' || peek() == '\n')
+        {
+            m_Index++;
+        }
+    }
+
+    void parseValue(Json & value)
+    {
+        skipSpaces();
+        if (m_bError)
+        {
+            return;
+        }
+
+        if (accept('{'))
+        {
+            value.m_Type = Json::OBJECT;
+            if (accept('}'))
+            {
+                return;
+            }
+            do
+            {
+                Json key;
+                skipSpaces();
+                parseString(key);
+                expect(':');
+                m_bError = m_bError || value.m_Object.count(key.m_String) > 0;
+                parseValue(value.m_Object[key.m_String]);
+            } while (!m_bError && accept(','));
+            expect('}');
+        }
+        else if (accept('['))
+        {
+            value.m_Type = Json::ARRAY;
+            if (accept(']'))
+            {
+                return;
+            }
+            do
+            {
+                value.m_Array.push_back(Json());
+                parseValue(value.m_Array.back());
+            } while (!m_bError && accept(','));
+            expect(']');
+        }
+        else if (peek() == '"')
+        {
+            parseString(value);
+        }
+        else if (m_Text.compare(m_Index, 4, "true") == 0 || m_Text.compare(m_Index, 5, "false") == 0)
+        {
+            value.m_Type = Json::BOOLEAN;
+            value.m_String = (peek() == 't') ? "true" : "false";
+            m_Index += value.m_String.size();
+        }
+        else
+        {
+            parseNumber(value);
+        }
+    }
+
+    void parseNumber(Json & value)
+    {
+        const size_t start = m_Index;
+        m_Index += (peek() == '-') ? 1 : 0;
+        const size_t digits = m_Index;
+        while (peek() >= '0' && peek() <= '9') { m_Index++; }
+        m_bError = m_bError || m_Index == digits || (m_Text[digits] == '0' && m_Index > digits + 1);
+        if (peek() == '.')
+        {
+            const size_t fraction = ++m_Index;
+            while (peek() >= '0' && peek() <= '9') { m_Index++; }
+            m_bError = m_bError || m_Index == fraction;
+        }
+        if (peek() == 'e' || peek() == 'E')
+        {
+            m_Index++;
+            m_Index += (peek() == '+' || peek() == '-') ? 1 : 0;
+            const size_t exponent = m_Index;
+            while (peek() >= '0' && peek() <= '9') { m_Index++; }
+            m_bError = m_bError || m_Index == exponent;
+        }
+
+        value.m_Type = Json::NUMBER;
+        value.m_Number = strtod(m_Text.substr(start, m_Index - start).c_str(), NULL);
+    }
+
+    unsigned int parseHex()
+    {
+        unsigned int code = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            const char c = peek();
+            const char * pDigit = strchr("0123456789abcdef", (c >= 'A' && c <= 'F') ? c - 'A' + 'a' : c);
+            m_bError = m_bError || c == '\0' || pDigit == NULL;
+            code = code * 16 + (pDigit ? (unsigned int)(pDigit - "0123456789abcdef") : 0);
+            m_Index++;
+        }
+        return code;
+    }
+
+    static void appendUtf8(std::string & text, unsigned int code)
+    {
+        if (code < 0x80)
+        {
+            text += (char)code;
+        }
+        else if (code < 0x800)
+        {
+            text += (char)(0xC0 | (code >> 6));
+            text += (char)(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            text += (char)(0xE0 | (code >> 12));
+            text += (char)(0x80 | ((code >> 6) & 0x3F));
+            text += (char)(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            text += (char)(0xF0 | (code >> 18));
+            text += (char)(0x80 | ((code >> 12) & 0x3F));
+            text += (char)(0x80 | ((code >> 6) & 0x3F));
+            text += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
+    void parseString(Json & value)
+    {
+        value.m_Type = Json::STRING;
+        if (peek() != '"')
+        {
+            m_bError = true;
+            return;
+        }
+
+        for (m_Index++; !m_bError; )
+        {
+            const unsigned char c = (unsigned char)peek();
+            m_Index++;
+            if (c == '"')
+            {
+                return;
+            }
+
+            // unescaped control characters are not allowed
+            m_bError = m_bError || c < 0x20;
+            if (c != '\\')
+            {
+                value.m_String += (char)c;
+                continue;
+            }
+
+            const char escape = peek();
+            m_Index++;
+            const char * pEscape = strchr("\"\\/bfnrt", escape);
+            if (escape != '\0' && pEscape != NULL)
+            {
+                value.m_String += "\"\\/\b\f\n\r\t"[pEscape - "\"\\/bfnrt"];
+            }
+            else if (escape == 'u')
+            {
+                unsigned int code = parseHex();
+                if (code >= 0xD800 && code < 0xDC00 && m_Text.compare(m_Index, 2, "\\u") == 0)
+                {
+                    m_Index += 2;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (parseHex() - 0xDC00);
+                }
+                appendUtf8(value.m_String, code);
+            }
+            else
+            {
+                m_bError = true;
+            }
+        }
+    }
+
+    const std::string &     m_Text;
+    size_t                  m_Index;
+    bool                    m_bError;
+};
+
+#endif // _AMD_TEST_JSON_H_
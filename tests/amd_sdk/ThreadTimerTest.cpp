@@ -0,0 +1,381 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: ThreadTimerTest.cpp
+//
+// ThreadTimer from many threads: every thread's scopes nest only within that thread, Merge()
+// sums the same scope across threads and hands every stopped scope out exactly once, also while
+// the threads keep recording, and the trees of exited threads are reused by new threads.
+//--------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ThreadTimer.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+typedef ThreadTimer::Handle Handle;
+typedef std::vector<ThreadTimer::MergedNode> MergedNodes;
+
+static const unsigned int s_NumThreads = 8;
+
+// The merged node of a timer under a parent node, m_uINVALID_HANDLE for top level
+static unsigned int findNode(const MergedNodes & nodes, unsigned int uParent, Handle hTimer)
+{
+    unsigned int uFound = ThreadTimer::m_uINVALID_HANDLE;
+    for (unsigned int i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].m_Handle == hTimer && nodes[i].m_uParent == uParent)
+        {
+            // each scope is merged into one node
+            AMD_TEST_CHECK(uFound == ThreadTimer::m_uINVALID_HANDLE);
+            uFound = i;
+        }
+    }
+    return uFound;
+}
+
+static unsigned long long countOf(const MergedNodes & nodes, Handle hTimer)
+{
+    unsigned long long count = 0;
+    for (unsigned int i = 0; i < nodes.size(); i++)
+    {
+        count += (nodes[i].m_Handle == hTimer) ? nodes[i].m_uCount : 0;
+    }
+    return count;
+}
+
+// Parents before children, and the child lists hold exactly the nodes that name them as parent
+static void checkLinks(const MergedNodes & nodes)
+{
+    std::vector<unsigned int> numLinked(nodes.size(), 0);
+    for (unsigned int i = 0; i < nodes.size(); i++)
+    {
+        AMD_TEST_CHECK(nodes[i].m_uParent == ThreadTimer::m_uINVALID_HANDLE || nodes[i].m_uParent < i);
+        for (unsigned int uChild = nodes[i].m_uFirstChild; uChild != ThreadTimer::m_uINVALID_HANDLE; uChild = nodes[uChild].m_uNext)
+        {
+            AMD_TEST_CHECK_EQUAL(nodes[uChild].m_uParent, i);
+            numLinked[uChild]++;
+        }
+    }
+
+    // top level nodes are chained from node 0
+    for (unsigned int uNode = nodes.empty() ? ThreadTimer::m_uINVALID_HANDLE : 0; uNode != ThreadTimer::m_uINVALID_HANDLE; uNode = nodes[uNode].m_uNext)
+    {
+        AMD_TEST_CHECK_EQUAL(nodes[uNode].m_uParent, ThreadTimer::m_uINVALID_HANDLE);
+        numLinked[uNode]++;
+    }
+
+    for (unsigned int i = 0; i < nodes.size(); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(numLinked[i], 1);
+    }
+}
+
+static void testRegister()
+{
+    ThreadTimer & timer = ThreadTimer::Instance();
+
+    // the same name gets the same handle from every thread
+    std::vector<Handle> handles(s_NumThreads * 16);
+    std::vector<std::thread> threads;
+    for (unsigned int uThread = 0; uThread < s_NumThreads; uThread++)
+    {
+        threads.push_back(std::thread([&, uThread]()
+        {
+            for (unsigned int i = 0; i < 16; i++)
+            {
+                const std::wstring name = L"Register" + std::to_wstring((i + uThread) % 16);
+                handles[uThread * 16 + (i + uThread) % 16] = timer.Register(name.c_str());
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    for (unsigned int i = 0; i < 16; i++)
+    {
+        const std::wstring name = L"Register" + std::to_wstring(i);
+        const Handle hTimer = timer.Register(name.c_str());
+        AMD_TEST_CHECK(hTimer != ThreadTimer::m_uINVALID_HANDLE);
+        AMD_TEST_CHECK(timer.GetName(hTimer) != NULL && name == timer.GetName(hTimer));
+        for (unsigned int uThread = 0; uThread < s_NumThreads; uThread++)
+        {
+            AMD_TEST_CHECK_EQUAL(handles[uThread * 16 + i], hTimer);
+        }
+    }
+
+    AMD_TEST_CHECK(timer.GetName(ThreadTimer::m_uINVALID_HANDLE) == NULL);
+}
+
+// Every thread nests its own timer in a shared one, and one thread also times that timer on top
+static void testIsolation()
+{
+    ThreadTimer & timer = ThreadTimer::Instance();
+    MergedNodes nodes;
+    timer.Merge(nodes);
+
+    const Handle hFrame = timer.Register(L"Frame");
+    std::vector<Handle> hWork(s_NumThreads);
+    for (unsigned int uThread = 0; uThread < s_NumThreads; uThread++)
+    {
+        hWork[uThread] = timer.Register((L"Work" + std::to_wstring(uThread)).c_str());
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned int uThread = 0; uThread < s_NumThreads; uThread++)
+    {
+        threads.push_back(std::thread([&, uThread]()
+        {
+            for (unsigned int i = 0; i < 100 + uThread; i++)
+            {
+                timer.Start(hFrame);
+                timer.Start(hWork[uThread]);
+                timer.Stop();
+                timer.Stop();
+            }
+
+            // the same timer on its own is a different scope
+            if (uThread == 0)
+            {
+                timer.Start(hWork[0]);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                timer.Stop();
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    timer.Merge(nodes);
+    checkLinks(nodes);
+
+    const unsigned int uFrame = findNode(nodes, ThreadTimer::m_uINVALID_HANDLE, hFrame);
+    AMD_TEST_CHECK(uFrame != ThreadTimer::m_uINVALID_HANDLE);
+    if (uFrame == ThreadTimer::m_uINVALID_HANDLE)
+    {
+        return;
+    }
+    AMD_TEST_CHECK_EQUAL(nodes[uFrame].m_uCount, s_NumThreads * 100 + s_NumThreads * (s_NumThreads - 1) / 2);
+
+    // no thread's work ended up under another thread's scope
+    unsigned long long uWorkTicks = 0;
+    for (unsigned int uThread = 0; uThread < s_NumThreads; uThread++)
+    {
+        const unsigned int uWork = findNode(nodes, uFrame, hWork[uThread]);
+        AMD_TEST_CHECK(uWork != ThreadTimer::m_uINVALID_HANDLE);
+        if (uWork != ThreadTimer::m_uINVALID_HANDLE)
+        {
+            AMD_TEST_CHECK_EQUAL(nodes[uWork].m_uCount, 100 + uThread);
+            AMD_TEST_CHECK_EQUAL(nodes[uWork].m_uFirstChild, ThreadTimer::m_uINVALID_HANDLE);
+            uWorkTicks += nodes[uWork].m_uTicks;
+        }
+        AMD_TEST_CHECK_EQUAL(countOf(nodes, hWork[uThread]), 100 + uThread + (uThread == 0 ? 1 : 0));
+    }
+    AMD_TEST_CHECK(nodes[uFrame].m_uTicks >= uWorkTicks);
+
+    const unsigned int uAlone = findNode(nodes, ThreadTimer::m_uINVALID_HANDLE, hWork[0]);
+    AMD_TEST_CHECK(uAlone != ThreadTimer::m_uINVALID_HANDLE);
+    if (uAlone != ThreadTimer::m_uINVALID_HANDLE)
+    {
+        AMD_TEST_CHECK_EQUAL(nodes[uAlone].m_uCount, 1);
+        AMD_TEST_CHECK(nodes[uAlone].m_uTicks >= (unsigned long long)(0.002 * ThreadTimer::GetTicksPerSecond()));
+    }
+
+    // merging clears the counts but keeps the scopes
+    const size_t numNodes = nodes.size();
+    timer.Merge(nodes);
+    AMD_TEST_CHECK_EQUAL(nodes.size(), numNodes);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(nodes[i].m_uCount, 0);
+        AMD_TEST_CHECK_EQUAL(nodes[i].m_uTicks, 0);
+    }
+}
+
+// Merging while the threads record loses and repeats nothing
+static void testConcurrentMerge()
+{
+    ThreadTimer & timer = ThreadTimer::Instance();
+    MergedNodes nodes;
+    timer.Merge(nodes);
+
+    const Handle hOuter = timer.Register(L"Outer");
+    const Handle hInner = timer.Register(L"Inner");
+    const unsigned int numScopes = 20000;
+
+    std::atomic<unsigned int> numRunning(s_NumThreads);
+    std::vector<std::thread> threads;
+    for (unsigned int uThread = 0; uThread < s_NumThreads; uThread++)
+    {
+        threads.push_back(std::thread([&, uThread]()
+        {
+            for (unsigned int i = 0; i < numScopes; i++)
+            {
+                timer.Start(hOuter);
+                timer.Start(hInner);
+                timer.Stop();
+
+                // a new scope now and then, so merging also sees nodes being added
+                if (i % 1000 == 0)
+                {
+                    timer.Start(timer.Register((L"Late" + std::to_wstring(uThread * 100 + i / 1000)).c_str()));
+                    timer.Stop();
+                }
+                timer.Stop();
+            }
+            numRunning--;
+        }));
+    }
+
+    unsigned long long uOuter = 0;
+    unsigned long long uInner = 0;
+    unsigned int numMerges = 0;
+    do
+    {
+        timer.Merge(nodes);
+        checkLinks(nodes);
+        uOuter += countOf(nodes, hOuter);
+        uInner += countOf(nodes, hInner);
+        numMerges++;
+    } while (numRunning > 0);
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+    timer.Merge(nodes);
+    uOuter += countOf(nodes, hOuter);
+    uInner += countOf(nodes, hInner);
+
+    AMD_TEST_CHECK_EQUAL(uOuter, (unsigned long long)s_NumThreads * numScopes);
+    AMD_TEST_CHECK_EQUAL(uInner, (unsigned long long)s_NumThreads * numScopes);
+    AMD_TEST_CHECK(numMerges > 1);
+
+    // one merged scope each, however many threads recorded it
+    const unsigned int uOuterNode = findNode(nodes, ThreadTimer::m_uINVALID_HANDLE, hOuter);
+    AMD_TEST_CHECK(uOuterNode != ThreadTimer::m_uINVALID_HANDLE);
+    AMD_TEST_CHECK(findNode(nodes, uOuterNode, hInner) != ThreadTimer::m_uINVALID_HANDLE);
+}
+
+// Threads that exit hand their tree to the next thread, with what it recorded and without the
+// scopes it left open
+static void testTreeReuse()
+{
+    ThreadTimer & timer = ThreadTimer::Instance();
+    MergedNodes nodes;
+    timer.Merge(nodes);
+
+    const Handle hTask = timer.Register(L"Task");
+    for (unsigned int uRound = 0; uRound < 50; uRound++)
+    {
+        std::thread thread([&]()
+        {
+            timer.Start(hTask);
+            timer.Stop();
+        });
+        thread.join();
+    }
+
+    timer.Merge(nodes);
+    const unsigned int uTask = findNode(nodes, ThreadTimer::m_uINVALID_HANDLE, hTask);
+    AMD_TEST_CHECK(uTask != ThreadTimer::m_uINVALID_HANDLE);
+    if (uTask != ThreadTimer::m_uINVALID_HANDLE)
+    {
+        AMD_TEST_CHECK_EQUAL(nodes[uTask].m_uCount, 50);
+    }
+
+    // a reused tree starts at the top level, whatever the thread before it left open
+    std::thread unbalanced([&]()
+    {
+        timer.Start(timer.Register(L"Unbalanced"));
+    });
+    unbalanced.join();
+
+    std::thread next([&]()
+    {
+        timer.Start(hTask);
+        timer.Stop();
+    });
+    next.join();
+
+    timer.Merge(nodes);
+    AMD_TEST_CHECK_EQUAL(countOf(nodes, hTask), 1);
+    const unsigned int uTopTask = findNode(nodes, ThreadTimer::m_uINVALID_HANDLE, hTask);
+    AMD_TEST_CHECK(uTopTask != ThreadTimer::m_uINVALID_HANDLE);
+    if (uTopTask != ThreadTimer::m_uINVALID_HANDLE)
+    {
+        AMD_TEST_CHECK_EQUAL(nodes[uTopTask].m_uCount, 1);
+    }
+}
+
+// Scopes deeper than m_uMAX_DEPTH are counted, not timed, and Start/Stop stay balanced
+static void testDepth()
+{
+    ThreadTimer & timer = ThreadTimer::Instance();
+    MergedNodes nodes;
+    timer.Merge(nodes);
+
+    const Handle hLevel = timer.Register(L"Level");
+    const Handle hAfter = timer.Register(L"After");
+    std::thread thread([&]()
+    {
+        for (unsigned int i = 0; i < ThreadTimer::m_uMAX_DEPTH + 8; i++)
+        {
+            timer.Start(hLevel);
+        }
+        for (unsigned int i = 0; i < ThreadTimer::m_uMAX_DEPTH + 8; i++)
+        {
+            timer.Stop();
+        }
+        timer.Start(hAfter);
+        timer.Stop();
+    });
+    thread.join();
+
+    timer.Merge(nodes);
+    AMD_TEST_CHECK_EQUAL(countOf(nodes, hLevel), ThreadTimer::m_uMAX_DEPTH);
+    AMD_TEST_CHECK(findNode(nodes, ThreadTimer::m_uINVALID_HANDLE, hAfter) != ThreadTimer::m_uINVALID_HANDLE);
+    AMD_TEST_CHECK_EQUAL(countOf(nodes, hAfter), 1);
+}
+
+int main()
+{
+    testRegister();
+    testIsolation();
+    testConcurrentMerge();
+    testTreeReuse();
+    testDepth();
+
+    return AMD_TEST_RESULT();
+}
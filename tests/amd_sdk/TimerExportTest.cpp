@@ -0,0 +1,354 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: TimerExportTest.cpp
+//
+// TimerExport output read back: the CSV with a RFC 4180 reader (paths, quoting, empty fields
+// for missing timers, times and percentiles in milliseconds), and the Chrome Trace with a strict
+// JSON parser (metadata, one complete event per timer and track, children laid out inside their
+// parent one after the other, percentiles in the args).
+//--------------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "TimerExport.h"
+#include "AMD_Test.h"
+#include "amd_sdk/TestJson.h"
+
+using namespace AMD;
+
+typedef TimerExport::Event Event;
+typedef std::vector<std::string> Row;
+
+static const unsigned int s_NumColumns = 16;
+
+static std::string readAll(FILE * pFile)
+{
+    rewind(pFile);
+    std::string text;
+    char buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    {
+        text.append(buffer, size);
+    }
+    fclose(pFile);
+    return text;
+}
+
+// RFC 4180: CRLF line ends, fields with quotes, commas or line breaks quoted, quotes doubled
+static bool parseCSV(const std::string & text, std::vector<Row> & rows)
+{
+    size_t i = 0;
+    while (i < text.size())
+    {
+        rows.push_back(Row(1));
+        for (;;)
+        {
+            std::string & field = rows.back().back();
+            if (i < text.size() && text[i] == '"')
+            {
+                for (i++; ; i++)
+                {
+                    if (i >= text.size())
+                    {
+                        return false;
+                    }
+                    if (text[i] == '"')
+                    {
+                        if (i + 1 < text.size() && text[i + 1] == '"')
+                        {
+                            field += '"';
+                            i++;
+                            continue;
+                        }
+                        i++;
+                        break;
+                    }
+                    field += text[i];
+                }
+            }
+            else
+            {
+                while (i < text.size() && text[i] != ',' && text[i] != '\r' && text[i] != '\n')
+                {
+                    if (text[i] == '"')
+                    {
+                        return false;
+                    }
+                    field += text[i++];
+                }
+            }
+
+            if (i < text.size() && text[i] == ',')
+            {
+                rows.back().push_back(std::string());
+                i++;
+                continue;
+            }
+            if (text.compare(i, 2, "\r\n") != 0)
+            {
+                return false;
+            }
+            i += 2;
+            break;
+        }
+    }
+    return true;
+}
+
+// A frame with nested CPU and GPU timers, one GPU only pass and names that need quoting
+struct Frame
+{
+    TimerHistogram          m_Histograms[6];
+    std::vector<Event>      m_Events;
+
+    Frame()
+    {
+        static const struct { const wchar_t * m_wsName; unsigned int m_uParent; double m_fCpu; double m_fGpu; bool m_bCpu; } events[] =
+        {
+            { L"Frame",                     TimerExport::m_uNO_PARENT,  0.0160, 0.0150, true },
+            { L"Shadows",                   0,                          0.0040, 0.0050, true },
+            { L"AO, \"HDAO\"",              0,                          0.0020, 0.0060, true },
+            { L"Blur",                      2,                          0.0005, 0.0025, false },
+            { L"Composite \x00e9\x20ac",    0,                          0.0010, 0.0012, true },
+            { L"Present",                   TimerExport::m_uNO_PARENT,  0.0003, 0.0001, true },
+        };
+
+        for (unsigned int i = 0; i < sizeof(events) / sizeof(events[0]); i++)
+        {
+            // a few hundred frames around the last time
+            for (unsigned int frame = 0; frame < 300; frame++)
+            {
+                m_Histograms[i].Add(events[i].m_fGpu * (0.8 + 0.4 * (frame % 100) / 100.0));
+            }
+
+            Event event;
+            event.m_wsName = events[i].m_wsName;
+            event.m_uParent = events[i].m_uParent;
+            event.m_uDepth = (events[i].m_uParent == TimerExport::m_uNO_PARENT) ? 0 : m_Events[events[i].m_uParent].m_uDepth + 1;
+            event.m_fCpuTime = events[i].m_fCpu;
+            event.m_fGpuTime = events[i].m_fGpu;
+            event.m_pCpuHistogram = events[i].m_bCpu ? &m_Histograms[i] : NULL;
+            event.m_pGpuHistogram = &m_Histograms[i];
+            m_Events.push_back(event);
+        }
+    }
+};
+
+static void testCSV()
+{
+    Frame frame;
+    FILE * pFile = tmpfile();
+    TimerExport::WriteCSV(pFile, &frame.m_Events[0], (unsigned int)frame.m_Events.size());
+
+    std::vector<Row> rows;
+    AMD_TEST_CHECK(parseCSV(readAll(pFile), rows));
+    AMD_TEST_CHECK_EQUAL(rows.size(), frame.m_Events.size() + 1);
+    if (rows.size() != frame.m_Events.size() + 1)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(rows[i].size(), s_NumColumns);
+    }
+    if (rows[0].size() != s_NumColumns || rows[3].size() != s_NumColumns || rows[4].size() != s_NumColumns)
+    {
+        return;
+    }
+
+    AMD_TEST_CHECK(rows[0][0] == "path" && rows[0][1] == "depth");
+    AMD_TEST_CHECK(rows[0][2] == "cpu_ms" && rows[0][4] == "cpu_p50_ms" && rows[0][6] == "cpu_p99_ms" && rows[0][8] == "cpu_frames");
+    AMD_TEST_CHECK(rows[0][9] == "gpu_ms" && rows[0][15] == "gpu_frames");
+
+    // paths from the top level down, UTF-8, quotes doubled on the way out and undone by the reader
+    AMD_TEST_CHECK(rows[1][0] == "Frame");
+    AMD_TEST_CHECK(rows[3][0] == "Frame|AO, \"HDAO\"");
+    AMD_TEST_CHECK(rows[4][0] == "Frame|AO, \"HDAO\"|Blur");
+    AMD_TEST_CHECK(rows[5][0] == "Frame|Composite \xc3\xa9\xe2\x82\xac");
+    AMD_TEST_CHECK(rows[6][0] == "Present");
+    for (size_t i = 0; i < frame.m_Events.size(); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(atoi(rows[i + 1][1].c_str()), frame.m_Events[i].m_uDepth);
+    }
+
+    // milliseconds, with the histogram's own statistics
+    const Event & ao = frame.m_Events[2];
+    const Row & row = rows[3];
+    AMD_TEST_CHECK_NEAR(atof(row[2].c_str()), ao.m_fCpuTime * 1000.0, 1e-4);
+    AMD_TEST_CHECK_NEAR(atof(row[3].c_str()), ao.m_pCpuHistogram->GetMean() * 1000.0, 1e-4);
+    AMD_TEST_CHECK_NEAR(atof(row[4].c_str()), ao.m_pCpuHistogram->GetPercentile(50.0) * 1000.0, 1e-4);
+    AMD_TEST_CHECK_NEAR(atof(row[5].c_str()), ao.m_pCpuHistogram->GetPercentile(95.0) * 1000.0, 1e-4);
+    AMD_TEST_CHECK_NEAR(atof(row[6].c_str()), ao.m_pCpuHistogram->GetPercentile(99.0) * 1000.0, 1e-4);
+    AMD_TEST_CHECK_NEAR(atof(row[7].c_str()), ao.m_pCpuHistogram->GetMax() * 1000.0, 1e-4);
+    AMD_TEST_CHECK_EQUAL(atoi(row[8].c_str()), 300);
+    AMD_TEST_CHECK_NEAR(atof(row[9].c_str()), ao.m_fGpuTime * 1000.0, 1e-4);
+    AMD_TEST_CHECK_EQUAL(atoi(row[15].c_str()), 300);
+
+    // no CPU timer: empty CPU fields, the GPU fields are still there
+    for (unsigned int column = 2; column < 9; column++)
+    {
+        AMD_TEST_CHECK(rows[4][column].empty());
+    }
+    AMD_TEST_CHECK_NEAR(atof(rows[4][9].c_str()), 2.5, 1e-4);
+
+    // no events: the header only
+    pFile = tmpfile();
+    TimerExport::WriteCSV(pFile, NULL, 0);
+    rows.clear();
+    AMD_TEST_CHECK(parseCSV(readAll(pFile), rows));
+    AMD_TEST_CHECK_EQUAL(rows.size(), 1);
+}
+
+// The X event of a timer on a track, NULL if there is none
+static const Json * findTraceEvent(const Json & trace, const char * pName, const char * pCategory)
+{
+    const Json * pFound = NULL;
+    const std::vector<Json> & events = trace["traceEvents"].m_Array;
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        if (events[i]["ph"].m_String == "X" && events[i]["name"].m_String == pName && events[i]["cat"].m_String == pCategory)
+        {
+            AMD_TEST_CHECK(pFound == NULL);
+            pFound = &events[i];
+        }
+    }
+    return pFound;
+}
+
+static void testChromeTrace()
+{
+    Frame frame;
+    FILE * pFile = tmpfile();
+    TimerExport::WriteChromeTrace(pFile, &frame.m_Events[0], (unsigned int)frame.m_Events.size());
+    const std::string text = readAll(pFile);
+
+    Json trace;
+    AMD_TEST_CHECK(JsonParser(text).parse(trace));
+    AMD_TEST_CHECK_EQUAL(trace.m_Type, Json::OBJECT);
+    AMD_TEST_CHECK(trace["displayTimeUnit"].m_String == "ms");
+
+    // the two track names, then one complete event per timer and track
+    const std::vector<Json> & events = trace["traceEvents"].m_Array;
+    AMD_TEST_CHECK_EQUAL(events.size(), 2 + 5 + 6);
+    unsigned int numMetadata = 0;
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(events[i]["pid"].m_Number, 1);
+        if (events[i]["ph"].m_String == "M")
+        {
+            AMD_TEST_CHECK(events[i]["name"].m_String == "thread_name");
+            AMD_TEST_CHECK(events[i]["args"]["name"].m_String == (events[i]["tid"].m_Number == 1 ? "CPU" : "GPU"));
+            numMetadata++;
+            continue;
+        }
+
+        AMD_TEST_CHECK(events[i]["ph"].m_String == "X");
+        AMD_TEST_CHECK_EQUAL(events[i]["tid"].m_Number, events[i]["cat"].m_String == "cpu" ? 1 : 2);
+        AMD_TEST_CHECK(events[i]["dur"].m_Number >= 0.0);
+    }
+    AMD_TEST_CHECK_EQUAL(numMetadata, 2);
+
+    AMD_TEST_CHECK(findTraceEvent(trace, "Blur", "cpu") == NULL);
+    AMD_TEST_CHECK(findTraceEvent(trace, "Composite \xc3\xa9\xe2\x82\xac", "gpu") != NULL);
+
+    // microseconds: each event starts where its previous sibling ended, the first child where its parent starts
+    static const struct { const char * m_pName; double m_fCpuStart; double m_fGpuStart; } layout[] =
+    {
+        { "Frame",              0.0,        0.0 },
+        { "Shadows",            0.0,        0.0 },
+        { "AO, \"HDAO\"",       4000.0,     5000.0 },
+        { "Blur",               -1.0,       5000.0 },
+        { "Composite \xc3\xa9\xe2\x82\xac", 6000.0, 11000.0 },
+        { "Present",            16000.0,    15000.0 },
+    };
+    for (unsigned int i = 0; i < sizeof(layout) / sizeof(layout[0]); i++)
+    {
+        const Json * pCpu = findTraceEvent(trace, layout[i].m_pName, "cpu");
+        const Json * pGpu = findTraceEvent(trace, layout[i].m_pName, "gpu");
+        AMD_TEST_CHECK((pCpu != NULL) == (layout[i].m_fCpuStart >= 0.0));
+        AMD_TEST_CHECK(pGpu != NULL);
+        if (pCpu != NULL)
+        {
+            AMD_TEST_CHECK_NEAR((*pCpu)["ts"].m_Number, layout[i].m_fCpuStart, 1e-3);
+            AMD_TEST_CHECK_NEAR((*pCpu)["dur"].m_Number, frame.m_Events[i].m_fCpuTime * 1000000.0, 1e-3);
+        }
+        if (pGpu == NULL)
+        {
+            continue;
+        }
+        AMD_TEST_CHECK_NEAR((*pGpu)["ts"].m_Number, layout[i].m_fGpuStart, 1e-3);
+        AMD_TEST_CHECK_NEAR((*pGpu)["dur"].m_Number, frame.m_Events[i].m_fGpuTime * 1000000.0, 1e-3);
+
+        // the statistics of the whole capture
+        const Json & args = (*pGpu)["args"];
+        const TimerHistogram & histogram = *frame.m_Events[i].m_pGpuHistogram;
+        AMD_TEST_CHECK_NEAR(args["mean_ms"].m_Number, histogram.GetMean() * 1000.0, 1e-4);
+        AMD_TEST_CHECK_NEAR(args["p50_ms"].m_Number, histogram.GetPercentile(50.0) * 1000.0, 1e-4);
+        AMD_TEST_CHECK_NEAR(args["p95_ms"].m_Number, histogram.GetPercentile(95.0) * 1000.0, 1e-4);
+        AMD_TEST_CHECK_NEAR(args["p99_ms"].m_Number, histogram.GetPercentile(99.0) * 1000.0, 1e-4);
+        AMD_TEST_CHECK_NEAR(args["max_ms"].m_Number, histogram.GetMax() * 1000.0, 1e-4);
+        AMD_TEST_CHECK_EQUAL(args["frames"].m_Number, 300);
+    }
+
+    // no events: still a valid trace with the track names
+    pFile = tmpfile();
+    TimerExport::WriteChromeTrace(pFile, NULL, 0);
+    Json empty;
+    AMD_TEST_CHECK(JsonParser(readAll(pFile)).parse(empty));
+    AMD_TEST_CHECK_EQUAL(empty["traceEvents"].m_Array.size(), 2);
+}
+
+static void testFiles()
+{
+    Frame frame;
+    AMD_TEST_CHECK(TimerExport::WriteCSV(L"TimerExportTest.csv", &frame.m_Events[0], (unsigned int)frame.m_Events.size()));
+    AMD_TEST_CHECK(TimerExport::WriteChromeTrace(L"TimerExportTest.json", &frame.m_Events[0], (unsigned int)frame.m_Events.size()));
+
+    FILE * pFile = fopen("TimerExportTest.json", "rb");
+    AMD_TEST_CHECK(pFile != NULL);
+    if (pFile != NULL)
+    {
+        Json trace;
+        AMD_TEST_CHECK(JsonParser(readAll(pFile)).parse(trace));
+    }
+    remove("TimerExportTest.csv");
+    remove("TimerExportTest.json");
+
+    AMD_TEST_CHECK(!TimerExport::WriteCSV(L"no_such_directory/TimerExportTest.csv", &frame.m_Events[0], 1));
+    AMD_TEST_CHECK(!TimerExport::WriteChromeTrace(L"no_such_directory/TimerExportTest.json", &frame.m_Events[0], 1));
+}
+
+int main()
+{
+    testCSV();
+    testChromeTrace();
+    testFiles();
+
+    return AMD_TEST_RESULT();
+}
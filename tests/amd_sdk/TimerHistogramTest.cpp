@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: TimerHistogramTest.cpp
+//
+// TimerHistogram against the sorted samples: every percentile estimate is within the 1%
+// relative error of DDSketch of the sample of that rank, for times between 1us and 10s and at
+// the bucket boundaries. Outside that range the estimates stay within the minimum and maximum,
+// and those, the mean and the count are exact.
+//--------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "TimerHistogram.h"
+#include "AMD_Test.h"
+
+using namespace AMD;
+
+static const double s_RelativeAccuracy = 0.01;
+static const double s_Gamma = (1.0 + s_RelativeAccuracy) / (1.0 - s_RelativeAccuracy);
+
+static const double s_Percentiles[] = { 0.0, 0.1, 1.0, 5.0, 10.0, 25.0, 50.0, 75.0, 90.0, 95.0, 99.0, 99.9, 100.0 };
+
+// Adds the samples, checks every percentile against the sample of that rank, returns the worst relative error
+static double checkSamples(std::vector<double> samples)
+{
+    TimerHistogram histogram;
+    double sum = 0.0;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        histogram.Add(samples[i]);
+        sum += samples[i];
+    }
+    std::sort(samples.begin(), samples.end());
+
+    AMD_TEST_CHECK_EQUAL(histogram.GetCount(), samples.size());
+    AMD_TEST_CHECK_EQUAL(histogram.GetMin(), samples.front());
+    AMD_TEST_CHECK_EQUAL(histogram.GetMax(), samples.back());
+    AMD_TEST_CHECK_NEAR(histogram.GetMean(), sum / samples.size(), 1e-12 * fabs(sum / samples.size()));
+
+    double worst = 0.0;
+    for (size_t i = 0; i < sizeof(s_Percentiles) / sizeof(s_Percentiles[0]); i++)
+    {
+        const double expected = samples[(size_t)(s_Percentiles[i] / 100.0 * (samples.size() - 1))];
+        const double estimate = histogram.GetPercentile(s_Percentiles[i]);
+        const double error = fabs(estimate - expected) / expected;
+        if (error > s_RelativeAccuracy * (1.0 + 1e-9))
+        {
+            printf("p%g of %d samples is %g, expected %g\n", s_Percentiles[i], (int)samples.size(), estimate, expected);
+        }
+        AMD_TEST_CHECK(error <= s_RelativeAccuracy * (1.0 + 1e-9));
+        AMD_TEST_CHECK(estimate >= samples.front() && estimate <= samples.back());
+        worst = std::max(worst, error);
+    }
+
+    return worst;
+}
+
+static void testEmpty()
+{
+    TimerHistogram histogram;
+    AMD_TEST_CHECK_EQUAL(histogram.GetCount(), 0);
+    AMD_TEST_CHECK_EQUAL(histogram.GetMean(), 0);
+    for (size_t i = 0; i < sizeof(s_Percentiles) / sizeof(s_Percentiles[0]); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(histogram.GetPercentile(s_Percentiles[i]), 0);
+    }
+
+    // one sample is every percentile, exactly
+    histogram.Add(0.0166);
+    for (size_t i = 0; i < sizeof(s_Percentiles) / sizeof(s_Percentiles[0]); i++)
+    {
+        AMD_TEST_CHECK_EQUAL(histogram.GetPercentile(s_Percentiles[i]), 0.0166);
+    }
+
+    histogram.Reset();
+    AMD_TEST_CHECK_EQUAL(histogram.GetCount(), 0);
+    AMD_TEST_CHECK_EQUAL(histogram.GetPercentile(50.0), 0);
+    AMD_TEST_CHECK_EQUAL(histogram.GetMin(), 0);
+    AMD_TEST_CHECK_EQUAL(histogram.GetMax(), 0);
+}
+
+static void testDistributions()
+{
+    std::mt19937 random(20160913);
+
+    // spread evenly over the whole range, on a log scale
+    {
+        std::uniform_real_distribution<double> exponent(log(1.0e-6), log(10.0));
+        std::vector<double> samples(100000);
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            samples[i] = exp(exponent(random));
+        }
+        const double worst = checkSamples(samples);
+
+        // the bound is not met by accident: the worst error is close to it
+        AMD_TEST_CHECK(worst > s_RelativeAccuracy / 2);
+    }
+
+    // frame times: 60 fps with jitter and a few hitches
+    {
+        std::normal_distribution<double> frame(0.0166, 0.0008);
+        std::vector<double> samples(20000);
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            samples[i] = (i % 500 == 0) ? 0.1 + 0.001 * (i / 500) : std::max(0.001, frame(random));
+        }
+        checkSamples(samples);
+    }
+
+    // GPU passes of a few microseconds, all but a few identical
+    {
+        std::vector<double> samples(1000, 3.0e-6);
+        samples[10] = 2.0e-6;
+        samples[20] = 5.0e-5;
+        checkSamples(samples);
+    }
+
+    // small counts, where the rank lands on single samples
+    for (size_t count = 2; count < 12; count++)
+    {
+        std::uniform_real_distribution<double> exponent(log(1.0e-5), log(1.0));
+        std::vector<double> samples(count);
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            samples[i] = exp(exponent(random));
+        }
+        checkSamples(samples);
+    }
+}
+
+// Times on either side of every bucket boundary, surrounded by samples that move the
+// minimum and maximum out of the way so the estimate is the bucket's own
+static void testBucketBoundaries()
+{
+    double worst = 0.0;
+    for (int i = 1; i < 800; i += 7)
+    {
+        const double boundary = 1.0e-6 * pow(s_Gamma, (double)i);
+        const double times[] = { boundary * (1.0 - 1e-12), boundary, boundary * (1.0 + 1e-12) };
+        for (size_t t = 0; t < sizeof(times) / sizeof(times[0]); t++)
+        {
+            std::vector<double> samples(9, times[t]);
+            samples.push_back(1.0e-6);
+            samples.push_back(10.0);
+            worst = std::max(worst, checkSamples(samples));
+        }
+    }
+
+    // both sides of a boundary are at the limit, 1% off in opposite directions
+    AMD_TEST_CHECK_NEAR(worst, s_RelativeAccuracy, 1e-6);
+}
+
+// Outside 1us to 10s the histogram has no buckets, but nothing lies outside the samples
+static void testOutOfRange()
+{
+    TimerHistogram histogram;
+    histogram.Add(0.0);
+    histogram.Add(1.0e-9);
+    histogram.Add(5.0e-7);
+    AMD_TEST_CHECK(histogram.GetPercentile(50.0) >= 0.0 && histogram.GetPercentile(50.0) <= 5.0e-7);
+    AMD_TEST_CHECK_EQUAL(histogram.GetPercentile(100.0), 5.0e-7);
+
+    histogram.Reset();
+    histogram.Add(12.0);
+    histogram.Add(30.0);
+    histogram.Add(3600.0);
+    AMD_TEST_CHECK_EQUAL(histogram.GetPercentile(0.0), 12.0);
+    AMD_TEST_CHECK(histogram.GetPercentile(50.0) >= 12.0 && histogram.GetPercentile(50.0) <= 3600.0);
+    AMD_TEST_CHECK_EQUAL(histogram.GetMax(), 3600.0);
+    AMD_TEST_CHECK_NEAR(histogram.GetMean(), 1214.0, 1e-9);
+
+    // mixed, the in-range samples keep their accuracy
+    histogram.Reset();
+    histogram.Add(0.0);
+    for (int i = 0; i < 98; i++)
+    {
+        histogram.Add(0.004);
+    }
+    histogram.Add(60.0);
+    AMD_TEST_CHECK_NEAR(histogram.GetPercentile(50.0), 0.004, 0.004 * s_RelativeAccuracy);
+    AMD_TEST_CHECK_EQUAL(histogram.GetPercentile(0.0), 0.0);
+    AMD_TEST_CHECK_EQUAL(histogram.GetPercentile(100.0), 60.0);
+    AMD_TEST_CHECK(histogram.GetPercentile(99.5) <= 60.0);
+}
+
+int main()
+{
+    testEmpty();
+    testDistributions();
+    testBucketBoundaries();
+    testOutOfRange();
+
+    return AMD_TEST_RESULT();
+}
@@ -0,0 +1,169 @@
+#
+# Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+# Writes aofx.golden: the output of a reference C preprocessor for every AOFX shader permutation.
+#
+# The permutations are read from the fxc_compile_*.bat files in amd_aofx\src\Shaders\build, with
+# AOFX_VIEWPORT_SCALE=0 and 1. Each one is preprocessed with cpp -P -undef -nostdinc -x c, on a
+# copy of the shader sources where the #include names match the files on disk (fxc runs on Windows,
+# the shaders include AMD_LIB\... with backslashes). The full outputs are several MB, so the golden
+# only keeps the number of C tokens and a 64 bit FNV-1a of the tokens, each followed by '\n'.
+# ShaderPreprocessorTest tokenizes the same way.
+#
+# usage: python aofx_goldens.py [--verify]
+
+import multiprocessing
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+SCRIPT_DIR      = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR        = os.path.join(SCRIPT_DIR, '..', '..', '..')
+SHADER_DIRS     = ['amd_aofx/src/Shaders', 'amd_lib/src/Shaders']
+BUILD_DIR       = os.path.join(ROOT_DIR, 'amd_aofx', 'src', 'Shaders', 'build')
+GOLDEN          = os.path.join(SCRIPT_DIR, 'aofx.golden')
+CPP             = ['cpp', '-P', '-undef', '-nostdinc', '-x', 'c']
+VIEWPORT_SCALES = ['0', '1']
+
+PUNCTUATORS     = ['<<=', '>>=', '...', '##', '->', '++', '--', '<<', '>>', '<=', '>=', '==', '!=', '&&', '||',
+                   '+=', '-=', '*=', '/=', '%=', '&=', '|=', '^=', '::']
+
+
+# C tokens like ShaderPreprocessorTest's tokenize(): strings, identifiers, pp-numbers (exponent
+# signs belong to them), the punctuators above in order, any other single character
+TOKEN = re.compile(r'\s+|("(?:\\.|[^"\\])*"?|\'(?:\\.|[^\'\\])*\'?|[A-Za-z_]\w*|(?:\d|\.\d)(?:[eEpP][+-]|[\w.])*|' +
+                   '|'.join(re.escape(p) for p in PUNCTUATORS) + '|.)', re.ASCII | re.DOTALL)
+
+
+def tokenize(text):
+    return [token for token in TOKEN.findall(text) if token]
+
+
+def fnv1a(tokens):
+    digest = 0xcbf29ce484222325
+    for token in tokens:
+        for b in (token + '\n').encode('latin-1'):
+            digest = ((digest ^ b) * 0x100000001b3) & 0xffffffffffffffff
+    return digest
+
+
+def read_permutations(path):
+    """(name, source, defines) for every fxc line of a .bat file, %AOFX_VIEWPORT_SCALE% left in"""
+    commands = {}
+    permutations = []
+    for line in open(path):
+        line = line.strip()
+        match = re.match(r'(?i)set (FXC_\w+)=(.*)', line)
+        if match:
+            commands[match.group(1)] = match.group(2)
+            continue
+        match = re.match(r'%(FXC_\w+)%(.*)', line)
+        if match:
+            arguments = (commands[match.group(1)] + ' ' + match.group(2)).split()
+            source = [a for a in arguments if a.lower().endswith('.hlsl')][0]
+            source = source.replace('\\', '/').replace('../', '', 1)
+            defines = [a[2:] for a in arguments if a.startswith('/D')]
+            name = re.sub(r'_(Data|DATA)$', '', arguments[arguments.index('/Vn') + 1])
+            permutations.append((name, source, defines))
+    return permutations
+
+
+def find_without_case(directory, name):
+    """the path of an #include as on Windows: backslashes and any case"""
+    path = directory
+    for component in name.replace('\\', '/').split('/'):
+        candidate = os.path.join(path, component)
+        if component not in ('.', '..') and not os.path.exists(candidate) and os.path.isdir(path):
+            for entry in os.listdir(path):
+                if entry.lower() == component.lower():
+                    candidate = os.path.join(path, entry)
+                    break
+        path = candidate
+    return os.path.relpath(path, directory).replace(os.sep, '/')
+
+
+def stage_sources(stage):
+    for shader_dir in SHADER_DIRS:
+        shutil.copytree(os.path.join(ROOT_DIR, shader_dir), os.path.join(stage, shader_dir))
+    for shader_dir in SHADER_DIRS:
+        for directory, _, files in os.walk(os.path.join(stage, shader_dir)):
+            for name in files:
+                if not name.endswith('.hlsl'):
+                    continue
+                path = os.path.join(directory, name)
+                text = open(path, encoding='latin-1').read()
+                fixed = re.sub(r'(#\s*include\s*")([^"]*)(")',
+                               lambda m: m.group(1) + find_without_case(directory, m.group(2).replace('\\\\', '\\')) + m.group(3), text)
+                if fixed != text:
+                    open(path, 'w', encoding='latin-1').write(fixed)
+
+
+def golden_line(job):
+    stage, name, source, defines = job
+    result = subprocess.run(CPP + ['-D' + d for d in defines] + [os.path.join(stage, SHADER_DIRS[0], source)],
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+    if result.returncode != 0:
+        raise ValueError('%s: %s' % (name, result.stderr))
+    tokens = tokenize(result.stdout)
+    return '%s %s %d %016x %s' % (name, source, len(tokens), fnv1a(tokens), ' '.join(defines))
+
+
+def main():
+    verify = '--verify' in sys.argv[1:]
+
+    permutations = []
+    for bat in sorted(os.listdir(BUILD_DIR)):
+        if bat.endswith('.bat'):
+            permutations += read_permutations(os.path.join(BUILD_DIR, bat))
+
+    out = []
+    out.append('# Generated by aofx_goldens.py from amd_aofx/src/Shaders/build/*.bat with %s, do not edit' % ' '.join(CPP))
+    out.append('# name source tokens fnv1a defines...')
+
+    stage = tempfile.mkdtemp()
+    try:
+        stage_sources(stage)
+        jobs = []
+        for scale in VIEWPORT_SCALES:
+            for name, source, defines in permutations:
+                jobs.append((stage, name, source, [d.replace('%AOFX_VIEWPORT_SCALE%', scale) for d in defines]))
+        with multiprocessing.Pool() as pool:
+            out += pool.map(golden_line, jobs)
+    finally:
+        shutil.rmtree(stage)
+
+    text = '\n'.join(out) + '\n'
+    if verify:
+        if not os.path.exists(GOLDEN) or open(GOLDEN).read() != text:
+            print('%s is out of date, run aofx_goldens.py' % GOLDEN)
+            sys.exit(1)
+    else:
+        with open(GOLDEN, 'w') as f:
+            f.write(text)
+
+    print('%d permutations' % (len(out) - 2))
+
+if __name__ == '__main__':
+    main()
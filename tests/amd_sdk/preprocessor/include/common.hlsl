@@ -0,0 +1,7 @@
+#pragma once
+
+/* block comments
+   spanning lines */
+#define TAPS ( 4 * QUALITY )
+#define LOW( uv ) tex.Sample( samp, uv )
+Texture2D tex : register( t0 ); SamplerState samp : register( s0 );
@@ -0,0 +1,13 @@
+#ifndef KERNEL_HLSL
+#define KERNEL_HLSL
+
+#include "../shared.hlsl"
+
+#define KERNEL( uv, q ) Kernel##q( uv, TAPS )
+
+float4 KERNEL( float2 uv, QUALITY ) \
+{ \
+    return SHARED_SCALE * LOW( uv ); \
+}
+
+#endif
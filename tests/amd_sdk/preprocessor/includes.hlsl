@@ -0,0 +1,12 @@
+// Includes resolve relative to the including file, and #pragma once files are read once
+#include "include\\common.hlsl"
+#include "include/common.hlsl"
+#include "include/kernel.hlsl"
+
+#if QUALITY >= 2 && defined( USE_KERNEL )
+float4 main( float2 uv : TEXCOORD ) : SV_Target { return KERNEL( uv, QUALITY ); }
+#elif QUALITY == 1
+float4 main( float2 uv : TEXCOORD ) : SV_Target { return LOW( uv ); }
+#else
+#error "unsupported quality"
+#endif
@@ -0,0 +1,41 @@
+#define x 3
+#define f(a) f(x * (a))
+#undef x
+#define x 2
+#define g f
+#define z z[0]
+#define h g(~
+#define m(a) a(w)
+#define w 0,1
+#define t(a) a
+#define p() int
+#define q(x) x
+#define r(x,y) x ## y
+#define str(x) # x
+#define xstr(x) str(x)
+#define hash_hash # ## #
+#define mkstr(a) # a
+#define in_between(a) mkstr(a)
+#define join(c, d) in_between(c hash_hash d)
+#define VA(fmt, ...) call(fmt, __VA_ARGS__)
+#define CAT(a,b) a##b
+#define EMPTY
+#if defined(x) && (x * 4 - 1) == 7 && !defined y && (1 ? 2 : 3) == 2 && (0x10 >> 2) == 4 && -1 < 0 && 10 % 3 == 1
+ok1
+#elif 1
+bad
+#endif
+#ifdef nothing
+# garbage directive inside inactive
+#else
+ok2
+#endif
+f(y+1) + f(f(z)) % t(t(g)(0) + t)(1);
+g(x+(3,4)-w) | h 5) & m
+(f)^m(m);
+p() i[q()] = { q(1), r(2,3), r(4,), r(,5), r(,) };
+char c[2][6] = { str(hello), str() };
+char s[] = join(x, y);
+VA("%d %d", 1, 2) VA("x") CAT(foo, bar) CAT(, EMPTY) CAT(1, .5e+3)
+#pragma warning( disable : 3571 )
+xstr(x "a\n" 'b')
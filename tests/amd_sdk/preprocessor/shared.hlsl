@@ -0,0 +1,3 @@
+#if !defined( SHARED_SCALE )
+# define SHARED_SCALE 0.5f
+#endif
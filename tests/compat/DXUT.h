@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: DXUT.h
+//
+// The part of DXUT the portable SDK helpers use, for the non-Windows test build. There is no
+// window or swap chain: DXUTGetD3D11Device returns the device a test installed with
+// CompatDXUT::device(), usually one from AOFX_CreateNullDevice, and the back buffer is a fixed
+// 1280x720 surface.
+//--------------------------------------------------------------------------------------
+
+#ifndef _AMD_TESTS_COMPAT_DXUT_H_
+#define _AMD_TESTS_COMPAT_DXUT_H_
+
+#include <windows.h>
+#include <d3d11.h>
+#include <cassert>
+
+#ifndef SAFE_DELETE
+#define SAFE_DELETE(p)                  { if (p) { delete (p); (p) = NULL; } }
+#endif
+#ifndef SAFE_DELETE_ARRAY
+#define SAFE_DELETE_ARRAY(p)            { if (p) { delete[] (p); (p) = NULL; } }
+#endif
+#ifndef SAFE_RELEASE
+#define SAFE_RELEASE(p)                 { if (p) { (p)->Release(); (p) = NULL; } }
+#endif
+
+namespace DirectX
+{
+    struct XMVECTOR { float v[4]; };
+    typedef const XMVECTOR FXMVECTOR;
+
+    inline XMVECTOR XMVectorSet(float x, float y, float z, float w)
+    {
+        XMVECTOR result = { { x, y, z, w } };
+        return result;
+    }
+}
+
+struct DXGI_SURFACE_DESC
+{
+    UINT Width;
+    UINT Height;
+    DXGI_FORMAT Format;
+    DXGI_SAMPLE_DESC SampleDesc;
+};
+
+namespace CompatDXUT
+{
+    inline ID3D11Device *& device() { static ID3D11Device * pDevice = NULL; return pDevice; }
+}
+
+inline ID3D11Device * WINAPI DXUTGetD3D11Device() { return CompatDXUT::device(); }
+
+inline const DXGI_SURFACE_DESC * WINAPI DXUTGetDXGIBackBufferSurfaceDesc()
+{
+    static const DXGI_SURFACE_DESC desc = { 1280, 720, DXGI_FORMAT_R8G8B8A8_UNORM, { 1, 0 } };
+    return &desc;
+}
+
+#endif // _AMD_TESTS_COMPAT_DXUT_H_
@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: SDKmisc.h
+//
+// CDXUTTextHelper for the non-Windows test build, see DXUT.h. Nothing is drawn, the lines
+// between Begin() and End() are kept so tests can read what would have been on screen.
+//--------------------------------------------------------------------------------------
+
+#ifndef _AMD_TESTS_COMPAT_SDKMISC_H_
+#define _AMD_TESTS_COMPAT_SDKMISC_H_
+
+#include "DXUT.h"
+
+#include <string>
+#include <vector>
+
+class CDXUTTextHelper
+{
+public:
+    CDXUTTextHelper() : m_x(0), m_y(0) {}
+
+    void SetInsertionPos(int x, int y) { m_x = x; m_y = y; }
+    void SetForegroundColor(DirectX::FXMVECTOR) {}
+
+    void Begin() { m_Lines.clear(); }
+    HRESULT DrawTextLine(const WCHAR * strMsg) { m_Lines.push_back(strMsg); return S_OK; }
+    void End() {}
+
+    const std::vector<std::wstring> & GetLines() const { return m_Lines; }
+
+private:
+    int m_x;
+    int m_y;
+    std::vector<std::wstring> m_Lines;
+};
+
+#endif // _AMD_TESTS_COMPAT_SDKMISC_H_
@@ -0,0 +1,813 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: d3d11.h
+//
+// The subset of the Direct3D 11 headers the portable test build needs on non-Windows
+// hosts. Only used by tests/CMakeLists.txt when WIN32 is not set. The interfaces declare
+// the methods of the platform SDK by name, so AOFX_CreateNullDevice implements them as is.
+//--------------------------------------------------------------------------------------
+
+#ifndef _AMD_TESTS_COMPAT_D3D11_H_
+#define _AMD_TESTS_COMPAT_D3D11_H_
+
+#include <windows.h>
+#include <dxgiformat.h>
+
+#define DXGI_ERROR_INVALID_CALL                                     ((HRESULT)0x887A0001L)
+#define DXGI_ERROR_NOT_FOUND                                        ((HRESULT)0x887A0002L)
+
+//--------------------------------------------------------------------------------------
+// Limits
+//--------------------------------------------------------------------------------------
+#define D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT           14
+#define D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT                128
+#define D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT                       16
+#define D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT                      8
+#define D3D11_PS_CS_UAV_REGISTER_COUNT                              8
+#define D3D11_1_UAV_SLOT_COUNT                                      64
+#define D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT                   32
+#define D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE    16
+#define D3D11_KEEP_UNORDERED_ACCESS_VIEWS                           0xffffffff
+#define D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL                 0xffffffff
+#define D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT                     4096
+#define D3D11_REQ_MIP_LEVELS                                        15
+#define D3D11_REQ_TEXTURE1D_ARRAY_AXIS_DIMENSION                    2048
+#define D3D11_REQ_TEXTURE1D_U_DIMENSION                             16384
+#define D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION                    2048
+#define D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION                        16384
+#define D3D11_REQ_TEXTURE3D_U_V_OR_W_DIMENSION                      2048
+#define D3D11_REQ_TEXTURECUBE_DIMENSION                             16384
+#define D3D_FL9_1_REQ_TEXTURE2D_U_OR_V_DIMENSION                    2048
+#define D3D_FL9_1_REQ_TEXTURE3D_U_V_OR_W_DIMENSION                  256
+#define D3D_FL9_1_REQ_TEXTURECUBE_DIMENSION                         512
+#define D3D_FL9_3_REQ_TEXTURE2D_U_OR_V_DIMENSION                    4096
+#define D3D11_STANDARD_MULTISAMPLE_PATTERN                          0xffffffff
+
+//--------------------------------------------------------------------------------------
+// Enumerations
+//--------------------------------------------------------------------------------------
+enum D3D_FEATURE_LEVEL
+{
+    D3D_FEATURE_LEVEL_9_1   = 0x9100,
+    D3D_FEATURE_LEVEL_9_2   = 0x9200,
+    D3D_FEATURE_LEVEL_9_3   = 0x9300,
+    D3D_FEATURE_LEVEL_10_0  = 0xa000,
+    D3D_FEATURE_LEVEL_10_1  = 0xa100,
+    D3D_FEATURE_LEVEL_11_0  = 0xb000,
+};
+
+enum D3D11_USAGE
+{
+    D3D11_USAGE_DEFAULT     = 0,
+    D3D11_USAGE_IMMUTABLE   = 1,
+    D3D11_USAGE_DYNAMIC     = 2,
+    D3D11_USAGE_STAGING     = 3,
+};
+
+enum D3D11_BIND_FLAG
+{
+    D3D11_BIND_VERTEX_BUFFER    = 0x1,
+    D3D11_BIND_INDEX_BUFFER     = 0x2,
+    D3D11_BIND_CONSTANT_BUFFER  = 0x4,
+    D3D11_BIND_SHADER_RESOURCE  = 0x8,
+    D3D11_BIND_STREAM_OUTPUT    = 0x10,
+    D3D11_BIND_RENDER_TARGET    = 0x20,
+    D3D11_BIND_DEPTH_STENCIL    = 0x40,
+    D3D11_BIND_UNORDERED_ACCESS = 0x80,
+};
+
+enum D3D11_CPU_ACCESS_FLAG
+{
+    D3D11_CPU_ACCESS_WRITE  = 0x10000,
+    D3D11_CPU_ACCESS_READ   = 0x20000,
+};
+
+enum D3D11_RESOURCE_MISC_FLAG
+{
+    D3D11_RESOURCE_MISC_GENERATE_MIPS       = 0x1,
+    D3D11_RESOURCE_MISC_TEXTURECUBE         = 0x4,
+    D3D11_RESOURCE_MISC_BUFFER_STRUCTURED   = 0x40,
+};
+
+enum D3D11_FORMAT_SUPPORT
+{
+    D3D11_FORMAT_SUPPORT_MIP_AUTOGEN    = 0x400,
+};
+
+enum D3D11_CREATE_DEVICE_FLAG
+{
+    D3D11_CREATE_DEVICE_SINGLETHREADED  = 0x1,
+};
+
+enum D3D11_MAP
+{
+    D3D11_MAP_READ                  = 1,
+    D3D11_MAP_WRITE                 = 2,
+    D3D11_MAP_READ_WRITE            = 3,
+    D3D11_MAP_WRITE_DISCARD         = 4,
+    D3D11_MAP_WRITE_NO_OVERWRITE    = 5,
+};
+
+enum D3D11_RESOURCE_DIMENSION
+{
+    D3D11_RESOURCE_DIMENSION_UNKNOWN    = 0,
+    D3D11_RESOURCE_DIMENSION_BUFFER     = 1,
+    D3D11_RESOURCE_DIMENSION_TEXTURE1D  = 2,
+    D3D11_RESOURCE_DIMENSION_TEXTURE2D  = 3,
+    D3D11_RESOURCE_DIMENSION_TEXTURE3D  = 4,
+};
+
+enum D3D_SRV_DIMENSION
+{
+    D3D_SRV_DIMENSION_UNKNOWN               = 0,
+    D3D_SRV_DIMENSION_BUFFER                = 1,
+    D3D_SRV_DIMENSION_TEXTURE1D             = 2,
+    D3D_SRV_DIMENSION_TEXTURE1DARRAY        = 3,
+    D3D_SRV_DIMENSION_TEXTURE2D             = 4,
+    D3D_SRV_DIMENSION_TEXTURE2DARRAY        = 5,
+    D3D_SRV_DIMENSION_TEXTURE2DMS           = 6,
+    D3D_SRV_DIMENSION_TEXTURE2DMSARRAY      = 7,
+    D3D_SRV_DIMENSION_TEXTURE3D             = 8,
+    D3D_SRV_DIMENSION_TEXTURECUBE           = 9,
+    D3D_SRV_DIMENSION_TEXTURECUBEARRAY      = 10,
+
+    D3D11_SRV_DIMENSION_UNKNOWN             = D3D_SRV_DIMENSION_UNKNOWN,
+    D3D11_SRV_DIMENSION_BUFFER              = D3D_SRV_DIMENSION_BUFFER,
+    D3D11_SRV_DIMENSION_TEXTURE1D           = D3D_SRV_DIMENSION_TEXTURE1D,
+    D3D11_SRV_DIMENSION_TEXTURE1DARRAY      = D3D_SRV_DIMENSION_TEXTURE1DARRAY,
+    D3D11_SRV_DIMENSION_TEXTURE2D           = D3D_SRV_DIMENSION_TEXTURE2D,
+    D3D11_SRV_DIMENSION_TEXTURE2DARRAY      = D3D_SRV_DIMENSION_TEXTURE2DARRAY,
+    D3D11_SRV_DIMENSION_TEXTURE2DMS         = D3D_SRV_DIMENSION_TEXTURE2DMS,
+    D3D11_SRV_DIMENSION_TEXTURE2DMSARRAY    = D3D_SRV_DIMENSION_TEXTURE2DMSARRAY,
+    D3D11_SRV_DIMENSION_TEXTURE3D           = D3D_SRV_DIMENSION_TEXTURE3D,
+    D3D11_SRV_DIMENSION_TEXTURECUBE         = D3D_SRV_DIMENSION_TEXTURECUBE,
+    D3D11_SRV_DIMENSION_TEXTURECUBEARRAY    = D3D_SRV_DIMENSION_TEXTURECUBEARRAY,
+};
+typedef D3D_SRV_DIMENSION D3D11_SRV_DIMENSION;
+
+enum D3D11_RTV_DIMENSION
+{
+    D3D11_RTV_DIMENSION_UNKNOWN             = 0,
+    D3D11_RTV_DIMENSION_BUFFER              = 1,
+    D3D11_RTV_DIMENSION_TEXTURE2D           = 4,
+    D3D11_RTV_DIMENSION_TEXTURE2DARRAY      = 5,
+    D3D11_RTV_DIMENSION_TEXTURE2DMS         = 6,
+    D3D11_RTV_DIMENSION_TEXTURE2DMSARRAY    = 7,
+};
+
+enum D3D11_DSV_DIMENSION
+{
+    D3D11_DSV_DIMENSION_UNKNOWN             = 0,
+    D3D11_DSV_DIMENSION_TEXTURE2D           = 3,
+    D3D11_DSV_DIMENSION_TEXTURE2DARRAY      = 4,
+    D3D11_DSV_DIMENSION_TEXTURE2DMS         = 5,
+    D3D11_DSV_DIMENSION_TEXTURE2DMSARRAY    = 6,
+};
+
+enum D3D11_DSV_FLAG
+{
+    D3D11_DSV_READ_ONLY_DEPTH   = 0x1,
+    D3D11_DSV_READ_ONLY_STENCIL = 0x2,
+};
+
+enum D3D11_UAV_DIMENSION
+{
+    D3D11_UAV_DIMENSION_UNKNOWN         = 0,
+    D3D11_UAV_DIMENSION_BUFFER          = 1,
+    D3D11_UAV_DIMENSION_TEXTURE2D       = 4,
+    D3D11_UAV_DIMENSION_TEXTURE2DARRAY  = 5,
+};
+
+enum D3D11_FILTER
+{
+    D3D11_FILTER_MIN_MAG_MIP_POINT  = 0,
+    D3D11_FILTER_MIN_MAG_MIP_LINEAR = 0x15,
+};
+
+enum D3D11_TEXTURE_ADDRESS_MODE
+{
+    D3D11_TEXTURE_ADDRESS_WRAP  = 1,
+    D3D11_TEXTURE_ADDRESS_CLAMP = 3,
+};
+
+enum D3D11_CULL_MODE
+{
+    D3D11_CULL_NONE = 1,
+    D3D11_CULL_BACK = 3,
+};
+
+enum D3D_PRIMITIVE_TOPOLOGY
+{
+    D3D_PRIMITIVE_TOPOLOGY_UNDEFINED        = 0,
+    D3D_PRIMITIVE_TOPOLOGY_LINELIST         = 2,
+    D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST     = 4,
+
+    D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED      = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED,
+    D3D11_PRIMITIVE_TOPOLOGY_LINELIST       = D3D_PRIMITIVE_TOPOLOGY_LINELIST,
+    D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST   = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+};
+typedef D3D_PRIMITIVE_TOPOLOGY D3D11_PRIMITIVE_TOPOLOGY;
+
+enum D3D11_FEATURE
+{
+    D3D11_FEATURE_D3D11_OPTIONS = 7,
+};
+
+enum D3D11_DEVICE_CONTEXT_TYPE
+{
+    D3D11_DEVICE_CONTEXT_IMMEDIATE  = 0,
+    D3D11_DEVICE_CONTEXT_DEFERRED   = 1,
+};
+
+enum D3D11_COUNTER_TYPE
+{
+    D3D11_COUNTER_TYPE_FLOAT32  = 0,
+};
+
+//--------------------------------------------------------------------------------------
+// Descriptions
+//--------------------------------------------------------------------------------------
+struct CD3D11_DEFAULT {};
+
+typedef RECT D3D11_RECT;
+
+struct D3D11_BOX
+{
+    UINT left, top, front;
+    UINT right, bottom, back;
+};
+
+struct D3D11_VIEWPORT
+{
+    FLOAT TopLeftX, TopLeftY, Width, Height, MinDepth, MaxDepth;
+};
+
+struct CD3D11_VIEWPORT : public D3D11_VIEWPORT
+{
+    CD3D11_VIEWPORT() {}
+    CD3D11_VIEWPORT(FLOAT x, FLOAT y, FLOAT w, FLOAT h, FLOAT minDepth = 0.0f, FLOAT maxDepth = 1.0f)
+    {
+        TopLeftX = x; TopLeftY = y; Width = w; Height = h; MinDepth = minDepth; MaxDepth = maxDepth;
+    }
+};
+
+struct D3D11_MAPPED_SUBRESOURCE
+{
+    void * pData;
+    UINT RowPitch;
+    UINT DepthPitch;
+};
+
+struct D3D11_SUBRESOURCE_DATA
+{
+    const void * pSysMem;
+    UINT SysMemPitch;
+    UINT SysMemSlicePitch;
+};
+
+struct DXGI_SAMPLE_DESC
+{
+    UINT Count;
+    UINT Quality;
+};
+
+struct D3D11_BUFFER_DESC
+{
+    UINT ByteWidth;
+    D3D11_USAGE Usage;
+    UINT BindFlags;
+    UINT CPUAccessFlags;
+    UINT MiscFlags;
+    UINT StructureByteStride;
+};
+
+struct CD3D11_BUFFER_DESC : public D3D11_BUFFER_DESC
+{
+    CD3D11_BUFFER_DESC() {}
+    CD3D11_BUFFER_DESC(UINT byteWidth, UINT bindFlags, D3D11_USAGE usage = D3D11_USAGE_DEFAULT, UINT cpuAccessFlags = 0, UINT miscFlags = 0, UINT structureByteStride = 0)
+    {
+        ByteWidth = byteWidth; Usage = usage; BindFlags = bindFlags; CPUAccessFlags = cpuAccessFlags; MiscFlags = miscFlags; StructureByteStride = structureByteStride;
+    }
+};
+
+struct D3D11_TEXTURE1D_DESC
+{
+    UINT Width;
+    UINT MipLevels;
+    UINT ArraySize;
+    DXGI_FORMAT Format;
+    D3D11_USAGE Usage;
+    UINT BindFlags;
+    UINT CPUAccessFlags;
+    UINT MiscFlags;
+};
+
+struct D3D11_TEXTURE2D_DESC
+{
+    UINT Width;
+    UINT Height;
+    UINT MipLevels;
+    UINT ArraySize;
+    DXGI_FORMAT Format;
+    DXGI_SAMPLE_DESC SampleDesc;
+    D3D11_USAGE Usage;
+    UINT BindFlags;
+    UINT CPUAccessFlags;
+    UINT MiscFlags;
+};
+
+struct D3D11_TEXTURE3D_DESC
+{
+    UINT Width;
+    UINT Height;
+    UINT Depth;
+    UINT MipLevels;
+    DXGI_FORMAT Format;
+    D3D11_USAGE Usage;
+    UINT BindFlags;
+    UINT CPUAccessFlags;
+    UINT MiscFlags;
+};
+
+struct D3D11_BUFFER_SRV         { UINT FirstElement; UINT NumElements; };
+struct D3D11_TEX1D_SRV          { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEX1D_ARRAY_SRV    { UINT MostDetailedMip; UINT MipLevels; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2D_SRV          { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEX2D_ARRAY_SRV    { UINT MostDetailedMip; UINT MipLevels; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2DMS_SRV        { UINT UnusedField_NothingToDefine; };
+struct D3D11_TEX2DMS_ARRAY_SRV  { UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX3D_SRV          { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEXCUBE_SRV        { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEXCUBE_ARRAY_SRV  { UINT MostDetailedMip; UINT MipLevels; UINT First2DArrayFace; UINT NumCubes; };
+
+struct D3D11_SHADER_RESOURCE_VIEW_DESC
+{
+    DXGI_FORMAT Format;
+    D3D11_SRV_DIMENSION ViewDimension;
+    union
+    {
+        D3D11_BUFFER_SRV Buffer;
+        D3D11_TEX1D_SRV Texture1D;
+        D3D11_TEX1D_ARRAY_SRV Texture1DArray;
+        D3D11_TEX2D_SRV Texture2D;
+        D3D11_TEX2D_ARRAY_SRV Texture2DArray;
+        D3D11_TEX2DMS_SRV Texture2DMS;
+        D3D11_TEX2DMS_ARRAY_SRV Texture2DMSArray;
+        D3D11_TEX3D_SRV Texture3D;
+        D3D11_TEXCUBE_SRV TextureCube;
+        D3D11_TEXCUBE_ARRAY_SRV TextureCubeArray;
+    };
+};
+
+struct D3D11_TEX2D_RTV          { UINT MipSlice; };
+struct D3D11_TEX2D_ARRAY_RTV    { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2DMS_RTV        { UINT UnusedField_NothingToDefine; };
+struct D3D11_TEX2DMS_ARRAY_RTV  { UINT FirstArraySlice; UINT ArraySize; };
+
+struct D3D11_RENDER_TARGET_VIEW_DESC
+{
+    DXGI_FORMAT Format;
+    D3D11_RTV_DIMENSION ViewDimension;
+    union
+    {
+        D3D11_TEX2D_RTV Texture2D;
+        D3D11_TEX2D_ARRAY_RTV Texture2DArray;
+        D3D11_TEX2DMS_RTV Texture2DMS;
+        D3D11_TEX2DMS_ARRAY_RTV Texture2DMSArray;
+    };
+};
+
+struct D3D11_TEX2D_DSV          { UINT MipSlice; };
+struct D3D11_TEX2D_ARRAY_DSV    { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2DMS_DSV        { UINT UnusedField_NothingToDefine; };
+struct D3D11_TEX2DMS_ARRAY_DSV  { UINT FirstArraySlice; UINT ArraySize; };
+
+struct D3D11_DEPTH_STENCIL_VIEW_DESC
+{
+    DXGI_FORMAT Format;
+    D3D11_DSV_DIMENSION ViewDimension;
+    UINT Flags;
+    union
+    {
+        D3D11_TEX2D_DSV Texture2D;
+        D3D11_TEX2D_ARRAY_DSV Texture2DArray;
+        D3D11_TEX2DMS_DSV Texture2DMS;
+        D3D11_TEX2DMS_ARRAY_DSV Texture2DMSArray;
+    };
+};
+
+struct D3D11_BUFFER_UAV         { UINT FirstElement; UINT NumElements; UINT Flags; };
+struct D3D11_TEX2D_UAV          { UINT MipSlice; };
+struct D3D11_TEX2D_ARRAY_UAV    { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+
+struct D3D11_UNORDERED_ACCESS_VIEW_DESC
+{
+    DXGI_FORMAT Format;
+    D3D11_UAV_DIMENSION ViewDimension;
+    union
+    {
+        D3D11_BUFFER_UAV Buffer;
+        D3D11_TEX2D_UAV Texture2D;
+        D3D11_TEX2D_ARRAY_UAV Texture2DArray;
+    };
+};
+
+struct D3D11_SAMPLER_DESC
+{
+    D3D11_FILTER Filter;
+    D3D11_TEXTURE_ADDRESS_MODE AddressU;
+    D3D11_TEXTURE_ADDRESS_MODE AddressV;
+    D3D11_TEXTURE_ADDRESS_MODE AddressW;
+    FLOAT MipLODBias;
+    UINT MaxAnisotropy;
+    UINT ComparisonFunc;
+    FLOAT BorderColor[4];
+    FLOAT MinLOD;
+    FLOAT MaxLOD;
+};
+
+struct CD3D11_SAMPLER_DESC : public D3D11_SAMPLER_DESC
+{
+    explicit CD3D11_SAMPLER_DESC(CD3D11_DEFAULT)
+    {
+        memset(this, 0, sizeof(*this));
+        Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        AddressU = AddressV = AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        MaxAnisotropy = 1;
+        MaxLOD = 3.402823466e+38f;
+    }
+};
+
+struct D3D11_RENDER_TARGET_BLEND_DESC
+{
+    BOOL BlendEnable;
+    UINT SrcBlend, DestBlend, BlendOp;
+    UINT SrcBlendAlpha, DestBlendAlpha, BlendOpAlpha;
+    UINT8 RenderTargetWriteMask;
+};
+
+struct D3D11_BLEND_DESC
+{
+    BOOL AlphaToCoverageEnable;
+    BOOL IndependentBlendEnable;
+    D3D11_RENDER_TARGET_BLEND_DESC RenderTarget[8];
+};
+
+struct CD3D11_BLEND_DESC : public D3D11_BLEND_DESC
+{
+    explicit CD3D11_BLEND_DESC(CD3D11_DEFAULT)
+    {
+        memset(this, 0, sizeof(*this));
+        for (UINT i = 0; i < 8; ++i) RenderTarget[i].RenderTargetWriteMask = 0xf;
+    }
+};
+
+struct D3D11_RASTERIZER_DESC
+{
+    UINT FillMode;
+    D3D11_CULL_MODE CullMode;
+    BOOL FrontCounterClockwise;
+    INT DepthBias;
+    FLOAT DepthBiasClamp;
+    FLOAT SlopeScaledDepthBias;
+    BOOL DepthClipEnable;
+    BOOL ScissorEnable;
+    BOOL MultisampleEnable;
+    BOOL AntialiasedLineEnable;
+};
+
+struct CD3D11_RASTERIZER_DESC : public D3D11_RASTERIZER_DESC
+{
+    explicit CD3D11_RASTERIZER_DESC(CD3D11_DEFAULT)
+    {
+        memset(this, 0, sizeof(*this));
+        FillMode = 3;
+        CullMode = D3D11_CULL_BACK;
+        DepthClipEnable = TRUE;
+    }
+};
+
+struct D3D11_DEPTH_STENCIL_DESC
+{
+    BOOL DepthEnable;
+    UINT DepthWriteMask;
+    UINT DepthFunc;
+    BOOL StencilEnable;
+};
+
+struct D3D11_FEATURE_DATA_D3D11_OPTIONS
+{
+    BOOL OutputMergerLogicOp;
+    BOOL UAVOnlyRenderingForcedSampleCount;
+    BOOL DiscardAPIsSeenByDriver;
+    BOOL FlagsForUpdateAndCopySeenByDriver;
+    BOOL ClearView;
+    BOOL CopyWithOverlap;
+    BOOL ConstantBufferPartialUpdate;
+    BOOL ConstantBufferOffsetting;
+    BOOL MapNoOverwriteOnDynamicConstantBuffer;
+    BOOL MapNoOverwriteOnDynamicBufferSRV;
+    BOOL MultisampleRTVWithForcedSampleCountOne;
+    BOOL SAD4ShaderInstructions;
+    BOOL ExtendedDoublesShaderInstructions;
+    BOOL ExtendedResourceSharing;
+};
+
+struct D3D11_INPUT_ELEMENT_DESC     { LPCSTR SemanticName; UINT SemanticIndex; DXGI_FORMAT Format; UINT InputSlot; UINT AlignedByteOffset; UINT InputSlotClass; UINT InstanceDataStepRate; };
+struct D3D11_SO_DECLARATION_ENTRY   { UINT Stream; LPCSTR SemanticName; UINT SemanticIndex; BYTE StartComponent; BYTE ComponentCount; BYTE OutputSlot; };
+struct D3D11_QUERY_DESC             { UINT Query; UINT MiscFlags; };
+struct D3D11_COUNTER_DESC           { UINT Counter; UINT MiscFlags; };
+struct D3D11_COUNTER_INFO           { UINT LastDeviceDependentCounter; UINT NumSimultaneousCounters; UINT8 NumDetectableParallelUnits; };
+
+inline UINT D3D11CalcSubresource(UINT mipSlice, UINT arraySlice, UINT mipLevels) { return mipSlice + arraySlice * mipLevels; }
+
+//--------------------------------------------------------------------------------------
+// Interfaces
+//--------------------------------------------------------------------------------------
+struct ID3D11Device;
+
+struct IUnknown
+{
+    virtual HRESULT QueryInterface(REFIID, void**) = 0;
+    virtual ULONG AddRef() = 0;
+    virtual ULONG Release() = 0;
+};
+
+struct ID3D11DeviceChild : public IUnknown
+{
+    virtual void GetDevice(ID3D11Device**) = 0;
+    virtual HRESULT GetPrivateData(REFGUID, UINT*, void*) = 0;
+    virtual HRESULT SetPrivateData(REFGUID, UINT, const void*) = 0;
+    virtual HRESULT SetPrivateDataInterface(REFGUID, const IUnknown*) = 0;
+};
+
+struct ID3D11Resource : public ID3D11DeviceChild
+{
+    virtual void GetType(D3D11_RESOURCE_DIMENSION*) = 0;
+    virtual void SetEvictionPriority(UINT) = 0;
+    virtual UINT GetEvictionPriority() = 0;
+};
+
+struct ID3D11Buffer : public ID3D11Resource
+{
+    virtual void GetDesc(D3D11_BUFFER_DESC*) = 0;
+};
+
+struct ID3D11Texture1D : public ID3D11Resource {};
+struct ID3D11Texture3D : public ID3D11Resource {};
+
+struct ID3D11Texture2D : public ID3D11Resource
+{
+    virtual void GetDesc(D3D11_TEXTURE2D_DESC*) = 0;
+};
+
+struct ID3D11View : public ID3D11DeviceChild
+{
+    virtual void GetResource(ID3D11Resource**) = 0;
+};
+
+struct ID3D11ShaderResourceView : public ID3D11View
+{
+    virtual void GetDesc(D3D11_SHADER_RESOURCE_VIEW_DESC*) = 0;
+};
+
+struct ID3D11RenderTargetView : public ID3D11View
+{
+    virtual void GetDesc(D3D11_RENDER_TARGET_VIEW_DESC*) = 0;
+};
+
+struct ID3D11DepthStencilView : public ID3D11View
+{
+    virtual void GetDesc(D3D11_DEPTH_STENCIL_VIEW_DESC*) = 0;
+};
+
+struct ID3D11UnorderedAccessView : public ID3D11View
+{
+    virtual void GetDesc(D3D11_UNORDERED_ACCESS_VIEW_DESC*) = 0;
+};
+
+struct ID3D11VertexShader : public ID3D11DeviceChild {};
+
+struct ID3D11PixelShader : public ID3D11DeviceChild {};
+
+struct ID3D11ComputeShader : public ID3D11DeviceChild {};
+
+struct ID3D11GeometryShader : public ID3D11DeviceChild {};
+
+struct ID3D11HullShader : public ID3D11DeviceChild {};
+
+struct ID3D11DomainShader : public ID3D11DeviceChild {};
+
+struct ID3D11ClassInstance : public ID3D11DeviceChild {};
+
+struct ID3D11ClassLinkage : public ID3D11DeviceChild {};
+
+struct ID3D11CommandList : public ID3D11DeviceChild {};
+
+struct ID3D11SamplerState : public ID3D11DeviceChild
+{
+    virtual void GetDesc(D3D11_SAMPLER_DESC*) = 0;
+};
+
+struct ID3D11BlendState : public ID3D11DeviceChild
+{
+    virtual void GetDesc(D3D11_BLEND_DESC*) = 0;
+};
+
+struct ID3D11RasterizerState : public ID3D11DeviceChild
+{
+    virtual void GetDesc(D3D11_RASTERIZER_DESC*) = 0;
+};
+
+struct ID3D11DepthStencilState : public ID3D11DeviceChild
+{
+    virtual void GetDesc(D3D11_DEPTH_STENCIL_DESC*) = 0;
+};
+
+struct ID3D11InputLayout : public ID3D11DeviceChild {};
+
+struct ID3D11Asynchronous : public ID3D11DeviceChild
+{
+    virtual UINT GetDataSize() = 0;
+};
+
+struct ID3D11Query : public ID3D11Asynchronous {};
+
+struct ID3D11Predicate : public ID3D11Query {};
+
+struct ID3D11Counter : public ID3D11Asynchronous {};
+
+struct ID3D11DeviceContext;
+
+struct ID3D11Device : public IUnknown
+{
+    virtual HRESULT CreateBuffer(const D3D11_BUFFER_DESC*, const D3D11_SUBRESOURCE_DATA*, ID3D11Buffer**) = 0;
+    virtual HRESULT CreateTexture1D(const D3D11_TEXTURE1D_DESC*, const D3D11_SUBRESOURCE_DATA*, ID3D11Texture1D**) = 0;
+    virtual HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC*, const D3D11_SUBRESOURCE_DATA*, ID3D11Texture2D**) = 0;
+    virtual HRESULT CreateTexture3D(const D3D11_TEXTURE3D_DESC*, const D3D11_SUBRESOURCE_DATA*, ID3D11Texture3D**) = 0;
+    virtual HRESULT CreateShaderResourceView(ID3D11Resource*, const D3D11_SHADER_RESOURCE_VIEW_DESC*, ID3D11ShaderResourceView**) = 0;
+    virtual HRESULT CreateUnorderedAccessView(ID3D11Resource*, const D3D11_UNORDERED_ACCESS_VIEW_DESC*, ID3D11UnorderedAccessView**) = 0;
+    virtual HRESULT CreateRenderTargetView(ID3D11Resource*, const D3D11_RENDER_TARGET_VIEW_DESC*, ID3D11RenderTargetView**) = 0;
+    virtual HRESULT CreateDepthStencilView(ID3D11Resource*, const D3D11_DEPTH_STENCIL_VIEW_DESC*, ID3D11DepthStencilView**) = 0;
+    virtual HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC*, UINT, const void*, SIZE_T, ID3D11InputLayout**) = 0;
+    virtual HRESULT CreateVertexShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11VertexShader**) = 0;
+    virtual HRESULT CreateGeometryShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11GeometryShader**) = 0;
+    virtual HRESULT CreateGeometryShaderWithStreamOutput(const void*, SIZE_T, const D3D11_SO_DECLARATION_ENTRY*, UINT, const UINT*, UINT, UINT, ID3D11ClassLinkage*, ID3D11GeometryShader**) = 0;
+    virtual HRESULT CreatePixelShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11PixelShader**) = 0;
+    virtual HRESULT CreateHullShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11HullShader**) = 0;
+    virtual HRESULT CreateDomainShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11DomainShader**) = 0;
+    virtual HRESULT CreateComputeShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11ComputeShader**) = 0;
+    virtual HRESULT CreateClassLinkage(ID3D11ClassLinkage**) = 0;
+    virtual HRESULT CreateBlendState(const D3D11_BLEND_DESC*, ID3D11BlendState**) = 0;
+    virtual HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC*, ID3D11DepthStencilState**) = 0;
+    virtual HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC*, ID3D11RasterizerState**) = 0;
+    virtual HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC*, ID3D11SamplerState**) = 0;
+    virtual HRESULT CreateQuery(const D3D11_QUERY_DESC*, ID3D11Query**) = 0;
+    virtual HRESULT CreatePredicate(const D3D11_QUERY_DESC*, ID3D11Predicate**) = 0;
+    virtual HRESULT CreateCounter(const D3D11_COUNTER_DESC*, ID3D11Counter**) = 0;
+    virtual HRESULT CreateDeferredContext(UINT, ID3D11DeviceContext**) = 0;
+    virtual HRESULT OpenSharedResource(HANDLE, REFIID, void**) = 0;
+    virtual HRESULT CheckFormatSupport(DXGI_FORMAT, UINT*) = 0;
+    virtual HRESULT CheckMultisampleQualityLevels(DXGI_FORMAT, UINT, UINT*) = 0;
+    virtual void CheckCounterInfo(D3D11_COUNTER_INFO*) = 0;
+    virtual HRESULT CheckCounter(const D3D11_COUNTER_DESC*, D3D11_COUNTER_TYPE*, UINT*, LPSTR, UINT*, LPSTR, UINT*, LPSTR, UINT*) = 0;
+    virtual HRESULT CheckFeatureSupport(D3D11_FEATURE, void*, UINT) = 0;
+    virtual HRESULT GetPrivateData(REFGUID, UINT*, void*) = 0;
+    virtual HRESULT SetPrivateData(REFGUID, UINT, const void*) = 0;
+    virtual HRESULT SetPrivateDataInterface(REFGUID, const IUnknown*) = 0;
+    virtual D3D_FEATURE_LEVEL GetFeatureLevel() = 0;
+    virtual UINT GetCreationFlags() = 0;
+    virtual HRESULT GetDeviceRemovedReason() = 0;
+    virtual void GetImmediateContext(ID3D11DeviceContext**) = 0;
+    virtual HRESULT SetExceptionMode(UINT) = 0;
+    virtual UINT GetExceptionMode() = 0;
+};
+#define D3D11_COMPAT_STAGE_METHODS(S, SH) \
+    virtual void S##SetConstantBuffers(UINT, UINT, ID3D11Buffer*const*) = 0; \
+    virtual void S##GetConstantBuffers(UINT, UINT, ID3D11Buffer**) = 0; \
+    virtual void S##SetShaderResources(UINT, UINT, ID3D11ShaderResourceView*const*) = 0; \
+    virtual void S##GetShaderResources(UINT, UINT, ID3D11ShaderResourceView**) = 0; \
+    virtual void S##SetSamplers(UINT, UINT, ID3D11SamplerState*const*) = 0; \
+    virtual void S##GetSamplers(UINT, UINT, ID3D11SamplerState**) = 0; \
+    virtual void S##SetShader(SH*, ID3D11ClassInstance*const*, UINT) = 0; \
+    virtual void S##GetShader(SH**, ID3D11ClassInstance**, UINT*) = 0;
+
+struct ID3D11DeviceContext : public ID3D11DeviceChild
+{
+    D3D11_COMPAT_STAGE_METHODS(VS, ID3D11VertexShader)
+    D3D11_COMPAT_STAGE_METHODS(PS, ID3D11PixelShader)
+    D3D11_COMPAT_STAGE_METHODS(CS, ID3D11ComputeShader)
+    D3D11_COMPAT_STAGE_METHODS(GS, ID3D11GeometryShader)
+    D3D11_COMPAT_STAGE_METHODS(HS, ID3D11HullShader)
+    D3D11_COMPAT_STAGE_METHODS(DS, ID3D11DomainShader)
+    virtual HRESULT Map(ID3D11Resource*, UINT, D3D11_MAP, UINT, D3D11_MAPPED_SUBRESOURCE*) = 0;
+    virtual void Unmap(ID3D11Resource*, UINT) = 0;
+    virtual void CSSetUnorderedAccessViews(UINT, UINT, ID3D11UnorderedAccessView*const*, const UINT*) = 0;
+    virtual void CSGetUnorderedAccessViews(UINT, UINT, ID3D11UnorderedAccessView**) = 0;
+    virtual void OMSetRenderTargets(UINT, ID3D11RenderTargetView*const*, ID3D11DepthStencilView*) = 0;
+    virtual void OMGetRenderTargets(UINT, ID3D11RenderTargetView**, ID3D11DepthStencilView**) = 0;
+    virtual void OMSetRenderTargetsAndUnorderedAccessViews(UINT, ID3D11RenderTargetView*const*, ID3D11DepthStencilView*, UINT, UINT, ID3D11UnorderedAccessView*const*, const UINT*) = 0;
+    virtual void OMGetRenderTargetsAndUnorderedAccessViews(UINT, ID3D11RenderTargetView**, ID3D11DepthStencilView**, UINT, UINT, ID3D11UnorderedAccessView**) = 0;
+    virtual void OMSetBlendState(ID3D11BlendState*, const FLOAT[4], UINT) = 0;
+    virtual void OMGetBlendState(ID3D11BlendState**, FLOAT[4], UINT*) = 0;
+    virtual void OMSetDepthStencilState(ID3D11DepthStencilState*, UINT) = 0;
+    virtual void OMGetDepthStencilState(ID3D11DepthStencilState**, UINT*) = 0;
+    virtual void RSSetState(ID3D11RasterizerState*) = 0;
+    virtual void RSGetState(ID3D11RasterizerState**) = 0;
+    virtual void RSSetViewports(UINT, const D3D11_VIEWPORT*) = 0;
+    virtual void RSGetViewports(UINT*, D3D11_VIEWPORT*) = 0;
+    virtual void RSSetScissorRects(UINT, const D3D11_RECT*) = 0;
+    virtual void RSGetScissorRects(UINT*, D3D11_RECT*) = 0;
+    virtual void IASetInputLayout(ID3D11InputLayout*) = 0;
+    virtual void IAGetInputLayout(ID3D11InputLayout**) = 0;
+    virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY) = 0;
+    virtual void IAGetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY*) = 0;
+    virtual void IASetVertexBuffers(UINT, UINT, ID3D11Buffer*const*, const UINT*, const UINT*) = 0;
+    virtual void IAGetVertexBuffers(UINT, UINT, ID3D11Buffer**, UINT*, UINT*) = 0;
+    virtual void IASetIndexBuffer(ID3D11Buffer*, DXGI_FORMAT, UINT) = 0;
+    virtual void IAGetIndexBuffer(ID3D11Buffer**, DXGI_FORMAT*, UINT*) = 0;
+    virtual void SOSetTargets(UINT, ID3D11Buffer*const*, const UINT*) = 0;
+    virtual void SOGetTargets(UINT, ID3D11Buffer**) = 0;
+    virtual void SetPredication(ID3D11Predicate*, BOOL) = 0;
+    virtual void GetPredication(ID3D11Predicate**, BOOL*) = 0;
+    virtual void Draw(UINT, UINT) = 0;
+    virtual void DrawIndexed(UINT, UINT, INT) = 0;
+    virtual void DrawInstanced(UINT, UINT, UINT, UINT) = 0;
+    virtual void DrawIndexedInstanced(UINT, UINT, UINT, INT, UINT) = 0;
+    virtual void DrawAuto() = 0;
+    virtual void DrawInstancedIndirect(ID3D11Buffer*, UINT) = 0;
+    virtual void DrawIndexedInstancedIndirect(ID3D11Buffer*, UINT) = 0;
+    virtual void Dispatch(UINT, UINT, UINT) = 0;
+    virtual void DispatchIndirect(ID3D11Buffer*, UINT) = 0;
+    virtual void UpdateSubresource(ID3D11Resource*, UINT, const D3D11_BOX*, const void*, UINT, UINT) = 0;
+    virtual void CopySubresourceRegion(ID3D11Resource*, UINT, UINT, UINT, UINT, ID3D11Resource*, UINT, const D3D11_BOX*) = 0;
+    virtual void CopyResource(ID3D11Resource*, ID3D11Resource*) = 0;
+    virtual void CopyStructureCount(ID3D11Buffer*, UINT, ID3D11UnorderedAccessView*) = 0;
+    virtual void ResolveSubresource(ID3D11Resource*, UINT, ID3D11Resource*, UINT, DXGI_FORMAT) = 0;
+    virtual void GenerateMips(ID3D11ShaderResourceView*) = 0;
+    virtual void ClearRenderTargetView(ID3D11RenderTargetView*, const FLOAT[4]) = 0;
+    virtual void ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView*, const UINT[4]) = 0;
+    virtual void ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView*, const FLOAT[4]) = 0;
+    virtual void ClearDepthStencilView(ID3D11DepthStencilView*, UINT, FLOAT, UINT8) = 0;
+    virtual void ClearState() = 0;
+    virtual void Begin(ID3D11Asynchronous*) = 0;
+    virtual void End(ID3D11Asynchronous*) = 0;
+    virtual HRESULT GetData(ID3D11Asynchronous*, void*, UINT, UINT) = 0;
+    virtual void SetResourceMinLOD(ID3D11Resource*, FLOAT) = 0;
+    virtual FLOAT GetResourceMinLOD(ID3D11Resource*) = 0;
+    virtual void ExecuteCommandList(ID3D11CommandList*, BOOL) = 0;
+    virtual void Flush() = 0;
+    virtual D3D11_DEVICE_CONTEXT_TYPE GetType() = 0;
+    virtual UINT GetContextFlags() = 0;
+    virtual HRESULT FinishCommandList(BOOL, ID3D11CommandList**) = 0;
+};
+
+#undef D3D11_COMPAT_STAGE_METHODS
+
+struct ID3DDeviceContextState : public ID3D11DeviceChild {};
+
+struct ID3D11DeviceContext1 : public ID3D11DeviceContext
+{
+    virtual void CopySubresourceRegion1(ID3D11Resource*, UINT, UINT, UINT, UINT, ID3D11Resource*, UINT, const D3D11_BOX*, UINT) = 0;
+    virtual void UpdateSubresource1(ID3D11Resource*, UINT, const D3D11_BOX*, const void*, UINT, UINT, UINT) = 0;
+    virtual void DiscardResource(ID3D11Resource*) = 0;
+    virtual void DiscardView(ID3D11View*) = 0;
+    virtual void VSSetConstantBuffers1(UINT, UINT, ID3D11Buffer*const*, const UINT*, const UINT*) = 0;
+    virtual void HSSetConstantBuffers1(UINT, UINT, ID3D11Buffer*const*, const UINT*, const UINT*) = 0;
+    virtual void DSSetConstantBuffers1(UINT, UINT, ID3D11Buffer*const*, const UINT*, const UINT*) = 0;
+    virtual void GSSetConstantBuffers1(UINT, UINT, ID3D11Buffer*const*, const UINT*, const UINT*) = 0;
+    virtual void PSSetConstantBuffers1(UINT, UINT, ID3D11Buffer*const*, const UINT*, const UINT*) = 0;
+    virtual void CSSetConstantBuffers1(UINT, UINT, ID3D11Buffer*const*, const UINT*, const UINT*) = 0;
+    virtual void VSGetConstantBuffers1(UINT, UINT, ID3D11Buffer**, UINT*, UINT*) = 0;
+    virtual void HSGetConstantBuffers1(UINT, UINT, ID3D11Buffer**, UINT*, UINT*) = 0;
+    virtual void DSGetConstantBuffers1(UINT, UINT, ID3D11Buffer**, UINT*, UINT*) = 0;
+    virtual void GSGetConstantBuffers1(UINT, UINT, ID3D11Buffer**, UINT*, UINT*) = 0;
+    virtual void PSGetConstantBuffers1(UINT, UINT, ID3D11Buffer**, UINT*, UINT*) = 0;
+    virtual void CSGetConstantBuffers1(UINT, UINT, ID3D11Buffer**, UINT*, UINT*) = 0;
+    virtual void SwapDeviceContextState(ID3DDeviceContextState*, ID3DDeviceContextState**) = 0;
+    virtual void ClearView(ID3D11View*, const FLOAT[4], const D3D11_RECT*, UINT) = 0;
+    virtual void DiscardView1(ID3D11View*, const D3D11_RECT*, UINT) = 0;
+};
+
+#endif // _AMD_TESTS_COMPAT_D3D11_H_
@@ -0,0 +1,1456 @@
+//
+// Copyright (c) 2016 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+//--------------------------------------------------------------------------------------
+// File: windows.h
+//
+// The subset of the Win32 headers the portable test build needs on non-Windows hosts.
+// Only used by tests/CMakeLists.txt when WIN32 is not set; the Windows build uses the
+// platform SDK. File handles and mappings are backed by POSIX file descriptors and mmap,
+// paths are narrowed and their backslashes turned into slashes. Processes are spawned with
+// posix_spawn, events and thread pool work items are built on std::thread.
+//--------------------------------------------------------------------------------------
+
+#ifndef _AMD_TESTS_COMPAT_WINDOWS_H_
+#define _AMD_TESTS_COMPAT_WINDOWS_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//--------------------------------------------------------------------------------------
+// Annotations and calling conventions
+//--------------------------------------------------------------------------------------
+#define WINAPI
+#define STDMETHODCALLTYPE
+#define __declspec(x)
+#define UNREFERENCED_PARAMETER(x)       (void)(x)
+
+#define _In_
+#define _In_z_
+#define _In_opt_
+#define _Inout_
+#define _Out_
+#define _Out_opt_
+#define _Outptr_
+#define _Outptr_opt_
+#define _In_reads_(x)
+#define _In_reads_opt_(x)
+#define _In_reads_bytes_(x)
+#define _Out_writes_(x)
+#define _Out_writes_opt_(x)
+#define _Analysis_assume_(x)
+#define _Use_decl_annotations_
+
+#define _WIN32_WINNT_VISTA              0x0600
+#define _WIN32_WINNT_WIN8               0x0602
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT                    _WIN32_WINNT_WIN8
+#endif
+
+//--------------------------------------------------------------------------------------
+// Types
+//--------------------------------------------------------------------------------------
+typedef int32_t                         HRESULT;
+typedef uint8_t                         BYTE;
+typedef uint8_t                         UINT8;
+typedef uint32_t                        UINT;
+typedef int32_t                         INT;
+typedef int                             BOOL;
+typedef float                           FLOAT;
+typedef char                            CHAR;
+typedef wchar_t                         WCHAR;
+typedef uint32_t                        DWORD;
+typedef int32_t                         LONG;
+typedef uint32_t                        ULONG;
+typedef uintptr_t                       ULONG_PTR;
+typedef int64_t                         LONGLONG;
+typedef int64_t                         LONG64;
+typedef uint64_t                        UINT64;
+typedef size_t                          SIZE_T;
+typedef void *                          HANDLE;
+typedef void *                          LPVOID;
+typedef void *                          PVOID;
+typedef char *                          LPSTR;
+typedef const char *                    LPCSTR;
+typedef const wchar_t *                 LPCWSTR;
+typedef wchar_t *                       LPWSTR;
+typedef void *                          HMODULE;
+typedef void *                          HWND;
+
+typedef union _LARGE_INTEGER
+{
+    struct
+    {
+        DWORD LowPart;
+        LONG HighPart;
+    };
+    LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef union _ULARGE_INTEGER
+{
+    struct
+    {
+        DWORD LowPart;
+        DWORD HighPart;
+    };
+    UINT64 QuadPart;
+} ULARGE_INTEGER;
+
+typedef struct tagRECT
+{
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+} RECT;
+
+struct GUID
+{
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t  Data4[8];
+};
+typedef GUID                            IID;
+typedef const GUID &                    REFGUID;
+typedef const IID &                     REFIID;
+
+inline bool operator==(const GUID & a, const GUID & b) { return memcmp(&a, &b, sizeof(GUID)) == 0; }
+
+// Every interface gets a distinct identity, the tests never compare against real IIDs
+template <class T> struct CompatUuidOf { static const GUID & get() { static GUID guid = { (uint32_t)(uintptr_t)&guid, 0, 0, { 0 } }; return guid; } };
+#define __uuidof(T)                     CompatUuidOf<T>::get()
+
+#define FALSE                           0
+#define TRUE                            1
+#define MAX_PATH                        260
+#define ARRAYSIZE(a)                    (sizeof(a) / sizeof((a)[0]))
+#define ZeroMemory(p, size)             memset((p), 0, (size))
+
+//--------------------------------------------------------------------------------------
+// Status codes
+//--------------------------------------------------------------------------------------
+#define S_OK                            ((HRESULT)0L)
+#define S_FALSE                         ((HRESULT)1L)
+#define E_NOTIMPL                       ((HRESULT)0x80004001L)
+#define E_NOINTERFACE                   ((HRESULT)0x80004002L)
+#define E_POINTER                       ((HRESULT)0x80004003L)
+#define E_FAIL                          ((HRESULT)0x80004005L)
+#define E_UNEXPECTED                    ((HRESULT)0x8000FFFFL)
+#define E_INVALIDARG                    ((HRESULT)0x80070057L)
+#define E_OUTOFMEMORY                   ((HRESULT)0x8007000EL)
+#define SUCCEEDED(hr)                   (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)                      (((HRESULT)(hr)) < 0)
+
+#define ERROR_FILE_NOT_FOUND            2L
+#define ERROR_PATH_NOT_FOUND            3L
+#define ERROR_ACCESS_DENIED             5L
+#define ERROR_NOT_ENOUGH_MEMORY         8L
+#define ERROR_INVALID_DATA              13L
+#define ERROR_NO_MORE_FILES             18L
+#define ERROR_HANDLE_EOF                38L
+#define ERROR_NOT_SUPPORTED             50L
+#define ERROR_FILE_EXISTS               80L
+#define ERROR_INSUFFICIENT_BUFFER       122L
+#define ERROR_ALREADY_EXISTS            183L
+#define ERROR_ARITHMETIC_OVERFLOW       534L
+#define HRESULT_FROM_WIN32(x)           ((HRESULT)(x) <= 0 ? ((HRESULT)(x)) : ((HRESULT)(((x) & 0x0000FFFF) | (7 << 16) | 0x80000000)))
+
+//--------------------------------------------------------------------------------------
+// CRT
+//--------------------------------------------------------------------------------------
+#define _fseeki64                       fseeko
+#define _ftelli64                       ftello
+
+//--------------------------------------------------------------------------------------
+// Files and read-only mappings
+//--------------------------------------------------------------------------------------
+#define INVALID_HANDLE_VALUE            ((HANDLE)(intptr_t)-1)
+#define GENERIC_READ                    0x80000000
+#define GENERIC_WRITE                   0x40000000
+#define FILE_WRITE_ATTRIBUTES           0x00000100
+#define FILE_SHARE_READ                 0x00000001
+#define FILE_SHARE_WRITE                0x00000002
+#define FILE_SHARE_DELETE               0x00000004
+#define CREATE_NEW                      1
+#define CREATE_ALWAYS                   2
+#define OPEN_EXISTING                   3
+#define OPEN_ALWAYS                     4
+#define FILE_BEGIN                      0
+#define FILE_CURRENT                    1
+#define FILE_END                        2
+#define FILE_ATTRIBUTE_DIRECTORY        0x00000010
+#define FILE_ATTRIBUTE_NORMAL           0x00000080
+#define INVALID_FILE_ATTRIBUTES         ((DWORD)-1)
+#define MOVEFILE_REPLACE_EXISTING       0x00000001
+#define MOVEFILE_WRITE_THROUGH          0x00000008
+#define PAGE_READONLY                   0x02
+#define FILE_MAP_READ                   0x0004
+
+typedef struct _FILE_STANDARD_INFO
+{
+    LARGE_INTEGER AllocationSize;
+    LARGE_INTEGER EndOfFile;
+    DWORD NumberOfLinks;
+    BOOL DeletePending;
+    BOOL Directory;
+} FILE_STANDARD_INFO;
+
+enum FILE_INFO_BY_HANDLE_CLASS { FileStandardInfo = 1 };
+
+typedef struct _FILETIME
+{
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+} FILETIME;
+
+namespace CompatWin32
+{
+    struct Event
+    {
+        std::mutex lock;
+        std::condition_variable changed;
+        bool manualReset;
+        bool signaled;
+    };
+
+    // A file descriptor, an event, or a child process (fd < 0) with its exit code and times
+    // once it was waited for
+    struct Handle
+    {
+        int fd;
+        Event * event;
+        pid_t pid;
+        DWORD exitCode;
+        FILETIME creationTime, exitTime, kernelTime, userTime;
+    };
+
+    inline DWORD & lastError() { static DWORD error = 0; return error; }
+    inline std::mutex & viewLock() { static std::mutex lock; return lock; }
+    inline std::map<const void *, size_t> & views() { static std::map<const void *, size_t> sizes; return sizes; }
+
+    // "\\?\" long path prefixes are dropped
+    inline std::string narrow(const wchar_t * name)
+    {
+        if (wcsncmp(name, L"\\\\?\\", 4) == 0) name += 4;
+        std::string result;
+        for (; *name; ++name) result += *name == L'\\' ? '/' : (char)*name;
+        return result;
+    }
+
+    inline BOOL fail()
+    {
+        switch (errno)
+        {
+        case ENOENT:    lastError() = ERROR_FILE_NOT_FOUND; break;
+        case ENOTDIR:   lastError() = ERROR_PATH_NOT_FOUND; break;
+        case EEXIST:    lastError() = ERROR_ALREADY_EXISTS; break;
+        case ENOMEM:    lastError() = ERROR_NOT_ENOUGH_MEMORY; break;
+        default:        lastError() = ERROR_ACCESS_DENIED; break;
+        }
+        return FALSE;
+    }
+
+    inline HANDLE openFile(const wchar_t * name, int flags)
+    {
+        int fd = open(narrow(name).c_str(), flags, 0644);
+        if (fd < 0)
+        {
+            fail();
+            return INVALID_HANDLE_VALUE;
+        }
+        Handle * handle = new Handle();
+        handle->fd = fd;
+        return handle;
+    }
+
+    inline HANDLE openRead(const wchar_t * name) { return openFile(name, O_RDONLY); }
+
+    inline int fd(HANDLE h) { return ((Handle *)h)->fd; }
+}
+
+inline DWORD GetLastError() { return CompatWin32::lastError(); }
+
+inline HANDLE CreateFile2(LPCWSTR name, DWORD, DWORD, DWORD, void *) { return CompatWin32::openRead(name); }
+
+// Sharing modes are not enforced, POSIX files can always be renamed and deleted while open
+inline HANDLE CreateFileW(LPCWSTR name, DWORD access, DWORD, void *, DWORD disposition, DWORD, HANDLE)
+{
+    int flags = (access & GENERIC_WRITE) ? ((access & GENERIC_READ) ? O_RDWR : O_WRONLY) : O_RDONLY;
+    switch (disposition)
+    {
+    case CREATE_NEW:    flags |= O_CREAT | O_EXCL; break;
+    case CREATE_ALWAYS: flags |= O_CREAT | O_TRUNC; break;
+    case OPEN_ALWAYS:   flags |= O_CREAT; break;
+    default:            break;
+    }
+    return CompatWin32::openFile(name, flags);
+}
+
+inline BOOL CloseHandle(HANDLE h)
+{
+    CompatWin32::Handle * handle = (CompatWin32::Handle *)h;
+    if (handle->fd >= 0) close(handle->fd);
+    delete handle->event;
+    delete handle;
+    return TRUE;
+}
+
+inline BOOL GetFileInformationByHandleEx(HANDLE h, FILE_INFO_BY_HANDLE_CLASS, void * info, DWORD)
+{
+    struct stat st;
+    if (fstat(((CompatWin32::Handle *)h)->fd, &st) != 0)
+    {
+        CompatWin32::lastError() = ERROR_ACCESS_DENIED;
+        return FALSE;
+    }
+    memset(info, 0, sizeof(FILE_STANDARD_INFO));
+    ((FILE_STANDARD_INFO *)info)->EndOfFile.QuadPart = st.st_size;
+    return TRUE;
+}
+
+inline HANDLE CreateFileMappingFromApp(HANDLE h, void *, DWORD, UINT64, LPCWSTR)
+{
+    CompatWin32::Handle * mapping = new CompatWin32::Handle();
+    mapping->fd = dup(((CompatWin32::Handle *)h)->fd);
+    return mapping;
+}
+
+inline HANDLE CreateFileMappingW(HANDLE h, void * attributes, DWORD protect, DWORD, DWORD, LPCWSTR name)
+{
+    return CreateFileMappingFromApp(h, attributes, protect, 0, name);
+}
+
+inline void * MapViewOfFileFromApp(HANDLE h, DWORD, UINT64, SIZE_T)
+{
+    int fd = ((CompatWin32::Handle *)h)->fd;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        CompatWin32::lastError() = ERROR_NOT_ENOUGH_MEMORY;
+        return NULL;
+    }
+    void * view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        CompatWin32::lastError() = ERROR_NOT_ENOUGH_MEMORY;
+        return NULL;
+    }
+    std::lock_guard<std::mutex> lock(CompatWin32::viewLock());
+    CompatWin32::views()[view] = (size_t)st.st_size;
+    return view;
+}
+
+inline void * MapViewOfFile(HANDLE h, DWORD access, DWORD, DWORD, SIZE_T size) { return MapViewOfFileFromApp(h, access, 0, size); }
+
+inline BOOL UnmapViewOfFile(const void * view)
+{
+    std::lock_guard<std::mutex> lock(CompatWin32::viewLock());
+    std::map<const void *, size_t>::iterator it = CompatWin32::views().find(view);
+    if (it == CompatWin32::views().end())
+    {
+        return FALSE;
+    }
+    munmap((void *)view, it->second);
+    CompatWin32::views().erase(it);
+    return TRUE;
+}
+
+//--------------------------------------------------------------------------------------
+// Writes, renames and directories
+//--------------------------------------------------------------------------------------
+typedef struct _WIN32_FILE_ATTRIBUTE_DATA
+{
+    DWORD dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD nFileSizeHigh;
+    DWORD nFileSizeLow;
+} WIN32_FILE_ATTRIBUTE_DATA;
+
+typedef struct _WIN32_FIND_DATAW
+{
+    DWORD dwFileAttributes;
+    FILETIME ftCreationTime;
+    FILETIME ftLastAccessTime;
+    FILETIME ftLastWriteTime;
+    DWORD nFileSizeHigh;
+    DWORD nFileSizeLow;
+    DWORD dwReserved0;
+    DWORD dwReserved1;
+    WCHAR cFileName[MAX_PATH];
+    WCHAR cAlternateFileName[14];
+} WIN32_FIND_DATAW;
+
+enum GET_FILEEX_INFO_LEVELS { GetFileExInfoStandard };
+
+namespace CompatWin32
+{
+    // FILETIME counts 100 ns intervals since 1601
+    static const UINT64 FILETIME_UNIX_EPOCH = 116444736000000000ULL;
+
+    inline FILETIME fileTime(const struct timespec & time)
+    {
+        UINT64 ticks = FILETIME_UNIX_EPOCH + (UINT64)time.tv_sec * 10000000ULL + (UINT64)time.tv_nsec / 100;
+        FILETIME result = { (DWORD)ticks, (DWORD)(ticks >> 32) };
+        return result;
+    }
+
+    inline struct timespec unixTime(const FILETIME & time)
+    {
+        UINT64 ticks = (((UINT64)time.dwHighDateTime << 32) | time.dwLowDateTime) - FILETIME_UNIX_EPOCH;
+        struct timespec result;
+        result.tv_sec = (time_t)(ticks / 10000000ULL);
+        result.tv_nsec = (long)(ticks % 10000000ULL) * 100;
+        return result;
+    }
+
+    inline void attributes(const struct stat & st, WIN32_FILE_ATTRIBUTE_DATA * data)
+    {
+        data->dwFileAttributes = S_ISDIR(st.st_mode) ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL;
+#if defined(__APPLE__)
+        data->ftCreationTime = fileTime(st.st_ctimespec);
+        data->ftLastAccessTime = fileTime(st.st_atimespec);
+        data->ftLastWriteTime = fileTime(st.st_mtimespec);
+#else
+        data->ftCreationTime = fileTime(st.st_ctim);
+        data->ftLastAccessTime = fileTime(st.st_atim);
+        data->ftLastWriteTime = fileTime(st.st_mtim);
+#endif
+        data->nFileSizeHigh = (DWORD)((UINT64)st.st_size >> 32);
+        data->nFileSizeLow = (DWORD)st.st_size;
+    }
+
+    struct Find
+    {
+        DIR * dir;
+        std::string path;
+    };
+
+    // Skips the entries FindFirstFileW / FindNextFileW do not return on Windows either
+    inline BOOL nextEntry(Find * find, WIN32_FIND_DATAW * data)
+    {
+        for (struct dirent * entry = readdir(find->dir); entry; entry = readdir(find->dir))
+        {
+            struct stat st;
+            if (stat((find->path + entry->d_name).c_str(), &st) != 0)
+            {
+                continue;
+            }
+            memset(data, 0, sizeof(WIN32_FIND_DATAW));
+            WIN32_FILE_ATTRIBUTE_DATA attributeData;
+            attributes(st, &attributeData);
+            memcpy(data, &attributeData, sizeof(attributeData));
+            mbstowcs(data->cFileName, entry->d_name, MAX_PATH - 1);
+            return TRUE;
+        }
+        lastError() = ERROR_NO_MORE_FILES;
+        return FALSE;
+    }
+}
+
+inline BOOL GetFileSizeEx(HANDLE h, LARGE_INTEGER * size)
+{
+    struct stat st;
+    if (fstat(CompatWin32::fd(h), &st) != 0) return CompatWin32::fail();
+    size->QuadPart = st.st_size;
+    return TRUE;
+}
+
+inline BOOL SetFilePointerEx(HANDLE h, LARGE_INTEGER distance, LARGE_INTEGER * newPosition, DWORD method)
+{
+    off_t position = lseek(CompatWin32::fd(h), (off_t)distance.QuadPart, method == FILE_END ? SEEK_END : method == FILE_CURRENT ? SEEK_CUR : SEEK_SET);
+    if (position < 0) return CompatWin32::fail();
+    if (newPosition) newPosition->QuadPart = position;
+    return TRUE;
+}
+
+inline BOOL ReadFile(HANDLE h, void * buffer, DWORD size, DWORD * read, void *)
+{
+    ssize_t result = ::read(CompatWin32::fd(h), buffer, size);
+    if (read) *read = result < 0 ? 0 : (DWORD)result;
+    return result < 0 ? CompatWin32::fail() : TRUE;
+}
+
+inline BOOL WriteFile(HANDLE h, const void * buffer, DWORD size, DWORD * written, void *)
+{
+    ssize_t result = ::write(CompatWin32::fd(h), buffer, size);
+    if (written) *written = result < 0 ? 0 : (DWORD)result;
+    return result < 0 ? CompatWin32::fail() : TRUE;
+}
+
+inline BOOL FlushFileBuffers(HANDLE h) { return fsync(CompatWin32::fd(h)) == 0 ? TRUE : CompatWin32::fail(); }
+
+inline BOOL SetEndOfFile(HANDLE h)
+{
+    int fd = CompatWin32::fd(h);
+    off_t position = lseek(fd, 0, SEEK_CUR);
+    return position >= 0 && ftruncate(fd, position) == 0 ? TRUE : CompatWin32::fail();
+}
+
+inline BOOL SetFileTime(HANDLE h, const FILETIME * creation, const FILETIME * access, const FILETIME * write)
+{
+    (void)creation;
+    struct timespec times[2];
+    times[0].tv_sec = times[1].tv_sec = 0;
+    times[0].tv_nsec = times[1].tv_nsec = UTIME_OMIT;
+    if (access) times[0] = CompatWin32::unixTime(*access);
+    if (write) times[1] = CompatWin32::unixTime(*write);
+    return futimens(CompatWin32::fd(h), times) == 0 ? TRUE : CompatWin32::fail();
+}
+
+inline void GetSystemTimeAsFileTime(FILETIME * time)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    *time = CompatWin32::fileTime(now);
+}
+
+inline DWORD GetFileAttributesW(LPCWSTR name)
+{
+    struct stat st;
+    if (stat(CompatWin32::narrow(name).c_str(), &st) != 0)
+    {
+        CompatWin32::fail();
+        return INVALID_FILE_ATTRIBUTES;
+    }
+    return S_ISDIR(st.st_mode) ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL;
+}
+
+inline BOOL GetFileAttributesExW(LPCWSTR name, GET_FILEEX_INFO_LEVELS, void * data)
+{
+    struct stat st;
+    if (stat(CompatWin32::narrow(name).c_str(), &st) != 0) return CompatWin32::fail();
+    CompatWin32::attributes(st, (WIN32_FILE_ATTRIBUTE_DATA *)data);
+    return TRUE;
+}
+
+inline BOOL CreateDirectoryW(LPCWSTR name, void *)
+{
+    return mkdir(CompatWin32::narrow(name).c_str(), 0755) == 0 ? TRUE : CompatWin32::fail();
+}
+
+inline BOOL DeleteFileW(LPCWSTR name)
+{
+    return unlink(CompatWin32::narrow(name).c_str()) == 0 ? TRUE : CompatWin32::fail();
+}
+
+inline BOOL RemoveDirectoryW(LPCWSTR name)
+{
+    return rmdir(CompatWin32::narrow(name).c_str()) == 0 ? TRUE : CompatWin32::fail();
+}
+
+// Without MOVEFILE_REPLACE_EXISTING the move fails when the target exists, as it does on Windows
+inline BOOL MoveFileExW(LPCWSTR existing, LPCWSTR target, DWORD flags)
+{
+    std::string from = CompatWin32::narrow(existing), to = CompatWin32::narrow(target);
+    if (flags & MOVEFILE_REPLACE_EXISTING)
+    {
+        return rename(from.c_str(), to.c_str()) == 0 ? TRUE : CompatWin32::fail();
+    }
+    struct stat st;
+    if (stat(from.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+    {
+        if (stat(to.c_str(), &st) == 0)
+        {
+            errno = EEXIST;
+            return CompatWin32::fail();
+        }
+        return rename(from.c_str(), to.c_str()) == 0 ? TRUE : CompatWin32::fail();
+    }
+    if (link(from.c_str(), to.c_str()) != 0) return CompatWin32::fail();
+    unlink(from.c_str());
+    return TRUE;
+}
+
+inline BOOL CopyFileW(LPCWSTR existing, LPCWSTR target, BOOL failIfExists)
+{
+    HANDLE source = CompatWin32::openFile(existing, O_RDONLY);
+    if (source == INVALID_HANDLE_VALUE) return FALSE;
+    HANDLE copy = CompatWin32::openFile(target, O_WRONLY | O_CREAT | (failIfExists ? O_EXCL : O_TRUNC));
+    if (copy == INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(source);
+        return FALSE;
+    }
+
+    BOOL result = TRUE;
+    char buffer[65536];
+    for (;;)
+    {
+        ssize_t size = ::read(CompatWin32::fd(source), buffer, sizeof(buffer));
+        if (size <= 0)
+        {
+            result = size == 0 ? TRUE : CompatWin32::fail();
+            break;
+        }
+        if (::write(CompatWin32::fd(copy), buffer, (size_t)size) != size)
+        {
+            result = CompatWin32::fail();
+            break;
+        }
+    }
+    CloseHandle(copy);
+    CloseHandle(source);
+    return result;
+}
+
+// Only the "directory\\*" patterns are supported
+inline HANDLE FindFirstFileW(LPCWSTR pattern, WIN32_FIND_DATAW * data)
+{
+    std::string path = CompatWin32::narrow(pattern);
+    if (path.size() >= 2 && path.compare(path.size() - 2, 2, "/*") == 0)
+    {
+        path.resize(path.size() - 1);
+    }
+    DIR * dir = opendir(path.c_str());
+    if (dir == NULL)
+    {
+        CompatWin32::fail();
+        return INVALID_HANDLE_VALUE;
+    }
+    CompatWin32::Find * find = new CompatWin32::Find;
+    find->dir = dir;
+    find->path = path;
+    if (!CompatWin32::nextEntry(find, data))
+    {
+        closedir(dir);
+        delete find;
+        return INVALID_HANDLE_VALUE;
+    }
+    return find;
+}
+
+inline BOOL FindNextFileW(HANDLE h, WIN32_FIND_DATAW * data) { return CompatWin32::nextEntry((CompatWin32::Find *)h, data); }
+
+inline BOOL FindClose(HANDLE h)
+{
+    CompatWin32::Find * find = (CompatWin32::Find *)h;
+    closedir(find->dir);
+    delete find;
+    return TRUE;
+}
+
+//--------------------------------------------------------------------------------------
+// Threads and critical sections
+//--------------------------------------------------------------------------------------
+typedef struct _CRITICAL_SECTION
+{
+    std::recursive_mutex * m_pMutex;
+} CRITICAL_SECTION;
+
+inline void InitializeCriticalSection(CRITICAL_SECTION * section) { section->m_pMutex = new std::recursive_mutex; }
+inline void DeleteCriticalSection(CRITICAL_SECTION * section) { delete section->m_pMutex; section->m_pMutex = NULL; }
+inline void EnterCriticalSection(CRITICAL_SECTION * section) { section->m_pMutex->lock(); }
+inline void LeaveCriticalSection(CRITICAL_SECTION * section) { section->m_pMutex->unlock(); }
+inline BOOL TryEnterCriticalSection(CRITICAL_SECTION * section) { return section->m_pMutex->try_lock() ? TRUE : FALSE; }
+
+// Interlocked functions are full barriers, like on Windows
+inline LONG InterlockedIncrement(LONG volatile * target) { return __atomic_add_fetch(target, 1, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedExchange(LONG volatile * target, LONG value) { return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedCompareExchange(LONG volatile * target, LONG exchange, LONG comparand)
+{
+    __atomic_compare_exchange_n(target, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+inline LONG64 InterlockedExchange64(LONG64 volatile * target, LONG64 value) { return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST); }
+inline LONG64 InterlockedExchangeAdd64(LONG64 volatile * target, LONG64 value) { return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST); }
+inline PVOID InterlockedCompareExchangePointer(PVOID volatile * target, PVOID exchange, PVOID comparand)
+{
+    __atomic_compare_exchange_n(target, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
+// Fiber local storage is thread local storage with a callback when the thread exits
+typedef void (WINAPI * PFLS_CALLBACK_FUNCTION)(PVOID);
+#define FLS_OUT_OF_INDEXES              ((DWORD)0xFFFFFFFF)
+
+inline DWORD FlsAlloc(PFLS_CALLBACK_FUNCTION callback)
+{
+    pthread_key_t key;
+    return (pthread_key_create(&key, callback) == 0) ? (DWORD)key : FLS_OUT_OF_INDEXES;
+}
+inline BOOL FlsFree(DWORD index) { return pthread_key_delete((pthread_key_t)index) == 0; }
+inline PVOID FlsGetValue(DWORD index) { return pthread_getspecific((pthread_key_t)index); }
+inline BOOL FlsSetValue(DWORD index, PVOID value) { return pthread_setspecific((pthread_key_t)index, value) == 0; }
+
+inline DWORD GetCurrentProcessId() { return (DWORD)getpid(); }
+inline DWORD GetCurrentThreadId() { return (DWORD)std::hash<std::thread::id>()(std::this_thread::get_id()); }
+inline HANDLE GetCurrentThread() { return (HANDLE)(intptr_t)-2; }
+
+// Only for the calling thread, from its CPU clock: all of it is reported as user time
+inline BOOL GetThreadTimes(HANDLE, FILETIME * creation, FILETIME * exit, FILETIME * kernel, FILETIME * user)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    UINT64 ticks = (UINT64)now.tv_sec * 10000000ULL + (UINT64)now.tv_nsec / 100;
+    FILETIME zero = { 0, 0 }, cpu = { (DWORD)ticks, (DWORD)(ticks >> 32) };
+    *creation = zero;
+    *exit = zero;
+    *kernel = zero;
+    *user = cpu;
+    return TRUE;
+}
+
+inline void Sleep(DWORD milliseconds) { usleep((useconds_t)milliseconds * 1000); }
+
+typedef struct _SYSTEM_INFO
+{
+    DWORD dwPageSize;
+    DWORD dwNumberOfProcessors;
+} SYSTEM_INFO;
+
+inline void GetSystemInfo(SYSTEM_INFO * info)
+{
+    unsigned int processors = std::thread::hardware_concurrency();
+    info->dwPageSize = (DWORD)sysconf(_SC_PAGESIZE);
+    info->dwNumberOfProcessors = processors > 0 ? processors : 1;
+}
+
+// Work items run on a thread of their own rather than on a pool
+typedef DWORD (WINAPI * LPTHREAD_START_ROUTINE)(LPVOID);
+#define WT_EXECUTEDEFAULT               0x00000000
+#define WT_EXECUTELONGFUNCTION          0x00000010
+
+inline BOOL QueueUserWorkItem(LPTHREAD_START_ROUTINE function, PVOID context, ULONG)
+{
+    std::thread(function, context).detach();
+    return TRUE;
+}
+
+//--------------------------------------------------------------------------------------
+// Processes. The command line is split with the Windows quoting rules (without escaped
+// quotes), the environment and the current directory are inherited.
+//--------------------------------------------------------------------------------------
+#define INFINITE                        0xFFFFFFFF
+#define WAIT_OBJECT_0                   0x00000000L
+#define WAIT_TIMEOUT                    0x00000102L
+#define WAIT_FAILED                     ((DWORD)0xFFFFFFFF)
+#define STILL_ACTIVE                    259
+#define MAXIMUM_WAIT_OBJECTS            64
+#define CREATE_NO_WINDOW                0x08000000
+
+typedef struct _STARTUPINFOW
+{
+    DWORD cb;
+} STARTUPINFOW;
+
+typedef struct _PROCESS_INFORMATION
+{
+    HANDLE hProcess;
+    HANDLE hThread;
+    DWORD dwProcessId;
+    DWORD dwThreadId;
+} PROCESS_INFORMATION;
+
+extern "C" char ** environ;
+
+namespace CompatWin32
+{
+    inline std::vector<std::string> splitCommandLine(const wchar_t * commandLine)
+    {
+        std::vector<std::string> arguments;
+        std::string argument;
+        bool bQuoted = false, bArgument = false;
+        for (; *commandLine; ++commandLine)
+        {
+            if (*commandLine == L'"')
+            {
+                bQuoted = !bQuoted;
+                bArgument = true;
+            }
+            else if (!bQuoted && (*commandLine == L' ' || *commandLine == L'\t'))
+            {
+                if (bArgument) arguments.push_back(argument);
+                argument.clear();
+                bArgument = false;
+            }
+            else
+            {
+                argument += (char)*commandLine;
+                bArgument = true;
+            }
+        }
+        if (bArgument) arguments.push_back(argument);
+        return arguments;
+    }
+
+    inline DWORD exitCode(int status)
+    {
+        return WIFEXITED(status) ? (DWORD)WEXITSTATUS(status) : (DWORD)(128 + WTERMSIG(status));
+    }
+
+    inline FILETIME now()
+    {
+        struct timespec time;
+        clock_gettime(CLOCK_REALTIME, &time);
+        return fileTime(time);
+    }
+
+    // A duration rather than a point in time, like the kernel and user times of a process
+    inline FILETIME duration(const struct timeval & time)
+    {
+        UINT64 ticks = (UINT64)time.tv_sec * 10000000ULL + (UINT64)time.tv_usec * 10;
+        FILETIME result = { (DWORD)ticks, (DWORD)(ticks >> 32) };
+        return result;
+    }
+
+    inline DWORD waitForEvent(Event * event, DWORD milliseconds)
+    {
+        std::unique_lock<std::mutex> lock(event->lock);
+        if (milliseconds == INFINITE)
+        {
+            event->changed.wait(lock, [event] { return event->signaled; });
+        }
+        else if (!event->changed.wait_for(lock, std::chrono::milliseconds(milliseconds), [event] { return event->signaled; }))
+        {
+            return WAIT_TIMEOUT;
+        }
+        if (!event->manualReset) event->signaled = false;
+        return WAIT_OBJECT_0;
+    }
+
+    // Polls the child for a finite timeout, POSIX has no waitpid with one
+    inline DWORD waitForProcess(Handle * process, DWORD milliseconds)
+    {
+        int status = 0;
+        struct rusage usage;
+        pid_t result;
+        for (DWORD waited = 0;; waited++)
+        {
+            do
+            {
+                result = wait4(process->pid, &status, milliseconds == INFINITE ? 0 : WNOHANG, &usage);
+            }
+            while (result < 0 && errno == EINTR);
+            if (result != 0 || waited >= milliseconds) break;
+            usleep(1000);
+        }
+
+        if (result < 0)
+        {
+            fail();
+            return WAIT_FAILED;
+        }
+        if (result == 0) return WAIT_TIMEOUT;
+
+        process->exitCode = exitCode(status);
+        process->exitTime = now();
+        process->kernelTime = duration(usage.ru_stime);
+        process->userTime = duration(usage.ru_utime);
+        process->pid = 0;
+        return WAIT_OBJECT_0;
+    }
+}
+
+inline BOOL CreateProcessW(LPCWSTR applicationName, LPWSTR commandLine, void *, void *, BOOL, DWORD, void *, LPCWSTR, STARTUPINFOW *, PROCESS_INFORMATION * information)
+{
+    std::vector<std::string> arguments = CompatWin32::splitCommandLine(commandLine ? commandLine : applicationName);
+    if (arguments.empty())
+    {
+        CompatWin32::lastError() = ERROR_FILE_NOT_FOUND;
+        return FALSE;
+    }
+    std::string path = applicationName ? CompatWin32::narrow(applicationName) : arguments[0];
+
+    std::vector<char *> argv;
+    for (size_t i = 0; i < arguments.size(); i++) argv.push_back(&arguments[i][0]);
+    argv.push_back(NULL);
+
+    pid_t pid = 0;
+    int error = posix_spawn(&pid, path.c_str(), NULL, NULL, &argv[0], environ);
+    if (error != 0)
+    {
+        errno = error;
+        return CompatWin32::fail();
+    }
+
+    CompatWin32::Handle * process = new CompatWin32::Handle();
+    process->fd = -1;
+    process->pid = pid;
+    process->exitCode = STILL_ACTIVE;
+    process->creationTime = CompatWin32::now();
+    CompatWin32::Handle * thread = new CompatWin32::Handle();
+    thread->fd = -1;
+
+    information->hProcess = process;
+    information->hThread = thread;
+    information->dwProcessId = (DWORD)pid;
+    information->dwThreadId = (DWORD)pid;
+    return TRUE;
+}
+
+// Events and processes can be waited for, other handles are always signaled
+inline DWORD WaitForSingleObject(HANDLE h, DWORD milliseconds)
+{
+    CompatWin32::Handle * handle = (CompatWin32::Handle *)h;
+    if (handle->event) return CompatWin32::waitForEvent(handle->event, milliseconds);
+    if (handle->pid == 0) return WAIT_OBJECT_0;
+    return CompatWin32::waitForProcess(handle, milliseconds);
+}
+
+// Only waiting for all of the objects is supported
+inline DWORD WaitForMultipleObjects(DWORD count, const HANDLE * handles, BOOL waitAll, DWORD milliseconds)
+{
+    if (!waitAll || count > MAXIMUM_WAIT_OBJECTS)
+    {
+        CompatWin32::lastError() = ERROR_NOT_SUPPORTED;
+        return WAIT_FAILED;
+    }
+    for (DWORD i = 0; i < count; i++)
+    {
+        DWORD result = WaitForSingleObject(handles[i], milliseconds);
+        if (result != WAIT_OBJECT_0) return result;
+    }
+    return WAIT_OBJECT_0;
+}
+
+// The exit, kernel and user times are only known once the process was waited for
+inline BOOL GetProcessTimes(HANDLE h, FILETIME * creation, FILETIME * exit, FILETIME * kernel, FILETIME * user)
+{
+    CompatWin32::Handle * process = (CompatWin32::Handle *)h;
+    if (WaitForSingleObject(h, 0) == WAIT_FAILED) return FALSE;
+    *creation = process->creationTime;
+    *exit = process->exitTime;
+    *kernel = process->kernelTime;
+    *user = process->userTime;
+    return TRUE;
+}
+
+inline BOOL GetExitCodeProcess(HANDLE h, DWORD * exitCode)
+{
+    if (WaitForSingleObject(h, 0) == WAIT_FAILED) return FALSE;
+    *exitCode = ((CompatWin32::Handle *)h)->exitCode;
+    return TRUE;
+}
+
+//--------------------------------------------------------------------------------------
+// Events
+//--------------------------------------------------------------------------------------
+inline HANDLE CreateEventW(void *, BOOL manualReset, BOOL initialState, LPCWSTR)
+{
+    CompatWin32::Handle * handle = new CompatWin32::Handle();
+    handle->fd = -1;
+    handle->event = new CompatWin32::Event();
+    handle->event->manualReset = manualReset != FALSE;
+    handle->event->signaled = initialState != FALSE;
+    return handle;
+}
+
+inline BOOL SetEvent(HANDLE h)
+{
+    CompatWin32::Event * event = ((CompatWin32::Handle *)h)->event;
+    {
+        std::lock_guard<std::mutex> lock(event->lock);
+        event->signaled = true;
+    }
+    event->changed.notify_all();
+    return TRUE;
+}
+
+inline BOOL ResetEvent(HANDLE h)
+{
+    CompatWin32::Event * event = ((CompatWin32::Handle *)h)->event;
+    std::lock_guard<std::mutex> lock(event->lock);
+    event->signaled = false;
+    return TRUE;
+}
+
+// The path name of the executable, a module handle other than NULL is not supported
+inline DWORD GetModuleFileNameW(HMODULE, LPWSTR fileName, DWORD size)
+{
+    char path[MAX_PATH * 4];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length < 0 || size == 0)
+    {
+        CompatWin32::fail();
+        return 0;
+    }
+    DWORD copied = (DWORD)length < size - 1 ? (DWORD)length : size - 1;
+    for (DWORD i = 0; i < copied; i++) fileName[i] = (wchar_t)(unsigned char)path[i];
+    fileName[copied] = 0;
+    if (copied < (DWORD)length) CompatWin32::lastError() = ERROR_INSUFFICIENT_BUFFER;
+    return copied;
+}
+
+//--------------------------------------------------------------------------------------
+// Shell paths and dialogs. Combined paths keep backslashes, they are narrowed when opened.
+//--------------------------------------------------------------------------------------
+#define CSIDL_PROGRAM_FILESX86          0x002a
+#define MB_OK                           0x00000000L
+#define IDOK                            1
+
+inline DWORD GetCurrentDirectoryW(DWORD size, LPWSTR buffer)
+{
+    char path[MAX_PATH * 4];
+    if (!getcwd(path, sizeof(path)))
+    {
+        CompatWin32::fail();
+        return 0;
+    }
+    DWORD length = (DWORD)strlen(path);
+    if (length >= size) return length + 1;
+    for (DWORD i = 0; i <= length; i++) buffer[i] = (wchar_t)(unsigned char)path[i];
+    return length;
+}
+
+// Only CSIDL_PROGRAM_FILESX86, from the environment variable Windows sets for it
+inline BOOL SHGetSpecialFolderPathW(HWND, LPWSTR path, int csidl, BOOL)
+{
+    const char * value = csidl == CSIDL_PROGRAM_FILESX86 ? getenv("ProgramFiles(x86)") : NULL;
+    path[0] = L'\0';
+    if (!value) return FALSE;
+    size_t length = strlen(value) < MAX_PATH - 1 ? strlen(value) : MAX_PATH - 1;
+    for (size_t i = 0; i < length; i++) path[i] = (wchar_t)(unsigned char)value[i];
+    path[length] = L'\0';
+    return TRUE;
+}
+
+// Resolves "." and ".." like the Shell does, an absolute file ignores the directory
+inline LPWSTR PathCombineW(LPWSTR destination, LPCWSTR directory, LPCWSTR file)
+{
+    std::wstring path = (file && (file[0] == L'\\' || file[0] == L'/')) ? std::wstring(file)
+                      : std::wstring(directory ? directory : L"") + L"\\" + (file ? file : L"");
+    std::vector<std::wstring> parts;
+    std::wstring part;
+    for (size_t i = 0; i <= path.size(); i++)
+    {
+        if (i < path.size() && path[i] != L'\\' && path[i] != L'/')
+        {
+            part += path[i];
+            continue;
+        }
+        if (part == L"..")
+        {
+            if (!parts.empty()) parts.pop_back();
+        }
+        else if (!part.empty() && part != L".")
+        {
+            parts.push_back(part);
+        }
+        part.clear();
+    }
+    std::wstring result = (!path.empty() && (path[0] == L'\\' || path[0] == L'/')) ? L"\\" : L"";
+    for (size_t i = 0; i < parts.size(); i++) result += (i > 0 ? L"\\" : L"") + parts[i];
+    if (result.size() >= MAX_PATH)
+    {
+        destination[0] = L'\0';
+        return NULL;
+    }
+    memcpy(destination, result.c_str(), (result.size() + 1) * sizeof(wchar_t));
+    return destination;
+}
+
+inline BOOL PathRemoveFileSpecW(LPWSTR path)
+{
+    wchar_t * separator = NULL;
+    for (wchar_t * c = path; *c; ++c) if (*c == L'\\' || *c == L'/') separator = c;
+    if (!separator) return FALSE;
+    *separator = L'\0';
+    return TRUE;
+}
+
+inline int MessageBoxW(HWND, LPCWSTR text, LPCWSTR caption, UINT)
+{
+    fprintf(stderr, "%ls: %ls\n", caption, text);
+    return IDOK;
+}
+
+inline void DebugBreak() { raise(SIGTRAP); }
+
+#define CreateProcess                   CreateProcessW
+#define STARTUPINFO                     STARTUPINFOW
+#define CreateEvent                     CreateEventW
+#define DeleteFile                      DeleteFileW
+#define SHGetSpecialFolderPath          SHGetSpecialFolderPathW
+#define PathCombine                     PathCombineW
+#define PathRemoveFileSpec              PathRemoveFileSpecW
+
+//--------------------------------------------------------------------------------------
+// Wide strings, with the MSVC meaning of %s and %c in the wide printf family
+//--------------------------------------------------------------------------------------
+namespace CompatWin32
+{
+    // MSVC reads %s / %c as wide in a wide format, POSIX needs %ls / %lc (and %s for MSVC's %S)
+    inline std::wstring wideFormat(const wchar_t * format)
+    {
+        std::wstring result;
+        for (const wchar_t * c = format; *c; ++c)
+        {
+            result += *c;
+            if (*c != L'%') continue;
+            if (c[1] == L'%')
+            {
+                result += *++c;
+                continue;
+            }
+            while (c[1] && wcschr(L"-+ #0123456789.*", c[1])) result += *++c;
+            bool length = false;
+            while (c[1] && wcschr(L"hlLqjzt", c[1]))
+            {
+                result += *++c;
+                length = true;
+            }
+            if (c[1] == L's' || c[1] == L'c')
+            {
+                if (!length) result += L'l';
+            }
+            else if (c[1] == L'S' || c[1] == L'C')
+            {
+                result += (wchar_t)towlower(*++c);
+                continue;
+            }
+            if (c[1]) result += *++c;
+        }
+        return result;
+    }
+}
+
+inline int vswprintf_s(wchar_t * buffer, size_t size, const wchar_t * format, va_list args)
+{
+    int result = vswprintf(buffer, size, CompatWin32::wideFormat(format).c_str(), args);
+    if (result < 0 && size > 0) buffer[0] = L'\0';
+    return result;
+}
+
+inline int swprintf_s(wchar_t * buffer, size_t size, const wchar_t * format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int result = vswprintf_s(buffer, size, format, args);
+    va_end(args);
+    return result;
+}
+
+template <size_t size> int swprintf_s(wchar_t (&buffer)[size], const wchar_t * format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int result = vswprintf_s(buffer, size, format, args);
+    va_end(args);
+    return result;
+}
+
+inline int wcscpy_s(wchar_t * destination, size_t size, const wchar_t * source)
+{
+    if (size == 0) return EINVAL;
+    size_t length = wcslen(source);
+    if (length >= size)
+    {
+        destination[0] = L'\0';
+        return ERANGE;
+    }
+    memcpy(destination, source, (length + 1) * sizeof(wchar_t));
+    return 0;
+}
+
+template <size_t size> int wcscpy_s(wchar_t (&destination)[size], const wchar_t * source) { return wcscpy_s(destination, size, source); }
+
+inline int wcscat_s(wchar_t * destination, size_t size, const wchar_t * source)
+{
+    size_t length = wcsnlen(destination, size);
+    if (length == size) return EINVAL;
+    return wcscpy_s(destination + length, size - length, source);
+}
+
+inline int _itow_s(int value, wchar_t * buffer, size_t size, int radix)
+{
+    if (radix != 10) return EINVAL;
+    return swprintf(buffer, size, L"%d", value) < 0 ? ERANGE : 0;
+}
+
+template <size_t size> int _itow_s(int value, wchar_t (&buffer)[size], int radix) { return _itow_s(value, buffer, size, radix); }
+
+inline int _wtoi(const wchar_t * text) { return (int)wcstol(text, NULL, 10); }
+inline double _wtof(const wchar_t * text) { return wcstod(text, NULL); }
+
+#define _TRUNCATE                       ((size_t)-1)
+
+// Narrows like the file functions do, a character at a time
+inline int wcstombs_s(size_t * converted, char * destination, size_t size, const wchar_t * source, size_t count)
+{
+    size_t length = wcslen(source);
+    if (count != _TRUNCATE && count < length) length = count;
+    if (length >= size)
+    {
+        if (count != _TRUNCATE)
+        {
+            if (size > 0) destination[0] = '\0';
+            if (converted) *converted = 0;
+            return ERANGE;
+        }
+        length = size - 1;
+    }
+    for (size_t i = 0; i < length; i++) destination[i] = (char)source[i];
+    destination[length] = '\0';
+    if (converted) *converted = length + 1;
+    return 0;
+}
+
+inline int _wgetenv_s(size_t * required, wchar_t * buffer, size_t size, const wchar_t * name)
+{
+    const char * value = getenv(CompatWin32::narrow(name).c_str());
+    *required = value ? strlen(value) + 1 : 0;
+    if (size > 0) buffer[0] = L'\0';
+    if (!value) return 0;
+    if (*required > size) return ERANGE;
+    for (size_t i = 0; i < *required; i++) buffer[i] = (wchar_t)(unsigned char)value[i];
+    return 0;
+}
+
+// The text mode 't' and the ",ccs=" encoding are dropped, POSIX files are always binary
+inline int _wfopen_s(FILE ** file, const wchar_t * name, const wchar_t * mode)
+{
+    std::string narrowMode;
+    for (; *mode && *mode != L','; ++mode) if (*mode != L't') narrowMode += (char)*mode;
+    *file = fopen(CompatWin32::narrow(name).c_str(), narrowMode.c_str());
+    return *file ? 0 : errno;
+}
+
+inline int _waccess(const wchar_t * name, int mode) { return access(CompatWin32::narrow(name).c_str(), mode); }
+
+inline int strcpy_s(char * destination, size_t size, const char * source)
+{
+    size_t length = strlen(source);
+    if (size == 0) return EINVAL;
+    if (length >= size)
+    {
+        destination[0] = '\0';
+        return ERANGE;
+    }
+    memcpy(destination, source, length + 1);
+    return 0;
+}
+
+inline int strcat_s(char * destination, size_t size, const char * source)
+{
+    size_t length = strnlen(destination, size);
+    if (length == size) return EINVAL;
+    return strcpy_s(destination + length, size - length, source);
+}
+
+// glibc reads %S as a wide string in a narrow format, as MSVC does
+template <size_t size> int sprintf_s(char (&buffer)[size], const char * format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int result = vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return result;
+}
+
+inline int _wcsicmp(const wchar_t * a, const wchar_t * b)
+{
+    for (; *a && towlower(*a) == towlower(*b); ++a, ++b) {}
+    return (int)towlower(*a) - (int)towlower(*b);
+}
+
+inline void OutputDebugStringW(LPCWSTR text) { fprintf(stderr, "%ls", text); }
+
+//--------------------------------------------------------------------------------------
+// CryptoAPI, with MD5 (RFC 1321) as its only hash
+//--------------------------------------------------------------------------------------
+typedef ULONG_PTR                       HCRYPTPROV;
+typedef ULONG_PTR                       HCRYPTHASH;
+typedef unsigned int                    ALG_ID;
+
+#define PROV_RSA_FULL                   1
+#define CRYPT_NEWKEYSET                 0x00000008
+#define CALG_MD5                        0x00008003
+#define HP_HASHVAL                      0x0002
+#define HP_HASHSIZE                     0x0004
+#define NTE_BAD_KEYSET                  ((HRESULT)0x80090016L)
+#define NTE_BAD_ALGID                   ((HRESULT)0x80090008L)
+
+namespace CompatWin32
+{
+    struct Md5
+    {
+        uint32_t state[4];
+        UINT64 length;
+        BYTE block[64];
+        BYTE digest[16];
+        bool finished;
+    };
+
+    inline uint32_t rotate(uint32_t x, int bits) { return (x << bits) | (x >> (32 - bits)); }
+
+    inline void md5Block(uint32_t state[4], const BYTE block[64])
+    {
+        static const uint32_t K[64] =
+        {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+        };
+        static const int R[16] = { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+
+        uint32_t M[16];
+        for (int i = 0; i < 16; i++)
+        {
+            M[i] = (uint32_t)block[i * 4] | ((uint32_t)block[i * 4 + 1] << 8) | ((uint32_t)block[i * 4 + 2] << 16) | ((uint32_t)block[i * 4 + 3] << 24);
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        for (int i = 0; i < 64; i++)
+        {
+            uint32_t f;
+            int g;
+            switch (i / 16)
+            {
+            case 0:  f = (b & c) | (~b & d); g = i; break;
+            case 1:  f = (d & b) | (~d & c); g = (5 * i + 1) % 16; break;
+            case 2:  f = b ^ c ^ d; g = (3 * i + 5) % 16; break;
+            default: f = c ^ (b | ~d); g = (7 * i) % 16; break;
+            }
+            uint32_t t = d;
+            d = c;
+            c = b;
+            b = b + rotate(a + f + K[i] + M[g], R[(i / 16) * 4 + i % 4]);
+            a = t;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+    }
+
+    inline void md5Update(Md5 * md5, const BYTE * data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            md5->block[md5->length++ % 64] = data[i];
+            if (md5->length % 64 == 0) md5Block(md5->state, md5->block);
+        }
+    }
+
+    inline void md5Finish(Md5 * md5)
+    {
+        UINT64 bits = md5->length * 8;
+        BYTE padding = 0x80;
+        md5Update(md5, &padding, 1);
+        padding = 0;
+        while (md5->length % 64 != 56) md5Update(md5, &padding, 1);
+        for (int i = 0; i < 8; i++)
+        {
+            BYTE byte = (BYTE)(bits >> (i * 8));
+            md5Update(md5, &byte, 1);
+        }
+        for (int i = 0; i < 16; i++) md5->digest[i] = (BYTE)(md5->state[i / 4] >> ((i % 4) * 8));
+        md5->finished = true;
+    }
+}
+
+// There are no key containers, so CRYPT_NEWKEYSET is never needed
+inline BOOL CryptAcquireContextW(HCRYPTPROV * provider, LPCWSTR, LPCWSTR, DWORD type, DWORD)
+{
+    *provider = (HCRYPTPROV)type;
+    return TRUE;
+}
+
+inline BOOL CryptReleaseContext(HCRYPTPROV, DWORD) { return TRUE; }
+
+inline BOOL CryptCreateHash(HCRYPTPROV, ALG_ID algorithm, HCRYPTHASH, DWORD, HCRYPTHASH * hash)
+{
+    if (algorithm != CALG_MD5)
+    {
+        CompatWin32::lastError() = (DWORD)NTE_BAD_ALGID;
+        return FALSE;
+    }
+    CompatWin32::Md5 * md5 = new CompatWin32::Md5();
+    md5->state[0] = 0x67452301;
+    md5->state[1] = 0xefcdab89;
+    md5->state[2] = 0x98badcfe;
+    md5->state[3] = 0x10325476;
+    *hash = (HCRYPTHASH)md5;
+    return TRUE;
+}
+
+inline BOOL CryptHashData(HCRYPTHASH hash, const BYTE * data, DWORD size, DWORD)
+{
+    CompatWin32::md5Update((CompatWin32::Md5 *)hash, data, size);
+    return TRUE;
+}
+
+inline BOOL CryptGetHashParam(HCRYPTHASH hash, DWORD parameter, BYTE * data, DWORD * size, DWORD)
+{
+    CompatWin32::Md5 * md5 = (CompatWin32::Md5 *)hash;
+    if (parameter == HP_HASHSIZE)
+    {
+        DWORD hashSize = sizeof(md5->digest);
+        memcpy(data, &hashSize, sizeof(hashSize));
+        *size = sizeof(hashSize);
+        return TRUE;
+    }
+    if (parameter != HP_HASHVAL || *size < sizeof(md5->digest))
+    {
+        CompatWin32::lastError() = ERROR_INSUFFICIENT_BUFFER;
+        return FALSE;
+    }
+    if (!md5->finished) CompatWin32::md5Finish(md5);
+    memcpy(data, md5->digest, sizeof(md5->digest));
+    *size = sizeof(md5->digest);
+    return TRUE;
+}
+
+inline BOOL CryptDestroyHash(HCRYPTHASH hash)
+{
+    delete (CompatWin32::Md5 *)hash;
+    return TRUE;
+}
+
+#define CryptAcquireContext             CryptAcquireContextW
+
+#endif // _AMD_TESTS_COMPAT_WINDOWS_H_